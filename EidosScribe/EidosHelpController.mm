@@ -1262,6 +1262,7 @@
 						  @"–\u00A0registerSurvivalCallback()",
 						  @"–\u00A0addCloned()",
 						  @"–\u00A0addCrossed()",
+						  @"–\u00A0addCrossedBatch()",
 						  @"–\u00A0addEmpty()",
 						  @"–\u00A0addMultiRecombinant()",
 						  @"–\u00A0addRecombinant()",
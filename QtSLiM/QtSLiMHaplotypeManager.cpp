@@ -871,7 +871,7 @@ int64_t *QtSLiMHaplotypeManager::buildDistanceArrayForSubrange(void)
 		Haplosome *haplosome1 = haplosomes[i];
 		int64_t *distance_column = distances + i;
 		int64_t *distance_row = distances + i * haplosome_count;
-		slim_position_t mutrun_length = haplosome1->mutrun_length_;
+		const MutationRunLayout &mutrun_layout = *haplosome1->mutrun_layout_;
 		int mutrun_count = haplosome1->mutrun_count_;
 		const MutationRun **haplosome1_mutruns = haplosome1->mutruns_;
 		
@@ -886,7 +886,7 @@ int64_t *QtSLiMHaplotypeManager::buildDistanceArrayForSubrange(void)
 			for (int mutrun_index = 0; mutrun_index < mutrun_count; ++mutrun_index)
 			{
 				// Skip mutation runs outside of the subrange we're focused on
-				if ((mutrun_length * mutrun_index > lastBase) || (mutrun_length * mutrun_index + mutrun_length - 1 < firstBase))
+				if ((mutrun_layout.RunStart(mutrun_index) > lastBase) || (mutrun_layout.RunLastPosition(mutrun_index) < firstBase))
 					continue;
 				
 				// OK, this mutrun intersects with our chosen subrange; proceed
@@ -1067,7 +1067,7 @@ int64_t *QtSLiMHaplotypeManager::buildDistanceArrayForSubrangeAndSubtypes(void)
 		Haplosome *haplosome1 = haplosomes[i];
 		int64_t *distance_column = distances + i;
 		int64_t *distance_row = distances + i * haplosome_count;
-		slim_position_t mutrun_length = haplosome1->mutrun_length_;
+		const MutationRunLayout &mutrun_layout = *haplosome1->mutrun_layout_;
 		int mutrun_count = haplosome1->mutrun_count_;
 		const MutationRun **haplosome1_mutruns = haplosome1->mutruns_;
 		
@@ -1082,7 +1082,7 @@ int64_t *QtSLiMHaplotypeManager::buildDistanceArrayForSubrangeAndSubtypes(void)
 			for (int mutrun_index = 0; mutrun_index < mutrun_count; ++mutrun_index)
 			{
 				// Skip mutation runs outside of the subrange we're focused on
-				if ((mutrun_length * mutrun_index > lastBase) || (mutrun_length * mutrun_index + mutrun_length - 1 < firstBase))
+				if ((mutrun_layout.RunStart(mutrun_index) > lastBase) || (mutrun_layout.RunLastPosition(mutrun_index) < firstBase))
 					continue;
 				
 				// OK, this mutrun intersects with our chosen subrange; proceed
@@ -148,6 +148,7 @@ void QtSLiMHelpOutlineDelegate::paint(QPainter *painter, const QStyleOptionViewI
                               "– registerSurvivalCallback()",
                               "– addCloned()",
                               "– addCrossed()",
+                              "– addCrossedBatch()",
                               "– addEmpty()",
                               "– addMultiRecombinant()",
                               "– addRecombinant()",
@@ -89,6 +89,7 @@
 #include <vector>
 
 #include "individual.h"
+#include "interaction_type.h"
 #include "eidos_test.h"
 #include "slim_test.h"
 #include "log_file.h"
@@ -4212,6 +4213,103 @@ void QtSLiMWindow::displayProfileResults(void)
 	}
 #endif
 	
+	//
+	//	Tree-sequence simplification metrics, presented per Species
+	//
+    for (Species *focal_species : community->all_species_)
+	{
+        if (!focal_species->RecordingTreeSequence() || (focal_species->profile_simplify_count_ == 0))
+            continue;
+        
+        double wall_time = Eidos_ElapsedProfileTime(focal_species->profile_simplify_wall_time_);
+        double chromosome_time = Eidos_ElapsedProfileTime(focal_species->profile_simplify_chromosome_time_);
+        size_t chromosome_count = focal_species->Chromosomes().size();
+        
+        tc.insertText(" \n", menlo11_d);
+		tc.insertText(" \n", optima13_d);
+		tc.insertText("Tree-sequence simplification", optima14b_d);
+        if (community->all_species_.size() > 1)
+        {
+            tc.insertText(" (", optima14b_d);
+            tc.insertText(QString::fromStdString(focal_species->avatar_), optima14b_d);
+            tc.insertText(" ", optima14b_d);
+            tc.insertText(QString::fromStdString(focal_species->name_), optima14b_d);
+            tc.insertText(")", optima14b_d);
+        }
+        tc.insertText("\n", optima14b_d);
+		tc.insertText(" \n", optima3_d);
+        
+        tc.insertText(QString("%1").arg(focal_species->profile_simplify_count_), menlo11_d);
+        tc.insertText(QString(" simplifications of %1 chromosome%2\n").arg(chromosome_count).arg(chromosome_count == 1 ? "" : "s"), optima13_d);
+        
+        tc.insertText(QString("%1 s").arg(wall_time, 0, 'f', 2), menlo11_d);
+        tc.insertText(" wall clock time simplifying chromosomes\n", optima13_d);
+        
+        tc.insertText(QString("%1 s").arg(chromosome_time, 0, 'f', 2), menlo11_d);
+        tc.insertText(" simplification time summed across chromosomes\n", optima13_d);
+        
+        tc.insertText(QString("%1x").arg((wall_time > 0.0) ? (chromosome_time / wall_time) : 1.0, 0, 'f', 2), menlo11_d);
+        tc.insertText(" speedup from simplifying chromosomes in parallel\n", optima13_d);
+	}
+	
+	//
+	//	Lost/fixed mutation removal metrics, presented per Species
+	//
+    for (Species *focal_species : community->all_species_)
+	{
+        double removal_time = Eidos_ElapsedProfileTime(focal_species->profile_fixation_time_);
+        
+        tc.insertText(" \n", menlo11_d);
+		tc.insertText(" \n", optima13_d);
+		tc.insertText("Lost/fixed mutation removal", optima14b_d);
+        if (community->all_species_.size() > 1)
+        {
+            tc.insertText(" (", optima14b_d);
+            tc.insertText(QString::fromStdString(focal_species->avatar_), optima14b_d);
+            tc.insertText(" ", optima14b_d);
+            tc.insertText(QString::fromStdString(focal_species->name_), optima14b_d);
+            tc.insertText(")", optima14b_d);
+        }
+        tc.insertText("\n", optima14b_d);
+		tc.insertText(" \n", optima3_d);
+        
+        tc.insertText(QString("%1 s").arg(removal_time, 0, 'f', 2), menlo11_d);
+        tc.insertText(" removing lost and fixed mutations\n", optima13_d);
+        
+        tc.insertText(QString("%1").arg(focal_species->profile_fixation_substitution_count_), menlo11_d);
+        tc.insertText(QString(" substitutions in %1 cycle%2\n").arg(focal_species->profile_fixation_cycle_count_).arg(focal_species->profile_fixation_cycle_count_ == 1 ? "" : "s"), optima13_d);
+        
+        tc.insertText(QString("%1").arg(focal_species->profile_fixation_mutrun_count_), menlo11_d);
+        tc.insertText(" distinct mutation runs modified to remove fixed mutations\n", optima13_d);
+	}
+	
+	//
+	//	Interaction strength cache metrics, presented per InteractionType
+	//
+    for (auto &iter : community->AllInteractionTypes())
+	{
+        InteractionType *interaction_type = iter.second;
+        int64_t hits = interaction_type->profile_strength_cache_hits_;
+        int64_t misses = interaction_type->profile_strength_cache_misses_;
+        
+        if (hits + misses == 0)
+            continue;
+        
+        tc.insertText(" \n", menlo11_d);
+		tc.insertText(" \n", optima13_d);
+		tc.insertText(QString("Interaction strength cache (i%1)\n").arg(interaction_type->interaction_type_id_), optima14b_d);
+		tc.insertText(" \n", optima3_d);
+        
+        tc.insertText(QString("%1").arg(hits), menlo11_d);
+        tc.insertText(" receiver strengths reused from the cache\n", optima13_d);
+        
+        tc.insertText(QString("%1").arg(misses), menlo11_d);
+        tc.insertText(" receiver strengths computed and cached\n", optima13_d);
+        
+        tc.insertText(QString("%1%").arg((hits * 100.0) / (hits + misses), 0, 'f', 2), menlo11_d);
+        tc.insertText(" hit rate\n", optima13_d);
+	}
+	
 	{
 		//
 		//	Memory usage metrics
@@ -4386,6 +4484,12 @@ void QtSLiMWindow::displayProfileResults(void)
 		tc.insertText(attributedStringForByteCount(mem_last_S.mutationRunExternalBuffers, final_total, colored_menlo), colored_menlo);
 		tc.insertText(" : external MutationIndex buffers\n", optima13_d);
 		
+		tc.insertText("   ", menlo11_d);
+		tc.insertText(attributedStringForByteCount(mem_tot_S.mutationRunPackedBuffers / div, average_total, colored_menlo), colored_menlo);
+		tc.insertText(" / ", optima13_d);
+		tc.insertText(attributedStringForByteCount(mem_last_S.mutationRunPackedBuffers, final_total, colored_menlo), colored_menlo);
+		tc.insertText(" : packed MutationIndex buffers\n", optima13_d);
+		
 		tc.insertText("   ", menlo11_d);
 		tc.insertText(attributedStringForByteCount(mem_tot_S.mutationRunNonneutralCaches / div, average_total, colored_menlo), colored_menlo);
 		tc.insertText(" / ", optima13_d);
@@ -2080,6 +2080,64 @@
 	}
 #endif
 	
+	//
+	//	Lost/fixed mutation removal metrics, presented per Species
+	//
+	for (Species *focal_species : community->all_species_)
+	{
+		double removal_time = Eidos_ElapsedProfileTime(focal_species->profile_fixation_time_);
+		
+		[content eidosAppendString:@"\n" attributes:menlo11_d];
+		[content eidosAppendString:@"\n" attributes:optima13_d];
+		[content eidosAppendString:@"Lost/fixed mutation removal" attributes:optima14b_d];
+		if (community->all_species_.size() > 1)
+		{
+			[content eidosAppendString:@" (" attributes:optima14b_d];
+			[content eidosAppendString:[NSString stringWithUTF8String:focal_species->avatar_.c_str()] attributes:optima14b_d];
+			[content eidosAppendString:@" " attributes:optima14b_d];
+			[content eidosAppendString:[NSString stringWithUTF8String:focal_species->name_.c_str()] attributes:optima14b_d];
+			[content eidosAppendString:@")" attributes:optima14b_d];
+		}
+		[content eidosAppendString:@"\n" attributes:optima14b_d];
+		[content eidosAppendString:@"\n" attributes:optima3_d];
+		
+		[content eidosAppendString:[NSString stringWithFormat:@"%0.2f s", removal_time] attributes:menlo11_d];
+		[content eidosAppendString:@" removing lost and fixed mutations\n" attributes:optima13_d];
+		
+		[content eidosAppendString:[NSString stringWithFormat:@"%lld", (long long int)focal_species->profile_fixation_substitution_count_] attributes:menlo11_d];
+		[content eidosAppendString:[NSString stringWithFormat:@" substitutions in %lld cycle%@\n", (long long int)focal_species->profile_fixation_cycle_count_, (focal_species->profile_fixation_cycle_count_ == 1) ? @"" : @"s"] attributes:optima13_d];
+		
+		[content eidosAppendString:[NSString stringWithFormat:@"%lld", (long long int)focal_species->profile_fixation_mutrun_count_] attributes:menlo11_d];
+		[content eidosAppendString:@" distinct mutation runs modified to remove fixed mutations\n" attributes:optima13_d];
+	}
+	
+	//
+	//	Interaction strength cache metrics, presented per InteractionType
+	//
+	for (auto &iter : community->AllInteractionTypes())
+	{
+		InteractionType *interaction_type = iter.second;
+		int64_t hits = interaction_type->profile_strength_cache_hits_;
+		int64_t misses = interaction_type->profile_strength_cache_misses_;
+		
+		if (hits + misses == 0)
+			continue;
+		
+		[content eidosAppendString:@"\n" attributes:menlo11_d];
+		[content eidosAppendString:@"\n" attributes:optima13_d];
+		[content eidosAppendString:[NSString stringWithFormat:@"Interaction strength cache (i%d)\n", (int)interaction_type->interaction_type_id_] attributes:optima14b_d];
+		[content eidosAppendString:@"\n" attributes:optima3_d];
+		
+		[content eidosAppendString:[NSString stringWithFormat:@"%lld", (long long int)hits] attributes:menlo11_d];
+		[content eidosAppendString:@" receiver strengths reused from the cache\n" attributes:optima13_d];
+		
+		[content eidosAppendString:[NSString stringWithFormat:@"%lld", (long long int)misses] attributes:menlo11_d];
+		[content eidosAppendString:@" receiver strengths computed and cached\n" attributes:optima13_d];
+		
+		[content eidosAppendString:[NSString stringWithFormat:@"%0.2f%%", (hits * 100.0) / (hits + misses)] attributes:menlo11_d];
+		[content eidosAppendString:@" hit rate\n" attributes:optima13_d];
+	}
+	
 	{
 		//
 		//	Memory usage metrics
@@ -2252,6 +2310,12 @@
 		[content appendAttributedString:[NSAttributedString attributedStringForByteCount:mem_last_S.mutationRunExternalBuffers total:final_total attributes:menlo11_d]];
 		[content eidosAppendString:@" : external MutationIndex buffers\n" attributes:optima13_d];
 		
+		[content eidosAppendString:@"   " attributes:menlo11_d];
+		[content appendAttributedString:[NSAttributedString attributedStringForByteCount:mem_tot_S.mutationRunPackedBuffers / div total:average_total attributes:menlo11_d]];
+		[content eidosAppendString:@" / " attributes:optima13_d];
+		[content appendAttributedString:[NSAttributedString attributedStringForByteCount:mem_last_S.mutationRunPackedBuffers total:final_total attributes:menlo11_d]];
+		[content eidosAppendString:@" : packed MutationIndex buffers\n" attributes:optima13_d];
+		
 		[content eidosAppendString:@"   " attributes:menlo11_d];
 		[content appendAttributedString:[NSAttributedString attributedStringForByteCount:mem_tot_S.mutationRunNonneutralCaches / div total:average_total attributes:menlo11_d]];
 		[content eidosAppendString:@" / " attributes:optima13_d];
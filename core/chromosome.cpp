@@ -672,10 +672,16 @@ void Chromosome::ChooseMutationRunLayout(void)
 			}
 			
 			mutrun_count_ = mutrun_count_base_ * mutrun_count_multiplier_;
-			mutrun_length_ = (slim_position_t)ceil((last_position_ + 1) / (double)mutrun_count_);
+			
+			slim_position_t mutrun_length = (slim_position_t)ceil((last_position_ + 1) / (double)mutrun_count_);
+			
+			mutrun_layout_.SetUniformLayout(mutrun_count_, mutrun_length);
+#if SLIM_ADAPTIVE_MUTRUN_LAYOUT
+			mutrun_layout_max_count_ = mutrun_count_;
+#endif
 			
 			if (SLiM_verbosity_level >= 2)
-				SLIM_OUTSTREAM << std::endl << "// Override mutation run count = " << mutrun_count_ << ", run length = " << mutrun_length_ << std::endl;
+				SLIM_OUTSTREAM << std::endl << "// Override mutation run count = " << mutrun_count_ << ", run length = " << mutrun_length << std::endl;
 		}
 		else
 		{
@@ -683,16 +689,97 @@ void Chromosome::ChooseMutationRunLayout(void)
 			// for simplicity we will just always start with a single run, since that is often best anyway,
 			// unless we're running multithreaded; then we start with one run per thread, generally
 			mutrun_count_ = mutrun_count_base_ * mutrun_count_multiplier_;
-			mutrun_length_ = (slim_position_t)ceil((last_position_ + 1) / (double)mutrun_count_);
+			
+			slim_position_t mutrun_length = (slim_position_t)ceil((last_position_ + 1) / (double)mutrun_count_);
 			
 			// When we are running experiments, the mutation run length needs to be a power of two so that it can be divided evenly,
 			// potentially a fairly large number of times.  We impose a maximum mutrun count of SLIM_MUTRUN_MAXIMUM_COUNT, so
 			// actually it needs to just be an exact multiple of SLIM_MUTRUN_MAXIMUM_COUNT, not an exact power of two.
-			mutrun_length_ = (slim_position_t)round(ceil(mutrun_length_ / (double)SLIM_MUTRUN_MAXIMUM_COUNT) * SLIM_MUTRUN_MAXIMUM_COUNT);
+			mutrun_length = (slim_position_t)round(ceil(mutrun_length / (double)SLIM_MUTRUN_MAXIMUM_COUNT) * SLIM_MUTRUN_MAXIMUM_COUNT);
+			
+			mutrun_layout_.SetUniformLayout(mutrun_count_, mutrun_length);
+#if SLIM_ADAPTIVE_MUTRUN_LAYOUT
+			// Experiments double the count up to SLIM_MUTRUN_MAXIMUM_COUNT, unless the chromosome is too short for experiments at all;
+			// see InitiateMutationRunExperiments().  A non-uniform layout has to leave every run room to be split that many times.
+			mutrun_layout_max_count_ = mutrun_count_;
+			
+			if (mutrun_length > SLIM_MUTRUN_MAXIMUM_COUNT)
+				while (mutrun_layout_max_count_ * 2 <= SLIM_MUTRUN_MAXIMUM_COUNT)
+					mutrun_layout_max_count_ *= 2;
+#endif
 			
 			if (SLiM_verbosity_level >= 2)
-				SLIM_OUTSTREAM << std::endl << "// Initial mutation run count = " << mutrun_count_ << ", run length = " << mutrun_length_ << std::endl;
+				SLIM_OUTSTREAM << std::endl << "// Initial mutation run count = " << mutrun_count_ << ", run length = " << mutrun_length << std::endl;
+		}
+		
+#if SLIM_ADAPTIVE_MUTRUN_LAYOUT
+		// Equal-length runs work well when crossovers and new mutations are spread evenly along the chromosome, but with strongly
+		// heterogeneous maps some runs are disrupted in nearly every gamete while others could be shared almost indefinitely.  In
+		// that case we switch to a granule-based layout with boundaries at equal quantiles of the expected disruption, so that every
+		// run is copied about equally often.  Splits and joins then keep the layout non-uniform, re-placing the new boundaries
+		// according to the current density of segregating mutations as well; see _SplitMutationRunLayout().  We keep runs at least
+		// (mutrun_layout_max_count_ / mutrun_count_) granules long, so that every run can still be split as far as experiments go.
+		if (mutrun_layout_max_count_ > 1)
+		{
+			slim_position_t covered_length = mutrun_layout_.covered_length_;
+			slim_position_t granule_length = std::max((slim_position_t)1, covered_length / SLIM_MUTRUN_LAYOUT_GRANULES);
+			int32_t granule_count = (int32_t)((covered_length + granule_length - 1) / granule_length);
+			std::vector<double> weights;
+			
+			_MutationRunLayoutWeights(weights, granule_length, granule_count, false);
+			
+			// measure the imbalance of equal-length runs at a reference resolution; each bin is a range of granules
+			int32_t bin_count = std::min(mutrun_layout_max_count_, (int32_t)64);
+			double max_bin_weight = 0.0, total_weight = 0.0;
+			
+			for (int32_t bin_index = 0; bin_index < bin_count; ++bin_index)
+			{
+				int32_t first_granule = (int32_t)(((int64_t)granule_count * bin_index) / bin_count);
+				int32_t end_granule = (int32_t)(((int64_t)granule_count * (bin_index + 1)) / bin_count);
+				double bin_weight = 0.0;
+				
+				for (int32_t granule_index = first_granule; granule_index < end_granule; ++granule_index)
+					bin_weight += weights[granule_index];
+				
+				max_bin_weight = std::max(max_bin_weight, bin_weight);
+				total_weight += bin_weight;
+			}
+			
+			double imbalance = (total_weight > 0.0) ? (max_bin_weight * bin_count / total_weight) : 1.0;
+			
+			if (imbalance >= SLIM_MUTRUN_LAYOUT_MIN_IMBALANCE)
+			{
+				std::vector<double> cumulative_weights(granule_count + 1);
+				std::vector<int32_t> boundaries(mutrun_count_ + 1);
+				int32_t min_granules = mutrun_layout_max_count_ / mutrun_count_;
+				
+				cumulative_weights[0] = 0.0;
+				for (int32_t granule_index = 0; granule_index < granule_count; ++granule_index)
+					cumulative_weights[granule_index + 1] = cumulative_weights[granule_index] + weights[granule_index];
+				
+				boundaries[0] = 0;
+				boundaries[mutrun_count_] = granule_count;
+				
+				for (int32_t run_index = 1; run_index < mutrun_count_; ++run_index)
+				{
+					double target = cumulative_weights[granule_count] * run_index / mutrun_count_;
+					int32_t boundary = (int32_t)(std::lower_bound(cumulative_weights.begin(), cumulative_weights.end(), target) - cumulative_weights.begin());
+					
+					if ((boundary > 0) && (target - cumulative_weights[boundary - 1] < cumulative_weights[boundary] - target))
+						boundary--;
+					
+					boundary = std::max(boundary, boundaries[run_index - 1] + min_granules);
+					boundary = std::min(boundary, granule_count - (mutrun_count_ - run_index) * min_granules);
+					boundaries[run_index] = boundary;
+				}
+				
+				mutrun_layout_.SetGranuleLayout(granule_length, covered_length, boundaries);
+				
+				if (SLiM_verbosity_level >= 2)
+					SLIM_OUTSTREAM << "// Mutation run lengths adapted to heterogeneous recombination/mutation maps (imbalance " << imbalance << ")" << std::endl;
+			}
 		}
+#endif
 	}
 	else
 	{
@@ -700,13 +787,13 @@ void Chromosome::ChooseMutationRunLayout(void)
 		mutrun_count_base_ = 0;
 		mutrun_count_multiplier_ = 1;
 		mutrun_count_ = 0;
-		mutrun_length_ = 0;
+		mutrun_layout_.SetUniformLayout(0, 0);
 	}
 	
-	last_position_mutrun_ = mutrun_count_ * mutrun_length_ - 1;
+	last_position_mutrun_ = mutrun_layout_.covered_length_ - 1;
 	
 	// Consistency check
-	if (((mutrun_length_ < 1) && species_.HasGenetics()) || (mutrun_count_ * mutrun_length_ <= last_position_) || (last_position_mutrun_ < last_position_))
+	if (((mutrun_layout_.RunStart(1) < 1) && species_.HasGenetics()) || (mutrun_layout_.run_count_ != mutrun_count_) || (mutrun_layout_.covered_length_ <= last_position_) || (last_position_mutrun_ < last_position_))
 		EIDOS_TERMINATION << "ERROR (Chromosome::ChooseMutationRunLayout): (internal error) math error in mutation run calculations." << EidosTerminate();
 }
 
@@ -1989,7 +2076,8 @@ void Chromosome::SetUpMutationRunContexts(void)
 		
 #pragma omp parallel default(none) shared(mutation_run_context_PERTHREAD, threadObserved) num_threads(mutation_run_context_COUNT_)
 		{
-			// Each thread allocates and initializes its own MutationRunContext, for "first touch" optimization
+			// Each thread allocates and initializes its own MutationRunContext, for "first touch" optimization; in NUMA-aware mode
+			// (slim -numa) the threads are pinned to cores, so each context stays on the NUMA node of the thread that uses it
 			int threadnum = omp_get_thread_num();
 			
 			mutation_run_context_PERTHREAD[threadnum] = new MutationRunContext();
@@ -2070,7 +2158,7 @@ void Chromosome::InitiateMutationRunExperiments(void)
 		
 		return;
 	}
-	if (mutrun_length_ <= SLIM_MUTRUN_MAXIMUM_COUNT)
+	if (mutrun_layout_.covered_length_ <= (slim_position_t)mutrun_count_ * SLIM_MUTRUN_MAXIMUM_COUNT)
 	{
 		// If the chromosome length is too short, go with that and don't run experiments;
 		// we want to guarantee that with SLIM_MUTRUN_MAXIMUM_COUNT runs each mutrun is at
@@ -2557,12 +2645,15 @@ void Chromosome::MaintainMutationRunExperiments(double p_last_gen_runtime)
 			
 			// We are splitting existing runs in two, so make a map from old mutrun index to new pair of
 			// mutrun indices; every time we encounter the same old index we will substitute the same pair.
-			species_.population_.SplitMutationRunsForChromosome(mutrun_count_ * 2, this);
+			MutationRunLayout new_layout;
+			
+			_SplitMutationRunLayout(new_layout);
+			species_.population_.SplitMutationRunsForChromosome(new_layout, this);
 			
 			// Fix the chromosome values
 			mutrun_count_multiplier_ *= 2;
 			mutrun_count_ *= 2;
-			mutrun_length_ /= 2;
+			mutrun_layout_ = std::move(new_layout);
 			
 #if MUTRUN_EXPERIMENT_OUTPUT
 			if (SLiM_verbosity_level >= 2)
@@ -2585,12 +2676,15 @@ void Chromosome::MaintainMutationRunExperiments(double p_last_gen_runtime)
 			
 			// We are joining existing runs together, so make a map from old mutrun index pairs to a new
 			// index; every time we encounter the same pair of indices we will substitute the same index.
+			MutationRunLayout new_layout;
+			
+			_JoinMutationRunLayout(new_layout);
 			species_.population_.JoinMutationRunsForChromosome(mutrun_count_ / 2, this);
 			
 			// Fix the chromosome values
 			mutrun_count_multiplier_ /= 2;
 			mutrun_count_ /= 2;
-			mutrun_length_ *= 2;
+			mutrun_layout_ = std::move(new_layout);
 			
 #if MUTRUN_EXPERIMENT_OUTPUT
 			if (SLiM_verbosity_level >= 2)
@@ -2607,6 +2701,203 @@ void Chromosome::MaintainMutationRunExperiments(double p_last_gen_runtime)
 	}
 }
 
+void Chromosome::_SplitMutationRunLayout(MutationRunLayout &p_new_layout)
+{
+#if SLIM_ADAPTIVE_MUTRUN_LAYOUT
+	if (!mutrun_layout_.uniform_)
+	{
+		// Split each run at the granule boundary nearest its weighted median, so that the two halves carry about equal weight,
+		// while leaving each half wide enough to be split again as far as experiments might go; see ChooseMutationRunLayout()
+		slim_position_t granule_length = mutrun_layout_.granule_length_;
+		int32_t granule_count = mutrun_layout_.GranuleCount();
+		int32_t new_mutrun_count = mutrun_count_ * 2;
+		int32_t min_granules = std::max(mutrun_layout_max_count_ / new_mutrun_count, (int32_t)1);
+		std::vector<double> weights;
+		
+		_MutationRunLayoutWeights(weights, granule_length, granule_count, true);
+		
+		std::vector<double> cumulative_weights(granule_count + 1);
+		std::vector<int32_t> boundaries(new_mutrun_count + 1);
+		
+		cumulative_weights[0] = 0.0;
+		for (int32_t granule_index = 0; granule_index < granule_count; ++granule_index)
+			cumulative_weights[granule_index + 1] = cumulative_weights[granule_index] + weights[granule_index];
+		
+		for (int32_t run_index = 0; run_index < mutrun_count_; ++run_index)
+		{
+			int32_t first_granule = (int32_t)(mutrun_layout_.run_starts_[run_index] / granule_length);
+			int32_t end_granule = (run_index + 1 < mutrun_count_) ? (int32_t)(mutrun_layout_.run_starts_[run_index + 1] / granule_length) : granule_count;
+			int32_t run_min_granules = std::min(min_granules, (end_granule - first_granule) / 2);
+			double first_weight = cumulative_weights[first_granule], end_weight = cumulative_weights[end_granule];
+			int32_t boundary;
+			
+			if (run_min_granules < 1)
+				EIDOS_TERMINATION << "ERROR (Chromosome::_SplitMutationRunLayout): (internal error) mutation run is too short to split." << EidosTerminate();
+			
+			if (end_weight > first_weight)
+			{
+				double target = (first_weight + end_weight) / 2.0;
+				
+				boundary = (int32_t)(std::lower_bound(cumulative_weights.begin() + first_granule, cumulative_weights.begin() + end_granule, target) - cumulative_weights.begin());
+				
+				if ((boundary > first_granule) && (target - cumulative_weights[boundary - 1] < cumulative_weights[boundary] - target))
+					boundary--;
+			}
+			else
+			{
+				boundary = first_granule + (end_granule - first_granule) / 2;
+			}
+			
+			boundary = std::max(boundary, first_granule + run_min_granules);
+			boundary = std::min(boundary, end_granule - run_min_granules);
+			
+			boundaries[run_index * 2] = first_granule;
+			boundaries[run_index * 2 + 1] = boundary;
+		}
+		
+		boundaries[new_mutrun_count] = granule_count;
+		
+		p_new_layout.SetGranuleLayout(granule_length, mutrun_layout_.covered_length_, boundaries);
+		return;
+	}
+#endif
+	
+	p_new_layout.SetUniformLayout(mutrun_count_ * 2, mutrun_layout_.uniform_length_ / 2);
+}
+
+void Chromosome::_JoinMutationRunLayout(MutationRunLayout &p_new_layout)
+{
+#if SLIM_ADAPTIVE_MUTRUN_LAYOUT
+	if (!mutrun_layout_.uniform_)
+	{
+		// Join each pair of runs, keeping the boundaries between pairs where they are
+		slim_position_t granule_length = mutrun_layout_.granule_length_;
+		int32_t new_mutrun_count = mutrun_count_ / 2;
+		std::vector<int32_t> boundaries(new_mutrun_count + 1);
+		
+		for (int32_t run_index = 0; run_index < new_mutrun_count; ++run_index)
+			boundaries[run_index] = (int32_t)(mutrun_layout_.run_starts_[run_index * 2] / granule_length);
+		
+		boundaries[new_mutrun_count] = mutrun_layout_.GranuleCount();
+		
+		p_new_layout.SetGranuleLayout(granule_length, mutrun_layout_.covered_length_, boundaries);
+		return;
+	}
+#endif
+	
+	p_new_layout.SetUniformLayout(mutrun_count_ / 2, mutrun_layout_.uniform_length_ * 2);
+}
+
+#if SLIM_ADAPTIVE_MUTRUN_LAYOUT
+void Chromosome::_MutationRunLayoutWeights(std::vector<double> &p_weights, slim_position_t p_granule_length, int32_t p_granule_count, bool p_include_segregating)
+{
+	// The disruption weight of a granule is the expected number of crossovers and new mutations in it per gamete (averaging the
+	// male and female maps if they differ), which measures how often a run containing it must be copied instead of shared.  If
+	// requested, the granule's share of the segregating mutations is averaged in with equal weight, measuring the cost of a copy.
+	std::vector<double> disruption(p_granule_count, 0.0);
+	
+	auto add_rate_map = [&disruption, p_granule_length](const std::vector<slim_position_t> &p_end_positions, const std::vector<double> &p_rates, double p_scale, slim_position_t p_start, slim_position_t p_end)
+	{
+		// add the integral of the rate map over [p_start, p_end] into the granules it covers
+		auto segment_iter = std::lower_bound(p_end_positions.begin(), p_end_positions.end(), p_start);
+		slim_position_t position = p_start;
+		
+		while ((position <= p_end) && (segment_iter != p_end_positions.end()))
+		{
+			slim_position_t segment_end = std::min(*segment_iter, p_end);
+			double rate = p_rates[segment_iter - p_end_positions.begin()] * p_scale;
+			
+			if (rate > 0.0)
+			{
+				while (position <= segment_end)
+				{
+					int32_t granule_index = (int32_t)(position / p_granule_length);
+					slim_position_t stretch_end = std::min((granule_index + 1) * p_granule_length - 1, segment_end);
+					
+					disruption[granule_index] += rate * (stretch_end - position + 1);
+					position = stretch_end + 1;
+				}
+			}
+			
+			position = segment_end + 1;
+			++segment_iter;
+		}
+	};
+	
+	if (single_recombination_map_)
+	{
+		add_rate_map(recombination_end_positions_H_, recombination_rates_H_, 1.0, 0, last_position_);
+	}
+	else
+	{
+		add_rate_map(recombination_end_positions_M_, recombination_rates_M_, 0.5, 0, last_position_);
+		add_rate_map(recombination_end_positions_F_, recombination_rates_F_, 0.5, 0, last_position_);
+	}
+	
+	// new mutations arise only within genomic elements
+	for (GenomicElement *genomic_element : genomic_elements_)
+	{
+		if (single_mutation_map_)
+		{
+			add_rate_map(mutation_end_positions_H_, mutation_rates_H_, 1.0, genomic_element->start_position_, genomic_element->end_position_);
+		}
+		else
+		{
+			add_rate_map(mutation_end_positions_M_, mutation_rates_M_, 0.5, genomic_element->start_position_, genomic_element->end_position_);
+			add_rate_map(mutation_end_positions_F_, mutation_rates_F_, 0.5, genomic_element->start_position_, genomic_element->end_position_);
+		}
+	}
+	
+	std::vector<double> segregating;
+	double disruption_total = 0.0, segregating_total = 0.0;
+	
+	for (double weight : disruption)
+		disruption_total += weight;
+	
+	if (p_include_segregating)
+	{
+		int registry_size;
+		const MutationIndex *registry = species_.population_.MutationRegistry(&registry_size);
+		Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+		
+		segregating.resize(p_granule_count, 0.0);
+		
+		for (int registry_index = 0; registry_index < registry_size; ++registry_index)
+		{
+			const Mutation *mut = mut_block_ptr + registry[registry_index];
+			
+			if (mut->chromosome_index_ == index_)
+			{
+				segregating[mut->position_ / p_granule_length] += 1.0;
+				segregating_total += 1.0;
+			}
+		}
+	}
+	
+	p_weights.assign(p_granule_count, 0.0);
+	
+	if ((disruption_total <= 0.0) && (segregating_total <= 0.0))
+	{
+		// with no information at all, weight every position equally
+		for (int32_t granule_index = 0; granule_index < p_granule_count; ++granule_index)
+			p_weights[granule_index] = 1.0;
+		
+		return;
+	}
+	
+	double disruption_scale = (disruption_total > 0.0) ? ((segregating_total > 0.0) ? 0.5 : 1.0) / disruption_total : 0.0;
+	double segregating_scale = (segregating_total > 0.0) ? ((disruption_total > 0.0) ? 0.5 : 1.0) / segregating_total : 0.0;
+	
+	for (int32_t granule_index = 0; granule_index < p_granule_count; ++granule_index)
+	{
+		p_weights[granule_index] = disruption[granule_index] * disruption_scale;
+		
+		if (segregating_total > 0.0)
+			p_weights[granule_index] += segregating[granule_index] * segregating_scale;
+	}
+}
+#endif
+
 void Chromosome::PrintMutationRunExperimentSummary(void)
 {
 #if MUTRUN_EXPERIMENT_OUTPUT
@@ -36,6 +36,7 @@
 #include "mutation_type.h"
 #include "genomic_element.h"
 #include "genomic_element_type.h"
+#include "mutation_run.h"
 #include "eidos_rng.h"
 #include "eidos_value.h"
 
@@ -189,7 +190,14 @@ private:
 	void TransitionToNewExperimentAgainstPreviousExperiment(int32_t p_new_mutrun_count);
 	void EnterStasisForMutationRunExperiments(void);
 	void MaintainMutationRunExperiments(double p_last_gen_runtime);
-	
+
+	// The layout that results from splitting every run in two, or joining every pair of runs; see ChooseMutationRunLayout()
+	void _SplitMutationRunLayout(MutationRunLayout &p_new_layout);
+	void _JoinMutationRunLayout(MutationRunLayout &p_new_layout);
+#if SLIM_ADAPTIVE_MUTRUN_LAYOUT
+	void _MutationRunLayoutWeights(std::vector<double> &p_weights, slim_position_t p_granule_length, int32_t p_granule_count, bool p_include_segregating);
+#endif
+
 	// Erroring during partial initialization
 	void CheckPartialInitializationForProperty(EidosGlobalStringID p_property_id);
 	void CheckPartialInitializationForMethod(EidosGlobalStringID p_method_id);
@@ -256,8 +264,11 @@ public:
 	int32_t mutrun_count_base_;								// minimum number of mutruns used (number of threads, typically); can be multiplied by a factor
 	int32_t mutrun_count_multiplier_;						// the current factor by which mutrun_count_base_ is multiplied; a power of two in [1, 1024]
 	int32_t mutrun_count_;									// the number of mutation runs being used for all haplosomes: base x multiplier
-	slim_position_t mutrun_length_;							// the length, in base pairs, of each mutation run; the last run might not use its full length
-	slim_position_t last_position_mutrun_;					// (mutrun_count_ * mutrun_length_ - 1), for complete coverage in crossover-mutation
+	MutationRunLayout mutrun_layout_;						// the positions covered by each mutation run; the last run might extend past last_position_
+	slim_position_t last_position_mutrun_;					// the last position covered by the mutation runs, for complete coverage in crossover-mutation
+#if SLIM_ADAPTIVE_MUTRUN_LAYOUT
+	int32_t mutrun_layout_max_count_ = 0;					// the most runs a non-uniform layout may be split into; each run spans >= max / count granules
+#endif
 	
 	std::string color_sub_;										// color to use for substitutions by default (in SLiMgui)
 	float color_sub_red_, color_sub_green_, color_sub_blue_;	// cached color components from color_sub_; should always be in sync
@@ -737,7 +748,7 @@ inline __attribute__((always_inline)) Haplosome *Chromosome::NewHaplosome_NONNUL
 				free(back->mutruns_);
 			
 			back->mutrun_count_ = mutrun_count_;
-			back->mutrun_length_ = mutrun_length_;
+			//back->mutrun_layout_ = &mutrun_layout_;		// guaranteed already set
 			
 			if (mutrun_count_ <= SLIM_HAPLOSOME_MUTRUN_BUFSIZE)
 			{
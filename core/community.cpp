@@ -31,6 +31,7 @@
 #include "subpopulation.h"
 #include "interaction_type.h"
 #include "log_file.h"
+#include "slim_native_callback.h"
 
 #include <iostream>
 #include <iomanip>
@@ -705,240 +706,37 @@ std::vector<SLiMEidosBlock*> Community::AllScriptBlocksForSpecies(Species *p_spe
 
 void Community::OptimizeScriptBlock(SLiMEidosBlock *p_script_block)
 {
-	// The goal here is to look for specific structures in callbacks that we are able to optimize by short-circuiting
-	// the callback interpretation entirely and replacing it with equivalent C++ code.  This is extremely messy, so
-	// we're not going to do this for very many cases, but sometimes it is worth it.
-	if (!p_script_block->has_cached_optimization_)
+	// The goal here is to look for fitnessEffect() and mutationEffect() callbacks simple enough that we can short-circuit
+	// interpretation entirely, compiling them into a SLiMNativeCallback that evaluates the same expression in C++.  Callbacks
+	// that return a constant are already handled with cached_return_value_, so we skip those.  See slim_native_callback.h.
+	if (p_script_block->has_cached_optimization_)
+		return;
+	if ((p_script_block->type_ != SLiMEidosBlockType::SLiMEidosFitnessEffectCallback) && (p_script_block->type_ != SLiMEidosBlockType::SLiMEidosMutationEffectCallback))
+		return;
+	
+	const EidosASTNode *base_node = p_script_block->compound_statement_node_;
+	
+	if (base_node->cached_return_value_)
+		return;
+	
+	std::string failure_reason;
+	
+	p_script_block->native_callback_ = SLiMNativeCallback::Compile(p_script_block, failure_reason);
+	p_script_block->has_cached_optimization_ = (p_script_block->native_callback_ != nullptr);
+	
+	if (SLiM_verbosity_level >= 2)
 	{
-		if (p_script_block->type_ == SLiMEidosBlockType::SLiMEidosFitnessEffectCallback)
-		{
-			const EidosASTNode *base_node = p_script_block->compound_statement_node_;
-			
-			if ((base_node->token_->token_type_ == EidosTokenType::kTokenLBrace) && (base_node->children_.size() == 1))
-			{
-				bool opt_dnorm1_candidate = true;
-				const EidosASTNode *expr_node = base_node->children_[0];
-				
-				// we must have an intervening "return", which we jump down through
-				if ((expr_node->token_->token_type_ == EidosTokenType::kTokenReturn) && (expr_node->children_.size() == 1))
-				{
-					expr_node = expr_node->children_[0];
-					
-					// parse an optional constant at the beginning, like 1.0 + ...
-					double added_constant = NAN;
-					
-					if ((expr_node->token_->token_type_ == EidosTokenType::kTokenPlus) && (expr_node->children_.size() == 2))
-					{
-						const EidosASTNode *constant_node = expr_node->children_[0];
-						const EidosASTNode *rhs_node = expr_node->children_[1];
-						
-						if (constant_node->HasCachedNumericValue())
-						{
-							added_constant = constant_node->CachedNumericValue();
-							expr_node = rhs_node;
-						}
-						else
-							opt_dnorm1_candidate = false;
-					}
-					else
-					{
-						added_constant = 0.0;
-					}
-					
-					// parse an optional divisor at the end, ... / div
-					double denominator = NAN;
-					
-					if ((expr_node->token_->token_type_ == EidosTokenType::kTokenDiv) && (expr_node->children_.size() == 2))
-					{
-						const EidosASTNode *numerator_node = expr_node->children_[0];
-						const EidosASTNode *denominator_node = expr_node->children_[1];
-						
-						if (denominator_node->HasCachedNumericValue())
-						{
-							denominator = denominator_node->CachedNumericValue();
-							expr_node = numerator_node;
-						}
-						else
-							opt_dnorm1_candidate = false;
-					}
-					else
-					{
-						denominator = 1.0;
-					}
-					
-					// parse the dnorm() function call
-					if (opt_dnorm1_candidate && (expr_node->token_->token_type_ == EidosTokenType::kTokenLParen) && (expr_node->children_.size() >= 2))
-					{
-						const EidosASTNode *call_node = expr_node->children_[0];
-						
-						if ((call_node->token_->token_type_ == EidosTokenType::kTokenIdentifier) && (call_node->token_->token_string_ == "dnorm"))
-						{
-							int child_count = (int)expr_node->children_.size();
-							const EidosASTNode *x_node = expr_node->children_[1];
-							const EidosASTNode *mean_node = (child_count >= 3) ? expr_node->children_[2] : nullptr;
-							const EidosASTNode *sd_node = (child_count >= 4) ? expr_node->children_[3] : nullptr;
-							double mean_value = 0.0, sd_value = 1.0;
-							
-							// resolve named arguments
-							if ((x_node->token_->token_type_ == EidosTokenType::kTokenAssign) && (x_node->children_.size() == 2))
-							{
-								const EidosASTNode *name_node = x_node->children_[0];
-								const EidosASTNode *value_node = x_node->children_[1];
-								
-								if ((name_node->token_->token_type_ == EidosTokenType::kTokenIdentifier) && (name_node->token_->token_string_ == "x"))
-									x_node = value_node;
-								else
-									opt_dnorm1_candidate = false;
-							}
-							if (mean_node && (mean_node->token_->token_type_ == EidosTokenType::kTokenAssign) && (mean_node->children_.size() == 2))
-							{
-								const EidosASTNode *name_node = mean_node->children_[0];
-								const EidosASTNode *value_node = mean_node->children_[1];
-								
-								if ((name_node->token_->token_type_ == EidosTokenType::kTokenIdentifier) && (name_node->token_->token_string_ == "mean"))
-									mean_node = value_node;
-								else
-									opt_dnorm1_candidate = false;
-							}
-							if (sd_node && (sd_node->token_->token_type_ == EidosTokenType::kTokenAssign) && (sd_node->children_.size() == 2))
-							{
-								const EidosASTNode *name_node = sd_node->children_[0];
-								const EidosASTNode *value_node = sd_node->children_[1];
-								
-								if ((name_node->token_->token_type_ == EidosTokenType::kTokenIdentifier) && (name_node->token_->token_string_ == "sd"))
-									sd_node = value_node;
-								else
-									opt_dnorm1_candidate = false;
-							}
-							
-							// the mean and sd parameters of dnorm can be omitted in the below calls, but if they are given, get their values
-							if (mean_node)
-							{
-								if (mean_node->HasCachedNumericValue())
-									mean_value = mean_node->CachedNumericValue();
-								else
-									opt_dnorm1_candidate = false;
-							}
-							
-							if (sd_node)
-							{
-								if (sd_node->HasCachedNumericValue())
-									sd_value = sd_node->CachedNumericValue();
-								else
-									opt_dnorm1_candidate = false;
-							}
-							
-							// parse the x argument to dnorm, which can take several different forms
-							if (opt_dnorm1_candidate)
-							{
-								if ((x_node->token_->token_type_ == EidosTokenType::kTokenMinus) && (x_node->children_.size() == 2) && (mean_value == 0.0))
-								{
-									const EidosASTNode *lhs_node = x_node->children_[0];
-									const EidosASTNode *rhs_node = x_node->children_[1];
-									const EidosASTNode *dot_node = nullptr, *constant_node = nullptr;
-									
-									if (lhs_node->token_->token_type_ == EidosTokenType::kTokenDot)
-									{
-										dot_node = lhs_node;
-										constant_node = rhs_node;
-									}
-									else if (rhs_node->token_->token_type_ == EidosTokenType::kTokenDot)
-									{
-										dot_node = rhs_node;
-										constant_node = lhs_node;
-									}
-									
-									if (dot_node && constant_node && (dot_node->children_.size() == 2) && constant_node->HasCachedNumericValue())
-									{
-										const EidosASTNode *var_node = dot_node->children_[0];
-										const EidosASTNode *prop_node = dot_node->children_[1];
-										
-										mean_value = constant_node->CachedNumericValue();
-										
-										if ((var_node->token_->token_type_ == EidosTokenType::kTokenIdentifier) && (var_node->token_->token_string_ == "individual")
-											&& (prop_node->token_->token_type_ == EidosTokenType::kTokenIdentifier) && (prop_node->token_->token_string_ == "tagF"))
-										{
-											// callback of the form { return D + dnorm(individual.tagF - A, 0.0, B) / C; }
-											// callback of the form { return D + dnorm(individual.tagF - A, 0.0, B); }
-											// callback of the form { return D + dnorm(A - individual.tagF, 0.0, B) / C; }
-											// callback of the form { return D + dnorm(A - individual.tagF, 0.0, B); }
-											p_script_block->has_cached_optimization_ = true;
-											p_script_block->has_cached_opt_dnorm1_ = true;
-											p_script_block->cached_opt_A_ = mean_value;
-											p_script_block->cached_opt_B_ = sd_value;
-											p_script_block->cached_opt_C_ = denominator;
-											p_script_block->cached_opt_D_ = added_constant;
-										}
-									}
-								}
-								else if ((x_node->token_->token_type_ == EidosTokenType::kTokenDot) && (x_node->children_.size() == 2))
-								{
-									const EidosASTNode *var_node = x_node->children_[0];
-									const EidosASTNode *prop_node = x_node->children_[1];
-									
-									if ((var_node->token_->token_type_ == EidosTokenType::kTokenIdentifier) && (var_node->token_->token_string_ == "individual")
-										&& (prop_node->token_->token_type_ == EidosTokenType::kTokenIdentifier) && (prop_node->token_->token_string_ == "tagF"))
-									{
-										// callback of the form { return D + dnorm(individual.tagF, A, B) / C; }
-										// callback of the form { return D + dnorm(individual.tagF, A, B); }
-										p_script_block->has_cached_optimization_ = true;
-										p_script_block->has_cached_opt_dnorm1_ = true;
-										p_script_block->cached_opt_A_ = mean_value;
-										p_script_block->cached_opt_B_ = sd_value;
-										p_script_block->cached_opt_C_ = denominator;
-										p_script_block->cached_opt_D_ = added_constant;
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-			
-//			if (p_script_block->has_cached_optimization_)
-//				std::cout << "optimized:" << std::endl << "   " << base_node->token_->token_string_ << std::endl;
-//			else
-//				std::cout << "NOT OPTIMIZED:" << std::endl << "   " << base_node->token_->token_string_ << std::endl;
-		}
-		else if (p_script_block->type_ == SLiMEidosBlockType::SLiMEidosMutationEffectCallback)
-		{
-			const EidosASTNode *base_node = p_script_block->compound_statement_node_;
-			
-			if ((base_node->token_->token_type_ == EidosTokenType::kTokenLBrace) && (base_node->children_.size() == 1))
-			{
-				const EidosASTNode *expr_node = base_node->children_[0];
-				
-				// we must have an intervening "return", which we jump down through
-				if ((expr_node->token_->token_type_ == EidosTokenType::kTokenReturn) && (expr_node->children_.size() == 1))
-				{
-					expr_node = expr_node->children_[0];
-					
-					if ((expr_node->token_->token_type_ == EidosTokenType::kTokenDiv) && (expr_node->children_.size() == 2))
-					{
-						const EidosASTNode *numerator_node = expr_node->children_[0];
-						const EidosASTNode *denominator_node = expr_node->children_[1];
-						
-						if (numerator_node->HasCachedNumericValue())
-						{
-							double numerator = numerator_node->CachedNumericValue();
-							
-							if ((denominator_node->token_->token_type_ == EidosTokenType::kTokenIdentifier) && (denominator_node->token_->token_string_ == "effect"))
-							{
-								// callback of the form { return A/effect; }
-								p_script_block->has_cached_optimization_ = true;
-								p_script_block->has_cached_opt_reciprocal = true;
-								p_script_block->cached_opt_A_ = numerator;
-							}
-						}
-					}
-				}
-			}
-			
-//			if (p_script_block->has_cached_optimization_)
-//				std::cout << "optimized:" << std::endl << "   " << base_node->token_->token_string_ << std::endl;
-//			else
-//				std::cout << "NOT OPTIMIZED:" << std::endl << "   " << base_node->token_->token_string_ << std::endl;
-		}
+		SLIM_OUTSTREAM << std::endl << "// " << ((p_script_block->type_ == SLiMEidosBlockType::SLiMEidosFitnessEffectCallback) ? "fitnessEffect()" : "mutationEffect()") << " callback ";
+		
+		if (p_script_block->block_id_ != -1)
+			SLIM_OUTSTREAM << "s" << p_script_block->block_id_ << " ";
+		
+		SLIM_OUTSTREAM << "(line " << (base_node->token_->token_line_ + 1) << ") ";
+		
+		if (p_script_block->has_cached_optimization_)
+			SLIM_OUTSTREAM << "compiled to native code" << std::endl;
+		else
+			SLIM_OUTSTREAM << "not compiled to native code: " << failure_reason << std::endl;
 	}
 }
 
@@ -3510,6 +3308,30 @@ void Community::StartProfiling(void)
 	}
 #endif
 	
+	// zero out tree-sequence simplification metrics
+	for (Species *focal_species : all_species_)
+	{
+		focal_species->profile_simplify_count_ = 0;
+		focal_species->profile_simplify_wall_time_ = 0;
+		focal_species->profile_simplify_chromosome_time_ = 0;
+	}
+	
+	// zero out lost/fixed mutation removal metrics
+	for (Species *focal_species : all_species_)
+	{
+		focal_species->profile_fixation_time_ = 0;
+		focal_species->profile_fixation_cycle_count_ = 0;
+		focal_species->profile_fixation_substitution_count_ = 0;
+		focal_species->profile_fixation_mutrun_count_ = 0;
+	}
+	
+	// zero out interaction strength cache metrics
+	for (auto &iter : interaction_types_)
+	{
+		iter.second->profile_strength_cache_hits_ = 0;
+		iter.second->profile_strength_cache_misses_ = 0;
+	}
+	
 	// zero out memory usage metrics
 	EIDOS_BZERO(&profile_last_memory_usage_Community, sizeof(SLiMMemoryUsage_Community));
 	EIDOS_BZERO(&profile_total_memory_usage_Community, sizeof(SLiMMemoryUsage_Community));
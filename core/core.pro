@@ -121,6 +121,7 @@ SOURCES += \
     slim_eidos_block.cpp \
     slim_functions.cpp \
     slim_globals.cpp \
+    slim_native_callback.cpp \
     slim_test.cpp \
     slim_test_core.cpp \
     slim_test_genetics.cpp \
@@ -150,6 +151,7 @@ HEADERS += \
     slim_eidos_block.h \
     slim_functions.h \
     slim_globals.h \
+    slim_native_callback.h \
     slim_test.h \
     sparse_vector.h \
     spatial_kernel.h \
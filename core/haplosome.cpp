@@ -27,6 +27,7 @@
 #include "polymorphism.h"
 #include "subpopulation.h"
 #include "eidos_sorting.h"
+#include "eidos_simd.h"
 
 #include <algorithm>
 #include <string>
@@ -239,7 +240,7 @@ void Haplosome::MakeNull(void)
 		mutruns_ = nullptr;
 		
 		mutrun_count_ = 0;
-		mutrun_length_ = 0;
+		mutrun_layout_ = nullptr;
 	}
 }
 
@@ -257,7 +258,7 @@ void Haplosome::ReinitializeHaplosomeToNull(Individual *individual)
 		
 		// chromosome_index_ remains untouched; we still belong to the same chromosome
 		mutrun_count_ = 0;
-		mutrun_length_ = 0;
+		mutrun_layout_ = nullptr;
 	}
 }
 
@@ -277,7 +278,7 @@ void Haplosome::ReinitializeHaplosomeToNonNull(Individual *individual, Chromosom
 	{
 		// was a null haplosome, needs to become not null
 		mutrun_count_ = p_chromosome->mutrun_count_;
-		mutrun_length_ = p_chromosome->mutrun_length_;
+		mutrun_layout_ = &p_chromosome->mutrun_layout_;
 		
 		if (mutrun_count_ <= SLIM_HAPLOSOME_MUTRUN_BUFSIZE)
 		{
@@ -302,7 +303,7 @@ void Haplosome::ReinitializeHaplosomeToNonNull(Individual *individual, Chromosom
 			free(mutruns_);
 		
 		mutrun_count_ = p_chromosome->mutrun_count_;
-		mutrun_length_ = p_chromosome->mutrun_length_;
+		mutrun_layout_ = &p_chromosome->mutrun_layout_;
 		
 		if (mutrun_count_ <= SLIM_HAPLOSOME_MUTRUN_BUFSIZE)
 		{
@@ -689,7 +690,7 @@ EidosValue_SP Haplosome::ExecuteMethod_Accelerated_containsMarkerMutation(EidosO
 			bool null_haplosome_seen = false;
 			
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_CONTAINS_MARKER_MUT);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(p_elements_size) firstprivate(p_elements, mutation_type_ptr, marker_position, last_position, result_logical_vec) reduction(||: null_haplosome_seen) if(p_elements_size >= EIDOS_OMPMIN_CONTAINS_MARKER_MUT) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(p_elements_size) firstprivate(p_elements, mutation_type_ptr, marker_position, last_position, result_logical_vec) reduction(||: null_haplosome_seen) if((int64_t)p_elements_size >= EIDOS_OMPMIN_CONTAINS_MARKER_MUT) num_threads(thread_count)
 			for (size_t element_index = 0; element_index < p_elements_size; ++element_index)
 			{
 				Haplosome *element = (Haplosome *)(p_elements[element_index]);
@@ -877,7 +878,7 @@ EidosValue_SP Haplosome::ExecuteMethod_Accelerated_countOfMutationsOfType(EidosO
 	bool saw_error = false;
 	
 	EIDOS_THREAD_COUNT(gEidos_OMP_threads_G_COUNT_OF_MUTS_OF_TYPE);
-#pragma omp parallel for schedule(dynamic, 1) default(none) shared(p_elements_size) firstprivate(p_elements, mut_block_ptr, mutation_type_ptr, integer_result, mutrun_count) reduction(||: saw_error) if(p_elements_size >= EIDOS_OMPMIN_G_COUNT_OF_MUTS_OF_TYPE) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(p_elements_size) firstprivate(p_elements, mut_block_ptr, mutation_type_ptr, integer_result, mutrun_count) reduction(||: saw_error) if((int64_t)p_elements_size >= EIDOS_OMPMIN_G_COUNT_OF_MUTS_OF_TYPE) num_threads(thread_count)
 	for (size_t element_index = 0; element_index < p_elements_size; ++element_index)
 	{
 		Haplosome *element = (Haplosome *)(p_elements[element_index]);
@@ -1486,22 +1487,15 @@ void Haplosome::PrintHaplosomes_MS(std::ostream &p_out, std::vector<Haplosome *>
 		std::swap(sorted_polymorphisms, filtered_polymorphisms);
 	}
 	
-	// make a hash table that looks up the genotype string position from a mutation pointer
-#if EIDOS_ROBIN_HOOD_HASHING
-	robin_hood::unordered_flat_map<const Mutation*, int> genotype_string_positions;
-	//typedef robin_hood::pair<const Mutation*, int> MAP_PAIR;
-#elif STD_UNORDERED_MAP_HASHING
-	std::unordered_map<const Mutation*, int> genotype_string_positions;
-	//typedef std::pair<const Mutation*, int> MAP_PAIR;
-#endif
-	int genotype_string_position = 0;
+	// build a bit-packed genotype matrix for the sample, with one row per polymorphism in sorted order
+	std::vector<MutationIndex> sorted_mutations;
 	
-	try {
-		for (const Polymorphism &polymorphism : sorted_polymorphisms) 
-			genotype_string_positions.emplace(polymorphism.mutation_ptr_, genotype_string_position++);
-	} catch (...) {
-		EIDOS_TERMINATION << "ERROR (Haplosome::PrintHaplosomes_MS): (internal error) SLiM encountered a raise from an internal hash table; please report this." << EidosTerminate(nullptr);
-	}
+	sorted_mutations.reserve(sorted_polymorphisms.size());
+	
+	for (const Polymorphism &polymorphism : sorted_polymorphisms)
+		sorted_mutations.emplace_back(polymorphism.mutation_ptr_->BlockIndex());
+	
+	GenotypeMatrix genotypes((const Haplosome * const *)p_haplosomes.data(), sample_size, sorted_mutations.data(), (int64_t)sorted_mutations.size());
 	
 	// print header
 	p_out << "//" << std::endl << "segsites: " << sorted_polymorphisms.size() << std::endl;
@@ -1530,78 +1524,36 @@ void Haplosome::PrintHaplosomes_MS(std::ostream &p_out, std::vector<Haplosome *>
 	}
 	
 	// print the sample's genotypes
+	int64_t segsite_count = genotypes.MutationCount();
+	std::string genotype(segsite_count, '0');
+	
 	for (slim_popsize_t j = 0; j < sample_size; j++)														// go through all individuals
 	{
-		Haplosome &haplosome = *p_haplosomes[j];
-		std::string genotype(sorted_polymorphisms.size(), '0'); // fill with 0s
-		
-		for (int run_index = 0; run_index < haplosome.mutrun_count_; ++run_index)
-		{
-			const MutationRun *mutrun = haplosome.mutruns_[run_index];
-			int mut_count = mutrun->size();
-			const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
-			
-			for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-			{
-				const Mutation *mutation = mut_block_ptr + mut_ptr[mut_index];
-				auto found_position = genotype_string_positions.find(mutation);
-				
-				// BCH 4/24/2019: when p_filter_monomorphic is true, mutations in a given haplosome may not exist in the position map
-				if (found_position != genotype_string_positions.end())
-					genotype.replace(found_position->second, 1, "1");
-			}
-		}
+		for (int64_t segsite_index = 0; segsite_index < segsite_count; ++segsite_index)
+			genotype[segsite_index] = (genotypes.Contains(segsite_index, j) ? '1' : '0');
 		
 		p_out << genotype << std::endl;
 	}
 }
 
-inline void EmitHaplosomeCall_Nuc_Simplify(std::ostream &p_out, const Haplosome &haplosome, std::vector<Polymorphism *> &nuc_based, slim_position_t mut_position, int *allele_index_for_nuc)
-{
-	// Find and emit the nuc-based mut contained by this haplosome, if any.  If more than one nuc-based mut is contained, it is an error.
-	int contained_mut_index = -1;
-	
-	for (int muts_index = 0; muts_index < (int)nuc_based.size(); ++muts_index)
-	{
-		const Mutation *mutation = nuc_based[muts_index]->mutation_ptr_;
-		
-		if (haplosome.contains_mutation(mutation))
-		{
-			if (contained_mut_index == -1)
-				contained_mut_index = muts_index;
-			else
-				EIDOS_TERMINATION << "ERROR (EmitHaplosomeCall_Nuc): more than one nucleotide-based mutation encountered at the same position (" << mut_position << ") in the same haplosome; the nucleotide cannot be called." << EidosTerminate();
-		}
-	}
-	
-	if (contained_mut_index == -1)
-		p_out << '0';
-	else
-		p_out << allele_index_for_nuc[nuc_based[contained_mut_index]->mutation_ptr_->nucleotide_];
-}
-
-inline void EmitHaplosomeCall_Nuc(std::ostream &p_out, const Haplosome &haplosome, std::vector<Polymorphism *> &nuc_based, slim_position_t mut_position)
+// Find the nucleotide-based mutation at mut_position contained by the haplosome in column p_column, if any, and return its index
+// in nuc_based, or -1 if there is none.  If more than one nucleotide-based mutation is contained, it is an error.
+static inline int _VCFNucleotideCallIndex(const GenotypeMatrix &p_genotypes, int64_t p_column, const Polymorphism *p_first_polymorphism, const std::vector<Polymorphism *> &nuc_based, slim_position_t mut_position)
 {
-	// Find and emit the nuc-based mut contained by this haplosome, if any.  If more than one nuc-based mut is contained, it is an error.
 	int contained_mut_index = -1;
 	
 	for (int muts_index = 0; muts_index < (int)nuc_based.size(); ++muts_index)
 	{
-		const Mutation *mutation = nuc_based[muts_index]->mutation_ptr_;
-		
-		if (haplosome.contains_mutation(mutation))
+		if (p_genotypes.Contains(nuc_based[muts_index] - p_first_polymorphism, p_column))
 		{
 			if (contained_mut_index == -1)
 				contained_mut_index = muts_index;
 			else
-				EIDOS_TERMINATION << "ERROR (EmitHaplosomeCall_Nuc): more than one nucleotide-based mutation encountered at the same position (" << mut_position << ") in the same haplosome; the nucleotide cannot be called." << EidosTerminate();
+				EIDOS_TERMINATION << "ERROR (Haplosome::_PrintVCF): more than one nucleotide-based mutation encountered at the same position (" << mut_position << ") in the same haplosome; the nucleotide cannot be called." << EidosTerminate();
 		}
 	}
 	
-	if (contained_mut_index == -1)
-		p_out << '0';
-	else
-		p_out << (contained_mut_index + 1);
+	return contained_mut_index;
 }
 
 // print the sample represented by haplosomes, using "vcf" format
@@ -1609,7 +1561,7 @@ inline void EmitHaplosomeCall_Nuc(std::ostream &p_out, const Haplosome &haplosom
 // depending on the intrinsic ploidy of p_chromosome the calls will be diploid or haploid; if diploid,
 // calls where one of a pair of haplosomes is null will be emitted as a haploid call; if all haplosomes
 // for a given individual are null, the call emitted will be "~".
-void Haplosome::PrintHaplosomes_VCF(std::ostream &p_out, std::vector<Haplosome *> &p_haplosomes, const Chromosome &p_chromosome, bool p_groupAsIndividuals, bool p_output_multiallelics, bool p_simplify_nucs, bool p_output_nonnucs)
+void Haplosome::PrintHaplosomes_VCF(std::ostream &p_out, std::vector<Haplosome *> &p_haplosomes, const Chromosome &p_chromosome, bool p_groupAsIndividuals, bool p_output_multiallelics, bool p_simplify_nucs, bool p_output_nonnucs, VCFOutputFormat p_format)
 {
 	Species &species = p_chromosome.species_;
 	bool nucleotide_based = species.IsNucleotideBased();
@@ -1636,8 +1588,11 @@ void Haplosome::PrintHaplosomes_VCF(std::ostream &p_out, std::vector<Haplosome *
 		individual_count = haplosome_count;
 	}
 	
-	// print the VCF header
-	p_out << "##fileformat=VCFv4.2" << std::endl;
+	// print the VCF header; for BCF output, the writer collects the header text and writes it out in EndHeader()
+	VCFRecordWriter writer(p_out, p_format, nucleotide_based, p_output_multiallelics, p_output_nonnucs);
+	std::ostream &header_out = writer.HeaderStream();
+	
+	header_out << "##fileformat=VCFv4.2" << std::endl;
 	
 	{
 		time_t rawtime;
@@ -1648,58 +1603,42 @@ void Haplosome::PrintHaplosomes_VCF(std::ostream &p_out, std::vector<Haplosome *
 		localtime_r(&rawtime, &timeinfo);
 		strftime(buffer, 25, "%Y%m%d", &timeinfo);
 		
-		p_out << "##fileDate=" << std::string(buffer) << std::endl;
+		header_out << "##fileDate=" << std::string(buffer) << std::endl;
 	}
 	
-	p_out << "##source=SLiM" << std::endl;
+	header_out << "##source=SLiM" << std::endl;
 	
 	// BCH 10 July 2019: output haplosome pedigree IDs, if available, for all of the haplosomes being output.
 	// It would be nice to be able to output individual pedigree IDs, but since we are working with a
 	// vector of haplosomes there is no guarantee that the pairs of haplosomes here come from the same individuals.
 	if (pedigrees_enabled && (haplosome_count > 0))
 	{
-		p_out << "##slimHaplosomePedigreeIDs=";
+		header_out << "##slimHaplosomePedigreeIDs=";
 		
 		for (slim_popsize_t haplosome_index = 0; haplosome_index < haplosome_count; haplosome_index++)
 		{
 			if (haplosome_index > 0)
-				p_out << ",";
-			p_out << p_haplosomes[haplosome_index]->haplosome_id_;
+				header_out << ",";
+			header_out << p_haplosomes[haplosome_index]->haplosome_id_;
 		}
 		
-		p_out << std::endl;
+		header_out << std::endl;
 	}
 	
-	// BCH 6 March 2019: Note that all of the INFO fields that provide per-mutation information have been
-	// changed from a Number of 1 to a Number of ., since in nucleotide-based models we can call more than
-	// one allele in a single call line (unlike in non-nucleotide-based models).
-	p_out << "##INFO=<ID=MID,Number=.,Type=Integer,Description=\"Mutation ID in SLiM\">" << std::endl;
-	p_out << "##INFO=<ID=S,Number=.,Type=Float,Description=\"Selection Coefficient\">" << std::endl;
-	p_out << "##INFO=<ID=DOM,Number=.,Type=Float,Description=\"Dominance\">" << std::endl;
-	// Note that at present we do not output the hemizygous dominance coefficient; too edge
-	p_out << "##INFO=<ID=PO,Number=.,Type=Integer,Description=\"Population of Origin\">" << std::endl;
-	p_out << "##INFO=<ID=TO,Number=.,Type=Integer,Description=\"Tick of Origin\">" << std::endl;			// changed to ticks for 4.0, and changed "GO" to "TO"
-	p_out << "##INFO=<ID=MT,Number=.,Type=Integer,Description=\"Mutation Type\">" << std::endl;
-	p_out << "##INFO=<ID=AC,Number=.,Type=Integer,Description=\"Allele Count\">" << std::endl;
-	p_out << "##INFO=<ID=DP,Number=1,Type=Integer,Description=\"Total Depth\">" << std::endl;
-	if (p_output_multiallelics && !nucleotide_based)
-		p_out << "##INFO=<ID=MULTIALLELIC,Number=0,Type=Flag,Description=\"Multiallelic\">" << std::endl;
-	if (nucleotide_based)
-		p_out << "##INFO=<ID=AA,Number=1,Type=String,Description=\"Ancestral Allele\">" << std::endl;
-	if (p_output_nonnucs && nucleotide_based)
-		p_out << "##INFO=<ID=NONNUC,Number=0,Type=Flag,Description=\"Non-nucleotide-based\">" << std::endl;
-	p_out << "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">" << std::endl;
-	p_out << "##contig=<ID=1,URL=https://github.com/MesserLab/SLiM>" << std::endl;
-	p_out << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT";
+	writer.WriteHeaderDefinitions(std::vector<const Chromosome *>{&p_chromosome});
+	
+	header_out << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT";
 	
 	for (slim_popsize_t individual_index = 0; individual_index < individual_count; individual_index++)
-		p_out << "\ti" << individual_index;
-	p_out << std::endl;
+		header_out << "\ti" << individual_index;
+	header_out << std::endl;
 	
-	Haplosome::_PrintVCF(p_out, (const Haplosome **)p_haplosomes.data(), haplosome_count, p_chromosome, p_groupAsIndividuals, p_simplify_nucs, p_output_nonnucs, p_output_multiallelics);
+	writer.EndHeader();
+	
+	Haplosome::_PrintVCF(writer, (const Haplosome **)p_haplosomes.data(), haplosome_count, p_chromosome, /* p_contig_index */ 0, p_groupAsIndividuals, p_simplify_nucs, p_output_nonnucs, p_output_multiallelics);
 }
 
-void Haplosome::_PrintVCF(std::ostream &p_out, const Haplosome **p_haplosomes, int64_t p_haplosomes_count, const Chromosome &p_chromosome, bool p_groupAsIndividuals, bool p_simplify_nucs, bool p_output_nonnucs, bool p_output_multiallelics)
+void Haplosome::_PrintVCF(VCFRecordWriter &p_writer, const Haplosome **p_haplosomes, int64_t p_haplosomes_count, const Chromosome &p_chromosome, int p_contig_index, bool p_groupAsIndividuals, bool p_simplify_nucs, bool p_output_nonnucs, bool p_output_multiallelics)
 {
 	ChromosomeType chromosome_type = p_chromosome.Type();
 	int intrinsic_ploidy = p_chromosome.IntrinsicPloidy();
@@ -1707,7 +1646,6 @@ void Haplosome::_PrintVCF(std::ostream &p_out, const Haplosome **p_haplosomes, i
 	bool nucleotide_based = species.IsNucleotideBased();
 	NucleotideArray *ancestral_seq = p_chromosome.AncestralSequence();
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
-	int64_t individual_count;
 	
 	// if groupAsIndividuals is false, we just act as though the chromosome is haploid
 	// this option is not available for Individual::PrintIndividuals_VCF() since it doesn't
@@ -1715,17 +1653,8 @@ void Haplosome::_PrintVCF(std::ostream &p_out, const Haplosome **p_haplosomes, i
 	if (!p_groupAsIndividuals)
 		intrinsic_ploidy = 1;
 	
-	if (intrinsic_ploidy == 2)
-	{
-		if (p_haplosomes_count % 2 == 1)
-			EIDOS_TERMINATION << "ERROR (Haplosome::_PrintVCF): Haplosome vector must be an even length for chromosome type \"" << chromosome_type << "\", since haplosomes are paired into individuals." << EidosTerminate();
-		
-		individual_count = p_haplosomes_count / 2;
-	}
-	else
-	{
-		individual_count = p_haplosomes_count;
-	}
+	if ((intrinsic_ploidy == 2) && (p_haplosomes_count % 2 == 1))
+		EIDOS_TERMINATION << "ERROR (Haplosome::_PrintVCF): Haplosome vector must be an even length for chromosome type \"" << chromosome_type << "\", since haplosomes are paired into individuals." << EidosTerminate();
 	
 	// get the polymorphisms within the sample
 	PolymorphismMap polymorphisms;
@@ -1757,6 +1686,28 @@ void Haplosome::_PrintVCF(std::ostream &p_out, const Haplosome **p_haplosomes, i
 	
 	std::sort(sorted_polymorphisms.begin(), sorted_polymorphisms.end());
 	
+	// Build a bit-packed genotype matrix for the sample, with one row per polymorphism in sorted order; this lets us look up
+	// calls quickly below, rather than searching each haplosome for each mutation.  Null haplosomes have empty columns.
+	std::vector<MutationIndex> sorted_mutations;
+	
+	sorted_mutations.reserve(sorted_polymorphisms.size());
+	
+	for (const Polymorphism &polymorphism : sorted_polymorphisms)
+		sorted_mutations.emplace_back(polymorphism.mutation_ptr_->BlockIndex());
+	
+	GenotypeMatrix genotypes(p_haplosomes, p_haplosomes_count, sorted_mutations.data(), (int64_t)sorted_mutations.size());
+	const Polymorphism *first_polymorphism = sorted_polymorphisms.data();
+	
+	// Each call line is assembled into a single record, which is reused from line to line; the writer then formats it
+	// as VCF or BCF.  Null haplosomes get kVCFCallNull in every call line, so we note which haplosomes are null once.
+	VCFRecord record;
+	std::vector<uint8_t> haplosome_is_null(p_haplosomes_count);
+	
+	record.calls_.resize(p_haplosomes_count);
+	
+	for (int64_t haplosome_index = 0; haplosome_index < p_haplosomes_count; haplosome_index++)
+		haplosome_is_null[haplosome_index] = p_haplosomes[haplosome_index]->IsNull();
+	
 	// Print a line for each mutation.  Note that we do NOT treat multiple mutations at the same position at being different alleles,
 	// output on the same line.  This is because a single individual can carry more than one mutation at the same position, so it is
 	// not really a question of different alleles; if there are N mutations at a given position, there are 2^N possible "alleles",
@@ -1796,23 +1747,29 @@ void Haplosome::_PrintVCF(std::ostream &p_out, const Haplosome **p_haplosomes, i
 				break;
 		}
 		
+		record.position_ = mut_position;
+		
 		// Emit the nucleotide-based mutations at this position as a single call line
 		if (nucleotide_based && (nuc_based.size() > 0))
 		{
-			// Get the ancestral nucleotide at this position; this will be index 0
-			// Indices 1..n will be used for the corresponding mutations in nonnuc_based
-			// Note that this means it is 
+			// Get the ancestral nucleotide at this position; this will be allele index 0
 			int ancestral_nuc_index = ancestral_seq->NucleotideAtIndex(mut_position);		// 0..3 for ACGT
 			
-			// Emit a single call line for all of the nucleotide-based mutations
+			record.ref_ = gSLiM_Nucleotides[ancestral_nuc_index];
+			record.ancestral_ = gSLiM_Nucleotides[ancestral_nuc_index];
+			record.multiallelic_ = false;
+			record.nonnuc_ = false;
+			record.alts_.clear();
+			record.mutations_.clear();
+			record.allele_counts_.clear();
 			
 			if (p_simplify_nucs)
 			{
 				// We are requested to simplify the nucleotide state; any mutations with the ancestral nucleotide will be considered part of the
-				// ancestral state, and any mutations with matching nucleotide will be lumped together; SLiM state will not be emitted
-				// We tally up the total prevalence of each nucleotide, ignoring the ancestral nucleotide.
+				// ancestral state, and any mutations with matching nucleotide will be lumped together; SLiM state will not be emitted, so the
+				// record's mutations are left empty.  We tally up the total prevalence of each nucleotide, ignoring the ancestral nucleotide.
 				slim_refcount_t total_prevalence[4] = {0, 0, 0, 0};
-				int allele_index_for_nuc[4] = {-1, -1 -1, -1};
+				int allele_index_for_nuc[4] = {-1, -1, -1, -1};
 				
 				for (Polymorphism *polymorphism : nuc_based)
 				{
@@ -1822,260 +1779,59 @@ void Haplosome::_PrintVCF(std::ostream &p_out, const Haplosome **p_haplosomes, i
 						total_prevalence[derived_nuc_index] += polymorphism->prevalence_;
 				}
 				
-				// Assign genotype call indexes for the four nucleotides, based upon which ones have prevalence > 0
-				allele_index_for_nuc[ancestral_nuc_index] = 0;	// emit 0 for any mutations with a back-mutation
-				
-				int next_allele_index = 1;	// 0 is ancestral
-				for (int nuc_index = 0; nuc_index < 4; ++nuc_index)
-				{
-					if (total_prevalence[nuc_index] > 0)
-						allele_index_for_nuc[nuc_index] = next_allele_index++;
-				}
-				
 				// If the only segregating alleles are back-mutations, we don't need to emit this call line at all
 				if (total_prevalence[0] + total_prevalence[1] + total_prevalence[2] + total_prevalence[3] != 0)
 				{
-					// emit CHROM ("1"), POS, ID (".")
-					// BCH 2/3/2025: we now emit the chromosome's symbol in the CHROM field, introducing a minor
-					// backward compatibility break; it used to be "1" by default, now it is "A" by default, but
-					// this is easy to fix by calling initializeChromosome() explicitly and supplying symbol="1"
-					p_out << p_chromosome.Symbol() << "\t" << (mut_position + 1) << "\t.\t";			// +1 because VCF uses 1-based positions
+					// Assign genotype call indexes for the four nucleotides, based upon which ones have prevalence > 0
+					allele_index_for_nuc[ancestral_nuc_index] = 0;	// emit 0 for any mutations with a back-mutation
 					
-					// emit REF ("A" etc.)
-					p_out << gSLiM_Nucleotides[ancestral_nuc_index];
-					p_out << "\t";
-					
-					// emit ALT ("T" etc.)
-					bool firstEmitted = true;
-					for (int nuc_index=0; nuc_index < 4; ++nuc_index)
+					int next_allele_index = 1;	// 0 is ancestral
+					for (int nuc_index = 0; nuc_index < 4; ++nuc_index)
 					{
 						if (total_prevalence[nuc_index] > 0)
 						{
-							if (!firstEmitted)
-								p_out << ',';
-							firstEmitted = false;
-							
-							p_out << gSLiM_Nucleotides[nuc_index];
-						}
-					}
-					
-					// emit QUAL (1000), FILTER (PASS)
-					p_out << "\t1000\tPASS\t";
-					
-					// emit the INFO fields and the Genotype marker; note mutation-specific fields are omitted since we are aggregating
-					p_out << "AC=";
-					firstEmitted = true;
-					for (int nuc_prevalence : total_prevalence)
-					{
-						if (nuc_prevalence > 0)
-						{
-							if (!firstEmitted)
-								p_out << ',';
-							firstEmitted = false;
-							
-							p_out << nuc_prevalence;
+							allele_index_for_nuc[nuc_index] = next_allele_index++;
+							record.alts_.emplace_back(gSLiM_Nucleotides[nuc_index]);
+							record.allele_counts_.emplace_back(total_prevalence[nuc_index]);
 						}
 					}
-					p_out << ";DP=1000;";
-					p_out << "AA=" << gSLiM_Nucleotides[ancestral_nuc_index];
-					
-					p_out << "\tGT";
 					
-					// emit the individual calls
-					if (intrinsic_ploidy == 1)
+					for (int64_t haplosome_index = 0; haplosome_index < p_haplosomes_count; haplosome_index++)
 					{
-						// intrinsically haploid chromosome; one haplosome per individual
-						for (slim_popsize_t individual_index = 0; individual_index < individual_count; individual_index++)
+						if (haplosome_is_null[haplosome_index])
 						{
-							const Haplosome &haplosome = *p_haplosomes[individual_index];
-							
-							// BCH 2/4/2025: If the haplosome is null, we now emit a "~" character
-							if (haplosome.IsNull()) {
-								p_out << "\t~";
-								continue;
-							}
-							
-							// haploid call
-							p_out << '\t';
-							
-							EmitHaplosomeCall_Nuc_Simplify(p_out, haplosome, nuc_based, mut_position, allele_index_for_nuc);
+							record.calls_[haplosome_index] = kVCFCallNull;
 						}
-					}
-					else
-					{
-						// intrinsically diploid chromosome; two haplosomes per individual
-						for (slim_popsize_t individual_index = 0; individual_index < individual_count; individual_index++)
+						else
 						{
-							const Haplosome &haplosome1 = *p_haplosomes[(size_t)individual_index * 2];
-							const Haplosome &haplosome2 = *p_haplosomes[(size_t)individual_index * 2 + 1];
-							bool haplosome1_null = haplosome1.IsNull(), haplosome2_null = haplosome2.IsNull();
-							
-							// BCH 2/4/2025: If both haplosomes are null, we now emit a "~" character
-							if (haplosome1_null && haplosome2_null) {
-								p_out << "\t~";
-								continue;
-							}
+							int contained_mut_index = _VCFNucleotideCallIndex(genotypes, haplosome_index, first_polymorphism, nuc_based, mut_position);
 							
-							// diploid call unless hemizygous, producing a haploid call (and losing which haplosome was null)
-							p_out << '\t';
-							
-							if (!haplosome1_null)
-								EmitHaplosomeCall_Nuc_Simplify(p_out, haplosome1, nuc_based, mut_position, allele_index_for_nuc);
-							
-							if (!haplosome1_null && !haplosome2_null)	// emit a separator for a diploid call
-								p_out << '|';
-							
-							if (!haplosome2_null)
-								EmitHaplosomeCall_Nuc_Simplify(p_out, haplosome2, nuc_based, mut_position, allele_index_for_nuc);
+							record.calls_[haplosome_index] = (int16_t)((contained_mut_index == -1) ? 0 : allele_index_for_nuc[(int)nuc_based[contained_mut_index]->mutation_ptr_->nucleotide_]);
 						}
 					}
 					
-					p_out << std::endl;
+					p_writer.WriteRecord(record, p_chromosome, p_contig_index, intrinsic_ploidy);
 				}
 			}
 			else
 			{
-				// emit CHROM ("1"), POS, ID (".")
-				// BCH 2/3/2025: we now emit the chromosome's symbol in the CHROM field, introducing a minor
-				// backward compatibility break; it used to be "1" by default, now it is "A" by default, but
-				// this is easy to fix by calling initializeChromosome() explicitly and supplying symbol="1"
-				p_out << p_chromosome.Symbol() << "\t" << (mut_position + 1) << "\t.\t";			// +1 because VCF uses 1-based positions
-				
-				// emit REF ("A" etc.)
-				p_out << gSLiM_Nucleotides[ancestral_nuc_index];
-				p_out << "\t";
-				
-				// emit ALT ("T" etc.)
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << gSLiM_Nucleotides[polymorphism->mutation_ptr_->nucleotide_];
-				}
-				
-				// emit QUAL (1000), FILTER (PASS)
-				p_out << "\t1000\tPASS\t";
-				
-				// emit the INFO fields and the Genotype marker
-				p_out << "MID=";
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << polymorphism->mutation_ptr_->mutation_id_;
-				}
-				p_out << ";";
-				
-				p_out << "S=";
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << polymorphism->mutation_ptr_->selection_coeff_;
-				}
-				p_out << ";";
-				
-				p_out << "DOM=";
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << polymorphism->mutation_ptr_->mutation_type_ptr_->dominance_coeff_;
-				}
-				p_out << ";";
-				
-				p_out << "PO=";
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << polymorphism->mutation_ptr_->subpop_index_;
-				}
-				p_out << ";";
-				
-				p_out << "TO=";
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << polymorphism->mutation_ptr_->origin_tick_;
-				}
-				p_out << ";";
-				
-				p_out << "MT=";
-				for (Polymorphism *polymorphism : nuc_based)
-				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << polymorphism->mutation_ptr_->mutation_type_ptr_->mutation_type_id_;
-				}
-				p_out << ";";
-				
-				p_out << "AC=";
+				// Each nucleotide-based mutation at this position is a separate alternate allele, with its own SLiM state
 				for (Polymorphism *polymorphism : nuc_based)
 				{
-					if (polymorphism != nuc_based.front())
-						p_out << ',';
-					p_out << polymorphism->prevalence_;
+					record.alts_.emplace_back(gSLiM_Nucleotides[(int)polymorphism->mutation_ptr_->nucleotide_]);
+					record.mutations_.emplace_back(polymorphism->mutation_ptr_);
+					record.allele_counts_.emplace_back(polymorphism->prevalence_);
 				}
-				p_out << ";";
-				
-				p_out << "DP=1000;";
-				
-				p_out << "AA=" << gSLiM_Nucleotides[ancestral_nuc_index];
 				
-				p_out << "\tGT";
-				
-				// emit the individual calls
-				if (intrinsic_ploidy == 1)
-				{
-					// intrinsically haploid chromosome; one haplosome per individual
-					for (slim_popsize_t individual_index = 0; individual_index < individual_count; individual_index++)
-					{
-						const Haplosome &haplosome = *p_haplosomes[individual_index];
-						
-						// BCH 2/4/2025: If the haplosome is null, we now emit a "~" character
-						if (haplosome.IsNull()) {
-							p_out << "\t~";
-							continue;
-						}
-						
-						// haploid call
-						p_out << '\t';
-						
-						EmitHaplosomeCall_Nuc(p_out, haplosome, nuc_based, mut_position);
-					}
-				}
-				else
+				for (int64_t haplosome_index = 0; haplosome_index < p_haplosomes_count; haplosome_index++)
 				{
-					// intrinsically diploid chromosome; two haplosomes per individual
-					for (slim_popsize_t individual_index = 0; individual_index < individual_count; individual_index++)
-					{
-						const Haplosome &haplosome1 = *p_haplosomes[(size_t)individual_index * 2];
-						const Haplosome &haplosome2 = *p_haplosomes[(size_t)individual_index * 2 + 1];
-						bool haplosome1_null = haplosome1.IsNull(), haplosome2_null = haplosome2.IsNull();
-						
-						// BCH 2/4/2025: If both haplosomes are null, we now emit a "~" character
-						if (haplosome1_null && haplosome2_null) {
-							p_out << "\t~";
-							continue;
-						}
-						
-						// diploid call unless hemizygous, producing a haploid call (and losing which haplosome was null)
-						p_out << '\t';
-						
-						if (!haplosome1.IsNull())
-							EmitHaplosomeCall_Nuc(p_out, haplosome1, nuc_based, mut_position);
-						
-						if (!haplosome1_null && !haplosome2_null)	// emit a separator for a diploid call
-							p_out << '|';
-						
-						if (!haplosome2.IsNull())
-							EmitHaplosomeCall_Nuc(p_out, haplosome2, nuc_based, mut_position);
-					}
+					if (haplosome_is_null[haplosome_index])
+						record.calls_[haplosome_index] = kVCFCallNull;
+					else
+						record.calls_[haplosome_index] = (int16_t)(_VCFNucleotideCallIndex(genotypes, haplosome_index, first_polymorphism, nuc_based, mut_position) + 1);
 				}
 				
-				p_out << std::endl;
+				p_writer.WriteRecord(record, p_chromosome, p_contig_index, intrinsic_ploidy);
 			}
 		}
 		
@@ -2083,96 +1839,35 @@ void Haplosome::_PrintVCF(std::ostream &p_out, const Haplosome **p_haplosomes, i
 		// We do this if outputNonnucleotides==T, or if we are non-nucleotide-based (in which case outputNonnucleotides is ignored)
 		if (p_output_nonnucs || !nucleotide_based)
 		{
-			for (Polymorphism *polymorphism : nonnuc_based)
+			// Count the mutations at the given position to determine if we are multiallelic
+			int allele_count = (int)nonnuc_based.size();
+			
+			// Output these mutations if (1) we are outputting multiallelics in a non-nuc-based model, or (2) we are a nuc-based model (regardless of allele count), or (3) they are not multiallelic
+			if (p_output_multiallelics || nucleotide_based || (allele_count == 1))
 			{
-				const Mutation *mutation = polymorphism->mutation_ptr_;
+				record.ref_ = 'A';
+				record.ancestral_ = '\0';
+				record.multiallelic_ = (!nucleotide_based && (allele_count > 1));	// output MULTIALLELIC flags only in non-nuc-based models
+				record.nonnuc_ = (nucleotide_based && p_output_nonnucs);
+				record.alts_.assign(1, 'T');
 				
-				// Count the mutations at the given position to determine if we are multiallelic
-				int allele_count = (int)nonnuc_based.size();
-				
-				// Output this mutation if (1) we are outputting multiallelics in a non-nuc-based model, or (2) we are a nuc-based model (regardless of allele count), or (3) it is not multiallelic
-				if (p_output_multiallelics || nucleotide_based || (allele_count == 1))
+				for (Polymorphism *polymorphism : nonnuc_based)
 				{
-					// emit CHROM ("1"), POS, ID ("."), REF ("A"), and ALT ("T")
-					// BCH 2/3/2025: we now emit the chromosome's symbol in the CHROM field, introducing a minor
-					// backward compatibility break; it used to be "1" by default, now it is "A" by default, but
-					// this is easy to fix by calling initializeChromosome() explicitly and supplying symbol="1"
-					p_out << p_chromosome.Symbol() << "\t" << (mut_position + 1) << "\t.\tA\tT";			// +1 because VCF uses 1-based positions
-					
-					// emit QUAL (1000), FILTER (PASS)
-					p_out << "\t1000\tPASS\t";
-					
-					// emit the INFO fields and the Genotype marker
-					p_out << "MID=" << mutation->mutation_id_ << ";";
-					p_out << "S=" << mutation->selection_coeff_ << ";";
-					p_out << "DOM=" << mutation->mutation_type_ptr_->dominance_coeff_ << ";";
-					p_out << "PO=" << mutation->subpop_index_ << ";";
-					p_out << "TO=" << mutation->origin_tick_ << ";";
-					p_out << "MT=" << mutation->mutation_type_ptr_->mutation_type_id_ << ";";
-					p_out << "AC=" << polymorphism->prevalence_ << ";";
-					p_out << "DP=1000";
-					
-					if (!nucleotide_based && (allele_count > 1))	// output MULTIALLELIC flags only in non-nuc-based models
-						p_out << ";MULTIALLELIC";
-					if (nucleotide_based && p_output_nonnucs)
-						p_out << ";NONNUC";
+					int64_t row = polymorphism - first_polymorphism;
+					const uint64_t *row_bits = genotypes.Row(row);
 					
-					p_out << "\tGT";
+					record.mutations_.assign(1, polymorphism->mutation_ptr_);
+					record.allele_counts_.assign(1, polymorphism->prevalence_);
 					
-					// emit the individual calls
-					if (intrinsic_ploidy == 1)
-					{
-						for (slim_popsize_t individual_index = 0; individual_index < individual_count; individual_index++)
-						{
-							const Haplosome &haplosome = *p_haplosomes[individual_index];
-							
-							// BCH 2/4/2025: If the haplosome is null, we now emit a "~" character
-							if (haplosome.IsNull()) {
-								p_out << "\t~";
-								continue;
-							}
-							
-							// haploid call
-							p_out << (haplosome.contains_mutation(mutation) ? "\t1" : "\t0");
-						}
-					}
-					else
+					for (int64_t haplosome_index = 0; haplosome_index < p_haplosomes_count; haplosome_index++)
 					{
-						for (slim_popsize_t individual_index = 0; individual_index < individual_count; individual_index++)
-						{
-							const Haplosome &haplosome1 = *p_haplosomes[(size_t)individual_index * 2];
-							const Haplosome &haplosome2 = *p_haplosomes[(size_t)individual_index * 2 + 1];
-							bool haplosome1_null = haplosome1.IsNull(), haplosome2_null = haplosome2.IsNull();
-							
-							// BCH 2/4/2025: If both haplosomes are null, we now emit a "~" character
-							if (haplosome1_null && haplosome2_null) {
-								p_out << "\t~";
-								continue;
-							}
-							else if (haplosome1_null)
-							{
-								// hemizygous; we emit this as haploid (losing which haplosome was null)
-								p_out << (haplosome2.contains_mutation(mutation) ? "\t1" : "\t0");
-							}
-							else if (haplosome2_null)
-							{
-								// hemizygous; we emit this as haploid (losing which haplosome was null)
-								p_out << (haplosome1.contains_mutation(mutation) ? "\t1" : "\t0");
-							}
-							else
-							{
-								bool haplosome1_has_mut = haplosome1.contains_mutation(mutation);
-								bool haplosome2_has_mut = haplosome2.contains_mutation(mutation);
-								
-								if (haplosome1_has_mut && haplosome2_has_mut)	p_out << "\t1|1";
-								else if (haplosome1_has_mut)					p_out << "\t1|0";
-								else if (haplosome2_has_mut)					p_out << "\t0|1";
-								else											p_out << "\t0|0";
-							}
-						}
+						if (haplosome_is_null[haplosome_index])
+							record.calls_[haplosome_index] = kVCFCallNull;
+						else
+							record.calls_[haplosome_index] = (int16_t)((row_bits[haplosome_index >> 6] >> (haplosome_index & 63)) & 1);
 					}
 					
-					p_out << std::endl;
+					p_writer.WriteRecord(record, p_chromosome, p_contig_index, intrinsic_ploidy);
 				}
 			}
 		}
@@ -2241,6 +1936,7 @@ const std::vector<EidosMethodSignature_CSP> *Haplosome_Class::Methods(void) cons
 		methods->emplace_back(((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_containsMarkerMutation, kEidosValueMaskLogical | kEidosValueMaskSingleton | kEidosValueMaskNULL | kEidosValueMaskObject, gSLiM_Mutation_Class))->AddIntObject_S("mutType", gSLiM_MutationType_Class)->AddInt_S("position")->AddLogical_OS("returnMutation", gStaticEidosValue_LogicalF))->DeclareAcceleratedImp(Haplosome::ExecuteMethod_Accelerated_containsMarkerMutation));
 		methods->emplace_back(((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_containsMutations, kEidosValueMaskLogical))->AddObject("mutations", gSLiM_Mutation_Class))->DeclareAcceleratedImp(Haplosome::ExecuteMethod_Accelerated_containsMutations));
 		methods->emplace_back(((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_countOfMutationsOfType, kEidosValueMaskInt | kEidosValueMaskSingleton))->AddIntObject_S("mutType", gSLiM_MutationType_Class))->DeclareAcceleratedImp(Haplosome::ExecuteMethod_Accelerated_countOfMutationsOfType));
+		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_genotypeMatrix, kEidosValueMaskLogical))->AddObject_ON("mutations", gSLiM_Mutation_Class, gStaticEidosValueNULL));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_positionsOfMutationsOfType, kEidosValueMaskInt))->AddIntObject_S("mutType", gSLiM_MutationType_Class));
 		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_mutationCountsInHaplosomes, kEidosValueMaskInt))->AddObject_ON("mutations", gSLiM_Mutation_Class, gStaticEidosValueNULL));
 		methods->emplace_back((EidosClassMethodSignature *)(new EidosClassMethodSignature(gStr_mutationFrequenciesInHaplosomes, kEidosValueMaskFloat))->AddObject_ON("mutations", gSLiM_Mutation_Class, gStaticEidosValueNULL));
@@ -2267,6 +1963,7 @@ EidosValue_SP Haplosome_Class::ExecuteClassMethod(EidosGlobalStringID p_method_i
 		case gID_addMutations:					return ExecuteMethod_addMutations(p_method_id, p_target, p_arguments, p_interpreter);
 		case gID_addNewDrawnMutation:
 		case gID_addNewMutation:				return ExecuteMethod_addNewMutation(p_method_id, p_target, p_arguments, p_interpreter);
+		case gID_genotypeMatrix:				return ExecuteMethod_genotypeMatrix(p_method_id, p_target, p_arguments, p_interpreter);
 		case gID_mutationCountsInHaplosomes:
 		case gID_mutationFrequenciesInHaplosomes:	return ExecuteMethod_mutationFreqsCountsInHaplosomes(p_method_id, p_target, p_arguments, p_interpreter);
 		case gID_outputHaplosomes:
@@ -2326,8 +2023,8 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_addMutations(EidosGlobalStringID p_
 	
 	Chromosome *chromosome = species->Chromosomes()[chromosome_index];
 	
-	// use the 0th haplosome in the target to find out what the mutation run length is, so we can calculate run indices
-	slim_position_t mutrun_length = haplosome_0->mutrun_length_;
+	// use the 0th haplosome in the target to find out what the mutation run layout is, so we can calculate run indices
+	const MutationRunLayout &mutrun_layout = *haplosome_0->mutrun_layout_;
 	
 	// check that the individuals that mutations are being added to have age == 0, in nonWF models, to prevent tree sequence inconsistencies (see issue #102)
 	if ((community.ModelType() == SLiMModelType::kModelTypeNonWF) && species->RecordingTreeSequence())
@@ -2506,7 +2203,7 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_addMutations(EidosGlobalStringID p_
 	{
 		Mutation *next_mutation = mutations_to_add[value_index];
 		const slim_position_t pos = next_mutation->position_;
-		slim_mutrun_index_t mutrun_index = (slim_mutrun_index_t)(pos / mutrun_length);
+		slim_mutrun_index_t mutrun_index = mutrun_layout.RunIndexForPosition(pos);
 		
 		if (mutrun_index <= last_handled_mutrun_index)
 			continue;
@@ -2533,7 +2230,7 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_addMutations(EidosGlobalStringID p_
 					const slim_position_t add_pos = mut_to_add->position_;
 					
 					// since we're in sorted order by position, as soon as we leave the current mutation run we're done
-					if (add_pos / mutrun_length != mutrun_index)
+					if (mutrun_layout.RunIndexForPosition(add_pos) != mutrun_index)
 						break;
 					
 					if (target_run->enforce_stack_policy_for_addition(mut_to_add->position_, mut_to_add->mutation_type_ptr_))
@@ -2626,9 +2323,9 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_addNewMutation(EidosGlobalStringID
 	
 	Chromosome *chromosome = species->Chromosomes()[chromosome_index];
 	
-	// get the 0th haplosome in the target to find out what the mutation run length is, so we can calculate run indices
+	// get the 0th haplosome in the target to find out what the mutation run layout is, so we can calculate run indices
 	int mutrun_count = haplosome_0->mutrun_count_;
-	slim_position_t mutrun_length = haplosome_0->mutrun_length_;
+	const MutationRunLayout &mutrun_layout = *haplosome_0->mutrun_layout_;
 	
 	// check that the individuals that mutations are being added to have age == 0, in nonWF models, to prevent tree sequence inconsistencies (see issue #102)
 	if ((community.ModelType() == SLiMModelType::kModelTypeNonWF) && species->RecordingTreeSequence())
@@ -2815,7 +2512,7 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_addNewMutation(EidosGlobalStringID
 		for (int pos_index = 0; pos_index < position_count; ++pos_index)
 		{
 			slim_position_t position = SLiMCastToPositionTypeOrRaise(arg_position->IntAtIndex_NOCAST(pos_index, nullptr));
-			mutrun_indexes.emplace_back((slim_mutrun_index_t)(position / mutrun_length));
+			mutrun_indexes.emplace_back(mutrun_layout.RunIndexForPosition(position));
 		}
 		
 		std::sort(mutrun_indexes.begin(), mutrun_indexes.end());
@@ -2891,7 +2588,7 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_addNewMutation(EidosGlobalStringID
 				position = SLiMCastToPositionTypeOrRaise(arg_position->IntAtIndex_NOCAST(mut_parameter_index, nullptr));
 			
 			// check that this mutation will be added to this mutation run
-			if (position / mutrun_length == mutrun_index)
+			if (mutrun_layout.RunIndexForPosition(position) == mutrun_index)
 			{
 				if (muttype_count != 1)
 					mutation_type_ptr = SLiM_ExtractMutationTypeFromEidosValue_io(arg_muttype, mut_parameter_index, &community, species, method_name.c_str());		// SPECIES CONSISTENCY CHECK
@@ -3002,6 +2699,90 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_addNewMutation(EidosGlobalStringID
 	return retval;
 }
 
+//	*********************	+ (logical)genotypeMatrix([No<Mutation> mutations = NULL])
+//
+EidosValue_SP Haplosome_Class::ExecuteMethod_genotypeMatrix(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const
+{
+#pragma unused (p_method_id, p_arguments, p_interpreter)
+	EidosValue *mutations_value = p_arguments[0].get();
+	
+	// get our target vector, and do a pre-check for null haplosomes; a zero-length target is an error since we need a species
+	int64_t target_size = p_target->Count();
+	
+	if (target_size == 0)
+		EIDOS_TERMINATION << "ERROR (Haplosome_Class::ExecuteMethod_genotypeMatrix): genotypeMatrix() cannot be called on a zero-length Haplosome vector." << EidosTerminate();
+	
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Haplosome_Class::ExecuteMethod_genotypeMatrix(): usage of statics");
+	
+	const Haplosome * const *target_data = (const Haplosome * const *)p_target->ObjectData();
+	
+	for (int64_t target_index = 0; target_index < target_size; ++target_index)
+		if (target_data[target_index]->IsNull())
+			EIDOS_TERMINATION << "ERROR (Haplosome_Class::ExecuteMethod_genotypeMatrix): genotypeMatrix() cannot be called on a null haplosome." << EidosTerminate();
+	
+	// SPECIES CONSISTENCY CHECK
+	Species *species = Community::SpeciesForHaplosomesVector(target_data, (int)target_size);
+	
+	if (!species)
+		EIDOS_TERMINATION << "ERROR (Haplosome_Class::ExecuteMethod_genotypeMatrix): genotypeMatrix() requires that all target haplosomes belong to a single species." << EidosTerminate();
+	
+	if (mutations_value->Count() >= 1)
+	{
+		Species *mut_species = Community::SpeciesForMutations(mutations_value);
+		
+		if (mut_species != species)
+			EIDOS_TERMINATION << "ERROR (Haplosome_Class::ExecuteMethod_genotypeMatrix): genotypeMatrix() requires that all mutations belong to the same species as the target haplosomes." << EidosTerminate();
+	}
+	
+	species->population_.CheckForDeferralInHaplosomes(p_target, "Haplosome_Class::ExecuteMethod_genotypeMatrix");
+	
+	// assemble the mutations for the rows; as for mutationCountsInHaplosomes(), NULL means all mutations in the registry
+	std::vector<MutationIndex> mutations;
+	
+	if (mutations_value->Type() == EidosValueType::kValueNULL)
+	{
+		int registry_size;
+		const MutationIndex *registry = species->population_.MutationRegistry(&registry_size);
+		
+		mutations.assign(registry, registry + registry_size);
+	}
+	else
+	{
+		int mutations_count = mutations_value->Count();
+		Mutation * const *mutations_data = (Mutation * const *)mutations_value->ObjectData();
+		
+		mutations.reserve(mutations_count);
+		
+		for (int mutation_index = 0; mutation_index < mutations_count; ++mutation_index)
+			mutations.emplace_back(mutations_data[mutation_index]->BlockIndex());
+	}
+	
+	GenotypeMatrix genotypes(target_data, target_size, mutations.data(), (int64_t)mutations.size());
+	
+	// the result has one row per haplosome and one column per mutation; Eidos matrices are column-major, so each
+	// column of the result is one row of the bit-packed matrix
+	int64_t mutations_count = (int64_t)mutations.size();
+	EidosValue_Logical *logical_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Logical())->resize_no_initialize(target_size * mutations_count);
+	
+	for (int64_t mutation_index = 0; mutation_index < mutations_count; ++mutation_index)
+	{
+		int64_t base_index = mutation_index * target_size;
+		
+		for (int64_t target_index = 0; target_index < target_size; ++target_index)
+			logical_result->set_logical_no_check(genotypes.Contains(mutation_index, target_index), base_index + target_index);
+	}
+	
+	// Eidos does not allow a zero-size dimension, so with no mutations the result is a plain zero-length vector
+	if (mutations_count > 0)
+	{
+		const int64_t dims[2] = {target_size, mutations_count};
+		
+		logical_result->SetDimensions(2, dims);
+	}
+	
+	return EidosValue_SP(logical_result);
+}
+
 //	*********************	+ (float)mutationFrequenciesInHaplosomes([No<Mutation> mutations = NULL])
 //	*********************	+ (integer)mutationCountsInHaplosomes([No<Mutation> mutations = NULL])
 //
@@ -3195,6 +2976,21 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_metho
 		// Otherwise, output to filePath
 		std::string outfile_path = Eidos_ResolvedPath(filePath_value->StringAtIndex_NOCAST(0, nullptr));
 		bool append = append_value->LogicalAtIndex_NOCAST(0, nullptr);
+		
+		if (p_method_id == gID_outputHaplosomesToVCF)
+		{
+			// VCF output may be BGZF-compressed VCF (.gz) or BCF (.bcf), depending on the path's extension
+			VCFOutputFile vcf_file;
+			
+			if (!vcf_file.Open(outfile_path, append, "Haplosome_Class::ExecuteMethod_outputX"))
+				EIDOS_TERMINATION << "ERROR (Haplosome_Class::ExecuteMethod_outputX): could not open " << outfile_path << "." << EidosTerminate();
+			
+			Haplosome::PrintHaplosomes_VCF(vcf_file.Stream(), haplosomes, *chromosome, group_as_individuals, output_multiallelics, simplify_nucs, output_nonnucs, vcf_file.Format());
+			
+			vcf_file.Close("Haplosome_Class::ExecuteMethod_outputX");
+			return gStaticEidosValueVOID;
+		}
+		
 		std::ofstream outfile;
 		
 		outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
@@ -3224,9 +3020,6 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_metho
 				case gID_outputHaplosomesToMS:
 					Haplosome::PrintHaplosomes_MS(outfile, haplosomes, *chromosome, filter_monomorphic);
 					break;
-				case gID_outputHaplosomesToVCF:
-					Haplosome::PrintHaplosomes_VCF(outfile, haplosomes, *chromosome, group_as_individuals, output_multiallelics, simplify_nucs, output_nonnucs);
-					break;
 				default:
 					EIDOS_TERMINATION << "ERROR (Haplosome_Class::ExecuteMethod_outputX): (internal error) unhandled case." << EidosTerminate();
 			}
@@ -3459,7 +3252,7 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_readHaplosomesFromMS(EidosGlobalStr
 			EIDOS_TERMINATION << "ERROR (Haplosome_Class::ExecuteMethod_readHaplosomesFromMS): readHaplosomesFromMS() does not allow null haplosomes in the target haplosome vector." << EidosTerminate();
 		
 		bool haplosome_started_empty = (haplosome->mutation_count() == 0);
-		slim_position_t mutrun_length = haplosome->mutrun_length_;
+		const MutationRunLayout &mutrun_layout = *haplosome->mutrun_layout_;
 		slim_mutrun_index_t current_run_index = -1;
 		MutationRun *current_mutrun = nullptr;
 		std::string &haplosome_string = calls[haplosome_index];
@@ -3474,7 +3267,7 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_readHaplosomesFromMS(EidosGlobalStr
 				MutationIndex mut_index = mutation_indices[segsite_index];
 				Mutation *mut = mut_block_ptr + mut_index;
 				slim_position_t mut_pos = mut->position_;
-				slim_mutrun_index_t mut_mutrun_index = (slim_mutrun_index_t)(mut_pos / mutrun_length);
+				slim_mutrun_index_t mut_mutrun_index = mutrun_layout.RunIndexForPosition(mut_pos);
 				
 				if (mut_mutrun_index != current_run_index)
 				{
@@ -4102,9 +3895,9 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_readHaplosomesFromVCF(EidosGlobalSt
 				Haplosome *haplosome = targets[haplosome_index];
 				slim_mutrun_index_t &haplosome_last_mutrun_modified = target_last_mutrun_modified[haplosome_index];
 				MutationRun *&haplosome_last_mutrun = target_last_mutrun[haplosome_index];
-				slim_position_t mutrun_length = haplosome->mutrun_length_;
+				const MutationRunLayout &mutrun_layout = *haplosome->mutrun_layout_;
 				MutationIndex mut_index = alt_allele_mut_indices[call - 1];
-				slim_mutrun_index_t mut_mutrun_index = (slim_mutrun_index_t)(mut_position / mutrun_length);
+				slim_mutrun_index_t mut_mutrun_index = mutrun_layout.RunIndexForPosition(mut_position);
 				
 				if (mut_mutrun_index != haplosome_last_mutrun_modified)
 				{
@@ -4197,8 +3990,8 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_removeMutations(EidosGlobalStringID
 	bool recording_tree_sequence_mutations = species->RecordingTreeSequenceMutations();
 	bool any_nonneutral_removed = false;
 	
-	// Use the 0th haplosome in the target to find out what the mutation run length is, so we can calculate run indices
-	slim_position_t mutrun_length = haplosome_0->mutrun_length_;
+	// Use the 0th haplosome in the target to find out what the mutation run layout is, so we can calculate run indices
+	const MutationRunLayout &mutrun_layout = *haplosome_0->mutrun_layout_;
 	
 	// TIMING RESTRICTION
 	if (community.executing_species_ == species)
@@ -4511,7 +4304,7 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_removeMutations(EidosGlobalStringID
 		{
 			Mutation *next_mutation = mutations_to_remove[value_index];
 			const slim_position_t pos = next_mutation->position_;
-			slim_mutrun_index_t mutrun_index = (slim_mutrun_index_t)(pos / mutrun_length);
+			slim_mutrun_index_t mutrun_index = mutrun_layout.RunIndexForPosition(pos);
 			
 			if (mutrun_index <= last_handled_mutrun_index)
 				continue;
@@ -4677,9 +4470,7 @@ void HaplosomeWalker::MoveToPosition(slim_position_t p_position)
 	Haplosome *haplosome = haplosome_;
 	
 	// start at the mutrun dictated by the position we are moving to; positions < 0 start at 0
-	mutrun_index_ = (int32_t)(p_position / haplosome->mutrun_length_);
-	if (mutrun_index_ < 0)
-		mutrun_index_ = 0;
+	mutrun_index_ = (p_position < 0) ? 0 : (int32_t)haplosome->mutrun_layout_->RunIndexForPosition(p_position);
 	
 	while (true)
 	{
@@ -4827,6 +4618,780 @@ int8_t HaplosomeWalker::NucleotideAtCurrentPosition(void)
 }
 
 
+//
+//	GenotypeMatrix
+//
+#pragma mark -
+#pragma mark GenotypeMatrix
+#pragma mark -
+
+GenotypeMatrix::GenotypeMatrix(const Haplosome * const *p_haplosomes, int64_t p_haplosomes_count, const MutationIndex *p_mutations, int64_t p_mutations_count) :
+	mutation_count_(p_mutations_count), haplosome_count_(p_haplosomes_count), words_per_row_((p_haplosomes_count + 63) / 64)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("GenotypeMatrix::GenotypeMatrix(): usage of statics");
+	
+	bits_.resize(mutation_count_ * words_per_row_, 0);
+	
+	if ((mutation_count_ == 0) || (haplosome_count_ == 0))
+		return;
+	
+	// make a hash table that looks up the row from a mutation index; duplicated mutations are copied at the end
+#if EIDOS_ROBIN_HOOD_HASHING
+	robin_hood::unordered_flat_map<MutationIndex, int64_t> row_for_mutation;
+#elif STD_UNORDERED_MAP_HASHING
+	std::unordered_map<MutationIndex, int64_t> row_for_mutation;
+#endif
+	std::vector<std::pair<int64_t, int64_t>> duplicate_rows;	// (row, original row)
+	
+	try {
+		row_for_mutation.reserve(mutation_count_);
+		
+		for (int64_t row = 0; row < mutation_count_; ++row)
+		{
+			auto inserted = row_for_mutation.emplace(p_mutations[row], row);
+			
+			if (!inserted.second)
+				duplicate_rows.emplace_back(row, inserted.first->second);
+		}
+	} catch (...) {
+		EIDOS_TERMINATION << "ERROR (GenotypeMatrix::GenotypeMatrix): (internal error) SLiM encountered a raise from an internal hash table; please report this." << EidosTerminate(nullptr);
+	}
+	
+	// We work through the mutation run indices one at a time.  At each index, we group the haplosomes by the MutationRun
+	// they use there, with a counting sort; each distinct run is then scanned once, and its mutations are set in the
+	// columns of all the haplosomes that use it.  When a run is widely shared, we build a bitset of its users and OR that
+	// into each row, a word at a time; otherwise we set the users' bits individually.  The scratch buffers are static,
+	// since this is called frequently, for output and statistics, and they can be large.
+	static std::vector<const MutationRun *> distinct_runs;
+	static std::vector<int64_t> run_for_column;
+	static std::vector<int64_t> user_starts;
+	static std::vector<int64_t> fill_positions;
+	static std::vector<int64_t> users;
+	static std::vector<int64_t> rows;
+	static std::vector<uint64_t> user_bits;
+	static std::vector<MutationIndex> decode_scratch;		// for packed runs; see MutationRun::decoded_pointers_const()
+	
+#if EIDOS_ROBIN_HOOD_HASHING
+	robin_hood::unordered_flat_map<const MutationRun *, int64_t> distinct_run_index;
+#elif STD_UNORDERED_MAP_HASHING
+	std::unordered_map<const MutationRun *, int64_t> distinct_run_index;
+#endif
+	
+	int32_t max_mutrun_count = 0;
+	
+	for (int64_t column = 0; column < haplosome_count_; ++column)
+		max_mutrun_count = std::max(max_mutrun_count, p_haplosomes[column]->mutrun_count_);		// 0 for null haplosomes
+	
+	run_for_column.resize(haplosome_count_);
+	users.resize(haplosome_count_);
+	user_bits.resize(words_per_row_);
+	
+	for (int32_t run_index = 0; run_index < max_mutrun_count; ++run_index)
+	{
+		distinct_runs.clear();
+		distinct_run_index.clear();
+		
+		// find the distinct runs at this index, and which one each haplosome uses
+		try {
+			for (int64_t column = 0; column < haplosome_count_; ++column)
+			{
+				const Haplosome *haplosome = p_haplosomes[column];
+				
+				if (run_index >= haplosome->mutrun_count_)
+				{
+					run_for_column[column] = -1;
+					continue;
+				}
+				
+				const MutationRun *mutrun = haplosome->mutruns_[run_index];
+				auto inserted = distinct_run_index.emplace(mutrun, (int64_t)distinct_runs.size());
+				
+				if (inserted.second)
+					distinct_runs.emplace_back(mutrun);
+				
+				run_for_column[column] = inserted.first->second;
+			}
+		} catch (...) {
+			EIDOS_TERMINATION << "ERROR (GenotypeMatrix::GenotypeMatrix): (internal error) SLiM encountered a raise from an internal hash table; please report this." << EidosTerminate(nullptr);
+		}
+		
+		// counting sort of the columns by distinct run, giving each run a contiguous block of users
+		int64_t distinct_count = (int64_t)distinct_runs.size();
+		
+		user_starts.assign(distinct_count + 1, 0);
+		
+		for (int64_t column = 0; column < haplosome_count_; ++column)
+			if (run_for_column[column] != -1)
+				user_starts[run_for_column[column] + 1]++;
+		
+		for (int64_t distinct_index = 0; distinct_index < distinct_count; ++distinct_index)
+			user_starts[distinct_index + 1] += user_starts[distinct_index];
+		
+		fill_positions.assign(user_starts.begin(), user_starts.end() - 1);
+		
+		for (int64_t column = 0; column < haplosome_count_; ++column)
+			if (run_for_column[column] != -1)
+				users[fill_positions[run_for_column[column]]++] = column;
+		
+		// now scan each distinct run once, and set its mutations for all of its users
+		for (int64_t distinct_index = 0; distinct_index < distinct_count; ++distinct_index)
+		{
+			const MutationRun *mutrun = distinct_runs[distinct_index];
+			const MutationIndex *mut_ptr, *end_of_mutations;
+			
+			mutrun->decoded_pointers_const(&mut_ptr, &end_of_mutations, decode_scratch);		// avoids unpacking packed runs
+			
+			rows.clear();
+			
+			for ( ; mut_ptr != end_of_mutations; ++mut_ptr)
+			{
+				auto found_row = row_for_mutation.find(*mut_ptr);
+				
+				if (found_row != row_for_mutation.end())
+					rows.emplace_back(found_row->second);
+			}
+			
+			if (rows.size() == 0)
+				continue;
+			
+			const int64_t *run_users = users.data() + user_starts[distinct_index];
+			int64_t run_user_count = user_starts[distinct_index + 1] - user_starts[distinct_index];
+			
+			if (run_user_count >= words_per_row_)
+			{
+				std::fill(user_bits.begin(), user_bits.end(), 0);
+				
+				for (int64_t user_index = 0; user_index < run_user_count; ++user_index)
+				{
+					int64_t column = run_users[user_index];
+					
+					user_bits[column >> 6] |= ((uint64_t)1 << (column & 63));
+				}
+				
+				for (int64_t row : rows)
+				{
+					uint64_t *row_bits = bits_.data() + row * words_per_row_;
+					
+					for (int64_t word_index = 0; word_index < words_per_row_; ++word_index)
+						row_bits[word_index] |= user_bits[word_index];
+				}
+			}
+			else
+			{
+				for (int64_t row : rows)
+				{
+					uint64_t *row_bits = bits_.data() + row * words_per_row_;
+					
+					for (int64_t user_index = 0; user_index < run_user_count; ++user_index)
+					{
+						int64_t column = run_users[user_index];
+						
+						row_bits[column >> 6] |= ((uint64_t)1 << (column & 63));
+					}
+				}
+			}
+		}
+	}
+	
+	// copy rows for duplicated mutations from their original rows
+	for (auto &duplicate_pair : duplicate_rows)
+		std::copy(Row(duplicate_pair.second), Row(duplicate_pair.second) + words_per_row_, bits_.data() + duplicate_pair.first * words_per_row_);
+}
+
+int64_t GenotypeMatrix::CountForRow(int64_t p_row) const
+{
+	return Eidos_SIMD::popcount_uint64(Row(p_row), words_per_row_);
+}
+
+int64_t GenotypeMatrix::CountForRowPair(int64_t p_row1, int64_t p_row2) const
+{
+	return Eidos_SIMD::popcount_and_uint64(Row(p_row1), Row(p_row2), words_per_row_);
+}
+
+
+//
+//	VCFRecordWriter
+//
+#pragma mark -
+#pragma mark VCFRecordWriter
+#pragma mark -
+
+// The fixed BCF dictionary indices for the header definitions that are always present; see WriteHeaderDefinitions()
+enum : int {
+	kVCFKey_PASS = 0,
+	kVCFKey_MID,
+	kVCFKey_S,
+	kVCFKey_DOM,
+	kVCFKey_PO,
+	kVCFKey_TO,
+	kVCFKey_MT,
+	kVCFKey_AC,
+	kVCFKey_DP,
+	kVCFKey_FirstOptional
+};
+
+// BCF typed-value encoding; see the VCF specification, section 6.3.3.  Values are little-endian, like our supported platforms.
+enum : uint8_t {
+	kBCFType_Null = 0,
+	kBCFType_Int8 = 1,
+	kBCFType_Int16 = 2,
+	kBCFType_Int32 = 3,
+	kBCFType_Float = 5,
+	kBCFType_Char = 7
+};
+
+static inline void _AppendInteger(std::string &p_buffer, int64_t p_value)
+{
+	char digits[24];
+	char *digits_end = digits + sizeof(digits);
+	char *digit_ptr = digits_end;
+	uint64_t magnitude = (p_value < 0) ? (uint64_t)0 - (uint64_t)p_value : (uint64_t)p_value;
+	
+	do {
+		*--digit_ptr = (char)('0' + (magnitude % 10));
+		magnitude /= 10;
+	} while (magnitude);
+	
+	if (p_value < 0)
+		*--digit_ptr = '-';
+	
+	p_buffer.append(digit_ptr, (size_t)(digits_end - digit_ptr));
+}
+
+static inline void _AppendFloat(std::string &p_buffer, double p_value)
+{
+	// %g matches the default formatting of floating-point values by std::ostream, which VCF output has always used
+	char formatted[32];
+	int length = snprintf(formatted, sizeof(formatted), "%g", p_value);
+	
+	p_buffer.append(formatted, (size_t)length);
+}
+
+template <typename T>
+static inline void _BCFAppendRaw(std::string &p_buffer, T p_value)
+{
+	p_buffer.append((const char *)&p_value, sizeof(T));
+}
+
+static void _BCFAppendTypeDescriptor(std::string &p_buffer, size_t p_count, uint8_t p_type)
+{
+	// counts of 15 or more are given by a typed integer following the descriptor
+	if (p_count < 15)
+	{
+		p_buffer.push_back((char)((p_count << 4) | p_type));
+	}
+	else
+	{
+		p_buffer.push_back((char)((15 << 4) | p_type));
+		
+		if (p_count <= 127)
+		{
+			p_buffer.push_back((char)((1 << 4) | kBCFType_Int8));
+			_BCFAppendRaw<int8_t>(p_buffer, (int8_t)p_count);
+		}
+		else if (p_count <= 32767)
+		{
+			p_buffer.push_back((char)((1 << 4) | kBCFType_Int16));
+			_BCFAppendRaw<int16_t>(p_buffer, (int16_t)p_count);
+		}
+		else
+		{
+			p_buffer.push_back((char)((1 << 4) | kBCFType_Int32));
+			_BCFAppendRaw<int32_t>(p_buffer, (int32_t)p_count);
+		}
+	}
+}
+
+static void _BCFAppendTypedIntegers(std::string &p_buffer, const int64_t *p_values, size_t p_count)
+{
+	// use the smallest integer type that can represent all of the values; the lowest values of each type are reserved
+	int64_t min_value = 0, max_value = 0;
+	
+	for (size_t value_index = 0; value_index < p_count; ++value_index)
+	{
+		min_value = std::min(min_value, p_values[value_index]);
+		max_value = std::max(max_value, p_values[value_index]);
+	}
+	
+	if ((min_value >= -120) && (max_value <= 127))
+	{
+		_BCFAppendTypeDescriptor(p_buffer, p_count, kBCFType_Int8);
+		for (size_t value_index = 0; value_index < p_count; ++value_index)
+			_BCFAppendRaw<int8_t>(p_buffer, (int8_t)p_values[value_index]);
+	}
+	else if ((min_value >= -32760) && (max_value <= 32767))
+	{
+		_BCFAppendTypeDescriptor(p_buffer, p_count, kBCFType_Int16);
+		for (size_t value_index = 0; value_index < p_count; ++value_index)
+			_BCFAppendRaw<int16_t>(p_buffer, (int16_t)p_values[value_index]);
+	}
+	else if ((min_value >= -2147483640LL) && (max_value <= INT32_MAX))
+	{
+		_BCFAppendTypeDescriptor(p_buffer, p_count, kBCFType_Int32);
+		for (size_t value_index = 0; value_index < p_count; ++value_index)
+			_BCFAppendRaw<int32_t>(p_buffer, (int32_t)p_values[value_index]);
+	}
+	else
+	{
+		EIDOS_TERMINATION << "ERROR (_BCFAppendTypedIntegers): a value (" << ((max_value > INT32_MAX) ? max_value : min_value) << ") is out of the 32-bit integer range representable in BCF; use VCF output instead." << EidosTerminate();
+	}
+}
+
+static inline void _BCFAppendTypedInteger(std::string &p_buffer, int64_t p_value)
+{
+	_BCFAppendTypedIntegers(p_buffer, &p_value, 1);
+}
+
+static void _BCFAppendTypedFloats(std::string &p_buffer, const float *p_values, size_t p_count)
+{
+	_BCFAppendTypeDescriptor(p_buffer, p_count, kBCFType_Float);
+	for (size_t value_index = 0; value_index < p_count; ++value_index)
+		_BCFAppendRaw<float>(p_buffer, p_values[value_index]);
+}
+
+static inline void _BCFAppendTypedString(std::string &p_buffer, const char *p_chars, size_t p_length)
+{
+	_BCFAppendTypeDescriptor(p_buffer, p_length, kBCFType_Char);
+	p_buffer.append(p_chars, p_length);
+}
+
+VCFRecordWriter::VCFRecordWriter(std::ostream &p_out, VCFOutputFormat p_format, bool p_nucleotide_based, bool p_output_multiallelics, bool p_output_nonnucs) :
+	out_(p_out), format_(p_format), nucleotide_based_(p_nucleotide_based), output_multiallelics_(p_output_multiallelics), output_nonnucs_(p_output_nonnucs)
+{
+	// the indices of the optional header definitions follow the fixed ones, in the order they are written
+	int next_key = kVCFKey_FirstOptional;
+	
+	key_multiallelic_ = (output_multiallelics_ && !nucleotide_based_) ? next_key++ : -1;
+	key_aa_ = nucleotide_based_ ? next_key++ : -1;
+	key_nonnuc_ = (output_nonnucs_ && nucleotide_based_) ? next_key++ : -1;
+	key_gt_ = next_key++;
+}
+
+void VCFRecordWriter::WriteHeaderDefinitions(const std::vector<const Chromosome *> &p_contigs)
+{
+	std::ostream &header_out = HeaderStream();
+	bool bcf = (format_ == VCFOutputFormat::kBCF);
+	
+	// BCF records refer to header definitions by index, so for BCF we give the indices explicitly with IDX, as htslib does;
+	// PASS is defined explicitly as well, since BCF records refer to it too
+	auto close_definition = [bcf](int p_key) { return bcf ? (",IDX=" + std::to_string(p_key) + ">") : std::string(">"); };
+	
+	if (bcf)
+		header_out << "##FILTER=<ID=PASS,Description=\"All filters passed\"" << close_definition(kVCFKey_PASS) << std::endl;
+	
+	// BCH 6 March 2019: Note that all of the INFO fields that provide per-mutation information have been
+	// changed from a Number of 1 to a Number of ., since in nucleotide-based models we can call more than
+	// one allele in a single call line (unlike in non-nucleotide-based models).
+	header_out << "##INFO=<ID=MID,Number=.,Type=Integer,Description=\"Mutation ID in SLiM\"" << close_definition(kVCFKey_MID) << std::endl;
+	header_out << "##INFO=<ID=S,Number=.,Type=Float,Description=\"Selection Coefficient\"" << close_definition(kVCFKey_S) << std::endl;
+	header_out << "##INFO=<ID=DOM,Number=.,Type=Float,Description=\"Dominance\"" << close_definition(kVCFKey_DOM) << std::endl;
+	// Note that at present we do not output the hemizygous dominance coefficient; too edge
+	header_out << "##INFO=<ID=PO,Number=.,Type=Integer,Description=\"Population of Origin\"" << close_definition(kVCFKey_PO) << std::endl;
+	header_out << "##INFO=<ID=TO,Number=.,Type=Integer,Description=\"Tick of Origin\"" << close_definition(kVCFKey_TO) << std::endl;			// changed to ticks for 4.0, and changed "GO" to "TO"
+	header_out << "##INFO=<ID=MT,Number=.,Type=Integer,Description=\"Mutation Type\"" << close_definition(kVCFKey_MT) << std::endl;
+	header_out << "##INFO=<ID=AC,Number=.,Type=Integer,Description=\"Allele Count\"" << close_definition(kVCFKey_AC) << std::endl;
+	header_out << "##INFO=<ID=DP,Number=1,Type=Integer,Description=\"Total Depth\"" << close_definition(kVCFKey_DP) << std::endl;
+	if (key_multiallelic_ != -1)
+		header_out << "##INFO=<ID=MULTIALLELIC,Number=0,Type=Flag,Description=\"Multiallelic\"" << close_definition(key_multiallelic_) << std::endl;
+	if (key_aa_ != -1)
+		header_out << "##INFO=<ID=AA,Number=1,Type=String,Description=\"Ancestral Allele\"" << close_definition(key_aa_) << std::endl;
+	if (key_nonnuc_ != -1)
+		header_out << "##INFO=<ID=NONNUC,Number=0,Type=Flag,Description=\"Non-nucleotide-based\"" << close_definition(key_nonnuc_) << std::endl;
+	header_out << "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\"" << close_definition(key_gt_) << std::endl;
+	
+	// VCF output has always declared a single contig named "1"; BCF records need a contig for each chromosome's symbol
+	if (bcf)
+	{
+		for (size_t contig_index = 0; contig_index < p_contigs.size(); ++contig_index)
+			header_out << "##contig=<ID=" << p_contigs[contig_index]->Symbol() << ",URL=https://github.com/MesserLab/SLiM,IDX=" << contig_index << ">" << std::endl;
+	}
+	else
+	{
+		header_out << "##contig=<ID=1,URL=https://github.com/MesserLab/SLiM>" << std::endl;
+	}
+}
+
+void VCFRecordWriter::EndHeader(void)
+{
+	if (format_ == VCFOutputFormat::kBCF)
+	{
+		// the BCF header is the magic, followed by the length of the header text including its terminating null, and the text
+		std::string header_text = bcf_header_.str();
+		
+		buffer_.assign("BCF\2\2", 5);
+		_BCFAppendRaw<uint32_t>(buffer_, (uint32_t)(header_text.length() + 1));
+		buffer_.append(header_text);
+		buffer_.push_back('\0');
+		
+		out_.write(buffer_.data(), (std::streamsize)buffer_.size());
+		
+		bcf_header_.str(std::string());
+	}
+}
+
+void VCFRecordWriter::WriteRecord(const VCFRecord &p_record, const Chromosome &p_chromosome, int p_contig_index, int p_ploidy)
+{
+	if (format_ == VCFOutputFormat::kBCF)
+		_WriteRecord_BCF(p_record, p_contig_index, p_ploidy);
+	else
+		_WriteRecord_VCF(p_record, p_chromosome.Symbol(), p_ploidy);
+	
+	out_.write(buffer_.data(), (std::streamsize)buffer_.size());
+}
+
+void VCFRecordWriter::_WriteRecord_VCF(const VCFRecord &p_record, const std::string &p_chromosome_symbol, int p_ploidy)
+{
+	std::string &buffer = buffer_;
+	
+	buffer.clear();
+	
+	// CHROM, POS, ID, REF, ALT, QUAL, FILTER; +1 because VCF uses 1-based positions
+	// BCH 2/3/2025: we now emit the chromosome's symbol in the CHROM field, introducing a minor
+	// backward compatibility break; it used to be "1" by default, now it is "A" by default, but
+	// this is easy to fix by calling initializeChromosome() explicitly and supplying symbol="1"
+	buffer.append(p_chromosome_symbol);
+	buffer.push_back('\t');
+	_AppendInteger(buffer, p_record.position_ + 1);
+	buffer.append("\t.\t");
+	buffer.push_back(p_record.ref_);
+	buffer.push_back('\t');
+	
+	for (size_t alt_index = 0; alt_index < p_record.alts_.size(); ++alt_index)
+	{
+		if (alt_index > 0)
+			buffer.push_back(',');
+		buffer.push_back(p_record.alts_[alt_index]);
+	}
+	
+	buffer.append("\t1000\tPASS\t");
+	
+	// INFO; the per-mutation fields are omitted when nucleotides have been simplified
+	const std::vector<const Mutation *> &mutations = p_record.mutations_;
+	
+	if (mutations.size())
+	{
+		buffer.append("MID=");
+		for (size_t mut_index = 0; mut_index < mutations.size(); ++mut_index)
+		{
+			if (mut_index > 0) buffer.push_back(',');
+			_AppendInteger(buffer, mutations[mut_index]->mutation_id_);
+		}
+		
+		buffer.append(";S=");
+		for (size_t mut_index = 0; mut_index < mutations.size(); ++mut_index)
+		{
+			if (mut_index > 0) buffer.push_back(',');
+			_AppendFloat(buffer, mutations[mut_index]->selection_coeff_);
+		}
+		
+		buffer.append(";DOM=");
+		for (size_t mut_index = 0; mut_index < mutations.size(); ++mut_index)
+		{
+			if (mut_index > 0) buffer.push_back(',');
+			_AppendFloat(buffer, mutations[mut_index]->mutation_type_ptr_->dominance_coeff_);
+		}
+		
+		buffer.append(";PO=");
+		for (size_t mut_index = 0; mut_index < mutations.size(); ++mut_index)
+		{
+			if (mut_index > 0) buffer.push_back(',');
+			_AppendInteger(buffer, mutations[mut_index]->subpop_index_);
+		}
+		
+		buffer.append(";TO=");
+		for (size_t mut_index = 0; mut_index < mutations.size(); ++mut_index)
+		{
+			if (mut_index > 0) buffer.push_back(',');
+			_AppendInteger(buffer, mutations[mut_index]->origin_tick_);
+		}
+		
+		buffer.append(";MT=");
+		for (size_t mut_index = 0; mut_index < mutations.size(); ++mut_index)
+		{
+			if (mut_index > 0) buffer.push_back(',');
+			_AppendInteger(buffer, mutations[mut_index]->mutation_type_ptr_->mutation_type_id_);
+		}
+		
+		buffer.push_back(';');
+	}
+	
+	buffer.append("AC=");
+	for (size_t allele_index = 0; allele_index < p_record.allele_counts_.size(); ++allele_index)
+	{
+		if (allele_index > 0) buffer.push_back(',');
+		_AppendInteger(buffer, p_record.allele_counts_[allele_index]);
+	}
+	
+	buffer.append(";DP=1000");
+	
+	if (p_record.ancestral_)
+	{
+		buffer.append(";AA=");
+		buffer.push_back(p_record.ancestral_);
+	}
+	if (p_record.multiallelic_)
+		buffer.append(";MULTIALLELIC");
+	if (p_record.nonnuc_)
+		buffer.append(";NONNUC");
+	
+	// FORMAT and the calls; a sample whose haplosomes are all null gets "~", and a diploid sample with one null haplosome
+	// gets a haploid call (losing which haplosome was null)
+	buffer.append("\tGT");
+	
+	const int16_t *calls = p_record.calls_.data();
+	size_t call_count = p_record.calls_.size();
+	
+	if (p_ploidy == 1)
+	{
+		for (size_t call_index = 0; call_index < call_count; ++call_index)
+		{
+			int16_t call = calls[call_index];
+			
+			buffer.push_back('\t');
+			
+			if (call == kVCFCallNull)
+				buffer.push_back('~');
+			else if (call < 10)
+				buffer.push_back((char)('0' + call));
+			else
+				_AppendInteger(buffer, call);
+		}
+	}
+	else
+	{
+		for (size_t call_index = 0; call_index + 1 < call_count; call_index += 2)
+		{
+			int16_t call1 = calls[call_index], call2 = calls[call_index + 1];
+			
+			buffer.push_back('\t');
+			
+			if ((call1 == kVCFCallNull) && (call2 == kVCFCallNull))
+			{
+				buffer.push_back('~');
+			}
+			else if ((call1 == kVCFCallNull) || (call2 == kVCFCallNull))
+			{
+				_AppendInteger(buffer, (call1 == kVCFCallNull) ? call2 : call1);
+			}
+			else if ((call1 < 10) && (call2 < 10))
+			{
+				buffer.push_back((char)('0' + call1));
+				buffer.push_back('|');
+				buffer.push_back((char)('0' + call2));
+			}
+			else
+			{
+				_AppendInteger(buffer, call1);
+				buffer.push_back('|');
+				_AppendInteger(buffer, call2);
+			}
+		}
+	}
+	
+	buffer.push_back('\n');
+}
+
+void VCFRecordWriter::_WriteRecord_BCF(const VCFRecord &p_record, int p_contig_index, int p_ploidy)
+{
+	std::string &buffer = buffer_;
+	const std::vector<const Mutation *> &mutations = p_record.mutations_;
+	size_t alt_count = p_record.alts_.size();
+	size_t call_count = p_record.calls_.size();
+	size_t sample_count = call_count / p_ploidy;
+	int info_count = (mutations.size() ? 6 : 0) + 2 + (p_record.ancestral_ ? 1 : 0) + (p_record.multiallelic_ ? 1 : 0) + (p_record.nonnuc_ ? 1 : 0);
+	
+	// the record begins with the lengths of its shared and per-sample parts, which we fill in at the end
+	buffer.assign(8, '\0');
+	
+	// CHROM, POS (0-based), rlen, QUAL, n_allele_info, n_fmt_sample
+	_BCFAppendRaw<int32_t>(buffer, (int32_t)p_contig_index);
+	_BCFAppendRaw<int32_t>(buffer, (int32_t)p_record.position_);
+	_BCFAppendRaw<int32_t>(buffer, 1);
+	_BCFAppendRaw<float>(buffer, 1000.0f);
+	_BCFAppendRaw<uint32_t>(buffer, (uint32_t)(((alt_count + 1) << 16) | (uint32_t)info_count));
+	_BCFAppendRaw<uint32_t>(buffer, (uint32_t)((1U << 24) | (uint32_t)sample_count));
+	
+	// ID (missing), the alleles (REF then ALT), and FILTER (PASS)
+	_BCFAppendTypeDescriptor(buffer, 0, kBCFType_Char);
+	_BCFAppendTypedString(buffer, &p_record.ref_, 1);
+	for (size_t alt_index = 0; alt_index < alt_count; ++alt_index)
+		_BCFAppendTypedString(buffer, &p_record.alts_[alt_index], 1);
+	_BCFAppendTypedInteger(buffer, kVCFKey_PASS);
+	
+	// INFO, as key/value pairs
+	if (mutations.size())
+	{
+		std::vector<int64_t> integer_values(mutations.size());
+		std::vector<float> float_values(mutations.size());
+		
+		for (size_t mut_index = 0; mut_index < mutations.size(); ++mut_index)
+			integer_values[mut_index] = mutations[mut_index]->mutation_id_;
+		_BCFAppendTypedInteger(buffer, kVCFKey_MID);
+		_BCFAppendTypedIntegers(buffer, integer_values.data(), integer_values.size());
+		
+		for (size_t mut_index = 0; mut_index < mutations.size(); ++mut_index)
+			float_values[mut_index] = (float)mutations[mut_index]->selection_coeff_;
+		_BCFAppendTypedInteger(buffer, kVCFKey_S);
+		_BCFAppendTypedFloats(buffer, float_values.data(), float_values.size());
+		
+		for (size_t mut_index = 0; mut_index < mutations.size(); ++mut_index)
+			float_values[mut_index] = (float)mutations[mut_index]->mutation_type_ptr_->dominance_coeff_;
+		_BCFAppendTypedInteger(buffer, kVCFKey_DOM);
+		_BCFAppendTypedFloats(buffer, float_values.data(), float_values.size());
+		
+		for (size_t mut_index = 0; mut_index < mutations.size(); ++mut_index)
+			integer_values[mut_index] = mutations[mut_index]->subpop_index_;
+		_BCFAppendTypedInteger(buffer, kVCFKey_PO);
+		_BCFAppendTypedIntegers(buffer, integer_values.data(), integer_values.size());
+		
+		for (size_t mut_index = 0; mut_index < mutations.size(); ++mut_index)
+			integer_values[mut_index] = mutations[mut_index]->origin_tick_;
+		_BCFAppendTypedInteger(buffer, kVCFKey_TO);
+		_BCFAppendTypedIntegers(buffer, integer_values.data(), integer_values.size());
+		
+		for (size_t mut_index = 0; mut_index < mutations.size(); ++mut_index)
+			integer_values[mut_index] = mutations[mut_index]->mutation_type_ptr_->mutation_type_id_;
+		_BCFAppendTypedInteger(buffer, kVCFKey_MT);
+		_BCFAppendTypedIntegers(buffer, integer_values.data(), integer_values.size());
+	}
+	
+	{
+		std::vector<int64_t> allele_counts(p_record.allele_counts_.begin(), p_record.allele_counts_.end());
+		
+		_BCFAppendTypedInteger(buffer, kVCFKey_AC);
+		_BCFAppendTypedIntegers(buffer, allele_counts.data(), allele_counts.size());
+	}
+	
+	_BCFAppendTypedInteger(buffer, kVCFKey_DP);
+	_BCFAppendTypedInteger(buffer, 1000);
+	
+	if (p_record.ancestral_)
+	{
+		_BCFAppendTypedInteger(buffer, key_aa_);
+		_BCFAppendTypedString(buffer, &p_record.ancestral_, 1);
+	}
+	if (p_record.multiallelic_)
+	{
+		_BCFAppendTypedInteger(buffer, key_multiallelic_);
+		_BCFAppendTypeDescriptor(buffer, 0, kBCFType_Null);
+	}
+	if (p_record.nonnuc_)
+	{
+		_BCFAppendTypedInteger(buffer, key_nonnuc_);
+		_BCFAppendTypeDescriptor(buffer, 0, kBCFType_Null);
+	}
+	
+	size_t shared_length = buffer.size() - 8;
+	
+	// GT, with p_ploidy values per sample: (allele + 1) << 1, with the phased bit set on the second allele of a diploid call;
+	// an all-null sample is a missing call (0), and a diploid sample with one null haplosome is a haploid call, padded out
+	// with the vector end value (0x81), as htslib does; int16 values are used only if there are too many alleles for int8
+	int16_t max_call = 0;
+	
+	for (size_t call_index = 0; call_index < call_count; ++call_index)
+		max_call = std::max(max_call, p_record.calls_[call_index]);
+	
+	bool use_int16 = (((max_call + 1) << 1) + 1 > 127);
+	int16_t missing_value = 0;
+	int16_t vector_end_value = (use_int16 ? (int16_t)-32767 : (int16_t)-127);
+	std::vector<int16_t> gt_values(call_count);
+	const int16_t *calls = p_record.calls_.data();
+	
+	if (p_ploidy == 1)
+	{
+		for (size_t call_index = 0; call_index < call_count; ++call_index)
+			gt_values[call_index] = (calls[call_index] == kVCFCallNull) ? missing_value : (int16_t)((calls[call_index] + 1) << 1);
+	}
+	else
+	{
+		for (size_t call_index = 0; call_index + 1 < call_count; call_index += 2)
+		{
+			int16_t call1 = calls[call_index], call2 = calls[call_index + 1];
+			
+			if ((call1 == kVCFCallNull) && (call2 == kVCFCallNull))
+			{
+				gt_values[call_index] = missing_value;
+				gt_values[call_index + 1] = vector_end_value;
+			}
+			else if ((call1 == kVCFCallNull) || (call2 == kVCFCallNull))
+			{
+				gt_values[call_index] = (int16_t)((((call1 == kVCFCallNull) ? call2 : call1) + 1) << 1);
+				gt_values[call_index + 1] = vector_end_value;
+			}
+			else
+			{
+				gt_values[call_index] = (int16_t)((call1 + 1) << 1);
+				gt_values[call_index + 1] = (int16_t)(((call2 + 1) << 1) | 1);
+			}
+		}
+	}
+	
+	_BCFAppendTypedInteger(buffer, key_gt_);
+	_BCFAppendTypeDescriptor(buffer, (size_t)p_ploidy, use_int16 ? kBCFType_Int16 : kBCFType_Int8);
+	
+	if (use_int16)
+		buffer.append((const char *)gt_values.data(), call_count * sizeof(int16_t));
+	else
+		for (int16_t gt_value : gt_values)
+			buffer.push_back((char)(int8_t)gt_value);
+	
+	size_t sample_length = buffer.size() - 8 - shared_length;
+	uint32_t lengths[2] = {(uint32_t)shared_length, (uint32_t)sample_length};
+	
+	memcpy(&buffer[0], lengths, 8);
+}
+
+
+//
+//	VCFOutputFile
+//
+#pragma mark -
+#pragma mark VCFOutputFile
+#pragma mark -
+
+bool VCFOutputFile::Open(const std::string &p_file_path, bool p_append, const std::string &p_caller)
+{
+	if (Eidos_string_hasSuffix(p_file_path, ".bcf"))
+	{
+		if (p_append)
+			EIDOS_TERMINATION << "ERROR (" << p_caller << "): append=T is not supported for BCF output, since a BCF file contains a single header; use VCF output (optionally compressed, with a path ending in .gz) to append." << EidosTerminate();
+		
+		format_ = VCFOutputFormat::kBCF;
+		compressed_ = true;
+	}
+	else
+	{
+		format_ = VCFOutputFormat::kVCF;
+		compressed_ = Eidos_string_hasSuffix(p_file_path, ".gz");
+	}
+	
+	if (compressed_)
+		return bgzf_buffer_.Open(p_file_path, p_append);
+	
+	text_stream_.open(p_file_path.c_str(), p_append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+	
+	return text_stream_.is_open();
+}
+
+void VCFOutputFile::Close(const std::string &p_caller)
+{
+	bool success;
+	
+	if (compressed_)
+	{
+		success = bgzf_stream_.good() && bgzf_buffer_.Close();
+	}
+	else
+	{
+		text_stream_.close();
+		success = !text_stream_.fail();
+	}
+	
+	if (!success)
+		EIDOS_TERMINATION << "ERROR (" << p_caller << "): errors occurred while writing the output file." << EidosTerminate();
+}
+
+
 
 
 
@@ -39,6 +39,7 @@
 
 #include <vector>
 #include <string.h>
+#include <fstream>
 #include <unordered_map>
 
 //TREE SEQUENCE
@@ -63,6 +64,17 @@ class Subpopulation;
 class Individual;
 class Individual_Class;
 class HaplosomeWalker;
+class GenotypeMatrix;
+class VCFRecordWriter;
+
+
+// VCF output can be written as VCF text or as BCF, the binary encoding of the same records used by htslib/bcftools (BCF 2.2);
+// BCF output should go to a BGZF-compressed stream, as VCFOutputFile provides.  BCF has no equivalent of the "~" call that SLiM
+// emits for an individual with only null haplosomes, so such calls are written as missing calls instead.
+enum class VCFOutputFormat : uint8_t {
+	kVCF = 0,
+	kBCF
+};
 
 
 extern EidosClass *gSLiM_Haplosome_Class;
@@ -119,7 +131,7 @@ private:
 	// 1 BYTE UNUSED HERE!
 	
 	int32_t mutrun_count_;											// number of runs being used; 0 for a null haplosome, otherwise >= 1
-	slim_position_t mutrun_length_;									// the length, in base pairs, of each run; the last run may not use its full length
+	const MutationRunLayout *mutrun_layout_;						// NOT OWNED: our chromosome's division of positions into runs; nullptr if null
 	const MutationRun *run_buffer_[SLIM_HAPLOSOME_MUTRUN_BUFSIZE];	// an internal buffer used to avoid allocation and memory nonlocality for simple models
 	const MutationRun **mutruns_;									// mutation runs; nullptr if a null haplosome OR an empty haplosome
 	
@@ -150,14 +162,14 @@ public:
 	// make a null haplosome; the Haplosome::NullHaplosome{} parameter is just a tag to select this constructor
 	// this constructor is for internal use only, and does not set chromosome_subposition_; use NewHaplosome_NULL()
 	inline Haplosome(NullHaplosome, Individual *p_individual, Chromosome *p_chromosome) :
-		chromosome_index_(p_chromosome->Index()), mutrun_count_(0), mutrun_length_(0), mutruns_(nullptr), individual_(p_individual), haplosome_id_(-1)
+		chromosome_index_(p_chromosome->Index()), mutrun_count_(0), mutrun_layout_(nullptr), mutruns_(nullptr), individual_(p_individual), haplosome_id_(-1)
 	{
 	};
 	
 	// make a non-null haplosome; the Haplosome::NonNullHaplosome{} parameter is just a tag to select this constructor
 	// this constructor is for internal use only, and does not set chromosome_subposition_; use NewHaplosome_NONNULL()
 	inline Haplosome(NonNullHaplosome, Individual *p_individual, Chromosome *p_chromosome) :
-		chromosome_index_(p_chromosome->Index()), mutrun_count_(p_chromosome->mutrun_count_), mutrun_length_(p_chromosome->mutrun_length_), individual_(p_individual), haplosome_id_(-1)
+		chromosome_index_(p_chromosome->Index()), mutrun_count_(p_chromosome->mutrun_count_), mutrun_layout_(&p_chromosome->mutrun_layout_), individual_(p_individual), haplosome_id_(-1)
 	{
 		if (mutrun_count_ <= SLIM_HAPLOSOME_MUTRUN_BUFSIZE)
 		{
@@ -183,7 +195,7 @@ public:
 	inline __attribute__((always_inline)) Individual *OwningIndividual(void)				{ return individual_; }
 	inline __attribute__((always_inline)) const Individual *OwningIndividual(void) const 	{ return individual_; }
 	Chromosome *AssociatedChromosome(void) const;
-	inline __attribute__((always_inline)) slim_position_t MutrunLength(void) const			{ return mutrun_length_; }
+	inline __attribute__((always_inline)) const MutationRunLayout &MutrunLayout(void) const	{ return *mutrun_layout_; }
 	
 	void NullHaplosomeAccessError(void) const __attribute__((__noreturn__)) __attribute__((cold)) __attribute__((analyzer_noreturn));		// prints an error message, a stacktrace, and exits; called only for DEBUG
 	
@@ -206,22 +218,22 @@ public:
 	static void DebugCheckStructureMatch(Haplosome *hapA, Haplosome *hapB, Chromosome *p_chromosome)
 	{
 		// This does a consistency check that two haplosomes (parent and child) match each other and,
-		// if they are non-null, the expectated mutrun count/length passed in (from a chromosome)
+		// if they are non-null, the expectated mutrun count/layout passed in (from a chromosome)
 		// It is used in the WF "munge" methods that munge an existing individual into a new child
 		if ((hapA->IsNull() != hapB->IsNull()) || (!hapA->IsNull() &&
-			((hapA->mutrun_count_ != p_chromosome->mutrun_count_) || (hapA->mutrun_length_ != p_chromosome->mutrun_length_) ||
-			(hapB->mutrun_count_ != p_chromosome->mutrun_count_) || (hapB->mutrun_length_ != p_chromosome->mutrun_length_))))
+			((hapA->mutrun_count_ != p_chromosome->mutrun_count_) || (hapA->mutrun_layout_ != &p_chromosome->mutrun_layout_) ||
+			(hapB->mutrun_count_ != p_chromosome->mutrun_count_) || (hapB->mutrun_layout_ != &p_chromosome->mutrun_layout_))))
 			EIDOS_TERMINATION << "ERROR (Haplosome::CheckStructureMatch): (internal error) haplosome structure does not match!" << EidosTerminate();
 	}
 	static void DebugCheckStructureMatch(Haplosome *hapA, Haplosome *hapB, Haplosome *hapC, Chromosome *p_chromosome)
 	{
 		// This does a consistency check that two haplosomes (parent and child) match each other and,
-		// if they are non-null, the expectated mutrun count/length passed in (from a chromosome)
+		// if they are non-null, the expectated mutrun count/layout passed in (from a chromosome)
 		// It is used in the WF "munge" methods that munge an existing individual into a new child
 		if (((hapA->IsNull() != hapB->IsNull()) || (hapA->IsNull() != hapC->IsNull())) || (!hapA->IsNull() &&
-			((hapA->mutrun_count_ != p_chromosome->mutrun_count_) || (hapA->mutrun_length_ != p_chromosome->mutrun_length_) ||
-			 (hapB->mutrun_count_ != p_chromosome->mutrun_count_) || (hapB->mutrun_length_ != p_chromosome->mutrun_length_) ||
-			 (hapC->mutrun_count_ != p_chromosome->mutrun_count_) || (hapC->mutrun_length_ != p_chromosome->mutrun_length_))))
+			((hapA->mutrun_count_ != p_chromosome->mutrun_count_) || (hapA->mutrun_layout_ != &p_chromosome->mutrun_layout_) ||
+			 (hapB->mutrun_count_ != p_chromosome->mutrun_count_) || (hapB->mutrun_layout_ != &p_chromosome->mutrun_layout_) ||
+			 (hapC->mutrun_count_ != p_chromosome->mutrun_count_) || (hapC->mutrun_layout_ != &p_chromosome->mutrun_layout_))))
 			EIDOS_TERMINATION << "ERROR (Haplosome::CheckStructureMatch): (internal error) haplosome structure does not match!" << EidosTerminate();
 	}
 #else
@@ -284,22 +296,6 @@ public:
 	MutationRun *WillModifyRunForBulkOperation(int64_t p_operation_id, slim_mutrun_index_t p_mutrun_index, MutationRunContext &p_mutrun_context);
 	static void BulkOperationEnd(int64_t p_operation_id, slim_mutrun_index_t p_mutrun_index);
 	
-	// Remove all mutations in p_haplosome that have a state_ of MutationState::kFixedAndSubstituted, indicating that they have fixed
-	void RemoveFixedMutations(int64_t p_operation_id, slim_mutrun_index_t p_mutrun_index)
-	{
-#if DEBUG
-		if (mutrun_count_ == 0)
-			NullHaplosomeAccessError();
-#endif
-		// Remove all fixed mutations from the given mutation run index.  Note that we cast away the const on our
-		// mutation runs here.  This method is called only when fixed mutations are being removed from *all* haplosomes,
-		// so the fact that it modifies other haplosomes that share this mutation run is a feature, not a bug.  See
-		// Population::RemoveAllFixedMutations() for further context on this.
-		MutationRun *mutrun = const_cast<MutationRun *>(mutruns_[p_mutrun_index]);
-		
-		mutrun->RemoveFixedMutations(p_operation_id);
-	}
-	
 	// TallyHaplosomeReferences_Checkback() counts up the total MutationRun references, using their usage counts, as a checkback
 	void TallyHaplosomeReferences_Checkback(slim_refcount_t *p_mutrun_ref_tally, slim_refcount_t *p_mutrun_tally, int64_t p_operation_id);
 	
@@ -347,7 +343,7 @@ public:
 		if (mutrun_count_ == 0)
 			NullHaplosomeAccessError();
 #endif
-		return mutruns_[p_mut->position_ / mutrun_length_]->contains_mutation(p_mut);
+		return mutruns_[mutrun_layout_->RunIndexForPosition(p_mut->position_)]->contains_mutation(p_mut);
 	}
 	
 	inline __attribute__((always_inline)) Mutation *mutation_with_type_and_position(MutationType *p_mut_type, slim_position_t p_position, slim_position_t p_last_position)
@@ -356,7 +352,7 @@ public:
 		if (mutrun_count_ == 0)
 			NullHaplosomeAccessError();
 #endif
-		return mutruns_[p_position / mutrun_length_]->mutation_with_type_and_position(p_mut_type, p_position, p_last_position);
+		return mutruns_[mutrun_layout_->RunIndexForPosition(p_position)]->mutation_with_type_and_position(p_mut_type, p_position, p_last_position);
 	}
 	
 	inline void copy_from_haplosome(const Haplosome &p_source_haplosome)
@@ -373,7 +369,7 @@ public:
 				NullHaplosomeAccessError();
 #endif
 #if DEBUG
-			if ((mutrun_count_ != p_source_haplosome.mutrun_count_) || (mutrun_length_ != p_source_haplosome.mutrun_length_))
+			if ((mutrun_count_ != p_source_haplosome.mutrun_count_) || (mutrun_layout_ != p_source_haplosome.mutrun_layout_))
 				EIDOS_TERMINATION << "ERROR (Haplosome::copy_from_haplosome): (internal error) assignment from haplosome with different count/length." << EidosTerminate();
 #endif
 			
@@ -395,7 +391,7 @@ public:
 	
 	inline const std::vector<Mutation *> *derived_mutation_ids_at_position(slim_position_t p_position) const
 	{
-		slim_mutrun_index_t run_index = (slim_mutrun_index_t)(p_position / mutrun_length_);
+		slim_mutrun_index_t run_index = mutrun_layout_->RunIndexForPosition(p_position);
 		
 		return mutruns_[run_index]->derived_mutation_ids_at_position(p_position);
 	}
@@ -409,8 +405,8 @@ public:
 	static void PrintHaplosomes_MS(std::ostream &p_out, std::vector<Haplosome *> &p_haplosomes, const Chromosome &p_chromosome, bool p_filter_monomorphic);
 	
 	// print the sample represented by haplosomes, using "vcf" format
-	static void PrintHaplosomes_VCF(std::ostream &p_out, std::vector<Haplosome *> &p_haplosomes, const Chromosome &p_chromosome, bool groupAsIndividuals, bool p_output_multiallelics, bool p_simplify_nucs, bool p_output_nonnucs);
-	static void _PrintVCF(std::ostream &p_out, const Haplosome **p_haplosomes, int64_t p_haplosomes_count, const Chromosome &p_chromosome, bool p_groupAsIndividuals, bool p_simplify_nucs, bool p_output_nonnucs, bool p_output_multiallelics);
+	static void PrintHaplosomes_VCF(std::ostream &p_out, std::vector<Haplosome *> &p_haplosomes, const Chromosome &p_chromosome, bool groupAsIndividuals, bool p_output_multiallelics, bool p_simplify_nucs, bool p_output_nonnucs, VCFOutputFormat p_format = VCFOutputFormat::kVCF);
+	static void _PrintVCF(VCFRecordWriter &p_writer, const Haplosome **p_haplosomes, int64_t p_haplosomes_count, const Chromosome &p_chromosome, int p_contig_index, bool p_groupAsIndividuals, bool p_simplify_nucs, bool p_output_nonnucs, bool p_output_multiallelics);
 	
 	// Memory usage tallying, for outputUsage()
 	size_t MemoryUsageForMutrunBuffers(void);
@@ -461,6 +457,7 @@ public:
 	friend Individual;
 	friend Individual_Class;
 	friend HaplosomeWalker;
+	friend GenotypeMatrix;
 };
 
 class Haplosome_Class : public EidosClass
@@ -479,6 +476,7 @@ public:
 	virtual EidosValue_SP ExecuteClassMethod(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const override;
 	EidosValue_SP ExecuteMethod_addMutations(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const;
 	EidosValue_SP ExecuteMethod_addNewMutation(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const;
+	EidosValue_SP ExecuteMethod_genotypeMatrix(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const;
 	EidosValue_SP ExecuteMethod_mutationFreqsCountsInHaplosomes(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const;
 	EidosValue_SP ExecuteMethod_outputX(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const;
 	EidosValue_SP ExecuteMethod_readHaplosomesFromMS(EidosGlobalStringID p_method_id, EidosValue_Object *p_target, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter) const;
@@ -518,6 +516,118 @@ public:
 };
 
 
+// This class is a bit-packed presence/absence matrix for a sample of haplosomes and a set of mutations.  Each row corresponds
+// to one mutation, and each column to one haplosome; a row is a bitset over the haplosomes, padded to a whole number of 64-bit
+// words, so the count of a mutation is a popcount over its row, and the count of two mutations together is a popcount over the
+// AND of their rows, both of which are vectorized (see eidos_simd.h).  The matrix is built once, from the MutationRun objects of
+// the haplosomes; since MutationRuns are shared among haplosomes, each distinct run is scanned only once, and its mutations are
+// set in all of the haplosomes that share it at the same time.  Null haplosomes are allowed, and simply have empty columns.
+// Duplicated mutations get duplicated rows.  Mutations that are not present in any of the haplosomes (including mutations that
+// have been fixed and substituted) have empty rows; the client is responsible for dealing with that, if necessary.
+class GenotypeMatrix
+{
+private:
+	int64_t mutation_count_;					// the number of rows
+	int64_t haplosome_count_;					// the number of columns
+	int64_t words_per_row_;						// the number of 64-bit words in each row
+	std::vector<uint64_t> bits_;				// mutation_count_ * words_per_row_ words, row-major
+	
+public:
+	GenotypeMatrix(void) = delete;
+	GenotypeMatrix(const GenotypeMatrix &p_original) = delete;
+	GenotypeMatrix& operator= (const GenotypeMatrix &p_original) = delete;
+	
+	GenotypeMatrix(const Haplosome * const *p_haplosomes, int64_t p_haplosomes_count, const MutationIndex *p_mutations, int64_t p_mutations_count);
+	
+	inline int64_t MutationCount(void) const { return mutation_count_; }
+	inline int64_t HaplosomeCount(void) const { return haplosome_count_; }
+	
+	inline const uint64_t *Row(int64_t p_row) const { return bits_.data() + p_row * words_per_row_; }
+	inline bool Contains(int64_t p_row, int64_t p_column) const { return (bits_[p_row * words_per_row_ + (p_column >> 6)] >> (p_column & 63)) & 1; }
+	
+	int64_t CountForRow(int64_t p_row) const;							// the number of haplosomes containing the mutation
+	int64_t CountForRowPair(int64_t p_row1, int64_t p_row2) const;		// the number of haplosomes containing both mutations
+};
+
+
+// One VCF call line, assembled by Haplosome::_PrintVCF() and written by VCFRecordWriter.  Calls are given per haplosome, in the
+// order of the haplosomes being output, as an allele index (0 for REF) or kVCFCallNull for a null haplosome.
+#define kVCFCallNull	(-1)
+
+struct VCFRecord
+{
+	slim_position_t position_;						// the zero-based position of the call line
+	char ref_;										// the REF nucleotide
+	std::vector<char> alts_;						// the ALT nucleotides, one per alternate allele
+	std::vector<const Mutation *> mutations_;		// the mutations for MID/S/DOM/PO/TO/MT, one per alternate allele; empty if omitted
+	std::vector<slim_refcount_t> allele_counts_;	// AC, one per alternate allele
+	char ancestral_;								// the AA nucleotide, or '\0' to omit AA (in non-nucleotide-based models)
+	bool multiallelic_;								// the MULTIALLELIC flag
+	bool nonnuc_;									// the NONNUC flag
+	std::vector<int16_t> calls_;					// one call per haplosome
+};
+
+// VCFRecordWriter formats VCFRecords as VCF text or BCF into a buffer that is reused across records, and hands each finished
+// record to the output stream with a single write, avoiding per-field stream insertion.  It also writes the header definitions
+// (INFO, FORMAT, and contig lines) that its records refer to, since BCF records refer to them by index.  For BCF, header text
+// written to HeaderStream() is collected, and written out in binary form by EndHeader().
+class VCFRecordWriter
+{
+private:
+	std::ostream &out_;
+	VCFOutputFormat format_;
+	bool nucleotide_based_;
+	bool output_multiallelics_;
+	bool output_nonnucs_;
+	
+	std::ostringstream bcf_header_;					// header text being collected, for BCF output
+	std::string buffer_;							// the record being formatted
+	
+	// BCF dictionary indices for the header definitions; -1 if the definition is not present
+	int key_multiallelic_, key_aa_, key_nonnuc_, key_gt_;
+	
+	void _WriteRecord_VCF(const VCFRecord &p_record, const std::string &p_chromosome_symbol, int p_ploidy);
+	void _WriteRecord_BCF(const VCFRecord &p_record, int p_contig_index, int p_ploidy);
+	
+public:
+	VCFRecordWriter(const VCFRecordWriter&) = delete;
+	VCFRecordWriter& operator=(const VCFRecordWriter&) = delete;
+	VCFRecordWriter(void) = delete;
+	VCFRecordWriter(std::ostream &p_out, VCFOutputFormat p_format, bool p_nucleotide_based, bool p_output_multiallelics, bool p_output_nonnucs);
+	
+	inline std::ostream &HeaderStream(void) { return (format_ == VCFOutputFormat::kBCF) ? bcf_header_ : out_; }
+	void WriteHeaderDefinitions(const std::vector<const Chromosome *> &p_contigs);
+	void EndHeader(void);
+	
+	// p_contig_index is the index of the record's chromosome in the p_contigs vector passed to WriteHeaderDefinitions()
+	void WriteRecord(const VCFRecord &p_record, const Chromosome &p_chromosome, int p_contig_index, int p_ploidy);
+};
+
+// VCFOutputFile opens a file for VCF output.  A path ending in ".gz" produces BGZF-compressed VCF, and a path ending in ".bcf"
+// produces BGZF-compressed BCF, with compression done on a background thread by EidosBGZFStreambuf; other paths produce VCF
+// text, as always.  Appending is supported for VCF but not for BCF, since a BCF file must contain exactly one header.
+class VCFOutputFile
+{
+private:
+	std::ofstream text_stream_;
+	EidosBGZFStreambuf bgzf_buffer_;
+	std::ostream bgzf_stream_;
+	bool compressed_ = false;
+	VCFOutputFormat format_ = VCFOutputFormat::kVCF;
+	
+public:
+	VCFOutputFile(const VCFOutputFile&) = delete;
+	VCFOutputFile& operator=(const VCFOutputFile&) = delete;
+	VCFOutputFile(void) : bgzf_stream_(&bgzf_buffer_) {}
+	
+	bool Open(const std::string &p_file_path, bool p_append, const std::string &p_caller);		// returns false if the file could not be opened
+	void Close(const std::string &p_caller);														// raises if errors occurred in writing
+	
+	inline std::ostream &Stream(void) { return compressed_ ? bgzf_stream_ : text_stream_; }
+	inline VCFOutputFormat Format(void) const { return format_; }
+};
+
+
 #endif /* defined(__SLiM__haplosome__) */
 
 
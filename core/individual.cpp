@@ -982,14 +982,24 @@ void Individual::PrintIndividuals_SLiM(std::ostream &p_out, const Individual **p
 		free(p_individuals);
 }
 
-void Individual::PrintIndividuals_VCF(std::ostream &p_out, const Individual **p_individuals, int64_t p_individuals_count, Species &p_species, bool p_output_multiallelics, bool p_simplify_nucs, bool p_output_nonnucs, Chromosome *p_focal_chromosome)
+void Individual::PrintIndividuals_VCF(std::ostream &p_out, const Individual **p_individuals, int64_t p_individuals_count, Species &p_species, bool p_output_multiallelics, bool p_simplify_nucs, bool p_output_nonnucs, Chromosome *p_focal_chromosome, VCFOutputFormat p_format)
 {
 	const std::vector<Chromosome *> &chromosomes = p_species.Chromosomes();
 	bool nucleotide_based = p_species.IsNucleotideBased();
 	bool pedigrees_enabled = p_species.PedigreesEnabledByUser();
 	
-	// print the VCF header
-	p_out << "##fileformat=VCFv4.2" << std::endl;
+	// the chromosomes to be output, which are the contigs of the output for BCF
+	std::vector<const Chromosome *> output_chromosomes;
+	
+	for (Chromosome *chromosome : chromosomes)
+		if (!p_focal_chromosome || (chromosome == p_focal_chromosome))
+			output_chromosomes.push_back(chromosome);
+	
+	// print the VCF header; for BCF output, the writer collects the header text and writes it out in EndHeader()
+	VCFRecordWriter writer(p_out, p_format, nucleotide_based, p_output_multiallelics, p_output_nonnucs);
+	std::ostream &header_out = writer.HeaderStream();
+	
+	header_out << "##fileformat=VCFv4.2" << std::endl;
 	
 	{
 		time_t rawtime;
@@ -1000,48 +1010,30 @@ void Individual::PrintIndividuals_VCF(std::ostream &p_out, const Individual **p_
 		localtime_r(&rawtime, &timeinfo);
 		strftime(buffer, 25, "%Y%m%d", &timeinfo);
 		
-		p_out << "##fileDate=" << std::string(buffer) << std::endl;
+		header_out << "##fileDate=" << std::string(buffer) << std::endl;
 	}
 	
-	p_out << "##source=SLiM" << std::endl;
+	header_out << "##source=SLiM" << std::endl;
 	
 	// BCH 2/11/2025: Unlike Haplosome::PrintHaplosomes_VCF(), we can print individual pedigree IDs,
 	// since we are working with a vector of individuals, not a vector of haplosomes.
 	if (pedigrees_enabled && (p_individuals_count > 0))
 	{
-		p_out << "##slimIndividualPedigreeIDs=";
+		header_out << "##slimIndividualPedigreeIDs=";
 		
 		for (int64_t individual_index = 0; individual_index < p_individuals_count; ++individual_index)
 		{
 			if (individual_index > 0)
-				p_out << ",";
-			p_out << p_individuals[individual_index]->pedigree_id_;
+				header_out << ",";
+			header_out << p_individuals[individual_index]->pedigree_id_;
 		}
 		
-		p_out << std::endl;
+		header_out << std::endl;
 	}
 	
-	// BCH 6 March 2019: Note that all of the INFO fields that provide per-mutation information have been
-	// changed from a Number of 1 to a Number of ., since in nucleotide-based models we can call more than
-	// one allele in a single call line (unlike in non-nucleotide-based models).
-	p_out << "##INFO=<ID=MID,Number=.,Type=Integer,Description=\"Mutation ID in SLiM\">" << std::endl;
-	p_out << "##INFO=<ID=S,Number=.,Type=Float,Description=\"Selection Coefficient\">" << std::endl;
-	p_out << "##INFO=<ID=DOM,Number=.,Type=Float,Description=\"Dominance\">" << std::endl;
-	// Note that at present we do not output the hemizygous dominance coefficient; too edge
-	p_out << "##INFO=<ID=PO,Number=.,Type=Integer,Description=\"Population of Origin\">" << std::endl;
-	p_out << "##INFO=<ID=TO,Number=.,Type=Integer,Description=\"Tick of Origin\">" << std::endl;			// changed to ticks for 4.0, and changed "GO" to "TO"
-	p_out << "##INFO=<ID=MT,Number=.,Type=Integer,Description=\"Mutation Type\">" << std::endl;
-	p_out << "##INFO=<ID=AC,Number=.,Type=Integer,Description=\"Allele Count\">" << std::endl;
-	p_out << "##INFO=<ID=DP,Number=1,Type=Integer,Description=\"Total Depth\">" << std::endl;
-	if (p_output_multiallelics && !nucleotide_based)
-		p_out << "##INFO=<ID=MULTIALLELIC,Number=0,Type=Flag,Description=\"Multiallelic\">" << std::endl;
-	if (nucleotide_based)
-		p_out << "##INFO=<ID=AA,Number=1,Type=String,Description=\"Ancestral Allele\">" << std::endl;
-	if (p_output_nonnucs && nucleotide_based)
-		p_out << "##INFO=<ID=NONNUC,Number=0,Type=Flag,Description=\"Non-nucleotide-based\">" << std::endl;
-	p_out << "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">" << std::endl;
-	p_out << "##contig=<ID=1,URL=https://github.com/MesserLab/SLiM>" << std::endl;
-	p_out << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT";
+	writer.WriteHeaderDefinitions(output_chromosomes);
+	
+	header_out << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT";
 	
 	// When printing individual identifiers, we print the actual identifiers like p1:i17,
 	// unlike Population::PrintSample_VCF() and Haplosome_Class::ExecuteMethod_outputX()
@@ -1054,15 +1046,15 @@ void Individual::PrintIndividuals_VCF(std::ostream &p_out, const Individual **p_
 		if (!subpop || (index_in_subpop == -1))
 			EIDOS_TERMINATION << "ERROR (Individual::PrintIndividuals_VCF): target individuals must be visible in a subpopulation (i.e., may not be a new juvenile)." << EidosTerminate();
 		
-		p_out << "\tp" << subpop->subpopulation_id_ << ":i" << index_in_subpop;
+		header_out << "\tp" << subpop->subpopulation_id_ << ":i" << index_in_subpop;
 	}
-	p_out << std::endl;
+	header_out << std::endl;
 	
-	for (Chromosome *chromosome : chromosomes)
+	writer.EndHeader();
+	
+	for (size_t contig_index = 0; contig_index < output_chromosomes.size(); ++contig_index)
 	{
-		if (p_focal_chromosome && (chromosome != p_focal_chromosome))
-			continue;
-		
+		const Chromosome *chromosome = output_chromosomes[contig_index];
 		slim_chromosome_index_t chromosome_index = chromosome->Index();
 		int intrinsic_ploidy = chromosome->IntrinsicPloidy();
 		int first_haplosome_index_ = p_species.FirstHaplosomeIndices()[chromosome_index];
@@ -1081,7 +1073,7 @@ void Individual::PrintIndividuals_VCF(std::ostream &p_out, const Individual **p_
 				haplosomes_buffer[haplosome_buffer_index++] = ind.haplosomes_[i];
 		}
 		
-		Haplosome::_PrintVCF(p_out, haplosomes_buffer, haplosome_count, *chromosome,
+		Haplosome::_PrintVCF(writer, haplosomes_buffer, haplosome_count, *chromosome, (int)contig_index,
 							 /* p_groupAsIndividuals*/ true,
 							 p_simplify_nucs,
 							 p_output_nonnucs,
@@ -2717,7 +2709,7 @@ bool Individual::_SetFitnessScaling_1(double source_value, EidosObject **p_value
 	// p_values; that is considered a bug in the user's script, and we could check for it
 	// in DEBUG mode if we wanted to.
 	EIDOS_THREAD_COUNT(gEidos_OMP_threads_SET_FITNESS_SCALE_1);
-#pragma omp parallel for simd schedule(simd:static) default(none) shared(p_values_size) firstprivate(p_values, source_value) if(parallel:p_values_size >= EIDOS_OMPMIN_SET_FITNESS_SCALE_1) num_threads(thread_count)
+#pragma omp parallel for simd schedule(simd:static) default(none) shared(p_values_size) firstprivate(p_values, source_value) if(parallel:(int64_t)p_values_size >= EIDOS_OMPMIN_SET_FITNESS_SCALE_1) num_threads(thread_count)
 	for (size_t value_index = 0; value_index < p_values_size; ++value_index)
 		((Individual *)(p_values[value_index]))->fitness_scaling_ = source_value;
 	
@@ -2734,7 +2726,7 @@ bool Individual::_SetFitnessScaling_N(const double *source_data, EidosObject **p
 	// p_values; that is considered a bug in the user's script, and we could check for it
 	// in DEBUG mode if we wanted to.
 	EIDOS_THREAD_COUNT(gEidos_OMP_threads_SET_FITNESS_SCALE_2);
-#pragma omp parallel for schedule(static) default(none) shared(p_values_size) firstprivate(p_values, source_data) reduction(||: saw_error) if(p_values_size >= EIDOS_OMPMIN_SET_FITNESS_SCALE_2) num_threads(thread_count)
+#pragma omp parallel for schedule(static) default(none) shared(p_values_size) firstprivate(p_values, source_data) reduction(||: saw_error) if((int64_t)p_values_size >= EIDOS_OMPMIN_SET_FITNESS_SCALE_2) num_threads(thread_count)
 	for (size_t value_index = 0; value_index < p_values_size; ++value_index)
 	{
 		double source_value = source_data[value_index];
@@ -3019,7 +3011,7 @@ EidosValue_SP Individual::ExecuteMethod_Accelerated_countOfMutationsOfType(Eidos
 	int haplosome_count_per_individual = species->HaplosomeCountPerIndividual();
 	
 	EIDOS_THREAD_COUNT(gEidos_OMP_threads_I_COUNT_OF_MUTS_OF_TYPE);
-#pragma omp parallel for schedule(dynamic, 1) default(none) shared(p_elements_size) firstprivate(p_elements, mut_block_ptr, mutation_type_ptr, integer_result) if(p_elements_size >= EIDOS_OMPMIN_I_COUNT_OF_MUTS_OF_TYPE) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(p_elements_size) firstprivate(p_elements, mut_block_ptr, mutation_type_ptr, integer_result) if((int64_t)p_elements_size >= EIDOS_OMPMIN_I_COUNT_OF_MUTS_OF_TYPE) num_threads(thread_count)
 	for (size_t element_index = 0; element_index < p_elements_size; ++element_index)
 	{
 		Individual *element = (Individual *)(p_elements[element_index]);
@@ -3222,7 +3214,7 @@ EidosValue_SP Individual::ExecuteMethod_Accelerated_sumOfMutationsOfType(EidosOb
 	int haplosome_count_per_individual = species->HaplosomeCountPerIndividual();
 	
 	EIDOS_THREAD_COUNT(gEidos_OMP_threads_SUM_OF_MUTS_OF_TYPE);
-#pragma omp parallel for schedule(dynamic, 1) default(none) shared(p_elements_size) firstprivate(p_elements, mut_block_ptr, mutation_type_ptr, float_result) if(p_elements_size >= EIDOS_OMPMIN_SUM_OF_MUTS_OF_TYPE) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(p_elements_size) firstprivate(p_elements, mut_block_ptr, mutation_type_ptr, float_result) if((int64_t)p_elements_size >= EIDOS_OMPMIN_SUM_OF_MUTS_OF_TYPE) num_threads(thread_count)
 	for (size_t element_index = 0; element_index < p_elements_size; ++element_index)
 	{
 		Individual *element = (Individual *)(p_elements[element_index]);
@@ -4131,15 +4123,13 @@ EidosValue_SP Individual_Class::ExecuteMethod_outputIndividualsToVCF(EidosGlobal
 	{
 		std::string outfile_path = Eidos_ResolvedPath(filePath_value->StringAtIndex_NOCAST(0, nullptr));
 		bool append = append_value->LogicalAtIndex_NOCAST(0, nullptr);
-		std::ofstream outfile;
+		VCFOutputFile outfile;		// BGZF-compressed VCF for a .gz path, BCF for a .bcf path
 		
-		outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
-		
-		if (outfile.is_open())
+		if (outfile.Open(outfile_path, append, "Individual_Class::ExecuteMethod_outputIndividualsToVCF"))
 		{
-			Individual::PrintIndividuals_VCF(outfile, individuals_buffer, individuals_count, *species, output_multiallelics, simplify_nucs, output_nonnucs, chromosome);
+			Individual::PrintIndividuals_VCF(outfile.Stream(), individuals_buffer, individuals_count, *species, output_multiallelics, simplify_nucs, output_nonnucs, chromosome, outfile.Format());
 			
-			outfile.close(); 
+			outfile.Close("Individual_Class::ExecuteMethod_outputIndividualsToVCF");
 		}
 		else
 		{
@@ -4158,9 +4148,8 @@ _AddCallToHaplosome(int call, Haplosome *haplosome, slim_mutrun_index_t &haploso
 	if (call == 0)
 		return;
 	
-	slim_position_t mutrun_length = haplosome->MutrunLength();
 	MutationIndex mut_index = alt_allele_mut_indices[call - 1];
-	slim_mutrun_index_t mut_mutrun_index = (slim_mutrun_index_t)(mut_position / mutrun_length);
+	slim_mutrun_index_t mut_mutrun_index = haplosome->MutrunLayout().RunIndexForPosition(mut_position);
 	
 	if (mut_mutrun_index != haplosome_last_mutrun_modified)
 	{
@@ -196,6 +196,9 @@ void InteractionType::EvaluateSubpopulation(Subpopulation *p_subpop)
 		
 		// Free both k-d trees, keeping in mind that the two might share their memory.  FIXME we could keep the
 		// k-d tree buffers around and reuse them; we would then need a flag indicating whether they're valid.
+		// If refitting is enabled, the ALL tree is kept for the next build to refit instead; see RefitKDTree().
+		RetainKDTreeForRefit(*subpop_data);
+		
 		if (subpop_data->kd_nodes_ALL_ == subpop_data->kd_nodes_EXERTERS_)
 			subpop_data->kd_nodes_EXERTERS_ = nullptr;
 		
@@ -217,6 +220,8 @@ void InteractionType::EvaluateSubpopulation(Subpopulation *p_subpop)
 		subpop_data->kd_root_EXERTERS_ = nullptr;
 		subpop_data->kd_node_count_EXERTERS_ = 0;
 		
+		subpop_data->FreeCellGrids();
+		
 		// Free the interaction() callbacks that were cached
 		subpop_data->evaluation_interaction_callbacks_.resize(0);
 	}
@@ -517,6 +522,9 @@ void InteractionType::EvaluateSubpopulation(Subpopulation *p_subpop)
 	// the subpopulation of receivers does not influence the choice of which callbacks are used.
 	subpop_data->evaluation_interaction_callbacks_ = community_.ScriptBlocksMatching(community_.Tick(), SLiMEidosBlockType::SLiMEidosInteractionCallback, -1, interaction_type_id_, subpop_id, -1, nullptr);
 	
+	// Bring the strength cache, if enabled, up to date with the new snapshot of positions
+	PrepareStrengthCache(p_subpop, *subpop_data);
+	
 	// Note that we do not create the k-d tree here.  Non-spatial models will never have a k-d tree; spatial models may or
 	// may not need one, depending upon what methods are called by the client, which may vary cycle by cycle.
 	// Also, receiver subpopulations need to be evaluated too, but (if used only for receivers) will not require a k-d tree.
@@ -590,7 +598,9 @@ void InteractionType::_InvalidateData(InteractionsData &data)
 		data.positions_ = nullptr;
 	}
 	
-	// keep in mind that the two k-d trees may share their memory
+	// keep in mind that the two k-d trees may share their memory; if refitting is enabled, the ALL tree is kept
+	RetainKDTreeForRefit(data);
+	
 	if (data.kd_nodes_ALL_ == data.kd_nodes_EXERTERS_)
 		data.kd_nodes_EXERTERS_ = nullptr;
 	
@@ -612,6 +622,8 @@ void InteractionType::_InvalidateData(InteractionsData &data)
 	data.kd_root_EXERTERS_ = nullptr;
 	data.kd_node_count_EXERTERS_ = 0;
 	
+	data.FreeCellGrids();
+	
 	data.evaluation_interaction_callbacks_.resize(0);
 }
 
@@ -652,7 +664,12 @@ void InteractionType::InvalidateForSubpopulation(Subpopulation *p_invalid_subpop
 		Subpopulation *subpop = community_.SubpopulationWithID(subpop_id);
 		
 		if (subpop == p_invalid_subpop)
+		{
+			// the subpopulation is going away, so there is no point in keeping its k-d tree for refitting, or its strength cache
 			_InvalidateData(data_iter.second);
+			data_iter.second.FreeRefitTree();
+			data_iter.second.FreeStrengthCache();
+		}
 	}
 }
 
@@ -1417,6 +1434,11 @@ size_t InteractionType::MemoryUsageForKDTrees(void)
 		const InteractionsData &data = iter.second;
 		usage += sizeof(SLiM_kdNode) * data.kd_node_count_ALL_;
 		usage += sizeof(SLiM_kdNode) * data.kd_node_count_EXERTERS_;
+		
+		if (data.cell_grid_ALL_)
+			usage += sizeof(SLiM_cellGrid) + sizeof(uint32_t) * data.cell_grid_ALL_->cell_starts_.size();
+		if (data.cell_grid_EXERTERS_ && (data.cell_grid_EXERTERS_ != data.cell_grid_ALL_))
+			usage += sizeof(SLiM_cellGrid) + sizeof(uint32_t) * data.cell_grid_EXERTERS_->cell_starts_.size();
 	}
 	
 	return usage;
@@ -1613,6 +1635,264 @@ SLiM_kdNode *InteractionType::MakeKDTree3_p2(SLiM_kdNode *t, int len)
 	return n;
 }
 
+#ifdef _OPENMP
+// Parallel k-d tree construction.  Near the root there are too few subtrees to keep all threads busy, and the median
+// selections there dominate the build time; so ranges of at least SLIM_KDTREE_COLLECTIVE_MIN nodes are handled one at a
+// time, breadth-first, with all threads cooperating on each median selection (a quickselect whose partition steps are
+// parallelized).  The remaining subtrees are then built as OpenMP tasks, recursing on the two halves until they fall below
+// a size threshold, at which point the serial phase-specific functions above take over.  The partition steps work on
+// fixed-size chunks, so the tree built does not depend upon the number of threads used to build it.
+#define SLIM_KDTREE_COLLECTIVE_MIN		65536		// ranges at least this large get a collective (all-thread) median selection
+#define SLIM_KDTREE_SELECT_CHUNK		8192		// chunk size for the parallel partition steps of a collective median selection
+
+SLiM_kdNode *InteractionType::MakeKDTree_Serial(SLiM_kdNode *t, int len, int p_phase)
+{
+	switch (spatiality_)
+	{
+		case 1: return MakeKDTree1_p0(t, len);
+		case 2: return ((p_phase == 0) ? MakeKDTree2_p0(t, len) : MakeKDTree2_p1(t, len));
+		case 3: return ((p_phase == 0) ? MakeKDTree3_p0(t, len) : ((p_phase == 1) ? MakeKDTree3_p1(t, len) : MakeKDTree3_p2(t, len)));
+		default: return nullptr;
+	}
+}
+
+SLiM_kdNode *InteractionType::MakeKDTree_Tasks(SLiM_kdNode *t, int len, int p_phase, int p_fallthrough)
+{
+	if (len < p_fallthrough)
+		return MakeKDTree_Serial(t, len, p_phase);
+	
+	SLiM_kdNode *n;
+	
+	switch (p_phase)
+	{
+		case 0: n = FindMedian_p0(t, t + len); break;
+		case 1: n = FindMedian_p1(t, t + len); break;
+		default: n = FindMedian_p2(t, t + len); break;
+	}
+	
+	int next_phase = (p_phase + 1) % spatiality_;
+	int left_len = (int)(n - t);
+	int right_len = (int)(t + len - (n + 1));
+	
+	// the two halves are disjoint, so they can be built concurrently; each task sets one child link of n
+	#pragma omp task default(none) firstprivate(t, n, left_len, next_phase, p_fallthrough)
+	{ n->left = (left_len ? MakeKDTree_Tasks(t, left_len, next_phase, p_fallthrough) : nullptr); }
+	#pragma omp task default(none) firstprivate(n, right_len, next_phase, p_fallthrough)
+	{ n->right = (right_len ? MakeKDTree_Tasks(n + 1, right_len, next_phase, p_fallthrough) : nullptr); }
+	
+	return n;
+}
+
+void InteractionType::FindMedian_Collective(SLiM_kdNode *start, int len, int p_phase, SLiM_kdNode *scratch, int64_t *chunk_counts)
+{
+	// This must be called by every thread of the enclosing parallel region, with identical arguments.  Like FindMedian_pX(),
+	// it leaves the median (by the p_phase coordinate) at start + len / 2, with no greater coordinates before it and no
+	// smaller coordinates after it.  The scratch buffer must have room for len nodes; chunk_counts must have room for two
+	// entries per chunk, plus two.  Each thread tracks the active range [lo, hi) identically, so no shared state is needed.
+	int64_t k = len / 2;
+	int64_t lo = 0, hi = len;
+	
+	while (hi - lo >= SLIM_KDTREE_COLLECTIVE_MIN / 4)
+	{
+		// Choose the pivot as the median of nine evenly spaced samples, which is robust to sorted and reverse-sorted input
+		double samples[9];
+		
+		for (int sample_index = 0; sample_index < 9; ++sample_index)
+			samples[sample_index] = start[lo + ((hi - lo - 1) * sample_index) / 8].x[p_phase];
+		
+		std::sort(samples, samples + 9);
+		
+		double pivot = samples[4];
+		int64_t chunk_count = (hi - lo + SLIM_KDTREE_SELECT_CHUNK - 1) / SLIM_KDTREE_SELECT_CHUNK;
+		
+		// Count the nodes below and equal to the pivot in each chunk
+		#pragma omp for schedule(static)
+		for (int64_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index)
+		{
+			SLiM_kdNode *chunk_start = start + lo + chunk_index * SLIM_KDTREE_SELECT_CHUNK;
+			SLiM_kdNode *chunk_end = start + std::min(lo + (chunk_index + 1) * SLIM_KDTREE_SELECT_CHUNK, hi);
+			int64_t less_count = 0, equal_count = 0;
+			
+			for (SLiM_kdNode *node = chunk_start; node < chunk_end; ++node)
+			{
+				double value = node->x[p_phase];
+				
+				if (value < pivot)
+					less_count++;
+				else if (value == pivot)
+					equal_count++;
+			}
+			
+			chunk_counts[chunk_index * 2] = less_count;
+			chunk_counts[chunk_index * 2 + 1] = equal_count;
+		}
+		
+		// Convert the counts into exclusive prefix sums, leaving the totals after them
+		#pragma omp single
+		{
+			int64_t less_total = 0, equal_total = 0;
+			
+			for (int64_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index)
+			{
+				int64_t less_count = chunk_counts[chunk_index * 2];
+				int64_t equal_count = chunk_counts[chunk_index * 2 + 1];
+				
+				chunk_counts[chunk_index * 2] = less_total;
+				chunk_counts[chunk_index * 2 + 1] = equal_total;
+				less_total += less_count;
+				equal_total += equal_count;
+			}
+			
+			chunk_counts[chunk_count * 2] = less_total;
+			chunk_counts[chunk_count * 2 + 1] = equal_total;
+		}
+		
+		int64_t less_total = chunk_counts[chunk_count * 2];
+		int64_t equal_total = chunk_counts[chunk_count * 2 + 1];
+		
+		// If no node equals the pivot, it must be NaN; we can't partition around that, so we finish up serially
+		if (equal_total == 0)
+			break;
+		
+		// Scatter each chunk's nodes into three partitions in the scratch buffer, keeping their order, and then copy back
+		#pragma omp for schedule(static)
+		for (int64_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index)
+		{
+			int64_t chunk_offset = chunk_index * SLIM_KDTREE_SELECT_CHUNK;
+			SLiM_kdNode *chunk_start = start + lo + chunk_offset;
+			SLiM_kdNode *chunk_end = start + std::min(lo + chunk_offset + SLIM_KDTREE_SELECT_CHUNK, hi);
+			int64_t less_before = chunk_counts[chunk_index * 2];
+			int64_t equal_before = chunk_counts[chunk_index * 2 + 1];
+			SLiM_kdNode *less_dest = scratch + lo + less_before;
+			SLiM_kdNode *equal_dest = scratch + lo + less_total + equal_before;
+			SLiM_kdNode *greater_dest = scratch + lo + less_total + equal_total + (chunk_offset - less_before - equal_before);
+			
+			for (SLiM_kdNode *node = chunk_start; node < chunk_end; ++node)
+			{
+				double value = node->x[p_phase];
+				
+				if (value < pivot)
+					*(less_dest++) = *node;
+				else if (value == pivot)
+					*(equal_dest++) = *node;
+				else
+					*(greater_dest++) = *node;
+			}
+		}
+		
+		#pragma omp for schedule(static)
+		for (int64_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index)
+		{
+			int64_t chunk_offset = lo + chunk_index * SLIM_KDTREE_SELECT_CHUNK;
+			int64_t chunk_length = std::min((int64_t)SLIM_KDTREE_SELECT_CHUNK, hi - chunk_offset);
+			
+			std::copy(scratch + chunk_offset, scratch + chunk_offset + chunk_length, start + chunk_offset);
+		}
+		
+		// Narrow the active range to the partition containing the median; if that is the equal partition, we're done
+		if (k < lo + less_total)
+			hi = lo + less_total;
+		else if (k < lo + less_total + equal_total)
+			return;
+		else
+			lo = lo + less_total + equal_total;
+	}
+	
+	#pragma omp single
+	{
+		std::nth_element(start + lo, start + k, start + hi, [p_phase](const SLiM_kdNode &i1, const SLiM_kdNode &i2) { return i1.x[p_phase] < i2.x[p_phase]; });
+	}
+}
+
+SLiM_kdNode *InteractionType::MakeKDTree_Parallel(SLiM_kdNode *t, int len)
+{
+	typedef struct {
+		SLiM_kdNode *start_;
+		int len_;
+		int phase_;
+		SLiM_kdNode **link_;		// where to put the root of the subtree built for this range
+	} KDTreeRange;
+	
+	SLiM_kdNode *root = nullptr;
+	std::vector<KDTreeRange> collective_ranges;		// ranges for which we do a collective median selection, breadth-first
+	std::vector<KDTreeRange> task_ranges;			// ranges that are built by tasks
+	
+	if (len >= SLIM_KDTREE_COLLECTIVE_MIN)
+		collective_ranges.push_back(KDTreeRange{t, len, 0, &root});
+	else
+		task_ranges.push_back(KDTreeRange{t, len, 0, &root});
+	
+	SLiM_kdNode *scratch = nullptr;
+	std::vector<int64_t> chunk_counts;
+	
+	if (collective_ranges.size())
+	{
+		scratch = (SLiM_kdNode *)malloc(len * sizeof(SLiM_kdNode));
+		if (!scratch)
+			EIDOS_TERMINATION << "ERROR (InteractionType::MakeKDTree_Parallel): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+		
+		chunk_counts.resize((len / SLIM_KDTREE_SELECT_CHUNK + 1) * 2 + 2);
+	}
+	
+	int64_t *chunk_counts_data = chunk_counts.data();
+	
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_KDTREE_BUILD);
+#pragma omp parallel default(none) shared(collective_ranges, task_ranges, len) firstprivate(t, scratch, chunk_counts_data) num_threads(thread_count)
+	{
+		// Ranges are appended only inside single constructs, whose implicit barriers keep all threads in step here
+		for (size_t range_index = 0; range_index < collective_ranges.size(); ++range_index)
+		{
+			KDTreeRange range = collective_ranges[range_index];
+			
+			FindMedian_Collective(range.start_, range.len_, range.phase_, scratch + (range.start_ - t), chunk_counts_data);
+			
+			#pragma omp single
+			{
+				SLiM_kdNode *n = range.start_ + range.len_ / 2;
+				int next_phase = (range.phase_ + 1) % spatiality_;
+				KDTreeRange left_range{range.start_, (int)(n - range.start_), next_phase, &n->left};
+				KDTreeRange right_range{n + 1, (int)(range.start_ + range.len_ - (n + 1)), next_phase, &n->right};
+				
+				*range.link_ = n;
+				n->left = nullptr;
+				n->right = nullptr;
+				
+				for (const KDTreeRange &child_range : {left_range, right_range})
+				{
+					if (child_range.len_ >= SLIM_KDTREE_COLLECTIVE_MIN)
+						collective_ranges.push_back(child_range);
+					else if (child_range.len_ > 0)
+						task_ranges.push_back(child_range);
+				}
+			}
+		}
+		
+		// Build the remaining subtrees with tasks; the fall-through size is set to divide the work enough to share it
+		// well among threads, but not so finely that we thrash on tiny tasks, as in Eidos_ParallelSort_Comparator()
+		#pragma omp single
+		{
+			int fallthrough = len / (10 * omp_get_num_threads());
+			
+			if (fallthrough < 1000)
+				fallthrough = 1000;
+			
+			for (KDTreeRange &range : task_ranges)
+			{
+				KDTreeRange task_range = range;
+				
+				#pragma omp task default(none) firstprivate(task_range, fallthrough)
+				{ *task_range.link_ = MakeKDTree_Tasks(task_range.start_, task_range.len_, task_range.phase_, fallthrough); }
+			}
+		}
+	}
+	
+	if (scratch)
+		free(scratch);
+	
+	return root;
+}
+#endif
+
 void InteractionType::CacheKDTreeNodes(Subpopulation *subpop, InteractionsData &p_subpop_data, bool p_apply_exerter_constraints, SLiM_kdNode **kd_nodes_ptr, SLiM_kdNode **kd_root_ptr, slim_popsize_t *kd_node_count_ptr)
 {
 	Individual **subpop_individuals = subpop->parent_individuals_.data();
@@ -1760,7 +2040,7 @@ void InteractionType::CacheKDTreeNodes(Subpopulation *subpop, InteractionsData &
 	*kd_node_count_ptr = actual_node_count;
 }
 
-void InteractionType::BuildKDTree(InteractionsData &p_subpop_data, SLiM_kdNode **kd_nodes_ptr, SLiM_kdNode **kd_root_ptr, slim_popsize_t *kd_node_count_ptr)
+void InteractionType::BuildKDTree(InteractionsData &p_subpop_data, SLiM_kdNode **kd_nodes_ptr, SLiM_kdNode **kd_root_ptr, slim_popsize_t *kd_node_count_ptr, SLiM_cellGrid **cell_grid_ptr)
 {
 	// If we have any periodic dimensions, we need to replicate our nodes spatially
 	// Note that exerter constraints have already been applied
@@ -1833,6 +2113,7 @@ void InteractionType::BuildKDTree(InteractionsData &p_subpop_data, SLiM_kdNode *
 						
 						replicate_node->x[0] = original_node->x[0] + x_offset;
 						replicate_node->individual_index_ = original_node->individual_index_;
+						replicate_node->slack_ = 0;
 					}
 					break;
 				case 2:
@@ -1844,6 +2125,7 @@ void InteractionType::BuildKDTree(InteractionsData &p_subpop_data, SLiM_kdNode *
 						replicate_node->x[0] = original_node->x[0] + x_offset;
 						replicate_node->x[1] = original_node->x[1] + y_offset;
 						replicate_node->individual_index_ = original_node->individual_index_;
+						replicate_node->slack_ = 0;
 					}
 					break;
 				case 3:
@@ -1856,6 +2138,7 @@ void InteractionType::BuildKDTree(InteractionsData &p_subpop_data, SLiM_kdNode *
 						replicate_node->x[1] = original_node->x[1] + y_offset;
 						replicate_node->x[2] = original_node->x[2] + z_offset;
 						replicate_node->individual_index_ = original_node->individual_index_;
+						replicate_node->slack_ = 0;
 					}
 					break;
 				default:
@@ -1870,6 +2153,20 @@ void InteractionType::BuildKDTree(InteractionsData &p_subpop_data, SLiM_kdNode *
 		*kd_node_count_ptr = actual_node_count;
 	}
 	
+	// If a uniform cell grid has been requested, and is feasible, we build it instead of the k-d tree; the nodes get sorted
+	// by cell, and the "root" is just the first node, so that callers can check for an empty tree in the usual way
+	if ((spatial_index_type_ != SpatialIndexType::kKDTree) && (*kd_node_count_ptr > 0))
+	{
+		SLiM_cellGrid *cell_grid = BuildCellGrid(kd_nodes_ptr, *kd_node_count_ptr);
+		
+		if (cell_grid)
+		{
+			*cell_grid_ptr = cell_grid;
+			*kd_root_ptr = *kd_nodes_ptr;
+			return;
+		}
+	}
+	
 	if (*kd_node_count_ptr == 0)
 	{
 		// Usually a root pointer of nullptr indicates that the tree hasn't been built, but it is
@@ -1878,7 +2175,17 @@ void InteractionType::BuildKDTree(InteractionsData &p_subpop_data, SLiM_kdNode *
 	}
 	else
 	{
-		// Now call out to recursively construct the tree
+		// Now call out to recursively construct the tree; large trees are built in parallel when we're multithreaded
+#ifdef _OPENMP
+		if (*kd_node_count_ptr >= EIDOS_OMPMIN_KDTREE_BUILD)
+		{
+			if ((spatiality_ < 1) || (spatiality_ > 3))
+				EIDOS_TERMINATION << "ERROR (InteractionType::BuildKDTree): (internal error) spatiality_ out of range." << EidosTerminate(nullptr);
+			
+			*kd_root_ptr = MakeKDTree_Parallel(*kd_nodes_ptr, *kd_node_count_ptr);
+		}
+		else
+#endif
 		switch (spatiality_)
 		{
 			case 1: *kd_root_ptr = MakeKDTree1_p0(*kd_nodes_ptr, *kd_node_count_ptr);	break;
@@ -1909,6 +2216,157 @@ void InteractionType::BuildKDTree(InteractionsData &p_subpop_data, SLiM_kdNode *
 	}
 }
 
+SLiM_cellGrid *InteractionType::BuildCellGrid(SLiM_kdNode **kd_nodes_ptr, slim_popsize_t kd_node_count)
+{
+	// The cell size is based on max_distance_, so a grid requires a finite maximum distance; if the grid cannot be
+	// used we return nullptr, and the caller falls back to building a k-d tree, so query results are unaffected
+	if (!std::isfinite(max_distance_))
+		return nullptr;
+	
+	// In auto mode, we use a grid only for 2D/3D with enough nodes that construction time matters; in 1D the k-d tree
+	// is already cheap, and for small trees the difference is negligible.  We also check density below.
+	bool auto_mode = (spatial_index_type_ == SpatialIndexType::kAuto);
+	
+	if (auto_mode && ((spatiality_ < 2) || (kd_node_count < 1000)))
+		return nullptr;
+	
+	SLiM_kdNode *nodes = *kd_nodes_ptr;
+	int spatiality = spatiality_;
+	
+	// Find the bounding box of the nodes; note that with periodicity this includes the replicated nodes
+	double min_x = std::numeric_limits<double>::infinity(), min_y = min_x, min_z = min_x;
+	double max_x = -std::numeric_limits<double>::infinity(), max_y = max_x, max_z = max_x;
+	
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_SPATIAL_GRID);
+#pragma omp parallel for schedule(static) default(none) shared(kd_node_count) firstprivate(nodes, spatiality) reduction(min: min_x, min_y, min_z) reduction(max: max_x, max_y, max_z) if(kd_node_count >= EIDOS_OMPMIN_SPATIAL_GRID) num_threads(thread_count)
+	for (slim_popsize_t node_index = 0; node_index < kd_node_count; ++node_index)
+	{
+		const double *x = nodes[node_index].x;
+		
+		min_x = std::min(min_x, x[0]);
+		max_x = std::max(max_x, x[0]);
+		
+		if (spatiality >= 2)
+		{
+			min_y = std::min(min_y, x[1]);
+			max_y = std::max(max_y, x[1]);
+		}
+		if (spatiality >= 3)
+		{
+			min_z = std::min(min_z, x[2]);
+			max_z = std::max(max_z, x[2]);
+		}
+	}
+	
+	double origin[SLIM_MAX_DIMENSIONALITY] = {min_x, min_y, min_z};
+	double extent[SLIM_MAX_DIMENSIONALITY] = {max_x - min_x, max_y - min_y, max_z - min_z};
+	
+	for (int dim = 0; dim < SLIM_MAX_DIMENSIONALITY; ++dim)
+		if ((dim >= spatiality) || !std::isfinite(extent[dim]))
+		{
+			origin[dim] = 0.0;
+			extent[dim] = 0.0;
+		}
+	
+	// Choose the cell size; it must be at least max_distance_, so that all neighbors are within one cell in each dimension.
+	// If there would be many more cells than nodes (a sparse population, or a very small maxDistance), we enlarge the cells
+	// to keep the grid's memory usage O(N); that is still correct, just with more candidates examined per query.
+	double max_cell_count = 2.0 * kd_node_count + 1.0;
+	double cell_size = ((max_distance_ > 0.0) ? max_distance_ : 1.0);
+	double cell_count_d[SLIM_MAX_DIMENSIONALITY];
+	
+	while (true)
+	{
+		double total_cell_count = 1.0;
+		
+		for (int dim = 0; dim < SLIM_MAX_DIMENSIONALITY; ++dim)
+		{
+			cell_count_d[dim] = std::floor(extent[dim] / cell_size) + 1.0;
+			total_cell_count *= cell_count_d[dim];
+		}
+		
+		if (total_cell_count <= max_cell_count)
+			break;
+		
+		// In auto mode, a grid that needs to be coarsened is too sparse to be worthwhile; the k-d tree wins there
+		if (auto_mode)
+			return nullptr;
+		
+		cell_size *= 2.0;
+	}
+	
+	SLiM_cellGrid *cell_grid = new SLiM_cellGrid;
+	
+	cell_grid->inverse_cell_size_ = 1.0 / cell_size;
+	
+	for (int dim = 0; dim < SLIM_MAX_DIMENSIONALITY; ++dim)
+	{
+		cell_grid->origin_[dim] = origin[dim];
+		cell_grid->cell_count_[dim] = (int64_t)cell_count_d[dim];
+	}
+	
+	// Assign each node to a cell; this is the expensive part of the build, and is embarrassingly parallel
+	double inverse_cell_size = cell_grid->inverse_cell_size_;
+	int64_t cell_count_x = cell_grid->cell_count_[0], cell_count_y = cell_grid->cell_count_[1], cell_count_z = cell_grid->cell_count_[2];
+	std::vector<uint32_t> node_cells(kd_node_count);
+	uint32_t *node_cells_data = node_cells.data();
+	
+#pragma omp parallel for schedule(static) default(none) shared(kd_node_count, origin) firstprivate(nodes, spatiality, node_cells_data, inverse_cell_size, cell_count_x, cell_count_y, cell_count_z) if(kd_node_count >= EIDOS_OMPMIN_SPATIAL_GRID) num_threads(thread_count)
+	for (slim_popsize_t node_index = 0; node_index < kd_node_count; ++node_index)
+	{
+		const double *x = nodes[node_index].x;
+		int64_t cell[SLIM_MAX_DIMENSIONALITY] = {0, 0, 0};
+		int64_t cell_counts[SLIM_MAX_DIMENSIONALITY] = {cell_count_x, cell_count_y, cell_count_z};
+		
+		for (int dim = 0; dim < spatiality; ++dim)
+		{
+			double c = std::floor((x[dim] - origin[dim]) * inverse_cell_size);
+			
+			// clamp to the grid; this also catches NaN, which will never be within the interaction distance anyway
+			if (!(c >= 0.0))
+				c = 0.0;
+			else if (c > cell_counts[dim] - 1)
+				c = (double)(cell_counts[dim] - 1);
+			
+			cell[dim] = (int64_t)c;
+		}
+		
+		node_cells_data[node_index] = (uint32_t)(cell[0] + cell_count_x * (cell[1] + cell_count_y * cell[2]));
+	}
+	
+	// Counting sort of the nodes by cell; we keep the original order within each cell, for reproducibility
+	size_t total_cell_count = (size_t)(cell_count_x * cell_count_y * cell_count_z);
+	std::vector<uint32_t> &cell_starts = cell_grid->cell_starts_;
+	
+	cell_starts.resize(total_cell_count + 1, 0);
+	
+	for (slim_popsize_t node_index = 0; node_index < kd_node_count; ++node_index)
+		cell_starts[node_cells_data[node_index] + 1]++;
+	
+	for (size_t cell_index = 0; cell_index < total_cell_count; ++cell_index)
+		cell_starts[cell_index + 1] += cell_starts[cell_index];
+	
+	SLiM_kdNode *sorted_nodes = (SLiM_kdNode *)malloc(kd_node_count * sizeof(SLiM_kdNode));
+	if (!sorted_nodes)
+		EIDOS_TERMINATION << "ERROR (InteractionType::BuildCellGrid): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+	
+	std::vector<uint32_t> cell_fill(cell_starts.begin(), cell_starts.end() - 1);
+	
+	for (slim_popsize_t node_index = 0; node_index < kd_node_count; ++node_index)
+	{
+		SLiM_kdNode *sorted_node = sorted_nodes + cell_fill[node_cells_data[node_index]]++;
+		
+		*sorted_node = nodes[node_index];
+		sorted_node->left = nullptr;
+		sorted_node->right = nullptr;
+	}
+	
+	free(nodes);
+	*kd_nodes_ptr = sorted_nodes;
+	
+	return cell_grid;
+}
+
 SLiM_kdNode *InteractionType::EnsureKDTreePresent_ALL(Subpopulation *subpop, InteractionsData &p_subpop_data)
 {
 	if (!p_subpop_data.evaluated_)
@@ -1918,10 +2376,27 @@ SLiM_kdNode *InteractionType::EnsureKDTreePresent_ALL(Subpopulation *subpop, Int
 		EIDOS_TERMINATION << "ERROR (InteractionType::EnsureKDTreePresent_ALL): (internal error) a k-d tree cannot be constructed for non-spatial interactions." << EidosTerminate();
 	
 	if (!p_subpop_data.kd_nodes_ALL_)
+	{
+		// If a tree was retained from the previous evaluation, try to refit it; if that fails, we build a new tree as usual
+		if (p_subpop_data.refit_nodes_ && RefitKDTree(subpop, p_subpop_data))
+			return p_subpop_data.kd_root_ALL_;
+		
 		CacheKDTreeNodes(subpop, p_subpop_data, /* p_apply_exerter_constraints */ false, &p_subpop_data.kd_nodes_ALL_, &p_subpop_data.kd_root_ALL_, &p_subpop_data.kd_node_count_ALL_);
+		
+		if (kd_tree_refit_)
+		{
+			p_subpop_data.kd_node_capacity_ALL_ = p_subpop_data.kd_node_count_ALL_;
+			p_subpop_data.kd_individuals_ALL_ = subpop->parent_individuals_;
+		}
+		else
+		{
+			p_subpop_data.kd_node_capacity_ALL_ = 0;
+			p_subpop_data.kd_individuals_ALL_.clear();
+		}
+	}
 	
 	if (!p_subpop_data.kd_root_ALL_ && (p_subpop_data.kd_node_count_ALL_ > 0))
-		BuildKDTree(p_subpop_data, &p_subpop_data.kd_nodes_ALL_, &p_subpop_data.kd_root_ALL_, &p_subpop_data.kd_node_count_ALL_);
+		BuildKDTree(p_subpop_data, &p_subpop_data.kd_nodes_ALL_, &p_subpop_data.kd_root_ALL_, &p_subpop_data.kd_node_count_ALL_, &p_subpop_data.cell_grid_ALL_);
 	
 	return p_subpop_data.kd_root_ALL_;		// note that this will return nullptr if the k-d tree has zero entries!
 }
@@ -1945,6 +2420,7 @@ SLiM_kdNode *InteractionType::EnsureKDTreePresent_EXERTERS(Subpopulation *subpop
 			p_subpop_data.kd_nodes_EXERTERS_ = p_subpop_data.kd_nodes_ALL_;
 			p_subpop_data.kd_root_EXERTERS_ = p_subpop_data.kd_root_ALL_;
 			p_subpop_data.kd_node_count_EXERTERS_ = p_subpop_data.kd_node_count_ALL_;
+			p_subpop_data.cell_grid_EXERTERS_ = p_subpop_data.cell_grid_ALL_;
 			
 			return p_subpop_data.kd_root_EXERTERS_;
 		}
@@ -1967,12 +2443,388 @@ SLiM_kdNode *InteractionType::EnsureKDTreePresent_EXERTERS(Subpopulation *subpop
 	}
 	
 	if (!p_subpop_data.kd_root_EXERTERS_ && (p_subpop_data.kd_node_count_EXERTERS_ > 0))
-		BuildKDTree(p_subpop_data, &p_subpop_data.kd_nodes_EXERTERS_, &p_subpop_data.kd_root_EXERTERS_, &p_subpop_data.kd_node_count_EXERTERS_);
+		BuildKDTree(p_subpop_data, &p_subpop_data.kd_nodes_EXERTERS_, &p_subpop_data.kd_root_EXERTERS_, &p_subpop_data.kd_node_count_EXERTERS_, &p_subpop_data.cell_grid_EXERTERS_);
 	
 	return p_subpop_data.kd_root_EXERTERS_;		// note that this will return nullptr if the k-d tree has zero entries!
 }
 
 
+#pragma mark -
+#pragma mark k-d tree refitting
+#pragma mark -
+
+// When individuals move only a little between evaluations, and few are born or die, the ALL k-d tree from the previous evaluation
+// can be refitted rather than rebuilt.  Surviving individuals keep their nodes, which are updated with their new positions; nodes
+// for individuals that have died are removed (tombstoned and then reclaimed), and individuals that are new get nodes inserted as
+// leaves.  The tree's topology is otherwise kept, so a node's position no longer necessarily separates its subtrees; instead each
+// node records a slack_ value, the farthest that a subtree extends across the node's split coordinate, and the queries allow for
+// that slack when pruning.  A newly built tree has zero slack everywhere.  Because the slack grows as individuals drift, and the
+// tree becomes unbalanced as nodes are inserted, the tree is rebuilt instead whenever the thresholds below are crossed.
+#define SLIM_KDTREE_REFIT_MAX_CHURN		0.25		// rebuild if births + deaths exceed this fraction of the individual count
+#define SLIM_KDTREE_REFIT_MAX_SLACK		0.25		// rebuild if the mean slack exceeds this fraction of the maximum distance
+#define SLIM_KDTREE_REFIT_EXTRA_DEPTH	8			// rebuild if an insertion is deeper than twice the balanced depth plus this
+
+void InteractionType::RetainKDTreeForRefit(InteractionsData &p_data)
+{
+	// Keep a built ALL tree, if refitting is enabled and the tree is one we know how to refit: a k-d tree (not a cell grid),
+	// without periodic replication, containing exactly the individuals recorded in kd_individuals_ALL_
+	if (!kd_tree_refit_ || !p_data.kd_root_ALL_ || p_data.cell_grid_ALL_)
+		return;
+	if (p_data.periodic_x_ || p_data.periodic_y_ || p_data.periodic_z_)
+		return;
+	if (p_data.kd_node_count_ALL_ != (slim_popsize_t)p_data.kd_individuals_ALL_.size())
+		return;
+	
+	p_data.FreeRefitTree();
+	
+	p_data.refit_nodes_ = p_data.kd_nodes_ALL_;
+	p_data.refit_root_ = p_data.kd_root_ALL_;
+	p_data.refit_node_count_ = p_data.kd_node_count_ALL_;
+	p_data.refit_node_capacity_ = p_data.kd_node_capacity_ALL_;
+	p_data.refit_individuals_.swap(p_data.kd_individuals_ALL_);
+	
+	// the EXERTERS tree may share the ALL tree's nodes; if so, it goes away with the ALL tree
+	if (p_data.kd_nodes_EXERTERS_ == p_data.kd_nodes_ALL_)
+	{
+		p_data.kd_nodes_EXERTERS_ = nullptr;
+		p_data.kd_root_EXERTERS_ = nullptr;
+		p_data.kd_node_count_EXERTERS_ = 0;
+	}
+	
+	p_data.kd_nodes_ALL_ = nullptr;
+	p_data.kd_root_ALL_ = nullptr;
+	p_data.kd_node_count_ALL_ = 0;
+	p_data.kd_node_capacity_ALL_ = 0;
+	p_data.kd_individuals_ALL_.clear();
+}
+
+bool InteractionType::RefitKDTree(Subpopulation *subpop, InteractionsData &p_subpop_data)
+{
+	// Take over the retained tree; whether or not the refit succeeds, it is no longer retained
+	SLiM_kdNode *nodes = p_subpop_data.refit_nodes_;
+	SLiM_kdNode *root = p_subpop_data.refit_root_;
+	slim_popsize_t node_count = p_subpop_data.refit_node_count_;
+	slim_popsize_t node_capacity = p_subpop_data.refit_node_capacity_;
+	std::vector<Individual *> old_individuals;
+	
+	old_individuals.swap(p_subpop_data.refit_individuals_);
+	p_subpop_data.refit_nodes_ = nullptr;
+	p_subpop_data.FreeRefitTree();
+	
+	std::vector<Individual *> &individuals = subpop->parent_individuals_;
+	slim_popsize_t individual_count = p_subpop_data.individual_count_;
+	
+	if (!kd_tree_refit_ || (individual_count == 0) || ((slim_popsize_t)individuals.size() != individual_count) ||
+		p_subpop_data.periodic_x_ || p_subpop_data.periodic_y_ || p_subpop_data.periodic_z_)
+	{
+		free(nodes);
+		return false;
+	}
+	
+	// Match each node to its individual's new index.  Individuals that have died since the tree was built are no longer in the
+	// subpopulation, but they have only been returned to the junkyard or the species' individual pool, so their memory can still
+	// be read; a node is matched only if the individual at the index it now claims is the same object, which it cannot be for an
+	// individual that has died (unless the object has been reused for a new individual, which it is then fine to match).
+	std::vector<uint8_t> matched(individual_count, 0);
+	std::vector<SLiM_kdNode *> free_nodes;
+	double *positions = p_subpop_data.positions_;
+	int spatiality = spatiality_;
+	slim_popsize_t dead_count = 0;
+	
+	for (slim_popsize_t node_index = 0; node_index < node_capacity; ++node_index)
+	{
+		SLiM_kdNode *node = nodes + node_index;
+		slim_popsize_t old_index = node->individual_index_;
+		
+		if (old_index < 0)
+		{
+			// an unused node, left over from a previous refit
+			free_nodes.push_back(node);
+			continue;
+		}
+		
+		Individual *individual = old_individuals[old_index];
+		slim_popsize_t new_index = individual->index_;
+		
+		if ((new_index >= 0) && (new_index < individual_count) && (individuals[new_index] == individual) && !matched[new_index])
+		{
+			double *position_data = positions + (size_t)new_index * SLIM_MAX_DIMENSIONALITY;
+			
+			matched[new_index] = 1;
+			node->individual_index_ = new_index;
+			for (int dim = 0; dim < spatiality; ++dim)
+				node->x[dim] = position_data[dim];
+		}
+		else
+		{
+			// a tombstone; RefitKDTree_RemoveDead() will remove it from the tree
+			node->individual_index_ = -1;
+			dead_count++;
+		}
+	}
+	
+	slim_popsize_t birth_count = individual_count - (node_count - dead_count);
+	
+	if ((dead_count + birth_count) > individual_count * SLIM_KDTREE_REFIT_MAX_CHURN)
+	{
+		free(nodes);
+		return false;
+	}
+	
+	// Remove the tombstoned nodes from the tree; the nodes they vacate are added to free_nodes
+	if (dead_count)
+		root = RefitKDTree_RemoveDead(root, free_nodes);
+	
+	// Grow the node buffer if the new individuals need more nodes than are free; the pointers into it then need to be rebased
+	if (birth_count > (slim_popsize_t)free_nodes.size())
+	{
+		slim_popsize_t new_capacity = node_capacity + (birth_count - (slim_popsize_t)free_nodes.size());
+		
+		new_capacity += new_capacity / 16;		// some headroom, to avoid reallocating every time in a growing population
+		
+		SLiM_kdNode *new_nodes = (SLiM_kdNode *)realloc(nodes, new_capacity * sizeof(SLiM_kdNode));
+		if (!new_nodes)
+			EIDOS_TERMINATION << "ERROR (InteractionType::RefitKDTree): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+		
+		if (new_nodes != nodes)
+		{
+			for (slim_popsize_t node_index = 0; node_index < node_capacity; ++node_index)
+			{
+				SLiM_kdNode *node = new_nodes + node_index;
+				
+				if (node->individual_index_ >= 0)
+				{
+					if (node->left) node->left = new_nodes + (node->left - nodes);
+					if (node->right) node->right = new_nodes + (node->right - nodes);
+				}
+			}
+			
+			for (SLiM_kdNode *&free_node : free_nodes)
+				free_node = new_nodes + (free_node - nodes);
+			
+			if (root)
+				root = new_nodes + (root - nodes);
+			
+			nodes = new_nodes;
+		}
+		
+		for (slim_popsize_t node_index = new_capacity - 1; node_index >= node_capacity; --node_index)
+		{
+			nodes[node_index].individual_index_ = -1;
+			free_nodes.push_back(nodes + node_index);
+		}
+		
+		node_capacity = new_capacity;
+	}
+	
+	// Insert nodes for the new individuals as leaves, descending as a query would; if the tree gets too deep, rebuild instead
+	if (birth_count > 0)
+	{
+		int depth_limit = SLIM_KDTREE_REFIT_EXTRA_DEPTH;
+		
+		for (slim_popsize_t count = individual_count; count > 0; count >>= 1)
+			depth_limit += 2;
+		
+		for (slim_popsize_t individual_index = 0; individual_index < individual_count; ++individual_index)
+		{
+			if (matched[individual_index])
+				continue;
+			
+			SLiM_kdNode *node = free_nodes.back();
+			double *position_data = positions + (size_t)individual_index * SLIM_MAX_DIMENSIONALITY;
+			
+			free_nodes.pop_back();
+			node->individual_index_ = individual_index;
+			node->slack_ = 0;
+			node->left = nullptr;
+			node->right = nullptr;
+			for (int dim = 0; dim < spatiality; ++dim)
+				node->x[dim] = position_data[dim];
+			
+			if (!root)
+			{
+				root = node;
+				continue;
+			}
+			
+			SLiM_kdNode *parent = root;
+			int phase = 0, depth = 2;
+			
+			while (true)
+			{
+				SLiM_kdNode **link = ((node->x[phase] < parent->x[phase]) ? &parent->left : &parent->right);
+				
+				if (!*link)
+				{
+					*link = node;
+					break;
+				}
+				
+				parent = *link;
+				if (++phase >= spatiality) phase = 0;
+				++depth;
+			}
+			
+			if (depth > depth_limit)
+			{
+				free(nodes);
+				return false;
+			}
+		}
+	}
+	
+	// Recompute the slack of every node, and rebuild if the mean slack would make queries much less efficient
+	double min_coords[SLIM_MAX_DIMENSIONALITY], max_coords[SLIM_MAX_DIMENSIONALITY];
+	double total_slack = RefitKDTree_Bounds(root, 0, min_coords, max_coords);
+	
+	if (std::isfinite(max_distance_) && (total_slack > individual_count * max_distance_ * SLIM_KDTREE_REFIT_MAX_SLACK))
+	{
+		free(nodes);
+		return false;
+	}
+	
+#if DEBUG
+	if (CheckRefitKDTree(root, 0, min_coords, max_coords) != individual_count)
+		EIDOS_TERMINATION << "ERROR (InteractionType::RefitKDTree): (internal error) the refitted k-d tree does not contain the expected number of nodes." << EidosTerminate();
+#endif
+	
+	p_subpop_data.kd_nodes_ALL_ = nodes;
+	p_subpop_data.kd_root_ALL_ = root;
+	p_subpop_data.kd_node_count_ALL_ = individual_count;
+	p_subpop_data.kd_node_capacity_ALL_ = node_capacity;
+	p_subpop_data.kd_individuals_ALL_ = individuals;
+	
+	return true;
+}
+
+SLiM_kdNode *InteractionType::RefitKDTree_RemoveDead(SLiM_kdNode *p_node, std::vector<SLiM_kdNode *> &p_free_nodes)
+{
+	// Returns the new root of the subtree, after removing tombstoned nodes; children are handled first, so that any leaf
+	// found below a tombstoned node is live and can be moved up to replace it
+	if (p_node->left)
+		p_node->left = RefitKDTree_RemoveDead(p_node->left, p_free_nodes);
+	if (p_node->right)
+		p_node->right = RefitKDTree_RemoveDead(p_node->right, p_free_nodes);
+	
+	if (p_node->individual_index_ >= 0)
+		return p_node;
+	
+	if (!p_node->left && !p_node->right)
+	{
+		p_free_nodes.push_back(p_node);
+		return nullptr;
+	}
+	
+	// Replace the tombstone with a leaf from one of its subtrees; the slack recomputed later covers wherever that leaf lies
+	SLiM_kdNode **link = (p_node->left ? &p_node->left : &p_node->right);
+	
+	while ((*link)->left || (*link)->right)
+		link = ((*link)->left ? &(*link)->left : &(*link)->right);
+	
+	SLiM_kdNode *leaf = *link;
+	
+	*link = nullptr;
+	p_node->x[0] = leaf->x[0];
+	p_node->x[1] = leaf->x[1];
+	p_node->x[2] = leaf->x[2];
+	p_node->individual_index_ = leaf->individual_index_;
+	leaf->individual_index_ = -1;
+	p_free_nodes.push_back(leaf);
+	
+	return p_node;
+}
+
+double InteractionType::RefitKDTree_Bounds(SLiM_kdNode *p_node, int p_phase, double *p_min, double *p_max)
+{
+	// Computes the bounding box of the subtree into p_min/p_max, sets the slack of each node in it, and returns their total slack
+	int spatiality = spatiality_;
+	int next_phase = ((p_phase + 1 >= spatiality) ? 0 : p_phase + 1);
+	double split = p_node->x[p_phase];
+	double slack = 0.0, total_slack = 0.0;
+	
+	for (int dim = 0; dim < spatiality; ++dim)
+		p_min[dim] = p_max[dim] = p_node->x[dim];
+	
+	for (SLiM_kdNode *child : {p_node->left, p_node->right})
+	{
+		if (!child)
+			continue;
+		
+		double child_min[SLIM_MAX_DIMENSIONALITY], child_max[SLIM_MAX_DIMENSIONALITY];
+		
+		total_slack += RefitKDTree_Bounds(child, next_phase, child_min, child_max);
+		
+		if (child == p_node->left)
+			slack = std::max(slack, child_max[p_phase] - split);
+		else
+			slack = std::max(slack, split - child_min[p_phase]);
+		
+		for (int dim = 0; dim < spatiality; ++dim)
+		{
+			p_min[dim] = std::min(p_min[dim], child_min[dim]);
+			p_max[dim] = std::max(p_max[dim], child_max[dim]);
+		}
+	}
+	
+	// round the slack up when storing it as a float, so that queries never prune a subtree that could contain a neighbor
+	float float_slack = (float)slack;
+	
+	if ((double)float_slack < slack)
+		float_slack = std::nextafter(float_slack, std::numeric_limits<float>::infinity());
+	
+	p_node->slack_ = float_slack;
+	
+	return total_slack + slack;
+}
+
+#if DEBUG
+int InteractionType::CheckRefitKDTree(SLiM_kdNode *p_node, int p_phase, double *p_min, double *p_max)
+{
+	// Checks that each node's slack covers its subtrees, recomputing bounding boxes independently of RefitKDTree_Bounds()
+	int spatiality = spatiality_;
+	int next_phase = ((p_phase + 1 >= spatiality) ? 0 : p_phase + 1);
+	int count = 1;
+	
+	for (int dim = 0; dim < spatiality; ++dim)
+		p_min[dim] = p_max[dim] = p_node->x[dim];
+	
+	if (p_node->individual_index_ < 0)
+		EIDOS_TERMINATION << "ERROR (InteractionType::CheckRefitKDTree): (internal error) the refitted k-d tree contains a tombstoned node." << EidosTerminate();
+	
+	double child_min[SLIM_MAX_DIMENSIONALITY], child_max[SLIM_MAX_DIMENSIONALITY];
+	
+	if (p_node->left)
+	{
+		count += CheckRefitKDTree(p_node->left, next_phase, child_min, child_max);
+		
+		if (child_max[p_phase] > p_node->x[p_phase] + (double)p_node->slack_)
+			EIDOS_TERMINATION << "ERROR (InteractionType::CheckRefitKDTree): (internal error) the refitted k-d tree has insufficient slack." << EidosTerminate();
+		
+		for (int dim = 0; dim < spatiality; ++dim)
+		{
+			p_min[dim] = std::min(p_min[dim], child_min[dim]);
+			p_max[dim] = std::max(p_max[dim], child_max[dim]);
+		}
+	}
+	if (p_node->right)
+	{
+		count += CheckRefitKDTree(p_node->right, next_phase, child_min, child_max);
+		
+		if (child_min[p_phase] < p_node->x[p_phase] - (double)p_node->slack_)
+			EIDOS_TERMINATION << "ERROR (InteractionType::CheckRefitKDTree): (internal error) the refitted k-d tree has insufficient slack." << EidosTerminate();
+		
+		for (int dim = 0; dim < spatiality; ++dim)
+		{
+			p_min[dim] = std::min(p_min[dim], child_min[dim]);
+			p_max[dim] = std::max(p_max[dim], child_max[dim]);
+		}
+	}
+	
+	return count;
+}
+#endif
+
+
 #pragma mark -
 #pragma mark k-d tree consistency checking
 #pragma mark -
@@ -2144,6 +2996,15 @@ void InteractionType::CheckKDTree3_p2_r(SLiM_kdNode *t, double split, bool isLef
 #pragma mark sparse vector building
 #pragma mark -
 
+// the squared distance from a point at offset dx from a node's split to the node's far subtree, at minimum; this is normally
+// just dx squared, but in a refitted tree the subtrees may extend across the split by up to slack_ (see RefitKDTree())
+inline __attribute__((always_inline)) double split_dist_sq(SLiM_kdNode *a, double dx)
+{
+	double t = std::fabs(dx) - a->slack_;
+	
+	return ((t > 0.0) ? t * t : 0.0);
+}
+
 inline __attribute__((always_inline)) double dist_sq1(SLiM_kdNode *a, double *b)
 {
 #ifndef __clang_analyzer__
@@ -2201,7 +3062,7 @@ void InteractionType::BuildSV_Presences_1(SLiM_kdNode *root, double *nd, slim_po
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 		p_sparse_vector->AddEntryPresence(root->individual_index_);
@@ -2237,7 +3098,7 @@ void InteractionType::BuildSV_Presences_2(SLiM_kdNode *root, double *nd, slim_po
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 		p_sparse_vector->AddEntryPresence(root->individual_index_);
@@ -2275,7 +3136,7 @@ void InteractionType::BuildSV_Presences_3(SLiM_kdNode *root, double *nd, slim_po
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 		p_sparse_vector->AddEntryPresence(root->individual_index_);
@@ -2313,7 +3174,7 @@ void InteractionType::BuildSV_Distances_1(SLiM_kdNode *root, double *nd, slim_po
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 		p_sparse_vector->AddEntryDistance(root->individual_index_, (sv_value_t)sqrt(d));
@@ -2349,7 +3210,7 @@ void InteractionType::BuildSV_Distances_2(SLiM_kdNode *root, double *nd, slim_po
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 		p_sparse_vector->AddEntryDistance(root->individual_index_, (sv_value_t)sqrt(d));
@@ -2387,7 +3248,7 @@ void InteractionType::BuildSV_Distances_3(SLiM_kdNode *root, double *nd, slim_po
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 		p_sparse_vector->AddEntryDistance(root->individual_index_, (sv_value_t)sqrt(d));
@@ -2425,7 +3286,7 @@ void InteractionType::BuildSV_Strengths_f_2(SLiM_kdNode *root, double *nd, slim_
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 	{
@@ -2454,7 +3315,7 @@ void InteractionType::BuildSV_Strengths_l_2(SLiM_kdNode *root, double *nd, slim_
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 	{
@@ -2483,7 +3344,7 @@ void InteractionType::BuildSV_Strengths_e_2(SLiM_kdNode *root, double *nd, slim_
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 	{
@@ -2512,7 +3373,7 @@ void InteractionType::BuildSV_Strengths_n_2(SLiM_kdNode *root, double *nd, slim_
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 	{
@@ -2541,7 +3402,7 @@ void InteractionType::BuildSV_Strengths_c_2(SLiM_kdNode *root, double *nd, slim_
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 	{
@@ -2570,7 +3431,7 @@ void InteractionType::BuildSV_Strengths_t_2(SLiM_kdNode *root, double *nd, slim_
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 	{
@@ -2685,7 +3546,7 @@ bool InteractionType::_PrecheckIndividualNonSexConstraints(Individual *p_individ
 	return true;
 }
 
-void InteractionType::FillSparseVectorForReceiverPresences(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, __attribute__((__unused__)) bool constraints_active)
+void InteractionType::FillSparseVectorForReceiverPresences(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, SLiM_cellGrid *cell_grid, __attribute__((__unused__)) bool constraints_active)
 {
 #if DEBUG
 	// The caller should guarantee that the receiver and exerter species are compatible with the interaction
@@ -2727,7 +3588,8 @@ void InteractionType::FillSparseVectorForReceiverPresences(SparseVector *sv, Ind
 		slim_popsize_t excluded_index = (exerter_subpop == receiver->subpopulation_) ? receiver->index_ : -1;
 		
 		// Without a specified exerter sex, we can add each exerter with no sex test
-		if (spatiality_ == 2)		BuildSV_Presences_2(kd_root, receiver_position, excluded_index, sv, 0);
+		if (cell_grid)				BuildSV_Presences_Grid(cell_grid, kd_root, receiver_position, excluded_index, sv);
+		else if (spatiality_ == 2)	BuildSV_Presences_2(kd_root, receiver_position, excluded_index, sv, 0);
 		else if (spatiality_ == 1)	BuildSV_Presences_1(kd_root, receiver_position, excluded_index, sv);
 		else if (spatiality_ == 3)	BuildSV_Presences_3(kd_root, receiver_position, excluded_index, sv, 0);
 	}
@@ -2736,7 +3598,7 @@ void InteractionType::FillSparseVectorForReceiverPresences(SparseVector *sv, Ind
 	sv->Finished();
 }
 
-void InteractionType::FillSparseVectorForReceiverDistances(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, __attribute__((__unused__)) bool constraints_active)
+void InteractionType::FillSparseVectorForReceiverDistances(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, SLiM_cellGrid *cell_grid, __attribute__((__unused__)) bool constraints_active)
 {
 #if DEBUG
 	// The caller should guarantee that the receiver and exerter species are compatible with the interaction
@@ -2777,7 +3639,8 @@ void InteractionType::FillSparseVectorForReceiverDistances(SparseVector *sv, Ind
 		// Figure out what index in the exerter subpopulation, if any, needs to be excluded so self-interaction is zero
 		slim_popsize_t excluded_index = (exerter_subpop == receiver->subpopulation_) ? receiver->index_ : -1;
 		
-		if (spatiality_ == 2)		BuildSV_Distances_2(kd_root, receiver_position, excluded_index, sv, 0);
+		if (cell_grid)				BuildSV_Distances_Grid(cell_grid, kd_root, receiver_position, excluded_index, sv);
+		else if (spatiality_ == 2)	BuildSV_Distances_2(kd_root, receiver_position, excluded_index, sv, 0);
 		else if (spatiality_ == 1)	BuildSV_Distances_1(kd_root, receiver_position, excluded_index, sv);
 		else if (spatiality_ == 3)	BuildSV_Distances_3(kd_root, receiver_position, excluded_index, sv, 0);
 	}
@@ -2786,7 +3649,7 @@ void InteractionType::FillSparseVectorForReceiverDistances(SparseVector *sv, Ind
 	sv->Finished();
 }
 
-void InteractionType::FillSparseVectorForPointDistances(SparseVector *sv, double *position, __attribute__((__unused__)) Subpopulation *exerter_subpop, SLiM_kdNode *kd_root)
+void InteractionType::FillSparseVectorForPointDistances(SparseVector *sv, double *position, __attribute__((__unused__)) Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, SLiM_cellGrid *cell_grid)
 {
 	// This is a special version of FillSparseVectorForReceiverDistances() used for nearestNeighborsOfPoint().
 	// It searches for neighbors of a point, without using a receiver, just a point.
@@ -2806,7 +3669,8 @@ void InteractionType::FillSparseVectorForPointDistances(SparseVector *sv, double
 	// if the root is nullptr, the tree is empty and we have no results
 	if (kd_root)
 	{
-		if (spatiality_ == 2)		BuildSV_Distances_2(kd_root, position, -1, sv, 0);
+		if (cell_grid)				BuildSV_Distances_Grid(cell_grid, kd_root, position, -1, sv);
+		else if (spatiality_ == 2)	BuildSV_Distances_2(kd_root, position, -1, sv, 0);
 		else if (spatiality_ == 1)	BuildSV_Distances_1(kd_root, position, -1, sv);
 		else if (spatiality_ == 3)	BuildSV_Distances_3(kd_root, position, -1, sv, 0);
 	}
@@ -2815,7 +3679,37 @@ void InteractionType::FillSparseVectorForPointDistances(SparseVector *sv, double
 	sv->Finished();
 }
 
-void InteractionType::FillSparseVectorForReceiverStrengths(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, std::vector<SLiMEidosBlock*> &interaction_callbacks)
+// Returns true if a strength cache row was computed for the given receiver, at the given position
+static inline __attribute__((always_inline)) bool StrengthCacheRowMatches(SLiM_strengthCacheRow &p_row, Individual *p_receiver, double *p_receiver_position, int p_spatiality)
+{
+	if ((p_row.receiver_ != p_receiver) || (p_row.receiver_pedigree_id_ != p_receiver->PedigreeID()))
+		return false;
+	
+	for (int dim = 0; dim < p_spatiality; ++dim)
+		if (p_row.position_[dim] != p_receiver_position[dim])
+			return false;
+	
+	return true;
+}
+
+// Copies a finished sparse vector of strengths for a receiver into a strength cache row, replacing the row's previous contents
+static void StoreStrengthCacheRow(SLiM_strengthCacheRow &p_row, Individual *p_receiver, double *p_receiver_position, int p_spatiality, SparseVector *p_sv)
+{
+	uint32_t nnz;
+	const uint32_t *columns;
+	const sv_value_t *strengths = p_sv->Strengths(&nnz, &columns);
+	
+	p_row.receiver_ = p_receiver;
+	p_row.receiver_pedigree_id_ = p_receiver->PedigreeID();
+	
+	for (int dim = 0; dim < p_spatiality; ++dim)
+		p_row.position_[dim] = p_receiver_position[dim];
+	
+	p_row.columns_.assign(columns, columns + nnz);
+	p_row.strengths_.assign(strengths, strengths + nnz);
+}
+
+void InteractionType::FillSparseVectorForReceiverStrengths(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, SLiM_cellGrid *cell_grid, std::vector<SLiMEidosBlock*> &interaction_callbacks)
 {
 #if DEBUG
 	// The caller should guarantee that the receiver and exerter species are compatible with the interaction
@@ -2842,6 +3736,45 @@ void InteractionType::FillSparseVectorForReceiverStrengths(SparseVector *sv, Ind
 		EIDOS_TERMINATION << "ERROR (InteractionType::FillSparseVectorForReceiverStrengths): (internal error) the receiver is a new juvenile." << EidosTerminate();
 #endif
 	
+	// If the strength cache is enabled, and prepared for the exerter subpopulation, the receiver's cached row is reused if it is
+	// still valid; otherwise the row is computed below, and then cached.  Rows are cached only for receivers in the exerter
+	// subpopulation, and only when there are no interaction() callbacks.  See PrepareStrengthCache().  Inside an active parallel
+	// region rows are used but not added, since two threads might then write the same row (if a receiver is given twice).
+	SLiM_strengthCacheRow *cache_row = nullptr;
+	
+	if (strength_cache_enabled_ && (interaction_callbacks.size() == 0) && (receiver->subpopulation_ == exerter_subpop))
+	{
+		auto data_iter = data_.find(exerter_subpop->subpopulation_id_);
+		SLiM_strengthCache *strength_cache = (data_iter == data_.end()) ? nullptr : data_iter->second.strength_cache_;
+		
+		if (strength_cache)
+		{
+			cache_row = &strength_cache->rows_[receiver->index_];
+			
+			if (StrengthCacheRowMatches(*cache_row, receiver, receiver_position, spatiality_))
+			{
+				size_t exerter_count = cache_row->columns_.size();
+				uint32_t *columns = cache_row->columns_.data();
+				sv_value_t *strengths = cache_row->strengths_.data();
+				
+				for (size_t exerter_iter = 0; exerter_iter < exerter_count; ++exerter_iter)
+					sv->AddEntryStrength(columns[exerter_iter], strengths[exerter_iter]);
+				
+				sv->Finished();
+				
+#if (SLIMPROFILING == 1)
+				profile_strength_cache_hits_++;
+#endif
+				return;
+			}
+			
+#ifdef _OPENMP
+			if (omp_in_parallel())
+				cache_row = nullptr;
+#endif
+		}
+	}
+	
 	// if the root is nullptr, the tree is empty and we have no results
 	if (kd_root)
 	{
@@ -2852,11 +3785,19 @@ void InteractionType::FillSparseVectorForReceiverStrengths(SparseVector *sv, Ind
 		// with no callbacks and spatiality "xy". Other kernels use the two-pass path below
 		// which enables SIMD optimizations for Exponential and Normal kernels.
 		// ADK 12/16/2025: changed to only use special-case path for Fixed kernel
-		if ((interaction_callbacks.size() == 0) && (spatiality_ == 2) && (if_type_ == SpatialKernelType::kFixed))
+		if ((interaction_callbacks.size() == 0) && (spatiality_ == 2) && (if_type_ == SpatialKernelType::kFixed) && !cell_grid)
 		{
 			sv->SetDataType(SparseVectorDataType::kStrengths);
 			BuildSV_Strengths_f_2(kd_root, receiver_position, excluded_index, sv, 0);
 			sv->Finished();
+			
+			if (cache_row)
+			{
+				StoreStrengthCacheRow(*cache_row, receiver, receiver_position, spatiality_, sv);
+#if (SLIMPROFILING == 1)
+				profile_strength_cache_misses_++;
+#endif
+			}
 			return;
 		}
 
@@ -2888,7 +3829,8 @@ void InteractionType::FillSparseVectorForReceiverStrengths(SparseVector *sv, Ind
 		// Set up to build distances first; this is an internal implementation detail, so we require the sparse vector set up for strengths above
 		sv->SetDataType(SparseVectorDataType::kDistances);
 		
-		if (spatiality_ == 2)		BuildSV_Distances_2(kd_root, receiver_position, excluded_index, sv, 0);
+		if (cell_grid)				BuildSV_Distances_Grid(cell_grid, kd_root, receiver_position, excluded_index, sv);
+		else if (spatiality_ == 2)	BuildSV_Distances_2(kd_root, receiver_position, excluded_index, sv, 0);
 		else if (spatiality_ == 1)	BuildSV_Distances_1(kd_root, receiver_position, excluded_index, sv);
 		else if (spatiality_ == 3)	BuildSV_Distances_3(kd_root, receiver_position, excluded_index, sv, 0);
 	}
@@ -2978,6 +3920,412 @@ void InteractionType::FillSparseVectorForReceiverStrengths(SparseVector *sv, Ind
 	
 	// We have transformed distances into strengths in the sparse vector's values_ buffer
 	sv->SetDataType(SparseVectorDataType::kStrengths);
+	
+	if (cache_row)
+	{
+		StoreStrengthCacheRow(*cache_row, receiver, receiver_position, spatiality_, sv);
+#if (SLIMPROFILING == 1)
+		profile_strength_cache_misses_++;
+#endif
+	}
+}
+
+
+#pragma mark -
+#pragma mark strength caching
+#pragma mark -
+
+// In models in which most individuals do not move (plants, for example), the interaction strengths for most receivers are the same
+// from one evaluation to the next.  If the strength cache is enabled, FillSparseVectorForReceiverStrengths() keeps the strengths it
+// computes for each receiver, and at each evaluation the rows that might have changed are discarded: those for receivers that have
+// moved or died, and those within max_distance_ of any change, which is any position at which an individual has died, been born,
+// or arrived or departed by moving.  To find the rows near changes quickly, the changed positions are binned into a grid of cells
+// at least max_distance_ on a side (larger if the grid would otherwise have too many cells); a row is kept only if none of the 3^D
+// cells around it contains a change.  This is conservative; a row may be discarded even though no change is within range of it.
+#define SLIM_STRENGTH_CACHE_MAX_CELLS	(1 << 20)		// the maximum number of cells in the grid of changed positions
+
+void InteractionType::PrepareStrengthCache(Subpopulation *p_subpop, InteractionsData &p_subpop_data)
+{
+	// The cache is used only for spatial interactions without exerter constraints, in non-periodic models; otherwise it is discarded
+	if (!strength_cache_enabled_ || (spatiality_ == 0) || exerter_constraints_.has_constraints_ ||
+		p_subpop_data.periodic_x_ || p_subpop_data.periodic_y_ || p_subpop_data.periodic_z_)
+	{
+		p_subpop_data.FreeStrengthCache();
+		return;
+	}
+	
+	if (!p_subpop_data.strength_cache_)
+		p_subpop_data.strength_cache_ = new SLiM_strengthCache();
+	
+	SLiM_strengthCache &cache = *p_subpop_data.strength_cache_;
+	std::vector<Individual *> &individuals = p_subpop->parent_individuals_;
+	slim_popsize_t individual_count = p_subpop_data.individual_count_;
+	slim_popsize_t previous_count = (slim_popsize_t)cache.individuals_.size();
+	double *positions = p_subpop_data.positions_;
+	double *previous_positions = cache.positions_.data();
+	int spatiality = spatiality_;
+	
+	// Find which of the previous individuals are still present, and collect the positions at which something has changed.  Since
+	// individuals usually stay in the same order, we walk the two vectors of individuals in parallel; if they get out of step, as in
+	// RefitKDTree() an individual is still present if it is at the index it now claims (individuals that have died can still be
+	// read).  An Individual object might have been reused for a new individual; if it is at the same position it is matched to the
+	// previous individual, but that is harmless, since without interaction() callbacks strengths depend only upon positions.  (The
+	// receiver's pedigree ID is checked before a row is used, though, so that a row is only used for the receiver it was made for,
+	// when pedigrees are being tracked.)
+	std::vector<slim_popsize_t> new_indices(previous_count, -1);
+	std::vector<uint8_t> matched(individual_count, 0);
+	std::vector<double> changes;		// changed positions, spatiality entries per position
+	bool indices_changed = false;		// true if any individual that has not moved now has a different index
+	slim_popsize_t next_index = 0;		// the index at which we expect to find the next previous individual
+	
+	for (slim_popsize_t previous_index = 0; previous_index < previous_count; ++previous_index)
+	{
+		Individual *individual = cache.individuals_[previous_index];
+		double *previous_position = previous_positions + (size_t)previous_index * SLIM_MAX_DIMENSIONALITY;
+		slim_popsize_t new_index;
+		
+		if ((next_index < individual_count) && (individuals[next_index] == individual))
+			new_index = next_index;
+		else
+			new_index = individual->index_;
+		
+		if ((new_index >= 0) && (new_index < individual_count) && (individuals[new_index] == individual) && !matched[new_index])
+		{
+			next_index = new_index + 1;
+			
+			double *position = positions + (size_t)new_index * SLIM_MAX_DIMENSIONALITY;
+			bool moved = false;
+			
+			for (int dim = 0; dim < spatiality; ++dim)
+				if (position[dim] != previous_position[dim])
+					moved = true;
+			
+			matched[new_index] = 1;
+			
+			if (moved)
+			{
+				changes.insert(changes.end(), previous_position, previous_position + spatiality);
+				changes.insert(changes.end(), position, position + spatiality);
+			}
+			else
+			{
+				new_indices[previous_index] = new_index;
+				
+				if (new_index != previous_index)
+					indices_changed = true;
+			}
+		}
+		else
+		{
+			changes.insert(changes.end(), previous_position, previous_position + spatiality);
+		}
+	}
+	
+	for (slim_popsize_t new_index = 0; new_index < individual_count; ++new_index)
+	{
+		if (!matched[new_index])
+		{
+			double *position = positions + (size_t)new_index * SLIM_MAX_DIMENSIONALITY;
+			
+			changes.insert(changes.end(), position, position + spatiality);
+		}
+	}
+	
+	// Bin the changed positions into a grid of cells, as described above
+	size_t change_count = changes.size() / spatiality;
+	bool keep_rows = true;
+	double origin[SLIM_MAX_DIMENSIONALITY] = {0.0, 0.0, 0.0};
+	int64_t cell_count[SLIM_MAX_DIMENSIONALITY] = {1, 1, 1};
+	double inverse_cell_size = 0.0;
+	std::vector<uint8_t> changed_cells;
+	
+	if (change_count > 0)
+	{
+		if (std::isinf(max_distance_))
+		{
+			// every receiver is within range of every change, so no row can be kept
+			keep_rows = false;
+		}
+		else
+		{
+			double extent[SLIM_MAX_DIMENSIONALITY] = {0.0, 0.0, 0.0};
+			double max_extent = 0.0;
+			
+			for (int dim = 0; dim < spatiality; ++dim)
+			{
+				double min_coord = changes[dim], max_coord = changes[dim];
+				
+				for (size_t change_index = 1; change_index < change_count; ++change_index)
+				{
+					double coord = changes[change_index * spatiality + dim];
+					
+					min_coord = std::min(min_coord, coord);
+					max_coord = std::max(max_coord, coord);
+				}
+				
+				origin[dim] = min_coord;
+				extent[dim] = max_coord - min_coord;
+				max_extent = std::max(max_extent, extent[dim]);
+			}
+			
+			// the cell size is padded a little, so that roundoff cannot put two points within max_distance_ two cells apart
+			double max_cells_per_dim = std::floor(std::pow((double)SLIM_STRENGTH_CACHE_MAX_CELLS, 1.0 / spatiality)) - 1.0;
+			double cell_size = std::max(max_distance_ * (1.0 + 1e-6), max_extent / max_cells_per_dim);
+			
+			if (!(cell_size > 0.0))
+				cell_size = 1.0;		// all changes are at a single point, and max_distance_ is zero
+			
+			inverse_cell_size = 1.0 / cell_size;
+			
+			for (int dim = 0; dim < spatiality; ++dim)
+				cell_count[dim] = (int64_t)(extent[dim] * inverse_cell_size) + 1;
+			
+			changed_cells.resize(cell_count[0] * cell_count[1] * cell_count[2], 0);
+			
+			for (size_t change_index = 0; change_index < change_count; ++change_index)
+			{
+				int64_t cell_index = 0;
+				
+				for (int dim = spatiality - 1; dim >= 0; --dim)
+				{
+					int64_t cell = (int64_t)((changes[change_index * spatiality + dim] - origin[dim]) * inverse_cell_size);
+					
+					cell = std::min(cell, cell_count[dim] - 1);
+					cell_index = cell_index * cell_count[dim] + cell;
+				}
+				
+				changed_cells[cell_index] = 1;
+			}
+		}
+	}
+	
+	// Carry the rows that are still valid over to the new indices of their receivers.  Rows are swapped between rows_ and
+	// spare_rows_, rather than reallocated, so that once equilibrated their buffers are reused rather than freed and malloced.
+	std::vector<SLiM_strengthCacheRow> &rows = cache.spare_rows_;
+	
+	rows.resize(individual_count);
+	
+	for (SLiM_strengthCacheRow &row : rows)
+		row.receiver_ = nullptr;
+	
+	if (keep_rows)
+	{
+		for (slim_popsize_t previous_index = 0; previous_index < (slim_popsize_t)cache.rows_.size(); ++previous_index)
+		{
+			SLiM_strengthCacheRow &row = cache.rows_[previous_index];
+			slim_popsize_t new_index = new_indices[previous_index];
+			
+			if (!row.receiver_ || (new_index == -1))
+				continue;
+			
+			if (change_count > 0)
+			{
+				// check the 3^D block of cells around the row's position, clipped to the grid
+				int64_t low[SLIM_MAX_DIMENSIONALITY] = {0, 0, 0}, high[SLIM_MAX_DIMENSIONALITY] = {0, 0, 0};
+				bool near_change = false;
+				bool outside_grid = false;
+				
+				for (int dim = 0; dim < spatiality; ++dim)
+				{
+					double cell = std::floor((row.position_[dim] - origin[dim]) * inverse_cell_size);
+					
+					if ((cell < -1.0) || (cell > (double)cell_count[dim]))
+					{
+						outside_grid = true;
+						break;
+					}
+					
+					low[dim] = std::max((int64_t)cell - 1, (int64_t)0);
+					high[dim] = std::min((int64_t)cell + 1, cell_count[dim] - 1);
+				}
+				
+				if (!outside_grid)
+				{
+					for (int64_t z = low[2]; (z <= high[2]) && !near_change; ++z)
+						for (int64_t y = low[1]; (y <= high[1]) && !near_change; ++y)
+							for (int64_t x = low[0]; x <= high[0]; ++x)
+								if (changed_cells[(z * cell_count[1] + y) * cell_count[0] + x])
+								{
+									near_change = true;
+									break;
+								}
+				}
+				
+				if (near_change)
+					continue;
+			}
+			
+			// the row's exerters are all within max_distance_ of it, and so have not moved or died; remap their indices
+			if (indices_changed)
+			{
+				for (uint32_t &column : row.columns_)
+				{
+#if DEBUG
+					if (new_indices[column] == -1)
+						EIDOS_TERMINATION << "ERROR (InteractionType::PrepareStrengthCache): (internal error) a cached exerter is no longer present." << EidosTerminate();
+#endif
+					column = (uint32_t)new_indices[column];
+				}
+			}
+			
+			std::swap(rows[new_index], row);
+		}
+	}
+	
+	cache.rows_.swap(cache.spare_rows_);
+	
+	// Remember the individuals and positions evaluated, for comparison at the next evaluation
+	cache.individuals_ = individuals;
+	cache.positions_.resize((size_t)individual_count * SLIM_MAX_DIMENSIONALITY);
+	
+	for (slim_popsize_t index = 0; index < individual_count; ++index)
+	{
+		for (int dim = 0; dim < spatiality; ++dim)
+			cache.positions_[(size_t)index * SLIM_MAX_DIMENSIONALITY + dim] = positions[(size_t)index * SLIM_MAX_DIMENSIONALITY + dim];
+	}
+}
+
+void InteractionType::FreeStrengthCaches(void)
+{
+	for (auto &data_iter : data_)
+		data_iter.second.FreeStrengthCache();
+}
+
+
+#pragma mark -
+#pragma mark cell grid neighbor searches
+#pragma mark -
+
+// visit all nodes within max_distance_ of nd in a cell grid, in D dimensions; p_function is called with each node and its squared distance
+template <int D, typename F>
+static inline __attribute__((always_inline)) void _ForEachCellGridNeighbor(SLiM_cellGrid *p_grid, SLiM_kdNode *p_nodes, double *nd, double p_max_distance, double p_max_distance_sq, F &p_function)
+{
+	int64_t low[SLIM_MAX_DIMENSIONALITY] = {0, 0, 0};
+	int64_t high[SLIM_MAX_DIMENSIONALITY] = {0, 0, 0};
+	
+	// Find the range of cells overlapping the bounding box of the interaction distance; since cells are at least max_distance_
+	// wide this is at most three cells in each dimension.  Ranges are clamped to the grid; if a range is empty (the point is
+	// beyond the grid by more than max_distance_, or is NaN), there are no neighbors.
+	for (int dim = 0; dim < D; ++dim)
+	{
+		double l = std::floor((nd[dim] - p_max_distance - p_grid->origin_[dim]) * p_grid->inverse_cell_size_);
+		double h = std::floor((nd[dim] + p_max_distance - p_grid->origin_[dim]) * p_grid->inverse_cell_size_);
+		
+		if (l < 0.0)
+			l = 0.0;
+		if (h > p_grid->cell_count_[dim] - 1)
+			h = (double)(p_grid->cell_count_[dim] - 1);
+		if (!(l <= h))
+			return;
+		
+		low[dim] = (int64_t)l;
+		high[dim] = (int64_t)h;
+	}
+	
+	// Cells are row-major with x varying fastest, so the cells in each row of the range have contiguous nodes
+	const uint32_t *cell_starts = p_grid->cell_starts_.data();
+	int64_t cell_count_x = p_grid->cell_count_[0], cell_count_y = p_grid->cell_count_[1];
+	
+	for (int64_t cell_z = low[2]; cell_z <= high[2]; ++cell_z)
+	{
+		for (int64_t cell_y = low[1]; cell_y <= high[1]; ++cell_y)
+		{
+			int64_t row_start = cell_count_x * (cell_y + cell_count_y * cell_z);
+			uint32_t node_end = cell_starts[row_start + high[0] + 1];
+			
+			for (uint32_t node_index = cell_starts[row_start + low[0]]; node_index < node_end; ++node_index)
+			{
+				SLiM_kdNode *node = p_nodes + node_index;
+				double d;
+				
+				if (D == 1)			d = dist_sq1(node, nd);
+				else if (D == 2)	d = dist_sq2(node, nd);
+				else				d = dist_sq3(node, nd);
+				
+				if (d <= p_max_distance_sq)
+					p_function(node, d);
+			}
+		}
+	}
+}
+
+template <typename F>
+void InteractionType::ForEachCellGridNeighbor(SLiM_cellGrid *p_grid, SLiM_kdNode *p_nodes, double *nd, F p_function)
+{
+	switch (spatiality_)
+	{
+		case 1: _ForEachCellGridNeighbor<1>(p_grid, p_nodes, nd, max_distance_, max_distance_sq_, p_function); break;
+		case 2: _ForEachCellGridNeighbor<2>(p_grid, p_nodes, nd, max_distance_, max_distance_sq_, p_function); break;
+		case 3: _ForEachCellGridNeighbor<3>(p_grid, p_nodes, nd, max_distance_, max_distance_sq_, p_function); break;
+		default:
+			EIDOS_TERMINATION << "ERROR (InteractionType::ForEachCellGridNeighbor): (internal error) spatiality_ out of range." << EidosTerminate(nullptr);
+	}
+}
+
+// add neighbors to the sparse vector using a cell grid
+void InteractionType::BuildSV_Presences_Grid(SLiM_cellGrid *p_grid, SLiM_kdNode *p_nodes, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector)
+{
+	ForEachCellGridNeighbor(p_grid, p_nodes, nd, [p_focal_individual_index, p_sparse_vector](SLiM_kdNode *node, __attribute__((unused)) double d) {
+		if (node->individual_index_ != p_focal_individual_index)
+			p_sparse_vector->AddEntryPresence(node->individual_index_);
+	});
+}
+
+// add neighbors to the sparse vector using a cell grid
+void InteractionType::BuildSV_Distances_Grid(SLiM_cellGrid *p_grid, SLiM_kdNode *p_nodes, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector)
+{
+	ForEachCellGridNeighbor(p_grid, p_nodes, nd, [p_focal_individual_index, p_sparse_vector](SLiM_kdNode *node, double d) {
+		if (node->individual_index_ != p_focal_individual_index)
+			p_sparse_vector->AddEntryDistance(node->individual_index_, (sv_value_t)sqrt(d));
+	});
+}
+
+// count neighbors using a cell grid
+int InteractionType::CountNeighbors_Grid(SLiM_cellGrid *p_grid, SLiM_kdNode *p_nodes, double *nd, slim_popsize_t p_focal_individual_index)
+{
+	int neighborCount = 0;
+	
+	ForEachCellGridNeighbor(p_grid, p_nodes, nd, [p_focal_individual_index, &neighborCount](SLiM_kdNode *node, __attribute__((unused)) double d) {
+		if (node->individual_index_ != p_focal_individual_index)
+			neighborCount++;
+	});
+	
+	return neighborCount;
+}
+
+// find the one best neighbor, within the interaction distance, using a cell grid
+void InteractionType::FindNeighbors1_Grid(SLiM_cellGrid *p_grid, SLiM_kdNode *p_nodes, double *nd, slim_popsize_t p_focal_individual_index, SLiM_kdNode **best, double *best_dist)
+{
+	ForEachCellGridNeighbor(p_grid, p_nodes, nd, [p_focal_individual_index, best, best_dist](SLiM_kdNode *node, double d) {
+		if ((!*best || d < *best_dist) && (node->individual_index_ != p_focal_individual_index)) {
+			*best_dist = d;
+			*best = node;
+		}
+	});
+}
+
+// find all neighbors using a cell grid
+void InteractionType::FindNeighborsA_Grid(SLiM_cellGrid *p_grid, SLiM_kdNode *p_nodes, double *nd, slim_popsize_t p_focal_individual_index, EidosValue_Object &p_result_vec, std::vector<Individual *> &p_individuals)
+{
+	ForEachCellGridNeighbor(p_grid, p_nodes, nd, [p_focal_individual_index, &p_result_vec, &p_individuals](SLiM_kdNode *node, __attribute__((unused)) double d) {
+		if (node->individual_index_ != p_focal_individual_index)
+			p_result_vec.push_object_element_capcheck_NORR(p_individuals[node->individual_index_]);
+	});
+}
+
+// count neighbors using whichever spatial index was built, dispatching on spatiality for the k-d tree
+int InteractionType::CountNeighbors(SLiM_kdNode *kd_root, SLiM_cellGrid *cell_grid, double *nd, slim_popsize_t p_focal_individual_index)
+{
+	if (cell_grid)
+		return CountNeighbors_Grid(cell_grid, kd_root, nd, p_focal_individual_index);
+	
+	switch (spatiality_)
+	{
+		case 1: return CountNeighbors_1(kd_root, nd, p_focal_individual_index);
+		case 2: return CountNeighbors_2(kd_root, nd, p_focal_individual_index, 0);
+		case 3: return CountNeighbors_3(kd_root, nd, p_focal_individual_index, 0);
+		default: return 0;	// unsupported value
+	}
 }
 
 
@@ -2995,7 +4343,7 @@ int InteractionType::CountNeighbors_1(SLiM_kdNode *root, double *nd, slim_popsiz
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 		neighborCount++;
@@ -3034,7 +4382,7 @@ int InteractionType::CountNeighbors_2(SLiM_kdNode *root, double *nd, slim_popsiz
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 		neighborCount++;
@@ -3075,7 +4423,7 @@ int InteractionType::CountNeighbors_3(SLiM_kdNode *root, double *nd, slim_popsiz
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 		neighborCount++;
@@ -3115,7 +4463,7 @@ void InteractionType::FindNeighbors1_1(SLiM_kdNode *root, double *nd, slim_popsi
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((!*best || d < *best_dist) && (root->individual_index_ != p_focal_individual_index)) {
 		*best_dist = d;
@@ -3153,7 +4501,7 @@ void InteractionType::FindNeighbors1_2(SLiM_kdNode *root, double *nd, slim_popsi
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((!*best || d < *best_dist) && (root->individual_index_ != p_focal_individual_index)) {
 		*best_dist = d;
@@ -3193,7 +4541,7 @@ void InteractionType::FindNeighbors1_3(SLiM_kdNode *root, double *nd, slim_popsi
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((!*best || d < *best_dist) && (root->individual_index_ != p_focal_individual_index)) {
 		*best_dist = d;
@@ -3233,7 +4581,7 @@ void InteractionType::FindNeighborsA_1(SLiM_kdNode *root, double *nd, slim_popsi
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 		p_result_vec.push_object_element_capcheck_NORR(p_individuals[root->individual_index_]);
@@ -3269,7 +4617,7 @@ void InteractionType::FindNeighborsA_2(SLiM_kdNode *root, double *nd, slim_popsi
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 		p_result_vec.push_object_element_capcheck_NORR(p_individuals[root->individual_index_]);
@@ -3307,7 +4655,7 @@ void InteractionType::FindNeighborsA_3(SLiM_kdNode *root, double *nd, slim_popsi
 #else
 	double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
+	double dx2 = split_dist_sq(root, dx);
 	
 	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
 		p_result_vec.push_object_element_capcheck_NORR(p_individuals[root->individual_index_]);
@@ -3341,7 +4689,7 @@ void InteractionType::FindNeighborsA_3(SLiM_kdNode *root, double *nd, slim_popsi
 // They were not thread-safe, and were replaced by FillSparseVectorForReceiverDistances_ALL_NEIGHBORS();
 // now (11/2/2023) that has turned into FillSparseVectorForReceiverDistances() using kd_root_ALL_, below.
 
-void InteractionType::FindNeighbors(Subpopulation *p_subpop, SLiM_kdNode *kd_root, slim_popsize_t kd_node_count, double *p_point, int p_count, EidosValue_Object &p_result_vec, Individual *p_excluded_individual, bool constraints_active)
+void InteractionType::FindNeighbors(Subpopulation *p_subpop, SLiM_kdNode *kd_root, SLiM_cellGrid *cell_grid, slim_popsize_t kd_node_count, double *p_point, int p_count, EidosValue_Object &p_result_vec, Individual *p_excluded_individual, bool constraints_active)
 {
 	// If this method is passed kd_root_ALL_, from EnsureKDTreePresent_ALL(), it finds all neighbors, regardless
 	// of exerter constraints.  If it is passed kd_root_EXERTERS_, from EnsureKDTreePresent_EXERTERS(), it finds
@@ -3365,17 +4713,24 @@ void InteractionType::FindNeighbors(Subpopulation *p_subpop, SLiM_kdNode *kd_roo
 	
 	if (p_count == 1)
 	{
-		// Finding a single nearest neighbor is special-cased, and does not enforce the max distance; we do that after
+		// Finding a single nearest neighbor is special-cased, and the k-d tree search does not enforce the max distance; we do that after
 		SLiM_kdNode *best = nullptr;
 		double best_dist = 0.0;
 		
-		switch (spatiality_)
+		if (cell_grid)
 		{
-			case 1: FindNeighbors1_1(kd_root, p_point, focal_individual_index, &best, &best_dist);		break;
-			case 2: FindNeighbors1_2(kd_root, p_point, focal_individual_index, &best, &best_dist, 0);	break;
-			case 3: FindNeighbors1_3(kd_root, p_point, focal_individual_index, &best, &best_dist, 0);	break;
-			default:
-				EIDOS_TERMINATION << "ERROR (InteractionType::FindNeighbors): (internal error) spatiality_ out of range." << EidosTerminate(nullptr);
+			FindNeighbors1_Grid(cell_grid, kd_root, p_point, focal_individual_index, &best, &best_dist);
+		}
+		else
+		{
+			switch (spatiality_)
+			{
+				case 1: FindNeighbors1_1(kd_root, p_point, focal_individual_index, &best, &best_dist);		break;
+				case 2: FindNeighbors1_2(kd_root, p_point, focal_individual_index, &best, &best_dist, 0);	break;
+				case 3: FindNeighbors1_3(kd_root, p_point, focal_individual_index, &best, &best_dist, 0);	break;
+				default:
+					EIDOS_TERMINATION << "ERROR (InteractionType::FindNeighbors): (internal error) spatiality_ out of range." << EidosTerminate(nullptr);
+			}
 		}
 		
 		if (best && (best_dist <= max_distance_sq_))
@@ -3388,13 +4743,20 @@ void InteractionType::FindNeighbors(Subpopulation *p_subpop, SLiM_kdNode *kd_roo
 	else if (p_count >= kd_node_count)	// can't do (kd_node_count - 1), because the focal individual might not be among the nodes in the k-d tree
 	{
 		// Finding all neighbors within the interaction distance is special-cased
-		switch (spatiality_)
+		if (cell_grid)
 		{
-			case 1: FindNeighborsA_1(kd_root, p_point, focal_individual_index, p_result_vec, p_subpop->parent_individuals_);		break;
-			case 2: FindNeighborsA_2(kd_root, p_point, focal_individual_index, p_result_vec, p_subpop->parent_individuals_, 0);		break;
-			case 3: FindNeighborsA_3(kd_root, p_point, focal_individual_index, p_result_vec, p_subpop->parent_individuals_, 0);		break;
-			default:
-				EIDOS_TERMINATION << "ERROR (InteractionType::FindNeighbors): (internal error) spatiality_ out of range." << EidosTerminate(nullptr);
+			FindNeighborsA_Grid(cell_grid, kd_root, p_point, focal_individual_index, p_result_vec, p_subpop->parent_individuals_);
+		}
+		else
+		{
+			switch (spatiality_)
+			{
+				case 1: FindNeighborsA_1(kd_root, p_point, focal_individual_index, p_result_vec, p_subpop->parent_individuals_);		break;
+				case 2: FindNeighborsA_2(kd_root, p_point, focal_individual_index, p_result_vec, p_subpop->parent_individuals_, 0);		break;
+				case 3: FindNeighborsA_3(kd_root, p_point, focal_individual_index, p_result_vec, p_subpop->parent_individuals_, 0);		break;
+				default:
+					EIDOS_TERMINATION << "ERROR (InteractionType::FindNeighbors): (internal error) spatiality_ out of range." << EidosTerminate(nullptr);
+			}
 		}
 	}
 	else
@@ -3406,9 +4768,9 @@ void InteractionType::FindNeighbors(Subpopulation *p_subpop, SLiM_kdNode *kd_roo
 		
 		try {
 			if (p_excluded_individual)
-				FillSparseVectorForReceiverDistances(sv, p_excluded_individual, p_point, p_subpop, kd_root, constraints_active);
+				FillSparseVectorForReceiverDistances(sv, p_excluded_individual, p_point, p_subpop, kd_root, cell_grid, constraints_active);
 			else
-				FillSparseVectorForPointDistances(sv, p_point, p_subpop, kd_root);
+				FillSparseVectorForPointDistances(sv, p_point, p_subpop, kd_root, cell_grid);
 			
 			uint32_t nnz;
 			const uint32_t *columns;
@@ -3506,8 +4868,22 @@ EidosValue_SP InteractionType::GetProperty(EidosGlobalStringID p_property_id)
 		}
 			
 			// variables
+		case gID_kdTreeRefit:
+			return (kd_tree_refit_ ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
 		case gID_maxDistance:
 			return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(max_distance_));
+		case gID_strengthCache:
+			return (strength_cache_enabled_ ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		case gID_spatialIndex:
+		{
+			switch (spatial_index_type_)
+			{
+				case SpatialIndexType::kKDTree:		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String("kdtree"));
+				case SpatialIndexType::kCellGrid:	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String("grid"));
+				case SpatialIndexType::kAuto:		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String("auto"));
+			}
+			EIDOS_TERMINATION << "ERROR (InteractionType::GetProperty): (internal error) unrecognized value for spatial_index_type_." << EidosTerminate();
+		}
 		case gID_tag:						// ACCELERATED
 		{
 			slim_usertag_t tag_value = tag_value_;
@@ -3561,6 +4937,18 @@ void InteractionType::SetProperty(EidosGlobalStringID p_property_id, const Eidos
 	// All of our strings are in the global registry, so we can require a successful lookup
 	switch (p_property_id)
 	{
+		case gID_kdTreeRefit:
+		{
+			kd_tree_refit_ = p_value.LogicalAtIndex_NOCAST(0, nullptr);
+			
+			// any trees retained for refitting are no longer needed; trees in use are left alone, and are just not retained
+			if (!kd_tree_refit_)
+				for (auto &data_iter : data_)
+					data_iter.second.FreeRefitTree();
+			
+			return;
+		}
+			
 		case gID_maxDistance:
 		{
 			if (AnyEvaluated())
@@ -3580,6 +4968,36 @@ void InteractionType::SetProperty(EidosGlobalStringID p_property_id, const Eidos
 			// changing max_distance_ invalidates the cached clipped_integral_ buffer; we don't deallocate it, just invalidate it
 			clipped_integral_valid_ = false;
 			
+			// it also invalidates any cached interaction strengths
+			FreeStrengthCaches();
+			
+			return;
+		}
+			
+		case gID_spatialIndex:
+		{
+			if (AnyEvaluated())
+				EIDOS_TERMINATION << "ERROR (InteractionType::SetProperty): spatialIndex cannot be changed while the interaction is being evaluated; call unevaluate() first, or set spatialIndex prior to evaluation of the interaction." << EidosTerminate();
+			
+			std::string value = p_value.StringAtIndex_NOCAST(0, nullptr);
+			
+			if (value == "kdtree")		spatial_index_type_ = SpatialIndexType::kKDTree;
+			else if (value == "grid")	spatial_index_type_ = SpatialIndexType::kCellGrid;
+			else if (value == "auto")	spatial_index_type_ = SpatialIndexType::kAuto;
+			else
+				EIDOS_TERMINATION << "ERROR (InteractionType::SetProperty): new value for property spatialIndex must be 'kdtree', 'grid', or 'auto'." << EidosTerminate();
+			
+			return;
+		}
+			
+		case gID_strengthCache:
+		{
+			strength_cache_enabled_ = p_value.LogicalAtIndex_NOCAST(0, nullptr);
+			
+			// strength caches are set up at evaluation, so enabling takes effect at the next evaluation; disabling takes effect now
+			if (!strength_cache_enabled_)
+				FreeStrengthCaches();
+			
 			return;
 		}
 			
@@ -4335,6 +5753,7 @@ EidosValue_SP InteractionType::ExecuteMethod_drawByStrength(EidosGlobalStringID
 			InteractionsData &receiver_subpop_data = InteractionsDataForSubpop(data_, receiver_subpop);
 			double *receiver_position = receiver_subpop_data.positions_ + (size_t)receiver_index_in_subpop * SLIM_MAX_DIMENSIONALITY;
 			SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+			SLiM_cellGrid *cell_grid_EXERTERS = exerter_subpop_data.cell_grid_EXERTERS_;
 			EidosValue_Object *result_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Individual_Class));
 			EidosValue_SP result_vec_SP(result_vec);
 			
@@ -4348,7 +5767,7 @@ EidosValue_SP InteractionType::ExecuteMethod_drawByStrength(EidosGlobalStringID
 				SparseVector *sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kPresences);
 				
 				try {
-					FillSparseVectorForReceiverPresences(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, /* constraints_active */ true);
+					FillSparseVectorForReceiverPresences(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, cell_grid_EXERTERS, /* constraints_active */ true);
 					uint32_t nnz;
 					const uint32_t *columns;
 					
@@ -4386,7 +5805,7 @@ EidosValue_SP InteractionType::ExecuteMethod_drawByStrength(EidosGlobalStringID
 				SparseVector *sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kStrengths);
 				
 				try {
-					FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);
+					FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, cell_grid_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);
 					uint32_t nnz;
 					const uint32_t *columns;
 					const sv_value_t *strengths;
@@ -4460,6 +5879,7 @@ EidosValue_SP InteractionType::ExecuteMethod_drawByStrength(EidosGlobalStringID
 		if ((count > 0) && (exerter_subpop_size > 0))	// BCH 5/24/2023: if the exerter subpop is empty, no individuals are drawn; short-circuit
 		{
 			SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+			SLiM_cellGrid *cell_grid_EXERTERS = exerter_subpop_data.cell_grid_EXERTERS_;
 			
 			// If there are no exerters satisfying constraints, short-circuit
 			if (!kd_root_EXERTERS)
@@ -4473,7 +5893,7 @@ EidosValue_SP InteractionType::ExecuteMethod_drawByStrength(EidosGlobalStringID
 			Individual * const *receiver_data = (Individual * const *)receiver_value->ObjectData();
 			
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_DRAWBYSTRENGTH);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(gEidos_RNG_PERTHREAD, receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS, optimize_fixed_interaction_strengths) firstprivate(receiver_data, result_vectors, count, exerter_subpop_size) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) reduction(||: saw_error_4) if(!has_interaction_callbacks && (receivers_count >= EIDOS_OMPMIN_DRAWBYSTRENGTH)) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(gEidos_RNG_PERTHREAD, receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS, cell_grid_EXERTERS, optimize_fixed_interaction_strengths) firstprivate(receiver_data, result_vectors, count, exerter_subpop_size) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) reduction(||: saw_error_4) if(!has_interaction_callbacks && (receivers_count >= EIDOS_OMPMIN_DRAWBYSTRENGTH)) num_threads(thread_count)
 			for (int receiver_index = 0; receiver_index < receivers_count; ++receiver_index)
 			{
 				Individual *receiver = (Individual *)receiver_data[receiver_index];
@@ -4511,7 +5931,7 @@ EidosValue_SP InteractionType::ExecuteMethod_drawByStrength(EidosGlobalStringID
 					SparseVector *sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kPresences);
 					
 					try {
-						FillSparseVectorForReceiverPresences(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, /* constraints_active */ true);
+						FillSparseVectorForReceiverPresences(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, cell_grid_EXERTERS, /* constraints_active */ true);
 						uint32_t nnz;
 						const uint32_t *columns;
 						
@@ -4548,7 +5968,7 @@ EidosValue_SP InteractionType::ExecuteMethod_drawByStrength(EidosGlobalStringID
 					
 					// Under OpenMP, raises can't go past the end of the parallel region; handle things the same way when not under OpenMP for simplicity
 					try {
-						FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// protected from running interaction() callbacks in parallel, above
+						FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, cell_grid_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// protected from running interaction() callbacks in parallel, above
 					} catch (...) {
 						saw_error_3 = true;
 						InteractionType::FreeSparseVector(sv);
@@ -4671,6 +6091,7 @@ EidosValue_SP InteractionType::ExecuteMethod_interactingNeighborCount(EidosGloba
 	
 	InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
 	SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+	SLiM_cellGrid *cell_grid_EXERTERS = exerter_subpop_data.cell_grid_EXERTERS_;
 	
 	// If there are no exerters satisfying constraints, short-circuit
 	if (!kd_root_EXERTERS)
@@ -4710,15 +6131,7 @@ EidosValue_SP InteractionType::ExecuteMethod_interactingNeighborCount(EidosGloba
 		// Find the neighbors
 		double *receiver_position = receiver_subpop_data.positions_ + (size_t)receiver_index_in_subpop * SLIM_MAX_DIMENSIONALITY;
 		slim_popsize_t focal_individual_index = (exerter_subpop == receiver_subpop) ? receiver_index_in_subpop : -1;
-		int neighborCount;
-		
-		switch (spatiality_)
-		{
-			case 1: neighborCount = CountNeighbors_1(kd_root_EXERTERS, receiver_position, focal_individual_index);			break;
-			case 2: neighborCount = CountNeighbors_2(kd_root_EXERTERS, receiver_position, focal_individual_index, 0);		break;
-			case 3: neighborCount = CountNeighbors_3(kd_root_EXERTERS, receiver_position, focal_individual_index, 0);		break;
-			default: neighborCount = 0; break;	// unsupported value
-		}
+		int neighborCount = CountNeighbors(kd_root_EXERTERS, cell_grid_EXERTERS, receiver_position, focal_individual_index);
 		
 		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(neighborCount));
 	}
@@ -4728,7 +6141,7 @@ EidosValue_SP InteractionType::ExecuteMethod_interactingNeighborCount(EidosGloba
 		bool saw_error_1 = false, saw_error_2 = false, saw_error_3 = false;
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_INTNEIGHCOUNT);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) if(receivers_count >= EIDOS_OMPMIN_INTNEIGHCOUNT) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS, cell_grid_EXERTERS) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) if(receivers_count >= EIDOS_OMPMIN_INTNEIGHCOUNT) num_threads(thread_count)
 		for (int receiver_index = 0; receiver_index < receivers_count; ++receiver_index)
 		{
 			Individual *receiver = receivers_data[receiver_index];
@@ -4763,15 +6176,7 @@ EidosValue_SP InteractionType::ExecuteMethod_interactingNeighborCount(EidosGloba
 			// Find the neighbors
 			double *receiver_position = receiver_subpop_data.positions_ + (size_t)receiver_index_in_subpop * SLIM_MAX_DIMENSIONALITY;
 			slim_popsize_t focal_individual_index = (exerter_subpop == receiver_subpop) ? receiver_index_in_subpop : -1;
-			int neighborCount;
-			
-			switch (spatiality_)
-			{
-				case 1: neighborCount = CountNeighbors_1(kd_root_EXERTERS, receiver_position, focal_individual_index);			break;
-				case 2: neighborCount = CountNeighbors_2(kd_root_EXERTERS, receiver_position, focal_individual_index, 0);		break;
-				case 3: neighborCount = CountNeighbors_3(kd_root_EXERTERS, receiver_position, focal_individual_index, 0);		break;
-				default: neighborCount = 0; break;	// unsupported value
-			}
+			int neighborCount = CountNeighbors(kd_root_EXERTERS, cell_grid_EXERTERS, receiver_position, focal_individual_index);
 			
 			result_vec->set_int_no_check(neighborCount, receiver_index);
 		}
@@ -4827,6 +6232,7 @@ EidosValue_SP InteractionType::ExecuteMethod_localPopulationDensity(EidosGlobalS
 	
 	InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
 	SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+	SLiM_cellGrid *cell_grid_EXERTERS = exerter_subpop_data.cell_grid_EXERTERS_;
 	
 	// If there are no exerters satisfying constraints, short-circuit
 	if (!kd_root_EXERTERS)
@@ -4888,7 +6294,7 @@ EidosValue_SP InteractionType::ExecuteMethod_localPopulationDensity(EidosGlobalS
 			SparseVector *sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kPresences);
 			
 			try {
-				FillSparseVectorForReceiverPresences(sv, first_receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, /* constraints_active */ true);
+				FillSparseVectorForReceiverPresences(sv, first_receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, cell_grid_EXERTERS, /* constraints_active */ true);
 				
 				uint32_t nnz;
 				sv->Presences(&nnz);
@@ -4907,7 +6313,7 @@ EidosValue_SP InteractionType::ExecuteMethod_localPopulationDensity(EidosGlobalS
 			SparseVector *sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kStrengths);
 			
 			try {
-				FillSparseVectorForReceiverStrengths(sv, first_receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// singleton case, not parallel
+				FillSparseVectorForReceiverStrengths(sv, first_receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, cell_grid_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// singleton case, not parallel
 				
 				// Get the sparse vector data
 				uint32_t nnz;
@@ -4944,7 +6350,7 @@ EidosValue_SP InteractionType::ExecuteMethod_localPopulationDensity(EidosGlobalS
 		bool saw_error_1 = false, saw_error_2 = false, saw_error_3 = false, saw_error_4 = false;
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_LOCALPOPDENSITY);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS, strength_for_zero_distance, clipped_integrals_data, optimize_fixed_interaction_strengths) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) reduction(||: saw_error_4) if(!has_interaction_callbacks && (receivers_count >= EIDOS_OMPMIN_LOCALPOPDENSITY)) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS, cell_grid_EXERTERS, strength_for_zero_distance, clipped_integrals_data, optimize_fixed_interaction_strengths) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) reduction(||: saw_error_4) if(!has_interaction_callbacks && (receivers_count >= EIDOS_OMPMIN_LOCALPOPDENSITY)) num_threads(thread_count)
 		for (int receiver_index = 0; receiver_index < receivers_count; ++receiver_index)
 		{
 			Individual *receiver = receivers_data[receiver_index];
@@ -4986,7 +6392,7 @@ EidosValue_SP InteractionType::ExecuteMethod_localPopulationDensity(EidosGlobalS
 				sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kPresences);
 				
 				try {
-					FillSparseVectorForReceiverPresences(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, /* constraints_active */ true);
+					FillSparseVectorForReceiverPresences(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, cell_grid_EXERTERS, /* constraints_active */ true);
 					
 					uint32_t nnz;
 					sv->Presences(&nnz);
@@ -5003,7 +6409,7 @@ EidosValue_SP InteractionType::ExecuteMethod_localPopulationDensity(EidosGlobalS
 				sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kStrengths);
 				
 				try {
-					FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// we do not allow interaction() callbacks, so this should not raise
+					FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, cell_grid_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// we do not allow interaction() callbacks, so this should not raise
 					
 					// Get the sparse vector data
 					uint32_t nnz;
@@ -5102,6 +6508,7 @@ EidosValue_SP InteractionType::ExecuteMethod_interactionDistance(EidosGlobalStri
 		// NULL means return distances from individuals1 (which must be singleton) to all individuals in the subpopulation
 		// We initialize the return vector to INFINITY, and fill in non-infinite values from the sparse vector
 		SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+		SLiM_cellGrid *cell_grid_EXERTERS = exerter_subpop_data.cell_grid_EXERTERS_;
 		
 		// If the k-d tree has no qualifying exerters, we return all infinity
 		if (!kd_root_EXERTERS)
@@ -5113,7 +6520,7 @@ EidosValue_SP InteractionType::ExecuteMethod_interactionDistance(EidosGlobalStri
 		const sv_value_t *distances;
 		
 		try {
-			FillSparseVectorForReceiverDistances(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, /* constraints_active */ true);
+			FillSparseVectorForReceiverDistances(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, cell_grid_EXERTERS, /* constraints_active */ true);
 			distances = sv->Distances(&nnz, &columns);
 			
 			EidosValue_Float *result_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(exerters_count);
@@ -5293,13 +6700,14 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestInteractingNeighbors(EidosGl
 		double *receiver_position = receiver_subpop_data.positions_ + (size_t)receiver_index_in_subpop * SLIM_MAX_DIMENSIONALITY;
 		InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
 		SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+		SLiM_cellGrid *cell_grid_EXERTERS = exerter_subpop_data.cell_grid_EXERTERS_;
 		
 		EidosValue_Object *result_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Individual_Class));
 		
 		if (count < exerter_subpop_size)		// reserve only if we are finding fewer than every possible neighbor
 			result_vec->reserve((int)count);
 		
-		FindNeighbors(exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.kd_node_count_EXERTERS_, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ true);
+		FindNeighbors(exerter_subpop, kd_root_EXERTERS, cell_grid_EXERTERS, exerter_subpop_data.kd_node_count_EXERTERS_, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ true);
 		
 		return EidosValue_SP(result_vec);
 	}
@@ -5331,9 +6739,10 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestInteractingNeighbors(EidosGl
 			
 			InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
 			SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+			SLiM_cellGrid *cell_grid_EXERTERS = exerter_subpop_data.cell_grid_EXERTERS_;
 			
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_NEARESTINTNEIGH);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS) firstprivate(receiver_data, result_vectors, count, exerter_subpop_size) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) if(receivers_count >= EIDOS_OMPMIN_NEARESTINTNEIGH) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS, cell_grid_EXERTERS) firstprivate(receiver_data, result_vectors, count, exerter_subpop_size) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) if(receivers_count >= EIDOS_OMPMIN_NEARESTINTNEIGH) num_threads(thread_count)
 			for (int receiver_index = 0; receiver_index < receivers_count; ++receiver_index)
 			{
 				Individual *receiver = receiver_data[receiver_index];
@@ -5369,7 +6778,7 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestInteractingNeighbors(EidosGl
 				if (count < exerter_subpop_size)		// reserve only if we are finding fewer than every possible neighbor
 					result_vec->reserve((int)count);
 				
-				FindNeighbors(exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.kd_node_count_EXERTERS_, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ true);
+				FindNeighbors(exerter_subpop, kd_root_EXERTERS, cell_grid_EXERTERS, exerter_subpop_data.kd_node_count_EXERTERS_, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ true);
 			}
 			
 			// deferred raises, for OpenMP compatibility
@@ -5483,13 +6892,14 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestNeighbors(EidosGlobalStringI
 		double *receiver_position = receiver_subpop_data.positions_ + (size_t)receiver_index_in_subpop * SLIM_MAX_DIMENSIONALITY;
 		InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
 		SLiM_kdNode *kd_root_ALL = EnsureKDTreePresent_ALL(exerter_subpop, exerter_subpop_data);
+		SLiM_cellGrid *cell_grid_ALL = exerter_subpop_data.cell_grid_ALL_;
 		
 		EidosValue_Object *result_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Individual_Class));
 		
 		if (count < exerter_subpop_size)		// reserve only if we are finding fewer than every possible neighbor
 			result_vec->reserve((int)count);
 		
-		FindNeighbors(exerter_subpop, kd_root_ALL, exerter_subpop_data.kd_node_count_ALL_, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ false);
+		FindNeighbors(exerter_subpop, kd_root_ALL, cell_grid_ALL, exerter_subpop_data.kd_node_count_ALL_, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ false);
 		
 		return EidosValue_SP(result_vec);
 	}
@@ -5521,9 +6931,10 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestNeighbors(EidosGlobalStringI
 			
 			InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
 			SLiM_kdNode *kd_root_ALL = EnsureKDTreePresent_ALL(exerter_subpop, exerter_subpop_data);
+			SLiM_cellGrid *cell_grid_ALL = exerter_subpop_data.cell_grid_ALL_;
 			
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_NEARESTNEIGH);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_ALL) firstprivate(receiver_data, result_vectors, count, exerter_subpop_size) reduction(||: saw_error_1) reduction(||: saw_error_2) if(receivers_count >= EIDOS_OMPMIN_NEARESTNEIGH) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_ALL, cell_grid_ALL) firstprivate(receiver_data, result_vectors, count, exerter_subpop_size) reduction(||: saw_error_1) reduction(||: saw_error_2) if(receivers_count >= EIDOS_OMPMIN_NEARESTNEIGH) num_threads(thread_count)
 			for (int receiver_index = 0; receiver_index < receivers_count; ++receiver_index)
 			{
 				Individual *receiver = receiver_data[receiver_index];
@@ -5549,7 +6960,7 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestNeighbors(EidosGlobalStringI
 				if (count < exerter_subpop_size)		// reserve only if we are finding fewer than every possible neighbor
 					result_vec->reserve((int)count);
 				
-				FindNeighbors(exerter_subpop, kd_root_ALL, exerter_subpop_data.kd_node_count_ALL_, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ false);
+				FindNeighbors(exerter_subpop, kd_root_ALL, cell_grid_ALL, exerter_subpop_data.kd_node_count_ALL_, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ false);
 			}
 			
 			// deferred raises, for OpenMP compatibility
@@ -5584,6 +6995,7 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestNeighborsOfPoint(EidosGlobal
 	
 	InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
 	SLiM_kdNode *kd_root_ALL = EnsureKDTreePresent_ALL(exerter_subpop, exerter_subpop_data);
+	SLiM_cellGrid *cell_grid_ALL = exerter_subpop_data.cell_grid_ALL_;
 	
 	// Check the point
 	if (point_value->Count() != spatiality_)
@@ -5613,7 +7025,7 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestNeighborsOfPoint(EidosGlobal
 	if (count < exerter_subpop_size)		// reserve only if we are finding fewer than every possible neighbor
 		result_vec->reserve((int)count);
 	
-	FindNeighbors(exerter_subpop, kd_root_ALL, exerter_subpop_data.kd_node_count_ALL_, point_array, (int)count, *result_vec, nullptr, /* constraints_active */ false);
+	FindNeighbors(exerter_subpop, kd_root_ALL, cell_grid_ALL, exerter_subpop_data.kd_node_count_ALL_, point_array, (int)count, *result_vec, nullptr, /* constraints_active */ false);
 	
 	return EidosValue_SP(result_vec);
 }
@@ -5645,6 +7057,7 @@ EidosValue_SP InteractionType::ExecuteMethod_neighborCount(EidosGlobalStringID p
 	
 	InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
 	SLiM_kdNode *kd_root_ALL = EnsureKDTreePresent_ALL(exerter_subpop, exerter_subpop_data);
+	SLiM_cellGrid *cell_grid_ALL = exerter_subpop_data.cell_grid_ALL_;
 	
 	// If there are no individuals in the tree, short-circuit
 	if (!kd_root_ALL)
@@ -5679,15 +7092,7 @@ EidosValue_SP InteractionType::ExecuteMethod_neighborCount(EidosGlobalStringID p
 		// Find the neighbors
 		double *receiver_position = receiver_subpop_data.positions_ + (size_t)receiver_index_in_subpop * SLIM_MAX_DIMENSIONALITY;
 		slim_popsize_t focal_individual_index = (exerter_subpop == receiver_subpop) ? receiver_index_in_subpop : -1;
-		int neighborCount;
-		
-		switch (spatiality_)
-		{
-			case 1: neighborCount = CountNeighbors_1(kd_root_ALL, receiver_position, focal_individual_index);			break;
-			case 2: neighborCount = CountNeighbors_2(kd_root_ALL, receiver_position, focal_individual_index, 0);		break;
-			case 3: neighborCount = CountNeighbors_3(kd_root_ALL, receiver_position, focal_individual_index, 0);		break;
-			default: neighborCount = 0; break;	// unsupported value
-		}
+		int neighborCount = CountNeighbors(kd_root_ALL, cell_grid_ALL, receiver_position, focal_individual_index);
 		
 		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(neighborCount));
 	}
@@ -5697,7 +7102,7 @@ EidosValue_SP InteractionType::ExecuteMethod_neighborCount(EidosGlobalStringID p
 		bool saw_error_1 = false, saw_error_2 = false;
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_NEIGHCOUNT);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_ALL) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) if(receivers_count >= EIDOS_OMPMIN_NEIGHCOUNT) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_ALL, cell_grid_ALL) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) if(receivers_count >= EIDOS_OMPMIN_NEIGHCOUNT) num_threads(thread_count)
 		for (int receiver_index = 0; receiver_index < receivers_count; ++receiver_index)
 		{
 			Individual *receiver = receivers_data[receiver_index];
@@ -5719,15 +7124,7 @@ EidosValue_SP InteractionType::ExecuteMethod_neighborCount(EidosGlobalStringID p
 			// Find the neighbors
 			double *receiver_position = receiver_subpop_data.positions_ + (size_t)receiver_index_in_subpop * SLIM_MAX_DIMENSIONALITY;
 			slim_popsize_t focal_individual_index = (exerter_subpop == receiver_subpop) ? receiver_index_in_subpop : -1;
-			int neighborCount;
-			
-			switch (spatiality_)
-			{
-				case 1: neighborCount = CountNeighbors_1(kd_root_ALL, receiver_position, focal_individual_index);			break;
-				case 2: neighborCount = CountNeighbors_2(kd_root_ALL, receiver_position, focal_individual_index, 0);		break;
-				case 3: neighborCount = CountNeighbors_3(kd_root_ALL, receiver_position, focal_individual_index, 0);		break;
-				default: neighborCount = 0; break;	// unsupported value
-			}
+			int neighborCount = CountNeighbors(kd_root_ALL, cell_grid_ALL, receiver_position, focal_individual_index);
 			
 			result_vec->set_int_no_check(neighborCount, receiver_index);
 		}
@@ -5761,6 +7158,7 @@ EidosValue_SP InteractionType::ExecuteMethod_neighborCountOfPoint(EidosGlobalStr
 	
 	InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
 	SLiM_kdNode *kd_root_ALL = EnsureKDTreePresent_ALL(exerter_subpop, exerter_subpop_data);
+	SLiM_cellGrid *cell_grid_ALL = exerter_subpop_data.cell_grid_ALL_;
 
 	if (!kd_root_ALL)
 		return gStaticEidosValue_Integer0;
@@ -5775,15 +7173,7 @@ EidosValue_SP InteractionType::ExecuteMethod_neighborCountOfPoint(EidosGlobalStr
 		point_array[point_index] = point_value->FloatAtIndex_NOCAST(point_index, nullptr);
 	
 	// Find the neighbors
-	int neighborCount;
-	
-	switch (spatiality_)
-	{
-		case 1: neighborCount = CountNeighbors_1(kd_root_ALL, point_array, -1);			break;
-		case 2: neighborCount = CountNeighbors_2(kd_root_ALL, point_array, -1, 0);		break;
-		case 3: neighborCount = CountNeighbors_3(kd_root_ALL, point_array, -1, 0);		break;
-		default: EIDOS_TERMINATION << "ERROR (InteractionType::ExecuteMethod_neighborCountOfPoint): (internal error) unsupported spatiality" << EidosTerminate();
-	}
+	int neighborCount = CountNeighbors(kd_root_ALL, cell_grid_ALL, point_array, -1);
 	
 	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(neighborCount));
 }
@@ -6014,6 +7404,9 @@ EidosValue_SP InteractionType::ExecuteMethod_setInteractionFunction(EidosGlobalS
 	// changing the interaction function invalidates the cached clipped_integral_ buffer; we don't deallocate it, just invalidate it
 	clipped_integral_valid_ = false;
 	
+	// it also invalidates any cached interaction strengths
+	FreeStrengthCaches();
+	
 	return gStaticEidosValueVOID;
 }
 
@@ -6075,6 +7468,7 @@ EidosValue_SP InteractionType::ExecuteMethod_strength(EidosGlobalStringID p_meth
 			// NULL means return distances from individuals1 (which must be singleton) to all individuals in the subpopulation
 			// We initialize the return vector to 0, and fill in non-zero values from the sparse vector
 			SLiM_kdNode *kd_root_EXERTERS = (spatiality_ ? EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data) : nullptr);
+			SLiM_cellGrid *cell_grid_EXERTERS = exerter_subpop_data.cell_grid_EXERTERS_;
 			
 			// If the k-d tree has no qualifying exerters, we return all zeros
 			if (!kd_root_EXERTERS)
@@ -6086,7 +7480,7 @@ EidosValue_SP InteractionType::ExecuteMethod_strength(EidosGlobalStringID p_meth
 			const sv_value_t *strengths;
 			
 			try {
-				FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, interaction_callbacks);
+				FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, cell_grid_EXERTERS, interaction_callbacks);
 				strengths = sv->Strengths(&nnz, &columns);
 				
 				EidosValue_Float *result_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(exerters_count);
@@ -6343,6 +7737,7 @@ EidosValue_SP InteractionType::ExecuteMethod_totalOfNeighborStrengths(EidosGloba
 	
 	InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
 	SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+	SLiM_cellGrid *cell_grid_EXERTERS = exerter_subpop_data.cell_grid_EXERTERS_;
 	
 	// If there are no exerters satisfying constraints, short-circuit
 	if (!kd_root_EXERTERS)
@@ -6382,7 +7777,7 @@ EidosValue_SP InteractionType::ExecuteMethod_totalOfNeighborStrengths(EidosGloba
 		SparseVector *sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kStrengths);
 		
 		try {
-			FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// singleton case, not parallel
+			FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, cell_grid_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// singleton case, not parallel
 		} catch (...) {
 			InteractionType::FreeSparseVector(sv);
 			throw;
@@ -6414,7 +7809,7 @@ EidosValue_SP InteractionType::ExecuteMethod_totalOfNeighborStrengths(EidosGloba
 		bool saw_error_1 = false, saw_error_2 = false, saw_error_3 = false, saw_error_4 = false;
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_TOTNEIGHSTRENGTH);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) reduction(||: saw_error_4) if(!has_interaction_callbacks && (receivers_count >= EIDOS_OMPMIN_TOTNEIGHSTRENGTH)) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS, cell_grid_EXERTERS) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) reduction(||: saw_error_4) if(!has_interaction_callbacks && (receivers_count >= EIDOS_OMPMIN_TOTNEIGHSTRENGTH)) num_threads(thread_count)
 		for (int receiver_index = 0; receiver_index < receivers_count; ++receiver_index)
 		{
 			Individual *receiver = receivers_data[receiver_index];
@@ -6451,7 +7846,7 @@ EidosValue_SP InteractionType::ExecuteMethod_totalOfNeighborStrengths(EidosGloba
 			
 			// Under OpenMP, raises can't go past the end of the parallel region; handle things the same way when not under OpenMP for simplicity
 			try {
-				FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// protected from running interaction() callbacks in parallel, above
+				FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, cell_grid_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// protected from running interaction() callbacks in parallel, above
 			} catch (...) {
 				saw_error_3 = true;
 				InteractionType::FreeSparseVector(sv);
@@ -6524,7 +7919,10 @@ const std::vector<EidosPropertySignature_CSP> *InteractionType_Class::Properties
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_reciprocal,		true,	kEidosValueMaskLogical | kEidosValueMaskSingleton)));
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_sexSegregation,	true,	kEidosValueMaskString | kEidosValueMaskSingleton)));
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_spatiality,		true,	kEidosValueMaskString | kEidosValueMaskSingleton)));
+		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_kdTreeRefit,	false,	kEidosValueMaskLogical | kEidosValueMaskSingleton)));
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_maxDistance,	false,	kEidosValueMaskFloat | kEidosValueMaskSingleton)));
+		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_spatialIndex,	false,	kEidosValueMaskString | kEidosValueMaskSingleton)));
+		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_strengthCache,	false,	kEidosValueMaskLogical | kEidosValueMaskSingleton)));
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_tag,			false,	kEidosValueMaskInt | kEidosValueMaskSingleton))->DeclareAcceleratedGet(InteractionType::GetProperty_Accelerated_tag));
 		
 		std::sort(properties->begin(), properties->end(), CompareEidosPropertySignatures);
@@ -6596,6 +7994,16 @@ _InteractionsData::_InteractionsData(_InteractionsData&& p_source) noexcept
 	kd_nodes_EXERTERS_ = p_source.kd_nodes_EXERTERS_;
 	kd_root_EXERTERS_ = p_source.kd_root_EXERTERS_;
 	kd_node_count_EXERTERS_ = p_source.kd_node_count_EXERTERS_;
+	cell_grid_ALL_ = p_source.cell_grid_ALL_;
+	cell_grid_EXERTERS_ = p_source.cell_grid_EXERTERS_;
+	kd_node_capacity_ALL_ = p_source.kd_node_capacity_ALL_;
+	kd_individuals_ALL_.swap(p_source.kd_individuals_ALL_);
+	refit_nodes_ = p_source.refit_nodes_;
+	refit_root_ = p_source.refit_root_;
+	refit_node_count_ = p_source.refit_node_count_;
+	refit_node_capacity_ = p_source.refit_node_capacity_;
+	refit_individuals_.swap(p_source.refit_individuals_);
+	strength_cache_ = p_source.strength_cache_;
 	
 	p_source.evaluated_ = false;
 	p_source.evaluation_interaction_callbacks_.resize(0);
@@ -6614,6 +8022,16 @@ _InteractionsData::_InteractionsData(_InteractionsData&& p_source) noexcept
 	p_source.kd_nodes_EXERTERS_ = nullptr;
 	p_source.kd_root_EXERTERS_ = nullptr;
 	p_source.kd_node_count_EXERTERS_ = 0;
+	p_source.cell_grid_ALL_ = nullptr;
+	p_source.cell_grid_EXERTERS_ = nullptr;
+	p_source.kd_node_capacity_ALL_ = 0;
+	p_source.kd_individuals_ALL_.clear();
+	p_source.refit_nodes_ = nullptr;
+	p_source.refit_root_ = nullptr;
+	p_source.refit_node_count_ = 0;
+	p_source.refit_node_capacity_ = 0;
+	p_source.refit_individuals_.clear();
+	p_source.strength_cache_ = nullptr;
 }
 
 _InteractionsData& _InteractionsData::operator=(_InteractionsData&& p_source) noexcept
@@ -6631,6 +8049,10 @@ _InteractionsData& _InteractionsData::operator=(_InteractionsData&& p_source) no
 		if (kd_nodes_EXERTERS_)
 			free(kd_nodes_EXERTERS_);
 		
+		FreeCellGrids();
+		FreeRefitTree();
+		FreeStrengthCache();
+		
 		evaluated_ = p_source.evaluated_;
 		evaluation_interaction_callbacks_.swap(p_source.evaluation_interaction_callbacks_);
 		individual_count_ = p_source.individual_count_;
@@ -6648,6 +8070,16 @@ _InteractionsData& _InteractionsData::operator=(_InteractionsData&& p_source) no
 		kd_nodes_EXERTERS_ = p_source.kd_nodes_EXERTERS_;
 		kd_root_EXERTERS_ = p_source.kd_root_EXERTERS_;
 		kd_node_count_EXERTERS_ = p_source.kd_node_count_EXERTERS_;
+		cell_grid_ALL_ = p_source.cell_grid_ALL_;
+		cell_grid_EXERTERS_ = p_source.cell_grid_EXERTERS_;
+		kd_node_capacity_ALL_ = p_source.kd_node_capacity_ALL_;
+		kd_individuals_ALL_.swap(p_source.kd_individuals_ALL_);
+		refit_nodes_ = p_source.refit_nodes_;
+		refit_root_ = p_source.refit_root_;
+		refit_node_count_ = p_source.refit_node_count_;
+		refit_node_capacity_ = p_source.refit_node_capacity_;
+		refit_individuals_.swap(p_source.refit_individuals_);
+		strength_cache_ = p_source.strength_cache_;
 		
 		p_source.evaluated_ = false;
 		p_source.evaluation_interaction_callbacks_.resize(0);
@@ -6666,6 +8098,16 @@ _InteractionsData& _InteractionsData::operator=(_InteractionsData&& p_source) no
 		p_source.kd_nodes_EXERTERS_ = nullptr;
 		p_source.kd_root_EXERTERS_ = nullptr;
 		p_source.kd_node_count_EXERTERS_ = 0;
+		p_source.cell_grid_ALL_ = nullptr;
+		p_source.cell_grid_EXERTERS_ = nullptr;
+		p_source.kd_node_capacity_ALL_ = 0;
+		p_source.kd_individuals_ALL_.clear();
+		p_source.refit_nodes_ = nullptr;
+		p_source.refit_root_ = nullptr;
+		p_source.refit_node_count_ = 0;
+		p_source.refit_node_capacity_ = 0;
+		p_source.refit_individuals_.clear();
+		p_source.strength_cache_ = nullptr;
 	}
 	
 	return *this;
@@ -6709,10 +8151,47 @@ _InteractionsData::~_InteractionsData(void)
 	kd_root_EXERTERS_ = nullptr;
 	kd_node_count_EXERTERS_ = 0;
 	
+	FreeCellGrids();
+	FreeRefitTree();
+	FreeStrengthCache();
+	
 	// Unnecessary since it's about to be destroyed anyway
 	//evaluation_interaction_callbacks_.resize(0);
 }
 
+void _InteractionsData::FreeCellGrids(void)
+{
+	// keep in mind that the two cell grids may be shared, like the k-d tree nodes they index
+	if (cell_grid_ALL_ == cell_grid_EXERTERS_)
+		cell_grid_EXERTERS_ = nullptr;
+	
+	delete cell_grid_ALL_;
+	cell_grid_ALL_ = nullptr;
+	
+	delete cell_grid_EXERTERS_;
+	cell_grid_EXERTERS_ = nullptr;
+}
+
+void _InteractionsData::FreeRefitTree(void)
+{
+	if (refit_nodes_)
+	{
+		free(refit_nodes_);
+		refit_nodes_ = nullptr;
+	}
+	
+	refit_root_ = nullptr;
+	refit_node_count_ = 0;
+	refit_node_capacity_ = 0;
+	refit_individuals_.clear();
+}
+
+void _InteractionsData::FreeStrengthCache(void)
+{
+	delete strength_cache_;
+	strength_cache_ = nullptr;
+}
+
 
 
 
@@ -62,11 +62,57 @@ struct _SLiM_kdNode
 {
 	double x[SLIM_MAX_DIMENSIONALITY];		// the coordinates of the individual
 	slim_popsize_t individual_index_;		// the index of the individual in its subpopulation, and into positions_
+	float slack_;							// how far the subtrees may cross this node's split (0 unless refitted); see RefitKDTree()
 	struct _SLiM_kdNode *left;				// the index of the KDNode for the left side
 	struct _SLiM_kdNode *right;				// the index of the KDNode for the right side
 };
 typedef struct _SLiM_kdNode SLiM_kdNode;
 
+// As an alternative to the k-d tree, exerters can be indexed with a uniform grid of cells (a "cell list"), with a cell size of at
+// least max_distance_, so that all neighbors of a point lie in the 3^D block of cells around it.  The grid is built with a counting
+// sort in O(N) time: the k-d node buffer is reordered so that the nodes in each cell are contiguous, and cell_starts_ gives the start
+// of each cell's run of nodes (with a final entry equal to the node count).  Cells are indexed row-major, x varying fastest; unused
+// dimensions have a cell count of 1.  The left/right pointers of the nodes are unused when they are organized as a grid.
+struct _SLiM_cellGrid
+{
+	double origin_[SLIM_MAX_DIMENSIONALITY];		// the minimum coordinate of the nodes in each dimension
+	double inverse_cell_size_;						// 1.0 / the cell size, which is the same in all dimensions
+	int64_t cell_count_[SLIM_MAX_DIMENSIONALITY];	// the number of cells in each dimension; 1 for unused dimensions
+	std::vector<uint32_t> cell_starts_;				// the index of the first node in each cell, plus a final entry for the end
+};
+typedef struct _SLiM_cellGrid SLiM_cellGrid;
+
+// This determines the spatial index used for exerters; see the spatialIndex property of InteractionType
+enum class SpatialIndexType : char {
+	kKDTree = 0,		// always use a k-d tree; the default
+	kCellGrid,			// use a uniform cell grid whenever maxDistance is finite
+	kAuto				// use a uniform cell grid when the density of exerters suggests it will be faster
+};
+
+// If the strength cache is enabled (see the strengthCache property of InteractionType), the interaction strengths computed for each
+// receiver are kept across evaluations in a row like this, and reused for as long as nothing within max_distance_ of the receiver
+// moves, dies, or is born.  The exerters are kept as indices in the subpopulation, which are remapped at each evaluation as
+// individuals die; an exerter in a valid row cannot have died, since its death would have invalidated the row.  See
+// PrepareStrengthCache().
+struct _SLiM_strengthCacheRow
+{
+	Individual *receiver_ = nullptr;				// the receiver the row was computed for, or nullptr if the row is empty
+	slim_pedigreeid_t receiver_pedigree_id_ = 0;	// the receiver's pedigree ID when the row was computed
+	double position_[SLIM_MAX_DIMENSIONALITY];		// the receiver's position when the row was computed
+	std::vector<uint32_t> columns_;					// the indices of the exerters with which the receiver interacts, in the order found
+	std::vector<sv_value_t> strengths_;				// the interaction strengths corresponding to columns_
+};
+typedef struct _SLiM_strengthCacheRow SLiM_strengthCacheRow;
+
+struct _SLiM_strengthCache
+{
+	std::vector<SLiM_strengthCacheRow> rows_;		// cached rows, indexed by receiver index in the subpopulation as of the last evaluation
+	std::vector<SLiM_strengthCacheRow> spare_rows_;	// unused rows, kept so that their buffers can be reused
+	std::vector<Individual *> individuals_;			// the subpopulation's individuals as of the last evaluation
+	std::vector<double> positions_;					// their positions, SLIM_MAX_DIMENSIONALITY entries per individual
+};
+typedef struct _SLiM_strengthCache SLiM_strengthCache;
+
 struct _InteractionsData
 {
 	// This flag is true when the interaction has been evaluated.  What that means in practice is that allocated blocks below
@@ -119,6 +165,30 @@ struct _InteractionsData
 	slim_popsize_t kd_node_count_EXERTERS_ = 0;		// the number of entries in the k-d tree; may be greater than individual_count_ due to periodicity
 	bool kd_constraints_raise_EXERTERS_ = false;	// an exerter tree cannot be constructed due to constraints; see EvaluateSubpopulation() for discussion
 	
+	// If a k-d tree was built as a uniform cell grid instead (see SpatialIndexType), these point to the grid for it, otherwise nullptr.
+	// In that case the kd_root_ pointer points to the first node of the (cell-sorted) node buffer, and is non-nullptr as usual.  As with
+	// the nodes themselves, the EXERTERS grid will be the same as the ALL grid if no exerter constraints are present.
+	SLiM_cellGrid *cell_grid_ALL_ = nullptr;
+	SLiM_cellGrid *cell_grid_EXERTERS_ = nullptr;
+	
+	// If k-d tree refitting is enabled (see the kdTreeRefit property of InteractionType), a built ALL tree is retained when the data
+	// is invalidated, rather than being freed, so that the next evaluation can refit it to the new positions instead of rebuilding it;
+	// see RefitKDTree().  After a refit, kd_nodes_ALL_ may contain unused nodes (with an individual_index_ of -1), so the number of
+	// nodes allocated is tracked separately.  kd_individuals_ALL_ records the individuals that the individual_index_ values of the
+	// nodes referred to when the tree was built, so that the nodes can be matched up with those individuals again after they move.
+	slim_popsize_t kd_node_capacity_ALL_ = 0;			// the number of nodes allocated in kd_nodes_ALL_, when refitting is enabled
+	std::vector<Individual *> kd_individuals_ALL_;		// the subpopulation's individuals when kd_nodes_ALL_ was built or refitted
+	
+	SLiM_kdNode *refit_nodes_ = nullptr;				// OWNED POINTER: the retained ALL tree's nodes, or nullptr
+	SLiM_kdNode *refit_root_ = nullptr;					// the root of the retained tree
+	slim_popsize_t refit_node_count_ = 0;				// the number of nodes in the retained tree
+	slim_popsize_t refit_node_capacity_ = 0;			// the number of nodes allocated in refit_nodes_
+	std::vector<Individual *> refit_individuals_;		// kd_individuals_ALL_ for the retained tree
+	
+	// If the strength cache is enabled, this holds the cached strength rows for receivers in this subpopulation, with exerters in
+	// this subpopulation; it is kept across evaluations, and brought up to date by PrepareStrengthCache() at each evaluation.
+	SLiM_strengthCache *strength_cache_ = nullptr;		// OWNED POINTER: the strength cache, or nullptr
+	
 	_InteractionsData(const _InteractionsData&) = delete;					// no copying
 	_InteractionsData& operator=(const _InteractionsData&) = delete;		// no copying
 	_InteractionsData(_InteractionsData&&) noexcept;						// move constructor, for std::map compatibility
@@ -127,6 +197,10 @@ struct _InteractionsData
 	
 	_InteractionsData(slim_popsize_t p_individual_count, slim_popsize_t p_first_male_index);
 	~_InteractionsData(void);
+	
+	void FreeCellGrids(void);		// frees the cell grids (if any), keeping in mind that they may be shared
+	void FreeRefitTree(void);		// frees the retained k-d tree (if any) that was kept for refitting
+	void FreeStrengthCache(void);	// frees the strength cache (if any)
 };
 typedef struct _InteractionsData InteractionsData;
 
@@ -177,6 +251,9 @@ private:
 	bool reciprocal_;							// if true, interaction strengths A->B == B->A; NOW UNUSED
 	double max_distance_;						// the maximum distance, beyond which interaction strength is assumed to be zero
 	double max_distance_sq_;					// the maximum distance squared, cached for speed
+	SpatialIndexType spatial_index_type_ = SpatialIndexType::kKDTree;	// the type of spatial index to build for exerters
+	bool kd_tree_refit_ = false;				// if true, ALL k-d trees are refitted across evaluations when possible; see RefitKDTree()
+	bool strength_cache_enabled_ = false;		// if true, receiver strength rows are cached across evaluations; see PrepareStrengthCache()
 	
 	InteractionConstraints receiver_constraints_;	// constraints on who can be a receiver
 	InteractionConstraints exerter_constraints_;	// constraints on who can be an exerter
@@ -232,6 +309,21 @@ private:
 	SLiM_kdNode *MakeKDTree3_p0(SLiM_kdNode *t, int len);
 	SLiM_kdNode *MakeKDTree3_p1(SLiM_kdNode *t, int len);
 	SLiM_kdNode *MakeKDTree3_p2(SLiM_kdNode *t, int len);
+	void RetainKDTreeForRefit(InteractionsData &p_data);
+	bool RefitKDTree(Subpopulation *subpop, InteractionsData &p_subpop_data);
+	SLiM_kdNode *RefitKDTree_RemoveDead(SLiM_kdNode *p_node, std::vector<SLiM_kdNode *> &p_free_nodes);
+	double RefitKDTree_Bounds(SLiM_kdNode *p_node, int p_phase, double *p_min, double *p_max);
+#if DEBUG
+	int CheckRefitKDTree(SLiM_kdNode *p_node, int p_phase, double *p_min, double *p_max);
+#endif
+	void PrepareStrengthCache(Subpopulation *p_subpop, InteractionsData &p_subpop_data);
+	void FreeStrengthCaches(void);
+#ifdef _OPENMP
+	SLiM_kdNode *MakeKDTree_Serial(SLiM_kdNode *t, int len, int p_phase);
+	SLiM_kdNode *MakeKDTree_Tasks(SLiM_kdNode *t, int len, int p_phase, int p_fallthrough);
+	void FindMedian_Collective(SLiM_kdNode *start, int len, int p_phase, SLiM_kdNode *scratch, int64_t *chunk_counts);
+	SLiM_kdNode *MakeKDTree_Parallel(SLiM_kdNode *t, int len);
+#endif
 	
 	// Setting up the k-d trees now proceeds in several steps.  CacheKDTreeNodes() allocates the k-d tree buffers and copies positions and indices in, but does not
 	// set up the left/right pointers -- it doesn't actually make the tree.  It is called at evaluate() time to set up the EXERTERS tree if exerter constraints
@@ -241,7 +333,8 @@ private:
 	// triggers caching and building of the tree as needed.  They return a pointer to the tree root, which is all that is needed to use the tree for queries.
 	// BEWARE!  Note that the EnsureKDTreePresent_X() methods will return nullptr if the requested tree contains zero nodes!  This needs to be checked!
 	void CacheKDTreeNodes(Subpopulation *subpop, InteractionsData &p_subpop_data, bool p_apply_exerter_constraints, SLiM_kdNode **kd_nodes_ptr, SLiM_kdNode **kd_root_ptr, slim_popsize_t *kd_node_count_ptr);
-	void BuildKDTree(InteractionsData &p_subpop_data, SLiM_kdNode **kd_nodes_ptr, SLiM_kdNode **kd_root_ptr, slim_popsize_t *kd_node_count_ptr);
+	void BuildKDTree(InteractionsData &p_subpop_data, SLiM_kdNode **kd_nodes_ptr, SLiM_kdNode **kd_root_ptr, slim_popsize_t *kd_node_count_ptr, SLiM_cellGrid **cell_grid_ptr);
+	SLiM_cellGrid *BuildCellGrid(SLiM_kdNode **kd_nodes_ptr, slim_popsize_t kd_node_count);
 	SLiM_kdNode *EnsureKDTreePresent_ALL(Subpopulation *subpop, InteractionsData &p_subpop_data);
 	SLiM_kdNode *EnsureKDTreePresent_EXERTERS(Subpopulation *subpop, InteractionsData &p_subpop_data);
 	
@@ -273,6 +366,14 @@ private:
 	void BuildSV_Strengths_c_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase);
 	void BuildSV_Strengths_t_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase);
 	
+	template <typename F> void ForEachCellGridNeighbor(SLiM_cellGrid *p_grid, SLiM_kdNode *p_nodes, double *nd, F p_function);
+	void BuildSV_Presences_Grid(SLiM_cellGrid *p_grid, SLiM_kdNode *p_nodes, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector);
+	void BuildSV_Distances_Grid(SLiM_cellGrid *p_grid, SLiM_kdNode *p_nodes, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector);
+	int CountNeighbors_Grid(SLiM_cellGrid *p_grid, SLiM_kdNode *p_nodes, double *nd, slim_popsize_t p_focal_individual_index);
+	void FindNeighbors1_Grid(SLiM_cellGrid *p_grid, SLiM_kdNode *p_nodes, double *nd, slim_popsize_t p_focal_individual_index, SLiM_kdNode **best, double *best_dist);
+	void FindNeighborsA_Grid(SLiM_cellGrid *p_grid, SLiM_kdNode *p_nodes, double *nd, slim_popsize_t p_focal_individual_index, EidosValue_Object &p_result_vec, std::vector<Individual *> &p_individuals);
+	
+	int CountNeighbors(SLiM_kdNode *kd_root, SLiM_cellGrid *cell_grid, double *nd, slim_popsize_t p_focal_individual_index);
 	int CountNeighbors_1(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index);
 	int CountNeighbors_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, int p_phase);
 	int CountNeighbors_3(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, int p_phase);
@@ -286,7 +387,7 @@ private:
 	void FindNeighborsN_1(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, int p_count, SLiM_kdNode **best, double *best_dist);
 	void FindNeighborsN_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, int p_count, SLiM_kdNode **best, double *best_dist, int p_phase);
 	void FindNeighborsN_3(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, int p_count, SLiM_kdNode **best, double *best_dist, int p_phase);
-	void FindNeighbors(Subpopulation *p_subpop, SLiM_kdNode *kd_root, slim_popsize_t kd_node_count, double *p_point, int p_count, EidosValue_Object &p_result_vec, Individual *p_excluded_individual, bool constraints_active);
+	void FindNeighbors(Subpopulation *p_subpop, SLiM_kdNode *kd_root, SLiM_cellGrid *cell_grid, slim_popsize_t kd_node_count, double *p_point, int p_count, EidosValue_Object &p_result_vec, Individual *p_excluded_individual, bool constraints_active);
 	
 	// this is a malloced 1D/2D/3D buffer, depending on our spatiality, that contains clipped integral values
 	// for distances, for a focal individual, from 0 to max_distance_ to the nearest edge in each dimension
@@ -366,10 +467,10 @@ private:
 #endif
 	}
 	
-	void FillSparseVectorForReceiverPresences(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, bool constraints_active);
-	void FillSparseVectorForReceiverDistances(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, bool constraints_active);
-	void FillSparseVectorForPointDistances(SparseVector *sv, double *position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root);
-	void FillSparseVectorForReceiverStrengths(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, std::vector<SLiMEidosBlock*> &interaction_callbacks);
+	void FillSparseVectorForReceiverPresences(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, SLiM_cellGrid *cell_grid, bool constraints_active);
+	void FillSparseVectorForReceiverDistances(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, SLiM_cellGrid *cell_grid, bool constraints_active);
+	void FillSparseVectorForPointDistances(SparseVector *sv, double *position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, SLiM_cellGrid *cell_grid);
+	void FillSparseVectorForReceiverStrengths(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, SLiM_cellGrid *cell_grid, std::vector<SLiMEidosBlock*> &interaction_callbacks);
 	
 public:
 	
@@ -378,6 +479,12 @@ public:
 	slim_objectid_t interaction_type_id_;		// the id by which this interaction type is indexed in the chromosome
 	EidosValue_SP cached_value_inttype_id_;		// a cached value for interaction_type_id_; reset() if that changes
 	
+#if (SLIMPROFILING == 1)
+	// PROFILING : InteractionType keeps track of how often its strength cache (if enabled) is hit
+	int64_t profile_strength_cache_hits_ = 0;		// receiver strength rows reused from the strength cache
+	int64_t profile_strength_cache_misses_ = 0;		// receiver strength rows computed and added to the strength cache
+#endif	// (SLIMPROFILING == 1)
+	
 	
 	InteractionType(const InteractionType&) = delete;					// no copying
 	InteractionType& operator=(const InteractionType&) = delete;		// no copying
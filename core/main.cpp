@@ -49,6 +49,7 @@
 #include "eidos_symbol_table.h"
 #include "interaction_type.h"
 #include "eidos_rng.h"
+#include "eidos_bytecode.h"
 
 // Get our Git commit SHA-1, as C string "g_GIT_SHA1"
 #include "../cmake/GitSHA1.h"
@@ -108,11 +109,11 @@ static void PrintUsageAndDie(bool p_print_header, bool p_print_full_usage)
 	
 	SLIM_OUTSTREAM << "usage: slim -v[ersion] | -u[sage] | -h[elp] | -testEidos | -testSLiM |" << std::endl;
 	SLIM_OUTSTREAM << "   [-l[ong] [<l>]] [-s[eed] <seed>] [-t[ime]] [-m[em]] [-M[emhist]] [-x]" << std::endl;
-	SLIM_OUTSTREAM << "   [-d[efine] <def>] [-c[heck]] [-p[rogress]] ";
+	SLIM_OUTSTREAM << "   [-d[efine] <def>] [-c[heck]] [-p[rogress]] [-noBytecode] ";
 #ifdef _OPENMP
 	// Some flags are visible only for a parallel build
 	// FIXME: these might not fit on the same line as other things
-	SLIM_OUTSTREAM << "[-maxThreads <n>] [-perTaskThreads \"x\"] ";
+	SLIM_OUTSTREAM << "[-maxThreads <n>] [-perTaskThreads \"x\"] [-numa] [-threadProfile <path>] [-tuneThreads <path>] ";
 #endif
 #if (SLIMPROFILING == 1)
 	// Some flags are visible only for a profile build
@@ -136,12 +137,16 @@ static void PrintUsageAndDie(bool p_print_header, bool p_print_full_usage)
 		SLIM_OUTSTREAM << "   -M[emhist]         : print a histogram of SLiM's memory usage" << std::endl;
 		SLIM_OUTSTREAM << "   -p[rogress]        : show a progress bar in the terminal as SLiM runs" << std::endl;
 		SLIM_OUTSTREAM << "   -x                 : disable SLiM's runtime safety/consistency checks" << std::endl;
+		SLIM_OUTSTREAM << "   -noBytecode        : disable compilation of simple Eidos blocks to bytecode" << std::endl;
 		SLIM_OUTSTREAM << "   -d[efine] <def>    : define an Eidos constant, such as \"mu=1e-7\"" << std::endl;
 		SLIM_OUTSTREAM << "   -c[heck]           : check the input script's syntax, without executing it" << std::endl;
 #ifdef _OPENMP
 		// Some flags are visible only for a parallel build
 		SLIM_OUTSTREAM << "   -maxThreads <n>    : set the maximum number of threads used" << std::endl;
 		SLIM_OUTSTREAM << "   -perTaskThreads \"x\": set per-task thread counts to named set \"x\"" << std::endl;
+		SLIM_OUTSTREAM << "   -numa              : pin threads to cores, spread across NUMA nodes" << std::endl;
+		SLIM_OUTSTREAM << "   -threadProfile <path>: load task size thresholds for multithreading from <path>" << std::endl;
+		SLIM_OUTSTREAM << "   -tuneThreads <path>: benchmark task size thresholds for this machine, write them to <path>" << std::endl;
 #endif
 #if (SLIMPROFILING == 1)
 		SLIM_OUTSTREAM << "   " << std::endl;
@@ -200,6 +205,7 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 	long max_thread_count = omp_get_max_threads();
 	bool changed_max_thread_count = false;
 	std::string per_task_thread_count_set_name = "";		// default per-task thread counts
+	std::string thread_profile_path = "";					// no task size threshold profile; use the compiled-in thresholds
 #endif
 	
 #if (SLIMPROFILING == 1)
@@ -339,6 +345,14 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 			continue;
 		}
 		
+		// -noBytecode: execute all Eidos code by walking its AST, without compiling to bytecode; useful for comparison
+		if (strcmp(arg, "-noBytecode") == 0)
+		{
+			gEidosBytecodeEnabled = false;
+			
+			continue;
+		}
+		
 		// -version or -v: print version information
 		if (strcmp(arg, "--version") == 0 || strcmp(arg, "-version") == 0 || strcmp(arg, "-v") == 0)
 		{
@@ -456,6 +470,54 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 			continue;
 		}
 		
+		// -numa: pin threads to cores, spread across NUMA nodes, and schedule loops over individuals so that each thread keeps
+		// the same individuals; see Eidos_PinOpenMPThreadsToNUMANodes().  This must precede -testEidos, -testSLiM, and -tuneThreads.
+		if (strcmp(arg, "-numa") == 0)
+		{
+#ifdef _OPENMP
+			// This command-line argument is ignored completely when not parallel
+			gEidosNUMAAware = true;
+#endif
+			
+			continue;
+		}
+		
+		// -threadProfile <path>: load task size thresholds for OpenMP from a profile written by -tuneThreads
+		if (strcmp(arg, "-threadProfile") == 0)
+		{
+			if (++arg_index == argc)
+				PrintUsageAndDie(false, true);
+			
+#ifdef _OPENMP
+			// The profile is loaded after OpenMP warmup, below
+			// This command-line argument is ignored completely when not parallel
+			thread_profile_path = std::string(argv[arg_index]);
+#endif
+			
+			continue;
+		}
+		
+		// -tuneThreads <path>: benchmark the parallel Eidos functions to choose task size thresholds for this machine, write them
+		// to a profile at <path> for use with -threadProfile, and quit; -maxThreads and -perTaskThreads should be given before it
+		if (strcmp(arg, "-tuneThreads") == 0)
+		{
+			if (++arg_index == argc)
+				PrintUsageAndDie(false, true);
+			
+#ifdef _OPENMP
+			Eidos_WarmUpOpenMP(&SLIM_ERRSTREAM, changed_max_thread_count, (int)max_thread_count, true, per_task_thread_count_set_name);
+			Eidos_WarmUp();
+			
+			Eidos_TuneOpenMPThresholds(std::string(argv[arg_index]), SLIM_OUTSTREAM);
+			
+			Eidos_FlushFiles();
+			exit(EXIT_SUCCESS);
+#else
+			SLIM_OUTSTREAM << "The -tuneThreads command-line option is only available in a PARALLEL build." << std::endl;
+			exit(EXIT_FAILURE);
+#endif
+		}
+		
 #if (SLIMPROFILING == 1)
 		if (strcmp(arg, "-profileStart") == 0)
 		{
@@ -559,6 +621,9 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 	
 #ifdef _OPENMP
 	Eidos_WarmUpOpenMP((SLiM_verbosity_level >= 1) ? &SLIM_ERRSTREAM : nullptr, changed_max_thread_count, (int)max_thread_count, true, per_task_thread_count_set_name);
+	
+	if (thread_profile_path.length())
+		Eidos_LoadOpenMPThresholdProfile(thread_profile_path, (SLiM_verbosity_level >= 1) ? &SLIM_ERRSTREAM : nullptr);
 #endif
 	
 	if (SLiM_verbosity_level >= 2)
@@ -29,6 +29,13 @@
 #include <cstdint>
 #include <csignal>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 
 // All Mutation objects get allocated out of a single shared block, for speed; see SLiM_WarmUp()
 // Note this is shared by all species; the mutations for every species come out of the same shared block.
@@ -43,20 +50,95 @@ EidosDebugLock gSLiM_Mutation_LOCK("gSLiM_Mutation_LOCK");
 
 slim_refcount_t *gSLiM_Mutation_Refcounts = nullptr;
 
+// The number of mutations for which address space has been reserved; gSLiM_Mutation_Block_Capacity can grow up to this
+static size_t gSLiM_Mutation_Block_ReservedCapacity = 0;
+
 #define SLIM_MUTATION_BLOCK_INITIAL_SIZE	16384		// makes for about a 1 MB block; not unreasonable		// NOLINT(*-macro-to-enum) : this is fine
+#define SLIM_MUTATION_BLOCK_MAXIMUM_SIZE	0x0000000080000000UL	// 2^31, the limit of MutationIndex		// NOLINT(*-macro-to-enum) : this is fine
+
+// Reserve a range of address space without backing it with memory; returns nullptr on failure
+static void *SLiM_ReserveAddressSpace(size_t p_bytes)
+{
+#ifdef _WIN32
+	return VirtualAlloc(nullptr, p_bytes, MEM_RESERVE, PAGE_NOACCESS);
+#else
+	void *result = mmap(nullptr, p_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	
+	return (result == MAP_FAILED) ? nullptr : result;
+#endif
+}
 
-extern std::vector<EidosValue_Object *> gEidosValue_Object_Mutation_Registry;	// this is in Eidos; see SLiM_IncreaseMutationBlockCapacity()
+static void SLiM_ReleaseAddressSpace(void *p_address, size_t p_bytes)
+{
+#ifdef _WIN32
+	(void)p_bytes;
+	VirtualFree(p_address, 0, MEM_RELEASE);
+#else
+	munmap(p_address, p_bytes);
+#endif
+}
+
+// Make the first p_bytes of a reserved range usable; the range may already be partly committed; returns false on failure
+static bool SLiM_CommitAddressSpace(void *p_address, size_t p_bytes)
+{
+#ifdef _WIN32
+	return (VirtualAlloc(p_address, p_bytes, MEM_COMMIT, PAGE_READWRITE) != nullptr);
+#else
+	static const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+	size_t rounded_bytes = ((p_bytes + page_size - 1) / page_size) * page_size;
+	
+	return (mprotect(p_address, rounded_bytes, PROT_READ | PROT_WRITE) == 0);
+#endif
+}
 
 void SLiM_CreateMutationBlock(void)
 {
 	THREAD_SAFETY_IN_ANY_PARALLEL("SLiM_CreateMutationBlock(): gSLiM_Mutation_Block address change");
 	
-	// first allocate the block; no need to zero the memory
+	// We reserve address space for the largest block we could ever need up front, and then commit it
+	// piece by piece as the block grows; see SLiM_IncreaseMutationBlockCapacity().  Reserving address
+	// space costs no memory, so this is cheap on 64-bit platforms.  If it fails, it is presumably due
+	// to a virtual memory limit (ulimit -v); we then halve the request until it succeeds, and use a
+	// quarter of that, to leave address space for the rest of SLiM's allocations.
+	size_t reserved_capacity = SLIM_MUTATION_BLOCK_MAXIMUM_SIZE;
+	bool reservation_was_limited = false;
+	
+	while (true)
+	{
+		gSLiM_Mutation_Block = (Mutation *)SLiM_ReserveAddressSpace(reserved_capacity * sizeof(Mutation));
+		gSLiM_Mutation_Refcounts = (slim_refcount_t *)SLiM_ReserveAddressSpace(reserved_capacity * sizeof(slim_refcount_t));
+		
+		if (gSLiM_Mutation_Block && gSLiM_Mutation_Refcounts)
+		{
+			if (!reservation_was_limited || (reserved_capacity <= SLIM_MUTATION_BLOCK_INITIAL_SIZE * 4))
+				break;
+			
+			SLiM_ReleaseAddressSpace(gSLiM_Mutation_Block, reserved_capacity * sizeof(Mutation));
+			SLiM_ReleaseAddressSpace(gSLiM_Mutation_Refcounts, reserved_capacity * sizeof(slim_refcount_t));
+			reserved_capacity /= 4;
+			reservation_was_limited = false;
+			continue;
+		}
+		
+		if (gSLiM_Mutation_Block)
+			SLiM_ReleaseAddressSpace(gSLiM_Mutation_Block, reserved_capacity * sizeof(Mutation));
+		if (gSLiM_Mutation_Refcounts)
+			SLiM_ReleaseAddressSpace(gSLiM_Mutation_Refcounts, reserved_capacity * sizeof(slim_refcount_t));
+		
+		if (reserved_capacity <= SLIM_MUTATION_BLOCK_INITIAL_SIZE)
+			EIDOS_TERMINATION << "ERROR (SLiM_CreateMutationBlock): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+		
+		reserved_capacity /= 2;
+		reservation_was_limited = true;
+	}
+	
+	gSLiM_Mutation_Block_ReservedCapacity = reserved_capacity;
+	
+	// then commit the initial block; no need to zero the memory
 	gSLiM_Mutation_Block_Capacity = SLIM_MUTATION_BLOCK_INITIAL_SIZE;
-	gSLiM_Mutation_Block = (Mutation *)malloc(gSLiM_Mutation_Block_Capacity * sizeof(Mutation));
-	gSLiM_Mutation_Refcounts = (slim_refcount_t *)malloc(gSLiM_Mutation_Block_Capacity * sizeof(slim_refcount_t));
 	
-	if (!gSLiM_Mutation_Block || !gSLiM_Mutation_Refcounts)
+	if (!SLiM_CommitAddressSpace(gSLiM_Mutation_Block, gSLiM_Mutation_Block_Capacity * sizeof(Mutation)) ||
+		!SLiM_CommitAddressSpace(gSLiM_Mutation_Refcounts, gSLiM_Mutation_Block_Capacity * sizeof(slim_refcount_t)))
 		EIDOS_TERMINATION << "ERROR (SLiM_CreateMutationBlock): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
 	
 	//std::cout << "Allocating initial mutation block, " << SLIM_MUTATION_BLOCK_INITIAL_SIZE * sizeof(Mutation) << " bytes (sizeof(Mutation) == " << sizeof(Mutation) << ")" << std::endl;
@@ -73,17 +155,11 @@ void SLiM_CreateMutationBlock(void)
 
 void SLiM_IncreaseMutationBlockCapacity(void)
 {
-	// We do not use a THREAD_SAFETY macro here because this needs to be checked in release builds also;
-	// we are not able to completely protect against this occurring at runtime, and it corrupts the run.
-	// It's OK for this to be called when we're inside an inactive parallel region; there is then no
-	// race condition.  When a parallel region is active, even inside a critical region, reallocating
-	// the mutation block has the potential for a race with other threads.
-	if (omp_in_parallel())
-	{
-		std::cerr << "ERROR (SLiM_IncreaseMutationBlockCapacity): (internal error) SLiM_IncreaseMutationBlockCapacity() was called to reallocate gSLiM_Mutation_Block inside a parallel section.  If you see this message, you need to increase the pre-allocation margin for your simulation, because it is generating such an unexpectedly large number of new mutations.  Please contact the SLiM developers for guidance on how to do this." << std::endl;
-		raise(SIGTRAP);
-	}
-	
+	// This can be called from inside an active parallel region, such as parallel offspring generation,
+	// provided the caller holds the lock that protects allocation from the block (MutationAlloc).  Other
+	// threads may be reading existing mutations at the same time; that is safe because growth commits
+	// new pages after the end of the existing block, and never moves anything.  Every Mutation * in the
+	// program therefore remains valid across this call, including those held by EidosValue_Object.
 #ifdef DEBUG_LOCKS_ENABLED
 	gSLiM_Mutation_LOCK.start_critical(1);
 #endif
@@ -91,23 +167,8 @@ void SLiM_IncreaseMutationBlockCapacity(void)
 	if (!gSLiM_Mutation_Block)
 		EIDOS_TERMINATION << "ERROR (SLiM_IncreaseMutationBlockCapacity): (internal error) called before SLiM_CreateMutationBlock()." << EidosTerminate();
 	
-	// We need to expand the size of our Mutation block.  This has the consequence of invalidating
-	// every Mutation * in the program.  In general that is fine; we are careful to only keep
-	// pointers to Mutation temporarily, and for long-term reference we use MutationIndex.  The
-	// exception to this is EidosValue_Object; the user can put references to mutations into
-	// variables that need to remain valid across reallocs like this.  We therefore have to hunt
-	// down every EidosValue_Object that contains Mutations, and fix the pointer inside each of
-	// them.  Because in SLiMgui all of the running simulations share a single Mutation block at
-	// the moment, in SLiMgui this patching has to occur across all of the simulations, not just
-	// the one that made this call.  Yes, this is very gross.  This is why pointers are evil.  :->
-	
-	// First let's do our realloc.  We just need to note the change in value for the pointer.
 	// For now we will just double in size; we don't want to waste too much memory, but we
-	// don't want to have to realloc too often, either.
-	// BCH 11 May 2020: the realloc of gSLiM_Mutation_Block is technically problematic, because
-	// Mutation is non-trivially copyable according to C++.  But it is safe, so I cast to void*
-	// in the hopes that that will make the warning go away.
-	std::uintptr_t old_mutation_block = reinterpret_cast<std::uintptr_t>(gSLiM_Mutation_Block);
+	// don't want to have to commit too often, either.
 	MutationIndex old_block_capacity = gSLiM_Mutation_Block_Capacity;
 	
 	//std::cout << "old capacity: " << old_block_capacity << std::endl;
@@ -117,19 +178,40 @@ void SLiM_IncreaseMutationBlockCapacity(void)
 	// a power of 2, so that we actually reach the maximum; see SLIM_MUTATION_BLOCK_INITIAL_SIZE.
 	// In other words, we expect to be at exactly 0x0000000040000000UL here, and thus to double
 	// to 0x0000000080000000UL, which is a capacity of 2^31, which is the limit of int32_t.
-	if ((size_t)old_block_capacity > 0x0000000040000000UL)	// >2^30 means >2^31 when doubled
-		EIDOS_TERMINATION << "ERROR (SLiM_IncreaseMutationBlockCapacity): too many mutations; there is a limit of 2^31 (2147483648) segregating mutations in SLiM." << EidosTerminate(nullptr);
+	// The reserved capacity is also a power of two, and is normally that same limit; if it was
+	// reduced by a virtual memory limit, we stop there instead, with a message to that effect.
+	size_t new_block_capacity = (size_t)old_block_capacity * 2;
 	
-	gSLiM_Mutation_Block_Capacity *= 2;
-	gSLiM_Mutation_Block = (Mutation *)realloc((void*)gSLiM_Mutation_Block, gSLiM_Mutation_Block_Capacity * sizeof(Mutation));						// NOLINT(*-realloc-usage) : realloc failure is a fatal error anyway
-	gSLiM_Mutation_Refcounts = (slim_refcount_t *)realloc(gSLiM_Mutation_Refcounts, gSLiM_Mutation_Block_Capacity * sizeof(slim_refcount_t));		// NOLINT(*-realloc-usage) : realloc failure is a fatal error anyway
+	if (new_block_capacity > gSLiM_Mutation_Block_ReservedCapacity)
+	{
+		if (omp_in_parallel())
+		{
+			// we can't raise from inside a parallel region, so this is the best we can do
+			std::cerr << "ERROR (SLiM_IncreaseMutationBlockCapacity): too many mutations; the mutation block is at its maximum capacity of " << old_block_capacity << " mutations." << std::endl;
+			raise(SIGTRAP);
+		}
+		
+		if ((size_t)old_block_capacity >= SLIM_MUTATION_BLOCK_MAXIMUM_SIZE / 2)
+			EIDOS_TERMINATION << "ERROR (SLiM_IncreaseMutationBlockCapacity): too many mutations; there is a limit of 2^31 (2147483648) segregating mutations in SLiM." << EidosTerminate(nullptr);
+		else
+			EIDOS_TERMINATION << "ERROR (SLiM_IncreaseMutationBlockCapacity): too many mutations; address space could be reserved for only " << gSLiM_Mutation_Block_ReservedCapacity << " mutations, probably because of a virtual memory limit (see ulimit -v)." << EidosTerminate(nullptr);
+	}
 	
-	if (!gSLiM_Mutation_Block || !gSLiM_Mutation_Refcounts)
+	if (!SLiM_CommitAddressSpace(gSLiM_Mutation_Block, new_block_capacity * sizeof(Mutation)) ||
+		!SLiM_CommitAddressSpace(gSLiM_Mutation_Refcounts, new_block_capacity * sizeof(slim_refcount_t)))
+	{
+		if (omp_in_parallel())
+		{
+			std::cerr << "ERROR (SLiM_IncreaseMutationBlockCapacity): allocation failed; you may need to raise the memory limit for SLiM." << std::endl;
+			raise(SIGTRAP);
+		}
+		
 		EIDOS_TERMINATION << "ERROR (SLiM_IncreaseMutationBlockCapacity): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+	}
 	
-	//std::cout << "new capacity: " << gSLiM_Mutation_Block_Capacity << std::endl;
+	gSLiM_Mutation_Block_Capacity = (MutationIndex)new_block_capacity;
 	
-	std::uintptr_t new_mutation_block = reinterpret_cast<std::uintptr_t>(gSLiM_Mutation_Block);
+	//std::cout << "new capacity: " << gSLiM_Mutation_Block_Capacity << std::endl;
 	
 	// Set up the free list to extend into the new portion of the buffer.  If we are called when
 	// gSLiM_Mutation_FreeIndex != -1, the free list will start with the new region.
@@ -140,27 +222,6 @@ void SLiM_IncreaseMutationBlockCapacity(void)
 	
 	gSLiM_Mutation_FreeIndex = old_block_capacity;
 	
-	// Now we go out and fix Mutation * references in EidosValue_Object in all symbol tables
-	if (new_mutation_block != old_mutation_block)
-	{
-		// This may be excessively cautious, but I want to avoid subtracting these uintptr_t values
-		// to produce a negative number; that seems unwise and possibly platform-dependent.
-		if (old_mutation_block > new_mutation_block)
-		{
-			std::uintptr_t ptr_diff = old_mutation_block - new_mutation_block;
-			
-			for (EidosValue_Object *mutation_value : gEidosValue_Object_Mutation_Registry)
-				mutation_value->PatchPointersBySubtracting(ptr_diff);
-		}
-		else
-		{
-			std::uintptr_t ptr_diff = new_mutation_block - old_mutation_block;
-			
-			for (EidosValue_Object *mutation_value : gEidosValue_Object_Mutation_Registry)
-				mutation_value->PatchPointersByAdding(ptr_diff);
-		}
-	}
-	
 #ifdef DEBUG_LOCKS_ENABLED
 	gSLiM_Mutation_LOCK.end_critical();
 #endif
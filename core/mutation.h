@@ -190,9 +190,11 @@ public:
 //
 
 // All Mutation objects get allocated out of a single shared pool, for speed.  We do not use EidosObjectPool for this
-// any more, because we need the allocation to be out of a single contiguous block of memory that we realloc as needed,
-// allowing Mutation objects to be referred to using 32-bit indexes into this contiguous block.  So we have a custom
-// pool, declared here and implemented in mutation.cpp.  Note that this is a global, to make it easy for users of
+// any more, because we need the allocation to be out of a single contiguous block of memory, allowing Mutation objects
+// to be referred to using 32-bit indexes into this contiguous block.  So we have a custom pool, declared here and
+// implemented in mutation.cpp.  Address space for the largest possible block is reserved up front, and memory is
+// committed at the end of the block as it grows; the block therefore never moves, so a Mutation * stays valid for the
+// life of the mutation, and the block can grow safely even while other threads are reading from it.  Note that this is a global, to make it easy for users of
 // MutationIndex to look up mutations without needing to track down a pointer to the mutation block from the sim.  This
 // means that in SLiMgui a single block will be used for all mutations in all simulations; that should be harmless.
 class MutationRun;
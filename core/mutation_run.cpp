@@ -43,6 +43,9 @@ MutationRun::~MutationRun(void)
 {
 	free(mutations_);
 	
+	if (packed_words_)
+		free(packed_words_);
+	
 #if SLIM_USE_NONNEUTRAL_CACHES
 	if (nonneutral_mutations_)
 		free(nonneutral_mutations_);
@@ -292,6 +295,9 @@ void MutationRun::_RemoveFixedMutations(void)
 	
 	// We don't use begin_pointer() / end_pointer() here, because we actually want to modify the MutationRun even
 	// though it is shared by multiple Haplosomes; this is an exceptional case, so we go around our safeguards.
+	// A packed run is unpacked first; it will be packed again, without the fixed mutations, by the next packing pass.
+	will_write_mutations();
+	
 	MutationIndex *haplosome_iter = mutations_;
 	MutationIndex *haplosome_backfill_iter = nullptr;
 	MutationIndex *haplosome_max = mutations_ + mutation_count_;
@@ -427,6 +433,8 @@ void MutationRun::split_run(MutationRun **p_first_half, MutationRun **p_second_h
 	MutationRun *second_half = NewMutationRun(p_mutrun_context);
 	int32_t second_half_start;
 	
+	ensure_unpacked();
+	
 	for (second_half_start = 0; second_half_start < mutation_count_; ++second_half_start)
 		if ((gSLiM_Mutation_Block + mutations_[second_half_start])->position_ >= p_split_first_position)
 			break;
@@ -453,11 +461,15 @@ void MutationRun::cache_nonneutral_mutations_REGIME_1() const
 	zero_out_nonneutral_buffer();
 	
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	const MutationIndex *mut_iter, *mut_iter_max;
+	static thread_local std::vector<MutationIndex> decode_scratch;
+	
+	decoded_pointers_const(&mut_iter, &mut_iter_max, decode_scratch);
 	
 	// loop through mutations and copy the non-neutral ones into our buffer, resizing as needed
-	for (int32_t bufindex = 0; bufindex < mutation_count_; ++bufindex)
+	for ( ; mut_iter != mut_iter_max; ++mut_iter)
 	{
-		MutationIndex mutindex = mutations_[bufindex];
+		MutationIndex mutindex = *mut_iter;
 		
 		if ((mut_block_ptr + mutindex)->selection_coeff_ != 0.0)
 			add_to_nonneutral_buffer(mutindex);
@@ -477,11 +489,15 @@ void MutationRun::cache_nonneutral_mutations_REGIME_2() const
 	zero_out_nonneutral_buffer();
 	
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	const MutationIndex *mut_iter, *mut_iter_max;
+	static thread_local std::vector<MutationIndex> decode_scratch;
+	
+	decoded_pointers_const(&mut_iter, &mut_iter_max, decode_scratch);
 	
 	// loop through mutations and copy the non-neutral ones into our buffer, resizing as needed
-	for (int32_t bufindex = 0; bufindex < mutation_count_; ++bufindex)
+	for ( ; mut_iter != mut_iter_max; ++mut_iter)
 	{
-		MutationIndex mutindex = mutations_[bufindex];
+		MutationIndex mutindex = *mut_iter;
 		Mutation *mutptr = mut_block_ptr + mutindex;
 		
 		// The result of && is not order-dependent, but the first condition is checked first.
@@ -505,11 +521,15 @@ void MutationRun::cache_nonneutral_mutations_REGIME_3() const
 	zero_out_nonneutral_buffer();
 	
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	const MutationIndex *mut_iter, *mut_iter_max;
+	static thread_local std::vector<MutationIndex> decode_scratch;
+	
+	decoded_pointers_const(&mut_iter, &mut_iter_max, decode_scratch);
 	
 	// loop through mutations and copy the non-neutral ones into our buffer, resizing as needed
-	for (int32_t bufindex = 0; bufindex < mutation_count_; ++bufindex)
+	for ( ; mut_iter != mut_iter_max; ++mut_iter)
 	{
-		MutationIndex mutindex = mutations_[bufindex];
+		MutationIndex mutindex = *mut_iter;
 		Mutation *mutptr = mut_block_ptr + mutindex;
 		
 		// The result of || is not order-dependent, but the first condition is checked first.
@@ -598,8 +618,10 @@ void MutationRun::clear_set_and_merge(const MutationRun &p_mutations_to_set, std
 	MutationIndex mutation_iter_mutation_index = *mutation_iter;
 	slim_position_t mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
 	
-	const MutationIndex *parent_iter		= p_mutations_to_set.begin_pointer_const();
-	const MutationIndex *parent_iter_max	= p_mutations_to_set.end_pointer_const();
+	const MutationIndex *parent_iter, *parent_iter_max;
+	static thread_local std::vector<MutationIndex> decode_scratch;
+	
+	p_mutations_to_set.decoded_pointers_const(&parent_iter, &parent_iter_max, decode_scratch);	// avoids unpacking the parent run
 	MutationIndex parent_iter_mutation_index = *parent_iter;
 	slim_position_t parent_iter_pos = (mut_block_ptr + parent_iter_mutation_index)->position_;
 	
@@ -653,11 +675,257 @@ void MutationRun::clear_set_and_merge(const MutationRun &p_mutations_to_set, std
 	}
 }
 
+void MutationRun::PackMutations(void) const
+{
+	// A run that is already packed just needs its plain buffer freed, if it has been unpacked since it was packed
+	if (packed_words_)
+	{
+		if (plain_valid_.load(std::memory_order_relaxed))
+		{
+			plain_valid_.store(false, std::memory_order_relaxed);
+			free(mutations_);
+			mutations_ = nullptr;
+			mutation_capacity_ = 0;
+		}
+		return;
+	}
+	
+	if ((mutation_count_ < SLIM_MUTRUN_PACKING_MIN_COUNT) || packing_declined_)
+		return;
+	
+	// Find the range of mutation indices in the run, which determines the width of the packed offsets
+	MutationIndex min_index = mutations_[0], max_index = mutations_[0];
+	
+	for (int32_t bufindex = 1; bufindex < mutation_count_; ++bufindex)
+	{
+		MutationIndex mutindex = mutations_[bufindex];
+		
+		if (mutindex < min_index) min_index = mutindex;
+		if (mutindex > max_index) max_index = mutindex;
+	}
+	
+	uint32_t range = (uint32_t)(max_index - min_index);
+	uint8_t bits = 0;
+	
+	while ((bits < 32) && ((range >> bits) != 0))
+		bits++;
+	
+	if (bits > SLIM_MUTRUN_PACKING_MAX_BITS)
+	{
+		packing_declined_ = true;
+		return;
+	}
+	
+	packed_base_ = min_index;
+	packed_bits_ = bits;
+	packed_words_ = (uint64_t *)calloc(PackedWordCount(), sizeof(uint64_t));		// zeroed, so Identical() can compare whole words
+	if (!packed_words_)
+		EIDOS_TERMINATION << "ERROR (MutationRun::PackMutations): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+	
+	for (int32_t bufindex = 0; bufindex < mutation_count_; ++bufindex)
+	{
+		uint64_t offset = (uint64_t)(uint32_t)(mutations_[bufindex] - min_index);
+		uint64_t bit_position = (uint64_t)bufindex * bits;
+		uint64_t *word = packed_words_ + (bit_position >> 6);
+		unsigned int shift = (unsigned int)(bit_position & 63);
+		
+		word[0] |= (offset << shift);
+		
+		if (shift + bits > 64)		// the value straddles a word boundary
+			word[1] |= (offset >> (64 - shift));
+	}
+	
+	plain_valid_.store(false, std::memory_order_relaxed);
+	free(mutations_);
+	mutations_ = nullptr;
+	mutation_capacity_ = 0;
+}
+
+void MutationRun::_UnpackMutations(void) const
+{
+	// This can be called by readers on different threads for the same (shared) run, so it is done inside a critical
+	// section; the packed copy is kept, since the run has not changed, and the next packing pass frees mutations_ again.
+#pragma omp critical (MutationRunUnpack)
+	{
+		if (!plain_valid_.load(std::memory_order_relaxed))
+		{
+			mutation_capacity_ = std::max(mutation_count_, (int32_t)SLIM_MUTRUN_INITIAL_CAPACITY);
+			mutations_ = (MutationIndex *)malloc(mutation_capacity_ * sizeof(MutationIndex));
+			if (!mutations_)
+				EIDOS_TERMINATION << "ERROR (MutationRun::_UnpackMutations): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+			
+			_DecodePackedMutations(mutations_);
+			plain_valid_.store(true, std::memory_order_release);
+		}
+	}
+}
+
+void MutationRun::_DiscardPackedMutations(bool p_preserve_contents)
+{
+	// The run is about to change, so the packed copy is going away; make sure that the plain buffer is valid first
+	if (!plain_valid_.load(std::memory_order_relaxed))
+	{
+		if (p_preserve_contents)
+		{
+			_UnpackMutations();
+		}
+		else
+		{
+			mutation_capacity_ = SLIM_MUTRUN_INITIAL_CAPACITY;
+			mutations_ = (MutationIndex *)malloc(mutation_capacity_ * sizeof(MutationIndex));
+			if (!mutations_)
+				EIDOS_TERMINATION << "ERROR (MutationRun::_DiscardPackedMutations): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+			
+			plain_valid_.store(true, std::memory_order_relaxed);
+		}
+	}
+	
+	free(packed_words_);
+	packed_words_ = nullptr;
+	packing_declined_ = false;
+}
+
+void MutationRun::_DecodePackedMutations(MutationIndex *p_buffer) const
+{
+	const uint64_t *word_ptr = packed_words_;
+	const uint64_t mask = (1ULL << packed_bits_) - 1;
+	const unsigned int bits = packed_bits_;
+	const MutationIndex base = packed_base_;
+	
+	// Stream through the packed words; current_word holds the bits_available not-yet-consumed bits of the current word
+	uint64_t current_word = *word_ptr;
+	unsigned int bits_available = 64;
+	
+	for (int32_t bufindex = 0; bufindex < mutation_count_; ++bufindex)
+	{
+		uint64_t value = current_word;
+		
+		if (bits_available < bits)
+		{
+			// the value straddles a word boundary; the rest of its bits come from the next word
+			uint64_t next_word = *(++word_ptr);
+			
+			value |= (next_word << bits_available);
+			current_word = next_word >> (bits - bits_available);
+			bits_available += 64 - bits;
+		}
+		else
+		{
+			current_word >>= bits;
+			bits_available -= bits;
+		}
+		
+		p_buffer[bufindex] = base + (MutationIndex)(value & mask);
+	}
+}
+
+#if SLIM_INTERN_NEW_MUTATION_RUNS
+const MutationRun *MutationRun::InternMutationRun(const MutationRun *p_run, MutationRunContext &p_mutrun_context)
+{
+	size_t capacity = p_mutrun_context.intern_capacity_;
+	
+	if (capacity == 0)
+	{
+		// No table has been allocated yet; it will be sized at the next reset, from this count
+		p_mutrun_context.intern_insertion_count_.fetch_add(1, std::memory_order_relaxed);
+		return p_run;
+	}
+	
+	MutationRunInternSlot *slots = p_mutrun_context.intern_slots_.get();
+	int64_t hash = p_run->Hash();
+	
+	// Hash() is good at distinguishing runs but its low bits are not well mixed, so we finish it with the splitmix64 finalizer
+	uint64_t slot_hash = (uint64_t)hash;
+	slot_hash = (slot_hash ^ (slot_hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	slot_hash = (slot_hash ^ (slot_hash >> 27)) * 0x94d049bb133111ebULL;
+	slot_hash = slot_hash ^ (slot_hash >> 31);
+	
+	size_t mask = capacity - 1;
+	size_t slot_index = (size_t)slot_hash & mask;
+	
+	for (int probe = 0; probe < SLIM_MUTRUN_INTERN_MAX_PROBES; ++probe, slot_index = (slot_index + 1) & mask)
+	{
+		MutationRunInternSlot &slot = slots[slot_index];
+		const MutationRun *slot_run = slot.run_.load(std::memory_order_acquire);
+		
+		if (!slot_run)
+		{
+			// The slot is empty, so p_run is not in the table (slots are never vacated between resets); try to claim the slot
+			if (slot.run_.compare_exchange_strong(slot_run, p_run, std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				slot.hash_.store(hash, std::memory_order_release);
+				p_mutrun_context.intern_insertion_count_.fetch_add(1, std::memory_order_relaxed);
+				return p_run;
+			}
+			
+			// Another thread claimed the slot first; slot_run now refers to its run, which might be identical to ours
+		}
+		
+		// Runs in the table are complete and immutable, so comparing against them is safe even while other threads insert
+		if ((slot.hash_.load(std::memory_order_acquire) == hash) && slot_run->Identical(*p_run))
+			return slot_run;
+	}
+	
+	// The neighborhood is crowded; keep p_run as it is, and leave any duplication to UniqueMutationRuns().  We count this as an
+	// insertion, so that a table that is too small for the number of new runs being created grows at the next reset.
+	p_mutrun_context.intern_insertion_count_.fetch_add(1, std::memory_order_relaxed);
+	return p_run;
+}
+
+void MutationRun::ResetInternTable(MutationRunContext &p_mutrun_context)
+{
+	// If nothing was inserted since the last reset, the table is still empty and can be left alone
+	size_t insertion_count = p_mutrun_context.intern_insertion_count_.exchange(0, std::memory_order_relaxed);
+	
+	if ((insertion_count == 0) && p_mutrun_context.intern_slots_)
+		return;
+	
+	// We aim for a load factor of at most 25% if the next tick makes as many insertions as the last, leaving room for growth
+	// (a table that gets crowded just declines to intern, until the next reset grows it); the table is reallocated only when
+	// it needs to grow, or could shrink by 8x, to avoid churning
+	size_t capacity = 1024;
+	
+	while (capacity < insertion_count * 4)
+		capacity <<= 1;
+	
+	if ((capacity > p_mutrun_context.intern_capacity_) || (capacity * 8 < p_mutrun_context.intern_capacity_))
+	{
+		p_mutrun_context.intern_slots_.reset(new MutationRunInternSlot[capacity]);
+		p_mutrun_context.intern_capacity_ = capacity;
+	}
+	
+	MutationRunInternSlot *slots = p_mutrun_context.intern_slots_.get();
+	
+	for (size_t slot_index = 0; slot_index < p_mutrun_context.intern_capacity_; ++slot_index)
+	{
+		slots[slot_index].run_.store(nullptr, std::memory_order_relaxed);
+		slots[slot_index].hash_.store(0, std::memory_order_relaxed);
+	}
+}
+#endif
+
 size_t MutationRun::MemoryUsageForMutationIndexBuffers(void) const
 {
 	return mutation_capacity_ * sizeof(MutationIndex);
 }
 
+size_t MutationRun::MemoryUsageForPackedBuffers(void) const
+{
+	return (packed_words_ ? PackedWordCount() * sizeof(uint64_t) : 0);
+}
+
+size_t MutationRun::MemoryUsageSavedByPacking(void) const
+{
+	// Compared to the minimal plain buffer that would otherwise hold the run; zero if the plain buffer also exists right now
+	if (!packed_words_ || plain_valid_.load(std::memory_order_relaxed))
+		return 0;
+	
+	size_t plain_size = mutation_count_ * sizeof(MutationIndex);
+	size_t packed_size = PackedWordCount() * sizeof(uint64_t);
+	
+	return (plain_size > packed_size) ? (plain_size - packed_size) : 0;
+}
+
 size_t MutationRun::MemoryUsageForNonneutralCaches(void) const
 {
 	return nonneutral_mutation_capacity_ * sizeof(MutationIndex);
@@ -709,3 +977,63 @@ size_t MutationRun::MemoryUsageForNonneutralCaches(void) const
 
 
 
+
+
+//
+//	MutationRunLayout
+//
+
+void MutationRunLayout::SetUniformLayout(int32_t p_run_count, slim_position_t p_run_length)
+{
+	run_count_ = p_run_count;
+	covered_length_ = p_run_count * p_run_length;
+	uniform_ = true;
+	uniform_length_ = p_run_length;
+	granule_length_ = 0;
+	
+	run_starts_.resize(p_run_count + 1);
+	for (int32_t run_index = 0; run_index <= p_run_count; ++run_index)
+		run_starts_[run_index] = run_index * p_run_length;
+	
+	granule_runs_.clear();
+	granule_runs_.shrink_to_fit();
+}
+
+void MutationRunLayout::SetGranuleLayout(slim_position_t p_granule_length, slim_position_t p_covered_length, const std::vector<int32_t> &p_granule_boundaries)
+{
+	// p_granule_boundaries gives the first granule of each run, followed by the granule count; the last granule may be partial
+	int32_t run_count = (int32_t)p_granule_boundaries.size() - 1;
+	
+	if ((run_count < 1) || (run_count > UINT16_MAX) || (p_granule_length < 1) || (p_granule_boundaries[0] != 0))
+		EIDOS_TERMINATION << "ERROR (MutationRunLayout::SetGranuleLayout): (internal error) invalid mutation run layout." << EidosTerminate();
+	
+	run_count_ = run_count;
+	covered_length_ = p_covered_length;
+	uniform_ = false;
+	uniform_length_ = 0;
+	granule_length_ = p_granule_length;
+	
+	int32_t granule_count = GranuleCount();
+	
+	if (p_granule_boundaries[run_count] != granule_count)
+		EIDOS_TERMINATION << "ERROR (MutationRunLayout::SetGranuleLayout): (internal error) mutation run layout does not cover the chromosome." << EidosTerminate();
+	
+	run_starts_.resize(run_count + 1);
+	granule_runs_.resize(granule_count);
+	
+	for (int32_t run_index = 0; run_index < run_count; ++run_index)
+	{
+		int32_t first_granule = p_granule_boundaries[run_index];
+		int32_t end_granule = p_granule_boundaries[run_index + 1];
+		
+		if (end_granule <= first_granule)
+			EIDOS_TERMINATION << "ERROR (MutationRunLayout::SetGranuleLayout): (internal error) empty mutation run in layout." << EidosTerminate();
+		
+		run_starts_[run_index] = first_granule * p_granule_length;
+		
+		for (int32_t granule_index = first_granule; granule_index < end_granule; ++granule_index)
+			granule_runs_[granule_index] = (uint16_t)run_index;
+	}
+	
+	run_starts_[run_count] = p_covered_length;
+}
@@ -40,6 +40,10 @@
 
 #include <string.h>
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 
 class MutationRun;
@@ -54,6 +58,26 @@ class MutationRun;
 // for the MutationRuns being used by each thread.
 typedef std::vector<const MutationRun *> MutationRunPool;
 
+// If defined as 1, the mutation runs of each new offspring haplosome are interned as they are created: a child run identical to
+// the corresponding run of either parent is replaced by the parental run, and other nonempty child runs are looked up in a
+// per-MutationRunContext hash table of the runs created so far in the tick, so that duplicates produced by recombination between
+// the same parental runs are collapsed at once rather than waiting for the periodic Population::UniqueMutationRuns() pass.
+// Runs that received a new mutation are never interned, since they cannot duplicate any existing run.
+#define SLIM_INTERN_NEW_MUTATION_RUNS	1
+
+// The maximum number of slots probed by MutationRun::InternMutationRun() before it gives up; a run that is not interned because
+// the table is crowded is simply kept as it is, so this bounds the cost of a lookup without affecting correctness.
+#define SLIM_MUTRUN_INTERN_MAX_PROBES	16
+
+#if SLIM_INTERN_NEW_MUTATION_RUNS
+// One slot in the intern table of a MutationRunContext.  A slot is claimed by compare-and-swap on run_, after which hash_ is set;
+// a reader that sees a claimed slot whose hash_ has not yet been set will just fail to match it, which is harmless.
+typedef struct MutationRunInternSlot {
+	std::atomic<const MutationRun *> run_;
+	std::atomic<int64_t> hash_;
+} MutationRunInternSlot;
+#endif
+
 // This struct groups together all the objects for one context in which MutationRuns are allocated and used.  There is one
 // such context per thread for each chromosome in the model -- a multiplicity of contexts, for locality and encapsulation.
 typedef struct MutationRunContext {
@@ -64,9 +88,77 @@ typedef struct MutationRunContext {
 #ifdef _OPENMP
 	omp_lock_t allocation_pool_lock_;					// must be used when accessing allocation pools across parallel threads
 #endif
+	
+#if SLIM_INTERN_NEW_MUTATION_RUNS
+	// The intern table holds the nonempty runs created by offspring generation since it was last reset, so that a newly created
+	// run that duplicates one of them can be replaced by it; see MutationRun::InternMutationRun().  It is an open-addressed table
+	// with a fixed power-of-two capacity between resets, so lookups and insertions can be done lock-free from parallel threads.
+	// It must be reset by MutationRun::ResetInternTable() before any run it might contain is freed; this is done in
+	// Population::FreeUnusedMutationRuns(), and the table is then sized from the number of insertions made since the last reset.
+	std::unique_ptr<MutationRunInternSlot[]> intern_slots_;
+	size_t intern_capacity_ = 0;
+	std::atomic<size_t> intern_insertion_count_{0};
+#endif
 } MutationRunContext;
 
 
+// If defined as 1, a chromosome whose recombination and mutation maps are strongly heterogeneous divides its positions into mutation
+// runs of varying length, with boundaries placed so that each run receives a similar share of the crossover, new-mutation, and
+// segregating-mutation load; see Chromosome::ChooseMutationRunLayout().  If 0, all runs always have the same length, as before.
+#define SLIM_ADAPTIVE_MUTRUN_LAYOUT		1
+
+// The number of granules a non-uniform MutationRunLayout aims for.  Boundaries are placed only at multiples of the granule length,
+// and a lookup table with one entry per granule maps positions to runs, so this trades boundary resolution against table size.
+#define SLIM_MUTRUN_LAYOUT_GRANULES		4096
+
+// A chromosome uses a non-uniform layout only if, over a reference division into equal-length bins, the heaviest bin carries at
+// least this multiple of the mean bin weight; otherwise equal-length runs are nearly as good, and are cheaper to map positions into.
+#define SLIM_MUTRUN_LAYOUT_MIN_IMBALANCE	2.0
+
+// MutationRunLayout describes how the positions of a chromosome are divided among its mutation runs.  Run i covers the positions
+// [RunStart(i), RunStart(i+1)), and the runs together cover [0, covered_length_), which may extend past the chromosome's end.  A
+// uniform layout has runs of equal length, and maps a position to a run by division, exactly as SLiM has always done; a non-uniform
+// layout maps through granule_runs_, in which each granule of granule_length_ positions lies entirely within one run.  Each Chromosome
+// owns one layout, which is changed in place when mutation runs are split or joined; each of its haplosomes points to it.
+class MutationRunLayout
+{
+public:
+	int32_t run_count_ = 0;								// the number of mutation runs
+	slim_position_t covered_length_ = 0;				// the number of positions covered by the runs; one past the last covered position
+	bool uniform_ = true;								// if true, every run has length uniform_length_
+	slim_position_t uniform_length_ = 0;				// the run length, for a uniform layout
+	slim_position_t granule_length_ = 0;				// the granule length, for a non-uniform layout
+	std::vector<slim_position_t> run_starts_;			// the first position of each run, plus covered_length_ at the end (run_count_ + 1 entries)
+	std::vector<uint16_t> granule_runs_;				// the run containing each granule, for a non-uniform layout
+
+	void SetUniformLayout(int32_t p_run_count, slim_position_t p_run_length);
+	void SetGranuleLayout(slim_position_t p_granule_length, slim_position_t p_covered_length, const std::vector<int32_t> &p_granule_boundaries);
+
+	inline int32_t GranuleCount(void) const { return (int32_t)((covered_length_ + granule_length_ - 1) / granule_length_); }
+
+	// Positions at or beyond covered_length_ map to run_count_ or beyond, for both kinds of layout, as the crossover-mutation code
+	// expects for the terminating breakpoint it places beyond the end of the last run
+	inline __attribute__((always_inline)) slim_mutrun_index_t RunIndexForPosition(slim_position_t p_position) const
+	{
+		if (uniform_)
+			return (slim_mutrun_index_t)(p_position / uniform_length_);
+		if (p_position >= covered_length_)
+			return run_count_;
+		return granule_runs_[p_position / granule_length_];
+	}
+
+	// p_run_index may be run_count_, giving covered_length_; for a uniform layout it may be larger still
+	inline __attribute__((always_inline)) slim_position_t RunStart(slim_mutrun_index_t p_run_index) const
+	{
+		if (uniform_)
+			return p_run_index * uniform_length_;
+		return run_starts_[p_run_index];
+	}
+
+	inline slim_position_t RunLastPosition(slim_mutrun_index_t p_run_index) const { return RunStart(p_run_index + 1) - 1; }
+};
+
+
 // BCH 4/19/2023: We want MutationRuns to be able to be shared between Haplosomes; that's the whole point, leveraging shared
 // haplohype blocks to reduce redundant processing.  We also need to modify MutationRun objects, particularly when they are
 // first created, adding the mutations that they contain.  These goals are somewhat in opposition, because once a MutationRun
@@ -87,6 +179,12 @@ typedef struct MutationRunContext {
 // many mutations, versus excessive reallocs for other simulations before they get up to equilibrium.  Set by guessing.
 #define SLIM_MUTRUN_INITIAL_CAPACITY	16
 
+// Mutation runs shorter than this are never packed by MutationRun::PackMutations(); packing them would save little, and short
+// runs are more likely to be modified or discarded soon.  Packing is also declined if the packed offsets would need more than
+// SLIM_MUTRUN_PACKING_MAX_BITS bits each, since the savings would then be less than 25% of the plain buffer.
+#define SLIM_MUTRUN_PACKING_MIN_COUNT	32
+#define SLIM_MUTRUN_PACKING_MAX_BITS	24
+
 
 // If defined as 1, MutationRun will keep a side cache of the non-neutral mutations occuring inside it.  This can greatly accelerate
 // fitness calculations, but does consume additional memory, and is not always advantageous.  Define to 0 to disable this feature.
@@ -112,9 +210,23 @@ private:
 	// making new MutationRun objects.  We now reuse MutationRun objects, without freeing their MutationIndex buffer, so the malloc
 	// overhead equilibrates and then goes away.  Removing the internal buffer saves space and simplifies the logic.  BCH 4/16/2023
 	
-	MutationIndex *mutations_;									// OWNED POINTER: a pointer to an array of MutationIndex
+	mutable MutationIndex *mutations_;							// OWNED POINTER: a pointer to an array of MutationIndex
 	int32_t mutation_count_ = 0;								// the number of entries presently in mutations_
-	int32_t mutation_capacity_;									// the capacity of mutations_
+	mutable int32_t mutation_capacity_;							// the capacity of mutations_
+	
+	// Packed storage, used only when the species has compressMutationRuns=T.  At the end of each tick, Population::PackMutationRuns()
+	// packs long runs that are in use: their mutation indices are stored as fixed-width offsets from the smallest index in the run,
+	// bit-packed into packed_words_, and the plain buffer in mutations_ is freed.  Runs are immutable once shared, and most runs are
+	// passed from parent to offspring intact, so this is usually a one-time cost per run.  A packed run can still be read through
+	// the usual accessors; begin_pointer_const() etc. unpack it on demand, keeping the packed copy since the run is unchanged, and
+	// the next packing pass frees the plain buffer again.  Readers that make a single pass over many runs, like the mutation tally
+	// code, should use decoded_pointers_const() instead, which decodes into a scratch buffer and leaves the run packed.  Any change
+	// to the run discards the packed copy.  This is all a form of caching, so it is mutable even for immutable objects.
+	mutable std::atomic<bool> plain_valid_{true};				// true if mutations_ holds the run's mutations; false if only packed_words_ does
+	mutable uint64_t *packed_words_ = nullptr;					// OWNED POINTER: the bit-packed offsets, or nullptr if the run is not packed
+	mutable MutationIndex packed_base_ = 0;						// the smallest mutation index in the run; packed values are offsets from this
+	mutable uint8_t packed_bits_ = 0;							// the width of each packed offset, in bits (0 if all indices are equal)
+	mutable bool packing_declined_ = false;						// set when packing would not save enough; cleared when the run is recycled
 	
 	mutable uint32_t use_count_ = 0;							// the usage count for this run across all haplosomes that are tallied
 #ifdef DEBUG_LOCKS_ENABLED
@@ -304,6 +416,9 @@ public:
 		// unused by Haplosomes, and so we can cast away the const (see comment at the header top about this).
 		MutationRun *freed_run = const_cast<MutationRun *>(p_run);
 		
+		if (freed_run->packed_words_)
+			freed_run->_DiscardPackedMutations(false);		// drop the packed copy, ensuring that a plain buffer exists
+		freed_run->packing_declined_ = false;
 		freed_run->mutation_count_ = 0;						// empty the mutation buffer
 		
 #if SLIM_USE_NONNEUTRAL_CACHES
@@ -336,7 +451,41 @@ public:
 		
 		free_pool.resize(0);
 		in_use_pool.resize(0);
+		
+#if SLIM_INTERN_NEW_MUTATION_RUNS
+		ResetInternTable(p_mutrun_context);
+#endif
+	}
+	
+#if SLIM_INTERN_NEW_MUTATION_RUNS
+	// Interning of newly created runs; see SLIM_INTERN_NEW_MUTATION_RUNS above and Population::InternChildMutationRuns().
+	// InternMutationRun() returns a run identical to p_run from the context's intern table, inserting p_run if there is none;
+	// it may be called concurrently.  ResetInternTable() empties the table, resizing it for the number of insertions since the
+	// last reset; it must not be called concurrently with InternMutationRun().  FreeNewMutationRun_LOCKED() frees a run that was
+	// just created and then found to be a duplicate, if it is still the most recent run in the in-use pool; otherwise the run is
+	// left in the in-use pool to be freed by Population::FreeUnusedMutationRuns(), since it has no other users.
+	static const MutationRun *InternMutationRun(const MutationRun *p_run, MutationRunContext &p_mutrun_context);
+	static void ResetInternTable(MutationRunContext &p_mutrun_context);
+	
+	static inline void FreeNewMutationRun_LOCKED(const MutationRun *p_run, MutationRunContext &p_mutrun_context)
+	{
+#ifdef _OPENMP
+		omp_set_lock(&p_mutrun_context.allocation_pool_lock_);
+#endif
+		
+		MutationRunPool &in_use_pool = p_mutrun_context.in_use_pool_;
+		
+		if (in_use_pool.size() && (in_use_pool.back() == p_run))
+		{
+			in_use_pool.pop_back();
+			FreeMutationRun(p_run, p_mutrun_context);
+		}
+		
+#ifdef _OPENMP
+		omp_unset_lock(&p_mutrun_context.allocation_pool_lock_);
+#endif
 	}
+#endif
 	
 	MutationRun(const MutationRun&) = delete;					// no copying
 	MutationRun& operator=(const MutationRun&) = delete;		// no copying
@@ -382,11 +531,59 @@ public:
 #endif
 	}
 	
+	// Packing; see the comments on packed_words_ above.  ensure_unpacked() must be called before reading mutations_ directly,
+	// and will_write_mutations() before modifying it; the accessors below do this for you.  PackMutations() may only be called
+	// when no other code is using the run, since it frees the plain buffer; Population::PackMutationRuns() is the funnel for it.
+	inline __attribute__((always_inline)) bool is_packed(void) const { return (packed_words_ != nullptr); }
+	inline __attribute__((always_inline)) void ensure_unpacked(void) const {
+		if (!plain_valid_.load(std::memory_order_acquire))
+			_UnpackMutations();
+	}
+	inline __attribute__((always_inline)) void will_write_mutations(void) {
+		if (packed_words_)
+			_DiscardPackedMutations(true);
+	}
+	inline __attribute__((always_inline)) MutationIndex packed_mutation_at(int32_t p_index) const {
+		uint64_t bit_position = (uint64_t)p_index * packed_bits_;
+		const uint64_t *word = packed_words_ + (bit_position >> 6);
+		unsigned int shift = (unsigned int)(bit_position & 63);
+		uint64_t value = word[0] >> shift;
+		
+		if (shift + packed_bits_ > 64)		// the value straddles a word boundary
+			value |= word[1] << (64 - shift);
+		
+		return packed_base_ + (MutationIndex)(value & ((1ULL << packed_bits_) - 1));
+	}
+	void PackMutations(void) const;
+	void _UnpackMutations(void) const;
+	void _DiscardPackedMutations(bool p_preserve_contents);
+	void _DecodePackedMutations(MutationIndex *p_buffer) const;
+	
+	// Provides pointers to the run's mutations without unpacking it; if the run is packed, its mutations are decoded into
+	// p_scratch, which must remain untouched while the returned pointers are in use.  This is for single-pass readers.
+	inline __attribute__((always_inline)) void decoded_pointers_const(const MutationIndex **p_begin, const MutationIndex **p_end, std::vector<MutationIndex> &p_scratch) const
+	{
+		if (plain_valid_.load(std::memory_order_acquire))
+		{
+			*p_begin = mutations_;
+			*p_end = mutations_ + mutation_count_;
+		}
+		else
+		{
+			p_scratch.resize(mutation_count_);
+			_DecodePackedMutations(p_scratch.data());
+			*p_begin = p_scratch.data();
+			*p_end = p_scratch.data() + mutation_count_;
+		}
+	}
+	
 	inline __attribute__((always_inline)) MutationIndex const & operator[] (int p_index) const {	// [] returns a reference to a pointer to Mutation; this is the const-pointer variant
+		ensure_unpacked();
 		return mutations_[p_index];
 	}
 	
 	inline __attribute__((always_inline)) MutationIndex& operator[] (int p_index) {				// [] returns a reference to a pointer to Mutation; this is the non-const-pointer variant
+		will_write_mutations();
 		return mutations_[p_index];
 	}
 	
@@ -395,11 +592,14 @@ public:
 	}
 	
 	inline __attribute__((always_inline)) void set_size(int p_size) {
+		will_write_mutations();
 		mutation_count_ = p_size;
 	}
 	
 	inline __attribute__((always_inline)) void clear(void)
 	{
+		if (packed_words_)
+			_DiscardPackedMutations(false);
 		mutation_count_ = 0;
 	}
 	
@@ -409,12 +609,16 @@ public:
 	
 	inline __attribute__((always_inline)) void pop_back(void)
 	{
+		will_write_mutations();
+		
 		if (mutation_count_ > 0)	// the standard says that popping an empty vector results in undefined behavior; this seems reasonable
 			--mutation_count_;
 	}
 	
 	inline __attribute__((always_inline)) void emplace_back(MutationIndex p_mutation_index)
 	{
+		will_write_mutations();
+		
 		if (mutation_count_ == mutation_capacity_)
 		{
 			// Up to a point, we want to double our capacity each time we have to realloc.  Beyond a certain point, that starts to
@@ -448,6 +652,8 @@ public:
 	
 	inline void emplace_back_bulk(const MutationIndex *p_mutation_indices, int32_t p_copy_count)
 	{
+		will_write_mutations();
+		
 		if (mutation_count_ + p_copy_count > mutation_capacity_)
 		{
 			// See emplace_back for comments on our capacity policy
@@ -587,18 +793,23 @@ public:
 	{
 		int source_mutation_count = p_source_run.mutation_count_;
 		
+		will_write_mutations();
+		
 		// first we need to ensure that we have sufficient capacity
 		if (source_mutation_count > mutation_capacity_)
 		{
-			mutation_capacity_ = p_source_run.mutation_capacity_;		// just use the same capacity as the source
+			mutation_capacity_ = std::max(p_source_run.mutation_capacity_, source_mutation_count);		// just use the same capacity as the source, unless it is packed
 			
 			mutations_ = (MutationIndex *)realloc(mutations_, mutation_capacity_ * sizeof(MutationIndex));
 			if (!mutations_)
 				EIDOS_TERMINATION << "ERROR (MutationRun::copy_from_run): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
 		}
 		
-		// then copy all pointers from the source to ourselves
-		memcpy(mutations_, p_source_run.mutations_, source_mutation_count * sizeof(MutationIndex));
+		// then copy all pointers from the source to ourselves, decoding them if the source is packed
+		if (p_source_run.plain_valid_.load(std::memory_order_acquire))
+			memcpy(mutations_, p_source_run.mutations_, source_mutation_count * sizeof(MutationIndex));
+		else
+			p_source_run._DecodePackedMutations(mutations_);
 		mutation_count_ = source_mutation_count;
 	}
 	
@@ -606,6 +817,8 @@ public:
 	{
 		int source_mutation_count = (int)p_source_vector.size();
 		
+		will_write_mutations();
+		
 		// first we need to ensure that we have sufficient capacity
 		if (source_mutation_count > mutation_capacity_)
 		{
@@ -634,34 +847,30 @@ public:
 	
 	inline __attribute__((always_inline)) const MutationIndex *begin_pointer_const(void) const
 	{
+		ensure_unpacked();
 		return mutations_;
 	}
 	
 	inline __attribute__((always_inline)) const MutationIndex *end_pointer_const(void) const
 	{
+		ensure_unpacked();
 		return mutations_ + mutation_count_;
 	}
 	
 	inline __attribute__((always_inline)) MutationIndex *begin_pointer(void)
 	{
+		will_write_mutations();
 		return mutations_;
 	}
 	
 	inline __attribute__((always_inline)) MutationIndex *end_pointer(void)
 	{
+		will_write_mutations();
 		return mutations_ + mutation_count_;
 	}
 	
+	// Removes all mutations with a state_ of MutationState::kFixedAndSubstituted; see Population::RemoveAllFixedMutations()
 	void _RemoveFixedMutations(void);
-	inline __attribute__((always_inline)) void RemoveFixedMutations(int64_t p_operation_id)
-	{
-		if (operation_id_ != p_operation_id)
-		{
-			operation_id_ = p_operation_id;
-			
-			_RemoveFixedMutations();
-		}
-	}
 	
 	// Hash and comparison functions used by UniqueMutationRuns() to unique mutation runs
 	inline __attribute__((always_inline)) int64_t Hash(void) const
@@ -673,10 +882,19 @@ public:
 		// early on when chromosomes are nearly empty collisions are common (where using mut_index++ gives us zero
 		// collisions in pretty much all cases), but at that stage Identical() is fast so it's OK.  At equilibrium
 		// when chromosomes are more full collisions are much less common, so we avoid Identical() when it is slow.
-		for (int mut_index = 0; mut_index < mutation_count_; mut_index += 4)
+		// Packed runs are hashed from their decoded values, so that a packed run hashes the same as a plain copy.
+		if (plain_valid_.load(std::memory_order_acquire))
+		{
+			for (int mut_index = 0; mut_index < mutation_count_; mut_index += 4)
+			{
+				// this hash function is a stab in the dark based upon the sdbm algorithm here: http://www.cse.yorku.ca/~oz/hash.html
+				hash = (uint64_t)mutations_[mut_index] + (hash << 6) + (hash << 16) - hash;
+			}
+		}
+		else
 		{
-			// this hash function is a stab in the dark based upon the sdbm algorithm here: http://www.cse.yorku.ca/~oz/hash.html
-			hash = (uint64_t)mutations_[mut_index] + (hash << 6) + (hash << 16) - hash;
+			for (int mut_index = 0; mut_index < mutation_count_; mut_index += 4)
+				hash = (uint64_t)packed_mutation_at(mut_index) + (hash << 6) + (hash << 16) - hash;
 		}
 		
 		return hash;
@@ -687,8 +905,24 @@ public:
 		if (mutation_count_ != p_run.mutation_count_)
 			return false;
 		
-		if (memcmp(mutations_, p_run.mutations_, mutation_count_ * sizeof(MutationIndex)) != 0)
-			return false;
+		bool plain_valid = plain_valid_.load(std::memory_order_acquire);
+		bool run_plain_valid = p_run.plain_valid_.load(std::memory_order_acquire);
+		
+		if (plain_valid && run_plain_valid)
+			return (memcmp(mutations_, p_run.mutations_, mutation_count_ * sizeof(MutationIndex)) == 0);
+		
+		// If both runs are packed with the same parameters, their packed words can be compared directly; unused bits are zero
+		if (!plain_valid && !run_plain_valid && (packed_base_ == p_run.packed_base_) && (packed_bits_ == p_run.packed_bits_))
+			return (memcmp(packed_words_, p_run.packed_words_, PackedWordCount() * sizeof(uint64_t)) == 0);
+		
+		for (int mut_index = 0; mut_index < mutation_count_; ++mut_index)
+		{
+			MutationIndex mutindex = (plain_valid ? mutations_[mut_index] : packed_mutation_at(mut_index));
+			MutationIndex run_mutindex = (run_plain_valid ? p_run.mutations_[mut_index] : p_run.packed_mutation_at(mut_index));
+			
+			if (mutindex != run_mutindex)
+				return false;
+		}
 		
 		return true;
 	}
@@ -831,7 +1065,13 @@ public:
 #endif	// SLIM_USE_NONNEUTRAL_CACHES
 	
 	// Memory usage tallying, for outputUsage()
+	inline __attribute__((always_inline)) size_t PackedWordCount(void) const {
+		size_t word_count = ((size_t)mutation_count_ * packed_bits_ + 63) / 64;
+		return (word_count ? word_count : 1);		// we always allocate at least one word, so packed_words_ is non-null
+	}
 	size_t MemoryUsageForMutationIndexBuffers(void) const;
+	size_t MemoryUsageForPackedBuffers(void) const;
+	size_t MemoryUsageSavedByPacking(void) const;
 	size_t MemoryUsageForNonneutralCaches(void) const;
 };
 
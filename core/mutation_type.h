@@ -139,6 +139,11 @@ public:
 	// muttypes, chromosome-based fitness calculations will be skipped altogether for this tick.
 	mutable bool is_pure_neutral_now_;
 	
+	// vectorized_mutationEffect_now_ is set up by Subpopulation::RunVectorizedMutationEffectCallbacks(), and is valid only inside a given
+	// UpdateFitness() call.  If set, the mutation type is subject to vectorized mutationEffect() callbacks in the current subpopulation /
+	// tick, and ApplyMutationEffectCallbacks() records or replays the effects of its mutations rather than executing callbacks for them.
+	mutable bool vectorized_mutationEffect_now_ = false;
+	
 	// set_neutral_by_global_active_callback_ is set by RecalculateFitness() if the muttype is made neutral by a constant callback
 	// (i.e., return 1.0) that is global (i.e., applies to all subpops) and active.  This flag should be consulted only when the
 	// "nonneutral regime" (i.e., sim.last_nonneutral_regime_) is 2 (constant neutral mutationEffect() callbacks only); it is not
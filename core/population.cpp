@@ -603,31 +603,6 @@ void Population::DoDeferredReproduction(void)
 	if (deferred_count_total == 0)
 		return;
 	
-	// before going parallel, we need to ensure that we have enough capacity in the
-	// mutation block; we can't expand it while parallel, due to race conditions
-	// see Population::EvolveSubpopulation() for the equivalent WF code
-#ifdef _OPENMP
-	do {
-		int registry_size;
-		MutationRegistry(&registry_size);
-		size_t est_mutation_block_slots_remaining_PRE = gSLiM_Mutation_Block_Capacity - registry_size;
-		double overall_mutation_rate = std::max(species_.chromosome_->overall_mutation_rate_F_, species_.chromosome_->overall_mutation_rate_M_);	// already multiplied by L
-		size_t est_slots_needed = (size_t)ceil(2 * deferred_count_total * overall_mutation_rate);	// 2 because diploid, in the worst case
-		
-		size_t ten_times_demand = 10 * est_slots_needed;
-		
-		if (est_mutation_block_slots_remaining_PRE <= ten_times_demand)
-		{
-			SLiM_IncreaseMutationBlockCapacity();
-			est_mutation_block_slots_remaining_PRE = gSLiM_Mutation_Block_Capacity - registry_size;
-			
-			//std::cerr << "Tick " << community_.Tick() << ": DOUBLED CAPACITY ***********************************" << std::endl;
-		}
-		else
-			break;
-	} while (true);
-#endif
-	
 	// now generate the haplosomes of the deferred offspring in parallel
 	EIDOS_BENCHMARK_START(EidosBenchmarkType::k_DEFERRED_REPRO);
 	
@@ -2399,6 +2374,7 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 		// In some cases the code below parallelizes, when we're running multithreaded.  The main condition, already satisfied simply by virtue of
 		// being in this code path, is that there are no callbacks enabled, of any type, that influence the process of reproduction.  This is because
 		// we can't run Eidos code in parallel, at least for now.  At the moment, the DSB recombination model is also not allowed; it hasn't been tested.
+		// Tree-sequence recording is allowed; while parallel, it goes into per-thread buffers (see Species::BeginParallelTreeSeqRecording()).
 #ifdef _OPENMP
 		bool can_parallelize = true;
 		
@@ -2476,42 +2452,11 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 					slim_pedigreeid_t base_pedigree_id = SLiM_GetNextPedigreeID_Block(migrants_to_generate);
 					slim_popsize_t base_child_count = child_count;
 					
-					// We need to make sure we have adequate capacity in the global mutation block for new mutations before we go parallel;
-					// if SLiM_IncreaseMutationBlockCapacity() is called while parallel, it is a fatal error.  So we make a guess at how
-					// much free space we will need, and preallocate here as needed, regardless of will_parallelize; no reason not to.
 #ifdef _OPENMP
 					bool will_parallelize = can_parallelize && (migrants_to_generate >= EIDOS_OMPMIN_WF_REPRO);
-					size_t est_mutation_block_slots_remaining_PRE = 0;
-					//size_t actual_mutation_block_slots_remaining_PRE = 0;
-					double overall_mutation_rate = 0;
-					size_t est_slots_needed = 0;
-					
-					{
-						do {
-							int registry_size;
-							MutationRegistry(&registry_size);
-							est_mutation_block_slots_remaining_PRE = gSLiM_Mutation_Block_Capacity - registry_size;
-							//actual_mutation_block_slots_remaining_PRE = SLiMMemoryUsageForFreeMutations() / sizeof(Mutation);
-							overall_mutation_rate = std::max(species_.chromosome_->overall_mutation_rate_F_, species_.chromosome_->overall_mutation_rate_M_);	// already multiplied by L
-							est_slots_needed = (size_t)ceil(2 * migrants_to_generate * overall_mutation_rate);	// 2 because diploid, in the worst case
-							
-							size_t ten_times_demand = 10 * est_slots_needed;
-							
-							if (est_mutation_block_slots_remaining_PRE <= ten_times_demand)
-							{
-								SLiM_IncreaseMutationBlockCapacity();
-								est_mutation_block_slots_remaining_PRE = gSLiM_Mutation_Block_Capacity - registry_size;
-								
-								//std::cerr << "Tick " << community_.Tick() << ": DOUBLED CAPACITY ***********************************" << std::endl;
-							}
-							else
-								break;
-						} while (true);
-						
-						//std::cerr << "Tick " << community_.Tick() << ":" << std::endl;
-						//std::cerr << "   before reproduction, " << actual_mutation_block_slots_remaining_PRE << " actual slots remaining (" << est_mutation_block_slots_remaining_PRE << " estimated)" << std::endl;
-						//std::cerr << "   demand for new mutations estimated at " << est_slots_needed << " (" << migrants_to_generate << " offspring, E(muts) == " << overall_mutation_rate << ")" << std::endl;
-					}
+					bool buffer_tree_seq = recording_tree_sequence && (will_parallelize || gSLiMForceParallelPaths);
+#else
+					bool buffer_tree_seq = recording_tree_sequence && gSLiMForceParallelPaths;
 #endif
 					
 					// generate all selfed, cloned, and autogamous offspring in one shared loop
@@ -2522,6 +2467,8 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 						{
 							EIDOS_BENCHMARK_START(EidosBenchmarkType::k_WF_REPRO);
 							EIDOS_THREAD_COUNT(gEidos_OMP_threads_WF_REPRO);
+							if (buffer_tree_seq)
+								species_.BeginParallelTreeSeqRecording(base_pedigree_id, migrants_to_generate);
 #pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, migrants_to_generate, base_child_count, base_pedigree_id, pedigrees_enabled, p_subpop, source_subpop, child_sex, prevent_incidental_selfing) if(will_parallelize) num_threads(thread_count)
 							{
 								Eidos_RNG_State *parallel_rng_state = EIDOS_STATE_RNG(omp_get_thread_num());
@@ -2540,6 +2487,8 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 									new_child->migrant_ = (&source_subpop != &p_subpop);
 								}
 							}
+							if (buffer_tree_seq)
+								species_.EndParallelTreeSeqRecording();
 							EIDOS_BENCHMARK_END(EidosBenchmarkType::k_WF_REPRO);
 							
 							child_count += migrants_to_generate;
@@ -2548,6 +2497,8 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 						{
 							EIDOS_BENCHMARK_START(EidosBenchmarkType::k_WF_REPRO);
 							EIDOS_THREAD_COUNT(gEidos_OMP_threads_WF_REPRO);
+							if (buffer_tree_seq)
+								species_.BeginParallelTreeSeqRecording(base_pedigree_id, migrants_to_generate);
 #pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, migrants_to_generate, base_child_count, base_pedigree_id, pedigrees_enabled, p_subpop, source_subpop, child_sex, prevent_incidental_selfing) if(will_parallelize) num_threads(thread_count)
 							{
 								Eidos_RNG_State *parallel_rng_state = EIDOS_STATE_RNG(omp_get_thread_num());
@@ -2569,6 +2520,8 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 									(p_subpop.*MungeIndividualCrossed_TEMPLATED)(new_child, base_pedigree_id + migrant_count, source_subpop.parent_individuals_[parent1], source_subpop.parent_individuals_[parent2], child_sex);
 								}
 							}
+							if (buffer_tree_seq)
+								species_.EndParallelTreeSeqRecording();
 							EIDOS_BENCHMARK_END(EidosBenchmarkType::k_WF_REPRO);
 							
 							child_count += migrants_to_generate;
@@ -2579,6 +2532,8 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 						// the full loop with support for selfing/cloning (but no callbacks, since we're in that overall branch)
 						EIDOS_BENCHMARK_START(EidosBenchmarkType::k_WF_REPRO);
 						EIDOS_THREAD_COUNT(gEidos_OMP_threads_WF_REPRO);
+						if (buffer_tree_seq)
+							species_.BeginParallelTreeSeqRecording(base_pedigree_id, migrants_to_generate);
 #pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, migrants_to_generate, number_to_clone, number_to_self, base_child_count, base_pedigree_id, pedigrees_enabled, p_subpop, source_subpop, sex_enabled, child_sex, recording_tree_sequence, prevent_incidental_selfing) if(will_parallelize) num_threads(thread_count)
 						{
 							Eidos_RNG_State *parallel_rng_state = EIDOS_STATE_RNG(omp_get_thread_num());
@@ -2638,20 +2593,13 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 								}
 							}
 						}
+						if (buffer_tree_seq)
+							species_.EndParallelTreeSeqRecording();
 						EIDOS_BENCHMARK_END(EidosBenchmarkType::k_WF_REPRO);
 						
 						child_count += migrants_to_generate;
 					}
 					
-#ifdef _OPENMP
-					//if (will_parallelize)
-					//{
-					//	size_t actual_mutation_block_slots_remaining_POST = SLiMMemoryUsageForFreeMutations() / sizeof(Mutation);
-					//	
-					//	std::cerr << "   after reproduction, " << actual_mutation_block_slots_remaining_POST << " actual slots remaining" << std::endl;
-					//	std::cerr << "   actual demand for new mutations was " << (actual_mutation_block_slots_remaining_PRE - actual_mutation_block_slots_remaining_POST) << " (" << est_slots_needed << " was estimated)" << std::endl;
-					//}
-#endif
 				}
 			}
 		}
@@ -2981,6 +2929,11 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 		}
 	}
 	
+#if SLIM_INTERN_NEW_MUTATION_RUNS
+	// bit (i % 64) is set for each run index i that might receive a new mutation; see InternChildMutationRuns()
+	uint64_t new_mutation_run_mask = 0;
+#endif
+	
 	// mutations are usually rare, so let's streamline the case where none occur
 	if (num_mutations == 0)
 	{
@@ -3000,14 +2953,14 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 			
 			Mutation *mut_block_ptr = gSLiM_Mutation_Block;
 			Haplosome *parent_haplosome = parent_haplosome_1;
-			slim_position_t mutrun_length = p_child_haplosome.mutrun_length_;
+			const MutationRunLayout &mutrun_layout = *p_child_haplosome.mutrun_layout_;
 			int mutrun_count = p_child_haplosome.mutrun_count_;
 			int first_uncompleted_mutrun = 0;
 			
 			for (int break_index = 0; break_index < breakpoints_count; break_index++)
 			{
 				slim_position_t breakpoint = breakpoints_ptr[break_index];
-				slim_mutrun_index_t break_mutrun_index = (slim_mutrun_index_t)(breakpoint / mutrun_length);
+				slim_mutrun_index_t break_mutrun_index = mutrun_layout.RunIndexForPosition(breakpoint);
 				
 				// Copy over mutation runs until we arrive at the run in which the breakpoint occurs
 				while (break_mutrun_index > first_uncompleted_mutrun)
@@ -3024,7 +2977,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 					break;
 				
 				// The break occurs to the left of the base position of the breakpoint; check whether that is between runs
-				if (breakpoint > break_mutrun_index * mutrun_length)
+				if (breakpoint > mutrun_layout.RunStart(break_mutrun_index))
 				{
 					// The breakpoint occurs *inside* the run, so process the run by copying mutations and switching strands
 					int this_mutrun_index = first_uncompleted_mutrun;
@@ -3071,7 +3024,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 						
 						// otherwise, figure out the new breakpoint, and continue looping on the current mutation run, which needs to be finished
 						breakpoint = breakpoints_ptr[break_index];
-						break_mutrun_index = (slim_mutrun_index_t)(breakpoint / mutrun_length);
+						break_mutrun_index = mutrun_layout.RunIndexForPosition(breakpoint);
 						
 						// if the next breakpoint is outside this mutation run, then finish the run and break out
 						if (break_mutrun_index > this_mutrun_index)
@@ -3114,6 +3067,11 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 		
 		num_mutations = p_chromosome.DrawSortedUniquedMutationPositions(num_mutations, parent_sex, mut_positions);
 		
+#if SLIM_INTERN_NEW_MUTATION_RUNS
+		for (auto &mut_position : mut_positions)
+			new_mutation_run_mask |= (uint64_t)1 << (p_child_haplosome.mutrun_layout_->RunIndexForPosition(mut_position.first) & 63);
+#endif
+		
 		// Create vector with the mutations to be added
 #if defined(__GNUC__) && !defined(__clang__)
 		// Work around GCC bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=27557
@@ -3200,9 +3158,9 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 			mutation_iter_pos = SLIM_INF_BASE_POSITION;
 		}
 		
-		slim_position_t mutrun_length = p_child_haplosome.mutrun_length_;
+		const MutationRunLayout &mutrun_layout = *p_child_haplosome.mutrun_layout_;
 		int mutrun_count = p_child_haplosome.mutrun_count_;
-		slim_mutrun_index_t mutation_mutrun_index = (slim_mutrun_index_t)(mutation_iter_pos / mutrun_length);
+		slim_mutrun_index_t mutation_mutrun_index = mutrun_layout.RunIndexForPosition(mutation_iter_pos);
 		
 		Haplosome *parent_haplosome = parent_haplosome_1;
 		int first_uncompleted_mutrun = 0;
@@ -3294,7 +3252,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 						mutation_iter_pos = SLIM_INF_BASE_POSITION;
 					}
 					
-					mutation_mutrun_index = (slim_mutrun_index_t)(mutation_iter_pos / mutrun_length);
+					mutation_mutrun_index = mutrun_layout.RunIndexForPosition(mutation_iter_pos);
 				}
 				while (mutation_mutrun_index == this_mutrun_index);
 				
@@ -3317,7 +3275,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 			
 			int break_index = 0;
 			slim_position_t breakpoint = breakpoints_ptr[break_index];
-			slim_mutrun_index_t break_mutrun_index = (slim_mutrun_index_t)(breakpoint / mutrun_length);
+			slim_mutrun_index_t break_mutrun_index = mutrun_layout.RunIndexForPosition(breakpoint);
 			
 			while (true)	// loop over breakpoints until we have handled the last one, which comes at the end
 			{
@@ -3351,7 +3309,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 						break;
 					
 					// If the breakpoint occurs *between* runs, just switch parent strands and the breakpoint is handled
-					if (breakpoint == break_mutrun_index * mutrun_length)
+					if (breakpoint == mutrun_layout.RunStart(break_mutrun_index))
 					{
 						parent_haplosome_1 = parent_haplosome_2;
 						parent_haplosome_2 = parent_haplosome;
@@ -3362,7 +3320,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 							break;
 						
 						breakpoint = breakpoints_ptr[break_index];
-						break_mutrun_index = (slim_mutrun_index_t)(breakpoint / mutrun_length);
+						break_mutrun_index = mutrun_layout.RunIndexForPosition(breakpoint);
 						
 						continue;
 					}
@@ -3444,7 +3402,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 										mutation_iter_pos = SLIM_INF_BASE_POSITION;
 									}
 									
-									mutation_mutrun_index = (slim_mutrun_index_t)(mutation_iter_pos / mutrun_length);
+									mutation_mutrun_index = mutrun_layout.RunIndexForPosition(mutation_iter_pos);
 								}
 								
 								// add the old mutation; no need to check for a duplicate here since the parental haplosome is already duplicate-free
@@ -3498,7 +3456,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 									mutation_iter_pos = SLIM_INF_BASE_POSITION;
 								}
 								
-								mutation_mutrun_index = (slim_mutrun_index_t)(mutation_iter_pos / mutrun_length);
+								mutation_mutrun_index = mutrun_layout.RunIndexForPosition(mutation_iter_pos);
 							}
 							
 							// we have finished the parental mutation run; if the breakpoint we are now working toward lies beyond the end of the
@@ -3521,7 +3479,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 							
 							// otherwise, figure out the new breakpoint, and continue looping on the current mutation run, which needs to be finished
 							breakpoint = breakpoints_ptr[break_index];
-							break_mutrun_index = (slim_mutrun_index_t)(breakpoint / mutrun_length);
+							break_mutrun_index = mutrun_layout.RunIndexForPosition(breakpoint);
 						}
 						
 						// if we just handled the last breakpoint, which is guaranteed to be at or beyond lastPosition+1, then we are done
@@ -3568,7 +3526,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 							
 							// otherwise, figure out the new breakpoint, and continue looping on the current mutation run, which needs to be finished
 							breakpoint = breakpoints_ptr[break_index];
-							break_mutrun_index = (slim_mutrun_index_t)(breakpoint / mutrun_length);
+							break_mutrun_index = mutrun_layout.RunIndexForPosition(breakpoint);
 							
 							// if the next breakpoint is outside this mutation run, then finish the run and break out
 							if (break_mutrun_index > this_mutrun_index)
@@ -3653,7 +3611,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 							mutation_iter_pos = SLIM_INF_BASE_POSITION;
 						}
 						
-						mutation_mutrun_index = (slim_mutrun_index_t)(mutation_iter_pos / mutrun_length);
+						mutation_mutrun_index = mutrun_layout.RunIndexForPosition(mutation_iter_pos);
 					}
 					while (mutation_mutrun_index == this_mutrun_index);
 					
@@ -3681,6 +3639,12 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 	
 	if (heteroduplex.size() > 0)
 		DoHeteroduplexRepair(heteroduplex, breakpoints_ptr, breakpoints_count, parent_haplosome_1, parent_haplosome_2, &p_child_haplosome);
+	
+#if SLIM_INTERN_NEW_MUTATION_RUNS
+	// the last breakpoint is always past the end of the chromosome, so with only one there is nothing to intern
+	if (breakpoints_count > 1)
+		InternChildMutationRuns(p_chromosome, p_child_haplosome, parent_haplosome_1, parent_haplosome_2, breakpoints_ptr, breakpoints_count, new_mutation_run_mask);
+#endif
 }
 
 template void Population::HaplosomeCrossed<false, false>(Chromosome &p_chromosome, Haplosome &p_child_haplosome, Haplosome *parent_haplosome_1, Haplosome *parent_haplosome_2, std::vector<SLiMEidosBlock*> *p_recombination_callbacks, std::vector<SLiMEidosBlock*> *p_mutation_callbacks);
@@ -3839,13 +3803,13 @@ void Population::HaplosomeCloned(Chromosome &p_chromosome, Haplosome &p_child_ha
 		Mutation *mut_block_ptr = gSLiM_Mutation_Block;
 		
 		int mutrun_count = p_child_haplosome.mutrun_count_;
-		slim_position_t mutrun_length = p_child_haplosome.mutrun_length_;
+		const MutationRunLayout &mutrun_layout = *p_child_haplosome.mutrun_layout_;
 		
 		const MutationIndex *mutation_iter		= mutations_to_add.data();
 		const MutationIndex *mutation_iter_max	= mutation_iter + mutations_to_add.size();
 		MutationIndex mutation_iter_mutation_index = *mutation_iter;
 		slim_position_t mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
-		slim_mutrun_index_t mutation_iter_mutrun_index = (slim_mutrun_index_t)(mutation_iter_pos / mutrun_length);
+		slim_mutrun_index_t mutation_iter_mutrun_index = mutrun_layout.RunIndexForPosition(mutation_iter_pos);
 		
 		for (int run_index = 0; run_index < mutrun_count; ++run_index)
 		{
@@ -3930,7 +3894,7 @@ void Population::HaplosomeCloned(Chromosome &p_chromosome, Haplosome &p_child_ha
 							mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
 						}
 						
-						mutation_iter_mutrun_index = (slim_mutrun_index_t)(mutation_iter_pos / mutrun_length);
+						mutation_iter_mutrun_index = mutrun_layout.RunIndexForPosition(mutation_iter_pos);
 						
 						// if we're out of new mutations for this run, transfer down to the simpler loop below
 						if (mutation_iter_mutrun_index != run_index)
@@ -4040,6 +4004,11 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 		}
 	}
 	
+#if SLIM_INTERN_NEW_MUTATION_RUNS
+	// bit (i % 64) is set for each run index i that might receive a new mutation; see InternChildMutationRuns()
+	uint64_t new_mutation_run_mask = 0;
+#endif
+	
 	// mutations are usually rare, so let's streamline the case where none occur
 	if (num_mutations == 0)
 	{
@@ -4049,14 +4018,14 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 		
 		Mutation *mut_block_ptr = gSLiM_Mutation_Block;
 		Haplosome *parent_haplosome = parent_haplosome_1;
-		slim_position_t mutrun_length = p_child_haplosome.mutrun_length_;
+		const MutationRunLayout &mutrun_layout = *p_child_haplosome.mutrun_layout_;
 		int mutrun_count = p_child_haplosome.mutrun_count_;
 		int first_uncompleted_mutrun = 0;
 		
 		for (int break_index = 0; break_index < breakpoints_count; break_index++)
 		{
 			slim_position_t breakpoint = breakpoints_ptr[break_index];
-			slim_mutrun_index_t break_mutrun_index = (slim_mutrun_index_t)(breakpoint / mutrun_length);
+			slim_mutrun_index_t break_mutrun_index = mutrun_layout.RunIndexForPosition(breakpoint);
 			
 			// Copy over mutation runs until we arrive at the run in which the breakpoint occurs
 			while (break_mutrun_index > first_uncompleted_mutrun)
@@ -4073,7 +4042,7 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 				break;
 			
 			// The break occurs to the left of the base position of the breakpoint; check whether that is between runs
-			if (breakpoint > break_mutrun_index * mutrun_length)
+			if (breakpoint > mutrun_layout.RunStart(break_mutrun_index))
 			{
 				// The breakpoint occurs *inside* the run, so process the run by copying mutations and switching strands
 				int this_mutrun_index = first_uncompleted_mutrun;
@@ -4120,7 +4089,7 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 					
 					// otherwise, figure out the new breakpoint, and continue looping on the current mutation run, which needs to be finished
 					breakpoint = breakpoints_ptr[break_index];
-					break_mutrun_index = (slim_mutrun_index_t)(breakpoint / mutrun_length);
+					break_mutrun_index = mutrun_layout.RunIndexForPosition(breakpoint);
 					
 					// if the next breakpoint is outside this mutation run, then finish the run and break out
 					if (break_mutrun_index > this_mutrun_index)
@@ -4162,6 +4131,11 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 		
 		num_mutations = p_chromosome.DrawSortedUniquedMutationPositions(num_mutations, parent_sex, mut_positions);
 		
+#if SLIM_INTERN_NEW_MUTATION_RUNS
+		for (auto &mut_position : mut_positions)
+			new_mutation_run_mask |= (uint64_t)1 << (p_child_haplosome.mutrun_layout_->RunIndexForPosition(mut_position.first) & 63);
+#endif
+		
 		// Create vector with the mutations to be added
 #if defined(__GNUC__) && !defined(__clang__)
 		// Work around GCC bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=27557
@@ -4244,9 +4218,9 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 			mutation_iter_pos = SLIM_INF_BASE_POSITION;
 		}
 		
-		slim_position_t mutrun_length = p_child_haplosome.mutrun_length_;
+		const MutationRunLayout &mutrun_layout = *p_child_haplosome.mutrun_layout_;
 		int mutrun_count = p_child_haplosome.mutrun_count_;
-		slim_mutrun_index_t mutation_mutrun_index = (slim_mutrun_index_t)(mutation_iter_pos / mutrun_length);
+		slim_mutrun_index_t mutation_mutrun_index = mutrun_layout.RunIndexForPosition(mutation_iter_pos);
 		
 		Haplosome *parent_haplosome = parent_haplosome_1;
 		int first_uncompleted_mutrun = 0;
@@ -4256,7 +4230,7 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 		//
 		int break_index = 0;
 		slim_position_t breakpoint = breakpoints_ptr[break_index];
-		slim_mutrun_index_t break_mutrun_index = (slim_mutrun_index_t)(breakpoint / mutrun_length);
+		slim_mutrun_index_t break_mutrun_index = mutrun_layout.RunIndexForPosition(breakpoint);
 		
 		while (true)	// loop over breakpoints until we have handled the last one, which comes at the end
 		{
@@ -4290,7 +4264,7 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 					break;
 				
 				// If the breakpoint occurs *between* runs, just switch parent strands and the breakpoint is handled
-				if (breakpoint == break_mutrun_index * mutrun_length)
+				if (breakpoint == mutrun_layout.RunStart(break_mutrun_index))
 				{
 					parent_haplosome_1 = parent_haplosome_2;
 					parent_haplosome_2 = parent_haplosome;
@@ -4301,7 +4275,7 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 						break;
 					
 					breakpoint = breakpoints_ptr[break_index];
-					break_mutrun_index = (slim_mutrun_index_t)(breakpoint / mutrun_length);
+					break_mutrun_index = mutrun_layout.RunIndexForPosition(breakpoint);
 					
 					continue;
 				}
@@ -4383,7 +4357,7 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 									mutation_iter_pos = SLIM_INF_BASE_POSITION;
 								}
 								
-								mutation_mutrun_index = (slim_mutrun_index_t)(mutation_iter_pos / mutrun_length);
+								mutation_mutrun_index = mutrun_layout.RunIndexForPosition(mutation_iter_pos);
 							}
 							
 							// add the old mutation; no need to check for a duplicate here since the parental haplosome is already duplicate-free
@@ -4437,7 +4411,7 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 								mutation_iter_pos = SLIM_INF_BASE_POSITION;
 							}
 							
-							mutation_mutrun_index = (slim_mutrun_index_t)(mutation_iter_pos / mutrun_length);
+							mutation_mutrun_index = mutrun_layout.RunIndexForPosition(mutation_iter_pos);
 						}
 						
 						// we have finished the parental mutation run; if the breakpoint we are now working toward lies beyond the end of the
@@ -4460,7 +4434,7 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 						
 						// otherwise, figure out the new breakpoint, and continue looping on the current mutation run, which needs to be finished
 						breakpoint = breakpoints_ptr[break_index];
-						break_mutrun_index = (slim_mutrun_index_t)(breakpoint / mutrun_length);
+						break_mutrun_index = mutrun_layout.RunIndexForPosition(breakpoint);
 					}
 					
 					// if we just handled the last breakpoint, which is guaranteed to be at or beyond lastPosition+1, then we are done
@@ -4507,7 +4481,7 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 						
 						// otherwise, figure out the new breakpoint, and continue looping on the current mutation run, which needs to be finished
 						breakpoint = breakpoints_ptr[break_index];
-						break_mutrun_index = (slim_mutrun_index_t)(breakpoint / mutrun_length);
+						break_mutrun_index = mutrun_layout.RunIndexForPosition(breakpoint);
 						
 						// if the next breakpoint is outside this mutation run, then finish the run and break out
 						if (break_mutrun_index > this_mutrun_index)
@@ -4592,7 +4566,7 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 						mutation_iter_pos = SLIM_INF_BASE_POSITION;
 					}
 					
-					mutation_mutrun_index = (slim_mutrun_index_t)(mutation_iter_pos / mutrun_length);
+					mutation_mutrun_index = mutrun_layout.RunIndexForPosition(mutation_iter_pos);
 				}
 				while (mutation_mutrun_index == this_mutrun_index);
 				
@@ -4616,6 +4590,12 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 		if (child_haplosome.mutruns_[i].get() == nullptr)
 			EIDOS_TERMINATION << "ERROR (Population::HaplosomeRecombined): (internal error) null mutation run left at end of recombination-mutation." << EidosTerminate();
 #endif
+	
+#if SLIM_INTERN_NEW_MUTATION_RUNS
+	// the last breakpoint is always past the end of the chromosome, so with only one there is nothing to intern
+	if (breakpoints_count > 1)
+		InternChildMutationRuns(p_chromosome, p_child_haplosome, parent_haplosome_1, parent_haplosome_2, breakpoints_ptr, breakpoints_count, new_mutation_run_mask);
+#endif
 }
 
 template void Population::HaplosomeRecombined<false, false>(Chromosome &p_chromosome, Haplosome &p_child_haplosome, Haplosome *parent_haplosome_1, Haplosome *parent_haplosome_2, std::vector<slim_position_t> &p_breakpoints, std::vector<SLiMEidosBlock*> *p_mutation_callbacks);
@@ -4906,13 +4886,13 @@ void Population::DoHeteroduplexRepair(std::vector<slim_position_t> &p_heterodupl
 		// mutations to be added or removed we make a new mutation run and effect the changes
 		// as we copy mutations over.  Mutruns without changes are left untouched.
 		Mutation *mut_block_ptr = gSLiM_Mutation_Block;
-		slim_position_t mutrun_length = p_child_haplosome->mutrun_length_;
+		const MutationRunLayout &mutrun_layout = *p_child_haplosome->mutrun_layout_;
 		slim_position_t mutrun_count = p_child_haplosome->mutrun_count_;
 		std::size_t removal_index = 0, addition_index = 0;
 		slim_position_t next_removal_pos = (removal_index < repair_removals.size()) ? repair_removals[removal_index] : SLIM_INF_BASE_POSITION;
 		slim_position_t next_addition_pos = (addition_index < repair_additions.size()) ? repair_additions[addition_index]->position_ : SLIM_INF_BASE_POSITION;
-		slim_mutrun_index_t next_removal_mutrun_index = (slim_mutrun_index_t)(next_removal_pos / mutrun_length);
-		slim_mutrun_index_t next_addition_mutrun_index = (slim_mutrun_index_t)(next_addition_pos / mutrun_length);
+		slim_mutrun_index_t next_removal_mutrun_index = mutrun_layout.RunIndexForPosition(next_removal_pos);
+		slim_mutrun_index_t next_addition_mutrun_index = mutrun_layout.RunIndexForPosition(next_addition_pos);
 		slim_mutrun_index_t run_index = std::min(next_removal_mutrun_index, next_addition_mutrun_index);
 		
 		while (run_index < mutrun_count)
@@ -4958,15 +4938,15 @@ void Population::DoHeteroduplexRepair(std::vector<slim_position_t> &p_heterodupl
 			}
 			
 			// update the mutrun indexes; we don't do this above to avoid lots of redundant division
-			next_removal_mutrun_index = (slim_mutrun_index_t)(next_removal_pos / mutrun_length);
-			next_addition_mutrun_index = (slim_mutrun_index_t)(next_addition_pos / mutrun_length);
+			next_removal_mutrun_index = mutrun_layout.RunIndexForPosition(next_removal_pos);
+			next_addition_mutrun_index = mutrun_layout.RunIndexForPosition(next_addition_pos);
 			
 			// if there are any removal positions left in this mutrun, they have been handled above
 			while (next_removal_mutrun_index == run_index)
 			{
 				removal_index++;
 				next_removal_pos = (removal_index < repair_removals.size()) ? repair_removals[removal_index] : SLIM_INF_BASE_POSITION;
-				next_removal_mutrun_index = (slim_mutrun_index_t)(next_removal_pos / mutrun_length);
+				next_removal_mutrun_index = mutrun_layout.RunIndexForPosition(next_removal_pos);
 			}
 			
 			// if there are addition mutations left in this mutrun, they must go after the end of the old mutrun's mutations
@@ -4979,7 +4959,7 @@ void Population::DoHeteroduplexRepair(std::vector<slim_position_t> &p_heterodupl
 				
 				addition_index++;
 				next_addition_pos = (addition_index < repair_additions.size()) ? repair_additions[addition_index]->position_ : SLIM_INF_BASE_POSITION;
-				next_addition_mutrun_index = (slim_mutrun_index_t)(next_addition_pos / mutrun_length);
+				next_addition_mutrun_index = mutrun_layout.RunIndexForPosition(next_addition_pos);
 			}
 			
 			// replace the mutation run at run_index with the newly constructed run that has all additions and removals
@@ -5012,6 +4992,65 @@ void Population::DoHeteroduplexRepair(std::vector<slim_position_t> &p_heterodupl
 	}
 }
 
+#if SLIM_INTERN_NEW_MUTATION_RUNS
+void Population::InternChildMutationRuns(Chromosome &p_chromosome, Haplosome &p_child_haplosome, const Haplosome *p_parent_haplosome_1, const Haplosome *p_parent_haplosome_2, const slim_position_t *p_breakpoints, int p_breakpoints_count, uint64_t p_skip_run_mask)
+{
+	// This is called at the end of HaplosomeCrossed() and HaplosomeRecombined(), once the child's runs are final, and may be called
+	// in parallel.  Runs copied from a parent are already shared; apart from runs that received a new mutation, which can't be
+	// duplicates, the only runs created for the child are those that contain a breakpoint, so those are the only runs we look at.
+	// We walk them from the end backwards, so that duplicates are most likely to still be at the end of their in-use pool and can
+	// be returned to the free pool at once by FreeNewMutationRun_LOCKED(); that keeps the free pool warm for the next child.
+	const MutationRunLayout &mutrun_layout = *p_child_haplosome.mutrun_layout_;
+	slim_mutrun_index_t mutrun_count = p_child_haplosome.mutrun_count_;
+	const MutationRun **child_runs = p_child_haplosome.mutruns_;
+	const MutationRun **parent_runs_1 = p_parent_haplosome_1->mutruns_;
+	const MutationRun **parent_runs_2 = p_parent_haplosome_2->mutruns_;
+	slim_mutrun_index_t previous_run_index = -1;
+	
+	for (int breakpoint_index = p_breakpoints_count - 1; breakpoint_index >= 0; --breakpoint_index)
+	{
+		slim_mutrun_index_t run_index = mutrun_layout.RunIndexForPosition(p_breakpoints[breakpoint_index]);
+		
+		// the final breakpoint is past the end of the chromosome, and several breakpoints can fall in one run
+		if ((run_index >= mutrun_count) || (run_index == previous_run_index))
+			continue;
+		
+		previous_run_index = run_index;
+		
+		if (p_skip_run_mask & ((uint64_t)1 << (run_index & 63)))
+			continue;
+		
+		const MutationRun *child_run = child_runs[run_index];
+		const MutationRun *parent_run_1 = parent_runs_1[run_index];
+		const MutationRun *parent_run_2 = parent_runs_2[run_index];
+		
+		if ((child_run == parent_run_1) || (child_run == parent_run_2))
+			continue;
+		
+		// A crossover inside a run often reproduces one of the parental runs exactly, such as when the two parental runs differ
+		// only on one side of the breakpoint; this also catches empty runs, which we don't want to put into the intern table
+		// since identical empty runs can exist at different run indices, unlike nonempty identical runs
+		MutationRunContext &mutrun_context = p_chromosome.ChromosomeMutationRunContextForMutationRunIndex(run_index);
+		const MutationRun *canonical_run;
+		
+		if (parent_run_1->Identical(*child_run))
+			canonical_run = parent_run_1;
+		else if (parent_run_2->Identical(*child_run))
+			canonical_run = parent_run_2;
+		else if (child_run->size() == 0)
+			continue;
+		else
+			canonical_run = MutationRun::InternMutationRun(child_run, mutrun_context);
+		
+		if (canonical_run != child_run)
+		{
+			child_runs[run_index] = canonical_run;
+			MutationRun::FreeNewMutationRun_LOCKED(child_run, mutrun_context);
+		}
+	}
+}
+#endif
+
 #ifdef SLIMGUI
 void Population::RecordFitness(slim_tick_t p_history_index, slim_objectid_t p_subpop_id, double p_fitness_value)
 {
@@ -5211,6 +5250,196 @@ void Population::ValidateMutationFitnessCaches(void)
 	}
 }
 
+bool Population::ShouldPrecomputeChromosomalFitness(void)
+{
+	// Precomputation is only for the case in which UpdateFitness() would loop over chromosomes calling FitnessOfParent() for each
+	// individual; pure neutral models skip that, and mutation run experiments need to time that loop, so they are excluded
+	if (species_.pure_neutral_ || species_.DoingAnyMutationRunExperiments() || (species_.Chromosomes().size() == 0))
+		return false;
+	
+	// The self-tests force precomputation, so that it is tested even in single-threaded builds
+	if (gSLiMForceParallelPaths)
+		return true;
+	
+#ifdef _OPENMP
+	// With only one subpopulation and one chromosome, UpdateFitness() can parallelize its own loop over individuals just as well
+	if ((subpops_.size() < 2) && (species_.Chromosomes().size() < 2))
+		return false;
+	
+	int64_t total_individual_count = 0;
+	
+	for (std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)
+		total_individual_count += subpop_pair.second->parent_subpop_size_;
+	
+	return (total_individual_count >= EIDOS_OMPMIN_FITNESS_SUBPOPS);
+#else
+	return false;
+#endif
+}
+
+#if (defined(_OPENMP) && SLIM_USE_NONNEUTRAL_CACHES)
+void Population::FixNonNeutralCaches_OMP(void)
+{
+	// This is the species-wide counterpart of Subpopulation::FixNonNeutralCaches_OMP(), used by PrecomputeChromosomalFitness().
+	// Mutation runs are shared across subpopulations, so all of their caches must be valid before fitness evaluation goes parallel.
+	// This is task-based; note the top-level parallel is *not* a parallel for loop!
+	int32_t nonneutral_change_counter = species_.nonneutral_change_counter_;
+	int32_t nonneutral_regime = species_.last_nonneutral_regime_;
+	int haplosome_count_per_individual = species_.HaplosomeCountPerIndividual();
+	
+#pragma omp parallel default(none) shared(nonneutral_change_counter, nonneutral_regime, haplosome_count_per_individual)
+	{
+#pragma omp single
+		{
+			for (std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)
+			{
+				for (Individual *individual : subpop_pair.second->parent_individuals_)
+				{
+					for (int haplosome_index = 0; haplosome_index < haplosome_count_per_individual; haplosome_index++)
+					{
+						Haplosome *haplosome = individual->haplosomes_[haplosome_index];
+						const int32_t mutrun_count = haplosome->mutrun_count_;		// 0 for null haplosomes
+						
+						for (int run_index = 0; run_index < mutrun_count; ++run_index)
+						{
+							const MutationRun *mutrun = haplosome->mutruns_[run_index];
+							
+							// This will start a new task if the mutrun needs to validate
+							// its nonneutral cache.  It avoids doing so more than once.
+							mutrun->validate_nonneutral_cache(nonneutral_change_counter, nonneutral_regime);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+#endif
+
+void Population::PrecomputeChromosomalFitness(void)
+{
+	// This computes the chromosomal component of fitness -- the product of the fitness effects of all mutations carried, across all
+	// chromosomes -- for every parental individual in every subpopulation, and stashes it in cached_fitness_UNSAFE_ for UpdateFitness()
+	// to pick up; see Subpopulation::chromosomal_fitness_precomputed_.  The work is divided into tasks, each a block of individuals in
+	// one subpopulation for one chromosome, which are handed out to threads dynamically so that threads that finish early take on more
+	// work; this balances the load across subpopulations of very different sizes.  Individuals with a fitnessScaling of zero (or less)
+	// are skipped, as in UpdateFitness(), since they have a fitness of zero regardless.  No callbacks are active, so no Eidos code runs.
+	const std::vector<Chromosome *> &chromosomes = species_.Chromosomes();
+	const std::vector<int> &first_haplosome_indices = species_.FirstHaplosomeIndices();
+	int chromosome_count = (int)chromosomes.size();
+	
+	// Mutation fitness caches are validated for the whole species, so do that up front rather than in the first UpdateFitness() call
+	if (species_.any_dominance_coeff_changed_)
+	{
+		ValidateMutationFitnessCaches();
+		species_.any_dominance_coeff_changed_ = false;
+	}
+	
+#if (defined(_OPENMP) && SLIM_USE_NONNEUTRAL_CACHES)
+	FixNonNeutralCaches_OMP();
+#endif
+	
+	// Make the tasks; each task covers the individuals [first_index_, end_index_) in subpop_, for one chromosome
+	typedef struct {
+		Subpopulation *subpop_;
+		slim_popsize_t first_index_;
+		slim_popsize_t end_index_;
+		int chromosome_index_;
+		int64_t buffer_offset_;		// the index of first_index_ across all subpopulations, for chromosome_fitness
+	} FitnessTask;
+	
+	const slim_popsize_t task_block_size = 256;
+	std::vector<FitnessTask> tasks;
+	int64_t total_individual_count = 0;
+	
+	for (std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)
+	{
+		Subpopulation *subpop = subpop_pair.second;
+		slim_popsize_t subpop_size = subpop->parent_subpop_size_;
+		
+		for (slim_popsize_t first_index = 0; first_index < subpop_size; first_index += task_block_size)
+		{
+			slim_popsize_t end_index = std::min(first_index + task_block_size, subpop_size);
+			
+			for (int chromosome_index = 0; chromosome_index < chromosome_count; ++chromosome_index)
+				tasks.emplace_back(FitnessTask{subpop, first_index, end_index, chromosome_index, total_individual_count + first_index});
+		}
+		
+		total_individual_count += subpop_size;
+		subpop->chromosomal_fitness_precomputed_ = true;
+	}
+	
+	// With more than one chromosome, the per-chromosome fitness values go into a buffer, indexed by chromosome and then individual
+	std::vector<double> chromosome_fitness((chromosome_count > 1) ? (size_t)(total_individual_count * chromosome_count) : 0);
+	double *chromosome_fitness_data = chromosome_fitness.data();
+	FitnessTask *tasks_data = tasks.data();
+	int64_t task_count = (int64_t)tasks.size();
+	
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_FITNESS_SUBPOPS);
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(task_count, tasks_data, chromosomes, first_haplosome_indices, chromosome_count, total_individual_count, chromosome_fitness_data) num_threads(thread_count)
+	for (int64_t task_index = 0; task_index < task_count; ++task_index)
+	{
+		FitnessTask &task = tasks_data[task_index];
+		Subpopulation *subpop = task.subpop_;
+		Chromosome *chromosome = chromosomes[task.chromosome_index_];
+		int first_haplosome_index = first_haplosome_indices[task.chromosome_index_];
+		int64_t buffer_base = task.chromosome_index_ * total_individual_count + task.buffer_offset_ - task.first_index_;
+		
+		for (slim_popsize_t individual_index = task.first_index_; individual_index < task.end_index_; ++individual_index)
+		{
+			Individual *individual = subpop->parent_individuals_[individual_index];
+			
+			if (individual->fitness_scaling_ <= 0.0)
+				continue;
+			
+			double w = subpop->ChromosomeFitnessOfParent(individual, chromosome, first_haplosome_index);
+			
+			if (chromosome_count == 1)
+				individual->cached_fitness_UNSAFE_ = w;
+			else
+				chromosome_fitness_data[buffer_base + individual_index] = w;
+		}
+	}
+	
+	// Multiply the per-chromosome values together, in chromosome order exactly as FitnessOfParent() does; the tasks for each block
+	// of individuals are consecutive, one per chromosome, so we step through the blocks using the tasks for the first chromosome
+	if (chromosome_count > 1)
+	{
+		int64_t block_count = task_count / chromosome_count;
+		
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(block_count, tasks_data, chromosome_count, total_individual_count, chromosome_fitness_data) num_threads(thread_count)
+		for (int64_t block_index = 0; block_index < block_count; ++block_index)
+		{
+			FitnessTask &task = tasks_data[block_index * chromosome_count];
+			Subpopulation *subpop = task.subpop_;
+			
+			for (slim_popsize_t individual_index = task.first_index_; individual_index < task.end_index_; ++individual_index)
+			{
+				Individual *individual = subpop->parent_individuals_[individual_index];
+				
+				if (individual->fitness_scaling_ <= 0.0)
+					continue;
+				
+				int64_t buffer_index = task.buffer_offset_ + (individual_index - task.first_index_);
+				double w = 1.0;
+				
+				for (int chromosome_index = 0; chromosome_index < chromosome_count; ++chromosome_index)
+				{
+					w *= chromosome_fitness_data[chromosome_index * total_individual_count + buffer_index];
+					
+					if (w <= 0.0)
+					{
+						w = 0.0;
+						break;
+					}
+				}
+				
+				individual->cached_fitness_UNSAFE_ = w;
+			}
+		}
+	}
+}
+
 void Population::RecalculateFitness(slim_tick_t p_tick)
 {
 	// calculate the fitnesses of the parents and make lookup tables; the main thing we do here is manage the mutationEffect() callbacks
@@ -5399,6 +5628,11 @@ void Population::RecalculateFitness(slim_tick_t p_tick)
 	{
 		std::vector<SLiMEidosBlock*> no_callbacks;
 		
+		// UpdateFitness() parallelizes only within a subpopulation; with many subpopulations (or chromosomes), do the heavy lifting
+		// for all of them in one parallel pass first, and UpdateFitness() will then just use the results
+		if (ShouldPrecomputeChromosomalFitness())
+			PrecomputeChromosomalFitness();
+		
 		for (std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)
 			subpop_pair.second->UpdateFitness(no_callbacks, no_callbacks);
 	}
@@ -5681,9 +5915,31 @@ void Population::UniqueMutationRuns(void)
 		EIDOS_TERMINATION << "ERROR (Population::UniqueMutationRuns): (internal error) bookkeeping error in mutation run uniquing." << EidosTerminate();
 }
 
+void Population::PackMutationRuns(void)
+{
+	// This packs every in-use mutation run that is long enough, and frees the plain buffers of runs that were packed
+	// previously but have been unpacked since by a reader; see MutationRun::PackMutations().  It must be called when
+	// nobody holds pointers into mutation run buffers, which is true at the end of the tick when this is called.
+	THREAD_SAFETY_IN_ANY_PARALLEL("Population::PackMutationRuns(): mutation run buffers are freed");
+	
+	for (Chromosome *chromosome : species_.Chromosomes())
+	{
+		int mutrun_context_count = chromosome->ChromosomeMutationRunContextCount();
+		
+		for (int context_index = 0; context_index < mutrun_context_count; ++context_index)
+		{
+			MutationRunContext &mutrun_context = chromosome->ChromosomeMutationRunContextForThread(context_index);
+			
+			for (const MutationRun *mutrun : mutrun_context.in_use_pool_)
+				mutrun->PackMutations();
+		}
+	}
+}
+
 #ifndef __clang_analyzer__
-void Population::SplitMutationRunsForChromosome(int32_t p_new_mutrun_count, Chromosome *p_chromosome)
+void Population::SplitMutationRunsForChromosome(const MutationRunLayout &p_new_layout, Chromosome *p_chromosome)
 {
+	// The new layout must divide each existing run into two new runs; the chromosome will adopt it once we have finished.
 	// Note this method assumes that mutation run refcounts are correct; we enforce that here
 	TallyMutationRunReferencesForPopulationForChromosome(p_chromosome);
 	
@@ -5708,16 +5964,13 @@ void Population::SplitMutationRunsForChromosome(int32_t p_new_mutrun_count, Chro
 					if (!haplosome->IsNull())
 					{
 						int32_t old_mutrun_count = haplosome->mutrun_count_;
-						slim_position_t old_mutrun_length = haplosome->mutrun_length_;
 						int32_t new_mutrun_count = old_mutrun_count << 1;
-						slim_position_t new_mutrun_length = old_mutrun_length >> 1;
 						
 						if (haplosome->mutruns_ != haplosome->run_buffer_)
 							free(haplosome->mutruns_);
 						haplosome->mutruns_ = nullptr;
 						
 						haplosome->mutrun_count_ = new_mutrun_count;
-						haplosome->mutrun_length_ = new_mutrun_length;
 						
 						if (new_mutrun_count <= SLIM_HAPLOSOME_MUTRUN_BUFSIZE)
 						{
@@ -5752,7 +6005,7 @@ void Population::SplitMutationRunsForChromosome(int32_t p_new_mutrun_count, Chro
 #endif
 	
 	int mutruns_buf_index;
-	const MutationRun **mutruns_buf = (const MutationRun **)calloc(p_new_mutrun_count, sizeof(const MutationRun *));
+	const MutationRun **mutruns_buf = (const MutationRun **)calloc(p_new_layout.run_count_, sizeof(const MutationRun *));
 	
 	if (!mutruns_buf)
 		EIDOS_TERMINATION << "ERROR (Population::SplitMutationRuns): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
@@ -5774,9 +6027,7 @@ void Population::SplitMutationRunsForChromosome(int32_t p_new_mutrun_count, Chro
 					if (!haplosome->IsNull())
 					{
 						int32_t old_mutrun_count = haplosome->mutrun_count_;
-						slim_position_t old_mutrun_length = haplosome->mutrun_length_;
 						int32_t new_mutrun_count = old_mutrun_count << 1;
-						slim_position_t new_mutrun_length = old_mutrun_length >> 1;
 						
 						// for every mutation run, fill up mutrun_buf with entries
 						mutruns_buf_index = 0;
@@ -5792,7 +6043,7 @@ void Population::SplitMutationRunsForChromosome(int32_t p_new_mutrun_count, Chro
 								// checking use_count() this way is only safe because we run directly after tallying!
 								MutationRun *first_half, *second_half;
 								
-								mutrun->split_run(&first_half, &second_half, new_mutrun_length * (mutruns_buf_index + 1), mutrun_context);
+								mutrun->split_run(&first_half, &second_half, p_new_layout.RunStart(mutruns_buf_index + 1), mutrun_context);
 								
 								mutruns_buf[mutruns_buf_index++] = first_half;
 								mutruns_buf[mutruns_buf_index++] = second_half;
@@ -5817,7 +6068,7 @@ void Population::SplitMutationRunsForChromosome(int32_t p_new_mutrun_count, Chro
 									// it was not in the map, so make the new runs, and insert them into the map
 									MutationRun *first_half, *second_half;
 									
-									mutrun->split_run(&first_half, &second_half, new_mutrun_length * (mutruns_buf_index + 1), mutrun_context);
+									mutrun->split_run(&first_half, &second_half, p_new_layout.RunStart(mutruns_buf_index + 1), mutrun_context);
 									
 									mutruns_buf[mutruns_buf_index++] = first_half;
 									mutruns_buf[mutruns_buf_index++] = second_half;
@@ -5833,7 +6084,6 @@ void Population::SplitMutationRunsForChromosome(int32_t p_new_mutrun_count, Chro
 						haplosome->mutruns_ = nullptr;
 						
 						haplosome->mutrun_count_ = new_mutrun_count;
-						haplosome->mutrun_length_ = new_mutrun_length;
 						
 						if (new_mutrun_count <= SLIM_HAPLOSOME_MUTRUN_BUFSIZE)
 							haplosome->mutruns_ = haplosome->run_buffer_;
@@ -5856,7 +6106,7 @@ void Population::SplitMutationRunsForChromosome(int32_t p_new_mutrun_count, Chro
 }
 #else
 // the static analyzer has a lot of trouble understanding this method
-void Population::SplitMutationRunsForChromosome(int32_t p_new_mutrun_count, Chromosome *p_chromosome)
+void Population::SplitMutationRunsForChromosome(const MutationRunLayout &p_new_layout, Chromosome *p_chromosome)
 {
 }
 #endif
@@ -5917,16 +6167,13 @@ void Population::JoinMutationRunsForChromosome(int32_t p_new_mutrun_count, Chrom
 					if (!haplosome->IsNull())
 					{
 						int32_t old_mutrun_count = haplosome->mutrun_count_;
-						slim_position_t old_mutrun_length = haplosome->mutrun_length_;
 						int32_t new_mutrun_count = old_mutrun_count >> 1;
-						slim_position_t new_mutrun_length = old_mutrun_length << 1;
 						
 						if (haplosome->mutruns_ != haplosome->run_buffer_)
 							free(haplosome->mutruns_);
 						haplosome->mutruns_ = nullptr;
 						
 						haplosome->mutrun_count_ = new_mutrun_count;
-						haplosome->mutrun_length_ = new_mutrun_length;
 						
 						if (new_mutrun_count <= SLIM_HAPLOSOME_MUTRUN_BUFSIZE)
 						{
@@ -5982,9 +6229,7 @@ void Population::JoinMutationRunsForChromosome(int32_t p_new_mutrun_count, Chrom
 					if (!haplosome->IsNull())
 					{
 						int32_t old_mutrun_count = haplosome->mutrun_count_;
-						slim_position_t old_mutrun_length = haplosome->mutrun_length_;
 						int32_t new_mutrun_count = old_mutrun_count >> 1;
-						slim_position_t new_mutrun_length = old_mutrun_length << 1;
 						
 						// for every mutation run, fill up mutrun_buf with entries
 						mutruns_buf_index = 0;
@@ -6039,7 +6284,6 @@ void Population::JoinMutationRunsForChromosome(int32_t p_new_mutrun_count, Chrom
 						haplosome->mutruns_ = nullptr;
 						
 						haplosome->mutrun_count_ = new_mutrun_count;
-						haplosome->mutrun_length_ = new_mutrun_length;
 						
 						if (new_mutrun_count <= SLIM_HAPLOSOME_MUTRUN_BUFSIZE)
 							haplosome->mutruns_ = haplosome->run_buffer_;
@@ -6150,7 +6394,6 @@ void Population::AssessMutationRuns(void)
 			int last_haplosome_index = species_.LastHaplosomeIndices()[chromosome_index];
 			slim_refcount_t total_haplosome_count = 0, total_mutrun_count = 0, total_shared_mutrun_count = 0;
 			int mutrun_count = 0, use_count_total = 0;
-			slim_position_t mutrun_length = 0;
 			int64_t mutation_total = 0;
 			
 			int64_t operation_id = MutationRun::GetNextOperationID();
@@ -6170,7 +6413,6 @@ void Population::AssessMutationRuns(void)
 						if (!haplosome->IsNull())
 						{
 							mutrun_count = haplosome->mutrun_count_;
-							mutrun_length = haplosome->mutrun_length_;
 							
 							for (int run_index = 0; run_index < mutrun_count; ++run_index)
 							{
@@ -6199,7 +6441,12 @@ void Population::AssessMutationRuns(void)
 			
 			std::cout << "   ========== Chromosome index " << (unsigned int)(chromosome->Index()) << ", id " << chromosome->ID() << ", symbol " << chromosome->Symbol() << " (length " << (chromosome->last_position_ + 1) << ")" << std::endl;
 			std::cout << "   Mutation count in chromosome: " << registry_count_in_chromosome << std::endl;
-			std::cout << "   Haplosome count: " << total_haplosome_count << " (divided into " << mutrun_count << " mutation runs of length " << mutrun_length << ")" << std::endl;
+			const MutationRunLayout &mutrun_layout = chromosome->mutrun_layout_;
+			
+			if (mutrun_layout.uniform_)
+				std::cout << "   Haplosome count: " << total_haplosome_count << " (divided into " << mutrun_count << " mutation runs of length " << mutrun_layout.uniform_length_ << ")" << std::endl;
+			else
+				std::cout << "   Haplosome count: " << total_haplosome_count << " (divided into " << mutrun_count << " mutation runs of variable length)" << std::endl;
 			
 			std::cout << "   Mutation run unshared: " << total_mutrun_count;
 			if (total_mutrun_count) std::cout << " (containing " << (mutation_total / (double)total_mutrun_count) << " mutations on average)";
@@ -6635,10 +6882,101 @@ void Population::TallyMutationRunReferencesForSubpops(std::vector<Subpopulation*
 
 void Population::TallyMutationRunReferencesForHaplosomes(const Haplosome * const *haplosomes_ptr, slim_popsize_t haplosomes_count)
 {
-	// FIXME parallelize this; unclear how, since the haplosomes might be scattered across chromosomes
-	// could perhaps check for the haplosomes all belonging to one chromosome, and parallelize that
-	// specific case, which is obvious, at least; probably that's the common case.
+	// The haplosomes might be scattered across chromosomes, in general, but the common case is that they all belong
+	// to a single chromosome (or are null); we check for that case, and parallelize it across MutationRunContexts in
+	// the same way as TallyMutationRunReferencesForSubpopsForChromosome().  Other cases are handled serially.
+	Chromosome *focal_chromosome = nullptr;
+	slim_refcount_t tallied_haplosome_count = 0;
+	
+	for (slim_popsize_t haplosome_index = 0; haplosome_index < haplosomes_count; ++haplosome_index)
+	{
+		const Haplosome *haplosome = haplosomes_ptr[haplosome_index];
+		
+		if (!haplosome->IsNull())
+		{
+			Chromosome *chromosome = species_.Chromosomes()[haplosome->chromosome_index_];
+			
+			if (!focal_chromosome)
+				focal_chromosome = chromosome;
+			else if (chromosome != focal_chromosome)
+			{
+				focal_chromosome = nullptr;
+				break;
+			}
+			
+			tallied_haplosome_count++;
+		}
+	}
+	
+	if (focal_chromosome)
+	{
+		int mutrun_count_multiplier = focal_chromosome->mutrun_count_multiplier_;
+		int mutrun_context_count = focal_chromosome->ChromosomeMutationRunContextCount();
+		
+		if (mutrun_count_multiplier * mutrun_context_count != focal_chromosome->mutrun_count_)
+			EIDOS_TERMINATION << "ERROR (Population::TallyMutationRunReferencesForHaplosomes): (internal error) mutation run subdivision is incorrect." << EidosTerminate();
+		
+		// zero the tallies and use counts for the other chromosomes, which are not involved in this tally
+		for (Chromosome *chromosome : species_.Chromosomes())
+		{
+			if (chromosome == focal_chromosome)
+				continue;
+			
+			chromosome->tallied_haplosome_count_ = 0;
+			
+			int other_context_count = chromosome->ChromosomeMutationRunContextCount();
+			
+			for (int mutrun_context_index = 0; mutrun_context_index < other_context_count; ++mutrun_context_index)
+			{
+				MutationRunContext &mutrun_context = chromosome->ChromosomeMutationRunContextForThread(mutrun_context_index);
+				
+				for (const MutationRun *mutrun : mutrun_context.in_use_pool_)
+					mutrun->zero_use_count();
+			}
+		}
+		
+		focal_chromosome->tallied_haplosome_count_ = tallied_haplosome_count;
+		
+		// THIS PARALLEL REGION CANNOT HAVE AN IF()!  IT MUST ALWAYS EXECUTE PARALLEL!
+#pragma omp parallel default(none) shared(mutrun_count_multiplier, mutrun_context_count, std::cerr, focal_chromosome, haplosomes_ptr, haplosomes_count) num_threads(mutrun_context_count)
+		{
+#ifdef _OPENMP
+			// it is imperative that we run with the requested number of threads
+			if (omp_get_num_threads() != mutrun_context_count)
+			{
+				std::cerr << "requested  " << mutrun_context_count << " threads but got " << omp_get_num_threads() << std::endl;
+				THREAD_SAFETY_IN_ANY_PARALLEL("Population::TallyMutationRunReferencesForHaplosomes(): incorrect thread count!");
+			}
+#endif
+			
+			// first, zero all use counts across all in-use MutationRun objects
+			// each thread does its own zeroing, for its own MutationRunContext
+			{
+				MutationRunContext &mutrun_context = focal_chromosome->ChromosomeMutationRunContextForThread(omp_get_thread_num());
+				
+				for (const MutationRun *mutrun : mutrun_context.in_use_pool_)
+					mutrun->zero_use_count();
+			}
+			
+			// second, loop through the haplosomes and tally the usage of their MutationRun objects
+			// each thread handles only the range of mutation run indices that it is responsible for
+			int first_mutrun_index = omp_get_thread_num() * mutrun_count_multiplier;
+			int last_mutrun_index = first_mutrun_index + mutrun_count_multiplier - 1;
+			
+			// note this is NOT an OpenMP parallel for loop!  each encountering thread runs every iteration!
+			for (slim_popsize_t haplosome_index = 0; haplosome_index < haplosomes_count; ++haplosome_index)
+			{
+				const Haplosome *haplosome = haplosomes_ptr[haplosome_index];
+				
+				if (!haplosome->IsNull())
+					for (int run_index = first_mutrun_index; run_index <= last_mutrun_index; ++run_index)
+						haplosome->mutruns_[run_index]->increment_use_count();
+			}
+		}
 		
+		return;
+	}
+	
 	// first, zero all chromosome tallies and all use counts across all in-use MutationRun objects
 	for (Chromosome *chromosome : species_.Chromosomes())
 	{
@@ -6777,6 +7115,11 @@ void Population::FreeUnusedMutationRuns(void)
 					++pool_index;
 				}
 			}
+			
+#if SLIM_INTERN_NEW_MUTATION_RUNS
+			// The intern table might refer to runs we just freed, so it has to be reset now
+			MutationRun::ResetInternTable(mutrun_context);
+#endif
 		}
 		
 		chromosome->StopMutationRunExperimentClock("FreeUnusedMutationRuns()");
@@ -7024,6 +7367,8 @@ void Population::TallyMutationReferencesAcrossSubpopulations(std::vector<Subpopu
 		for (Chromosome *chromosome : species_.Chromosomes())
 			chromosome->tallied_haplosome_count_ = 0;
 		
+		std::vector<MutationIndex> decode_scratch;		// for packed runs; see MutationRun::decoded_pointers_const()
+		
 		for (Subpopulation *subpop : *p_subpops_to_tally)
 		{
 			for (Individual *ind : subpop->parent_individuals_)
@@ -7042,8 +7387,9 @@ void Population::TallyMutationReferencesAcrossSubpopulations(std::vector<Subpopu
 						for (int run_index = 0; run_index < mutrun_count; ++run_index)
 						{
 							const MutationRun *mutrun = haplosome->mutruns_[run_index];
-							const MutationIndex *haplosome_iter = mutrun->begin_pointer_const();
-							const MutationIndex *haplosome_end_iter = mutrun->end_pointer_const();
+							const MutationIndex *haplosome_iter, *haplosome_end_iter;
+							
+							mutrun->decoded_pointers_const(&haplosome_iter, &haplosome_end_iter, decode_scratch);
 							
 							for (; haplosome_iter != haplosome_end_iter; ++haplosome_iter)
 								++(*(refcount_block_ptr + *haplosome_iter));
@@ -7119,6 +7465,8 @@ void Population::TallyMutationReferencesAcrossHaplosomes(const Haplosome * const
 		for (Chromosome *chromosome : species_.Chromosomes())
 			chromosome->tallied_haplosome_count_ = 0;
 		
+		std::vector<MutationIndex> decode_scratch;		// for packed runs; see MutationRun::decoded_pointers_const()
+		
 		for (slim_popsize_t i = 0; i < haplosomes_count; i++)
 		{
 			const Haplosome *haplosome = haplosomes_ptr[i];
@@ -7131,8 +7479,9 @@ void Population::TallyMutationReferencesAcrossHaplosomes(const Haplosome * const
 				for (int run_index = 0; run_index < mutrun_count; ++run_index)
 				{
 					const MutationRun *mutrun = haplosome->mutruns_[run_index];
-					const MutationIndex *haplosome_iter = mutrun->begin_pointer_const();
-					const MutationIndex *haplosome_end_iter = mutrun->end_pointer_const();
+					const MutationIndex *haplosome_iter, *haplosome_end_iter;
+					
+					mutrun->decoded_pointers_const(&haplosome_iter, &haplosome_end_iter, decode_scratch);
 					
 					for (; haplosome_iter != haplosome_end_iter; ++haplosome_iter)
 						++(*(refcount_block_ptr + *haplosome_iter));
@@ -7176,6 +7525,7 @@ void Population::_TallyMutationReferences_FAST_FromMutationRunUsage(bool p_clock
 			MutationRunPool &inuse_pool = mutrun_context.in_use_pool_;
 			size_t inuse_pool_count = inuse_pool.size();
 			slim_refcount_t *refcount_block_ptr = gSLiM_Mutation_Refcounts;
+			std::vector<MutationIndex> decode_scratch;		// for packed runs; see MutationRun::decoded_pointers_const()
 			
 			for (size_t pool_index = 0; pool_index < inuse_pool_count; ++pool_index)
 			{
@@ -7191,8 +7541,12 @@ void Population::_TallyMutationReferences_FAST_FromMutationRunUsage(bool p_clock
 				
 				// Try using __restrict__ pointers to help the compiler optimize here; unclear
 				// whether this matters.  See https://github.com/MesserLab/SLiM/pull/596.
-				const MutationIndex * __restrict__ mutrun_iter = mutrun->begin_pointer_const();
-				const MutationIndex * const __restrict__ mutrun_end_iter = mutrun->end_pointer_const();
+				const MutationIndex *mutrun_begin, *mutrun_end;
+				
+				mutrun->decoded_pointers_const(&mutrun_begin, &mutrun_end, decode_scratch);
+				
+				const MutationIndex * __restrict__ mutrun_iter = mutrun_begin;
+				const MutationIndex * const __restrict__ mutrun_end_iter = mutrun_end;
 				slim_refcount_t * const __restrict__ refcounts = refcount_block_ptr;
 				
 				// I've gone back and forth on unrolling this loop.  This ought to be done
@@ -7463,6 +7817,11 @@ void Population::RemoveAllFixedMutations(void)
 	if (child_generation_valid_)
 		EIDOS_TERMINATION << "ERROR (Population::RemoveAllFixedMutations): (internal error) called with child generation active!" << EidosTerminate();
 	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_START();
+#endif
+	
 	// We use a stack-local MutationRun object so it gets disposed of properly via RAII; non-optimal
 	// from a performance perspective, since it will do reallocs to reach its needed size, but
 	// since this method is only called once per cycle it shouldn't matter.
@@ -7636,7 +7995,20 @@ void Population::RemoveAllFixedMutations(void)
 	}
 #endif
 	
-	// replace fixed mutations with Substitution objects, one chromosome at a time
+	// Remove fixed mutations from the haplosomes that carry them.  A fixed mutation is present in every non-null haplosome for its
+	// chromosome, so the run at its run index in each haplosome contains it; all we need to do is to find the distinct runs at those
+	// run indices and remove the fixed mutations from each run once.  Note that we cast away the const on the mutation runs here;
+	// fixed mutations are being removed from *all* haplosomes, so the fact that this modifies every haplosome that shares a run is a
+	// feature, not a bug.  We gather the distinct runs first, serially, since that is just pointer-chasing, using operation_id to
+	// visit each shared run only once.  A run is never used at more than one run index, or by more than one chromosome, so the runs
+	// gathered are all distinct across chromosomes, and the removal itself is embarrassingly parallel.
+	static std::vector<slim_mutrun_index_t> fixed_mutrun_indices;	// static to avoid alloc/dealloc
+	static std::vector<MutationRun *> fixed_mutruns;				// static to avoid alloc/dealloc
+	int64_t operation_id = MutationRun::GetNextOperationID();
+	size_t total_fixed_mutation_count = 0;
+	
+	fixed_mutruns.resize(0);
+	
 	for (Chromosome *chromosome : chromosomes)
 	{
 		std::vector<MutationIndex> &fixed_mutation_accumulator = chromosome->fixed_mutation_accumulator_;
@@ -7645,14 +8017,25 @@ void Population::RemoveAllFixedMutations(void)
 		if (fixed_mutation_accumulator_size == 0)
 			continue;
 		
-		slim_chromosome_index_t chromosome_index = chromosome->Index();
+		total_fixed_mutation_count += fixed_mutation_accumulator_size;
+		
+		//std::cout << "Chromosome " << chromosome->Index() << ": removing " << fixed_mutation_accumulator.size() << " fixed mutations..." << std::endl;
+		
+		// Find the distinct run indices that contain fixed mutations; usually there are just one or a few
+		const MutationRunLayout &mutrun_layout = chromosome->mutrun_layout_;
+		
+		fixed_mutrun_indices.resize(0);
+		
+		for (int mut_index = 0; mut_index < fixed_mutation_accumulator_size; mut_index++)
+			fixed_mutrun_indices.push_back(mutrun_layout.RunIndexForPosition((mut_block_ptr + fixed_mutation_accumulator[mut_index])->position_));
 		
-		//std::cout << "Chromosome " << chromosome_index << ": removing " << fixed_mutation_accumulator.size() << " fixed mutations..." << std::endl;
+		std::sort(fixed_mutrun_indices.begin(), fixed_mutrun_indices.end());
+		fixed_mutrun_indices.erase(std::unique(fixed_mutrun_indices.begin(), fixed_mutrun_indices.end()), fixed_mutrun_indices.end());
 		
-		// We remove fixed mutations from each MutationRun just once; this is the operation ID we use for that
+		// Then gather the distinct runs at those indices, across all haplosomes for this chromosome
+		slim_chromosome_index_t chromosome_index = chromosome->Index();
 		int first_haplosome_index = species_.FirstHaplosomeIndices()[chromosome_index];
 		int last_haplosome_index = species_.LastHaplosomeIndices()[chromosome_index];
-		int64_t operation_id = MutationRun::GetNextOperationID();
 		
 		for (std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)		// subpopulations
 		{
@@ -7668,70 +8051,86 @@ void Population::RemoveAllFixedMutations(void)
 					
 					if (!haplosome->IsNull())
 					{
-						// Loop over the mutations to remove, and take advantage of our mutation runs by scanning
-						// for removal only within the runs that contain a mutation to be removed.  If there is
-						// more than one mutation to be removed within the same run, the second time around the
-						// runs will no-op the scan using operation_id.  The whole rest of the haplosomes can be skipped.
-						slim_position_t mutrun_length = haplosome->mutrun_length_;
-						
-						for (int mut_index = 0; mut_index < fixed_mutation_accumulator_size; mut_index++)
+						for (slim_mutrun_index_t mutrun_index : fixed_mutrun_indices)
 						{
-							MutationIndex mut_to_remove = fixed_mutation_accumulator[mut_index];
-							Mutation *mutation = (mut_block_ptr + mut_to_remove);
-							slim_position_t mut_position = mutation->position_;
-							slim_mutrun_index_t mutrun_index = (slim_mutrun_index_t)(mut_position / mutrun_length);
-								
-							haplosome->RemoveFixedMutations(operation_id, mutrun_index);
+							MutationRun *mutrun = const_cast<MutationRun *>(haplosome->mutruns_[mutrun_index]);
+							
+							if (mutrun->operation_id_ != operation_id)
+							{
+								mutrun->operation_id_ = operation_id;
+								fixed_mutruns.push_back(mutrun);
+							}
 						}
 					}
 				}
 			}
 		}
+	}
+	
+	if (total_fixed_mutation_count > 0)
+	{
+		// Remove the fixed mutations from each distinct run; each run is touched by only one thread, and removal writes only to
+		// the run itself (unpacking it first, if it is packed, and invalidating its nonneutral cache), so no locking is needed
+		int64_t fixed_mutrun_count = (int64_t)fixed_mutruns.size();
+		MutationRun **fixed_mutruns_ptr = fixed_mutruns.data();
 		
-		slim_tick_t tick = community_.Tick();
+		EIDOS_THREAD_COUNT(gEidos_OMP_threads_FIXED_MUT_REMOVE);
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(fixed_mutrun_count) firstprivate(fixed_mutruns_ptr) if(fixed_mutrun_count >= EIDOS_OMPMIN_FIXED_MUT_REMOVE) num_threads(thread_count)
+		for (int64_t run_index = 0; run_index < fixed_mutrun_count; ++run_index)
+			fixed_mutruns_ptr[run_index]->_RemoveFixedMutations();
 		
-		// TREE SEQUENCE RECORDING
-		if (species_.RecordingTreeSequence())
+#if (SLIMPROFILING == 1)
+		// PROFILING
+		if (gEidosProfilingClientCount)
 		{
-			// When doing tree recording, we additionally keep all fixed mutations (their ids) in a multimap indexed by their position
-			// This allows us to find all the fixed mutations at a given position quickly and easily, for calculating derived states
-			for (int i = 0; i < fixed_mutation_accumulator_size; i++)
-			{
-				Mutation *mut_to_remove = mut_block_ptr + fixed_mutation_accumulator[i];
-				Substitution *sub = new Substitution(*mut_to_remove, tick);
-				
-				treeseq_substitutions_map_.emplace(mut_to_remove->position_, sub);
-				substitutions_.emplace_back(sub);
-			}
+			species_.profile_fixation_cycle_count_++;
+			species_.profile_fixation_substitution_count_ += total_fixed_mutation_count;
+			species_.profile_fixation_mutrun_count_ += fixed_mutrun_count;
 		}
-		else
+#endif
+		
+		// Replace the fixed mutations with Substitution objects, for all chromosomes in one batch.  Substitutions are retained/released
+		// Eidos objects, so each must be allocated individually, but we can at least make room for all of them in substitutions_ up
+		// front, growing it geometrically since it is reserved again in every cycle with fixations.  The order of substitutions_ is the
+		// same as before: by chromosome, and within each chromosome in registry order.
+		slim_tick_t tick = community_.Tick();
+		bool recording_tree_sequence = species_.RecordingTreeSequence();
+		bool nucleotide_based = species_.IsNucleotideBased();
+		size_t substitutions_needed = substitutions_.size() + total_fixed_mutation_count;
+		
+		if (substitutions_needed > substitutions_.capacity())
+			substitutions_.reserve(std::max(substitutions_needed, 2 * substitutions_.capacity()));
+		
+		for (Chromosome *chromosome : chromosomes)
 		{
-			// When not doing tree recording, we just create substitutions and keep them in a vector
-			for (int i = 0; i < fixed_mutation_accumulator_size; i++)
+			std::vector<MutationIndex> &fixed_mutation_accumulator = chromosome->fixed_mutation_accumulator_;
+			
+			if (fixed_mutation_accumulator.size() == 0)
+				continue;
+			
+			// Nucleotide-based models also need to modify the ancestral sequence when a mutation fixes
+			NucleotideArray *ancestral_seq = (nucleotide_based ? chromosome->ancestral_seq_buffer_ : nullptr);
+			
+			for (MutationIndex fixed_mutation_index : fixed_mutation_accumulator)
 			{
-				Mutation *mut_to_remove = mut_block_ptr + fixed_mutation_accumulator[i];
+				Mutation *mut_to_remove = mut_block_ptr + fixed_mutation_index;
 				Substitution *sub = new Substitution(*mut_to_remove, tick);
 				
+				// TREE SEQUENCE RECORDING
+				// When doing tree recording, we additionally keep all fixed mutations (their ids) in a multimap indexed by their position
+				// This allows us to find all the fixed mutations at a given position quickly and easily, for calculating derived states
+				if (recording_tree_sequence)
+					treeseq_substitutions_map_.emplace(mut_to_remove->position_, sub);
+				
 				substitutions_.emplace_back(sub);
-			}
-		}
-		
-		// Nucleotide-based models also need to modify the ancestral sequence when a mutation fixes
-		if (species_.IsNucleotideBased())
-		{
-			NucleotideArray *ancestral_seq = chromosome->ancestral_seq_buffer_;
-			
-			for (int i = 0; i < fixed_mutation_accumulator_size; i++)
-			{
-				Mutation *mut_to_remove = mut_block_ptr + fixed_mutation_accumulator[i];
 				
-				if (mut_to_remove->mutation_type_ptr_->nucleotide_based_)
+				if (ancestral_seq && mut_to_remove->mutation_type_ptr_->nucleotide_based_)
 					ancestral_seq->SetNucleotideAtIndex(mut_to_remove->position_, mut_to_remove->nucleotide_);
 			}
+			
+			// Clear the accumulator for reuse next tick
+			fixed_mutation_accumulator.resize(0);
 		}
-		
-		// Clear the accumulator for reuse next tick
-		fixed_mutation_accumulator.resize(0);
 	}
 	
 	// now we can delete (or zombify) removed mutation objects
@@ -7753,6 +8152,11 @@ void Population::RemoveAllFixedMutations(void)
 #endif
 		}
 	}
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_END(species_.profile_fixation_time_);
+#endif
 }
 
 void Population::CheckMutationRegistry(bool p_check_haplosomes)
@@ -8446,7 +8850,7 @@ void Population::PrintSample_MS(std::ostream &p_out, Subpopulation &p_subpop, sl
 }
 
 // print sample of p_sample_size *individuals* (NOT haplosomes or genomes) from subpopulation p_subpop_id
-void Population::PrintSample_VCF(std::ostream &p_out, Subpopulation &p_subpop, slim_popsize_t p_sample_size, bool p_replace, IndividualSex p_requested_sex, const Chromosome &p_chromosome, bool p_output_multiallelics, bool p_simplify_nucs, bool p_output_nonnucs, bool p_group_as_individuals) const
+void Population::PrintSample_VCF(std::ostream &p_out, Subpopulation &p_subpop, slim_popsize_t p_sample_size, bool p_replace, IndividualSex p_requested_sex, const Chromosome &p_chromosome, bool p_output_multiallelics, bool p_simplify_nucs, bool p_output_nonnucs, bool p_group_as_individuals, VCFOutputFormat p_format) const
 {
 	if (child_generation_valid_)
 		EIDOS_TERMINATION << "ERROR (Population::PrintSample_VCF): (internal error) called with child generation active!." << EidosTerminate();
@@ -8493,7 +8897,7 @@ void Population::PrintSample_VCF(std::ostream &p_out, Subpopulation &p_subpop, s
 	}
 	
 	// print the sample using Haplosome's static member function
-	Haplosome::PrintHaplosomes_VCF(p_out, sample, p_chromosome, p_group_as_individuals, p_output_multiallelics, p_simplify_nucs, p_output_nonnucs);
+	Haplosome::PrintHaplosomes_VCF(p_out, sample, p_chromosome, p_group_as_individuals, p_output_multiallelics, p_simplify_nucs, p_output_nonnucs, p_format);
 }
 
 
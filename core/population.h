@@ -45,6 +45,7 @@ class Species;
 class Subpopulation;
 class Individual;
 class Haplosome;
+enum class VCFOutputFormat : uint8_t;
 
 
 #pragma mark -
@@ -244,6 +245,12 @@ public:
 	
 	void DoHeteroduplexRepair(std::vector<slim_position_t> &p_heteroduplex, slim_position_t *p_breakpoints, int p_breakpoints_count, Haplosome *p_parent_haplosome_1, Haplosome *p_parent_haplosome_2, Haplosome *p_child_haplosome);
 	
+#if SLIM_INTERN_NEW_MUTATION_RUNS
+	// collapse the child runs containing a breakpoint onto identical parental or previously created runs; p_skip_run_mask has bit
+	// (i % 64) set for each run index i that might contain a new mutation, and such runs are left alone since they can't be duplicates
+	void InternChildMutationRuns(Chromosome &p_chromosome, Haplosome &p_child_haplosome, const Haplosome *p_parent_haplosome_1, const Haplosome *p_parent_haplosome_2, const slim_position_t *p_breakpoints, int p_breakpoints_count, uint64_t p_skip_run_mask);
+#endif
+	
 	// generate offspring within a reproduction() callback using templated Subpopulation methods; these pointers get
 	// set up at the beginning of each tick's reproduction() callback stage, and should not be used outside of it
 	Individual *(Subpopulation::*GenerateIndividualCrossed_TEMPLATED)(Individual *p_parent1, Individual *p_parent2, IndividualSex p_child_sex) = nullptr;
@@ -256,11 +263,22 @@ public:
 	// Recalculate all fitness values for the parental generation, including the use of mutationEffect() callbacks
 	void RecalculateFitness(slim_tick_t p_tick);
 	
+	// Compute the chromosomal fitness of all parental individuals in one parallel pass across subpopulations and chromosomes, for use
+	// by Subpopulation::UpdateFitness(); used by RecalculateFitness() when no callbacks are active, in models with many subpopulations
+	bool ShouldPrecomputeChromosomalFitness(void);
+	void PrecomputeChromosomalFitness(void);
+#if (defined(_OPENMP) && SLIM_USE_NONNEUTRAL_CACHES)
+	void FixNonNeutralCaches_OMP(void);
+#endif
+	
 	// Scan through all mutation runs in the simulation and unique them
 	void UniqueMutationRuns(void);
 	
+	// Pack the long mutation runs currently in use into their compressed form; used when compressMutationRuns=T
+	void PackMutationRuns(void);
+	
 	// Scan through all haplosomes and either split or join their mutation runs, to double or halve the number of runs per haplosome
-	void SplitMutationRunsForChromosome(int32_t p_new_mutrun_count, Chromosome *p_chromosome);
+	void SplitMutationRunsForChromosome(const MutationRunLayout &p_new_layout, Chromosome *p_chromosome);
 	void JoinMutationRunsForChromosome(int32_t p_new_mutrun_count, Chromosome *p_chromosome);
 	
 	// Tally mutations and remove fixed/lost mutations
@@ -386,7 +404,7 @@ public:
 	void PrintSample_MS(std::ostream &p_out, Subpopulation &p_subpop, slim_popsize_t p_sample_size, bool p_replace, IndividualSex p_requested_sex, const Chromosome &p_chromosome, bool p_filter_monomorphic) const;
 	
 	// print sample of p_sample_size haplosomes from subpopulation p_subpop_id, using "vcf" format
-	void PrintSample_VCF(std::ostream &p_out, Subpopulation &p_subpop, slim_popsize_t p_sample_size, bool p_replace, IndividualSex p_requested_sex, const Chromosome &p_chromosome, bool p_output_multiallelics, bool p_simplify_nucs, bool p_output_nonnucs, bool p_group_as_individuals) const;
+	void PrintSample_VCF(std::ostream &p_out, Subpopulation &p_subpop, slim_popsize_t p_sample_size, bool p_replace, IndividualSex p_requested_sex, const Chromosome &p_chromosome, bool p_output_multiallelics, bool p_simplify_nucs, bool p_output_nonnucs, bool p_group_as_individuals, VCFOutputFormat p_format) const;
 	
 	// remove subpopulations, purge all mutations and substitutions, etc.; called before InitializePopulationFrom[Text|Binary]File()
 	void RemoveAllSubpopulationInfo(void);
@@ -17,6 +17,7 @@
 #include "species.h"
 #include "interaction_type.h"
 #include "subpopulation.h"
+#include "slim_native_callback.h"
 
 #include "errno.h"
 #include "string.h"
@@ -1319,6 +1320,7 @@ SLiMEidosBlock::SLiMEidosBlock(slim_objectid_t p_id, const std::string &p_script
 SLiMEidosBlock::~SLiMEidosBlock(void)
 {
 	delete script_;
+	delete native_callback_;
 }
 
 void SLiMEidosBlock::TokenizeAndParse(void)
@@ -1731,6 +1733,8 @@ EidosValue_SP SLiMEidosBlock::GetProperty(EidosGlobalStringID p_property_id)
 			
 			return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(tag_value));
 		}
+		case gID_vectorized:
+			return (vectorized_ ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
 			
 			// all others, including gID_none
 		default:
@@ -1763,6 +1767,17 @@ void SLiMEidosBlock::SetProperty(EidosGlobalStringID p_property_id, const EidosV
 			return;
 		}
 			
+		case gID_vectorized:
+		{
+			eidos_logical_t value = p_value.LogicalAtIndex_NOCAST(0, nullptr);
+			
+			if (type_ != SLiMEidosBlockType::SLiMEidosMutationEffectCallback)
+				EIDOS_TERMINATION << "ERROR (SLiMEidosBlock::SetProperty): property vectorized can only be set on mutationEffect() callbacks." << EidosTerminate();
+			
+			vectorized_ = value;
+			return;
+		}
+			
 			// all others, including gID_none
 		default:
 			return super::SetProperty(p_property_id, p_value);
@@ -1799,6 +1814,7 @@ const std::vector<EidosPropertySignature_CSP> *SLiMEidosBlock_Class::Properties(
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_speciesSpec,		true,	kEidosValueMaskObject, gSLiM_Species_Class)));
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_tag,			false,	kEidosValueMaskInt | kEidosValueMaskSingleton)));
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_ticksSpec,		true,	kEidosValueMaskObject, gSLiM_Species_Class)));
+		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_vectorized,		false,	kEidosValueMaskLogical | kEidosValueMaskSingleton)));
 		
 		std::sort(properties->begin(), properties->end(), CompareEidosPropertySignatures);
 	}
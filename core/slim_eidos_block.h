@@ -38,6 +38,7 @@
 #include <unordered_set>
 
 class Community;
+class SLiMNativeCallback;
 
 
 enum class SLiMEidosBlockType {
@@ -168,6 +169,7 @@ public:
 	
 	slim_usertag_t block_active_ = -1;							// the "active" property of the block: 0 if inactive, all other values are active
 	slim_usertag_t tag_value_ = SLIM_TAG_UNSET_VALUE;			// a user-defined tag value
+	bool vectorized_ = false;									// the "vectorized" property of the block: mutationEffect() callbacks only; see Subpopulation::RunVectorizedMutationEffectCallbacks()
 	
 	// Flags indicating what identifiers this script block uses; identifiers that are not used do not need to be added.
 	bool contains_wildcard_ = false;			// "apply", "sapply", "executeLambda", "_executeLambda_OUTER", "ls", "rm"; all other contains_ flags will be T if this is T
@@ -199,15 +201,10 @@ public:
 	bool contains_fitness_ = false;				// "fitness" (survival callback parameter)
 	bool contains_draw_ = false;				// "draw" (survival callback parameter)
 	
-	// Special-case optimizations for particular common callback types.  If a callback can be substituted by C++ code,
-	// has_cached_optimization_ will be true and the flags and values below will indicate exactly how to do so.
+	// Compiled C++ code for simple fitnessEffect() and mutationEffect() callbacks; if a callback could be compiled by
+	// Community::OptimizeScriptBlock(), has_cached_optimization_ will be true and native_callback_ will evaluate it.
 	bool has_cached_optimization_ = false;
-	bool has_cached_opt_dnorm1_ = false;
-	bool has_cached_opt_reciprocal = false;
-	double cached_opt_A_ = 0.0;
-	double cached_opt_B_ = 0.0;
-	double cached_opt_C_ = 0.0;
-	double cached_opt_D_ = 0.0;
+	SLiMNativeCallback *native_callback_ = nullptr;				// OWNED
 	
 	
 	static SLiMEidosBlockType BlockTypeForRootNode(EidosASTNode *p_root_node);		// get the block type for a node without actually constructing the block
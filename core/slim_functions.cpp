@@ -36,19 +36,10 @@
 #include <algorithm>
 
 
-extern const char *gSLiMSourceCode_calcDxy;
-extern const char *gSLiMSourceCode_calcFST;
 extern const char *gSLiMSourceCode_calcVA;
-extern const char *gSLiMSourceCode_calcLD_D;
-extern const char *gSLiMSourceCode_calcLD_Rsquared;
 extern const char *gSLiMSourceCode_calcMeanFroh;
 extern const char *gSLiMSourceCode_calcPairHeterozygosity;
-extern const char *gSLiMSourceCode_calcHeterozygosity;
-extern const char *gSLiMSourceCode_calcWattersonsTheta;
 extern const char *gSLiMSourceCode_calcInbreedingLoad;
-extern const char *gSLiMSourceCode_calcPi;
-extern const char *gSLiMSourceCode_calcSFS;
-extern const char *gSLiMSourceCode_calcTajimasD;
 
 extern const char *gSLiMSourceCode_initializeMutationRateFromFile;
 extern const char *gSLiMSourceCode_initializeRecombinationRateFromFile;
@@ -74,20 +65,22 @@ const std::vector<EidosFunctionSignature_CSP> *Community::SLiMFunctionSignatures
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("nucleotidesToCodons", SLiM_ExecuteFunction_nucleotidesToCodons, kEidosValueMaskInt, "SLiM"))->AddIntString("sequence"));
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("randomNucleotides", SLiM_ExecuteFunction_randomNucleotides, kEidosValueMaskInt | kEidosValueMaskString, "SLiM"))->AddInt_S("length")->AddNumeric_ON("basis", gStaticEidosValueNULL)->AddString_OS("format", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String("string"))));
 		
+		// Population genetics utilities (implemented natively)
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcDxy", SLiM_ExecuteFunction_calcDxy, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes1", gSLiM_Haplosome_Class)->AddObject("haplosomes2", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL)->AddLogical_OS("normalize", gStaticEidosValue_LogicalF));
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcFST", SLiM_ExecuteFunction_calcFST, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes1", gSLiM_Haplosome_Class)->AddObject("haplosomes2", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcHeterozygosity", SLiM_ExecuteFunction_calcHeterozygosity, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcLD_D", SLiM_ExecuteFunction_calcLD_D, kEidosValueMaskFloat, "SLiM"))->AddObject_S("mut1", gSLiM_Mutation_Class)->AddObject_ON("mut2", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddObject_ON("haplosomes", gSLiM_Haplosome_Class, gStaticEidosValueNULL));
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcLD_Rsquared", SLiM_ExecuteFunction_calcLD_Rsquared, kEidosValueMaskFloat, "SLiM"))->AddObject_S("mut1", gSLiM_Mutation_Class)->AddObject_ON("mut2", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddObject_ON("haplosomes", gSLiM_Haplosome_Class, gStaticEidosValueNULL)->AddLogical_OS("squared", gStaticEidosValue_LogicalT));
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcWattersonsTheta", SLiM_ExecuteFunction_calcWattersonsTheta, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcPi", SLiM_ExecuteFunction_calcPi, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcSFS", SLiM_ExecuteFunction_calcSFS, kEidosValueMaskNumeric, "SLiM"))->AddInt_OSN("binCount", gStaticEidosValueNULL)->AddObject_ON("haplosomes", gSLiM_Haplosome_Class, gStaticEidosValueNULL)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddString_OS("metric", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String("density")))->AddLogical_OS("fold", gStaticEidosValue_LogicalF));
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcTajimasD", SLiM_ExecuteFunction_calcTajimasD, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
+		
 		// Population genetics utilities (implemented with Eidos code)
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcDxy", gSLiMSourceCode_calcDxy, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes1", gSLiM_Haplosome_Class)->AddObject("haplosomes2", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL)->AddLogical_OS("normalize", gStaticEidosValue_LogicalF));
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcFST", gSLiMSourceCode_calcFST, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes1", gSLiM_Haplosome_Class)->AddObject("haplosomes2", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcVA", gSLiMSourceCode_calcVA, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("individuals", gSLiM_Individual_Class)->AddIntObject_S("mutType", gSLiM_MutationType_Class));
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcLD_D", gSLiMSourceCode_calcLD_D, kEidosValueMaskFloat, "SLiM"))->AddObject_S("mut1", gSLiM_Mutation_Class)->AddObject_ON("mut2", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddObject_ON("haplosomes", gSLiM_Haplosome_Class, gStaticEidosValueNULL));
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcLD_Rsquared", gSLiMSourceCode_calcLD_Rsquared, kEidosValueMaskFloat, "SLiM"))->AddObject_S("mut1", gSLiM_Mutation_Class)->AddObject_ON("mut2", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddObject_ON("haplosomes", gSLiM_Haplosome_Class, gStaticEidosValueNULL)->AddLogical_OS("squared", gStaticEidosValue_LogicalT));
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcMeanFroh", gSLiMSourceCode_calcMeanFroh, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("individuals", gSLiM_Individual_Class)->AddInt_OS("minimumLength", EidosValue_Int_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(1000000)))->AddArgWithDefault(kEidosValueMaskNULL | kEidosValueMaskInt | kEidosValueMaskString | kEidosValueMaskObject | kEidosValueMaskOptional | kEidosValueMaskSingleton, "chromosome", gSLiM_Chromosome_Class, gStaticEidosValueNULL));
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcPairHeterozygosity", gSLiMSourceCode_calcPairHeterozygosity, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject_S("haplosome1", gSLiM_Haplosome_Class)->AddObject_S("haplosome2", gSLiM_Haplosome_Class)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL)->AddLogical_OS("infiniteSites", gStaticEidosValue_LogicalT));
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcHeterozygosity", gSLiMSourceCode_calcHeterozygosity, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcWattersonsTheta", gSLiMSourceCode_calcWattersonsTheta, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcInbreedingLoad", gSLiMSourceCode_calcInbreedingLoad, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddIntObject_OSN("mutType", gSLiM_MutationType_Class, gStaticEidosValueNULL));
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcPi", gSLiMSourceCode_calcPi, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcSFS", gSLiMSourceCode_calcSFS, kEidosValueMaskNumeric, "SLiM"))->AddInt_OSN("binCount", gStaticEidosValueNULL)->AddObject_ON("haplosomes", gSLiM_Haplosome_Class, gStaticEidosValueNULL)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddString_OS("metric", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String("density")))->AddLogical_OS("fold", gStaticEidosValue_LogicalF));
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcTajimasD", gSLiMSourceCode_calcTajimasD, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
 		
 		// Other built-in SLiM functions
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("summarizeIndividuals", SLiM_ExecuteFunction_summarizeIndividuals, kEidosValueMaskFloat, "SLiM"))->AddObject("individuals", gSLiM_Individual_Class)->AddInt("dim")->AddNumeric("spatialBounds")->AddString_S("operation")->AddLogicalEquiv_OSN("empty", gStaticEidosValue_Float0)->AddLogical_OS("perUnitArea", gStaticEidosValue_LogicalF)->AddString_OSN("spatiality", gStaticEidosValueNULL));
@@ -124,159 +117,7 @@ const std::vector<EidosFunctionSignature_CSP> *Community::SLiMFunctionSignatures
 
 // These are implemented in Eidos, for transparency/modifiability.  These strings are globals mostly so the
 // formatting of the code looks nice in Xcode; they are used only by Community::SLiMFunctionSignatures().
-
-#pragma mark (float$)calcDxy(object<Haplosome> haplosomes1, object<Haplosome> haplosomes2, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL], [logical$ normalize = F])
-const char *gSLiMSourceCode_calcDxy = 
-R"V0G0N({
-	n1 = haplosomes1.length();
-	n2 = haplosomes2.length();
-	if (n1 == 0 | n2 == 0)
-		stop("ERROR (calcDxy): haplosomes1 and haplosomes2 must both be non-empty.");
-	
-	species = haplosomes1[0].individual.subpopulation.species;
-	if (community.allSpecies.length() > 1)
-	{
-		if (any(c(haplosomes1, haplosomes2).individual.subpopulation.species != species))
-			stop("ERROR (calcDxy): all haplosomes must belong to the same species.");
-		if (!isNULL(muts))
-			if (any(muts.mutationType.species != species))
-				stop("ERROR (calcDxy): all mutations must belong to the same species as the haplosomes.");
-	}
-	
-	chromosome = haplosomes1[0].chromosome;
-	if (species.chromosomes.length() > 1)
-	{
-		if (any(c(haplosomes1, haplosomes2).chromosome != chromosome))
-			stop("ERROR (calcDxy): all haplosomes must be associated with the same chromosome.");
-		if (!isNULL(muts))
-			if (any(muts.chromosome != chromosome))
-				stop("ERROR (calcDxy): all mutations must be associated with the same chromosome as the haplosomes.");
-	}
-	length = chromosome.length;
-	
-	if (isNULL(muts))
-		muts = species.subsetMutations(chromosome=chromosome);
-	
-	// handle windowing
-	if (!isNULL(start) & !isNULL(end))
-	{
-		if (start > end)
-			stop("ERROR (calcDxy): start must be less than or equal to end.");
-		if ((start < 0) | (end >= length))
-			stop("ERROR (calcDxy): start and end must be within the bounds of the focal chromosome");
-		length = end - start + 1;
-		mpos = muts.position;
-		muts = muts[(mpos >= start) & (mpos <= end)];
-	}
-	else if (isNULL(start) & isNULL(end))
-	{
-		start = 0;
-		end = chromosome.lastPosition;
-	}
-	else if (!isNULL(start) | !isNULL(end))
-	{
-		stop("ERROR (calcDxy): start and end must both be NULL or both be non-NULL.");
-	}
-	
-	// narrow down to mutations actually present in the haplosomes and not fixed
-	p = c(haplosomes1, haplosomes2).mutationFrequenciesInHaplosomes(muts);
-	muts = muts[(p != 0.0) & (p != 1.0)];
-	if (size(muts) == 0) // if there are no mutations segregating, Dxy = 0
-		return 0.0;
-	
-	// get the count of each mutation in the two sets of haplosomes
-	dos1 = haplosomes1.mutationCountsInHaplosomes(muts);
-	dos2 = haplosomes2.mutationCountsInHaplosomes(muts);
-	
-	// calculate counts for the "empty" positions (they are alleles too, even
-	// though they don't have mutation objects in SLiM); note the implementation
-	// assumes "infinite sites" by assuming that a given site contains only a
-	// single SLiM mutation; if multiple SLiM mutations were present, the empty
-	// count would need to account for all of them, but that is hard to do
-	dos1_empty = size(haplosomes1) - dos1;
-	dos2_empty = size(haplosomes2) - dos2;
-	
-	dos1 = c(dos1, dos1_empty);
-	dos2 = c(dos2, dos2_empty);
-	
-	// "presence of A in haplosomes1" times "absence of A in haplosomes2" +
-	//    "presence of A in haplosomes2" times "absence of A in haplosomes1"
-	diffs_per_site = dos1 * (n2 - dos2) + (n1 - dos1) * dos2;
-	diff = sum(diffs_per_site);
-	
-	// this estimates Dxy as defined by Nei, without normalization by length
-	dxy = diff / 2.0 / n1 / n2;
-	
-	if (normalize)
-		return dxy / length;
-	else
-		return dxy;
-})V0G0N";
-
-#pragma mark (float$)calcFST(object<Haplosome> haplosomes1, object<Haplosome> haplosomes2, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
-const char *gSLiMSourceCode_calcFST = 
-R"V0G0N({
-	if ((haplosomes1.length() == 0) | (haplosomes2.length() == 0))
-		stop("ERROR (calcFST): haplosomes1 and haplosomes2 must both be non-empty.");
-	
-	species = haplosomes1[0].individual.subpopulation.species;
-	if (community.allSpecies.length() > 1)
-	{
-		if (any(c(haplosomes1, haplosomes2).individual.subpopulation.species != species))
-			stop("ERROR (calcFST): all haplosomes must belong to the same species.");
-		if (!isNULL(muts))
-			if (any(muts.mutationType.species != species))
-				stop("ERROR (calcFST): all mutations must belong to the same species as the haplosomes.");
-	}
-	
-	chromosomes = haplosomes1[0].chromosome;
-	if (species.chromosomes.length() > 1)
-	{
-		chromosomes = sortBy(unique(haplosomes1.chromosome, preserveOrder=F), "id");
-		chromosomes2 = sortBy(unique(haplosomes2.chromosome, preserveOrder=F), "id");
-		if (!identical(chromosomes, chromosomes2))
-			stop("ERROR (calcFST): both haplosomes must be associated with the same set of chromosomes.");
-		if (!isNULL(muts))
-			if (any(match(unique(muts.chromosome), chromosomes) == -1))
-				stop("ERROR (calcFST): all mutations must be associated with the same chromosomes as the haplosomes.");
-	}
-	
-	if (isNULL(muts))
-		muts = species.subsetMutations(chromosome=chromosomes);
-	
-	// handle windowing
-	if (!isNULL(start) & !isNULL(end))
-	{
-		if (chromosomes.length() > 1)
-			stop("ERROR (calcFST): start/end cannot be specified with more than one chromosome.");
-		if (start > end)
-			stop("ERROR (calcFST): start must be less than or equal to end.");
-		if ((start < 0) | (end >= chromosomes.length))
-			stop("ERROR (calcFST): start and end must be within the bounds of the focal chromosome");
-		mpos = muts.position;
-		muts = muts[(mpos >= start) & (mpos <= end)];
-	}
-	else if (!isNULL(start) | !isNULL(end))
-	{
-		stop("ERROR (calcFST): start and end must both be NULL or both be non-NULL.");
-	}
-	
-	// do the calculation; if the FST is undefined, return NULL
-	p1_p = haplosomes1.mutationFrequenciesInHaplosomes(muts);
-	p2_p = haplosomes2.mutationFrequenciesInHaplosomes(muts);
-	mean_p = (p1_p + p2_p) / 2.0;
-	H_t = 2.0 * mean_p * (1.0 - mean_p);
-	H_s = p1_p * (1.0 - p1_p) + p2_p * (1.0 - p2_p);
-	mean_H_t = mean(H_t);
-	
-	if (isNULL(mean_H_t))	// occurs if muts is zero-length
-		return NAN;
-	if (mean_H_t == 0)		// occurs if muts is not zero-length but all frequencies are zero
-		return NAN;
-	
-	fst = 1.0 - mean(H_s) / mean_H_t;
-	return fst;
-})V0G0N";
+// Some of the population genetics utilities are implemented natively, for speed; see the next section.
 
 #pragma mark (float$)calcVA(object<Individual> individuals, io<MutationType>$ mutType)
 const char *gSLiMSourceCode_calcVA = 
@@ -303,118 +144,6 @@ R"V0G0N({
 	return var(individuals.sumOfMutationsOfType(mutType));
 })V0G0N";
 
-#pragma mark (float)calcLD_D(object<Mutation>$ mut1, [No<Mutation> mut2 = NULL], [No<Haplosome> haplosomes = NULL])
-const char *gSLiMSourceCode_calcLD_D = 
-R"V0G0N({
-	// check species
-	species = mut1.mutationType.species;
-	if (community.allSpecies.length() > 1)
-	{
-		if (!isNULL(haplosomes))
-			if (any(haplosomes.individual.subpopulation.species != species))
-				stop("ERROR (calcLD_D): all haplosomes must belong to the same species as mut1.");
-		if (!isNULL(mut2))
-			if (any(mut2.mutationType.species != species))
-				stop("ERROR (calcLD_D): all mutations must belong to the same species as mut1.");
-	}
-	
-	// check chromosome
-	chromosome = mut1.chromosome;
-	if (species.chromosomes.length() > 1)
-	{
-		if (!isNULL(haplosomes))
-			if (any(haplosomes.chromosome != chromosome))
-				stop("ERROR (calcLD_D): all haplosomes must belong to the same chromosome as mut1.");
-		if (!isNULL(mut2))
-			if (any(mut2.chromosome != chromosome))
-				stop("ERROR (calcLD_D): all mutations must belong to the same chromosome as mut1.");
-	}
-	
-	// if mut2 is NULL, calculate across all mutations for the chromosome
-	if (isNULL(mut2))
-		mut2 = species.subsetMutations(chromosome=chromosome);	// includes mut1
-	
-	// if haplosomes is NULL, calculate across all haplosomes for the chromosome
-	if (isNULL(haplosomes))
-		haplosomes = species.subpopulations.haplosomesForChromosomes(chromosome);
-	
-	if (size(haplosomes) == 0)
-		stop("ERROR (calcLD_D): haplosomes must be non-empty.");
-	
-	// get haplosomes that contain the first mutation
-	haplosomes1 = haplosomes[haplosomes.containsMutations(mut1)];
-	
-	if (size(haplosomes1) == 0)
-		return rep(0.0, size(mut2)); // D=0 if either mutation is not present
-	
-	// calculate the frequency of haplosomes that contain both mutations
-	p_12 = haplosomes1.mutationCountsInHaplosomes(mut2) / size(haplosomes);
-	
-	// calculate the frequency of each mutation across haplosomes
-	p_1 = size(haplosomes1) / size(haplosomes);
-	p_2 = haplosomes.mutationFrequenciesInHaplosomes(mut2);
-	return p_12 - p_1 * p_2;
-})V0G0N";
-
-#pragma mark (float)calcLD_Rsquared(object<Mutation>$ mut1, [No<Mutation> mut2 = NULL], [No<Haplosome> haplosomes = NULL], [logical$ squared = T])
-const char *gSLiMSourceCode_calcLD_Rsquared = 
-R"V0G0N({
-	// check species
-	species = mut1.mutationType.species;
-	if (community.allSpecies.length() > 1)
-	{
-		if (!isNULL(haplosomes))
-			if (any(haplosomes.individual.subpopulation.species != species))
-				stop("ERROR (calcLD_Rsquared): all haplosomes must belong to the same species as mut1.");
-		if (!isNULL(mut2))
-			if (any(mut2.mutationType.species != species))
-				stop("ERROR (calcLD_Rsquared): all mutations must belong to the same species as mut1.");
-	}
-	
-	// check chromosome
-	chromosome = mut1.chromosome;
-	if (species.chromosomes.length() > 1)
-	{
-		if (!isNULL(haplosomes))
-			if (any(haplosomes.chromosome != chromosome))
-				stop("ERROR (calcLD_Rsquared): all haplosomes must belong to the same chromosome as mut1.");
-		if (!isNULL(mut2))
-			if (any(mut2.chromosome != chromosome))
-				stop("ERROR (calcLD_Rsquared): all mutations must belong to the same chromosome as mut1.");
-	}
-	
-	// if mut2 is NULL, calculate across all mutations for the chromosome
-	if (isNULL(mut2))
-		mut2 = species.subsetMutations(chromosome=chromosome);	// includes mut1
-	
-	// if haplosomes is NULL, calculate across all haplosomes for the chromosome
-	if (isNULL(haplosomes))
-		haplosomes = species.subpopulations.haplosomesForChromosomes(chromosome);
-	
-	if (size(haplosomes) == 0)
-		stop("ERROR (calcLD_Rsquared): haplosomes must be non-empty.");
-	
-	// get haplosomes that contain the first mutation
-	haplosomes1 = haplosomes[haplosomes.containsMutations(mut1)];
-	
-	if (size(haplosomes1) == 0)
-		return rep(NAN, size(mut2)); // r^2 doesn't exist if either mutation is absent (0/0)
-	
-	// calculate the frequency of haplosomes that contain both mutations
-	p_12 = haplosomes1.mutationCountsInHaplosomes(mut2) / size(haplosomes);
-	
-	// calculate the frequency of each mutation across haplosomes
-	p_1 = size(haplosomes1) / size(haplosomes);
-	p_2 = haplosomes.mutationFrequenciesInHaplosomes(mut2);
-	
-	// squared=T returns r^2 between 0 and 1
-	// squared=F returns r between -1 and 1
-	if (squared)
-		return (p_12 - p_1 * p_2)^2 / (p_1 * p_2 * (1.0 - p_1) * (1.0 - p_2));
-	else
-		return (p_12 - p_1 * p_2) / sqrt(p_1 * p_2 * (1.0 - p_1) * (1.0 - p_2));
-})V0G0N";
-
 #pragma mark (float$)calcMeanFroh(object<Individual> individuals, [integer$ minimumLength = 1e6], [Niso<Chromosome>$ chromosome = NULL])
 const char *gSLiMSourceCode_calcMeanFroh = 
 R"V0G0N({
@@ -553,118 +282,6 @@ R"V0G0N({
 	return size(unshared) / length;
 })V0G0N";
 
-#pragma mark (float$)calcHeterozygosity(o<Haplosome> haplosomes, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
-const char *gSLiMSourceCode_calcHeterozygosity = 
-R"V0G0N({
-	if (haplosomes.length() == 0)
-		stop("ERROR (calcHeterozygosity): haplosomes must be non-empty.");
-	
-	species = haplosomes[0].individual.subpopulation.species;
-	if (community.allSpecies.length() > 1)
-	{
-		if (any(haplosomes.individual.subpopulation.species != species))
-			stop("ERROR (calcHeterozygosity): all haplosomes must belong to the same species.");
-		if (!isNULL(muts))
-			if (any(muts.mutationType.species != species))
-				stop("ERROR (calcHeterozygosity): all mutations must belong to the same species as the haplosomes.");
-	}
-	
-	chromosome = haplosomes[0].chromosome;
-	if (species.chromosomes.length() > 1)
-	{
-		if (any(haplosomes.chromosome != chromosome))
-			stop("ERROR (calcHeterozygosity): all haplosomes must be associated with the same chromosome.");
-		if (!isNULL(muts))
-			if (any(muts.chromosome != chromosome))
-				stop("ERROR (calcHeterozygosity): all mutations must be associated with the same chromosome as the haplosomes.");
-	}
-	
-	length = chromosome.length;
-	
-	if (isNULL(muts))
-		muts = species.subsetMutations(chromosome=chromosome);
-	
-	// handle windowing
-	if (!isNULL(start) & !isNULL(end))
-	{
-		if (start > end)
-			stop("ERROR (calcHeterozygosity): start must be less than or equal to end.");
-		if ((start < 0) | (end >= length))
-			stop("ERROR (calcHeterozygosity): start and end must be within the bounds of the focal chromosome");
-		mpos = muts.position;
-		muts = muts[(mpos >= start) & (mpos <= end)];
-		length = end - start + 1;
-	}
-	else if (!isNULL(start) | !isNULL(end))
-	{
-		stop("ERROR (calcHeterozygosity): start and end must both be NULL or both be non-NULL.");
-	}
-
-	// do the calculation
-	p = haplosomes.mutationFrequenciesInHaplosomes(muts);
-	heterozygosity = 2 * sum(p * (1 - p)) / length;
-	return heterozygosity;
-})V0G0N";
-
-#pragma mark (float$)calcWattersonsTheta(o<Haplosome> haplosomes, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
-const char *gSLiMSourceCode_calcWattersonsTheta = 
-R"V0G0N({
-	if (haplosomes.length() == 0)
-		stop("ERROR (calcWattersonsTheta): haplosomes must be non-empty.");
-	
-	species = haplosomes[0].individual.subpopulation.species;
-	if (community.allSpecies.length() > 1)
-	{
-		if (any(haplosomes.individual.subpopulation.species != species))
-			stop("ERROR (calcWattersonsTheta): all haplosomes must belong to the same species.");
-		if (!isNULL(muts))
-			if (any(muts.mutationType.species != species))
-				stop("ERROR (calcWattersonsTheta): all mutations must belong to the same species as the haplosomes.");
-	}
-	
-	chromosome = haplosomes[0].chromosome;
-	if (species.chromosomes.length() > 1)
-	{
-		if (any(haplosomes.chromosome != chromosome))
-			stop("ERROR (calcWattersonsTheta): all haplosomes must be associated with the same chromosome.");
-		if (!isNULL(muts))
-			if (any(muts.chromosome != chromosome))
-				stop("ERROR (calcWattersonsTheta): all mutations must be associated with the same chromosome as the haplosomes.");
-	}
-	
-	length = chromosome.length;
-	
-	if (isNULL(muts))
-		muts = species.subsetMutations(chromosome=chromosome);
-	
-	// handle windowing
-	if (!isNULL(start) & !isNULL(end))
-	{
-		if (start > end)
-			stop("ERROR (calcWattersonsTheta): start must be less than or equal to end.");
-		if ((start < 0) | (end >= length))
-			stop("ERROR (calcWattersonsTheta): start and end must be within the bounds of the focal chromosome");
-		mpos = muts.position;
-		muts = muts[(mpos >= start) & (mpos <= end)];
-		length = end - start + 1;
-	}
-	else if (!isNULL(start) | !isNULL(end))
-	{
-		stop("ERROR (calcWattersonsTheta): start and end must both be NULL or both be non-NULL.");
-	}
-
-	// narrow down to the mutations that are actually present in the haplosomes and aren't fixed
-	p = haplosomes.mutationFrequenciesInHaplosomes(muts);
-	muts = muts[(p != 0.0) & (p != 1.0)];
-
-	// do the calculation
-	k = size(muts);
-	n = haplosomes.size();
-	a_n = sum(1 / 1:(n-1));
-	theta = (k / a_n) / length;
-	return theta;
-})V0G0N";
-
 #pragma mark (float$)calcInbreedingLoad(object<Haplosome> haplosomes, [Nio<MutationType>$ mutType = NULL])
 const char *gSLiMSourceCode_calcInbreedingLoad = 
 R"V0G0N({
@@ -728,283 +345,853 @@ R"V0G0N({
 	return (sum(q*s) - sum(q^2*s) - 2*sum(q*(1-q)*s*h));
 })V0G0N";
 
-#pragma mark (float$)calcPi(object<Haplosome> haplosomes, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
-const char *gSLiMSourceCode_calcPi = 
-R"V0G0N({
-	if (haplosomes.length() < 2)
-		stop("ERROR (calcPi): haplosomes must contain at least two elements.");
+
+// ************************************************************************************
+//
+//	population genetics utilities (native)
+//
+#pragma mark -
+#pragma mark Population genetics utilities (native)
+#pragma mark -
+
+// These functions were originally implemented in Eidos, but they are called frequently enough (often every few ticks,
+// on large haplosome samples) that the interpreter overhead, temporary vectors, and repeated tallies were a problem.
+// The native versions below share their argument validation, and tally each haplosome sample just once, directly
+// from the MutationRun buffers, using Population::TallyMutationReferencesAcrossHaplosomes().  That tally runs in
+// parallel across MutationRunContexts when the sample belongs to a single chromosome.  The error messages and the
+// results match the previous Eidos implementations, which can be found in the Git history for reference.
+
+// Check that the haplosome sample(s) and the focal mutations all belong to p_species; p_haplosomes2 may be nullptr
+static void _PopGen_CheckSpecies(const char *p_caller, Species *p_species, EidosValue *p_haplosomes1, EidosValue *p_haplosomes2, EidosValue *p_muts)
+{
+	if (p_species->community_.AllSpecies().size() <= 1)
+		return;
 	
-	species = haplosomes[0].individual.subpopulation.species;
-	if (community.allSpecies.length() > 1)
+	if ((Community::SpeciesForHaplosomes(p_haplosomes1) != p_species) || (p_haplosomes2 && (Community::SpeciesForHaplosomes(p_haplosomes2) != p_species)))
+		EIDOS_TERMINATION << "ERROR (" << p_caller << "): all haplosomes must belong to the same species." << EidosTerminate();
+	
+	if ((p_muts->Type() != EidosValueType::kValueNULL) && (p_muts->Count() > 0) && (Community::SpeciesForMutations(p_muts) != p_species))
+		EIDOS_TERMINATION << "ERROR (" << p_caller << "): all mutations must belong to the same species as the haplosomes." << EidosTerminate();
+}
+
+// Check that the haplosome sample(s) and the focal mutations all belong to p_chromosome; p_haplosomes2 may be nullptr
+static void _PopGen_CheckSingleChromosome(const char *p_caller, Species *p_species, Chromosome *p_chromosome, EidosValue *p_haplosomes1, EidosValue *p_haplosomes2, EidosValue *p_muts)
+{
+	if (p_species->Chromosomes().size() <= 1)
+		return;
+	
+	slim_chromosome_index_t chromosome_index = p_chromosome->Index();
+	
+	for (EidosValue *haplosomes_value : {p_haplosomes1, p_haplosomes2})
 	{
-		if (any(haplosomes.individual.subpopulation.species != species))
-			stop("ERROR (calcPi): all haplosomes must belong to the same species.");
-		if (!isNULL(muts))
-			if (any(muts.mutationType.species != species))
-				stop("ERROR (calcPi): all mutations must belong to the same species as the haplosomes.");
+		if (!haplosomes_value)
+			continue;
+		
+		Haplosome * const *haplosomes = (Haplosome * const *)haplosomes_value->ObjectData();
+		int haplosomes_count = haplosomes_value->Count();
+		
+		for (int haplosome_index = 0; haplosome_index < haplosomes_count; ++haplosome_index)
+			if (haplosomes[haplosome_index]->AssociatedChromosome()->Index() != chromosome_index)
+				EIDOS_TERMINATION << "ERROR (" << p_caller << "): all haplosomes must be associated with the same chromosome." << EidosTerminate();
 	}
 	
-	chromosome = haplosomes[0].chromosome;
-	if (species.chromosomes.length() > 1)
+	if (p_muts->Type() != EidosValueType::kValueNULL)
 	{
-		if (any(haplosomes.chromosome != chromosome))
-			stop("ERROR (calcPi): all haplosomes must be associated with the same chromosome.");
-		if (!isNULL(muts))
-			if (any(muts.chromosome != chromosome))
-				stop("ERROR (calcPi): all mutations must be associated with the same chromosome as the haplosomes.");
+		Mutation * const *muts = (Mutation * const *)p_muts->ObjectData();
+		int muts_count = p_muts->Count();
+		
+		for (int mut_index = 0; mut_index < muts_count; ++mut_index)
+			if (muts[mut_index]->chromosome_index_ != chromosome_index)
+				EIDOS_TERMINATION << "ERROR (" << p_caller << "): all mutations must be associated with the same chromosome as the haplosomes." << EidosTerminate();
 	}
+}
+
+// Interpret the start/end arguments; returns true if a window was given, in which case p_start and p_end are set
+static bool _PopGen_WindowForArguments(const char *p_caller, Chromosome *p_chromosome, EidosValue *p_start_value, EidosValue *p_end_value, slim_position_t *p_start, slim_position_t *p_end)
+{
+	bool start_null = (p_start_value->Type() == EidosValueType::kValueNULL);
+	bool end_null = (p_end_value->Type() == EidosValueType::kValueNULL);
 	
-	length = chromosome.length;
+	if (start_null && end_null)
+		return false;
+	if (start_null || end_null)
+		EIDOS_TERMINATION << "ERROR (" << p_caller << "): start and end must both be NULL or both be non-NULL." << EidosTerminate();
 	
-	if (isNULL(muts))
-		muts = species.subsetMutations(chromosome=chromosome);
+	int64_t start = p_start_value->IntAtIndex_NOCAST(0, nullptr);
+	int64_t end = p_end_value->IntAtIndex_NOCAST(0, nullptr);
 	
-	// handle windowing
-	if (!isNULL(start) & !isNULL(end))
+	if (start > end)
+		EIDOS_TERMINATION << "ERROR (" << p_caller << "): start must be less than or equal to end." << EidosTerminate();
+	if ((start < 0) || (end > p_chromosome->last_position_))
+		EIDOS_TERMINATION << "ERROR (" << p_caller << "): start and end must be within the bounds of the focal chromosome" << EidosTerminate();
+	
+	*p_start = (slim_position_t)start;
+	*p_end = (slim_position_t)end;
+	return true;
+}
+
+// Assemble the focal mutations: those supplied, or all registered mutations on the included chromosomes, restricted to the window if any
+static void _PopGen_FocalMutations(Species *p_species, EidosValue *p_muts_value, const std::vector<bool> &p_chromosome_included, bool p_windowed, slim_position_t p_start, slim_position_t p_end, std::vector<Mutation *> &p_focal_muts)
+{
+	p_focal_muts.clear();
+	
+	if (p_muts_value->Type() != EidosValueType::kValueNULL)
 	{
-		if (start > end)
-			stop("ERROR (calcPi): start must be less than or equal to end.");
-		if ((start < 0) | (end >= length))
-			stop("ERROR (calcPi): start and end must be within the bounds of the focal chromosome");
-		mpos = muts.position;
-		muts = muts[(mpos >= start) & (mpos <= end)];
-		length = end - start + 1;
+		Mutation * const *muts = (Mutation * const *)p_muts_value->ObjectData();
+		int muts_count = p_muts_value->Count();
+		
+		p_focal_muts.reserve(muts_count);
+		
+		for (int mut_index = 0; mut_index < muts_count; ++mut_index)
+		{
+			Mutation *mut = muts[mut_index];
+			
+			if (!p_windowed || ((mut->position_ >= p_start) && (mut->position_ <= p_end)))
+				p_focal_muts.push_back(mut);
+		}
 	}
-	else if (!isNULL(start) | !isNULL(end))
+	else
 	{
-		stop("ERROR (calcPi): start and end must both be NULL or both be non-NULL.");
+		int registry_size;
+		const MutationIndex *registry = p_species->population_.MutationRegistry(&registry_size);
+		Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+		
+		p_focal_muts.reserve(registry_size);
+		
+		for (int registry_index = 0; registry_index < registry_size; ++registry_index)
+		{
+			Mutation *mut = mut_block_ptr + registry[registry_index];
+			
+			if (!p_chromosome_included[mut->chromosome_index_])
+				continue;
+			if (!p_windowed || ((mut->position_ >= p_start) && (mut->position_ <= p_end)))
+				p_focal_muts.push_back(mut);
+		}
 	}
+}
+
+// Tally the mutations in a haplosome sample, and fetch the counts for the focal mutations.  The count for each mutation
+// is taken within the haplosomes of the sample that belong to the mutation's chromosome; fixed and lost mutations that
+// are no longer in the registry get a count of the full sample size, or zero, respectively, as in mutationCountsInHaplosomes().
+// The tallied (non-null) haplosome count for each chromosome is left in Chromosome::tallied_haplosome_count_.
+static void _PopGen_TallySample(const char *p_caller, Species *p_species, Haplosome * const *p_haplosomes, int p_haplosomes_count, bool p_allow_null, const std::vector<Mutation *> &p_focal_muts, std::vector<slim_refcount_t> &p_counts)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("_PopGen_TallySample(): mutation tallies are shared state");
 	
-	// narrow down to the mutations that are actually present in the haplosomes and aren't fixed
-	p = haplosomes.mutationFrequenciesInHaplosomes(muts);
-	muts = muts[(p != 0.0) & (p != 1.0)];
+	if (!p_allow_null)
+		for (int haplosome_index = 0; haplosome_index < p_haplosomes_count; ++haplosome_index)
+			if (p_haplosomes[haplosome_index]->IsNull())
+				EIDOS_TERMINATION << "ERROR (" << p_caller << "): haplosomes must not contain null haplosomes." << EidosTerminate();
 	
-	// do the calculation
-	// obtain counts of variant sequences for all segregating sites
-	varCount = haplosomes.mutationCountsInHaplosomes(muts);
-	// total count of sequences minus count of variant sequences equals count of invariant sequences
-	invarCount = haplosomes.size() - varCount;
-	// count of pairwise differences per site is the product of counts of both alleles
-	// (equation 1 in Korunes and Samuk 2021); this is then summed for all sites 
-	diffs = sum(varCount * invarCount);
-	// pi is the ratio of pairwise differences to number of possible combinations of the given sequences
-	pi = diffs / ((haplosomes.size() * (haplosomes.size() - 1)) / 2);
-	// pi is conventionally averaged per site (consistent with SLiM's calculation of Watterson's theta)
-	avg_pi = pi / length;
-	return avg_pi;
-})V0G0N";
-
-#pragma mark (numeric)calcSFS([Ni$ binCount = NULL], [No<Haplosome> haplosomes = NULL], [No<Mutation> muts = NULL], [string$ metric = "density"], [logical$ fold = F])
-const char *gSLiMSourceCode_calcSFS = 
-R"V0G0N({
-	// first determine the haplosomes and the species
-	if (isNULL(haplosomes)) {
-		if (community.allSpecies.length() != 1)
-			stop("ERROR (): calcSFS() can only infer the value of haplosomes in a single-species model; otherwise, you need to supply the specific haplosomes to be used.");
-		
-		species = community.allSpecies;
-		haplosomes = sim.subpopulations.haplosomesNonNull;
-	}
-	else
+	Population &population = p_species->population_;
+	
+	population.CheckForDeferralInHaplosomesVector((Haplosome **)p_haplosomes, p_haplosomes_count, p_caller);
+	population.TallyMutationReferencesAcrossHaplosomes(p_haplosomes, p_haplosomes_count);
+	
+	const std::vector<Chromosome *> &chromosomes = p_species->Chromosomes();
+	const slim_refcount_t *refcount_block_ptr = gSLiM_Mutation_Refcounts;
+	size_t focal_count = p_focal_muts.size();
+	
+	p_counts.resize(focal_count);
+	
+	for (size_t mut_index = 0; mut_index < focal_count; ++mut_index)
 	{
-		if (haplosomes.length() == 0)
-			stop("ERROR (calcSFS): haplosomes must be non-empty.");
+		const Mutation *mut = p_focal_muts[mut_index];
+		int8_t mut_state = mut->state_;
+		slim_refcount_t count;
 		
-		species = haplosomes[0].individual.subpopulation.species;
+		if (mut_state == MutationState::kInRegistry)			count = *(refcount_block_ptr + mut->BlockIndex());
+		else if (mut_state == MutationState::kLostAndRemoved)	count = 0;
+		else													count = chromosomes[mut->chromosome_index_]->tallied_haplosome_count_;
 		
-		if (community.allSpecies.length() > 1)
+		p_counts[mut_index] = count;
+	}
+}
+
+// The per-function setup shared by calcHeterozygosity(), calcWattersonsTheta(), calcPi(), and calcTajimasD(): validate a
+// single haplosome sample for a single chromosome, determine the focal mutations and sequence length, and tally counts
+static void _PopGen_SingleSampleCounts(const char *p_caller, EidosValue *p_haplosomes_value, EidosValue *p_muts_value, EidosValue *p_start_value, EidosValue *p_end_value, std::vector<slim_refcount_t> &p_counts, slim_position_t *p_length)
+{
+	Haplosome * const *haplosomes = (Haplosome * const *)p_haplosomes_value->ObjectData();
+	int haplosomes_count = p_haplosomes_value->Count();
+	Species *species = &haplosomes[0]->OwningIndividual()->subpopulation_->species_;
+	Chromosome *chromosome = haplosomes[0]->AssociatedChromosome();
+	
+	_PopGen_CheckSpecies(p_caller, species, p_haplosomes_value, nullptr, p_muts_value);
+	_PopGen_CheckSingleChromosome(p_caller, species, chromosome, p_haplosomes_value, nullptr, p_muts_value);
+	
+	slim_position_t start = 0, end = chromosome->last_position_;
+	bool windowed = _PopGen_WindowForArguments(p_caller, chromosome, p_start_value, p_end_value, &start, &end);
+	std::vector<bool> chromosome_included(species->Chromosomes().size(), false);
+	std::vector<Mutation *> focal_muts;
+	
+	chromosome_included[chromosome->Index()] = true;
+	_PopGen_FocalMutations(species, p_muts_value, chromosome_included, windowed, start, end, focal_muts);
+	_PopGen_TallySample(p_caller, species, haplosomes, haplosomes_count, /* p_allow_null */ false, focal_muts, p_counts);
+	
+	*p_length = end - start + 1;
+}
+
+// The sums over segregating sites needed by calcPi(), calcWattersonsTheta(), and calcTajimasD(); these are all computed
+// from one tally, so that calcTajimasD() does not need to tally three times as the Eidos implementation did
+static void _PopGen_SegregatingSiteSums(const std::vector<slim_refcount_t> &p_counts, slim_refcount_t p_n, int64_t *p_segregating_count, int64_t *p_pairwise_diffs)
+{
+	int64_t segregating_count = 0, pairwise_diffs = 0;
+	
+	for (slim_refcount_t count : p_counts)
+	{
+		if ((count > 0) && (count < p_n))
 		{
-			if (any(haplosomes.individual.subpopulation.species != species))
-				stop("ERROR (calcSFS): all haplosomes must belong to the same species.");
+			segregating_count++;
+			pairwise_diffs += (int64_t)count * (p_n - count);
 		}
+	}
+	
+	*p_segregating_count = segregating_count;
+	*p_pairwise_diffs = pairwise_diffs;
+}
+
+//	(float$)calcDxy(object<Haplosome> haplosomes1, object<Haplosome> haplosomes2, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL], [logical$ normalize = F])
+EidosValue_SP SLiM_ExecuteFunction_calcDxy(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	EidosValue *haplosomes1_value = p_arguments[0].get();
+	EidosValue *haplosomes2_value = p_arguments[1].get();
+	EidosValue *muts_value = p_arguments[2].get();
+	EidosValue *start_value = p_arguments[3].get();
+	EidosValue *end_value = p_arguments[4].get();
+	EidosValue *normalize_value = p_arguments[5].get();
+	const char *caller = "calcDxy";
+	
+	int n1 = haplosomes1_value->Count();
+	int n2 = haplosomes2_value->Count();
+	
+	if ((n1 == 0) || (n2 == 0))
+		EIDOS_TERMINATION << "ERROR (calcDxy): haplosomes1 and haplosomes2 must both be non-empty." << EidosTerminate();
+	
+	Haplosome * const *haplosomes1 = (Haplosome * const *)haplosomes1_value->ObjectData();
+	Haplosome * const *haplosomes2 = (Haplosome * const *)haplosomes2_value->ObjectData();
+	Species *species = &haplosomes1[0]->OwningIndividual()->subpopulation_->species_;
+	Chromosome *chromosome = haplosomes1[0]->AssociatedChromosome();
+	
+	_PopGen_CheckSpecies(caller, species, haplosomes1_value, haplosomes2_value, muts_value);
+	_PopGen_CheckSingleChromosome(caller, species, chromosome, haplosomes1_value, haplosomes2_value, muts_value);
+	
+	slim_position_t start = 0, end = chromosome->last_position_;
+	bool windowed = _PopGen_WindowForArguments(caller, chromosome, start_value, end_value, &start, &end);
+	std::vector<bool> chromosome_included(species->Chromosomes().size(), false);
+	std::vector<Mutation *> focal_muts;
+	std::vector<slim_refcount_t> counts1, counts2;
+	
+	chromosome_included[chromosome->Index()] = true;
+	_PopGen_FocalMutations(species, muts_value, chromosome_included, windowed, start, end, focal_muts);
+	_PopGen_TallySample(caller, species, haplosomes1, n1, /* p_allow_null */ false, focal_muts, counts1);
+	_PopGen_TallySample(caller, species, haplosomes2, n2, /* p_allow_null */ false, focal_muts, counts2);
+	
+	// sum over sites segregating in the combined sample; note the implementation assumes "infinite sites" by assuming
+	// that a given site contains only a single SLiM mutation.  The "empty" allele at each site contributes the same
+	// number of differences as the mutation itself, which is why we double; this estimates Dxy as defined by Nei.
+	// Fixed mutations that have been substituted are excluded; their count is the full sample size in both samples.
+	int64_t n_total = (int64_t)n1 + n2;
+	double diff = 0.0;
+	bool any_segregating = false;
+	
+	for (size_t mut_index = 0; mut_index < focal_muts.size(); ++mut_index)
+	{
+		int64_t dos1 = counts1[mut_index];
+		int64_t dos2 = counts2[mut_index];
+		int64_t total = dos1 + dos2;
+		
+		if ((total == 0) || (total == n_total))
+			continue;
 		
-		// exclude null haplosomes silently
-		haplosomes = haplosomes[!haplosomes.isNullHaplosome];
+		any_segregating = true;
+		diff += 2.0 * (double)(dos1 * (n2 - dos2) + (n1 - dos1) * dos2);
 	}
 	
-	// validate binCount
-	if (!isNULL(binCount))
-		if ((binCount <= 0) | (binCount > 100000))
-				stop("ERROR (calcSFS): binCount must be in the range [1, 100000], or NULL.");
+	if (!any_segregating)		// if there are no mutations segregating, Dxy = 0
+		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(0.0));
 	
-	// if no haplosomes are supplied, we don't want to error (we want to work
-	// even when called on an empty simulation, for ease of use), so we just
-	// return zeros; note after this point haplosomes is guaranteed non-empty
-	if (haplosomes.length() == 0)
+	double dxy = diff / 2.0 / n1 / n2;
+	
+	if (normalize_value->LogicalAtIndex_NOCAST(0, nullptr))
+		dxy /= (end - start + 1);
+	
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(dxy));
+}
+
+//	(float$)calcFST(object<Haplosome> haplosomes1, object<Haplosome> haplosomes2, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
+EidosValue_SP SLiM_ExecuteFunction_calcFST(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	EidosValue *haplosomes1_value = p_arguments[0].get();
+	EidosValue *haplosomes2_value = p_arguments[1].get();
+	EidosValue *muts_value = p_arguments[2].get();
+	EidosValue *start_value = p_arguments[3].get();
+	EidosValue *end_value = p_arguments[4].get();
+	const char *caller = "calcFST";
+	
+	int n1 = haplosomes1_value->Count();
+	int n2 = haplosomes2_value->Count();
+	
+	if ((n1 == 0) || (n2 == 0))
+		EIDOS_TERMINATION << "ERROR (calcFST): haplosomes1 and haplosomes2 must both be non-empty." << EidosTerminate();
+	
+	Haplosome * const *haplosomes1 = (Haplosome * const *)haplosomes1_value->ObjectData();
+	Haplosome * const *haplosomes2 = (Haplosome * const *)haplosomes2_value->ObjectData();
+	Species *species = &haplosomes1[0]->OwningIndividual()->subpopulation_->species_;
+	
+	_PopGen_CheckSpecies(caller, species, haplosomes1_value, haplosomes2_value, muts_value);
+	
+	// unlike the other functions, calcFST() allows multiple chromosomes, as long as both samples cover the same set
+	size_t chromosome_count = species->Chromosomes().size();
+	std::vector<bool> chromosome_included(chromosome_count, false);
+	std::vector<bool> chromosome_included2(chromosome_count, false);
+	int included_count = 0;
+	
+	for (int haplosome_index = 0; haplosome_index < n1; ++haplosome_index)
+		chromosome_included[haplosomes1[haplosome_index]->AssociatedChromosome()->Index()] = true;
+	for (int haplosome_index = 0; haplosome_index < n2; ++haplosome_index)
+		chromosome_included2[haplosomes2[haplosome_index]->AssociatedChromosome()->Index()] = true;
+	
+	if (chromosome_included != chromosome_included2)
+		EIDOS_TERMINATION << "ERROR (calcFST): both haplosomes must be associated with the same set of chromosomes." << EidosTerminate();
+	
+	for (bool included : chromosome_included)
+		if (included)
+			included_count++;
+	
+	if (muts_value->Type() != EidosValueType::kValueNULL)
 	{
-		if (isNULL(binCount))
-				return integer(0);
-		return float(binCount);
+		Mutation * const *muts = (Mutation * const *)muts_value->ObjectData();
+		int muts_count = muts_value->Count();
+		
+		for (int mut_index = 0; mut_index < muts_count; ++mut_index)
+			if (!chromosome_included[muts[mut_index]->chromosome_index_])
+				EIDOS_TERMINATION << "ERROR (calcFST): all mutations must be associated with the same chromosomes as the haplosomes." << EidosTerminate();
 	}
 	
-	// a NULL binCount means: each haplosome is a sample, and bins should be
-	// counts, not frequency bins; with N samples, we have bins for the counts
-	// from 1 to N-1 (here we do 0 to N, we will remove the end bins downstream)
-	// note for this mode we do require that all haplosomes belong to a single
-	// chromosome; counts combined across different haplosomes are not valid
-	// in the general case.
-	binsAreSampleCounts = F;
-	if (isNULL(binCount))
+	// handle windowing
+	slim_position_t start = 0, end = 0;
+	bool windowed = false;
+	
+	if ((start_value->Type() != EidosValueType::kValueNULL) && (end_value->Type() != EidosValueType::kValueNULL) && (included_count > 1))
+		EIDOS_TERMINATION << "ERROR (calcFST): start/end cannot be specified with more than one chromosome." << EidosTerminate();
+	
+	windowed = _PopGen_WindowForArguments(caller, haplosomes1[0]->AssociatedChromosome(), start_value, end_value, &start, &end);
+	
+	std::vector<Mutation *> focal_muts;
+	std::vector<slim_refcount_t> counts1, counts2;
+	std::vector<slim_refcount_t> tallied1(chromosome_count), tallied2(chromosome_count);
+	
+	_PopGen_FocalMutations(species, muts_value, chromosome_included, windowed, start, end, focal_muts);
+	
+	// if the FST is undefined, return NAN; this occurs if muts is zero-length
+	if (focal_muts.size() == 0)
+		return gStaticEidosValue_FloatNAN;
+	
+	_PopGen_TallySample(caller, species, haplosomes1, n1, /* p_allow_null */ false, focal_muts, counts1);
+	for (size_t chromosome_index = 0; chromosome_index < chromosome_count; ++chromosome_index)
+		tallied1[chromosome_index] = species->Chromosomes()[chromosome_index]->tallied_haplosome_count_;
+	
+	_PopGen_TallySample(caller, species, haplosomes2, n2, /* p_allow_null */ false, focal_muts, counts2);
+	for (size_t chromosome_index = 0; chromosome_index < chromosome_count; ++chromosome_index)
+		tallied2[chromosome_index] = species->Chromosomes()[chromosome_index]->tallied_haplosome_count_;
+	
+	double sum_H_t = 0.0, sum_H_s = 0.0;
+	
+	for (size_t mut_index = 0; mut_index < focal_muts.size(); ++mut_index)
 	{
-		chromosome = haplosomes[0].chromosome;
-		if (any(haplosomes.chromosome != chromosome))
-				stop("ERROR (calcSFS): when binCount is NULL, all haplosomes must be associated with the same chromosome; counts should be within a single chromosome, since a different number of haplosomes could be present for different chromosomes.");
+		slim_chromosome_index_t chromosome_index = focal_muts[mut_index]->chromosome_index_;
+		double p1_p = counts1[mut_index] / (double)tallied1[chromosome_index];
+		double p2_p = counts2[mut_index] / (double)tallied2[chromosome_index];
+		double mean_p = (p1_p + p2_p) / 2.0;
 		
-		binCount = haplosomes.length() + 1;		// 0 to number of haplosomes
-		binsAreSampleCounts = T;
+		sum_H_t += 2.0 * mean_p * (1.0 - mean_p);
+		sum_H_s += p1_p * (1.0 - p1_p) + p2_p * (1.0 - p2_p);
 	}
 	
-	// apart from the case above, we do not need to require a single chromosome;
-	// we work with all mutations in the model, even if the haplosomes supplied
-	// belong to a single chromosome.  this works because mutations that are not
-	// present in any of the supplied haplosomes will have a frequency of zero
-	// (or NAN, if the mutation belongs to a different chromosome), and those
-	// will be filtered out below.
-	if (isNULL(muts))
+	double mean_H_t = sum_H_t / focal_muts.size();
+	double mean_H_s = sum_H_s / focal_muts.size();
+	
+	if (mean_H_t == 0)		// occurs if muts is not zero-length but all frequencies are zero
+		return gStaticEidosValue_FloatNAN;
+	
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(1.0 - mean_H_s / mean_H_t));
+}
+
+//	(float$)calcHeterozygosity(o<Haplosome> haplosomes, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
+EidosValue_SP SLiM_ExecuteFunction_calcHeterozygosity(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	EidosValue *haplosomes_value = p_arguments[0].get();
+	int n = haplosomes_value->Count();
+	
+	if (n == 0)
+		EIDOS_TERMINATION << "ERROR (calcHeterozygosity): haplosomes must be non-empty." << EidosTerminate();
+	
+	std::vector<slim_refcount_t> counts;
+	slim_position_t length;
+	
+	_PopGen_SingleSampleCounts("calcHeterozygosity", haplosomes_value, p_arguments[1].get(), p_arguments[2].get(), p_arguments[3].get(), counts, &length);
+	
+	double sum_pq = 0.0;
+	
+	for (slim_refcount_t count : counts)
 	{
-		muts = species.mutations;
+		double p = count / (double)n;
+		
+		sum_pq += p * (1 - p);
 	}
-	else
+	
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(2 * sum_pq / length));
+}
+
+// The shared implementation of calcLD_D() and calcLD_Rsquared(), using a bit-packed genotype matrix with mut1 in row 0 and
+// the mut2 mutations in the following rows; the joint counts are then popcounts over the AND of row 0 with each other row
+static EidosValue_SP _PopGen_CalcLD(const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter, const char *p_caller, bool p_r_statistic)
+{
+	Mutation *mut1 = (Mutation *)p_arguments[0]->ObjectElementAtIndex_NOCAST(0, nullptr);
+	EidosValue *mut2_value = p_arguments[1].get();
+	EidosValue *haplosomes_value = p_arguments[2].get();
+	bool squared = (p_r_statistic ? p_arguments[3]->LogicalAtIndex_NOCAST(0, nullptr) : false);
+	
+	// check species
+	Species *species = &mut1->mutation_type_ptr_->species_;
+	
+	if (SLiM_GetCommunityFromInterpreter(p_interpreter).AllSpecies().size() > 1)
 	{
-		if (any(muts.chromosome.species != species))
-			stop("ERROR (calcSFS): all mutations in muts must belong to the same species as the haplosomes; an SFS can be calculated only within a single species.");
+		if ((haplosomes_value->Type() != EidosValueType::kValueNULL) && (haplosomes_value->Count() > 0) && (Community::SpeciesForHaplosomes(haplosomes_value) != species))
+			EIDOS_TERMINATION << "ERROR (" << p_caller << "): all haplosomes must belong to the same species as mut1." << EidosTerminate();
+		if ((mut2_value->Type() != EidosValueType::kValueNULL) && (mut2_value->Count() > 0) && (Community::SpeciesForMutations(mut2_value) != species))
+			EIDOS_TERMINATION << "ERROR (" << p_caller << "): all mutations must belong to the same species as mut1." << EidosTerminate();
 	}
 	
-	if (!binsAreSampleCounts)
+	// check chromosome
+	slim_chromosome_index_t chromosome_index = mut1->chromosome_index_;
+	Chromosome *chromosome = species->Chromosomes()[chromosome_index];
+	
+	if (species->Chromosomes().size() > 1)
+	{
+		if (haplosomes_value->Type() != EidosValueType::kValueNULL)
+		{
+			Haplosome * const *haplosomes_data = (Haplosome * const *)haplosomes_value->ObjectData();
+			int haplosomes_count = haplosomes_value->Count();
+			
+			for (int haplosome_index = 0; haplosome_index < haplosomes_count; ++haplosome_index)
+				if (haplosomes_data[haplosome_index]->AssociatedChromosome() != chromosome)
+					EIDOS_TERMINATION << "ERROR (" << p_caller << "): all haplosomes must belong to the same chromosome as mut1." << EidosTerminate();
+		}
+		if (mut2_value->Type() != EidosValueType::kValueNULL)
+		{
+			Mutation * const *mut2_data = (Mutation * const *)mut2_value->ObjectData();
+			int mut2_count = mut2_value->Count();
+			
+			for (int mut_index = 0; mut_index < mut2_count; ++mut_index)
+				if (mut2_data[mut_index]->chromosome_index_ != chromosome_index)
+					EIDOS_TERMINATION << "ERROR (" << p_caller << "): all mutations must belong to the same chromosome as mut1." << EidosTerminate();
+		}
+	}
+	
+	// assemble the rows: mut1, followed by mut2; if mut2 is NULL, all mutations for the chromosome are used (including mut1)
+	std::vector<Mutation *> mut2_vec;
+	
+	if (mut2_value->Type() == EidosValueType::kValueNULL)
 	{
-		// get the frequencies; note mutationFrequenciesInHaplosomes() is smart enough
-		// to assess the frequency of each mutation only within the haplosomes that
-		// are associated with the same chromosome as the mutation, so this should do
-		// the right thing even in multichrom models.
-		freqs = haplosomes.mutationFrequenciesInHaplosomes(muts);
+		std::vector<bool> chromosome_included(species->Chromosomes().size(), false);
 		
-		// filter out frequencies of zero or NAN; they should not influence the SFS.
-		freqs = freqs[freqs != 0.0];
-		freqs = freqs[isFinite(freqs)];
+		chromosome_included[chromosome_index] = true;
+		_PopGen_FocalMutations(species, mut2_value, chromosome_included, /* p_windowed */ false, 0, 0, mut2_vec);
+	}
+	else
+	{
+		Mutation * const *mut2_data = (Mutation * const *)mut2_value->ObjectData();
 		
-		// discretize the frequencies into the specified number of bins
-		bins = pmin(asInteger(floor(freqs * binCount)), binCount - 1);
+		mut2_vec.assign(mut2_data, mut2_data + mut2_value->Count());
+	}
+	
+	// assemble the haplosomes; if haplosomes is NULL, all non-null haplosomes for the chromosome are used
+	std::vector<Haplosome *> haplosomes;
+	
+	if (haplosomes_value->Type() == EidosValueType::kValueNULL)
+	{
+		int first_haplosome_index = species->FirstHaplosomeIndices()[chromosome_index];
+		int last_haplosome_index = species->LastHaplosomeIndices()[chromosome_index];
 		
-		// tabulate the number of mutations in each frequency bin to make a histogram
-		tallies = tabulate(bins, maxbin=binCount-1);
+		for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : species->population_.subpops_)
+			for (Individual *ind : subpop_pair.second->parent_individuals_)
+				for (int haplosome_index = first_haplosome_index; haplosome_index <= last_haplosome_index; haplosome_index++)
+					if (!ind->haplosomes_[haplosome_index]->IsNull())
+						haplosomes.push_back(ind->haplosomes_[haplosome_index]);
 	}
 	else
 	{
-		// this is the "binCount=NULL" case, where each bin is an integer count
-		// we handle this separately to avoid possible float numerical error
-		counts = haplosomes.mutationCountsInHaplosomes(muts);
+		Haplosome * const *haplosomes_data = (Haplosome * const *)haplosomes_value->ObjectData();
+		int haplosomes_count = haplosomes_value->Count();
 		
-		// filter out counts of zero; they should not influence the SFS.
-		counts = counts[counts != 0.0];
+		for (int haplosome_index = 0; haplosome_index < haplosomes_count; ++haplosome_index)
+			if (haplosomes_data[haplosome_index]->IsNull())
+				EIDOS_TERMINATION << "ERROR (" << p_caller << "): haplosomes must not contain null haplosomes." << EidosTerminate();
 		
-		// tabulate the number of mutations in each count bin to make a histogram
-		tallies = tabulate(counts, maxbin=binCount-1);
+		haplosomes.assign(haplosomes_data, haplosomes_data + haplosomes_count);
+	}
+	
+	if (haplosomes.size() == 0)
+		EIDOS_TERMINATION << "ERROR (" << p_caller << "): haplosomes must be non-empty." << EidosTerminate();
+	
+	species->population_.CheckForDeferralInHaplosomesVector(haplosomes.data(), haplosomes.size(), p_caller);
+	
+	std::vector<MutationIndex> rows;
+	size_t mut2_count = mut2_vec.size();
+	
+	rows.reserve(mut2_count + 1);
+	rows.emplace_back(mut1->BlockIndex());
+	
+	for (Mutation *mut2 : mut2_vec)
+		rows.emplace_back(mut2->BlockIndex());
+	
+	GenotypeMatrix genotypes(haplosomes.data(), (int64_t)haplosomes.size(), rows.data(), (int64_t)rows.size());
+	
+	// D = 0 if either mutation is not present, and r^2 doesn't exist (0/0)
+	double n = (double)haplosomes.size();
+	int64_t count_1 = genotypes.CountForRow(0);
+	EidosValue_Float *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(mut2_count);
+	
+	if (count_1 == 0)
+	{
+		for (size_t mut_index = 0; mut_index < mut2_count; ++mut_index)
+			float_result->set_float_no_check(p_r_statistic ? std::numeric_limits<double>::quiet_NaN() : 0.0, mut_index);
 		
-		// unlike above (frequency bins), with count bins we discard the bottom
-		// and top bins; count bins span [1, N-1]; the top bin might contain fixed
-		// mutations in SLiM, but they are not empirically observable
-		if (binsAreSampleCounts)
-			tallies = tallies[1:(length(tallies)-2)];
+		return EidosValue_SP(float_result);
+	}
+	
+	double p_1 = count_1 / n;
+	
+	for (size_t mut_index = 0; mut_index < mut2_count; ++mut_index)
+	{
+		// fixed mutations that have been substituted are present in every haplosome, but are not in the matrix
+		const Mutation *mut2 = mut2_vec[mut_index];
+		int8_t mut2_state = mut2->state_;
+		double p_12, p_2;
+		
+		if (mut2_state == MutationState::kInRegistry)
+		{
+			p_12 = genotypes.CountForRowPair(0, mut_index + 1) / n;
+			p_2 = genotypes.CountForRow(mut_index + 1) / n;
+		}
+		else if (mut2_state == MutationState::kLostAndRemoved)
+		{
+			p_12 = 0.0;
+			p_2 = 0.0;
+		}
+		else
+		{
+			p_12 = p_1;
+			p_2 = 1.0;
+		}
+		
+		double D = p_12 - p_1 * p_2;
+		double result;
+		
+		if (!p_r_statistic)
+			result = D;
+		else if (squared)
+			result = (D * D) / (p_1 * p_2 * (1.0 - p_1) * (1.0 - p_2));		// r^2, between 0 and 1
+		else
+			result = D / std::sqrt(p_1 * p_2 * (1.0 - p_1) * (1.0 - p_2));	// r, between -1 and 1
+		
+		float_result->set_float_no_check(result, mut_index);
 	}
 	
-	// "fold" the SFS if requested, combining the first and last value, and on
-	// to the center; this is often done empirically because you don't know
-	// which allele is ancestral and which is derived.  the tricky thing is
-	// what to do with the central bin, if there is an odd number of bins; we
-	// add it to itself, but the central bin could be handled other ways too,
-	// such as excluding that data point (which the user can do after).
-	if (fold & (size(tallies) >= 2))
+	return EidosValue_SP(float_result);
+}
+
+//	(float)calcLD_D(object<Mutation>$ mut1, [No<Mutation> mut2 = NULL], [No<Haplosome> haplosomes = NULL])
+EidosValue_SP SLiM_ExecuteFunction_calcLD_D(const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
+{
+	return _PopGen_CalcLD(p_arguments, p_interpreter, "calcLD_D", /* p_r_statistic */ false);
+}
+
+//	(float)calcLD_Rsquared(object<Mutation>$ mut1, [No<Mutation> mut2 = NULL], [No<Haplosome> haplosomes = NULL], [logical$ squared = T])
+EidosValue_SP SLiM_ExecuteFunction_calcLD_Rsquared(const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
+{
+	return _PopGen_CalcLD(p_arguments, p_interpreter, "calcLD_Rsquared", /* p_r_statistic */ true);
+}
+
+//	(float$)calcWattersonsTheta(o<Haplosome> haplosomes, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
+EidosValue_SP SLiM_ExecuteFunction_calcWattersonsTheta(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	EidosValue *haplosomes_value = p_arguments[0].get();
+	int n = haplosomes_value->Count();
+	
+	if (n == 0)
+		EIDOS_TERMINATION << "ERROR (calcWattersonsTheta): haplosomes must be non-empty." << EidosTerminate();
+	
+	std::vector<slim_refcount_t> counts;
+	slim_position_t length;
+	int64_t k, pairwise_diffs;
+	
+	_PopGen_SingleSampleCounts("calcWattersonsTheta", haplosomes_value, p_arguments[1].get(), p_arguments[2].get(), p_arguments[3].get(), counts, &length);
+	_PopGen_SegregatingSiteSums(counts, n, &k, &pairwise_diffs);
+	
+	// with no segregating sites theta is zero; this also covers n == 1, for which a_n would be zero
+	if (k == 0)
+		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(0.0));
+	
+	double a_n = 0.0;
+	
+	for (int i = 1; i <= n - 1; ++i)
+		a_n += 1.0 / i;
+	
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float((k / a_n) / length));
+}
+
+//	(float$)calcPi(object<Haplosome> haplosomes, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
+EidosValue_SP SLiM_ExecuteFunction_calcPi(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	EidosValue *haplosomes_value = p_arguments[0].get();
+	int n = haplosomes_value->Count();
+	
+	if (n < 2)
+		EIDOS_TERMINATION << "ERROR (calcPi): haplosomes must contain at least two elements." << EidosTerminate();
+	
+	std::vector<slim_refcount_t> counts;
+	slim_position_t length;
+	int64_t k, diffs;
+	
+	_PopGen_SingleSampleCounts("calcPi", haplosomes_value, p_arguments[1].get(), p_arguments[2].get(), p_arguments[3].get(), counts, &length);
+	_PopGen_SegregatingSiteSums(counts, n, &k, &diffs);
+	
+	// count of pairwise differences per site is the product of counts of both alleles (equation 1 in Korunes and
+	// Samuk 2021), summed across sites; pi is the ratio of pairwise differences to the number of possible pairs of
+	// sequences, conventionally averaged per site (consistent with SLiM's calculation of Watterson's theta)
+	double pi = diffs / ((n * (int64_t)(n - 1)) / 2.0);
+	
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(pi / length));
+}
+
+//	(numeric)calcSFS([Ni$ binCount = NULL], [No<Haplosome> haplosomes = NULL], [No<Mutation> muts = NULL], [string$ metric = "density"], [logical$ fold = F])
+EidosValue_SP SLiM_ExecuteFunction_calcSFS(const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
+{
+	EidosValue *binCount_value = p_arguments[0].get();
+	EidosValue *haplosomes_value = p_arguments[1].get();
+	EidosValue *muts_value = p_arguments[2].get();
+	EidosValue *metric_value = p_arguments[3].get();
+	EidosValue *fold_value = p_arguments[4].get();
+	const char *caller = "calcSFS";
+	
+	// first determine the haplosomes and the species; null haplosomes are excluded silently
+	Species *species;
+	std::vector<Haplosome *> haplosomes;
+	
+	if (haplosomes_value->Type() == EidosValueType::kValueNULL)
 	{
-		midpoint = (length(tallies) - 1) / 2;
-		leftSeq = asInteger(seq(from=0, to=midpoint));
-		rightSeq = asInteger(seq(from=length(tallies)-1, to=midpoint));
-		tallies = tallies[leftSeq] + tallies[rightSeq];
+		Community &community = SLiM_GetCommunityFromInterpreter(p_interpreter);
+		
+		if (community.AllSpecies().size() != 1)
+			EIDOS_TERMINATION << "ERROR (calcSFS): calcSFS() can only infer the value of haplosomes in a single-species model; otherwise, you need to supply the specific haplosomes to be used." << EidosTerminate();
+		
+		species = community.AllSpecies()[0];
+		
+		int haplosome_count_per_individual = species->HaplosomeCountPerIndividual();
+		
+		for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : species->population_.subpops_)
+			for (Individual *ind : subpop_pair.second->parent_individuals_)
+				for (int haplosome_index = 0; haplosome_index < haplosome_count_per_individual; haplosome_index++)
+					if (!ind->haplosomes_[haplosome_index]->IsNull())
+						haplosomes.push_back(ind->haplosomes_[haplosome_index]);
 	}
+	else
+	{
+		int haplosomes_count = haplosomes_value->Count();
+		
+		if (haplosomes_count == 0)
+			EIDOS_TERMINATION << "ERROR (calcSFS): haplosomes must be non-empty." << EidosTerminate();
+		
+		Haplosome * const *haplosomes_data = (Haplosome * const *)haplosomes_value->ObjectData();
+		
+		species = &haplosomes_data[0]->OwningIndividual()->subpopulation_->species_;
+		
+		if ((species->community_.AllSpecies().size() > 1) && (Community::SpeciesForHaplosomes(haplosomes_value) != species))
+			EIDOS_TERMINATION << "ERROR (calcSFS): all haplosomes must belong to the same species." << EidosTerminate();
+		
+		for (int haplosome_index = 0; haplosome_index < haplosomes_count; ++haplosome_index)
+			if (!haplosomes_data[haplosome_index]->IsNull())
+				haplosomes.push_back(haplosomes_data[haplosome_index]);
+	}
+	
+	// validate binCount and metric
+	bool binsAreSampleCounts = (binCount_value->Type() == EidosValueType::kValueNULL);
+	int64_t binCount = (binsAreSampleCounts ? 0 : binCount_value->IntAtIndex_NOCAST(0, nullptr));
+	
+	if (!binsAreSampleCounts && ((binCount <= 0) || (binCount > 100000)))
+		EIDOS_TERMINATION << "ERROR (calcSFS): binCount must be in the range [1, 100000], or NULL." << EidosTerminate();
+	
+	const std::string &metric = ((EidosValue_String *)metric_value)->StringRefAtIndex_NOCAST(0, nullptr);
+	bool metric_is_density;
 	
-	// return either counts or densities, as requested; note that you can have
-	// binsAreSampleCounts be T, and yet return density values, that is legal,
-	// and just means that you want densities for singletons, doubletons, etc.
 	if (metric == "count")
-		return tallies;
+		metric_is_density = false;
 	else if (metric == "density")
-		return tallies / sum(tallies);
+		metric_is_density = true;
 	else
-		stop("ERROR (calcSFS): unrecognized value '" + metric + "' for parameter metric.");
-})V0G0N";
-
-#pragma mark (float$)calcTajimasD(object<Haplosome> haplosomes, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
-const char *gSLiMSourceCode_calcTajimasD = 
-R"V0G0N({
-	if (haplosomes.length() < 4)
-		stop("ERROR (calcTajimasD): haplosomes must contain at least four elements.");
+		EIDOS_TERMINATION << "ERROR (calcSFS): unrecognized value '" << metric << "' for parameter metric." << EidosTerminate();
 	
-	species = haplosomes[0].individual.subpopulation.species;
-	if (community.allSpecies.length() > 1)
+	// if no haplosomes are supplied, we don't want to error (we want to work even when called on an empty
+	// simulation, for ease of use), so we just return zeros; after this point haplosomes is guaranteed non-empty
+	if (haplosomes.size() == 0)
 	{
-		if (any(haplosomes.individual.subpopulation.species != species))
-			stop("ERROR (calcTajimasD): all haplosomes must belong to the same species.");
-		if (!isNULL(muts))
-			if (any(muts.mutationType.species != species))
-				stop("ERROR (calcTajimasD): all mutations must belong to the same species as the haplosomes.");
+		if (binsAreSampleCounts)
+			return gStaticEidosValue_Integer_ZeroVec;
+		
+		EidosValue_Float *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(binCount);
+		
+		for (int64_t bin_index = 0; bin_index < binCount; ++bin_index)
+			float_result->set_float_no_check(0.0, bin_index);
+		
+		return EidosValue_SP(float_result);
 	}
 	
-	chromosome = haplosomes[0].chromosome;
-	if (species.chromosomes.length() > 1)
+	// a NULL binCount means: each haplosome is a sample, and bins should be counts, not frequency bins; with N samples,
+	// we have bins for the counts from 1 to N-1.  For this mode we require that all haplosomes belong to a single
+	// chromosome; counts combined across different haplosomes are not valid in the general case.  Apart from this case,
+	// we do not need to require a single chromosome; mutations not present in any of the supplied haplosomes will have a
+	// frequency of zero (or NAN, if the mutation belongs to a different chromosome), and those are filtered out below.
+	if (binsAreSampleCounts)
 	{
-		if (any(haplosomes.chromosome != chromosome))
-			stop("ERROR (calcTajimasD): all haplosomes must be associated with the same chromosome.");
-		if (!isNULL(muts))
-			if (any(muts.chromosome != chromosome))
-				stop("ERROR (calcTajimasD): all mutations must be associated with the same chromosome as the haplosomes.");
+		slim_chromosome_index_t chromosome_index = haplosomes[0]->AssociatedChromosome()->Index();
+		
+		for (Haplosome *haplosome : haplosomes)
+			if (haplosome->AssociatedChromosome()->Index() != chromosome_index)
+				EIDOS_TERMINATION << "ERROR (calcSFS): when binCount is NULL, all haplosomes must be associated with the same chromosome; counts should be within a single chromosome, since a different number of haplosomes could be present for different chromosomes." << EidosTerminate();
+		
+		binCount = (int64_t)haplosomes.size() + 1;		// 0 to number of haplosomes
 	}
 	
-	length = chromosome.length;
+	if ((muts_value->Type() != EidosValueType::kValueNULL) && (muts_value->Count() > 0) && (Community::SpeciesForMutations(muts_value) != species))
+		EIDOS_TERMINATION << "ERROR (calcSFS): all mutations in muts must belong to the same species as the haplosomes; an SFS can be calculated only within a single species." << EidosTerminate();
 	
-	if (isNULL(muts))
-		muts = species.subsetMutations(chromosome=chromosome);
+	std::vector<bool> chromosome_included(species->Chromosomes().size(), true);
+	std::vector<Mutation *> focal_muts;
+	std::vector<slim_refcount_t> counts;
 	
-	// handle windowing
-	if (!isNULL(start) & !isNULL(end))
+	_PopGen_FocalMutations(species, muts_value, chromosome_included, /* p_windowed */ false, 0, 0, focal_muts);
+	_PopGen_TallySample(caller, species, haplosomes.data(), (int)haplosomes.size(), /* p_allow_null */ false, focal_muts, counts);
+	
+	// tabulate the number of mutations in each bin to make a histogram; frequencies of zero or NAN, and counts of
+	// zero, are filtered out since they should not influence the SFS
+	std::vector<int64_t> tallies(binCount, 0);
+	
+	if (!binsAreSampleCounts)
 	{
-		if (start > end)
-			stop("ERROR (calcTajimasD): start must be less than or equal to end.");
-		if ((start < 0) | (end >= length))
-			stop("ERROR (calcTajimasD): start and end must be within the bounds of the focal chromosome");
-		mpos = muts.position;
-		muts = muts[(mpos >= start) & (mpos <= end)];
-		length = end - start + 1;
+		const std::vector<Chromosome *> &chromosomes = species->Chromosomes();
+		
+		for (size_t mut_index = 0; mut_index < focal_muts.size(); ++mut_index)
+		{
+			double freq = counts[mut_index] / (double)chromosomes[focal_muts[mut_index]->chromosome_index_]->tallied_haplosome_count_;
+			
+			if ((freq == 0.0) || !std::isfinite(freq))
+				continue;
+			
+			int64_t bin = std::min((int64_t)std::floor(freq * binCount), binCount - 1);
+			
+			tallies[bin]++;
+		}
 	}
-	else if (!isNULL(start) | !isNULL(end))
+	else
+	{
+		for (slim_refcount_t count : counts)
+			if (count != 0)
+				tallies[count]++;
+		
+		// unlike frequency bins, with count bins we discard the bottom and top bins; count bins span [1, N-1]; the
+		// top bin might contain fixed mutations in SLiM, but they are not empirically observable
+		tallies.pop_back();
+		tallies.erase(tallies.begin());
+	}
+	
+	// "fold" the SFS if requested, combining the first and last value, and on to the center; this is often done
+	// empirically because you don't know which allele is ancestral and which is derived.  With an odd number of bins,
+	// the central bin is added to itself; it could be handled other ways, such as being excluded by the user after.
+	if (fold_value->LogicalAtIndex_NOCAST(0, nullptr) && (tallies.size() >= 2))
 	{
-		stop("ERROR (calcTajimasD): start and end must both be NULL or both be non-NULL.");
+		size_t tallies_count = tallies.size();
+		size_t folded_count = (tallies_count + 1) / 2;
+		std::vector<int64_t> folded(folded_count);
+		
+		for (size_t bin_index = 0; bin_index < folded_count; ++bin_index)
+			folded[bin_index] = tallies[bin_index] + tallies[tallies_count - 1 - bin_index];
+		
+		tallies.swap(folded);
 	}
 	
-	// narrow down to the mutations that are actually present in the haplosomes and aren't fixed
-	p = haplosomes.mutationFrequenciesInHaplosomes(muts);
-	muts = muts[(p != 0.0) & (p != 1.0)];
+	// return either counts or densities, as requested; binsAreSampleCounts can be T with density values returned,
+	// which just means that the user wants densities for singletons, doubletons, etc.
+	size_t tallies_count = tallies.size();
+	
+	if (!metric_is_density)
+	{
+		EidosValue_Int *int_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Int())->resize_no_initialize(tallies_count);
+		
+		for (size_t bin_index = 0; bin_index < tallies_count; ++bin_index)
+			int_result->set_int_no_check(tallies[bin_index], bin_index);
+		
+		return EidosValue_SP(int_result);
+	}
+	else
+	{
+		int64_t total = 0;
+		
+		for (int64_t tally : tallies)
+			total += tally;
+		
+		EidosValue_Float *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(tallies_count);
+		
+		for (size_t bin_index = 0; bin_index < tallies_count; ++bin_index)
+			float_result->set_float_no_check(tallies[bin_index] / (double)total, bin_index);
+		
+		return EidosValue_SP(float_result);
+	}
+}
+
+//	(float$)calcTajimasD(object<Haplosome> haplosomes, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
+EidosValue_SP SLiM_ExecuteFunction_calcTajimasD(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	EidosValue *haplosomes_value = p_arguments[0].get();
+	int n = haplosomes_value->Count();
+	
+	if (n < 4)
+		EIDOS_TERMINATION << "ERROR (calcTajimasD): haplosomes must contain at least four elements." << EidosTerminate();
+	
+	std::vector<slim_refcount_t> counts;
+	slim_position_t length;
+	int64_t k, diffs;
+	
+	_PopGen_SingleSampleCounts("calcTajimasD", haplosomes_value, p_arguments[1].get(), p_arguments[2].get(), p_arguments[3].get(), counts, &length);
+	_PopGen_SegregatingSiteSums(counts, n, &k, &diffs);
+	
+	// pi and Watterson's theta, without division by sequence length, both from the same tally
+	double a_1 = 0.0, a_2 = 0.0;
+	
+	for (int i = 1; i <= n - 1; ++i)
+	{
+		a_1 += 1.0 / i;
+		a_2 += 1.0 / ((double)i * i);
+	}
+	
+	double pi = diffs / ((n * (int64_t)(n - 1)) / 2.0);
+	double theta = (k == 0) ? 0.0 : (k / a_1);
+	double diff = pi - theta;
 	
-	// do the calculation
-	// Pi and Watterson's theta functions divide by sequence length so this must be undone in Tajima's D
-	// Sequence length is constant (i.e. no missing data or indels) so this can be applied equally over both metrics
-	diff = (calcPi(haplosomes, muts, start, end) - calcWattersonsTheta(haplosomes, muts, start, end)) * length;
 	// calculate standard deviation of covariance of pi and Watterson's theta
-	// note that first 3 variables defined below are sufficient for Watterson's theta calculation as well,
-	// although the calcWattersonsTheta() function is used above for proper interval handling and clarity 
-	k = size(muts);
-	n = haplosomes.size();
-	a_1 = sum(1 / 1:(n - 1));
-	a_2 = sum(1 / (1:(n - 1)) ^ 2);
-	b_1 = (n + 1) / (3 * (n - 1));
-	b_2 = 2 * (n ^ 2 + n + 3) / (9 * n * (n - 1));
-	c_1 = b_1 - 1 / a_1;
-	c_2 = b_2 - (n + 2) / (a_1 * n) + a_2 / a_1 ^ 2;
-	e_1 = c_1 / a_1;
-	e_2 = c_2 / (a_1 ^ 2 + a_2);
-	covar = e_1 * k + e_2 * k * (k - 1);
-	stdev = sqrt(covar);
-	tajima_d = diff / stdev;
-	return tajima_d;
-})V0G0N";
+	double b_1 = (n + 1) / (3.0 * (n - 1));
+	double b_2 = 2.0 * ((double)n * n + n + 3) / (9.0 * n * (n - 1));
+	double c_1 = b_1 - 1 / a_1;
+	double c_2 = b_2 - (n + 2) / (a_1 * n) + a_2 / (a_1 * a_1);
+	double e_1 = c_1 / a_1;
+	double e_2 = c_2 / (a_1 * a_1 + a_2);
+	double covar = e_1 * k + e_2 * k * (k - 1);
+	double stdev = sqrt(covar);
+	
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(diff / stdev));
+}
 
 
 // ************************************************************************************
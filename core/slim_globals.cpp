@@ -186,6 +186,8 @@ std::ostringstream gSLiMError;
 std::ostringstream gSLiMScheduling;
 #endif
 
+bool gSLiMForceParallelPaths = false;
+
 
 #pragma mark -
 #pragma mark Types and max values
@@ -500,6 +502,7 @@ void SumUpMemoryUsage_Species(SLiMMemoryUsage_Species &p_usage)
 		p_usage.mutationObjects +
 		p_usage.mutationRunObjects +
 		p_usage.mutationRunExternalBuffers +
+		p_usage.mutationRunPackedBuffers +
 		p_usage.mutationRunNonneutralCaches +
 		p_usage.mutationRunUnusedPoolSpace +
 		p_usage.mutationRunUnusedPoolBuffers +
@@ -564,6 +567,8 @@ void AccumulateMemoryUsageIntoTotal_Species(SLiMMemoryUsage_Species &p_usage, SL
 	p_total.mutationRunObjects_count += p_usage.mutationRunObjects_count;
 	p_total.mutationRunObjects += p_usage.mutationRunObjects;
 	p_total.mutationRunExternalBuffers += p_usage.mutationRunExternalBuffers;
+	p_total.mutationRunPackedBuffers += p_usage.mutationRunPackedBuffers;
+	p_total.mutationRunPackingSavings += p_usage.mutationRunPackingSavings;
 	p_total.mutationRunNonneutralCaches += p_usage.mutationRunNonneutralCaches;
 	p_total.mutationRunUnusedPoolSpace += p_usage.mutationRunUnusedPoolSpace;
 	p_total.mutationRunUnusedPoolBuffers += p_usage.mutationRunUnusedPoolBuffers;
@@ -1332,6 +1337,9 @@ const std::string &gStr_periodicity = EidosRegisteredString("periodicity", gID_p
 const std::string &gStr_spatiality = EidosRegisteredString("spatiality", gID_spatiality);
 const std::string &gStr_spatialPosition = EidosRegisteredString("spatialPosition", gID_spatialPosition);
 const std::string &gStr_maxDistance = EidosRegisteredString("maxDistance", gID_maxDistance);
+const std::string &gStr_spatialIndex = EidosRegisteredString("spatialIndex", gID_spatialIndex);
+const std::string &gStr_kdTreeRefit = EidosRegisteredString("kdTreeRefit", gID_kdTreeRefit);
+const std::string &gStr_strengthCache = EidosRegisteredString("strengthCache", gID_strengthCache);
 
 // mostly method names
 const std::string &gStr_ancestralNucleotides = EidosRegisteredString("ancestralNucleotides", gID_ancestralNucleotides);
@@ -1398,6 +1406,7 @@ const std::string &gStr_mutationCounts = EidosRegisteredString("mutationCounts",
 const std::string &gStr_mutationCountsInHaplosomes = EidosRegisteredString("mutationCountsInHaplosomes", gID_mutationCountsInHaplosomes);
 const std::string &gStr_mutationFrequencies = EidosRegisteredString("mutationFrequencies", gID_mutationFrequencies);
 const std::string &gStr_mutationFrequenciesInHaplosomes = EidosRegisteredString("mutationFrequenciesInHaplosomes", gID_mutationFrequenciesInHaplosomes);
+const std::string &gStr_genotypeMatrix = EidosRegisteredString("genotypeMatrix", gID_genotypeMatrix);
 //const std::string &gStr_mutationsOfType = EidosRegisteredString("mutationsOfType", gID_mutationsOfType);
 //const std::string &gStr_countOfMutationsOfType = EidosRegisteredString("countOfMutationsOfType", gID_countOfMutationsOfType);
 const std::string &gStr_outputFixedMutations = EidosRegisteredString("outputFixedMutations", gID_outputFixedMutations);
@@ -1444,6 +1453,7 @@ const std::string &gStr_setSpatialBounds = EidosRegisteredString("setSpatialBoun
 const std::string &gStr_setSubpopulationSize = EidosRegisteredString("setSubpopulationSize", gID_setSubpopulationSize);
 const std::string &gStr_addCloned = EidosRegisteredString("addCloned", gID_addCloned);
 const std::string &gStr_addCrossed = EidosRegisteredString("addCrossed", gID_addCrossed);
+const std::string &gStr_addCrossedBatch = EidosRegisteredString("addCrossedBatch", gID_addCrossedBatch);
 const std::string &gStr_addEmpty = EidosRegisteredString("addEmpty", gID_addEmpty);
 const std::string &gStr_addMultiRecombinant = EidosRegisteredString("addMultiRecombinant", gID_addMultiRecombinant);
 const std::string &gStr_addRecombinant = EidosRegisteredString("addRecombinant", gID_addRecombinant);
@@ -1630,6 +1640,7 @@ const std::string &gStr_species = EidosRegisteredString("species", gID_species);
 const std::string &gStr_ticks = EidosRegisteredString("ticks", gID_ticks);
 const std::string &gStr_speciesSpec = EidosRegisteredString("speciesSpec", gID_speciesSpec);
 const std::string &gStr_ticksSpec = EidosRegisteredString("ticksSpec", gID_ticksSpec);
+const std::string &gStr_vectorized = EidosRegisteredString("vectorized", gID_vectorized);
 const std::string &gStr_first = EidosRegisteredString("first", gID_first);
 const std::string &gStr_early = EidosRegisteredString("early", gID_early);
 const std::string &gStr_late = EidosRegisteredString("late", gID_late);
@@ -2540,6 +2551,69 @@ void WriteProfileResults(std::string profile_output_path, std::string model_name
 	}
 #endif
 	
+	//
+	//	Tree-sequence simplification metrics, presented per Species
+	//
+	for (Species *focal_species : community->AllSpecies())
+	{
+		if (!focal_species->RecordingTreeSequence() || (focal_species->profile_simplify_count_ == 0))
+			continue;
+		
+		double wall_time = Eidos_ElapsedProfileTime(focal_species->profile_simplify_wall_time_);
+		double chromosome_time = Eidos_ElapsedProfileTime(focal_species->profile_simplify_chromosome_time_);
+		
+		fout << "<h3>Tree-sequence simplification";
+		if (community->AllSpecies().size() > 1)
+			fout << " (" << HTMLEncodeString(focal_species->avatar_) << " " << HTMLEncodeString(focal_species->name_) << ")";
+		fout << "</h3>\n";
+		
+		fout << "<p><tt>" << focal_species->profile_simplify_count_ << "</tt> simplifications of " << focal_species->Chromosomes().size() << " chromosome" << ((focal_species->Chromosomes().size() == 1) ? "" : "s") << "<BR>\n";
+		snprintf(buf, 256, "%0.2f s", wall_time);
+		fout << "<tt>" << buf << "</tt> wall clock time simplifying chromosomes<BR>\n";
+		snprintf(buf, 256, "%0.2f s", chromosome_time);
+		fout << "<tt>" << buf << "</tt> simplification time summed across chromosomes<BR>\n";
+		snprintf(buf, 256, "%0.2fx", (wall_time > 0.0) ? (chromosome_time / wall_time) : 1.0);
+		fout << "<tt>" << buf << "</tt> speedup from simplifying chromosomes in parallel</p>\n\n";
+	}
+	
+	//
+	//	Lost/fixed mutation removal metrics, presented per Species
+	//
+	for (Species *focal_species : community->AllSpecies())
+	{
+		double removal_time = Eidos_ElapsedProfileTime(focal_species->profile_fixation_time_);
+		
+		fout << "<h3>Lost/fixed mutation removal";
+		if (community->AllSpecies().size() > 1)
+			fout << " (" << HTMLEncodeString(focal_species->avatar_) << " " << HTMLEncodeString(focal_species->name_) << ")";
+		fout << "</h3>\n";
+		
+		snprintf(buf, 256, "%0.2f s", removal_time);
+		fout << "<p><tt>" << buf << "</tt> removing lost and fixed mutations<BR>\n";
+		fout << "<tt>" << focal_species->profile_fixation_substitution_count_ << "</tt> substitutions in " << focal_species->profile_fixation_cycle_count_ << " cycle" << ((focal_species->profile_fixation_cycle_count_ == 1) ? "" : "s") << "<BR>\n";
+		fout << "<tt>" << focal_species->profile_fixation_mutrun_count_ << "</tt> distinct mutation runs modified to remove fixed mutations</p>\n\n";
+	}
+	
+	//
+	//	Interaction strength cache metrics, presented per InteractionType
+	//
+	for (auto &iter : community->AllInteractionTypes())
+	{
+		InteractionType *interaction_type = iter.second;
+		int64_t hits = interaction_type->profile_strength_cache_hits_;
+		int64_t misses = interaction_type->profile_strength_cache_misses_;
+		
+		if (hits + misses == 0)
+			continue;
+		
+		fout << "<h3>Interaction strength cache (i" << interaction_type->interaction_type_id_ << ")</h3>\n";
+		
+		fout << "<p><tt>" << hits << "</tt> receiver strengths reused from the cache<BR>\n";
+		fout << "<tt>" << misses << "</tt> receiver strengths computed and cached<BR>\n";
+		snprintf(buf, 256, "%0.2f%%", (hits * 100.0) / (hits + misses));
+		fout << "<tt>" << buf << "</tt> hit rate</p>\n\n";
+	}
+	
 	//
 	//	Memory usage metrics
 	//
@@ -2613,6 +2687,7 @@ void WriteProfileResults(std::string profile_output_path, std::string model_name
 		snprintf(buf, 256, "%0.2f", mem_tot_S.mutationRunObjects_count / ddiv);
 		fout << "<p><tt>" << ColoredSpanForByteCount(mem_tot_S.mutationRunObjects / div, average_total) << "</tt> / <tt>" << ColoredSpanForByteCount(mem_last_S.mutationRunObjects, final_total) << "</tt> : MutationRun objects (" << buf << " / " << mem_last_S.mutationRunObjects_count << ")<BR>\n";
 		fout << "<tt>&nbsp;&nbsp;&nbsp;" << ColoredSpanForByteCount(mem_tot_S.mutationRunExternalBuffers / div, average_total) << "</tt> / <tt>" << ColoredSpanForByteCount(mem_last_S.mutationRunExternalBuffers, final_total) << "</tt> : external MutationIndex buffers<BR>\n";
+		fout << "<tt>&nbsp;&nbsp;&nbsp;" << ColoredSpanForByteCount(mem_tot_S.mutationRunPackedBuffers / div, average_total) << "</tt> / <tt>" << ColoredSpanForByteCount(mem_last_S.mutationRunPackedBuffers, final_total) << "</tt> : packed MutationIndex buffers<BR>\n";
 		fout << "<tt>&nbsp;&nbsp;&nbsp;" << ColoredSpanForByteCount(mem_tot_S.mutationRunNonneutralCaches / div, average_total) << "</tt> / <tt>" << ColoredSpanForByteCount(mem_last_S.mutationRunNonneutralCaches, final_total) << "</tt> : nonneutral mutation caches<BR>\n";
 		fout << "<tt>&nbsp;&nbsp;&nbsp;" << ColoredSpanForByteCount(mem_tot_S.mutationRunUnusedPoolSpace / div, average_total) << "</tt> / <tt>" << ColoredSpanForByteCount(mem_last_S.mutationRunUnusedPoolSpace, final_total) << "</tt> : unused pool space<BR>\n";
 		fout << "<tt>&nbsp;&nbsp;&nbsp;" << ColoredSpanForByteCount(mem_tot_S.mutationRunUnusedPoolBuffers / div, average_total) << "</tt> / <tt>" << ColoredSpanForByteCount(mem_last_S.mutationRunUnusedPoolBuffers, final_total) << "</tt> : unused pool buffers</p>\n\n";
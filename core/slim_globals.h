@@ -89,6 +89,11 @@ extern std::ostringstream gSLiMError;
 extern std::ostringstream gSLiMScheduling;		// information about scheduling in each tick
 #endif
 
+// If true, the code paths used for parallel work -- buffered tree-sequence recording during WF reproduction, and precomputation of
+// chromosomal fitness across subpopulations -- are taken even when they would not be, such as in single-threaded builds.  This is
+// set only by the self-tests, which compare the results against those from the normal code paths.
+extern bool gSLiMForceParallelPaths;
+
 
 // *******************************************************************************************************************
 //
@@ -322,7 +327,8 @@ void Eidos_Deleter(void *ptr) {
 
  The dynamics of Mutation are unusual and require further discussion.  The global shared gSLiM_Mutation_Block pool
  is used instead of EidosObjectPool because all mutations must be allocated out of a single contiguous memory bloc
- in order to be indexable with MutationIndex (whereas EidosObjectPool dynamically creates new blocs).  This allows
+ in order to be indexable with MutationIndex (whereas EidosObjectPool dynamically creates new blocs).  The bloc is
+ carved out of a range of address space reserved at startup, so it grows in place and mutations never move.  This allows
  references to mutations in MutationRun to be done with 32-bit MutationIndexes rather than 64-bit pointers, giving
  better performance.  Mutation, as a subclass of EidosDictionaryRetained, is under retain/release, but the uses of
  Mutation inside SLiM's core do not cause retain/release activity, for efficiency; instead, the population keeps a
@@ -421,6 +427,8 @@ typedef struct
 	int64_t mutationRunObjects_count;
 	size_t mutationRunObjects;
 	size_t mutationRunExternalBuffers;
+	size_t mutationRunPackedBuffers;			// with compressMutationRuns=T; see MutationRun::PackMutations()
+	size_t mutationRunPackingSavings;			// NOT memory usage, so NOT included in totals; the bytes saved by packing
 	size_t mutationRunNonneutralCaches;
 	size_t mutationRunUnusedPoolSpace;			// this pool is kept by Species
 	size_t mutationRunUnusedPoolBuffers;		// this pool is kept by Species
@@ -913,6 +921,9 @@ extern const std::string &gStr_periodicity;
 extern const std::string &gStr_spatiality;
 extern const std::string &gStr_spatialPosition;
 extern const std::string &gStr_maxDistance;
+extern const std::string &gStr_spatialIndex;
+extern const std::string &gStr_kdTreeRefit;
+extern const std::string &gStr_strengthCache;
 
 extern const std::string &gStr_ancestralNucleotides;
 extern const std::string &gStr_nucleotides;
@@ -978,6 +989,7 @@ extern const std::string &gStr_mutationCounts;
 extern const std::string &gStr_mutationCountsInHaplosomes;
 extern const std::string &gStr_mutationFrequencies;
 extern const std::string &gStr_mutationFrequenciesInHaplosomes;
+extern const std::string &gStr_genotypeMatrix;
 //extern const std::string &gStr_mutationsOfType;
 //extern const std::string &gStr_countOfMutationsOfType;
 extern const std::string &gStr_outputFixedMutations;
@@ -1024,6 +1036,7 @@ extern const std::string &gStr_setSpatialBounds;
 extern const std::string &gStr_setSubpopulationSize;
 extern const std::string &gStr_addCloned;
 extern const std::string &gStr_addCrossed;
+extern const std::string &gStr_addCrossedBatch;
 extern const std::string &gStr_addEmpty;
 extern const std::string &gStr_addMultiRecombinant;
 extern const std::string &gStr_addRecombinant;
@@ -1204,6 +1217,7 @@ extern const std::string &gStr_species;
 extern const std::string &gStr_ticks;
 extern const std::string &gStr_speciesSpec;
 extern const std::string &gStr_ticksSpec;
+extern const std::string &gStr_vectorized;
 extern const std::string &gStr_first;
 extern const std::string &gStr_early;
 extern const std::string &gStr_late;
@@ -1376,6 +1390,9 @@ enum _SLiMGlobalStringID : int {
 	gID_spatiality,
 	gID_spatialPosition,
 	gID_maxDistance,
+	gID_spatialIndex,
+	gID_kdTreeRefit,
+	gID_strengthCache,
 	
 	gID_ancestralNucleotides,
 	gID_nucleotides,
@@ -1441,6 +1458,7 @@ enum _SLiMGlobalStringID : int {
 	gID_mutationCountsInHaplosomes,
 	gID_mutationFrequencies,
 	gID_mutationFrequenciesInHaplosomes,
+	gID_genotypeMatrix,
 	//gID_mutationsOfType,
 	//gID_countOfMutationsOfType,
 	gID_outputFixedMutations,
@@ -1487,6 +1505,7 @@ enum _SLiMGlobalStringID : int {
 	gID_setSubpopulationSize,
 	gID_addCloned,
 	gID_addCrossed,
+	gID_addCrossedBatch,
 	gID_addEmpty,
 	gID_addMultiRecombinant,
 	gID_addRecombinant,
@@ -1652,6 +1671,7 @@ enum _SLiMGlobalStringID : int {
 	gID_ticks,
 	gID_speciesSpec,
 	gID_ticksSpec,
+	gID_vectorized,
 	gID_first,
 	gID_early,
 	gID_late,
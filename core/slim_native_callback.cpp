@@ -0,0 +1,539 @@
+//
+//  slim_native_callback.cpp
+//  SLiM
+//
+//  Created by Ben Haller on 10/16/26.
+//  Copyright (c) 2026 Benjamin C. Haller.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of SLiM.
+//
+//	SLiM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	SLiM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with SLiM.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "slim_native_callback.h"
+#include "slim_eidos_block.h"
+#include "individual.h"
+#include "eidos_ast_node.h"
+#include "eidos_rng.h"
+
+#include <cmath>
+#include <algorithm>
+
+
+// kChunkSize is bound to a reference by std::min() in EvaluateMany(), so it needs a definition; unoptimized builds fail to link without it
+const size_t SLiMNativeCallback::kChunkSize;
+
+// The math functions we compile, with the ops they compile to; all take one numeric argument, x, and return float
+static const struct { const char *name_; SLiMNativeOp op_; } gSLiMNativeMathFunctions[] = {
+	{"exp", SLiMNativeOp::kExp}, {"log", SLiMNativeOp::kLog}, {"log10", SLiMNativeOp::kLog10}, {"log2", SLiMNativeOp::kLog2},
+	{"sqrt", SLiMNativeOp::kSqrt}, {"sin", SLiMNativeOp::kSin}, {"cos", SLiMNativeOp::kCos}, {"tan", SLiMNativeOp::kTan}
+};
+
+// Get the value node for a function argument, which may be named; returns nullptr if it is named something other than p_name
+static const EidosASTNode *_SLiMNativeArgument(const EidosASTNode *p_arg_node, const char *p_name)
+{
+	if (p_arg_node->token_->token_type_ == EidosTokenType::kTokenAssign)
+	{
+		if ((p_arg_node->children_.size() == 2) && (p_arg_node->children_[0]->token_->token_string_ == p_name))
+			return p_arg_node->children_[1];
+		
+		return nullptr;
+	}
+	
+	return p_arg_node;
+}
+
+bool SLiMNativeCallback::_CompileNode(const EidosASTNode *p_node, bool p_effect_defined, int p_depth, bool *p_is_float, std::string &p_failure_reason)
+{
+	EidosTokenType token_type = p_node->token_->token_type_;
+	const std::string &token_string = p_node->token_->token_string_;
+	size_t child_count = p_node->children_.size();
+	
+	if (p_depth >= kMaxStackDepth)
+	{
+		p_failure_reason = "the expression is too deeply nested";
+		return false;
+	}
+	
+	switch (token_type)
+	{
+		case EidosTokenType::kTokenNumber:
+		{
+			const EidosValue *literal = p_node->cached_literal_value_.get();
+			
+			if (!literal || (literal->Count() != 1))
+			{
+				p_failure_reason = "the numeric literal " + token_string + " could not be evaluated";
+				return false;
+			}
+			
+			program_.emplace_back(SLiMNativeInstruction{SLiMNativeOp::kConstant, literal->NumericAtIndex_NOCAST(0, nullptr), 0.0, p_node->token_});
+			*p_is_float = (literal->Type() == EidosValueType::kValueFloat);
+			return true;
+		}
+		case EidosTokenType::kTokenIdentifier:
+		{
+			// built-in constants such as PI have cached values; effect is the only callback parameter that can stand alone
+			const EidosValue *literal = p_node->cached_literal_value_.get();
+			
+			if (literal && (literal->Type() == EidosValueType::kValueFloat) && (literal->Count() == 1))
+			{
+				program_.emplace_back(SLiMNativeInstruction{SLiMNativeOp::kConstant, literal->FloatAtIndex_NOCAST(0, nullptr), 0.0, p_node->token_});
+				*p_is_float = true;
+				return true;
+			}
+			if ((token_string == "effect") && p_effect_defined)
+			{
+				program_.emplace_back(SLiMNativeInstruction{SLiMNativeOp::kEffect, 0.0, 0.0, p_node->token_});
+				*p_is_float = true;
+				return true;
+			}
+			
+			p_failure_reason = "identifier " + token_string + " is not supported";
+			return false;
+		}
+		case EidosTokenType::kTokenDot:
+		{
+			if ((child_count == 2) && (p_node->children_[0]->token_->token_type_ == EidosTokenType::kTokenIdentifier) && (p_node->children_[0]->token_->token_string_ == "individual"))
+			{
+				const std::string &property_name = p_node->children_[1]->token_->token_string_;
+				SLiMNativeOp op;
+				
+				if (property_name == "tagF")			{ op = SLiMNativeOp::kIndividualTagF; *p_is_float = true; }
+				else if (property_name == "tag")		{ op = SLiMNativeOp::kIndividualTag; *p_is_float = false; }
+				else if (property_name == "x")			{ op = SLiMNativeOp::kIndividualX; *p_is_float = true; }
+				else if (property_name == "y")			{ op = SLiMNativeOp::kIndividualY; *p_is_float = true; }
+				else if (property_name == "z")			{ op = SLiMNativeOp::kIndividualZ; *p_is_float = true; }
+				else if (property_name == "age")		{ op = SLiMNativeOp::kIndividualAge; *p_is_float = false; }
+				else
+				{
+					p_failure_reason = "property individual." + property_name + " is not supported";
+					return false;
+				}
+				
+				program_.emplace_back(SLiMNativeInstruction{op, 0.0, 0.0, p_node->children_[1]->token_});
+				return true;
+			}
+			
+			p_failure_reason = "only properties of individual are supported";
+			return false;
+		}
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+		case EidosTokenType::kTokenMult:
+		case EidosTokenType::kTokenDiv:
+		case EidosTokenType::kTokenExp:
+		{
+			if ((child_count == 1) && (token_type == EidosTokenType::kTokenMinus))
+			{
+				bool operand_is_float;
+				
+				if (!_CompileNode(p_node->children_[0], p_effect_defined, p_depth, &operand_is_float, p_failure_reason))
+					return false;
+				
+				if (!operand_is_float)
+				{
+					p_failure_reason = "integer negation is not supported";
+					return false;
+				}
+				
+				program_.emplace_back(SLiMNativeInstruction{SLiMNativeOp::kNegate, 0.0, 0.0, p_node->token_});
+				*p_is_float = true;
+				return true;
+			}
+			
+			if (child_count != 2)
+			{
+				p_failure_reason = "unary operator " + token_string + " is not supported";
+				return false;
+			}
+			
+			bool lhs_is_float, rhs_is_float;
+			
+			if (!_CompileNode(p_node->children_[0], p_effect_defined, p_depth, &lhs_is_float, p_failure_reason))
+				return false;
+			if (!_CompileNode(p_node->children_[1], p_effect_defined, p_depth + 1, &rhs_is_float, p_failure_reason))
+				return false;
+			
+			// integer +, -, and * produce an integer result, and raise on overflow; / and ^ always produce float
+			if (!lhs_is_float && !rhs_is_float && (token_type != EidosTokenType::kTokenDiv) && (token_type != EidosTokenType::kTokenExp))
+			{
+				p_failure_reason = "integer arithmetic with operator " + token_string + " is not supported";
+				return false;
+			}
+			
+			SLiMNativeOp op = SLiMNativeOp::kAdd;
+			
+			if (token_type == EidosTokenType::kTokenMinus)		op = SLiMNativeOp::kSub;
+			else if (token_type == EidosTokenType::kTokenMult)	op = SLiMNativeOp::kMult;
+			else if (token_type == EidosTokenType::kTokenDiv)	op = SLiMNativeOp::kDiv;
+			else if (token_type == EidosTokenType::kTokenExp)	op = SLiMNativeOp::kPow;
+			
+			program_.emplace_back(SLiMNativeInstruction{op, 0.0, 0.0, p_node->token_});
+			*p_is_float = true;
+			return true;
+		}
+		case EidosTokenType::kTokenLParen:
+		{
+			// a function call: the first child is the function name, the rest are the arguments
+			const EidosToken *call_token = p_node->children_[0]->token_;
+			const std::string &function_name = call_token->token_string_;
+			
+			if (call_token->token_type_ != EidosTokenType::kTokenIdentifier)
+			{
+				p_failure_reason = "only calls to built-in functions are supported";
+				return false;
+			}
+			
+			if (function_name == "dnorm")
+			{
+				// dnorm(float x, [numeric mean = 0], [numeric sd = 1]), with constant mean and sd
+				if ((child_count < 2) || (child_count > 4))
+				{
+					p_failure_reason = "dnorm() has the wrong number of arguments";
+					return false;
+				}
+				
+				const EidosASTNode *x_node = _SLiMNativeArgument(p_node->children_[1], "x");
+				const EidosASTNode *mean_node = (child_count >= 3) ? _SLiMNativeArgument(p_node->children_[2], "mean") : nullptr;
+				const EidosASTNode *sd_node = (child_count >= 4) ? _SLiMNativeArgument(p_node->children_[3], "sd") : nullptr;
+				
+				if (!x_node || ((child_count >= 3) && !mean_node) || ((child_count >= 4) && !sd_node))
+				{
+					p_failure_reason = "dnorm() arguments must be given in order";
+					return false;
+				}
+				if ((mean_node && !mean_node->HasCachedNumericValue()) || (sd_node && !sd_node->HasCachedNumericValue()))
+				{
+					p_failure_reason = "dnorm() is supported only with a constant mean and sd";
+					return false;
+				}
+				
+				double mean = (mean_node ? mean_node->CachedNumericValue() : 0.0);
+				double sd = (sd_node ? sd_node->CachedNumericValue() : 1.0);
+				
+				if (!(sd > 0.0))
+				{
+					p_failure_reason = "dnorm() has an invalid sd";
+					return false;
+				}
+				
+				bool x_is_float;
+				
+				if (!_CompileNode(x_node, p_effect_defined, p_depth, &x_is_float, p_failure_reason))
+					return false;
+				
+				if (!x_is_float)
+				{
+					p_failure_reason = "dnorm() requires a float x";
+					return false;
+				}
+				
+				program_.emplace_back(SLiMNativeInstruction{SLiMNativeOp::kDnorm, mean, sd, p_node->token_});
+				*p_is_float = true;
+				return true;
+			}
+			
+			// the single-argument math functions
+			SLiMNativeOp op = SLiMNativeOp::kAbs;
+			bool found = (function_name == "abs");
+			
+			for (auto &math_function : gSLiMNativeMathFunctions)
+				if (function_name == math_function.name_)
+				{
+					op = math_function.op_;
+					found = true;
+					break;
+				}
+			
+			if (!found)
+			{
+				p_failure_reason = "function " + function_name + "() is not supported";
+				return false;
+			}
+			if (child_count != 2)
+			{
+				p_failure_reason = "function " + function_name + "() has the wrong number of arguments";
+				return false;
+			}
+			
+			const EidosASTNode *x_node = _SLiMNativeArgument(p_node->children_[1], "x");
+			bool x_is_float;
+			
+			if (!x_node)
+			{
+				p_failure_reason = "function " + function_name + "() has an unrecognized named argument";
+				return false;
+			}
+			if (!_CompileNode(x_node, p_effect_defined, p_depth, &x_is_float, p_failure_reason))
+				return false;
+			
+			// abs() of an integer is an integer, and can overflow
+			if ((op == SLiMNativeOp::kAbs) && !x_is_float)
+			{
+				p_failure_reason = "abs() of an integer is not supported";
+				return false;
+			}
+			
+			program_.emplace_back(SLiMNativeInstruction{op, 0.0, 0.0, p_node->token_});
+			*p_is_float = true;
+			return true;
+		}
+		default:
+			p_failure_reason = "operator " + token_string + " is not supported";
+			return false;
+	}
+}
+
+SLiMNativeCallback *SLiMNativeCallback::Compile(const SLiMEidosBlock *p_script_block, std::string &p_failure_reason)
+{
+	bool is_mutationEffect = (p_script_block->type_ == SLiMEidosBlockType::SLiMEidosMutationEffectCallback);
+	
+	if (!is_mutationEffect && (p_script_block->type_ != SLiMEidosBlockType::SLiMEidosFitnessEffectCallback))
+	{
+		p_failure_reason = "only fitnessEffect() and mutationEffect() callbacks can be compiled";
+		return nullptr;
+	}
+	
+	const EidosASTNode *base_node = p_script_block->compound_statement_node_;
+	
+	if ((base_node->token_->token_type_ != EidosTokenType::kTokenLBrace) || (base_node->children_.size() != 1) ||
+		(base_node->children_[0]->token_->token_type_ != EidosTokenType::kTokenReturn) || (base_node->children_[0]->children_.size() != 1))
+	{
+		p_failure_reason = "the body is not a single return statement";
+		return nullptr;
+	}
+	
+	SLiMNativeCallback *native_callback = new SLiMNativeCallback();
+	bool is_float;
+	
+	if (!native_callback->_CompileNode(base_node->children_[0]->children_[0], is_mutationEffect, 0, &is_float, p_failure_reason) || !is_float)
+	{
+		if (p_failure_reason.empty())
+			p_failure_reason = "the return value would not be of type float";
+		
+		delete native_callback;
+		return nullptr;
+	}
+	
+	// figure out the stack depth needed
+	int depth = 0;
+	
+	for (const SLiMNativeInstruction &instruction : native_callback->program_)
+	{
+		if (instruction.op_ <= SLiMNativeOp::kEffect)
+			depth++;
+		else if (instruction.op_ <= SLiMNativeOp::kPow)
+			depth--;
+		
+		native_callback->stack_depth_ = std::max(native_callback->stack_depth_, depth);
+		
+		if ((instruction.op_ == SLiMNativeOp::kPow) || ((instruction.op_ >= SLiMNativeOp::kExp) && (instruction.op_ != SLiMNativeOp::kSqrt)))
+			native_callback->has_transcendentals_ = true;
+	}
+	
+	return native_callback;
+}
+
+void SLiMNativeCallback::_RaisePropertyUnavailable(const SLiMNativeInstruction &p_instruction) const
+{
+	// these match the errors raised by Individual::GetProperty()
+	if (p_instruction.op_ == SLiMNativeOp::kIndividualTagF)
+		EIDOS_TERMINATION << "ERROR (Individual::GetProperty): property tagF accessed on individual before being set." << EidosTerminate(p_instruction.token_);
+	else if (p_instruction.op_ == SLiMNativeOp::kIndividualTag)
+		EIDOS_TERMINATION << "ERROR (Individual::GetProperty): property tag accessed on individual before being set." << EidosTerminate(p_instruction.token_);
+	else
+		EIDOS_TERMINATION << "ERROR (Individual::GetProperty): property age is not available in WF models." << EidosTerminate(p_instruction.token_);
+}
+
+// This matches the computation done by dnorm() for singleton arguments
+static inline double _SLiMNativeDnorm(double p_x, double p_mean, double p_sd)
+{
+#ifdef _OPENMP
+	return gsl_ran_gaussian_pdf(p_x - p_mean, p_sd);
+#else
+	double norm = 1.0 / (std::sqrt(2.0 * M_PI) * p_sd);
+	double inv_2var = -1.0 / (2.0 * p_sd * p_sd);
+	double diff = p_x - p_mean;
+	
+	return std::exp(diff * diff * inv_2var) * norm;
+#endif
+}
+
+double SLiMNativeCallback::Evaluate(const Individual *p_individual, double p_effect) const
+{
+	double stack[kMaxStackDepth];
+	int sp = 0;
+	
+	for (const SLiMNativeInstruction &instruction : program_)
+	{
+		switch (instruction.op_)
+		{
+			case SLiMNativeOp::kConstant:		stack[sp++] = instruction.A_; break;
+			case SLiMNativeOp::kIndividualTagF:
+			{
+				double value = p_individual->tagF_value_;
+				
+				if (value == SLIM_TAGF_UNSET_VALUE)
+					_RaisePropertyUnavailable(instruction);
+				
+				stack[sp++] = value;
+				break;
+			}
+			case SLiMNativeOp::kIndividualTag:
+			{
+				slim_usertag_t value = p_individual->tag_value_;
+				
+				if (value == SLIM_TAG_UNSET_VALUE)
+					_RaisePropertyUnavailable(instruction);
+				
+				stack[sp++] = (double)value;
+				break;
+			}
+			case SLiMNativeOp::kIndividualX:	stack[sp++] = p_individual->spatial_x_; break;
+			case SLiMNativeOp::kIndividualY:	stack[sp++] = p_individual->spatial_y_; break;
+			case SLiMNativeOp::kIndividualZ:	stack[sp++] = p_individual->spatial_z_; break;
+			case SLiMNativeOp::kIndividualAge:
+			{
+				if (p_individual->age_ == -1)
+					_RaisePropertyUnavailable(instruction);
+				
+				stack[sp++] = (double)p_individual->age_;
+				break;
+			}
+			case SLiMNativeOp::kEffect:			stack[sp++] = p_effect; break;
+			
+			case SLiMNativeOp::kAdd:			sp--; stack[sp - 1] = stack[sp - 1] + stack[sp]; break;
+			case SLiMNativeOp::kSub:			sp--; stack[sp - 1] = stack[sp - 1] - stack[sp]; break;
+			case SLiMNativeOp::kMult:			sp--; stack[sp - 1] = stack[sp - 1] * stack[sp]; break;
+			case SLiMNativeOp::kDiv:			sp--; stack[sp - 1] = stack[sp - 1] / stack[sp]; break;
+			case SLiMNativeOp::kPow:			sp--; stack[sp - 1] = std::pow(stack[sp - 1], stack[sp]); break;
+			case SLiMNativeOp::kNegate:			stack[sp - 1] = -stack[sp - 1]; break;
+			
+			case SLiMNativeOp::kAbs:			stack[sp - 1] = std::fabs(stack[sp - 1]); break;
+			case SLiMNativeOp::kExp:			stack[sp - 1] = std::exp(stack[sp - 1]); break;
+			case SLiMNativeOp::kLog:			stack[sp - 1] = std::log(stack[sp - 1]); break;
+			case SLiMNativeOp::kLog10:			stack[sp - 1] = std::log10(stack[sp - 1]); break;
+			case SLiMNativeOp::kLog2:			stack[sp - 1] = std::log2(stack[sp - 1]); break;
+			case SLiMNativeOp::kSqrt:			stack[sp - 1] = std::sqrt(stack[sp - 1]); break;
+			case SLiMNativeOp::kSin:			stack[sp - 1] = std::sin(stack[sp - 1]); break;
+			case SLiMNativeOp::kCos:			stack[sp - 1] = std::cos(stack[sp - 1]); break;
+			case SLiMNativeOp::kTan:			stack[sp - 1] = std::tan(stack[sp - 1]); break;
+			case SLiMNativeOp::kDnorm:			stack[sp - 1] = _SLiMNativeDnorm(stack[sp - 1], instruction.A_, instruction.B_); break;
+		}
+	}
+	
+	return stack[0];
+}
+
+bool SLiMNativeCallback::EvaluateMany(Individual * const *p_individuals, const double *p_effects, size_t p_count, double *p_results)
+{
+	// The stack here is a set of columns, each holding one value per individual for up to kChunkSize individuals; each
+	// instruction is applied across a whole column at a time, in a tight loop the compiler can vectorize
+	columns_.resize(stack_depth_ * kChunkSize);
+	
+	for (size_t chunk_start = 0; chunk_start < p_count; chunk_start += kChunkSize)
+	{
+		size_t count = std::min(kChunkSize, p_count - chunk_start);
+		Individual * const *individuals = p_individuals + chunk_start;
+		int sp = 0;
+		
+		for (const SLiMNativeInstruction &instruction : program_)
+		{
+			double *push = columns_.data() + sp * kChunkSize;			// the column that a push fills
+			double *a = push - kChunkSize;								// the top column
+			double *b = push - 2 * kChunkSize;							// the column below the top; binary ops leave their result here
+			
+			switch (instruction.op_)
+			{
+				case SLiMNativeOp::kConstant:
+				{
+					double value = instruction.A_;
+					
+					for (size_t i = 0; i < count; ++i)
+						push[i] = value;
+					sp++;
+					break;
+				}
+				case SLiMNativeOp::kIndividualTagF:
+				{
+					for (size_t i = 0; i < count; ++i)
+					{
+						double value = individuals[i]->tagF_value_;
+						
+						if (value == SLIM_TAGF_UNSET_VALUE)
+							return false;
+						push[i] = value;
+					}
+					sp++;
+					break;
+				}
+				case SLiMNativeOp::kIndividualTag:
+				{
+					for (size_t i = 0; i < count; ++i)
+					{
+						slim_usertag_t value = individuals[i]->tag_value_;
+						
+						if (value == SLIM_TAG_UNSET_VALUE)
+							return false;
+						push[i] = (double)value;
+					}
+					sp++;
+					break;
+				}
+				case SLiMNativeOp::kIndividualX:	for (size_t i = 0; i < count; ++i) push[i] = individuals[i]->spatial_x_; sp++; break;
+				case SLiMNativeOp::kIndividualY:	for (size_t i = 0; i < count; ++i) push[i] = individuals[i]->spatial_y_; sp++; break;
+				case SLiMNativeOp::kIndividualZ:	for (size_t i = 0; i < count; ++i) push[i] = individuals[i]->spatial_z_; sp++; break;
+				case SLiMNativeOp::kIndividualAge:
+				{
+					for (size_t i = 0; i < count; ++i)
+					{
+						if (individuals[i]->age_ == -1)
+							return false;
+						push[i] = (double)individuals[i]->age_;
+					}
+					sp++;
+					break;
+				}
+				case SLiMNativeOp::kEffect:			std::copy(p_effects + chunk_start, p_effects + chunk_start + count, push); sp++; break;
+				
+				case SLiMNativeOp::kAdd:			for (size_t i = 0; i < count; ++i) b[i] = b[i] + a[i]; sp--; break;
+				case SLiMNativeOp::kSub:			for (size_t i = 0; i < count; ++i) b[i] = b[i] - a[i]; sp--; break;
+				case SLiMNativeOp::kMult:			for (size_t i = 0; i < count; ++i) b[i] = b[i] * a[i]; sp--; break;
+				case SLiMNativeOp::kDiv:			for (size_t i = 0; i < count; ++i) b[i] = b[i] / a[i]; sp--; break;
+				case SLiMNativeOp::kPow:			for (size_t i = 0; i < count; ++i) b[i] = std::pow(b[i], a[i]); sp--; break;
+				case SLiMNativeOp::kNegate:			for (size_t i = 0; i < count; ++i) a[i] = -a[i]; break;
+				
+				case SLiMNativeOp::kAbs:			for (size_t i = 0; i < count; ++i) a[i] = std::fabs(a[i]); break;
+				case SLiMNativeOp::kExp:			for (size_t i = 0; i < count; ++i) a[i] = std::exp(a[i]); break;
+				case SLiMNativeOp::kLog:			for (size_t i = 0; i < count; ++i) a[i] = std::log(a[i]); break;
+				case SLiMNativeOp::kLog10:			for (size_t i = 0; i < count; ++i) a[i] = std::log10(a[i]); break;
+				case SLiMNativeOp::kLog2:			for (size_t i = 0; i < count; ++i) a[i] = std::log2(a[i]); break;
+				case SLiMNativeOp::kSqrt:			for (size_t i = 0; i < count; ++i) a[i] = std::sqrt(a[i]); break;
+				case SLiMNativeOp::kSin:			for (size_t i = 0; i < count; ++i) a[i] = std::sin(a[i]); break;
+				case SLiMNativeOp::kCos:			for (size_t i = 0; i < count; ++i) a[i] = std::cos(a[i]); break;
+				case SLiMNativeOp::kTan:			for (size_t i = 0; i < count; ++i) a[i] = std::tan(a[i]); break;
+				case SLiMNativeOp::kDnorm:
+				{
+					double mean = instruction.A_, sd = instruction.B_;
+					
+					for (size_t i = 0; i < count; ++i)
+						a[i] = _SLiMNativeDnorm(a[i], mean, sd);
+					break;
+				}
+			}
+		}
+		
+		std::copy(columns_.data(), columns_.data() + count, p_results + chunk_start);
+	}
+	
+	return true;
+}
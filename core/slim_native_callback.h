@@ -0,0 +1,130 @@
+//
+//  slim_native_callback.h
+//  SLiM
+//
+//  Created by Ben Haller on 10/16/26.
+//  Copyright (c) 2026 Benjamin C. Haller.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of SLiM.
+//
+//	SLiM is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	SLiM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with SLiM.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+
+ SLiMNativeCallback is a compiled form of a simple fitnessEffect() or mutationEffect() callback, of the form { return <expr>; },
+ that can be evaluated in C++ without entering the Eidos interpreter at all.  The expression may use numeric constants, the
+ tagF, tag, x, y, z, and age properties of individual, effect (in mutationEffect() callbacks), the operators +, -, *, /, and ^,
+ and the functions abs(), exp(), log(), log10(), log2(), sqrt(), sin(), cos(), tan(), and dnorm() with a constant mean and sd.
+ Community::OptimizeScriptBlock() compiles callbacks when they are added, and reports which were not compiled, and why, at
+ verbosity level 2 and above.  The compiled form is a postfix program that can be evaluated for one individual at a time, or
+ for many individuals at once, one operation at a time across all of them; UpdateFitness() uses the latter to evaluate the
+ fitnessEffect() callbacks for a whole subpopulation up front, when it can.
+
+ Evaluation must match the interpreter exactly.  Integer +, -, and * are therefore not compiled, since the interpreter raises
+ on overflow, and neither is anything that would give a result that is not float; the math functions use the same C library
+ calls that the interpreter uses for singletons.  Errors, such as accessing tagF before it has been set, are raised with the
+ same messages as in the interpreter when evaluating one individual; when evaluating many at once, an error instead makes the
+ evaluation fail, so that the caller can fall back to evaluating them one at a time, raising only where the interpreter would.
+ Note that EvaluateMany() matches the interpreter's results for singletons, not for vectors; the interpreter uses SIMD math
+ libraries for some functions on vectors, which can differ in the last bit.  Vectorized mutationEffect() callbacks therefore
+ use EvaluateMany() only when HasTranscendentals() is false, since their arithmetic is exact either way.
+
+ */
+
+#ifndef __SLiM__slim_native_callback__
+#define __SLiM__slim_native_callback__
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "slim_globals.h"
+
+
+class EidosASTNode;
+class EidosToken;
+class SLiMEidosBlock;
+class Individual;
+
+
+enum class SLiMNativeOp : uint8_t {
+	kConstant = 0,			// push A_
+	kIndividualTagF,		// push individual.tagF, raising if unset
+	kIndividualTag,			// push individual.tag, raising if unset
+	kIndividualX,			// push individual.x
+	kIndividualY,			// push individual.y
+	kIndividualZ,			// push individual.z
+	kIndividualAge,			// push individual.age, raising in WF models
+	kEffect,				// push effect (mutationEffect() callbacks only)
+	
+	kAdd,					// pop b, pop a, push a + b
+	kSub,					// pop b, pop a, push a - b
+	kMult,					// pop b, pop a, push a * b
+	kDiv,					// pop b, pop a, push a / b
+	kPow,					// pop b, pop a, push pow(a, b)
+	kNegate,				// pop a, push -a
+	
+	kAbs,					// pop a, push fabs(a)
+	kExp,					// pop a, push exp(a)
+	kLog,					// pop a, push log(a)
+	kLog10,					// pop a, push log10(a)
+	kLog2,					// pop a, push log2(a)
+	kSqrt,					// pop a, push sqrt(a)
+	kSin,					// pop a, push sin(a)
+	kCos,					// pop a, push cos(a)
+	kTan,					// pop a, push tan(a)
+	kDnorm					// pop a, push dnorm(a, mean = A_, sd = B_)
+};
+
+struct SLiMNativeInstruction {
+	SLiMNativeOp op_;
+	double A_;
+	double B_;
+	const EidosToken *token_;		// for error positions
+};
+
+
+class SLiMNativeCallback
+{
+	//	This class has its copy constructor and assignment operator disabled, to prevent accidental copying.
+	
+private:
+	std::vector<SLiMNativeInstruction> program_;
+	int stack_depth_ = 0;								// the maximum stack depth reached by program_
+	std::vector<double> columns_;						// scratch space for EvaluateMany(), stack_depth_ columns of kChunkSize
+	bool has_transcendentals_ = false;					// true if program_ uses ^ or a math function other than abs() and sqrt()
+	
+	bool _CompileNode(const EidosASTNode *p_node, bool p_effect_defined, int p_depth, bool *p_is_float, std::string &p_failure_reason);
+	void _RaisePropertyUnavailable(const SLiMNativeInstruction &p_instruction) const __attribute__((__noreturn__)) __attribute__((cold)) __attribute__((analyzer_noreturn));
+	
+public:
+	static const int kMaxStackDepth = 32;
+	static const size_t kChunkSize = 256;
+	
+	SLiMNativeCallback(const SLiMNativeCallback&) = delete;					// no copying
+	SLiMNativeCallback& operator=(const SLiMNativeCallback&) = delete;		// no copying
+	SLiMNativeCallback(void) = default;
+	
+	// Compile a fitnessEffect() or mutationEffect() callback; returns nullptr, with the reason set in p_failure_reason, if it can't be compiled
+	static SLiMNativeCallback *Compile(const SLiMEidosBlock *p_script_block, std::string &p_failure_reason);
+	
+	inline bool HasTranscendentals(void) const { return has_transcendentals_; }
+	
+	// Evaluate for one individual, with the effect value for a mutationEffect() callback; raises as the interpreter would
+	double Evaluate(const Individual *p_individual, double p_effect) const;
+	
+	// Evaluate for p_count individuals, with effects in p_effects for a mutationEffect() callback (nullptr otherwise), putting the results
+	// in p_results; returns false, without raising, if the interpreter would raise for any individual, in which case p_results is invalid
+	bool EvaluateMany(Individual * const *p_individuals, const double *p_effects, size_t p_count, double *p_results);
+};
+
+
+#endif /* __SLiM__slim_native_callback__ */
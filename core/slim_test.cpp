@@ -1393,9 +1393,19 @@ extern void _RunParallelSLiMTests()
 	;
 	{
 		std::vector<std::string> test_strings = Eidos_string_split(parallelization_test_string, "// ***********************************************************************************************");
+		bool saved_NUMA_aware = gEidosNUMAAware;
 		
-		//for (int testidx = 0; testidx < 100; testidx++)	// uncomment this for a more thorough stress test
+		// The tests are run twice: as configured, and then in NUMA-aware mode (slim -numa), with the static runtime schedule
+		// that Eidos_WarmUpOpenMP() sets up for it, so that the schedule(runtime) loops over individuals are checked both ways
+		for (int NUMA_pass = 0; NUMA_pass < 2; NUMA_pass++)
 		{
+			if (NUMA_pass == 1)
+			{
+				gEidosNUMAAware = true;
+				omp_set_schedule(omp_sched_static, 0);
+			}
+			
+			//for (int testidx = 0; testidx < 100; testidx++)	// uncomment this for a more thorough stress test
 			for (std::string &test_string : test_strings)
 			{
 				// Skip empty tests
@@ -1421,6 +1431,13 @@ extern void _RunParallelSLiMTests()
 				//std::cout << "parallel test took " << std::chrono::duration<double>(end_ts - begin_ts).count() << " seconds:" << std::endl << test_string << std::endl << std::endl;
 			}
 		}
+		
+		gEidosNUMAAware = saved_NUMA_aware;
+		
+		if (gEidosNUMAAware)
+			omp_set_schedule(omp_sched_static, 0);
+		else
+			omp_set_schedule(omp_sched_dynamic, 16);
 	}
 #endif
 }
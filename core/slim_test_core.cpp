@@ -231,9 +231,12 @@ void _RunInitTests(void)
 	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(dimensionality='xyz', periodicity='xyz'); stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(preventIncidentalSelfing=F); stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(preventIncidentalSelfing=T); stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(compressMutationRuns=F); stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(compressMutationRuns=T); stop(); }", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(keepPedigrees=NULL); stop(); }", "cannot be type NULL", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(dimensionality=NULL); stop(); }", "cannot be type NULL", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(preventIncidentalSelfing=NULL); stop(); }", "cannot be type NULL", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(compressMutationRuns=NULL); stop(); }", "cannot be type NULL", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(dimensionality='foo'); stop(); }", "legal non-empty values", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(dimensionality='y'); stop(); }", "legal non-empty values", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(dimensionality='z'); stop(); }", "legal non-empty values", __LINE__);
@@ -2071,6 +2074,10 @@ void _RunIndividualTests(void)
 	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { i = p1.individuals; i.z = asFloat(seqAlong(i) % 2 == 0); if (all(i.z == (seqAlong(i) % 2 == 0))) stop(); }", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_p1 + "1 early() { i = p1.individuals; i.z = seqAlong(i); if (all(i.z == seqAlong(i))) stop(); }", "cannot be type integer", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { i = p1.individuals; i.z = asFloat(seqAlong(i)); if (all(i.z == seqAlong(i))) stop(); }", __LINE__);
+	
+	// vectorized access to a whole subpopulation must agree with per-individual access and cachedFitness(), across ticks and after individuals are killed
+	SLiMAssertScriptSuccess(gen1_setup_p1 + "late() { p1.individuals.tagF = runif(10); p1.individuals.fitnessScaling = runif(10); } 2:10 early() { i = p1.individuals; assert(identical(i.tagF, sapply(i, 'applyValue.tagF;'))); assert(identical(p1.cachedFitness(NULL), sapply(0:9, 'p1.cachedFitness(applyValue);'))); assert(all(i.fitnessScaling == 1.0)); }", __LINE__);
+	SLiMAssertScriptSuccess(nonWF_prefix + gen1_setup_p1_100 + "reproduction() { subpop.addCloned(individual); } 2:10 early() { i = p1.individuals; i.age = i.age; i.tagF = asFloat(i.age); sim.killIndividuals(p1.sampleIndividuals(10)); i = p1.individuals; assert(identical(i.age, sapply(i, 'applyValue.age;'))); assert(identical(i.tagF, asFloat(i.age))); } late() { i = p1.individuals; assert(identical(i.age, sapply(i, 'applyValue.age;'))); assert(identical(p1.cachedFitness(NULL), sapply(seqAlong(i), 'p1.cachedFitness(applyValue);'))); }", __LINE__);
 #ifdef SLIMGUI
 	// the color property is only functional under SLiMgui now
 	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { i = p1.individuals; i.color = format('#%.6X', seqAlong(i)); if (all(i.color == format('#%.6X', seqAlong(i)))) stop(); }", __LINE__);
@@ -2221,6 +2228,17 @@ void _RunSLiMEidosBlockTests(void)
 	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF_cross + "fitnessEffect(p1) { if (!isNULL(individual) & !isNULL(subpop)) return 1.0; } 100 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF_clone + "fitnessEffect(p1) { if (!isNULL(individual) & !isNULL(subpop)) return 1.0; } 100 early() { stop(); }", __LINE__);
 	
+	// callbacks simple enough to be executed as bytecode must give the same results as the AST walker; see eidos_bytecode.h
+	SLiMAssertScriptSuccess(gen1_setup_p1 + "fitnessEffect(p1) { x = individual.index; if (x < 5) return 1.0 + x / 10; return 0.5; } 2 early() { f = p1.cachedFitness(NULL); assert(all(abs(f - c(1.0, 1.1, 1.2, 1.3, 1.4, 0.5, 0.5, 0.5, 0.5, 0.5)) < 1e-12)); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "mutationEffect(m1) { return (homozygous ? effect * 2.0 else effect); } 100 early() { stop(); }", __LINE__);
+	
+	// callbacks simple enough to be compiled to native code must give the same results, and raise the same errors, as the interpreter; see slim_native_callback.h
+	SLiMAssertScriptSuccess(gen1_setup_p1 + "late() { p1.individuals.tagF = (0:9) / 10.0; } fitnessEffect(p1) { return 1.0 + dnorm(individual.tagF, 0.5, 0.2) / 4.0; } 2:5 early() { f = p1.cachedFitness(NULL); assert(all(abs(f - (1.0 + dnorm((0:9) / 10.0, 0.5, 0.2) / 4.0)) < 1e-15)); }", __LINE__);
+	SLiMAssertScriptSuccess(gen1_setup_p1 + "late() { p1.individuals.tagF = (0:9) / 10.0; p1.individuals.tag = 0:9; } fitnessEffect(p1) { return individual.tagF - 0.45; } fitnessEffect(p1) { return exp(individual.tag / 4); } 2:5 early() { f = p1.cachedFitness(NULL); assert(all(abs(f - ifelse((0:9) < 5, 0.0, ((0:9) / 10.0 - 0.45) * exp((0:9) / 4))) < 1e-12)); }", __LINE__);
+	SLiMAssertScriptSuccess(gen1_setup_p1p2p3 + "late() { sim.subpopulations.individuals.tag = 3; } mutationEffect(m1) { return 0.5 + individual.tag / 8; } 2:20 early() { for (ind in p1.individuals) assert(abs(0.875 ^ size(unique(ind.haplosomes.mutationsOfType(m1), preserveOrder=F)) - p1.cachedFitness(ind.index)) < 1e-12); }", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1 + "fitnessEffect(p1) { return 1.0 + individual.tagF; } 10 early() { ; }", "accessed on individual before being set", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1 + "fitnessEffect(p1) { return 1.0 + individual.age; } 10 early() { ; }", "not available in WF models", __LINE__);
+	
 	// mutationEffect() callbacks
 	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "mutationEffect(m1) { return effect; } 100 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "mutationEffect(m1) { stop(); } 100 early() { ; }", __LINE__);
@@ -2256,6 +2274,15 @@ void _RunSLiMEidosBlockTests(void)
 	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "mutationEffect(m1) { mut; return 'a'; } 100 early() { ; }", "return value", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "mutationEffect(m1) { mut; return mut; } 100 early() { ; }", "return value", __LINE__);
 	
+	// vectorized mutationEffect() callbacks
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "1 early() { s1.vectorized = T; } s1 mutationEffect(m1) { if ((size(mut) > 1) & (size(effect) == size(mut)) & (size(homozygous) == size(mut)) & (size(individual) == size(mut))) stop(); return effect; } 100 early() { ; }", __LINE__);
+	SLiMAssertScriptSuccess(gen1_setup_p1p2p3 + "1 early() { s1.vectorized = T; } s1 mutationEffect(m1) { return rep(0.5, size(mut)); } 2:20 early() { for (ind in p1.individuals) assert(abs(ind.fitnessScaling * 0.5 ^ size(unique(ind.haplosomes.mutationsOfType(m1), preserveOrder=F)) - p1.cachedFitness(ind.index)) < 1e-12); }", __LINE__);
+	SLiMAssertScriptSuccess(gen1_setup_p1p2p3 + "1 early() { s1.vectorized = T; s2.vectorized = T; } s1 mutationEffect(m1) { return effect * 0.5; } s2 mutationEffect(m1, p1) { return effect * 0.5; } 2:20 early() { for (ind in p1.individuals) assert(abs(0.25 ^ size(unique(ind.haplosomes.mutationsOfType(m1), preserveOrder=F)) - p1.cachedFitness(ind.index)) < 1e-12); }", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "1 early() { s1.vectorized = T; } s1 late() { }", "can only be set on mutationEffect", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "1 early() { s1.vectorized = T; } s1 mutationEffect(m1) { return effect; } mutationEffect(m1, p1) { return effect; } 100 early() { ; }", "cannot both be active", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "1 early() { s1.vectorized = T; } s1 mutationEffect(m1) { return c(effect, 1.0); } 100 early() { ; }", "one element per mutation", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3 + "1 early() { s1.vectorized = T; } s1 mutationEffect(m1) { return 1; } 100 early() { ; }", "one element per mutation", __LINE__);
+	
 	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "mutationEffect(m1) { if (!isNULL(mut) & !isNULL(homozygous) & !isNULL(effect) & !isNULL(individual) & !isNULL(subpop)) return effect; } 100 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF_cross + "mutationEffect(m1) { if (!isNULL(mut) & !isNULL(homozygous) & !isNULL(effect) & !isNULL(individual) & !isNULL(subpop)) return effect; } 100 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF_clone + "mutationEffect(m1) { if (!isNULL(mut) & !isNULL(homozygous) & !isNULL(effect) & !isNULL(individual) & !isNULL(subpop)) return effect; } 100 early() { stop(); }", __LINE__);
@@ -2415,6 +2442,18 @@ void _RunSLiMEidosBlockTests(void)
 	
 	SLiMAssertScriptSuccess(gen1_setup_p1p2p3_nonWF + "reproduction() { s1.active = 0; } s1 reproduction(p1) { stop(); } 10 early() { ; }", __LINE__);
 	
+	// addCrossedBatch() for big bang reproduction
+	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF + "2 reproduction(p1) { self.active = 0; f = p1.subsetIndividuals(sex='F'); m = p1.sampleIndividuals(size(f), replace=T, sex='M'); o = p1.addCrossedBatch(f, m, count=2); assert(size(o) == 2 * size(f)); } 3 early() { stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF + "2 reproduction(p1) { self.active = 0; f = p1.subsetIndividuals(sex='F'); m = p1.sampleIndividuals(size(f), replace=T, sex='M'); counts = integerMod(seqLen(size(f)), 3); o = p1.addCrossedBatch(f, m, sex='M', count=counts); assert(size(o) == sum(counts)); assert(all(o.sex == 'M')); } 3 early() { stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(gen1_setup_p1p2p3_nonWF + "2 reproduction(p1) { self.active = 0; o = p1.addCrossedBatch(p1.individuals[integer(0)], p1.individuals[integer(0)]); assert(size(o) == 0); } 3 early() { ; }", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3_nonWF + "2 reproduction(p1) { self.active = 0; f = p1.subsetIndividuals(sex='F'); m = p1.subsetIndividuals(sex='M'); p1.addCrossedBatch(f, c(m, m)); } 3 early() { ; }", "be the same length", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3_nonWF + "2 reproduction(p1) { self.active = 0; f = p1.subsetIndividuals(sex='F'); m = p1.sampleIndividuals(size(f), replace=T, sex='M'); p1.addCrossedBatch(f, m, count=c(1, 1)); } 3 early() { ; }", "count be singleton", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3_nonWF + "2 reproduction(p1) { self.active = 0; f = p1.subsetIndividuals(sex='F'); m = p1.sampleIndividuals(size(f), replace=T, sex='M'); p1.addCrossedBatch(m, f); } 3 early() { ; }", "parent1 must be female", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3_nonWF + "2 early() { f = p1.subsetIndividuals(sex='F'); m = p1.subsetIndividuals(sex='M'); p1.addCrossedBatch(f[0], m[0]); } 3 early() { ; }", "may only be called from a reproduction() callback", __LINE__);
+	
+	// the constants table for a reproduction() callback is reused across individuals; each invocation must see its own individual, and no local variables from earlier invocations
+	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF + "1 late() { sim.subpopulations.individuals.tag = 0; } 2 reproduction() { assert(!exists('seen')); seen = individual; assert(individual.tag == 0); individual.tag = 1; } 2 early() { if (all(sim.subpopulations.individuals.tag == 1)) stop(); }", __LINE__);
+	
 	SLiMAssertScriptRaise(gen1_setup_p1p2p3_nonWF + "reproduction(m1) { stop(); } 10 early() { ; }", "identifier prefix 'p' was expected", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_p1p2p3_nonWF + "reproduction(p1, p1) { stop(); } 10 early() { ; }", "needs a value for sex", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_p1p2p3_nonWF + "reproduction(NULL, '*') { stop(); } 10 early() { ; }", "needs a value for sex", __LINE__);
@@ -673,6 +673,42 @@ void _RunMutationTests(void)
 	SLiMAssertScriptRaise(gen1_setup_highmut_p1 + "10 early() { mut = sim.mutations[0]; mut.setSelectionCoeff(1); if (mut.selectionCoeff == 1) stop(); }", "cannot be type integer", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 early() { mut = sim.mutations[0]; mut.setSelectionCoeff(-500.0); if (mut.selectionCoeff == -500.0) stop(); }", __LINE__);	// legal; no lower bound
 	SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 early() { mut = sim.mutations[0]; mut.setSelectionCoeff(500.0); if (mut.selectionCoeff == 500.0) stop(); }", __LINE__);		// legal; no upper bound
+	
+	// Test that references to mutations remain valid while the mutation block grows underneath them
+	SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 early() { mut = sim.mutations[0]; id = mut.id; pos = mut.position; p1.haplosomes[0].addNewMutation(m1, 0.0, 0:49999); if ((mut.id == id) & (mut.position == pos) & (size(sim.mutations) > 50000)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_highmut_p1 + "2 early() { defineConstant('M', sim.mutations[0]); defineConstant('ID', M.id); } 3 early() { p1.haplosomes[0:9].addNewMutation(m1, 0.0, 0:9999); } 5 early() { if ((M.id == ID) & all(sim.mutations.mutationType == m1)) stop(); }", __LINE__);
+	
+	// Test that compressed mutation runs give the same answers through the tally code (which decodes packed runs) as through haplosome queries
+	// (which unpack them), including after fixation and substitution, and after haplosomes with packed runs are modified by script
+	std::string compressed_setup("initialize() { initializeSLiMOptions(doMutationRunExperiments=F, compressMutationRuns=T); initializeMutationRate(1e-4); initializeMutationType('m1', 0.5, 'f', 0.0); initializeMutationType('m2', 0.5, 'f', 0.02); initializeGenomicElementType('g1', c(m1, m2), c(1.0, 0.1)); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } 1 early() { sim.addSubpop('p1', 10); } ");
+	std::string compressed_check("counts = sapply(sim.mutations, 'sum(p1.haplosomes.containsMutations(applyValue));'); assert(identical(sim.mutationCounts(p1), counts), 'mismatch'); ");
+	SLiMAssertScriptStop(compressed_setup + "50 late() { " + compressed_check + "if (size(sim.mutations) > 100) stop(); }", __LINE__);
+	SLiMAssertScriptStop(compressed_setup + "300 late() { " + compressed_check + "if (size(sim.substitutions) > 0) stop(); }", __LINE__);
+	SLiMAssertScriptStop(compressed_setup + "50 early() { h = p1.haplosomes[0]; h.removeMutations(h.mutations[0:9]); p1.haplosomes[1:5].addNewMutation(m2, 0.1, 500:509); } 50 late() { " + compressed_check + "community.outputUsage(); stop(); }", __LINE__);
+	SLiMAssertScriptStop(compressed_setup + "50 late() { m = sim.mutations; g = p1.haplosomes.genotypeMatrix(m); assert(identical(asInteger(apply(g, 1, 'sum(applyValue);')), sim.mutationCounts(p1, m)), 'mismatch'); " + compressed_check + "stop(); }", __LINE__);
+	
+	// Test that mutation runs interned during offspring generation stay consistent with the tallies, with heavy recombination so that
+	// many child runs are interned, in ticks that are not multiples of 100 (when UniqueMutationRuns() would unique runs anyway); this
+	// covers crossing, modification of interned runs in children, addRecombinant(), and gene conversion with heteroduplex mismatch repair
+	std::string interned_setup("initialize() { initializeSLiMOptions(doMutationRunExperiments=F); initializeChromosome(1, 100000, mutationRuns=16); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeMutationType('m2', 0.5, 'f', 0.02); initializeGenomicElementType('g1', c(m1, m2), c(1.0, 0.1)); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-4); } ");
+	std::string interned_check("counts = sapply(sim.mutations, 'sum(p1.haplosomes.containsMutations(applyValue));'); assert(identical(sim.mutationCounts(p1), counts), 'mismatch'); ");
+	SLiMAssertScriptStop(interned_setup + "1 early() { sim.addSubpop('p1', 20); } 155 late() { " + interned_check + "if (size(sim.mutations) > 20) stop(); }", __LINE__);
+	SLiMAssertScriptStop(interned_setup + "1 early() { sim.addSubpop('p1', 20); } 50: modifyChild() { if (child.index == 0) child.haplosomes[0].addNewMutation(m2, 0.1, 5000); return T; } 55 late() { " + interned_check + "if (size(sim.mutations) > 20) stop(); }", __LINE__);
+	SLiMAssertScriptStop(std::string("initialize() { initializeSLiMModelType('nonWF'); ") + interned_setup.substr(15) + "1 early() { sim.addSubpop('p1', 20); } reproduction() { if (individual.index == 0) for (i in 1:20) { p = p1.sampleIndividuals(2); b = sort(sample(0:99999, 10)); p1.addRecombinant(p[0].haplosomes[0], p[0].haplosomes[1], b, p[1].haplosomes[0], p[1].haplosomes[1], b, randomizeStrands=T); } } early() { p1.fitnessScaling = 20 / p1.individualCount; } 55 late() { " + interned_check + "if (size(sim.mutations) > 20) stop(); }", __LINE__);
+	SLiMAssertScriptStop(interned_setup.substr(0, interned_setup.length() - 2) + "initializeGeneConversion(0.5, 500, 0.5); } 1 early() { sim.addSubpop('p1', 20); } 55 late() { " + interned_check + "if (size(sim.mutations) > 20) stop(); }", __LINE__);
+
+	// Test that a recombination hotspot, which gives the chromosome mutation runs of varying length, leaves haplosome queries consistent with
+	// the tallies through crossing, gene conversion, addRecombinant(), and script modifications spanning the positions where runs change
+	std::string variable_setup("initialize() { initializeSLiMOptions(doMutationRunExperiments=F); initializeChromosome(1, 100000, mutationRuns=16); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeMutationType('m2', 0.5, 'f', 0.02); initializeGenomicElementType('g1', c(m1, m2), c(1.0, 0.1)); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(c(1e-8, 1e-4), c(89999, 99999)); } ");
+	std::string variable_check("counts = sapply(sim.mutations, 'sum(p1.haplosomes.containsMutations(applyValue));'); assert(identical(sim.mutationCounts(p1), counts), 'mismatch'); for (h in p1.haplosomes) assert(identical(h.mutations.position, sort(h.mutations.position)), 'unsorted'); ");
+	SLiMAssertScriptStop(variable_setup + "1 early() { sim.addSubpop('p1', 20); } 155 late() { " + variable_check + "if (size(sim.mutations) > 20) stop(); }", __LINE__);
+	SLiMAssertScriptStop(variable_setup + "1 early() { sim.addSubpop('p1', 20); } 50 late() { h = p1.haplosomes[0]; h.removeMutations(h.mutations[h.mutations.position >= 85000]); p1.haplosomes[1:5].addNewMutation(m2, 0.1, c(0, 45000:45009, 89990:90009, 99999)); " + variable_check + "if (sum(p1.haplosomes.containsMarkerMutation(m2, 90000)) >= 5) stop(); }", __LINE__);
+	SLiMAssertScriptStop(std::string("initialize() { initializeSLiMModelType('nonWF'); ") + variable_setup.substr(15, variable_setup.length() - 17) + "initializeGeneConversion(0.5, 500, 0.5); } 1 early() { sim.addSubpop('p1', 20); } reproduction() { if (individual.index == 0) for (i in 1:20) { p = p1.sampleIndividuals(2); b = sort(sample(85000:99999, 10)); p1.addRecombinant(p[0].haplosomes[0], p[0].haplosomes[1], b, p[1].haplosomes[0], p[1].haplosomes[1], b, randomizeStrands=T); } } early() { p1.fitnessScaling = 20 / p1.individualCount; } 55 late() { " + variable_check + "if (size(sim.mutations) > 20) stop(); }", __LINE__);
+	
+	// Test that mutation run experiments on the hotspot map, which split runs at weighted medians and join them pairwise within the non-uniform
+	// layout, leave haplosome queries consistent with the tallies; the first split comes after 50 ticks, and joins and further splits follow
+	std::string experiment_setup("initialize() { initializeSLiMOptions(doMutationRunExperiments=T); initializeChromosome(1, 100000); " + variable_setup.substr(variable_setup.find("initializeMutationRate")));
+	SLiMAssertScriptStop(experiment_setup + "1 early() { sim.addSubpop('p1', 20); } late() { " + variable_check + "} 300 late() { if (size(sim.mutations) > 20) stop(); }", __LINE__);
 }
 
 #pragma mark Substitution tests
@@ -697,6 +733,12 @@ void _RunSubstitutionTests(void)
 	SLiMAssertScriptRaise(gen1_setup_fixmut_p1 + "30 early() { sub = sim.substitutions[0]; sub.position = 99999; stop(); }", "read-only property", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_fixmut_p1 + "30 early() { sub = sim.substitutions[0]; sub.selectionCoeff = 50.0; stop(); }", "read-only property", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_fixmut_p1 + "30 early() { sub = sim.substitutions[0]; sub.subpopID = 237; if (sub.subpopID == 237) stop(); }", __LINE__);						// legal; this field may be used as a user tag
+	
+	// Test that mutations fixing together, in shared and unshared mutation runs on several chromosomes, are all substituted in chromosome order and removed
+	std::string multifix_setup("initialize() { initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); for (id in 1:3) { initializeChromosome(id, 100000, mutationRuns=8); initializeMutationRate(0); initializeGenomicElement(g1); initializeRecombinationRate(1e-5); } } 1 early() { sim.addSubpop('p1', 20); } 10 early() { for (id in 1:3) { h = p1.haplosomesForChromosomes(id); h.addNewDrawnMutation(m1, c(100, 200, 50000, 99999)); h[0:4].addNewDrawnMutation(m1, c(150, 50001)); } } ");
+	std::string multifix_check("10 late() { assert(identical(sim.substitutions.chromosome.id, repEach(1:3, 4)), 'order'); for (id in 1:3) assert(identical(sort(sim.substitutions[sim.substitutions.chromosome.id == id].position), c(100, 200, 50000, 99999)), 'positions'); assert(all(match(p1.haplosomes.mutations.position, c(150, 50001)) >= 0), 'not removed'); counts = sapply(sim.mutations, 'sum(p1.haplosomesForChromosomes(applyValue.chromosome).containsMutations(applyValue));'); if (identical(sim.mutationCounts(p1), counts) & all(sim.mutations.position == 150 | sim.mutations.position == 50001)) stop(); }");
+	SLiMAssertScriptStop(multifix_setup + multifix_check, __LINE__);
+	SLiMAssertScriptStop(multifix_setup.substr(0, 15) + "initializeSLiMOptions(compressMutationRuns=T); " + multifix_setup.substr(15) + multifix_check, __LINE__);
 }
 
 #pragma mark Haplosome tests
@@ -830,6 +872,13 @@ void _RunHaplosomeTests(const std::string &temp_path)
 	SLiMAssertScriptStop(gen1_setup_p1 + "10 early() { p1.haplosomes[0].countOfMutationsOfType(1); stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1 + "10 early() { p1.haplosomes[0:1].countOfMutationsOfType(1); stop(); }", __LINE__);
 	
+	// Test Haplosome + (logical)genotypeMatrix([No<Mutation> mutations = NULL])
+	SLiMAssertScriptRaise(gen1_setup_p1 + "10 early() { g = p1.haplosomes[integer(0)].genotypeMatrix(); stop(); }", "zero-length Haplosome vector", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 early() { g = p1.haplosomes[0].genotypeMatrix(); if (identical(dim(g), c(1, size(sim.mutations)))) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "10 early() { g = p1.haplosomes.genotypeMatrix(object()); if (identical(g, logical(0))) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 early() { h = p1.haplosomes; m = sim.mutations; g = h.genotypeMatrix(m); if (identical(asInteger(apply(g, 1, 'sum(applyValue);')), h.mutationCountsInHaplosomes(m))) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 early() { h = p1.haplosomes; m = sim.mutations; g = h.genotypeMatrix(m); if (all(g[5, ] == h[5].containsMutations(m))) stop(); }", __LINE__);
+	
 	// Test Haplosome + (float)mutationFrequenciesInHaplosomes([No<Mutation> mutations = NULL])
 	SLiMAssertScriptRaise(gen1_setup_p1 + "10 early() { f = p1.haplosomes[integer(0)].mutationFrequenciesInHaplosomes(); stop(); }", "zero-length Haplosome vector", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1 + "10 early() { f = p1.haplosomes[0].mutationFrequenciesInHaplosomes(); stop(); }", __LINE__);
@@ -941,6 +990,24 @@ void _RunHaplosomeTests(const std::string &temp_path)
 		SLiMAssertScriptStop(gen1_setup_sex_p1 + "10 late() { sample(p1.individuals, 100, T).haplosomes.outputHaplosomesToVCF('" + temp_path + "/slimOutputVCFTest8.txt', F); stop(); }", __LINE__);
 	}
 	
+	// BGZF-compressed VCF output (.gz) and BCF output (.bcf) are chosen by the file extension
+	if (Eidos_TemporaryDirectoryExists())
+	{
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { sample(p1.individuals, 100, T).haplosomes.outputHaplosomesToVCF('" + temp_path + "/slimOutputVCFTest9.vcf.gz'); if (fileExists('" + temp_path + "/slimOutputVCFTest9.vcf.gz')) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { sample(p1.individuals, 100, T).haplosomes.outputHaplosomesToVCF('" + temp_path + "/slimOutputVCFTest10.vcf.gz'); sample(p1.individuals, 100, T).haplosomes.outputHaplosomesToVCF('" + temp_path + "/slimOutputVCFTest10.vcf.gz', append=T); stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_sex_p1 + "10 late() { sample(p1.individuals, 100, T).haplosomes.outputHaplosomesToVCF('" + temp_path + "/slimOutputVCFTest11.bcf'); if (fileExists('" + temp_path + "/slimOutputVCFTest11.bcf')) stop(); }", __LINE__);
+		SLiMAssertScriptRaise(gen1_setup_highmut_p1 + "10 late() { sample(p1.individuals, 100, T).haplosomes.outputHaplosomesToVCF('" + temp_path + "/slimOutputVCFTest12.bcf', append=T); stop(); }", "append=T is not supported for BCF output", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { p1.outputVCFSample(10, filePath='" + temp_path + "/slimOutputVCFTest13.bcf'); p1.individuals.outputIndividualsToVCF('" + temp_path + "/slimOutputVCFTest14.vcf.gz'); stop(); }", __LINE__);
+		
+		// check the contents: BGZF output decompresses to the plain VCF output, and BCF output starts with the BCF 2.2 magic and header
+#ifndef _WIN32
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { h = sample(p1.individuals, 100, T).haplosomes; h.outputHaplosomesToVCF('" + temp_path + "/slimOutputVCFTest15.vcf'); h.outputHaplosomesToVCF('" + temp_path + "/slimOutputVCFTest15.vcf.gz'); v = readFile('" + temp_path + "/slimOutputVCFTest15.vcf'); if ((size(v) > 20) & identical(system('gzip', args=c('-dc', '" + temp_path + "/slimOutputVCFTest15.vcf.gz')), v)) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { h = sample(p1.individuals, 100, T).haplosomes; for (i in 1:2) { h.outputHaplosomesToVCF('" + temp_path + "/slimOutputVCFTest16.vcf', append=T); h.outputHaplosomesToVCF('" + temp_path + "/slimOutputVCFTest16.vcf.gz', append=T); } v = readFile('" + temp_path + "/slimOutputVCFTest16.vcf'); if (identical(system('gzip', args=c('-dc', '" + temp_path + "/slimOutputVCFTest16.vcf.gz')), v)) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_sex_p1 + "10 late() { p1.individuals.outputIndividualsToVCF('" + temp_path + "/slimOutputVCFTest17.vcf'); p1.individuals.outputIndividualsToVCF('" + temp_path + "/slimOutputVCFTest17.vcf.gz'); v = readFile('" + temp_path + "/slimOutputVCFTest17.vcf'); if (identical(system('gzip', args=c('-dc', '" + temp_path + "/slimOutputVCFTest17.vcf.gz')), v)) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { h = sample(p1.individuals, 100, T).haplosomes; h.outputHaplosomesToVCF('" + temp_path + "/slimOutputVCFTest18.vcf'); h.outputHaplosomesToVCF('" + temp_path + "/slimOutputVCFTest18.bcf'); b = strsplit(paste(system(\"gzip -dc '" + temp_path + "/slimOutputVCFTest18.bcf' | od -An -tu1 -N9\")), ' '); b = asInteger(b[b != '']); len = sum(b[5:8] * c(1, 256, 65536, 16777216)); t = system(\"gzip -dc '" + temp_path + "/slimOutputVCFTest18.bcf' | tail -c +10 | head -c \" + (len - 1)); z = system(\"gzip -dc '" + temp_path + "/slimOutputVCFTest18.bcf' | tail -c +\" + (9 + len) + \" | od -An -tu1 -N1\"); v = readFile('" + temp_path + "/slimOutputVCFTest18.vcf'); if (identical(b[0:4], c(66, 67, 70, 2, 2)) & (t[0] == '##fileformat=VCFv4.2') & (t[size(t) - 1] == v[which(substr(v, 0, 5) == '#CHROM')]) & (asInteger(z) == 0)) stop(); }", __LINE__);
+#endif
+	}
+	
 	
 	// BCH: This is just a temporary resting spot for these zygosityOfMutations() tests, which have been pulled back from the `multitrait` branch.
 	
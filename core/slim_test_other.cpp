@@ -19,6 +19,9 @@
 
 
 #include "slim_test.h"
+#include "species.h"
+#include "individual.h"
+#include "mutation.h"
 
 #include "eidos_globals.h"
 #include "eidos_rng.h"
@@ -34,6 +37,10 @@
 static void _RunInteractionTypeTests_Nonspatial(bool p_sex_enabled, const std::string &p_sex_segregation);
 static void _RunInteractionTypeTests_Spatial(const std::string &p_max_distance, bool p_sex_enabled, const std::string &p_sex_segregation);
 static void _RunInteractionTypeTests_LocalPopDensity(void);
+static std::string _InteractionPairSetup(const std::string &p_model_type, const std::string &p_options, const std::string &p_spatiality, const std::string &p_max_distance, const std::string &p_kernel, const std::string &p_extra_setup);
+static void _RunInteractionTypeTests_SpatialIndex(void);
+static void _RunInteractionTypeTests_KDTreeRefit(void);
+static void _RunInteractionTypeTests_StrengthCache(void);
 static void _RunSpatialKernelValueTests(void);
 static void _RunSpatialKernelSIMDTests(void);
 
@@ -83,6 +90,9 @@ void _RunInteractionTypeTests(void)
 	_RunInteractionTypeTests_Spatial("999.0", false, "**");
 	
 	_RunInteractionTypeTests_LocalPopDensity();		// different enough to get its own call
+	_RunInteractionTypeTests_SpatialIndex();		// compares cell grid results against k-d tree results
+	_RunInteractionTypeTests_KDTreeRefit();			// compares refitted k-d tree results against rebuilt k-d tree results
+	_RunInteractionTypeTests_StrengthCache();		// compares cached strength results against uncached strength results
 
 	_RunSpatialKernelValueTests();					// test numerical correctness of kernel calculations
 	_RunSpatialKernelSIMDTests();					// C++ level tests for SIMD kernel functions
@@ -1111,6 +1121,103 @@ void _RunInteractionTypeTests_Spatial(const std::string &p_max_distance, bool p_
 	}
 }
 
+// Returns an initialize() callback defining two identical interaction types, i1 and i2, so that tests can enable an
+// optimization for one of them (in p_extra_setup) and check that both give the same query results
+std::string _InteractionPairSetup(const std::string &p_model_type, const std::string &p_options, const std::string &p_spatiality, const std::string &p_max_distance, const std::string &p_kernel, const std::string &p_extra_setup)
+{
+	return "initialize() { initializeSLiMModelType('" + p_model_type + "'); initializeSLiMOptions(" + p_options + "); initializeMutationRate(0); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99); initializeRecombinationRate(0); initializeInteractionType(1, '" + p_spatiality + "', maxDistance=" + p_max_distance + "); initializeInteractionType(2, '" + p_spatiality + "', maxDistance=" + p_max_distance + "); i1.setInteractionFunction(" + p_kernel + "); i2.setInteractionFunction(" + p_kernel + "); " + p_extra_setup + " } ";
+}
+
+void _RunInteractionTypeTests_SpatialIndex(void)
+{
+	// Test InteractionType - spatialIndex; queries using a cell grid should give the same results as queries using a k-d tree
+	SLiMAssertScriptStop(gen1_setup_i1x + "1 early() { if (i1.spatialIndex == 'kdtree') stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_i1x + "1 early() { i1.spatialIndex = 'grid'; if (i1.spatialIndex == 'grid') stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_i1x + "1 early() { i1.spatialIndex = 'auto'; if (i1.spatialIndex == 'auto') stop(); }", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_i1x + "1 early() { i1.spatialIndex = 'octree'; }", "must be 'kdtree', 'grid', or 'auto'", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_i1x + "1 late() { i1.evaluate(p1); i1.spatialIndex = 'grid'; }", "cannot be changed while the interaction is being evaluated", __LINE__);
+	
+	for (int i = 0; i < 6; ++i)
+	{
+		std::string options, spatiality, max_distance = "0.05", index_type = "grid";
+		
+		switch (i)		// NOLINT(*-missing-default-case) : loop bounds
+		{
+			case 0: options = "dimensionality='x'"; spatiality = "x"; break;
+			case 1: options = "dimensionality='xy'"; spatiality = "xy"; break;
+			case 2: options = "dimensionality='xy', periodicity='xy'"; spatiality = "xy"; break;
+			case 3: options = "dimensionality='xyz'"; spatiality = "xyz"; max_distance = "0.15"; break;
+			case 4: options = "dimensionality='xy'"; spatiality = "xy"; index_type = "auto"; break;
+			case 5: options = "dimensionality='xy'"; spatiality = "xy"; max_distance = "INF"; break;		// falls back to a k-d tree
+		}
+		
+		std::string setup = _InteractionPairSetup("WF", options, spatiality, max_distance, "'n', 1.0, 0.02", "initializeSex('A'); i2.spatialIndex = '" + index_type + "';") + "1 late() { sim.addSubpop('p1', 2000); p1.individuals.setSpatialPosition(p1.pointUniform(2000)); ";
+		std::string eval = "i1.evaluate(p1); i2.evaluate(p1); ind = p1.individuals; pt = p1.pointUniform(1); ok = T; ";
+		
+		SLiMAssertScriptStop(setup + eval + "ok = ok & identical(i1.neighborCount(ind), i2.neighborCount(ind)); ok = ok & identical(i1.interactingNeighborCount(ind), i2.interactingNeighborCount(ind)); ok = ok & all(abs(i1.totalOfNeighborStrengths(ind) - i2.totalOfNeighborStrengths(ind)) < 1e-4); ok = ok & identical(i1.neighborCountOfPoint(pt, p1), i2.neighborCountOfPoint(pt, p1)); if (ok) stop(); }", __LINE__);
+		SLiMAssertScriptStop(setup + eval + "for (r in ind[0:49]) { ok = ok & identical(i1.nearestNeighbors(r, 1), i2.nearestNeighbors(r, 1)); ok = ok & identical(sort(i1.nearestNeighbors(r, 5).index), sort(i2.nearestNeighbors(r, 5).index)); ok = ok & identical(sort(i1.nearestNeighbors(r, 2000).index), sort(i2.nearestNeighbors(r, 2000).index)); } ok = ok & identical(sort(i1.nearestNeighborsOfPoint(pt, p1, 10).index), sort(i2.nearestNeighborsOfPoint(pt, p1, 10).index)); if (ok) stop(); }", __LINE__);
+		
+		// exerter constraints produce a separate EXERTERS index; sex-segregation and non-sex constraints take different paths
+		SLiMAssertScriptStop(setup + "i1.setConstraints('exerter', sex='F'); i2.setConstraints('exerter', sex='F'); " + eval + "ok = ok & identical(i1.interactingNeighborCount(ind), i2.interactingNeighborCount(ind)); for (r in ind[0:49]) ok = ok & identical(sort(i1.nearestInteractingNeighbors(r, 2000).index), sort(i2.nearestInteractingNeighbors(r, 2000).index)); if (ok) stop(); }", __LINE__);
+		SLiMAssertScriptStop(setup + "ind = p1.individuals; ind.tag = rbinom(2000, 1, 0.5); i1.setConstraints('exerter', tag=1); i2.setConstraints('exerter', tag=1); " + eval + "ok = ok & identical(i1.interactingNeighborCount(ind), i2.interactingNeighborCount(ind)); ok = ok & identical(i1.neighborCount(ind), i2.neighborCount(ind)); if (ok) stop(); }", __LINE__);
+		SLiMAssertScriptStop(setup + eval + "ok = ok & (size(i2.drawByStrength(ind[0], 5)) <= 5); ok = ok & (size(i2.drawByStrength(ind[0:9], 3, returnDict=T).getValue(9)) <= 3); if (ok) stop(); }", __LINE__);
+	}
+}
+
+void _RunInteractionTypeTests_KDTreeRefit(void)
+{
+	// Test InteractionType - kdTreeRefit; queries using a refitted k-d tree should give the same results as queries using a rebuilt tree
+	SLiMAssertScriptStop(gen1_setup_i1x + "1 early() { if (i1.kdTreeRefit == F) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_i1x + "1 early() { i1.kdTreeRefit = T; if (i1.kdTreeRefit == T) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_i1x + "1 late() { i1.kdTreeRefit = T; i1.evaluate(p1); i1.nearestNeighbors(p1.individuals[0]); i1.kdTreeRefit = F; } 2 late() { i1.evaluate(p1); i1.nearestNeighbors(p1.individuals[0]); stop(); }", __LINE__);
+	
+	for (int i = 0; i < 4; ++i)
+	{
+		std::string options, spatiality, max_distance = "0.05";
+		
+		switch (i)		// NOLINT(*-missing-default-case) : loop bounds
+		{
+			case 0: options = "dimensionality='x'"; spatiality = "x"; max_distance = "0.01"; break;
+			case 1: options = "dimensionality='xy'"; spatiality = "xy"; break;
+			case 2: options = "dimensionality='xyz'"; spatiality = "xyz"; max_distance = "0.15"; break;
+			case 3: options = "dimensionality='xy'"; spatiality = "xy"; max_distance = "INF"; break;
+		}
+		
+		// a nonWF model with a few percent births and deaths per tick, and small movements, so that most ticks refit the tree
+		std::string setup = _InteractionPairSetup("nonWF", options, spatiality, max_distance, "'n', 1.0, 0.02", "i1.kdTreeRefit = T;") + "1 early() { sim.addSubpop('p1', 1000); p1.individuals.setSpatialPosition(p1.pointUniform(1000)); defineGlobal('OK', T); } reproduction() { if (runif(1) < 0.03) { child = subpop.addCloned(individual); child.setSpatialPosition(individual.spatialPosition); } } ";
+		std::string move = "early() { sim.killIndividuals(sample(p1.individuals, 30)); ind = p1.individuals; ind.setSpatialPosition(p1.pointReflected(ind.spatialPosition + rnorm(size(ind) * " + std::to_string(spatiality.length()) + ", 0, 0.002))); i1.evaluate(p1); i2.evaluate(p1); ind = p1.individuals; ";
+		
+		SLiMAssertScriptStop(setup + move + "ok = identical(i1.neighborCount(ind), i2.neighborCount(ind)); ok = ok & all(abs(i1.totalOfNeighborStrengths(ind) - i2.totalOfNeighborStrengths(ind)) <= 1e-4 * (1 + i2.totalOfNeighborStrengths(ind))); for (r in ind[0:19]) ok = ok & identical(i2.distance(r, i1.nearestNeighbors(r, 1)), i2.distance(r, i2.nearestNeighbors(r, 1))); for (r in ind[0:19]) ok = ok & identical(sort(i1.nearestNeighbors(r, 2000).index), sort(i2.nearestNeighbors(r, 2000).index)); defineGlobal('OK', OK & ok); } 15 late() { if (OK) stop(); }", __LINE__);
+	}
+}
+
+void _RunInteractionTypeTests_StrengthCache(void)
+{
+	// Test InteractionType - strengthCache; queries using cached strengths should give the same results as queries without the cache
+	SLiMAssertScriptStop(gen1_setup_i1x + "1 early() { if (i1.strengthCache == F) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_i1x + "1 early() { i1.strengthCache = T; if (i1.strengthCache == T) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_i1x + "1 late() { i1.strengthCache = T; i1.evaluate(p1); i1.totalOfNeighborStrengths(p1.individuals); i1.strengthCache = F; } 2 late() { i1.evaluate(p1); i1.totalOfNeighborStrengths(p1.individuals); stop(); }", __LINE__);
+	
+	for (int i = 0; i < 4; ++i)
+	{
+		std::string options, spatiality, max_distance = "0.05", kernel = "'n', 1.0, 0.02";
+		
+		switch (i)		// NOLINT(*-missing-default-case) : loop bounds
+		{
+			case 0: options = "dimensionality='x'"; spatiality = "x"; max_distance = "0.01"; kernel = "'n', 1.0, 0.005"; break;
+			case 1: options = "dimensionality='xy'"; spatiality = "xy"; break;
+			case 2: options = "dimensionality='xy'"; spatiality = "xy"; kernel = "'f', 1.0"; break;
+			case 3: options = "dimensionality='xyz'"; spatiality = "xyz"; max_distance = "0.15"; kernel = "'l', 1.0"; break;
+		}
+		
+		// a mostly sessile nonWF model, with a few births, deaths, and moves per tick; maxDistance is halved partway through
+		std::string setup = _InteractionPairSetup("nonWF", options, spatiality, max_distance, kernel, "i1.strengthCache = T;") + "1 early() { sim.addSubpop('p1', 1000); p1.individuals.setSpatialPosition(p1.pointUniform(1000)); defineGlobal('OK', T); } reproduction() { if (runif(1) < 0.01) { child = subpop.addCloned(individual); child.setSpatialPosition(individual.spatialPosition); } } 8 late() { i1.unevaluate(); i2.unevaluate(); i1.maxDistance = i1.maxDistance / 2; i2.maxDistance = i2.maxDistance / 2; } ";
+		std::string move = "early() { sim.killIndividuals(sample(p1.individuals, 10)); movers = sample(p1.individuals, 20); movers.setSpatialPosition(p1.pointReflected(movers.spatialPosition + rnorm(size(movers) * " + std::to_string(spatiality.length()) + ", 0, 0.01))); i1.evaluate(p1); i2.evaluate(p1); ind = p1.individuals; ";
+		
+		SLiMAssertScriptStop(setup + move + "ok = all(abs(i1.totalOfNeighborStrengths(ind) - i2.totalOfNeighborStrengths(ind)) <= 2^-21 * i2.totalOfNeighborStrengths(ind)); for (r in sample(ind, 50)) { s1 = i1.strength(r); s2 = i2.strength(r); ok = ok & identical(s1 > 0, s2 > 0) & all(abs(s1 - s2) <= 2^-21 * s2); } for (r in ind[0:9]) ok = ok & all(size(i1.drawByStrength(r, 5)) <= 5); defineGlobal('OK', OK & ok); } 15 late() { if (OK) stop(); }", __LINE__);
+	}
+}
+
 void _RunInteractionTypeTests_LocalPopDensity()
 {
 	// Test InteractionType - localPopulationDensity()
@@ -2014,6 +2121,7 @@ void _RunNonWFTests(void)
 	SLiMAssertScriptRaise(WF_prefix + gen1_setup_p1 + "1 early() { p1.takeMigrants(p1.individuals); stop(); }", "not available in WF models", __LINE__);
 	SLiMAssertScriptRaise(WF_prefix + gen1_setup_p1 + "1 early() { p1.addCloned(p1.individuals[0]); stop(); }", "not available in WF models", __LINE__);
 	SLiMAssertScriptRaise(WF_prefix + gen1_setup_p1 + "1 early() { p1.addCrossed(p1.individuals[0], p1.individuals[1]); stop(); }", "not available in WF models", __LINE__);
+	SLiMAssertScriptRaise(WF_prefix + gen1_setup_p1 + "1 early() { p1.addCrossedBatch(p1.individuals[0], p1.individuals[1]); stop(); }", "not available in WF models", __LINE__);
 	SLiMAssertScriptRaise(WF_prefix + gen1_setup_p1 + "1 early() { p1.addEmpty(); stop(); }", "not available in WF models", __LINE__);
 	SLiMAssertScriptRaise(WF_prefix + gen1_setup_p1 + "1 early() { p1.addSelfed(p1.individuals[0]); stop(); }", "not available in WF models", __LINE__);
 	
@@ -2081,6 +2189,21 @@ void _RunNonWFTests(void)
 }
 
 #pragma mark treeseq tests
+// Loads two .trees files and raises if their tables differ in anything but provenance, which records the run times
+static void _AssertTreeSeqFilesMatch(const std::string &p_path1, const std::string &p_path2, int p_lineNumber)
+{
+	tsk_table_collection_t tables1, tables2;
+	int ret1 = tsk_table_collection_load(&tables1, p_path1.c_str(), 0);
+	int ret2 = tsk_table_collection_load(&tables2, p_path2.c_str(), 0);
+	bool match = (ret1 == 0) && (ret2 == 0) && tsk_table_collection_equals(&tables1, &tables2, TSK_CMP_IGNORE_PROVENANCE);
+	
+	tsk_table_collection_free(&tables1);
+	tsk_table_collection_free(&tables2);
+	
+	if (!match)
+		EIDOS_TERMINATION << "ERROR (_AssertTreeSeqFilesMatch): tree sequences " << p_path1 << " and " << p_path2 << " do not match (test at line " << p_lineNumber << ")." << EidosTerminate();
+}
+
 void _RunTreeSeqTests(const std::string &temp_path)
 {
 	// initializeTreeSeq()
@@ -2117,6 +2240,17 @@ void _RunTreeSeqTests(const std::string &temp_path)
 	// treeSeqSimplify()
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "50 early() { sim.treeSeqSimplify(); } 100 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "1: early() { sim.treeSeqSimplify(); } 100 early() { stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationInterval=1); } " + gen1_setup_highmut_p1 + "1: late() { sim.treeSeqSimplify(); } 100 early() { stop(); }", __LINE__);
+	
+	// crosschecks simplify a copy of the tables after a full sort, and check that the result matches the tables simplified
+	// after sorting only the edges added since the last simplification; here treeSeqSimplify() is also called mid-tick
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationInterval=3, runCrosschecks=T); } " + gen1_setup_highmut_p1 + "2: early() { if (community.tick % 2 == 0) sim.treeSeqSimplify(); } 1: late() { sim.treeSeqSimplify(); } 50 late() { stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMModelType('nonWF'); initializeTreeSeq(simplificationInterval=3, runCrosschecks=T); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeMutationRate(1e-6); initializeRecombinationRate(1e-7); } reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 100); } early() { p1.fitnessScaling = 100 / p1.individualCount; } 2: early() { if (community.tick % 2 == 0) sim.treeSeqSimplify(); } 50 late() { stop(); }", __LINE__);
+	
+	// treeSeqSimplify() with multiple chromosomes, which get simplified in parallel across chromosomes
+	std::string multichrom_treeseq_setup("initialize() { initializeTreeSeq(simplificationInterval=10, runCrosschecks=T); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); for (id in 1:4) { initializeChromosome(id, 1e5); initializeMutationRate(1e-6); initializeRecombinationRate(1e-7); initializeGenomicElement(g1); } } 1 early() { sim.addSubpop('p1', 50); } ");
+	SLiMAssertScriptStop(multichrom_treeseq_setup + "50 early() { sim.treeSeqSimplify(); } 100 early() { stop(); }", __LINE__);
+	SLiMAssertScriptStop(multichrom_treeseq_setup + "50 early() { sim.treeSeqRememberIndividuals(p1.individuals[0:9]); } 100 early() { sim.treeSeqSimplify(); stop(); }", __LINE__);
 	
 	// treeSeqRememberIndividuals()
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "50 early() { sim.treeSeqRememberIndividuals(p1.individuals[integer(0)]); } 100 early() { sim.treeSeqSimplify(); stop(); }", __LINE__);
@@ -2229,6 +2363,69 @@ initialize() {
 			SLiMAssertScriptSuccess(test_script);
 		}
 	}
+	
+	// WF reproduction records into per-thread buffers when it runs in parallel, and merges them into the tables afterwards with
+	// a counting sort; and with several subpopulations or chromosomes, fitness is precomputed for all of them in one parallel
+	// pass.  Force those paths with one thread, so that they are tested in single-threaded builds too, and check that the tables
+	// and fitness values match those from the normal paths.  The model has sex, an X chromosome, migration, and cloning, to
+	// cover every reproduction loop.
+	if (Eidos_TemporaryDirectoryExists())
+	{
+		std::string forced_paths_model = "initialize() { initializeSLiMOptions(doMutationRunExperiments=F); parallelSetNumThreads(1); setSeed(11); initializeTreeSeq(simplificationInterval=5); initializeSex(); initializeMutationType('m1', 0.5, 'n', 0.0, 0.05); initializeGenomicElementType('g1', m1, 1.0); for (id in 1:2) { initializeChromosome(id, 1e5); initializeMutationRate(1e-6); initializeRecombinationRate(1e-7); initializeGenomicElement(g1); } initializeChromosome(3, 1e5, 'X'); initializeMutationRate(1e-6); initializeRecombinationRate(1e-7); initializeGenomicElement(g1); } 1 early() { sim.addSubpop('p1', 300); sim.addSubpop('p2', 200); p1.setMigrationRates(p2, 0.1); p2.setCloningRate(0.2); } ";
+		
+		for (int run = 1; run <= 2; ++run)
+		{
+			std::string output_path = temp_path + "/SLiM_forced_paths_" + std::to_string(run);
+			
+			// pedigree and mutation ids are global, so they are reset for each run to make the two runs identical
+			gSLiMForceParallelPaths = (run == 2);
+			gSLiM_next_pedigree_id = 0;
+			gSLiM_next_mutation_id = 0;
+			SLiMAssertScriptSuccess(forced_paths_model + "2:30 early() { writeFile('" + output_path + "_fitness.txt', format('%.17g', c(p1.cachedFitness(NULL), p2.cachedFitness(NULL))), append=T); } 30 late() { sim.treeSeqOutput('" + output_path + "', simplify=F); }", __LINE__);
+		}
+		
+		gSLiMForceParallelPaths = false;
+		
+		SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { w1 = readFile('" + temp_path + "/SLiM_forced_paths_1_fitness.txt'); w2 = readFile('" + temp_path + "/SLiM_forced_paths_2_fitness.txt'); if ((size(w1) == 29 * 500) & identical(w1, w2)) stop(); }", __LINE__);
+		
+		for (int chromosome_id = 1; chromosome_id <= 3; ++chromosome_id)
+		{
+			std::string file_name = "/chromosome_" + std::to_string(chromosome_id) + ".trees";
+			
+			_AssertTreeSeqFilesMatch(temp_path + "/SLiM_forced_paths_1" + file_name, temp_path + "/SLiM_forced_paths_2" + file_name, __LINE__);
+		}
+		
+		// SimplifyAllTreeSequences() simplifies each chromosome's tables separately (in parallel, when it can), and filters the
+		// shared node table afterwards; with one thread, check that simplifying every tick, including mid-tick, gives the same
+		// tables as simplifying only once at the end
+		std::string simplify_model = "initialize() { parallelSetNumThreads(1); setSeed(13); initializeTreeSeq(*****); initializeSex(); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); for (id in 1:2) { initializeChromosome(id, 1e5); initializeMutationRate(1e-6); initializeRecombinationRate(1e-7); initializeGenomicElement(g1); } initializeChromosome(3, 1e5, 'X'); initializeMutationRate(1e-6); initializeRecombinationRate(1e-7); initializeGenomicElement(g1); } 1 early() { sim.addSubpop('p1', 100); } ";
+		
+		for (int run = 1; run <= 2; ++run)
+		{
+			std::string model = simplify_model;
+			
+			model.replace(model.find("*****"), 5, (run == 1) ? "simplificationInterval=1" : "simplificationRatio=INF");
+			if (run == 1)
+				model += "2: early() { sim.treeSeqSimplify(); } ";
+			
+			gSLiM_next_pedigree_id = 0;
+			gSLiM_next_mutation_id = 0;
+			SLiMAssertScriptSuccess(model + "30 late() { sim.treeSeqOutput('" + temp_path + "/SLiM_simplify_" + std::to_string(run) + "', simplify=T); }", __LINE__);
+		}
+		
+		for (int chromosome_id = 1; chromosome_id <= 3; ++chromosome_id)
+		{
+			std::string file_name = "/chromosome_" + std::to_string(chromosome_id) + ".trees";
+			
+			_AssertTreeSeqFilesMatch(temp_path + "/SLiM_simplify_1" + file_name, temp_path + "/SLiM_simplify_2" + file_name, __LINE__);
+		}
+		
+#ifdef _OPENMP
+		gEidosNumThreads = gEidosMaxThreads;
+		gEidosNumThreadsOverride = false;
+		omp_set_num_threads(gEidosMaxThreads);
+#endif
+	}
 }
 
 #pragma mark Nucleotide API tests
@@ -3034,6 +3231,42 @@ initialize() {
 	SLiMAssertScriptSuccess(base_script + "calcSFS(10, sim.subpopulations.haplosomesForChromosomes(1), metric='count', fold=T); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcSFS(10, sim.subpopulations.haplosomesForChromosomes(2), metric='count', fold=T); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcSFS(10, sim.subpopulations.haplosomesForChromosomes(1), muts_ch1, metric='count', fold=T); }", __LINE__);
+	
+	// numerical consistency of the native implementations with their definitions in terms of mutation counts
+	std::string counts_script = "h = sim.subpopulations.haplosomesForChromosomes(1); n = size(h); c = h.mutationCountsInHaplosomes(muts_ch1); p = c / n; L = CHR1.lastPosition + 1; ";
+	
+	SLiMAssertScriptSuccess(base_script + counts_script + "if (abs(calcHeterozygosity(h) - 2 * sum(p * (1 - p)) / L) > 1e-15) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + counts_script + "k = sum((c > 0) & (c < n)); expected = (k == 0) ? 0.0 else k / sum(1 / (seqLen(n - 1) + 1)) / L; if (abs(calcWattersonsTheta(h) - expected) > 1e-15) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + counts_script + "if (abs(calcPi(h) - sum(c * (n - c)) / (n * (n - 1) / 2) / L) > 1e-15) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + "if (abs(calcPi(c(h_p1_ch1, h_p2_ch1)) - calcPairHeterozygosity(h_p1_ch1, h_p2_ch1)) > 1e-15) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + counts_script + "if (sum(calcSFS(NULL, h, metric='count')) != sum((c > 0) & (c < n))) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + counts_script + "if (sum(calcSFS(10, h, metric='count')) != sum(c > 0)) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + "if (!isNAN(calcFST(p1.haplosomesForChromosomes(1), p2.haplosomesForChromosomes(1), muts_ch1[integer(0)]))) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + "if (calcDxy(p1.haplosomesForChromosomes(1), p2.haplosomesForChromosomes(1), muts_ch1[integer(0)]) != 0.0) stop(); }", __LINE__);
+	
+	// (float)calcLD_D(object<Mutation>$ mut1, [No<Mutation> mut2 = NULL], [No<Haplosome> haplosomes = NULL]) and calcLD_Rsquared()
+	std::string ld_script = "if (size(muts_ch1) == 0) return; mut = muts_ch1[0]; h = sim.subpopulations.haplosomesForChromosomes(1); n = size(h); h1 = h[h.containsMutations(mut)]; p_1 = size(h1) / n; p_12 = h1.mutationCountsInHaplosomes(muts_ch1) / n; p_2 = h.mutationFrequenciesInHaplosomes(muts_ch1); D = p_12 - p_1 * p_2; ";
+	
+	SLiMAssertScriptRaise(base_script + "if (size(muts_ch1)) calcLD_D(muts_ch1[0], NULL, h0); }", "haplosomes must be non-empty", __LINE__);
+	SLiMAssertScriptRaise(base_script + "if (size(muts_ch1)) calcLD_D(muts_ch1[0], NULL, sim.subpopulations.haplosomes); }", "same chromosome", __LINE__);
+	SLiMAssertScriptRaise(base_script + "if (size(muts_ch1) & size(muts_ch2)) calcLD_Rsquared(muts_ch1[0], muts_ch2); }", "same chromosome", __LINE__);
+	SLiMAssertScriptSuccess(base_script + ld_script + "if (!identical(calcLD_D(mut), calcLD_D(mut, muts_ch1, h))) stop(); if (any(abs(calcLD_D(mut) - D) > 1e-15)) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + ld_script + "r2 = calcLD_Rsquared(mut, muts_ch1, h); expected = D^2 / (p_1 * p_2 * (1.0 - p_1) * (1.0 - p_2)); if (!identical(isNAN(r2), isNAN(expected))) stop(); if (any(abs(r2[!isNAN(r2)] - expected[!isNAN(expected)]) > 1e-12)) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + ld_script + "r = calcLD_Rsquared(mut, muts_ch1, h, squared=F); r2 = calcLD_Rsquared(mut, muts_ch1, h); ok = !isNAN(r2); if (any(abs(r[ok]^2 - r2[ok]) > 1e-12)) stop(); }", __LINE__);
+	
+	// null haplosomes are an error for all of the above except calcSFS(), which excludes them silently, and calcLD_D()/calcLD_Rsquared() with haplosomes=NULL
+	std::string null_script = "initialize() { initializeSex(); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeChromosome(1, 1e5, 'X'); initializeMutationRate(1e-6); initializeGenomicElement(g1, 0, 1e5-1); initializeRecombinationRate(1e-8); } 1 late() { sim.addSubpop('p1', 50); sim.addSubpop('p2', 50); } 20 late() { h = sim.subpopulations.haplosomes; h1 = p1.haplosomes; h2 = p2.haplosomes; nonnull = h[!h.isNullHaplosome]; muts = sim.mutations; ";
+	
+	SLiMAssertScriptRaise(null_script + "calcHeterozygosity(h); }", "must not contain null haplosomes", __LINE__);
+	SLiMAssertScriptRaise(null_script + "calcWattersonsTheta(h); }", "must not contain null haplosomes", __LINE__);
+	SLiMAssertScriptRaise(null_script + "calcPi(h); }", "must not contain null haplosomes", __LINE__);
+	SLiMAssertScriptRaise(null_script + "calcTajimasD(h); }", "must not contain null haplosomes", __LINE__);
+	SLiMAssertScriptRaise(null_script + "calcFST(h1, h2); }", "must not contain null haplosomes", __LINE__);
+	SLiMAssertScriptRaise(null_script + "calcDxy(h1, h2); }", "must not contain null haplosomes", __LINE__);
+	SLiMAssertScriptRaise(null_script + "calcLD_D(muts[0], NULL, h); }", "must not contain null haplosomes", __LINE__);
+	SLiMAssertScriptSuccess(null_script + "calcHeterozygosity(nonnull); calcPi(nonnull); calcFST(h1[!h1.isNullHaplosome], h2[!h2.isNullHaplosome]); }", __LINE__);
+	SLiMAssertScriptSuccess(null_script + "if (!identical(calcSFS(10, h, metric='count'), calcSFS(10, nonnull, metric='count'))) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(null_script + "if (size(muts) == 0) return; if (!identical(calcLD_D(muts[0], muts), calcLD_D(muts[0], muts, nonnull))) stop(); }", __LINE__);
 }
 
 #pragma mark Spatial kernel value tests
@@ -1365,7 +1365,7 @@ slim_tick_t Species::_InitializePopulationFromTextFile(const char *p_file, Eidos
 			else
 				continue;	// no mutations
 				
-			slim_position_t mutrun_length_ = haplosome.mutrun_length_;
+			const MutationRunLayout &mutrun_layout = *haplosome.mutrun_layout_;
 			slim_mutrun_index_t current_mutrun_index = -1;
 			MutationRun *current_mutrun = nullptr;
 			
@@ -1380,7 +1380,7 @@ slim_tick_t Species::_InitializePopulationFromTextFile(const char *p_file, Eidos
 					EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromTextFile): polymorphism " << polymorphism_id << " has not been defined." << EidosTerminate();
 				
 				MutationIndex mutation = found_mut_pair->second;
-				slim_mutrun_index_t mutrun_index = (slim_mutrun_index_t)((mut_block_ptr + mutation)->position_ / mutrun_length_);
+				slim_mutrun_index_t mutrun_index = mutrun_layout.RunIndexForPosition((mut_block_ptr + mutation)->position_);
 				
 				assert(mutrun_index != -1);		// to clue in the static analyzer
 				
@@ -2156,14 +2156,14 @@ slim_tick_t Species::_InitializePopulationFromBinaryFile(const char *p_file, Eid
 							}
 						}
 						
-						slim_position_t mutrun_length_ = haplosome.mutrun_length_;
+						const MutationRunLayout &mutrun_layout = *haplosome.mutrun_layout_;
 						slim_mutrun_index_t current_mutrun_index = -1;
 						MutationRun *current_mutrun = nullptr;
 						
 						for (int mut_index = 0; mut_index < mutcount; ++mut_index)
 						{
 							MutationIndex mutation = haplosomebuf[mut_index];
-							slim_mutrun_index_t mutrun_index = (slim_mutrun_index_t)((mut_block_ptr + mutation)->position_ / mutrun_length_);
+							slim_mutrun_index_t mutrun_index = mutrun_layout.RunIndexForPosition((mut_block_ptr + mutation)->position_);
 							
 							if (mutrun_index != current_mutrun_index)
 							{
@@ -2788,6 +2788,11 @@ void Species::MaintainMutationRegistry(void)
 		// likely to be pretty small for most simulations, so if the cost is significant then it may be a lose.
 		if (cycle_ % 100 == 0)
 			population_.UniqueMutationRuns();
+		
+		// With compressMutationRuns=T, pack the mutation runs that are in use now; this is done after uniquing, so that
+		// duplicate runs are freed rather than packed, and at the end of the tick, when no run buffers are being used.
+		if (compress_mutation_runs_)
+			population_.PackMutationRuns();
 	}
 }
 
@@ -3406,7 +3411,7 @@ void Species::nonWF_MergeOffspring(void)
 		
 		EIDOS_BENCHMARK_START(EidosBenchmarkType::k_MIGRANT_CLEAR);
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_MIGRANT_CLEAR);
-#pragma omp parallel for schedule(static) default(none) shared(parent_count) firstprivate(parents)  if(parent_count >= EIDOS_OMPMIN_MIGRANT_CLEAR) num_threads(thread_count)
+#pragma omp parallel for schedule(static) default(none) shared(parent_count) firstprivate(parents)  if((int64_t)parent_count >= EIDOS_OMPMIN_MIGRANT_CLEAR) num_threads(thread_count)
 		for (size_t parent_index = 0; parent_index < parent_count; ++parent_index)
 		{
 			parents[parent_index]->migrant_ = false;
@@ -4173,6 +4178,8 @@ void Species::TabulateSLiMMemoryUsage_Species(SLiMMemoryUsage_Species *p_usage)
 		{
 			int64_t mutrun_objectCount = 0;
 			int64_t mutrun_externalBuffers = 0;
+			int64_t mutrun_packedBuffers = 0;
+			int64_t mutrun_packingSavings = 0;
 			int64_t mutrun_nonneutralCaches = 0;
 			
 			// each thread has its own inuse pool
@@ -4186,6 +4193,8 @@ void Species::TabulateSLiMMemoryUsage_Species(SLiMMemoryUsage_Species *p_usage)
 					{
 						mutrun_objectCount++;
 						mutrun_externalBuffers += inuse_mutrun->MemoryUsageForMutationIndexBuffers();
+						mutrun_packedBuffers += inuse_mutrun->MemoryUsageForPackedBuffers();
+						mutrun_packingSavings += inuse_mutrun->MemoryUsageSavedByPacking();
 						mutrun_nonneutralCaches += inuse_mutrun->MemoryUsageForNonneutralCaches();
 					}
 				}
@@ -4195,6 +4204,8 @@ void Species::TabulateSLiMMemoryUsage_Species(SLiMMemoryUsage_Species *p_usage)
 			p_usage->mutationRunObjects = sizeof(MutationRun) * mutrun_objectCount;
 			
 			p_usage->mutationRunExternalBuffers = mutrun_externalBuffers;
+			p_usage->mutationRunPackedBuffers = mutrun_packedBuffers;
+			p_usage->mutationRunPackingSavings = mutrun_packingSavings;
 			p_usage->mutationRunNonneutralCaches = mutrun_nonneutralCaches;
 		}
 		
@@ -4219,7 +4230,7 @@ void Species::TabulateSLiMMemoryUsage_Species(SLiMMemoryUsage_Species *p_usage)
 			}
 			
 			p_usage->mutationRunUnusedPoolSpace = sizeof(MutationRun) * mutrun_unusedCount;
-			p_usage->mutationRunExternalBuffers = mutrun_unusedBuffers;
+			p_usage->mutationRunUnusedPoolBuffers = mutrun_unusedBuffers;
 		}
 	}
 	
@@ -4692,6 +4703,36 @@ struct edge_plus_time {
 	double left, right;
 };
 
+// the sort order required by tskit for edges: by parent time, then parent id, then child id, then left coordinate
+static inline __attribute__((always_inline)) bool edge_plus_time_less(const edge_plus_time &lhs, const edge_plus_time &rhs)
+{
+	if (lhs.time == rhs.time) {
+		if (lhs.parent == rhs.parent) {
+			if (lhs.child == rhs.child) {
+				return lhs.left < rhs.left;
+			}
+			return lhs.child < rhs.child;
+		}
+		return lhs.parent < rhs.parent;
+	}
+	return lhs.time < rhs.time;
+}
+
+// Simplification leaves the edge table sorted, and the edges recorded after that are appended to the end of it.  This
+// finds the length of the sorted prefix, so that only the edges after it need to be sorted and then merged into it;
+// that makes the cost of sorting proportional to the number of new edges (plus a linear merge) rather than n log n in
+// the size of the whole table, which matters most when simplifying often to keep the tables small.  Nothing depends
+// upon the prefix actually being the old edges; any sorted prefix works, and in the worst case it has length 1.
+static std::size_t slim_sorted_edge_prefix_length(const edge_plus_time *values, std::size_t num_rows)
+{
+	std::size_t prefix_length = (num_rows ? 1 : 0);
+	
+	while ((prefix_length < num_rows) && !edge_plus_time_less(values[prefix_length], values[prefix_length - 1]))
+		prefix_length++;
+	
+	return prefix_length;
+}
+
 // This parallel sorter is basically a clone of _Eidos_ParallelQuicksort_ASCENDING() in eidos_sorting.inc
 // The only difference (and the only reason we can't use that code directly) is we want to inline our comparator
 #ifdef _OPENMP
@@ -4806,20 +4847,20 @@ slim_sort_edges(tsk_table_sorter_t *sorter, tsk_size_t start)
 		temp_edge_data[i] = edge_plus_time{ node_times[edges->parent[i]], edges->parent[i], edges->child[i], edges->left[i], edges->right[i] };
 	}
 	
-	// sort with std::sort
-	std::sort(temp_edge_data, temp_edge_data + num_rows,
-			  [](const edge_plus_time &lhs, const edge_plus_time &rhs) {
-		if (lhs.time == rhs.time) {
-			if (lhs.parent == rhs.parent) {
-				if (lhs.child == rhs.child) {
-					return lhs.left < rhs.left;
-				}
-				return lhs.child < rhs.child;
-			}
-			return lhs.parent < rhs.parent;
-		}
-		return lhs.time < rhs.time;
-	});
+	// sort the edges after the already sorted prefix with std::sort, and then merge them into the prefix
+	std::size_t sorted_prefix = slim_sorted_edge_prefix_length(temp_edge_data, num_rows);
+	
+	if (sorted_prefix == num_rows)
+	{
+		// the edge table is already sorted, so there is nothing to copy back
+		free(temp_edge_data);
+		return 0;
+	}
+	
+	std::sort(temp_edge_data + sorted_prefix, temp_edge_data + num_rows,
+			  [](const edge_plus_time &lhs, const edge_plus_time &rhs) { return edge_plus_time_less(lhs, rhs); });
+	std::inplace_merge(temp_edge_data, temp_edge_data + sorted_prefix, temp_edge_data + num_rows,
+					   [](const edge_plus_time &lhs, const edge_plus_time &rhs) { return edge_plus_time_less(lhs, rhs); });
 	
 	// post-sort: copy the sorted temp_edge_data vector back into the edge table
 	for (std::size_t i = 0; i < num_rows; ++i)
@@ -4861,7 +4902,7 @@ slim_sort_edges_PARALLEL(tsk_table_sorter_t *sorter, tsk_size_t start)
 	{
 		EIDOS_BENCHMARK_START(EidosBenchmarkType::k_SIMPLIFY_SORT_PRE);
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_SIMPLIFY_SORT_PRE);
-#pragma omp parallel for schedule(static) default(none) shared(num_rows, temp_edge_data, edges, node_times) if(num_rows >= EIDOS_OMPMIN_SIMPLIFY_SORT_PRE) num_threads(thread_count)
+#pragma omp parallel for schedule(static) default(none) shared(num_rows, temp_edge_data, edges, node_times) if((int64_t)num_rows >= EIDOS_OMPMIN_SIMPLIFY_SORT_PRE) num_threads(thread_count)
 		for (tsk_size_t i = 0; i < num_rows; ++i)
 		{
 			temp_edge_data[i] = edge_plus_time{ node_times[edges->parent[i]], edges->parent[i], edges->child[i], edges->left[i], edges->right[i] };
@@ -4869,17 +4910,30 @@ slim_sort_edges_PARALLEL(tsk_table_sorter_t *sorter, tsk_size_t start)
 		EIDOS_BENCHMARK_END(EidosBenchmarkType::k_SIMPLIFY_SORT_PRE);
 	}
 	
+	// find the already sorted prefix of the edge table (typically the edges that survived the last simplification);
+	// only the edges after it need to be sorted, after which they are merged into it
+	std::size_t sorted_prefix = slim_sorted_edge_prefix_length(temp_edge_data, num_rows);
+	
+	if (sorted_prefix == num_rows)
+	{
+		// the edge table is already sorted, so there is nothing to copy back
+		free(temp_edge_data);
+		return 0;
+	}
+	
 	// sort with std::sort when not running parallel, or if the task is small;
 	// sort in parallel for big tasks if we can; see Eidos_ParallelSort() which
 	// this is patterned after, but we want the (faster) inlined comparator...
 	{
 		EIDOS_BENCHMARK_START(EidosBenchmarkType::k_SIMPLIFY_SORT);
 		
+		std::size_t unsorted_rows = num_rows - sorted_prefix;
+		
 #ifdef _OPENMP
-		if (num_rows >= EIDOS_OMPMIN_SIMPLIFY_SORT)
+		if ((int64_t)unsorted_rows >= EIDOS_OMPMIN_SIMPLIFY_SORT)
 		{
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_SIMPLIFY_SORT);
-#pragma omp parallel default(none) shared(num_rows, temp_edge_data) num_threads(thread_count)
+#pragma omp parallel default(none) shared(num_rows, unsorted_rows, sorted_prefix, temp_edge_data) num_threads(thread_count)
 			{
 				// We fall through to using std::sort when below a threshold interval size.
 				// The larger the threshold, the less time we spend thrashing tasks on small
@@ -4889,14 +4943,14 @@ slim_sort_edges_PARALLEL(tsk_table_sorter_t *sorter, tsk_size_t start)
 				// to subdivide with tasks enough that the workload is shared well, and then
 				// do the rest of the work with std::sort().  The more threads there are,
 				// the smaller we want to subdivide.
-				int64_t fallthrough = num_rows / (EIDOS_FALLTHROUGH_FACTOR * omp_get_num_threads());
+				int64_t fallthrough = unsorted_rows / (EIDOS_FALLTHROUGH_FACTOR * omp_get_num_threads());
 				
 				if (fallthrough < 1000)
 					fallthrough = 1000;
 				
 #pragma omp single nowait
 				{
-					_Eidos_ParallelQuicksort_ASCENDING(temp_edge_data, 0, num_rows - 1, fallthrough);
+					_Eidos_ParallelQuicksort_ASCENDING(temp_edge_data, sorted_prefix, num_rows - 1, fallthrough);
 				}
 			} // End of parallel region
 			
@@ -4904,24 +4958,17 @@ slim_sort_edges_PARALLEL(tsk_table_sorter_t *sorter, tsk_size_t start)
 		}
 #endif
 		
-		std::sort(temp_edge_data, temp_edge_data + num_rows,
-				  [](const edge_plus_time &lhs, const edge_plus_time &rhs) {
-			if (lhs.time == rhs.time) {
-				if (lhs.parent == rhs.parent) {
-					if (lhs.child == rhs.child) {
-						return lhs.left < rhs.left;
-					}
-					return lhs.child < rhs.child;
-				}
-				return lhs.parent < rhs.parent;
-			}
-			return lhs.time < rhs.time;
-		});
+		std::sort(temp_edge_data + sorted_prefix, temp_edge_data + num_rows,
+				  [](const edge_plus_time &lhs, const edge_plus_time &rhs) { return edge_plus_time_less(lhs, rhs); });
 		
 #ifdef _OPENMP
 		// If we did a parallel sort, we jump here to skip the single-threaded sort
 	didParallelSort:
 #endif
+		
+		// merge the newly sorted edges into the sorted prefix; this is linear, given a temporary buffer
+		std::inplace_merge(temp_edge_data, temp_edge_data + sorted_prefix, temp_edge_data + num_rows,
+						   [](const edge_plus_time &lhs, const edge_plus_time &rhs) { return edge_plus_time_less(lhs, rhs); });
 		EIDOS_BENCHMARK_END(EidosBenchmarkType::k_SIMPLIFY_SORT);
 	}
 	
@@ -4929,7 +4976,7 @@ slim_sort_edges_PARALLEL(tsk_table_sorter_t *sorter, tsk_size_t start)
 	{
 		EIDOS_BENCHMARK_START(EidosBenchmarkType::k_SIMPLIFY_SORT_POST);
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_SIMPLIFY_SORT_POST);
-#pragma omp parallel for schedule(static) default(none) shared(num_rows, temp_edge_data, edges) if(num_rows >= EIDOS_OMPMIN_SIMPLIFY_SORT_POST) num_threads(thread_count)
+#pragma omp parallel for schedule(static) default(none) shared(num_rows, temp_edge_data, edges) if((int64_t)num_rows >= EIDOS_OMPMIN_SIMPLIFY_SORT_POST) num_threads(thread_count)
 		for (std::size_t i = 0; i < num_rows; ++i)
 		{
 			edges->left[i] = temp_edge_data[i].left;
@@ -4952,6 +4999,24 @@ void Species::_SimplifyTreeSequence(TreeSeqInfo &tsinfo, const std::vector<tsk_i
 	// It assumes that a variety of things will be done by the caller, and those things are not optional!
 	// With multiple chromosomes when running parallel, this will be called from inside a parallel region!
 	
+	// when running crosschecks, sort and simplify a copy of the tables with tskit's own sorter, which always sorts the whole
+	// edge table, so that we can check below that our edge sorters, which sort only the edges added since the last
+	// simplification, lead to the same simplified tables
+	tsk_table_collection_t *reference_tables = nullptr;
+	
+	if (running_treeseq_crosschecks_ && (cycle_ % treeseq_crosschecks_interval_ == 0))
+	{
+		reference_tables = (tsk_table_collection_t *)malloc(sizeof(tsk_table_collection_t));
+		if (!reference_tables)
+			EIDOS_TERMINATION << "ERROR (Species::_SimplifyTreeSequence): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+		
+		int ret = tsk_table_collection_copy(&tsinfo.tables_, reference_tables, 0);
+		if (ret != 0) handle_error("_SimplifyTreeSequence tsk_table_collection_copy()", ret);
+		
+		ret = tsk_table_collection_sort(reference_tables, /* edge_start */ NULL, TSK_NO_CHECK_INTEGRITY);
+		if (ret < 0) handle_error("_SimplifyTreeSequence tsk_table_collection_sort()", ret);
+	}
+	
 	// sort the table collection
 	{
 		tsk_flags_t flags = TSK_NO_CHECK_INTEGRITY;
@@ -4970,8 +5035,7 @@ void Species::_SimplifyTreeSequence(TreeSeqInfo &tsinfo, const std::vector<tsk_i
 #else
 		// sort the tables using our own custom edge sorter, for additional speed through inlining of the comparison function
 		// see https://github.com/tskit-dev/tskit/pull/627, https://github.com/tskit-dev/tskit/pull/711
-		// FIXME for additional speed we could perhaps be smart about only sorting the portions of the edge table
-		// that need it, but the tricky thing is that all the old stuff has to be at the bottom of the table, not the top...
+		// the sorters only sort the edges added since the last simplification, and merge them into the old (sorted) edges
 		tsk_table_sorter_t sorter;
 		int ret = tsk_table_sorter_init(&sorter, &tsinfo.tables_, /* flags */ flags);
 		if (ret != 0) handle_error("tsk_table_sorter_init", ret);
@@ -4998,11 +5062,17 @@ void Species::_SimplifyTreeSequence(TreeSeqInfo &tsinfo, const std::vector<tsk_i
 		if (ret != 0) handle_error("tsk_table_sorter_free", ret);
 #endif
 	}
-	
+
 	// remove redundant sites we added
 	{
 		int ret = tsk_table_collection_deduplicate_sites(&tsinfo.tables_, 0);
 		if (ret < 0) handle_error("tsk_table_collection_deduplicate_sites", ret);
+		
+		if (reference_tables)
+		{
+			ret = tsk_table_collection_deduplicate_sites(reference_tables, 0);
+			if (ret < 0) handle_error("_SimplifyTreeSequence tsk_table_collection_deduplicate_sites()", ret);
+		}
 	}
 	
 	// simplify
@@ -5028,6 +5098,27 @@ void Species::_SimplifyTreeSequence(TreeSeqInfo &tsinfo, const std::vector<tsk_i
 		if (ret != 0) handle_error("tsk_table_collection_simplify", ret);
 		
 		EIDOS_BENCHMARK_END(EidosBenchmarkType::k_SIMPLIFY_CORE);
+		
+		if (reference_tables)
+		{
+			ret = tsk_table_collection_simplify(reference_tables, samples.data(), (tsk_size_t)samples.size(), flags, NULL);
+			if (ret != 0) handle_error("_SimplifyTreeSequence tsk_table_collection_simplify()", ret);
+		}
+	}
+	
+	// check that simplifying after our sort gave the same tables as simplifying after tskit's full sort
+	if (reference_tables)
+	{
+		bool tables_match = tsk_edge_table_equals(&tsinfo.tables_.edges, &reference_tables->edges, 0) &&
+			tsk_site_table_equals(&tsinfo.tables_.sites, &reference_tables->sites, 0) &&
+			tsk_mutation_table_equals(&tsinfo.tables_.mutations, &reference_tables->mutations, 0);
+		
+		int ret = tsk_table_collection_free(reference_tables);
+		if (ret != 0) handle_error("_SimplifyTreeSequence tsk_table_collection_free()", ret);
+		free(reference_tables);
+		
+		if (!tables_match)
+			EIDOS_TERMINATION << "ERROR (Species::_SimplifyTreeSequence): (internal error) the simplified tables do not match the tables simplified after a full sort." << EidosTerminate();
 	}
 	
 	// note that we leave things in a partially completed state; the nodes and individuals tables still
@@ -5114,26 +5205,76 @@ void Species::SimplifyAllTreeSequences(void)
 	
 	WritePopulationTable(&main_tables);
 	
-	// simplify all of the tree sequences
-	// FIXME MULTICHROM: parallelize simplification here!
-	for (Chromosome *chromosome : chromosomes_)
+	// simplify all of the tree sequences; with more than one chromosome, we do this in parallel across chromosomes.
+	// This is safe because each chromosome has its own edge, site, and mutation tables, which are the only tables
+	// that sorting and simplification modify.  The shared node, individual, and population tables are only read,
+	// since we pass TSK_SIMPLIFY_NO_FILTER_NODES and do not filter individuals or populations; the node table gets
+	// filtered below, after all the chromosomes are done.  Each chromosome's tables get their own shallow copies of
+	// the shared tables from CopySharedTablesIn(), so the threads do not share any table collection structs either.
+	int chromosome_count = (int)chromosomes_.size();
+	bool saw_error = false;	// deferred raises for OpenMP compliance
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	bool profiling = (gEidosProfilingClientCount ? true : false);
+	std::vector<eidos_profile_t> chromosome_times(profiling ? chromosome_count : 0, 0);
+	eidos_profile_t *chromosome_times_ptr = chromosome_times.data();
+	eidos_profile_t simplify_start = (profiling ? Eidos_BenchmarkTime() : 0);
+#endif
+	
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES);
+#if (SLIMPROFILING == 1)
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(chromosome_count, samples) firstprivate(profiling, chromosome_times_ptr) reduction(||: saw_error) if(chromosome_count >= EIDOS_OMPMIN_SIMPLIFY_CHROMOSOMES) num_threads(thread_count)
+#else
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(chromosome_count, samples) reduction(||: saw_error) if(chromosome_count >= EIDOS_OMPMIN_SIMPLIFY_CHROMOSOMES) num_threads(thread_count)
+#endif
+	for (int chromosome_index = 0; chromosome_index < chromosome_count; ++chromosome_index)
 	{
-		slim_chromosome_index_t chromosome_index = chromosome->Index();
+#if (SLIMPROFILING == 1)
+		// PROFILING; note that Eidos_ProfileTime() is not thread-safe, so we use the uncorrected benchmark clock
+		eidos_profile_t chromosome_start = (profiling ? Eidos_BenchmarkTime() : 0);
+#endif
+		
 		TreeSeqInfo &chromosome_tsinfo = treeseq_[chromosome_index];
 		tsk_table_collection_t &chromosome_tables = chromosome_tsinfo.tables_;
 		
-		// swap in the shared tables from the main tree sequence; we need them for simplify to work, but
-		// simplify should not touch any of them, so it should be safe to simplify using them directly
-		if (chromosome_index > 0)
-			CopySharedTablesIn(chromosome_tables);
+		try {
+			// swap in the shared tables from the main tree sequence; we need them for simplify to work, but
+			// simplify should not touch any of them, so it should be safe to simplify using them directly
+			if (chromosome_index > 0)
+				CopySharedTablesIn(chromosome_tables);
+			
+			// simplify
+			_SimplifyTreeSequence(chromosome_tsinfo, samples);
+			
+			// swap out the shared tables immediately after; the filtering code below does not need the shared tables
+			if (chromosome_index > 0)
+				DisconnectCopiedSharedTables(chromosome_tables);
+		} catch (...) {
+			saw_error = true;
+		}
 		
-		// simplify
-		_SimplifyTreeSequence(chromosome_tsinfo, samples);
+#if (SLIMPROFILING == 1)
+		// PROFILING; each chromosome writes only its own slot, so no synchronization is needed
+		if (profiling)
+			chromosome_times_ptr[chromosome_index] = Eidos_BenchmarkTime() - chromosome_start;
+#endif
+	}
+	
+	if (saw_error)
+		EIDOS_TERMINATION << "ERROR (Species::SimplifyAllTreeSequences): an exception was caught inside a parallel region." << EidosTerminate(nullptr);
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	if (profiling)
+	{
+		profile_simplify_count_++;
+		profile_simplify_wall_time_ += (Eidos_BenchmarkTime() - simplify_start);
 		
-		// swap out the shared tables immediately after; the filtering code below does not need the shared tables
-		if (chromosome_index > 0)
-			DisconnectCopiedSharedTables(chromosome_tables);
+		for (eidos_profile_t chromosome_time : chromosome_times)
+			profile_simplify_chromosome_time_ += chromosome_time;
 	}
+#endif
 	
 	// the node table needs to be filtered now; we turned that off for simplification, so it could be parallelized.
 	// this code is copied from https://github.com/tskit-dev/tskit/pull/2665/files (multichrom_wright_fisher.c)
@@ -5589,6 +5730,38 @@ void Species::SetCurrentNewIndividual(__attribute__((unused))Individual *p_indiv
 	
 	// This is called by code where new individuals are created
 	
+	// When recording from inside a parallel region, the node table rows for the new individual were reserved by
+	// BeginParallelTreeSeqRecording(), in pedigree id order, so we just fill them in.  This touches only the new
+	// individual's own rows, so it is thread-safe.  There is no table position to record for RetractNewIndividual(),
+	// since modifyChild() callbacks, which can reject a new individual, never run in parallel.
+	if (treeseq_buffering_)
+	{
+		slim_pedigreeid_t individual_offset = p_individual->PedigreeID() - treeseq_buffer_base_pedigree_id_;
+		
+#if DEBUG
+		if ((individual_offset < 0) || (individual_offset >= treeseq_buffer_individual_count_))
+			EIDOS_TERMINATION << "ERROR (Species::SetCurrentNewIndividual): (internal error) new individual is outside the range reserved for parallel recording." << EidosTerminate();
+#endif
+		
+		tsk_node_table_t &shared_node_table = treeseq_[0].tables_.nodes;
+		tsk_id_t nodeTSKID1 = treeseq_buffer_base_node_ + (tsk_id_t)(individual_offset * 2);
+		bool is_male = (p_individual->sex_ == IndividualSex::kMale);
+		
+		for (int node_offset = 0; node_offset <= 1; ++node_offset)
+		{
+			tsk_id_t nodeTSKID = nodeTSKID1 + node_offset;
+			HaplosomeMetadataRec *default_metadata = (node_offset == 0) ? (is_male ? hap_metadata_1M_ : hap_metadata_1F_) : (is_male ? hap_metadata_2M_ : hap_metadata_2F_);
+			HaplosomeMetadataRec *metadata = (HaplosomeMetadataRec *)(shared_node_table.metadata + shared_node_table.metadata_offset[nodeTSKID]);
+			
+			memcpy(metadata, default_metadata, haplosome_metadata_size_);
+			metadata->haplosome_id_ = p_individual->PedigreeID() * 2 + node_offset;
+			shared_node_table.population[nodeTSKID] = (tsk_id_t)p_individual->subpopulation_->subpopulation_id_;
+		}
+		
+		p_individual->SetTskitNodeIdBase(nodeTSKID1);
+		return;
+	}
+	
 	// Remember the new individual being defined; we don't need this right now,
 	// but it seems to keep coming back, so I've kept the code for it...
 	//current_new_individual_ = p_individual;
@@ -5779,6 +5952,9 @@ void Species::RecordNewHaplosome(slim_position_t *p_breakpoints, int p_breakpoin
 	if (p_breakpoints_count && (p_breakpoints[p_breakpoints_count - 1] > chromosome.last_position_))
 		p_breakpoints_count--;
 	
+	// when recording from inside a parallel region, edges go into this thread's buffer; see BeginParallelTreeSeqRecording()
+	TreeSeqThreadBuffer *thread_buffer = (treeseq_buffering_ ? &treeseq_thread_buffers_[omp_get_thread_num() * chromosomes_.size() + chromosome_index] : nullptr);
+	
 	// add an edge for each interval between breakpoints
 	double left = 0.0;
 	double right;
@@ -5800,16 +5976,31 @@ void Species::RecordNewHaplosome(slim_position_t *p_breakpoints, int p_breakpoin
 			EIDOS_TERMINATION << "ERROR (Species::RecordNewHaplosome): (internal error) a left==right breakpoint was passed to RecordNewHaplosome()." << EidosTerminate();
 #endif
 		
-		int ret = tsk_edge_table_add_row(&tsinfo.tables_.edges, left, right, parent, offspringTSKID, NULL, 0);
-		if (ret < 0) handle_error("tsk_edge_table_add_row", ret);
+		if (thread_buffer)
+		{
+			thread_buffer->edges_.emplace_back(TreeSeqEdgeRec{left, right, parent, offspringTSKID});
+		}
+		else
+		{
+			int ret = tsk_edge_table_add_row(&tsinfo.tables_.edges, left, right, parent, offspringTSKID, NULL, 0);
+			if (ret < 0) handle_error("tsk_edge_table_add_row", ret);
+		}
 		
 		left = right;
 	}
 	
 	right = (double)chromosome.last_position_+1;
 	tsk_id_t parent = (tsk_id_t) (polarity ? haplosome1TSKID : haplosome2TSKID);
-	int ret = tsk_edge_table_add_row(&tsinfo.tables_.edges, left, right, parent, offspringTSKID, NULL, 0);
-	if (ret < 0) handle_error("tsk_edge_table_add_row", ret);
+	
+	if (thread_buffer)
+	{
+		thread_buffer->edges_.emplace_back(TreeSeqEdgeRec{left, right, parent, offspringTSKID});
+	}
+	else
+	{
+		int ret = tsk_edge_table_add_row(&tsinfo.tables_.edges, left, right, parent, offspringTSKID, NULL, 0);
+		if (ret < 0) handle_error("tsk_edge_table_add_row", ret);
+	}
 }
 
 void Species::RecordNewHaplosome_NULL(Haplosome *p_new_haplosome)
@@ -5885,7 +6076,40 @@ void Species::RecordNewDerivedState(const Haplosome *p_haplosome, slim_position_
 	tsk_id_t haplosomeTSKID = p_haplosome->OwningIndividual()->TskitNodeIdBase() + p_haplosome->chromosome_subposition_;
 	slim_chromosome_index_t index = p_haplosome->chromosome_index_;
 	TreeSeqInfo &tsinfo = treeseq_[index];
-
+	
+	// when recording from inside a parallel region, the derived state goes into this thread's buffer, and the site and mutation
+	// table rows are added by EndParallelTreeSeqRecording(); the time check below is unnecessary in that case, since the new
+	// haplosome's node was created in this tick by BeginParallelTreeSeqRecording()
+	if (treeseq_buffering_)
+	{
+		TreeSeqThreadBuffer &thread_buffer = treeseq_thread_buffers_[omp_get_thread_num() * chromosomes_.size() + index];
+		std::vector<slim_mutationid_t> &derived_mutation_ids = thread_buffer.derived_state_ids_;
+		std::vector<MutationMetadataRec> &mutation_metadata = thread_buffer.derived_state_metadata_;
+		size_t state_start = derived_mutation_ids.size();
+		MutationMetadataRec metadata_rec;
+		
+		for (Mutation *mutation : p_derived_mutations)
+		{
+			derived_mutation_ids.emplace_back(mutation->mutation_id_);
+			MetadataForMutation(mutation, &metadata_rec);
+			mutation_metadata.emplace_back(metadata_rec);
+		}
+		
+		auto position_range_iter = population_.treeseq_substitutions_map_.equal_range(p_position);
+		
+		for (auto position_iter = position_range_iter.first; position_iter != position_range_iter.second; ++position_iter)
+		{
+			Substitution *substitution = position_iter->second;
+			
+			derived_mutation_ids.emplace_back(substitution->mutation_id_);
+			MetadataForSubstitution(substitution, &metadata_rec);
+			mutation_metadata.emplace_back(metadata_rec);
+		}
+		
+		thread_buffer.derived_states_.emplace_back(TreeSeqDerivedStateRec{haplosomeTSKID, p_position, state_start, derived_mutation_ids.size() - state_start});
+		return;
+	}
+	
 	// Identify any previous mutations at this site in this haplosome, and add a new site.
 	// This site may already exist, but we add it anyway, and deal with that in deduplicate_sites().
 	double tsk_position = (double) p_position;
@@ -5950,6 +6174,146 @@ void Species::RecordNewDerivedState(const Haplosome *p_haplosome, slim_position_
 	if (ret < 0) handle_error("tsk_mutation_table_add_row", ret);
 }
 
+void Species::BeginParallelTreeSeqRecording(slim_pedigreeid_t p_base_pedigree_id, slim_popsize_t p_individual_count)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Species::BeginParallelTreeSeqRecording(): illegal when parallel");
+	
+#if DEBUG
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (Species::BeginParallelTreeSeqRecording): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+	if (treeseq_buffering_)
+		EIDOS_TERMINATION << "ERROR (Species::BeginParallelTreeSeqRecording): (internal error) parallel recording is already in progress." << EidosTerminate();
+#endif
+	
+	// This is called before new individuals, with consecutive pedigree ids starting at p_base_pedigree_id, are generated
+	// in a parallel region.  SetCurrentNewIndividual(), RecordNewHaplosome(), and RecordNewDerivedState() can then be
+	// called from any thread until EndParallelTreeSeqRecording() is called after the parallel region.  We reserve two
+	// node table rows per individual here, in pedigree id order, which gives every individual the same node ids it
+	// would have had in a single-threaded run; SetCurrentNewIndividual() fills in the rest of the node information.
+	double time = (double) -1 * (community_.tree_seq_tick_ + community_.tree_seq_tick_offset_);	// see Population::AddSubpopulationSplit() regarding tree_seq_tick_offset_
+	tsk_node_table_t &shared_node_table = treeseq_[0].tables_.nodes;
+	
+	treeseq_buffer_base_node_ = (tsk_id_t)shared_node_table.num_rows;
+	treeseq_buffer_base_pedigree_id_ = p_base_pedigree_id;
+	treeseq_buffer_individual_count_ = p_individual_count;
+	
+	for (slim_popsize_t individual_index = 0; individual_index < p_individual_count; ++individual_index)
+	{
+		tsk_id_t ret = tsk_node_table_add_row(&shared_node_table, TSK_NODE_IS_SAMPLE, time, TSK_NULL, TSK_NULL, (char *)hap_metadata_1F_, (tsk_size_t)haplosome_metadata_size_);
+		if (ret < 0) handle_error("tsk_node_table_add_row", ret);
+		
+		ret = tsk_node_table_add_row(&shared_node_table, TSK_NODE_IS_SAMPLE, time, TSK_NULL, TSK_NULL, (char *)hap_metadata_2F_, (tsk_size_t)haplosome_metadata_size_);
+		if (ret < 0) handle_error("tsk_node_table_add_row", ret);
+	}
+	
+	// make sure there is an (empty) buffer for each thread and chromosome; the buffers keep their capacity between uses
+	size_t buffer_count = (size_t)gEidosMaxThreads * chromosomes_.size();
+	
+	if (treeseq_thread_buffers_.size() < buffer_count)
+		treeseq_thread_buffers_.resize(buffer_count);
+	
+	treeseq_buffering_ = true;
+}
+
+void Species::EndParallelTreeSeqRecording(void)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Species::EndParallelTreeSeqRecording(): illegal when parallel");
+	
+#if DEBUG
+	if (!treeseq_buffering_)
+		EIDOS_TERMINATION << "ERROR (Species::EndParallelTreeSeqRecording): (internal error) parallel recording is not in progress." << EidosTerminate();
+#endif
+	
+	treeseq_buffering_ = false;
+	
+	// Append the buffered edges and derived states to the tables.  Within each thread's buffer, the records for each new
+	// haplosome are in the order they were recorded, and each haplosome was recorded by a single thread; so a stable
+	// counting sort on the new haplosome's node id, visiting the threads in order, reproduces the order in which a
+	// single-threaded run would have recorded them, regardless of how the work was scheduled across threads.
+	size_t chromosome_count = chromosomes_.size();
+	size_t buffer_count = treeseq_thread_buffers_.size();
+	size_t node_count = 2 * (size_t)treeseq_buffer_individual_count_;
+	double time = -(double) (community_.tree_seq_tick_ + community_.tree_seq_tick_offset_);	// see Population::AddSubpopulationSplit() regarding tree_seq_tick_offset_
+	std::vector<size_t> node_cursors(node_count + 1);
+	std::vector<const TreeSeqEdgeRec *> ordered_edges;
+	std::vector<std::pair<const TreeSeqThreadBuffer *, const TreeSeqDerivedStateRec *>> ordered_states;
+	
+	for (size_t chromosome_index = 0; chromosome_index < chromosome_count; ++chromosome_index)
+	{
+		TreeSeqInfo &tsinfo = treeseq_[chromosome_index];
+		
+		// edges: count the edges for each node, convert the counts to starting positions, and scatter
+		std::fill(node_cursors.begin(), node_cursors.end(), 0);
+		
+		for (size_t buffer_index = chromosome_index; buffer_index < buffer_count; buffer_index += chromosome_count)
+			for (const TreeSeqEdgeRec &edge : treeseq_thread_buffers_[buffer_index].edges_)
+				node_cursors[edge.child_ - treeseq_buffer_base_node_ + 1]++;
+		
+		for (size_t node_index = 1; node_index <= node_count; ++node_index)
+			node_cursors[node_index] += node_cursors[node_index - 1];
+		
+		ordered_edges.resize(node_cursors[node_count]);
+		
+		for (size_t buffer_index = chromosome_index; buffer_index < buffer_count; buffer_index += chromosome_count)
+			for (const TreeSeqEdgeRec &edge : treeseq_thread_buffers_[buffer_index].edges_)
+				ordered_edges[node_cursors[edge.child_ - treeseq_buffer_base_node_]++] = &edge;
+		
+		for (const TreeSeqEdgeRec *edge : ordered_edges)
+		{
+			int ret = tsk_edge_table_add_row(&tsinfo.tables_.edges, edge->left_, edge->right_, edge->parent_, edge->child_, NULL, 0);
+			if (ret < 0) handle_error("tsk_edge_table_add_row", ret);
+		}
+		
+		// derived states: the same counting sort, and then a site table row and a mutation table row for each
+		std::fill(node_cursors.begin(), node_cursors.end(), 0);
+		
+		for (size_t buffer_index = chromosome_index; buffer_index < buffer_count; buffer_index += chromosome_count)
+			for (const TreeSeqDerivedStateRec &state : treeseq_thread_buffers_[buffer_index].derived_states_)
+				node_cursors[state.node_ - treeseq_buffer_base_node_ + 1]++;
+		
+		for (size_t node_index = 1; node_index <= node_count; ++node_index)
+			node_cursors[node_index] += node_cursors[node_index - 1];
+		
+		ordered_states.resize(node_cursors[node_count]);
+		
+		for (size_t buffer_index = chromosome_index; buffer_index < buffer_count; buffer_index += chromosome_count)
+		{
+			const TreeSeqThreadBuffer &thread_buffer = treeseq_thread_buffers_[buffer_index];
+			
+			for (const TreeSeqDerivedStateRec &state : thread_buffer.derived_states_)
+				ordered_states[node_cursors[state.node_ - treeseq_buffer_base_node_]++] = std::make_pair(&thread_buffer, &state);
+		}
+		
+		for (auto &buffer_and_state : ordered_states)
+		{
+			const TreeSeqThreadBuffer &thread_buffer = *buffer_and_state.first;
+			const TreeSeqDerivedStateRec &state = *buffer_and_state.second;
+			
+			tsk_id_t site_id = tsk_site_table_add_row(&tsinfo.tables_.sites, (double)state.position_, NULL, 0, NULL, 0);
+			if (site_id < 0) handle_error("tsk_site_table_add_row", site_id);
+			
+			const char *derived_muts_bytes = (const char *)(thread_buffer.derived_state_ids_.data() + state.state_start_);
+			size_t derived_state_length = state.state_length_ * sizeof(slim_mutationid_t);
+			const char *mutation_metadata_bytes = (const char *)(thread_buffer.derived_state_metadata_.data() + state.state_start_);
+			size_t mutation_metadata_length = state.state_length_ * sizeof(MutationMetadataRec);
+			
+			int ret = tsk_mutation_table_add_row(&tsinfo.tables_.mutations, site_id, state.node_, TSK_NULL,
+							time,
+							derived_muts_bytes, (tsk_size_t)derived_state_length,
+							mutation_metadata_bytes, (tsk_size_t)mutation_metadata_length);
+			if (ret < 0) handle_error("tsk_mutation_table_add_row", ret);
+		}
+	}
+	
+	for (TreeSeqThreadBuffer &thread_buffer : treeseq_thread_buffers_)
+	{
+		thread_buffer.edges_.clear();
+		thread_buffer.derived_states_.clear();
+		thread_buffer.derived_state_ids_.clear();
+		thread_buffer.derived_state_metadata_.clear();
+	}
+}
+
 void Species::CheckAutoSimplification(void)
 {
 #if DEBUG
@@ -9822,7 +10186,7 @@ void Species::__AddMutationsFromTreeSequenceToHaplosomes(std::unordered_map<slim
 						EIDOS_TERMINATION << "ERROR (Species::__AddMutationsFromTreeSequenceToHaplosomes): (internal error) null haplosome has non-zero treeseq allele length " << haplosome_allele_length << "." << EidosTerminate();
 					
 					slim_mutationid_t *haplosome_allele = (slim_mutationid_t *)variant->alleles[haplosome_variant];
-					slim_mutrun_index_t run_index = (slim_mutrun_index_t)(variant_pos_int / haplosome->mutrun_length_);
+					slim_mutrun_index_t run_index = haplosome->mutrun_layout_->RunIndexForPosition(variant_pos_int);
 					
 #ifdef _OPENMP
 					// When parallel, the MutationRunContext depends upon the position in the haplosome
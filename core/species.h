@@ -237,6 +237,9 @@ private:
 	// preventing incidental selfing in hermaphroditic models
 	bool prevent_incidental_selfing_ = false;
 	
+	// compressed (bit-packed) storage for long mutation runs; see MutationRun::PackMutations()
+	bool compress_mutation_runs_ = false;
+	
 	// mutation run timing experiment configuration
 	bool do_mutrun_experiments_ = true;				// user-level flag in initializeSLiMOptions(); if false, experiments are never run
 	bool doing_any_mutrun_experiments_ = false;		// is any chromosome actually running mutation run timing experiments?
@@ -340,6 +343,34 @@ private:
 	std::vector<TreeSeqInfo> treeseq_;				// OWNED; all our tree-sequence state, in the order the chromosomes were defined
 													// index 0's table collection contains the shared tables; see CopySharedTablesIn()
 	
+	// ********** buffers used while new individuals are recorded from inside a parallel region; see BeginParallelTreeSeqRecording()
+	// Each thread appends edges and derived states for the haplosomes it generates to its own buffer for each chromosome, instead of
+	// to the shared tables; EndParallelTreeSeqRecording() then appends them to the tables in the order of the offspring node ids,
+	// which is the order a single-threaded run would have recorded them in.  The node table rows are reserved up front.
+	typedef struct _TreeSeqEdgeRec {
+		double left_, right_;
+		tsk_id_t parent_, child_;
+	} TreeSeqEdgeRec;
+	
+	typedef struct _TreeSeqDerivedStateRec {
+		tsk_id_t node_;
+		slim_position_t position_;
+		size_t state_start_, state_length_;		// the range of derived_state_ids_ and derived_state_metadata_ used by the derived state
+	} TreeSeqDerivedStateRec;
+	
+	typedef struct _TreeSeqThreadBuffer {
+		std::vector<TreeSeqEdgeRec> edges_;
+		std::vector<TreeSeqDerivedStateRec> derived_states_;
+		std::vector<slim_mutationid_t> derived_state_ids_;
+		std::vector<MutationMetadataRec> derived_state_metadata_;
+	} TreeSeqThreadBuffer;
+	
+	bool treeseq_buffering_ = false;						// true between BeginParallelTreeSeqRecording() and EndParallelTreeSeqRecording()
+	tsk_id_t treeseq_buffer_base_node_ = 0;					// the node id reserved for the first haplosome of the first buffered individual
+	slim_pedigreeid_t treeseq_buffer_base_pedigree_id_ = 0;	// the pedigree id of the first buffered individual
+	slim_popsize_t treeseq_buffer_individual_count_ = 0;	// the number of individuals, with consecutive pedigree ids, reserved for
+	std::vector<TreeSeqThreadBuffer> treeseq_thread_buffers_;	// indexed by (thread number * chromosome count + chromosome index)
+	
 public:
 	
 	// Object pools for individuals and haplosomes, kept population-wide; these must be above their clients in the declaration order
@@ -394,6 +425,18 @@ public:
 	std::vector<int32_t> profile_nonneutral_regime_history_;						// a record of the nonneutral regime used in each cycle
 	int64_t profile_max_mutation_index_;											// the largest mutation index seen over the course of the profile
 #endif	// SLIM_USE_NONNEUTRAL_CACHES
+	
+	// tree-sequence simplification metrics; the per-chromosome time is summed across chromosomes (and thus across threads),
+	// so its ratio to the wall time spent simplifying chromosomes is the effective speedup from simplifying them in parallel
+	int64_t profile_simplify_count_ = 0;											// the number of times SimplifyAllTreeSequences() simplified
+	eidos_profile_t profile_simplify_wall_time_ = 0;								// wall clock time spent in the per-chromosome simplification phase
+	eidos_profile_t profile_simplify_chromosome_time_ = 0;							// per-chromosome simplification time, summed over chromosomes
+	
+	// lost/fixed mutation removal metrics, from Population::RemoveAllFixedMutations()
+	eidos_profile_t profile_fixation_time_ = 0;										// time spent removing lost and fixed mutations, in all cycles
+	int64_t profile_fixation_cycle_count_ = 0;										// the number of cycles in which fixed mutations were substituted
+	int64_t profile_fixation_substitution_count_ = 0;								// the number of Substitution objects created for fixed mutations
+	int64_t profile_fixation_mutrun_count_ = 0;										// the number of distinct mutation runs fixed mutations were removed from
 #endif	// (SLIMPROFILING == 1)
 	
 	Species(const Species&) = delete;																	// no copying
@@ -552,6 +595,8 @@ public:
 	void RecordNewHaplosome_NULL(Haplosome *p_new_haplosome);
 	void RecordNewDerivedState(const Haplosome *p_haplosome, slim_position_t p_position, const std::vector<Mutation *> &p_derived_mutations);
 	void RetractNewIndividual(void);
+	void BeginParallelTreeSeqRecording(slim_pedigreeid_t p_base_pedigree_id, slim_popsize_t p_individual_count);
+	void EndParallelTreeSeqRecording(void);
 	void AddIndividualsToTable(Individual * const *p_individual, size_t p_num_individuals, tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash, tsk_flags_t p_flags);
 	void AddLiveIndividualsToIndividualsTable(tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash);
 	void FixAliveIndividuals(tsk_table_collection_t *p_tables);
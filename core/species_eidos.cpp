@@ -1285,7 +1285,7 @@ EidosValue_SP Species::ExecuteContextFunction_initializeSex(const std::string &p
 	return gStaticEidosValueVOID;
 }
 
-//	*********************	(void)initializeSLiMOptions([logical$ keepPedigrees = F], [string$ dimensionality = ""], [string$ periodicity = ""], [logical$ doMutationRunExperiments = T], [logical$ preventIncidentalSelfing = F], [logical$ nucleotideBased = F], [logical$ randomizeCallbacks = T], [logical$ checkInfiniteLoops = T])
+//	*********************	(void)initializeSLiMOptions([logical$ keepPedigrees = F], [string$ dimensionality = ""], [string$ periodicity = ""], [logical$ doMutationRunExperiments = T], [logical$ preventIncidentalSelfing = F], [logical$ nucleotideBased = F], [logical$ randomizeCallbacks = T], [logical$ checkInfiniteLoops = T], [logical$ compressMutationRuns = F])
 //
 EidosValue_SP Species::ExecuteContextFunction_initializeSLiMOptions(const std::string &p_function_name, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
@@ -1300,6 +1300,7 @@ EidosValue_SP Species::ExecuteContextFunction_initializeSLiMOptions(const std::s
 #ifdef SLIMGUI
 	EidosValue *arg_checkInfiniteLoops_value = p_arguments[7].get();	// this exists outside SLiMgui, but we don't use it
 #endif
+	EidosValue *arg_compressMutationRuns_value = p_arguments[8].get();
 	std::ostream &output_stream = p_interpreter.ExecutionOutputStream();
 	
 	if (num_slimoptions_inits_ > 0)
@@ -1428,6 +1429,13 @@ EidosValue_SP Species::ExecuteContextFunction_initializeSLiMOptions(const std::s
 #endif
 	}
 	
+	{
+		// [logical$ compressMutationRuns = F]
+		bool compress_mutation_runs = arg_compressMutationRuns_value->LogicalAtIndex_NOCAST(0, nullptr);
+		
+		compress_mutation_runs_ = compress_mutation_runs;
+	}
+	
 	if (SLiM_verbosity_level >= 1)
 	{
 		output_stream << "initializeSLiMOptions(";
@@ -1485,6 +1493,13 @@ EidosValue_SP Species::ExecuteContextFunction_initializeSLiMOptions(const std::s
 			if (previous_params) output_stream << ", ";
 			output_stream << "randomizeCallbacks = " << (shuffle_buf_is_enabled_ ? "T" : "F");
 			previous_params = true;
+		}
+		
+		if (compress_mutation_runs_)
+		{
+			if (previous_params) output_stream << ", ";
+			output_stream << "compressMutationRuns = " << (compress_mutation_runs_ ? "T" : "F");
+			previous_params = true;
 			(void)previous_params;	// dead store above is deliberate
 		}
 		
@@ -29,6 +29,7 @@
 #include "eidos_ast_node.h"
 #include "eidos_globals.h"
 #include "eidos_class_Image.h"
+#include "slim_native_callback.h"
 
 #include <iostream>
 #include <fstream>
@@ -38,6 +39,7 @@
 #include <map>
 #include <utility>
 #include <cmath>
+#include <memory>
 
 
 #pragma mark -
@@ -431,12 +433,13 @@ void Subpopulation::CheckIndividualIntegrity(void)
 	for (Chromosome *chromosome : chromosomes)
 	{
 		int32_t mutrun_count = chromosome->mutrun_count_;
-		slim_position_t mutrun_length = chromosome->mutrun_length_;
 		
-		if (has_genetics && ((mutrun_count == 0) || (mutrun_length == 0)))
-			EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) species with genetics has mutrun count/length of 0." << EidosTerminate();
-		else if (!has_genetics && ((mutrun_count != 0) || (mutrun_length != 0)))
-			EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) species with no genetics has non-zero mutrun count/length." << EidosTerminate();
+		if (has_genetics && (mutrun_count == 0))
+			EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) species with genetics has mutrun count of 0." << EidosTerminate();
+		else if (!has_genetics && (mutrun_count != 0))
+			EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) species with no genetics has non-zero mutrun count." << EidosTerminate();
+		else if (has_genetics && (chromosome->mutrun_layout_.run_count_ != mutrun_count))
+			EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) mutrun layout does not match the mutrun count." << EidosTerminate();
 	}
 	
 #if DEBUG_LESS_INTENSIVE
@@ -533,10 +536,10 @@ void Subpopulation::CheckIndividualIntegrity(void)
 				if (!haplosome1->IsNull())
 				{
 					slim_position_t mutrun_count = chromosome->mutrun_count_;
-					slim_position_t mutrun_length = chromosome->mutrun_length_;
+					const MutationRunLayout *mutrun_layout = &chromosome->mutrun_layout_;
 					
-					if ((haplosome1->mutrun_count_ != mutrun_count) || (haplosome1->mutrun_length_ != mutrun_length))
-						EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome1 of individual has the wrong mutrun count/length." << EidosTerminate();
+					if ((haplosome1->mutrun_count_ != mutrun_count) || (haplosome1->mutrun_layout_ != mutrun_layout))
+						EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome1 of individual has the wrong mutrun count/layout." << EidosTerminate();
 					
 					// check that every mutation in the haplosome belongs to the right chromosome
 					for (int run_index = 0; run_index < mutrun_count; ++run_index)
@@ -555,9 +558,9 @@ void Subpopulation::CheckIndividualIntegrity(void)
 					}
 				}
 				
-				if (((haplosome1->mutrun_count_ == 0) && ((haplosome1->mutrun_length_ != 0) || (haplosome1->mutruns_ != nullptr))) ||
-					((haplosome1->mutrun_length_ == 0) && ((haplosome1->mutrun_count_ != 0) || (haplosome1->mutruns_ != nullptr))))
-					EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome1 mutrun count/length/pointer inconsistency." << EidosTerminate();
+				if (((haplosome1->mutrun_count_ == 0) && ((haplosome1->mutrun_layout_ != nullptr) || (haplosome1->mutruns_ != nullptr))) ||
+					((haplosome1->mutrun_layout_ == nullptr) && ((haplosome1->mutrun_count_ != 0) || (haplosome1->mutruns_ != nullptr))))
+					EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome1 mutrun count/layout/pointer inconsistency." << EidosTerminate();
 				
 				if (species_.PedigreesEnabled())
 				{
@@ -658,10 +661,10 @@ void Subpopulation::CheckIndividualIntegrity(void)
 				if (!haplosome2->IsNull())
 				{
 					slim_position_t mutrun_count = chromosome->mutrun_count_;
-					slim_position_t mutrun_length = chromosome->mutrun_length_;
+					const MutationRunLayout *mutrun_layout = &chromosome->mutrun_layout_;
 					
-					if ((haplosome2->mutrun_count_ != mutrun_count) || (haplosome2->mutrun_length_ != mutrun_length))
-						EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome2 of individual has the wrong mutrun count/length." << EidosTerminate();
+					if ((haplosome2->mutrun_count_ != mutrun_count) || (haplosome2->mutrun_layout_ != mutrun_layout))
+						EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome2 of individual has the wrong mutrun count/layout." << EidosTerminate();
 					
 					// check that every mutation in the haplosome belongs to the right chromosome
 					for (int run_index = 0; run_index < mutrun_count; ++run_index)
@@ -680,9 +683,9 @@ void Subpopulation::CheckIndividualIntegrity(void)
 					}
 				}
 				
-				if (((haplosome2->mutrun_count_ == 0) && ((haplosome2->mutrun_length_ != 0) || (haplosome2->mutruns_ != nullptr))) ||
-					((haplosome2->mutrun_length_ == 0) && ((haplosome2->mutrun_count_ != 0) || (haplosome2->mutruns_ != nullptr))))
-					EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome2 mutrun count/length/pointer inconsistency." << EidosTerminate();
+				if (((haplosome2->mutrun_count_ == 0) && ((haplosome2->mutrun_layout_ != nullptr) || (haplosome2->mutruns_ != nullptr))) ||
+					((haplosome2->mutrun_layout_ == nullptr) && ((haplosome2->mutrun_count_ != 0) || (haplosome2->mutruns_ != nullptr))))
+					EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome2 mutrun count/layout/pointer inconsistency." << EidosTerminate();
 				
 				if (species_.PedigreesEnabled())
 				{
@@ -846,18 +849,18 @@ void Subpopulation::CheckIndividualIntegrity(void)
 					if (!haplosome1->IsNull())
 					{
 						slim_position_t mutrun_count = chromosome->mutrun_count_;
-						slim_position_t mutrun_length = chromosome->mutrun_length_;
+						const MutationRunLayout *mutrun_layout = &chromosome->mutrun_layout_;
 						
-						if ((haplosome1->mutrun_count_ != mutrun_count) || (haplosome1->mutrun_length_ != mutrun_length))
-							EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome1 of individual has the wrong mutrun count/length." << EidosTerminate();
+						if ((haplosome1->mutrun_count_ != mutrun_count) || (haplosome1->mutrun_layout_ != mutrun_layout))
+							EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome1 of individual has the wrong mutrun count/layout." << EidosTerminate();
 						
 						// do not check haplosomes in the child generation; they are conceptually cleared to
 						// nullptr (but can actually even contain garbage, unless SLIM_CLEAR_HAPLOSOMES is set
 					}
 					
-					if (((haplosome1->mutrun_count_ == 0) && ((haplosome1->mutrun_length_ != 0) || (haplosome1->mutruns_ != nullptr))) ||
-						((haplosome1->mutrun_length_ == 0) && ((haplosome1->mutrun_count_ != 0) || (haplosome1->mutruns_ != nullptr))))
-						EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome1 mutrun count/length/pointer inconsistency." << EidosTerminate();
+					if (((haplosome1->mutrun_count_ == 0) && ((haplosome1->mutrun_layout_ != nullptr) || (haplosome1->mutruns_ != nullptr))) ||
+						((haplosome1->mutrun_layout_ == nullptr) && ((haplosome1->mutrun_count_ != 0) || (haplosome1->mutruns_ != nullptr))))
+						EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome1 mutrun count/layout/pointer inconsistency." << EidosTerminate();
 					
 					// we don't check pedigree IDs for the child generation; they are not expected to be set up
 					
@@ -954,18 +957,18 @@ void Subpopulation::CheckIndividualIntegrity(void)
 					if (!haplosome2->IsNull())
 					{
 						slim_position_t mutrun_count = chromosome->mutrun_count_;
-						slim_position_t mutrun_length = chromosome->mutrun_length_;
+						const MutationRunLayout *mutrun_layout = &chromosome->mutrun_layout_;
 						
-						if ((haplosome2->mutrun_count_ != mutrun_count) || (haplosome2->mutrun_length_ != mutrun_length))
-							EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome2 of individual has the wrong mutrun count/length." << EidosTerminate();
+						if ((haplosome2->mutrun_count_ != mutrun_count) || (haplosome2->mutrun_layout_ != mutrun_layout))
+							EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome2 of individual has the wrong mutrun count/layout." << EidosTerminate();
 						
 						// do not check haplosomes in the child generation; they are conceptually cleared to
 						// nullptr (but can actually even contain garbage, unless SLIM_CLEAR_HAPLOSOMES is set
 					}
 					
-					if (((haplosome2->mutrun_count_ == 0) && ((haplosome2->mutrun_length_ != 0) || (haplosome2->mutruns_ != nullptr))) ||
-						((haplosome2->mutrun_length_ == 0) && ((haplosome2->mutrun_count_ != 0) || (haplosome2->mutruns_ != nullptr))))
-						EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome2 mutrun count/length/pointer inconsistency." << EidosTerminate();
+					if (((haplosome2->mutrun_count_ == 0) && ((haplosome2->mutrun_layout_ != nullptr) || (haplosome2->mutruns_ != nullptr))) ||
+						((haplosome2->mutrun_layout_ == nullptr) && ((haplosome2->mutrun_count_ != 0) || (haplosome2->mutruns_ != nullptr))))
+						EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) haplosome2 mutrun count/layout/pointer inconsistency." << EidosTerminate();
 					
 					// we don't check pedigree IDs for the child generation; they are not expected to be set up
 					
@@ -1378,6 +1381,11 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 {
 	const std::map<slim_objectid_t,MutationType*> &mut_types = species_.MutationTypes();
 	
+	// If our chromosomal fitness values were precomputed for us, we use them for this call only
+	bool chromosomal_fitness_precomputed = chromosomal_fitness_precomputed_;
+	
+	chromosomal_fitness_precomputed_ = false;
+	
 	// The FitnessOfParent...() methods called by this method rely upon cached fitness values
 	// kept inside the Mutation objects.  Those caches may need to be validated before we can
 	// calculate fitness values.  We check for that condition and repair it first.
@@ -1635,6 +1643,35 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 		}
 	}
 	
+	// if Population::PrecomputeChromosomalFitness() already did the work, in parallel across subpopulations and chromosomes, just
+	// fetch the results; it does so only when no callbacks are active and no mutrun experiments are running, so this is safe
+	if (chromosomal_fitness_precomputed)
+		FitnessOfParent_TEMPLATED = &Subpopulation::FitnessOfParent_Precomputed;
+	
+	// if any active mutationEffect() callback is vectorized, run the vectorized callbacks now, once each for the whole subpopulation;
+	// the fitness loops below then get their results back through ApplyMutationEffectCallbacks()
+	bool vectorized_mutationEffect_callbacks = false;
+	
+	if (mutationEffect_callbacks_exist && !skip_chromosomal_fitness)
+	{
+		for (SLiMEidosBlock *mutationEffect_callback : p_mutationEffect_callbacks)
+			if (mutationEffect_callback->block_active_ && mutationEffect_callback->vectorized_)
+			{
+				vectorized_mutationEffect_callbacks = true;
+				break;
+			}
+	}
+	
+	if (vectorized_mutationEffect_callbacks)
+		RunVectorizedMutationEffectCallbacks(p_mutationEffect_callbacks, FitnessOfParent_TEMPLATED);
+	
+	// if every active fitnessEffect() callback is constant or compiled to native code, evaluate them all now, across the whole
+	// subpopulation at once; the fitness loops below then get their results back through ApplyFitnessEffectCallbacks()
+	fitnessEffect_precomputed_ = false;
+	
+	if (fitnessEffect_callbacks_exist)
+		PrecomputeFitnessEffectCallbacks(p_mutationEffect_callbacks, p_fitnessEffect_callbacks);
+	
 	// Mutrun experiment timing can be per-individual, per-chromosome, but that entails a lot of timing overhead.
 	// To avoid that overhead, in single-chromosome models we just time across the whole round of fitness evals
 	// instead.  Note that in this case we chose a template above for FitnessOfParent() that does not time.
@@ -1763,12 +1800,13 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					// because all the correct caches need to get flushed to everyone
 					// before beginning fitness evaluation, for efficiency
 					// beginend_nonneutral_pointers() handles the non-parallel case
-					FixNonNeutralCaches_OMP();
+					if (!chromosomal_fitness_precomputed)
+						FixNonNeutralCaches_OMP();
 #endif
 					
 					EIDOS_BENCHMARK_START(EidosBenchmarkType::k_FITNESS_SEX_3);
 					EIDOS_THREAD_COUNT(gEidos_OMP_threads_FITNESS_SEX_3);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(parent_first_male_index_, subpop_fitness_scaling) reduction(+: totalFemaleFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_3) num_threads(thread_count)
+#pragma omp parallel for schedule(runtime) default(none) shared(parent_first_male_index_, subpop_fitness_scaling) reduction(+: totalFemaleFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_3) num_threads(thread_count)
 					for (slim_popsize_t female_index = 0; female_index < parent_first_male_index_; female_index++)
 					{
 						double fitness = parent_individuals_[female_index]->fitness_scaling_;
@@ -1981,7 +2019,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					// note that we rely on the fixup of non-neutral caches done above
 					EIDOS_BENCHMARK_START(EidosBenchmarkType::k_FITNESS_SEX_3);
 					EIDOS_THREAD_COUNT(gEidos_OMP_threads_FITNESS_SEX_3);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(parent_first_male_index_, parent_subpop_size_, subpop_fitness_scaling) reduction(+: totalMaleFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_3) num_threads(thread_count)
+#pragma omp parallel for schedule(runtime) default(none) shared(parent_first_male_index_, parent_subpop_size_, subpop_fitness_scaling) reduction(+: totalMaleFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_3) num_threads(thread_count)
 					for (slim_popsize_t male_index = parent_first_male_index_; male_index < parent_subpop_size_; male_index++)
 					{
 						double fitness = parent_individuals_[male_index]->fitness_scaling_;
@@ -2205,12 +2243,13 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					// because all the correct caches need to get flushed to everyone
 					// before beginning fitness evaluation, for efficiency
 					// beginend_nonneutral_pointers() handles the non-parallel case
-					FixNonNeutralCaches_OMP();
+					if (!chromosomal_fitness_precomputed)
+						FixNonNeutralCaches_OMP();
 #endif
 					
 					EIDOS_BENCHMARK_START(EidosBenchmarkType::k_FITNESS_ASEX_3);
 					EIDOS_THREAD_COUNT(gEidos_OMP_threads_FITNESS_ASEX_3);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(parent_subpop_size_, subpop_fitness_scaling) reduction(+: totalFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_ASEX_3) num_threads(thread_count)
+#pragma omp parallel for schedule(runtime) default(none) shared(parent_subpop_size_, subpop_fitness_scaling) reduction(+: totalFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_ASEX_3) num_threads(thread_count)
 					for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; individual_index++)
 					{
 						double fitness = parent_individuals_[individual_index]->fitness_scaling_;
@@ -2317,6 +2356,11 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 		}
 	}
 	
+	if (vectorized_mutationEffect_callbacks)
+		EndVectorizedMutationEffectCallbacks();
+	
+	fitnessEffect_precomputed_ = false;
+	
 	// Mutrun experiment timing can be per-individual, per-chromosome, but that entails a lot of timing overhead.
 	// To avoid that overhead, in single-chromosome models we just time across the whole round of fitness evals
 	// instead.  Note that in this case we chose a template above for FitnessOfParent() that does not time.
@@ -2455,7 +2499,54 @@ double Subpopulation::ApplyMutationEffectCallbacks(MutationIndex p_mutation, int
 	SLIM_PROFILE_BLOCK_START();
 #endif
 	
-	slim_objectid_t mutation_type_id = (gSLiM_Mutation_Block + p_mutation)->mutation_type_ptr_->mutation_type_id_;
+	MutationType *mutation_type = (gSLiM_Mutation_Block + p_mutation)->mutation_type_ptr_;
+	slim_objectid_t mutation_type_id = mutation_type->mutation_type_id_;
+	
+	// With vectorized mutationEffect() callbacks, the recording pass records calls for the mutation types they govern and executes nothing,
+	// and the replaying pass answers those calls from the results of the vectorized callbacks; see RunVectorizedMutationEffectCallbacks()
+	if (vectorized_mutationEffect_mode_ && ((vectorized_mutationEffect_mode_ == 1) || mutation_type->vectorized_mutationEffect_now_))
+	{
+		if (vectorized_mutationEffect_mode_ == 1)
+		{
+			if (mutation_type->vectorized_mutationEffect_now_)
+			{
+				if (p_individual != vectorized_cursor_individual_)
+				{
+					vectorized_cursor_individual_ = p_individual;
+					vectorized_individual_start_[p_individual->index_] = vectorized_mutations_.size();
+				}
+				
+				vectorized_mutations_.emplace_back(p_mutation);
+				vectorized_homozygous_.emplace_back((int8_t)p_homozygous);
+				vectorized_effects_.emplace_back(p_computed_fitness);
+				vectorized_individuals_.emplace_back(p_individual);
+			}
+			
+			// the fitness values calculated by the recording pass are discarded; we just need to avoid hitting zero early
+			p_computed_fitness = 1.0;
+		}
+		else
+		{
+			if (p_individual != vectorized_cursor_individual_)
+			{
+				vectorized_cursor_individual_ = p_individual;
+				vectorized_cursor_ = vectorized_individual_start_[p_individual->index_];
+			}
+			
+			// the replaying pass visits the same calls in the same order, unless a callback changed the individuals or mutations involved
+			if ((vectorized_cursor_ >= vectorized_mutations_.size()) || (vectorized_individuals_[vectorized_cursor_] != p_individual) || (vectorized_mutations_[vectorized_cursor_] != p_mutation))
+				EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyMutationEffectCallbacks): a mutation effect was requested that was not provided to vectorized mutationEffect() callbacks; callbacks may not change fitnessScaling or the mutations of individuals during fitness calculation." << EidosTerminate();
+			
+			p_computed_fitness = vectorized_effects_[vectorized_cursor_++];
+		}
+		
+#if (SLIMPROFILING == 1)
+		// PROFILING
+		SLIM_PROFILE_BLOCK_END(community_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosMutationEffectCallback)]);
+#endif
+		
+		return p_computed_fitness;
+	}
 	
 	for (SLiMEidosBlock *mutationEffect_callback : p_mutationEffect_callbacks)
 	{
@@ -2519,21 +2610,9 @@ double Subpopulation::ApplyMutationEffectCallbacks(MutationIndex p_mutation, int
 				}
 				else if (mutationEffect_callback->has_cached_optimization_)
 				{
-					// We can special-case particular simple callbacks for speed.  This is similar to the cached_return_value_
-					// mechanism above, but it is done in SLiM, not in Eidos, and is specific to callbacks, not general.
-					// The has_cached_optimization_ flag is the umbrella flag for all such optimizations; we then figure
-					// out below which cached optimization is in effect for this callback.  See Community::OptimizeScriptBlock()
-					// for comments on the specific cases optimized here.
-					if (mutationEffect_callback->has_cached_opt_reciprocal)
-					{
-						double A = mutationEffect_callback->cached_opt_A_;
-						
-						p_computed_fitness = (A / p_computed_fitness);	// p_computed_fitness is effect
-					}
-					else
-					{
-						EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyMutationEffectCallbacks): (internal error) cached optimization flag mismatch" << EidosTerminate(mutationEffect_callback->identifier_token_);
-					}
+					// The callback was compiled to native code by Community::OptimizeScriptBlock(), so we can evaluate it without
+					// the interpreter.  This is similar to the cached_return_value_ mechanism above, but specific to callbacks.
+					p_computed_fitness = mutationEffect_callback->native_callback_->Evaluate(p_individual, p_computed_fitness);	// p_computed_fitness is effect
 				}
 				else
 				{
@@ -2621,8 +2700,415 @@ double Subpopulation::ApplyMutationEffectCallbacks(MutationIndex p_mutation, int
 	return p_computed_fitness;
 }
 
+// Vectorized mutationEffect() callbacks are called once per tick in each subpopulation, with vectors of all of the mutations they govern
+// in all individuals, rather than once per individual per mutation, to avoid the overhead of entering the interpreter for each call.  To
+// find the calls that would have been made, we make a recording pass over the individuals with the regular fitness code, in which
+// ApplyMutationEffectCallbacks() records each call for a mutation type governed by vectorized callbacks instead of executing anything.
+// Each vectorized callback is then executed once, on the recorded calls for its mutation type, and UpdateFitness() goes on to make its
+// usual pass, in which ApplyMutationEffectCallbacks() answers those calls with the effects returned.  This keeps the determination of
+// homozygosity and the combination of effects in one place.  Vectorized and non-vectorized callbacks cannot govern the same mutation
+// type, since the non-vectorized callbacks would then need to run in the recording pass to produce the effects passed along.
+void Subpopulation::RunVectorizedMutationEffectCallbacks(std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks, double (Subpopulation::*p_FitnessOfParent)(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks))
+{
+	const std::map<slim_objectid_t,MutationType*> &mut_types = species_.MutationTypes();
+	
+	// flag the mutation types governed by active vectorized callbacks
+	for (SLiMEidosBlock *mutationEffect_callback : p_mutationEffect_callbacks)
+	{
+		if (mutationEffect_callback->block_active_ && mutationEffect_callback->vectorized_)
+		{
+			slim_objectid_t mutation_type_id = mutationEffect_callback->mutation_type_id_;
+			
+			if (mutation_type_id == -1)
+			{
+				for (auto &mut_type_iter : mut_types)
+					mut_type_iter.second->vectorized_mutationEffect_now_ = true;
+			}
+			else
+			{
+				MutationType *found_muttype = species_.MutationTypeWithID(mutation_type_id);
+				
+				if (found_muttype)
+					found_muttype->vectorized_mutationEffect_now_ = true;
+			}
+		}
+	}
+	
+	// check that no active non-vectorized callback governs any of those mutation types
+	for (SLiMEidosBlock *mutationEffect_callback : p_mutationEffect_callbacks)
+	{
+		if (mutationEffect_callback->block_active_ && !mutationEffect_callback->vectorized_)
+		{
+			slim_objectid_t mutation_type_id = mutationEffect_callback->mutation_type_id_;
+			bool conflict = false;
+			
+			if (mutation_type_id == -1)
+			{
+				for (auto &mut_type_iter : mut_types)
+					if (mut_type_iter.second->vectorized_mutationEffect_now_)
+						conflict = true;
+			}
+			else
+			{
+				MutationType *found_muttype = species_.MutationTypeWithID(mutation_type_id);
+				
+				if (found_muttype && found_muttype->vectorized_mutationEffect_now_)
+					conflict = true;
+			}
+			
+			if (conflict)
+			{
+				EndVectorizedMutationEffectCallbacks();
+				EIDOS_TERMINATION << "ERROR (Subpopulation::RunVectorizedMutationEffectCallbacks): vectorized and non-vectorized mutationEffect() callbacks cannot both be active for the same mutation type in the same subpopulation." << EidosTerminate(mutationEffect_callback->identifier_token_);
+			}
+		}
+	}
+	
+	// the recording pass; individuals with a fitnessScaling of zero or less are skipped, as in UpdateFitness()
+	vectorized_mutations_.clear();
+	vectorized_homozygous_.clear();
+	vectorized_effects_.clear();
+	vectorized_individuals_.clear();
+	vectorized_individual_start_.resize(parent_subpop_size_);
+	vectorized_cursor_individual_ = nullptr;
+	vectorized_mutationEffect_mode_ = 1;
+	
+	for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; individual_index++)
+	{
+		if (parent_individuals_[individual_index]->fitness_scaling_ > 0.0)
+			(void)(this->*p_FitnessOfParent)(individual_index, p_mutationEffect_callbacks);
+	}
+	
+	vectorized_mutationEffect_mode_ = 0;
+	
+	// execute each active vectorized callback on the calls recorded for its mutation type; callbacks governing the same mutation
+	// type are chained in order, each receiving the effects returned by the previous one, as with non-vectorized callbacks
+	std::vector<size_t> call_indices;
+	size_t call_count = vectorized_mutations_.size();
+	
+	for (SLiMEidosBlock *mutationEffect_callback : p_mutationEffect_callbacks)
+	{
+		if (mutationEffect_callback->block_active_ && mutationEffect_callback->vectorized_)
+		{
+			slim_objectid_t mutation_type_id = mutationEffect_callback->mutation_type_id_;
+			
+			call_indices.clear();
+			
+			for (size_t call_index = 0; call_index < call_count; ++call_index)
+				if ((mutation_type_id == -1) || ((gSLiM_Mutation_Block + vectorized_mutations_[call_index])->mutation_type_ptr_->mutation_type_id_ == mutation_type_id))
+					call_indices.emplace_back(call_index);
+			
+			if (call_indices.size())
+				ExecuteVectorizedMutationEffectCallback(mutationEffect_callback, call_indices);
+		}
+	}
+	
+	// set up for the replaying pass
+	vectorized_cursor_individual_ = nullptr;
+	vectorized_mutationEffect_mode_ = 2;
+}
+
+void Subpopulation::ExecuteVectorizedMutationEffectCallback(SLiMEidosBlock *p_mutationEffect_callback, std::vector<size_t> &p_call_indices)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Population::ExecuteVectorizedMutationEffectCallback(): running Eidos callback");
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_START();
+#endif
+	
+	size_t call_count = p_call_indices.size();
+	const EidosASTNode *compound_statement_node = p_mutationEffect_callback->compound_statement_node_;
+	
+#if DEBUG_POINTS_ENABLED
+	// SLiMgui debugging point
+	EidosDebugPointIndent indenter;
+	
+	{
+		EidosInterpreterDebugPointsSet *debug_points = community_.DebugPoints();
+		EidosToken *decl_token = p_mutationEffect_callback->root_node_->token_;
+		
+		if (debug_points && debug_points->set.size() && (decl_token->token_line_ != -1) &&
+			(debug_points->set.find(decl_token->token_line_) != debug_points->set.end()))
+		{
+			SLIM_ERRSTREAM << EidosDebugPointIndent::Indent() << "#DEBUG mutationEffect(m" << p_mutationEffect_callback->mutation_type_id_;
+			if (p_mutationEffect_callback->subpopulation_id_ != -1)
+				SLIM_ERRSTREAM << ", p" << p_mutationEffect_callback->subpopulation_id_;
+			SLIM_ERRSTREAM << ")";
+			
+			if (p_mutationEffect_callback->block_id_ != -1)
+				SLIM_ERRSTREAM << " s" << p_mutationEffect_callback->block_id_;
+			
+			SLIM_ERRSTREAM << " (line " << (decl_token->token_line_ + 1) << community_.DebugPointInfo() << ", vectorized over " << call_count << " mutations)" << std::endl;
+			indenter.indent();
+		}
+	}
+#endif
+	
+	if (compound_statement_node->cached_return_value_)
+	{
+		// The script is a constant expression such as "{ return 1.1; }", so we can short-circuit it completely
+		EidosValue *result = compound_statement_node->cached_return_value_.get();
+		
+		if ((result->Type() != EidosValueType::kValueFloat) || (result->Count() != 1))
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteVectorizedMutationEffectCallback): vectorized mutationEffect() callbacks must provide a float return value with one element per mutation, or a float singleton." << EidosTerminate(p_mutationEffect_callback->identifier_token_);
+		
+		double effect = result->FloatData()[0];
+		
+		for (size_t call_index : p_call_indices)
+			vectorized_effects_[call_index] = effect;
+	}
+	else if (p_mutationEffect_callback->has_cached_optimization_ && !p_mutationEffect_callback->native_callback_->HasTranscendentals() && ExecuteVectorizedNativeCallback(p_mutationEffect_callback, p_call_indices))
+	{
+		// The callback was compiled to native code, and evaluated across all of the calls by ExecuteVectorizedNativeCallback()
+	}
+	else
+	{
+		EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &community_.SymbolTable());
+		EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
+		EidosFunctionMap &function_map = community_.FunctionMap();
+		EidosInterpreter interpreter(p_mutationEffect_callback->compound_statement_node_, client_symbols, function_map, &community_, SLIM_OUTSTREAM, SLIM_ERRSTREAM
+#ifdef SLIMGUI
+			, community_.check_infinite_loops_
+#endif
+			);
+		
+		if (p_mutationEffect_callback->contains_self_)
+			callback_symbols.InitializeConstantSymbolEntry(p_mutationEffect_callback->SelfSymbolTableEntry());		// define "self"
+		
+		// Set up the callback's parameters as vectors, with one element per call; a mutation facing a null haplosome has a homozygous
+		// value of F, since NULL cannot be an element of a vector, but its effect still incorporates the hemizygous dominance coefficient
+		if (p_mutationEffect_callback->contains_mut_)
+		{
+			Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+			EidosValue_Object *mut_value = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Mutation_Class))->resize_no_initialize_RR(call_count);
+			
+			for (size_t element_index = 0; element_index < call_count; ++element_index)
+				mut_value->set_object_element_no_check_no_previous_RR(mut_block_ptr + vectorized_mutations_[p_call_indices[element_index]], element_index);
+			
+			callback_symbols.InitializeConstantSymbolEntry(gID_mut, EidosValue_SP(mut_value));
+		}
+		if (p_mutationEffect_callback->contains_effect_)
+		{
+			EidosValue_Float *effect_value = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(call_count);
+			double *effect_data = effect_value->data_mutable();
+			
+			for (size_t element_index = 0; element_index < call_count; ++element_index)
+				effect_data[element_index] = vectorized_effects_[p_call_indices[element_index]];
+			
+			callback_symbols.InitializeConstantSymbolEntry(gID_effect, EidosValue_SP(effect_value));
+		}
+		if (p_mutationEffect_callback->contains_individual_)
+		{
+			EidosValue_Object *individual_value = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Individual_Class))->resize_no_initialize(call_count);
+			
+			for (size_t element_index = 0; element_index < call_count; ++element_index)
+				individual_value->set_object_element_no_check_NORR(vectorized_individuals_[p_call_indices[element_index]], element_index);
+			
+			callback_symbols.InitializeConstantSymbolEntry(gID_individual, EidosValue_SP(individual_value));
+		}
+		if (p_mutationEffect_callback->contains_subpop_)
+			callback_symbols.InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
+		if (p_mutationEffect_callback->contains_homozygous_)
+		{
+			EidosValue_Logical *homozygous_value = (new (gEidosValuePool->AllocateChunk()) EidosValue_Logical())->resize_no_initialize(call_count);
+			eidos_logical_t *homozygous_data = homozygous_value->data_mutable();
+			
+			for (size_t element_index = 0; element_index < call_count; ++element_index)
+				homozygous_data[element_index] = (vectorized_homozygous_[p_call_indices[element_index]] == 1);
+			
+			callback_symbols.InitializeConstantSymbolEntry(gID_homozygous, EidosValue_SP(homozygous_value));
+		}
+		
+		// Interpret the script; the result must be a float vector with one effect per call, or a float singleton applying to all of them
+		EidosValue_SP result_SP = interpreter.EvaluateInternalBlock(p_mutationEffect_callback->script_);
+		EidosValue *result = result_SP.get();
+		int result_count = result->Count();
+		
+		if ((result->Type() != EidosValueType::kValueFloat) || ((result_count != (int)call_count) && (result_count != 1)))
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteVectorizedMutationEffectCallback): vectorized mutationEffect() callbacks must provide a float return value with one element per mutation, or a float singleton." << EidosTerminate(p_mutationEffect_callback->identifier_token_);
+		
+		const double *result_data = result->FloatData();
+		
+		if (result_count == 1)
+		{
+			double effect = result_data[0];
+			
+			for (size_t call_index : p_call_indices)
+				vectorized_effects_[call_index] = effect;
+		}
+		else
+		{
+			for (size_t element_index = 0; element_index < call_count; ++element_index)
+				vectorized_effects_[p_call_indices[element_index]] = result_data[element_index];
+		}
+	}
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_END(community_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosMutationEffectCallback)]);
+#endif
+}
+
+bool Subpopulation::ExecuteVectorizedNativeCallback(SLiMEidosBlock *p_mutationEffect_callback, std::vector<size_t> &p_call_indices)
+{
+	// Evaluate a vectorized mutationEffect() callback that has been compiled to native code; returns false if it would raise, so
+	// that ExecuteVectorizedMutationEffectCallback() can run it in the interpreter instead, to raise in the usual way
+	size_t call_count = p_call_indices.size();
+	std::vector<Individual *> individuals(call_count);
+	std::vector<double> effects(call_count);
+	
+	for (size_t element_index = 0; element_index < call_count; ++element_index)
+	{
+		individuals[element_index] = vectorized_individuals_[p_call_indices[element_index]];
+		effects[element_index] = vectorized_effects_[p_call_indices[element_index]];
+	}
+	
+	if (!p_mutationEffect_callback->native_callback_->EvaluateMany(individuals.data(), effects.data(), call_count, effects.data()))
+		return false;
+	
+	for (size_t element_index = 0; element_index < call_count; ++element_index)
+		vectorized_effects_[p_call_indices[element_index]] = effects[element_index];
+	
+	return true;
+}
+
+void Subpopulation::EndVectorizedMutationEffectCallbacks(void)
+{
+	for (auto &mut_type_iter : species_.MutationTypes())
+		mut_type_iter.second->vectorized_mutationEffect_now_ = false;
+	
+	vectorized_mutationEffect_mode_ = 0;
+	vectorized_cursor_individual_ = nullptr;
+	vectorized_mutations_.clear();
+	vectorized_homozygous_.clear();
+	vectorized_effects_.clear();
+	vectorized_individuals_.clear();
+}
+
+bool Subpopulation::PrecomputeFitnessEffectCallbacks(std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks, std::vector<SLiMEidosBlock*> &p_fitnessEffect_callbacks)
+{
+	// Evaluating the fitnessEffect() callbacks ahead of the mutationEffect() callbacks is safe only if no mutationEffect() callback could
+	// change what they see; vectorized callbacks have already run, and constant and native callbacks have no side effects
+	for (SLiMEidosBlock *mutationEffect_callback : p_mutationEffect_callbacks)
+		if (mutationEffect_callback->block_active_ && !mutationEffect_callback->vectorized_ && !mutationEffect_callback->compound_statement_node_->cached_return_value_ && !mutationEffect_callback->has_cached_optimization_)
+			return false;
+	
+	for (SLiMEidosBlock *fitnessEffect_callback : p_fitnessEffect_callbacks)
+	{
+		if (fitnessEffect_callback->block_active_)
+		{
+			EidosValue *cached_value = fitnessEffect_callback->compound_statement_node_->cached_return_value_.get();
+			
+			// a bad constant return value is left for ApplyFitnessEffectCallbacks() to raise on
+			if (cached_value && ((cached_value->Type() != EidosValueType::kValueFloat) || (cached_value->Count() != 1)))
+				return false;
+			if (!cached_value && !fitnessEffect_callback->has_cached_optimization_)
+				return false;
+		}
+	}
+	
+#if DEBUG_POINTS_ENABLED
+	// debug points are reported by ApplyFitnessEffectCallbacks(), so we don't precompute if any are set
+	EidosInterpreterDebugPointsSet *debug_points = community_.DebugPoints();
+	
+	if (debug_points && debug_points->set.size())
+		return false;
+#endif
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_START();
+#endif
+	
+	// Start with every parental individual that the fitness loops will evaluate callbacks for; as in ApplyFitnessEffectCallbacks(),
+	// the callbacks are applied in order, and an individual whose fitness falls to zero or below is dropped from further evaluation
+	fitnessEffect_precomputed_values_.assign(parent_subpop_size_, 1.0);
+	fitnessEffect_precompute_individuals_.clear();
+	fitnessEffect_precompute_indices_.clear();
+	
+	for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; ++individual_index)
+	{
+		Individual *individual = parent_individuals_[individual_index];
+		
+		if (individual->fitness_scaling_ > 0.0)
+		{
+			fitnessEffect_precompute_individuals_.emplace_back(individual);
+			fitnessEffect_precompute_indices_.emplace_back(individual_index);
+		}
+	}
+	
+	bool success = true;
+	
+	for (SLiMEidosBlock *fitnessEffect_callback : p_fitnessEffect_callbacks)
+	{
+		if (!fitnessEffect_callback->block_active_)
+			continue;
+		
+		size_t live_count = fitnessEffect_precompute_indices_.size();
+		EidosValue *cached_value = fitnessEffect_callback->compound_statement_node_->cached_return_value_.get();
+		
+		if (cached_value)
+		{
+			double value = cached_value->FloatData()[0];
+			
+			for (size_t live_index = 0; live_index < live_count; ++live_index)
+				fitnessEffect_precomputed_values_[fitnessEffect_precompute_indices_[live_index]] *= value;
+		}
+		else
+		{
+			// if the callback would raise for any individual, we leave it to ApplyFitnessEffectCallbacks() to raise in the usual way
+			fitnessEffect_precompute_results_.resize(live_count);
+			
+			if (!fitnessEffect_callback->native_callback_->EvaluateMany(fitnessEffect_precompute_individuals_.data(), nullptr, live_count, fitnessEffect_precompute_results_.data()))
+			{
+				success = false;
+				break;
+			}
+			
+			for (size_t live_index = 0; live_index < live_count; ++live_index)
+				fitnessEffect_precomputed_values_[fitnessEffect_precompute_indices_[live_index]] *= fitnessEffect_precompute_results_[live_index];
+		}
+		
+		// compact the live individuals, zeroing the fitness of those that have been dropped
+		size_t kept_count = 0;
+		
+		for (size_t live_index = 0; live_index < live_count; ++live_index)
+		{
+			slim_popsize_t individual_index = fitnessEffect_precompute_indices_[live_index];
+			
+			if (fitnessEffect_precomputed_values_[individual_index] <= 0.0)
+			{
+				fitnessEffect_precomputed_values_[individual_index] = 0.0;
+			}
+			else
+			{
+				fitnessEffect_precompute_individuals_[kept_count] = fitnessEffect_precompute_individuals_[live_index];
+				fitnessEffect_precompute_indices_[kept_count] = individual_index;
+				kept_count++;
+			}
+		}
+		
+		fitnessEffect_precompute_individuals_.resize(kept_count);
+		fitnessEffect_precompute_indices_.resize(kept_count);
+	}
+	
+	fitnessEffect_precomputed_ = success;
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_END(community_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosFitnessEffectCallback)]);
+#endif
+	
+	return success;
+}
+
 double Subpopulation::ApplyFitnessEffectCallbacks(std::vector<SLiMEidosBlock*> &p_fitnessEffect_callbacks, slim_popsize_t p_individual_index)
 {
+	// if PrecomputeFitnessEffectCallbacks() already did the work, just fetch the result
+	if (fitnessEffect_precomputed_)
+		return fitnessEffect_precomputed_values_[p_individual_index];
+	
 	THREAD_SAFETY_IN_ANY_PARALLEL("Population::ApplyFitnessEffectCallbacks(): running Eidos callback");
 	
 #if (SLIMPROFILING == 1)
@@ -2688,24 +3174,9 @@ double Subpopulation::ApplyFitnessEffectCallbacks(std::vector<SLiMEidosBlock*> &
 			}
 			else if (fitnessEffect_callback->has_cached_optimization_)
 			{
-				// We can special-case particular simple callbacks for speed.  This is similar to the cached_return_value_
-				// mechanism above, but it is done in SLiM, not in Eidos, and is specific to callbacks, not general.
-				// The has_cached_optimization_ flag is the umbrella flag for all such optimizations; we then figure
-				// out below which cached optimization is in effect for this callback.  See Community::OptimizeScriptBlock()
-				// for comments on the specific cases optimized here.
-				if (fitnessEffect_callback->has_cached_opt_dnorm1_)
-				{
-					double A = fitnessEffect_callback->cached_opt_A_;
-					double B = fitnessEffect_callback->cached_opt_B_;
-					double C = fitnessEffect_callback->cached_opt_C_;
-					double D = fitnessEffect_callback->cached_opt_D_;
-					
-					computed_fitness *= (D + (gsl_ran_gaussian_pdf(individual->tagF_value_ - A, B) / C));
-				}
-				else
-				{
-					EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyFitnessEffectCallbacks): (internal error) cached optimization flag mismatch" << EidosTerminate(fitnessEffect_callback->identifier_token_);
-				}
+				// The callback was compiled to native code by Community::OptimizeScriptBlock(), so we can evaluate it without
+				// the interpreter.  This is similar to the cached_return_value_ mechanism above, but specific to callbacks.
+				computed_fitness *= fitnessEffect_callback->native_callback_->Evaluate(individual, 0.0);
 			}
 			else
 			{
@@ -2936,6 +3407,44 @@ double Subpopulation::FitnessOfParent_1CH_Haploid(slim_popsize_t p_individual_in
 	return w;
 }
 
+double Subpopulation::FitnessOfParent_Precomputed(slim_popsize_t p_individual_index, __attribute__((unused)) std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks)
+{
+	// the chromosomal fitness of the individual was computed by Population::PrecomputeChromosomalFitness(); see chromosomal_fitness_precomputed_
+	return parent_individuals_[p_individual_index]->cached_fitness_UNSAFE_;
+}
+
+double Subpopulation::ChromosomeFitnessOfParent(Individual *p_individual, Chromosome *p_chromosome, int p_first_haplosome_index)
+{
+	// calculate the fitness effect of one chromosome for an individual in the parent population, without callbacks; this is
+	// the body of the chromosome loop in FitnessOfParent(), used by Population::PrecomputeChromosomalFitness()
+	static std::vector<SLiMEidosBlock*> no_callbacks;		// never modified, so it is safe to share across threads
+	
+	switch (p_chromosome->Type())
+	{
+			// diploid, possibly with one or both being null haplosomes
+		case ChromosomeType::kA_DiploidAutosome:
+		case ChromosomeType::kX_XSexChromosome:
+		case ChromosomeType::kZ_ZSexChromosome:
+			return _Fitness_DiploidChromosome<false, false>(p_individual->haplosomes_[p_first_haplosome_index], p_individual->haplosomes_[p_first_haplosome_index+1], no_callbacks);
+			
+			// haploid, possibly null
+		case ChromosomeType::kH_HaploidAutosome:
+		case ChromosomeType::kY_YSexChromosome:
+		case ChromosomeType::kW_WSexChromosome:
+		case ChromosomeType::kHF_HaploidFemaleInherited:
+		case ChromosomeType::kFL_HaploidFemaleLine:
+		case ChromosomeType::kHM_HaploidMaleInherited:
+		case ChromosomeType::kML_HaploidMaleLine:
+			// special cases: haploid but with an accompanying null
+		case ChromosomeType::kHNull_HaploidAutosomeWithNull:
+			return _Fitness_HaploidChromosome<false, false>(p_individual->haplosomes_[p_first_haplosome_index], no_callbacks);
+		case ChromosomeType::kNullY_YSexChromosomeWithNull:
+			return _Fitness_HaploidChromosome<false, false>(p_individual->haplosomes_[p_first_haplosome_index+1], no_callbacks);
+	}
+	
+	return 1.0;
+}
+
 template <const bool f_callbacks, const bool f_singlecallback>
 double Subpopulation::_Fitness_DiploidChromosome(Haplosome *haplosome1, Haplosome *haplosome2, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks)
 {
@@ -5645,19 +6154,18 @@ template bool Subpopulation::MungeIndividualCloned_1CH_H<true, true, false>(Indi
 template bool Subpopulation::MungeIndividualCloned_1CH_H<true, true, true>(Individual *individual, slim_pedigreeid_t p_pedigree_id, Individual *p_parent);
 
 // nonWF only:
-void Subpopulation::ApplyReproductionCallbacks(std::vector<SLiMEidosBlock*> &p_reproduction_callbacks, slim_popsize_t p_individual_index)
+void Subpopulation::ApplyReproductionCallbacks(std::vector<SLiMEidosBlock*> &p_reproduction_callbacks, std::vector<std::unique_ptr<EidosSymbolTable>> &p_callback_symbols, slim_popsize_t p_individual_index)
 {
 	THREAD_SAFETY_IN_ANY_PARALLEL("Population::ApplyReproductionCallbacks(): running Eidos callback");
 	
-#if (SLIMPROFILING == 1)
-	// PROFILING
-	SLIM_PROFILE_BLOCK_START();
-#endif
-	
 	Individual *individual = parent_individuals_[p_individual_index];
+	EidosFunctionMap &function_map = community_.FunctionMap();
+	size_t callback_count = p_reproduction_callbacks.size();
 	
-	for (SLiMEidosBlock *reproduction_callback : p_reproduction_callbacks)
+	for (size_t callback_index = 0; callback_index < callback_count; ++callback_index)
 	{
+		SLiMEidosBlock *reproduction_callback = p_reproduction_callbacks[callback_index];
+		
 		if (reproduction_callback->block_active_)
 		{
 			IndividualSex sex_specificity = reproduction_callback->sex_specificity_;
@@ -5693,30 +6201,20 @@ void Subpopulation::ApplyReproductionCallbacks(std::vector<SLiMEidosBlock*> &p_r
 				}
 #endif
 				
-				// This code is similar to Population::ExecuteScript, but we set up an additional symbol table, and we use the return value
-				// We need to actually execute the script; we start a block here to manage the lifetime of the symbol table
+				// This code is similar to Population::ExecuteScript, but we use a constants table set up by ReproduceSubpopulation(), and
+				// we use the return value.  Only the value of "individual" changes between invocations, so we swap it in place; each
+				// invocation still gets a fresh local variables table, so no variables leak from one individual's invocation to the next.
 				{
-					EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &community_.SymbolTable());
+					EidosSymbolTable &callback_symbols = *p_callback_symbols[callback_index];
 					EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
-					EidosFunctionMap &function_map = community_.FunctionMap();
 					EidosInterpreter interpreter(reproduction_callback->compound_statement_node_, client_symbols, function_map, &community_, SLIM_OUTSTREAM, SLIM_ERRSTREAM
 #ifdef SLIMGUI
 						, community_.check_infinite_loops_
 #endif
 						);
 					
-					if (reproduction_callback->contains_self_)
-						callback_symbols.InitializeConstantSymbolEntry(reproduction_callback->SelfSymbolTableEntry());		// define "self"
-					
-					// Set all of the callback's parameters; note we use InitializeConstantSymbolEntry() for speed.
-					// We can use that method because we know the lifetime of the symbol table is shorter than that of
-					// the value objects, and we know that the values we are setting here will not change (the objects
-					// referred to by the values may change, but the values themselves will not change).
-					// BCH 11/7/2025: note these symbols are now protected in SLiM_ConfigureContext()
 					if (reproduction_callback->contains_individual_)
-						callback_symbols.InitializeConstantSymbolEntry(gID_individual, individual->CachedEidosValue());
-					if (reproduction_callback->contains_subpop_)
-						callback_symbols.InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
+						callback_symbols.ReplaceConstantSymbolEntry(gID_individual, individual->CachedEidosValue());
 					
 					try
 					{
@@ -5741,11 +6239,6 @@ void Subpopulation::ApplyReproductionCallbacks(std::vector<SLiMEidosBlock*> &p_r
 			}
 		}
 	}
-	
-#if (SLIMPROFILING == 1)
-	// PROFILING
-	SLIM_PROFILE_BLOCK_END(community_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosReproductionCallback)]);
-#endif
 }
 
 // nonWF only:
@@ -5755,6 +6248,34 @@ void Subpopulation::ReproduceSubpopulation(void)
 	if (registered_reproduction_callbacks_.size() == 0)
 		return;
 	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_START();
+#endif
+	
+	// Set up a constants table for each callback once, for the whole pass over the subpopulation, rather than once per individual.
+	// We can use InitializeConstantSymbolEntry() for speed because we know the lifetime of these symbol tables is shorter than that
+	// of the value objects, and we know that the values we are setting here will not change (the objects referred to by the values
+	// may change, but the values themselves will not change).  The "individual" entry is a placeholder, replaced for each individual.
+	// BCH 11/7/2025: note these symbols are now protected in SLiM_ConfigureContext()
+	std::vector<std::unique_ptr<EidosSymbolTable>> callback_symbols;
+	
+	callback_symbols.reserve(registered_reproduction_callbacks_.size());
+	
+	for (SLiMEidosBlock *reproduction_callback : registered_reproduction_callbacks_)
+	{
+		EidosSymbolTable *symbols = new EidosSymbolTable(EidosSymbolTableType::kContextConstantsTable, &community_.SymbolTable());
+		
+		callback_symbols.emplace_back(symbols);
+		
+		if (reproduction_callback->contains_self_)
+			symbols->InitializeConstantSymbolEntry(reproduction_callback->SelfSymbolTableEntry());		// define "self"
+		if (reproduction_callback->contains_individual_)
+			symbols->InitializeConstantSymbolEntry(gID_individual, gStaticEidosValueNULL);
+		if (reproduction_callback->contains_subpop_)
+			symbols->InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
+	}
+	
 	if (species_.RandomizingCallbackOrder())
 	{
 		slim_popsize_t *shuffle_buf = species_.BorrowShuffleBuffer(parent_subpop_size_);
@@ -5763,7 +6284,7 @@ void Subpopulation::ReproduceSubpopulation(void)
 		{
 			slim_popsize_t individual_index = shuffle_buf[shuffle_index];
 			
-			ApplyReproductionCallbacks(registered_reproduction_callbacks_, individual_index);
+			ApplyReproductionCallbacks(registered_reproduction_callbacks_, callback_symbols, individual_index);
 		}
 		
 		species_.ReturnShuffleBuffer();
@@ -5771,8 +6292,13 @@ void Subpopulation::ReproduceSubpopulation(void)
 	else
 	{
 		for (int individual_index = 0; individual_index < parent_subpop_size_; ++individual_index)
-			ApplyReproductionCallbacks(registered_reproduction_callbacks_, individual_index);
+			ApplyReproductionCallbacks(registered_reproduction_callbacks_, callback_symbols, individual_index);
 	}
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_END(community_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosReproductionCallback)]);
+#endif
 }
 
 // nonWF only:
@@ -6174,7 +6700,7 @@ void Subpopulation::IncrementIndividualAges(void)
 	
 	EIDOS_BENCHMARK_START(EidosBenchmarkType::k_AGE_INCR);
 	EIDOS_THREAD_COUNT(gEidos_OMP_threads_AGE_INCR);
-#pragma omp parallel for schedule(static) default(none) shared(parent_count) firstprivate(parents) if(parent_count >= EIDOS_OMPMIN_AGE_INCR) num_threads(thread_count)
+#pragma omp parallel for schedule(static) default(none) shared(parent_count) firstprivate(parents) if((int64_t)parent_count >= EIDOS_OMPMIN_AGE_INCR) num_threads(thread_count)
 	for (size_t parent_index = 0; parent_index < parent_count; ++parent_index)
 	{
 		(parents[parent_index]->age_)++;
@@ -6628,6 +7154,7 @@ EidosValue_SP Subpopulation::ExecuteInstanceMethod(EidosGlobalStringID p_method_
 			// nonWF only:
 		case gID_addCloned:				return ExecuteMethod_addCloned(p_method_id, p_arguments, p_interpreter);
 		case gID_addCrossed:			return ExecuteMethod_addCrossed(p_method_id, p_arguments, p_interpreter);
+		case gID_addCrossedBatch:		return ExecuteMethod_addCrossedBatch(p_method_id, p_arguments, p_interpreter);
 		case gID_addEmpty:				return ExecuteMethod_addEmpty(p_method_id, p_arguments, p_interpreter);
 		case gID_addMultiRecombinant:	return ExecuteMethod_addMultiRecombinant(p_method_id, p_arguments, p_interpreter);
 		case gID_addRecombinant:		return ExecuteMethod_addRecombinant(p_method_id, p_arguments, p_interpreter);
@@ -7118,6 +7645,122 @@ EidosValue_SP Subpopulation::ExecuteMethod_addCrossed(EidosGlobalStringID p_meth
 	return EidosValue_SP(result);
 }
 
+//	*********************	– (o<Individual>)addCrossedBatch(object<Individual> parent1, object<Individual> parent2, [Nfs$ sex = NULL], [integer count = 1])
+//
+EidosValue_SP Subpopulation::ExecuteMethod_addCrossedBatch(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
+{
+#pragma unused (p_method_id, p_arguments, p_interpreter)
+	if (model_type_ == SLiMModelType::kModelTypeWF)
+		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCrossedBatch): addCrossedBatch() is not available in WF models." << EidosTerminate();
+	
+	// TIMING RESTRICTION
+	if (community_.CycleStage() != SLiMCycleStage::kNonWFStage1GenerateOffspring)
+		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCrossedBatch): addCrossedBatch() may only be called from a reproduction() callback." << EidosTerminate();
+	if (community_.executing_block_type_ != SLiMEidosBlockType::SLiMEidosReproductionCallback)
+		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCrossedBatch): addCrossedBatch() may not be called from a nested callback." << EidosTerminate();
+	
+	EidosValue *parent1_value = p_arguments[0].get();
+	EidosValue *parent2_value = p_arguments[1].get();
+	EidosValue *sex_value = p_arguments[2].get();
+	EidosValue *count_value = p_arguments[3].get();
+	int pair_count = parent1_value->Count();
+	int count_count = count_value->Count();
+	
+	if (parent2_value->Count() != pair_count)
+		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCrossedBatch): addCrossedBatch() requires that parent1 and parent2 be the same length." << EidosTerminate();
+	if ((count_count != 1) && (count_count != pair_count))
+		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCrossedBatch): addCrossedBatch() requires that count be singleton, or the same length as parent1 and parent2." << EidosTerminate();
+	
+	Individual * const *parent1_data = (Individual * const *)parent1_value->ObjectData();
+	Individual * const *parent2_data = (Individual * const *)parent2_value->ObjectData();
+	const int64_t *count_data = count_value->IntData();
+	bool prevent_incidental_selfing = species_.PreventIncidentalSelfing();
+	int64_t total_child_count = 0;
+	
+	// Check all of the mating pairs and counts before generating any offspring, so that an error does not leave a partial batch behind
+	for (int pair_index = 0; pair_index < pair_count; ++pair_index)
+	{
+		Individual *parent1 = parent1_data[pair_index];
+		Individual *parent2 = parent2_data[pair_index];
+		IndividualSex parent1_sex = parent1->sex_;
+		IndividualSex parent2_sex = parent2->sex_;
+		
+		if ((parent1_sex != IndividualSex::kFemale) && (parent1_sex != IndividualSex::kHermaphrodite))
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCrossedBatch): parent1 must be female in sexual models (or hermaphroditic in non-sexual models)." << EidosTerminate();
+		if ((parent2_sex != IndividualSex::kMale) && (parent2_sex != IndividualSex::kHermaphrodite))
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCrossedBatch): parent2 must be male in sexual models (or hermaphroditic in non-sexual models)." << EidosTerminate();
+		
+		// SPECIES CONSISTENCY CHECK
+		if ((&parent1->subpopulation_->species_ != &this->species_) || (&parent2->subpopulation_->species_ != &this->species_))
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCrossedBatch): addCrossedBatch() requires that all parents belong to the same species as the target subpopulation." << EidosTerminate();
+		
+		if ((parent1->index_ == -1) || (parent2->index_ == -1))
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCrossedBatch): parent1 and parent2 must be visible in a subpopulation (i.e., may not be new juveniles)." << EidosTerminate();
+		
+		if (prevent_incidental_selfing && (parent1 == parent2))
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCrossedBatch): parent1 and parent2 must be different individuals, since preventIncidentalSelfing has been set to T (use addSelfed to generate a non-incidentally selfed offspring)." << EidosTerminate();
+		
+		int64_t child_count = count_data[(count_count == 1) ? 0 : pair_index];
+		
+		if ((child_count < 0) || (child_count > SLIM_MAX_SUBPOP_SIZE))
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCrossedBatch): addCrossedBatch() requires offspring counts >= 0 and <= 1000000000." << EidosTerminate();
+		
+		total_child_count += child_count;
+	}
+	
+	if (total_child_count > SLIM_MAX_SUBPOP_SIZE)
+		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCrossedBatch): addCrossedBatch() requires a total offspring count <= 1000000000." << EidosTerminate();
+	
+	EidosValue_Object *result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Individual_Class))->reserve(total_child_count);	// reserve enough space for all results
+	
+	if (total_child_count == 0)
+		return EidosValue_SP(result);
+	
+	// Generate the children in order, pair by pair, exactly as a loop over addCrossed() would; this draws random numbers in the same
+	// sequence as that loop, but avoids the per-call dispatch, argument processing, and result allocation of calling addCrossed()
+	for (int pair_index = 0; pair_index < pair_count; ++pair_index)
+	{
+		Individual *parent1 = parent1_data[pair_index];
+		Individual *parent2 = parent2_data[pair_index];
+		int64_t child_count = count_data[(count_count == 1) ? 0 : pair_index];
+		
+		for (int64_t child_index = 0; child_index < child_count; ++child_index)
+		{
+			// Determine the sex of the offspring based on the sex parameter
+			IndividualSex child_sex = _SexForSexValue(sex_value, sex_enabled_);
+			
+			// Make the new individual; if it doesn't pass modifyChild(), nullptr will be returned
+			Individual *individual = (this->*(population_.GenerateIndividualCrossed_TEMPLATED))(parent1, parent2, child_sex);
+			
+			// If the child was accepted, add it to our staging area and to our result vector
+			if (individual)
+			{
+				nonWF_offspring_individuals_.emplace_back(individual);
+				result->push_object_element_NORR(individual);
+				
+#if defined(SLIMGUI)
+				{
+					Subpopulation &parent1_subpop = *parent1->subpopulation_;
+					Subpopulation &parent2_subpop = *parent2->subpopulation_;
+					
+					gui_offspring_crossed_++;
+					
+					// see ExecuteMethod_addCrossed() for discussion of this tallying
+					parent1_subpop.gui_premigration_size_ += 0.5;
+					parent2_subpop.gui_premigration_size_ += 0.5;
+					if (&parent1_subpop != this)
+						gui_migrants_[parent1_subpop.subpopulation_id_] += 0.5;
+					if (&parent2_subpop != this)
+						gui_migrants_[parent2_subpop.subpopulation_id_] += 0.5;
+				}
+#endif
+			}
+		}
+	}
+	
+	return EidosValue_SP(result);
+}
+
 //	*********************	– (o<Individual>)addEmpty([Nfs$ sex = NULL], [Nl$ haplosome1Null = NULL], [Nl$ haplosome2Null = NULL], [integer$ count = 1])
 //
 EidosValue_SP Subpopulation::ExecuteMethod_addEmpty(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
@@ -12514,6 +13157,7 @@ EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_m
 	
 	// Figure out the right output stream
 	std::ofstream outfile;
+	VCFOutputFile vcf_outfile;		// used instead of outfile for VCF output, which may be BGZF-compressed (.gz) or BCF (.bcf)
 	bool has_file = false;
 	std::string outfile_path;
 	
@@ -12521,11 +13165,21 @@ EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_m
 	{
 		outfile_path = Eidos_ResolvedPath(filePath_arg->StringAtIndex_NOCAST(0, nullptr));
 		bool append = append_arg->LogicalAtIndex_NOCAST(0, nullptr);
+		bool opened;
+		
+		if (p_method_id == gID_outputVCFSample)
+		{
+			opened = vcf_outfile.Open(outfile_path, append, "Subpopulation::ExecuteMethod_outputXSample");
+		}
+		else
+		{
+			outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+			opened = outfile.is_open();
+		}
 		
-		outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
 		has_file = true;
 		
-		if (!outfile.is_open())
+		if (!opened)
 			EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_outputXSample): " << EidosStringRegistry::StringForGlobalStringID(p_method_id) << "() could not open "<< outfile_path << "." << EidosTerminate();
 	}
 	else
@@ -12534,7 +13188,7 @@ EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_m
 		Eidos_EraseProgress();
 	}
 	
-	std::ostream &out = *(has_file ? dynamic_cast<std::ostream *>(&outfile) : dynamic_cast<std::ostream *>(&output_stream));
+	std::ostream &out = *(has_file ? ((p_method_id == gID_outputVCFSample) ? &vcf_outfile.Stream() : dynamic_cast<std::ostream *>(&outfile)) : dynamic_cast<std::ostream *>(&output_stream));
 	
 	if (!has_file || (p_method_id == gID_outputSample))
 	{
@@ -12571,10 +13225,15 @@ EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_m
 	else if (p_method_id == gID_outputMSSample)
 		population_.PrintSample_MS(out, *this, sample_size, replace, requested_sex, *chromosome, filter_monomorphic);
 	else if (p_method_id == gID_outputVCFSample)
-		population_.PrintSample_VCF(out, *this, sample_size, replace, requested_sex, *chromosome, output_multiallelics, simplify_nucs, output_nonnucs, group_as_individuals);
+		population_.PrintSample_VCF(out, *this, sample_size, replace, requested_sex, *chromosome, output_multiallelics, simplify_nucs, output_nonnucs, group_as_individuals, vcf_outfile.Format());
 	
 	if (has_file)
-		outfile.close(); 
+	{
+		if (p_method_id == gID_outputVCFSample)
+			vcf_outfile.Close("Subpopulation::ExecuteMethod_outputXSample");
+		else
+			outfile.close();
+	}
 	
 	return gStaticEidosValueVOID;
 }
@@ -12747,6 +13406,7 @@ const std::vector<EidosMethodSignature_CSP> *Subpopulation_Class::Methods(void)
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_setSubpopulationSize, kEidosValueMaskVOID))->AddInt_S("size"));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_addCloned, kEidosValueMaskObject, gSLiM_Individual_Class))->AddObject_S("parent", gSLiM_Individual_Class)->AddInt_OS("count", gStaticEidosValue_Integer1)->AddLogical_OS("defer", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_addCrossed, kEidosValueMaskObject, gSLiM_Individual_Class))->AddObject_S("parent1", gSLiM_Individual_Class)->AddObject_S("parent2", gSLiM_Individual_Class)->AddArgWithDefault(kEidosValueMaskNULL | kEidosValueMaskFloat | kEidosValueMaskString | kEidosValueMaskSingleton | kEidosValueMaskOptional, "sex", nullptr, gStaticEidosValueNULL)->AddInt_OS("count", gStaticEidosValue_Integer1)->AddLogical_OS("defer", gStaticEidosValue_LogicalF));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_addCrossedBatch, kEidosValueMaskObject, gSLiM_Individual_Class))->AddObject("parent1", gSLiM_Individual_Class)->AddObject("parent2", gSLiM_Individual_Class)->AddArgWithDefault(kEidosValueMaskNULL | kEidosValueMaskFloat | kEidosValueMaskString | kEidosValueMaskSingleton | kEidosValueMaskOptional, "sex", nullptr, gStaticEidosValueNULL)->AddInt_O("count", gStaticEidosValue_Integer1));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_addEmpty, kEidosValueMaskObject, gSLiM_Individual_Class))->AddArgWithDefault(kEidosValueMaskNULL | kEidosValueMaskFloat | kEidosValueMaskString | kEidosValueMaskSingleton | kEidosValueMaskOptional, "sex", nullptr, gStaticEidosValueNULL)->AddLogical_OSN("haplosome1Null", gStaticEidosValueNULL)->AddLogical_OSN("haplosome2Null", gStaticEidosValueNULL)->AddInt_OS("count", gStaticEidosValue_Integer1));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_addMultiRecombinant, kEidosValueMaskObject, gSLiM_Individual_Class))->AddObject_S("pattern", gEidosDictionaryUnretained_Class)->AddArgWithDefault(kEidosValueMaskNULL | kEidosValueMaskFloat | kEidosValueMaskString | kEidosValueMaskSingleton | kEidosValueMaskOptional, "sex", nullptr, gStaticEidosValueNULL)->AddObject_OSN("parent1", gSLiM_Individual_Class, gStaticEidosValueNULL)->AddObject_OSN("parent2", gSLiM_Individual_Class, gStaticEidosValueNULL)->AddLogical_OSN("randomizeStrands", gStaticEidosValueNULL)->AddInt_OS("count", gStaticEidosValue_Integer1)->AddLogical_OS("defer", gStaticEidosValue_LogicalF));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_addRecombinant, kEidosValueMaskObject, gSLiM_Individual_Class))->AddObject_SN(gStr_strand1, gSLiM_Haplosome_Class)->AddObject_SN(gStr_strand2, gSLiM_Haplosome_Class)->AddInt_N(gStr_breaks1)->AddObject_SN(gStr_strand3, gSLiM_Haplosome_Class)->AddObject_SN(gStr_strand4, gSLiM_Haplosome_Class)->AddInt_N(gStr_breaks2)->AddArgWithDefault(kEidosValueMaskNULL | kEidosValueMaskFloat | kEidosValueMaskString | kEidosValueMaskSingleton | kEidosValueMaskOptional, "sex", nullptr, gStaticEidosValueNULL)->AddObject_OSN("parent1", gSLiM_Individual_Class, gStaticEidosValueNULL)->AddObject_OSN("parent2", gSLiM_Individual_Class, gStaticEidosValueNULL)->AddLogical_OSN("randomizeStrands", gStaticEidosValueNULL)->AddInt_OS("count", gStaticEidosValue_Integer1)->AddLogical_OS("defer", gStaticEidosValue_LogicalF));
@@ -64,6 +64,7 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 #include <limits.h>
 
 
@@ -183,6 +184,33 @@ public:
 	bool individual_cached_fitness_OVERRIDE_ = false;
 	double individual_cached_fitness_OVERRIDE_value_;
 	
+	// Set by Population::PrecomputeChromosomalFitness() when it has already computed the chromosomal fitness of every parental individual,
+	// in a single parallel pass across all subpopulations and chromosomes, and stashed it in cached_fitness_UNSAFE_.  UpdateFitness() then
+	// uses those values through FitnessOfParent_Precomputed(), and clears this flag.  This is done only when no callbacks are active.
+	bool chromosomal_fitness_precomputed_ = false;
+	
+	// State for vectorized mutationEffect() callbacks, valid only inside a given UpdateFitness() call; see RunVectorizedMutationEffectCallbacks().
+	// In a recording pass, each call to ApplyMutationEffectCallbacks() for a mutation type with vectorized callbacks is appended to these buffers;
+	// the vectorized callbacks are then run over the buffers, replacing the recorded effects, and a replaying pass reads those effects back.
+	// Each individual's calls are contiguous in the buffers, starting at vectorized_individual_start_[index]; the replay cursor follows them.
+	int vectorized_mutationEffect_mode_ = 0;						// 0 = off, 1 = recording, 2 = replaying
+	std::vector<MutationIndex> vectorized_mutations_;
+	std::vector<int8_t> vectorized_homozygous_;						// -1 (facing a null haplosome), 0 (heterozygous), 1 (homozygous)
+	std::vector<double> vectorized_effects_;
+	std::vector<Individual *> vectorized_individuals_;
+	std::vector<size_t> vectorized_individual_start_;
+	Individual *vectorized_cursor_individual_ = nullptr;
+	size_t vectorized_cursor_ = 0;
+	
+	// Set by PrecomputeFitnessEffectCallbacks() when it has evaluated every active fitnessEffect() callback for every live parental
+	// individual up front, which it does only when they are all constant or compiled to native code; ApplyFitnessEffectCallbacks()
+	// then just returns fitnessEffect_precomputed_values_[index].  Valid only inside a given UpdateFitness() call.
+	bool fitnessEffect_precomputed_ = false;
+	std::vector<double> fitnessEffect_precomputed_values_;
+	std::vector<Individual *> fitnessEffect_precompute_individuals_;	// scratch: the individuals still live, for EvaluateMany()
+	std::vector<slim_popsize_t> fitnessEffect_precompute_indices_;		// scratch: their indices
+	std::vector<double> fitnessEffect_precompute_results_;				// scratch: the results from EvaluateMany()
+	
 	// SEX ONLY; the default values here are for the non-sex case
 	bool sex_enabled_ = false;										// the subpopulation needs to have easy reference to whether its individuals are sexual or not
 	
@@ -371,6 +399,8 @@ public:
 	double FitnessOfParent(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks);
 	double FitnessOfParent_1CH_Diploid(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks);
 	double FitnessOfParent_1CH_Haploid(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks);
+	double FitnessOfParent_Precomputed(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks);
+	double ChromosomeFitnessOfParent(Individual *p_individual, Chromosome *p_chromosome, int p_first_haplosome_index);		// one chromosome, no callbacks
 	
 	template <const bool f_callbacks, const bool f_singlecallback>
 	double _Fitness_HaploidChromosome(Haplosome *haplosome, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks);
@@ -378,6 +408,11 @@ public:
 	double _Fitness_DiploidChromosome(Haplosome *haplosome1, Haplosome *haplosome2, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks);
 	
 	double ApplyMutationEffectCallbacks(MutationIndex p_mutation, int p_homozygous, double p_computed_fitness, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks, Individual *p_individual);
+	void RunVectorizedMutationEffectCallbacks(std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks, double (Subpopulation::*p_FitnessOfParent)(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks));
+	void ExecuteVectorizedMutationEffectCallback(SLiMEidosBlock *p_mutationEffect_callback, std::vector<size_t> &p_call_indices);
+	bool ExecuteVectorizedNativeCallback(SLiMEidosBlock *p_mutationEffect_callback, std::vector<size_t> &p_call_indices);
+	void EndVectorizedMutationEffectCallbacks(void);
+	bool PrecomputeFitnessEffectCallbacks(std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks, std::vector<SLiMEidosBlock*> &p_fitnessEffect_callbacks);
 	double ApplyFitnessEffectCallbacks(std::vector<SLiMEidosBlock*> &p_fitnessEffect_callbacks, slim_popsize_t p_individual_index);
 	
 	// generate newly allocated offspring individuals from parent individuals; these methods loop over
@@ -424,7 +459,7 @@ public:
 	void SwapChildAndParentHaplosomes(void);															// switch to the next generation by swapping; the children become the parents
 
 	// nonWF only:
-	void ApplyReproductionCallbacks(std::vector<SLiMEidosBlock*> &p_reproduction_callbacks, slim_popsize_t p_individual_index);
+	void ApplyReproductionCallbacks(std::vector<SLiMEidosBlock*> &p_reproduction_callbacks, std::vector<std::unique_ptr<EidosSymbolTable>> &p_callback_symbols, slim_popsize_t p_individual_index);
 	void ReproduceSubpopulation(void);
 	void MergeReproductionOffspring(void);
 	bool ApplySurvivalCallbacks(std::vector<SLiMEidosBlock*> &p_survival_callbacks, Individual *p_individual, double p_fitness, double p_draw, bool p_surviving);
@@ -460,6 +495,7 @@ public:
 	// nonWF only:
 	EidosValue_SP ExecuteMethod_addCloned(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_addCrossed(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
+	EidosValue_SP ExecuteMethod_addCrossedBatch(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_addEmpty(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_addMultiRecombinant(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_addRecombinant(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
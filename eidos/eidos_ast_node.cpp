@@ -20,6 +20,7 @@
 
 #include "eidos_ast_node.h"
 #include "eidos_interpreter.h"
+#include "eidos_bytecode.h"
 
 #include <string>
 #include <algorithm>
@@ -49,6 +50,12 @@ EidosASTNode::~EidosASTNode(void)
 		delete argument_cache_;
 		argument_cache_ = nullptr;
 	}
+	
+	if (bytecode_)
+	{
+		delete bytecode_;
+		bytecode_ = nullptr;
+	}
 }
 
 void EidosASTNode::AddChild(EidosASTNode *p_child_node)
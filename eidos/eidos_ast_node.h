@@ -31,6 +31,8 @@
 
 class EidosASTNode;
 class EidosInterpreter;
+class EidosBytecode;
+enum class EidosBytecodeState : uint8_t;
 
 
 // EidosASTNodes must be allocated out of the global pool, for speed.  See eidos_object_pool.h.  When Eidos disposes of a node,
@@ -91,6 +93,9 @@ public:
 	
 	mutable EidosASTNode_ArgumentCache *argument_cache_ = nullptr;		// OWNED POINTER: an argument cache struct, allocated on demand for function/method call nodes
 	
+	mutable EidosBytecode *bytecode_ = nullptr;							// OWNED POINTER: compiled bytecode for a block, allocated lazily on its root node; see eidos_bytecode.h
+	mutable EidosBytecodeState bytecode_state_ = (EidosBytecodeState)0;	// whether compilation to bytecode_ has been attempted, and its outcome
+	
 #if (SLIMPROFILING == 1)
 	// PROFILING
 	mutable eidos_profile_t profile_total_ = 0;							// profiling clock for this node and its children; only set for some nodes
@@ -0,0 +1,989 @@
+//
+//  eidos_bytecode.cpp
+//  Eidos
+//
+//  Created by Ben Haller on 10/16/26.
+//  Copyright (c) 2026 Benjamin C. Haller.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "eidos_bytecode.h"
+#include "eidos_ast_node.h"
+#include "eidos_symbol_table.h"
+#include "eidos_call_signature.h"
+#include "eidos_property_signature.h"
+#include "eidos_functions.h"
+#include "eidos_token.h"
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <climits>
+
+
+bool gEidosBytecodeEnabled = true;
+
+
+#pragma mark -
+#pragma mark EidosBytecodeCompiler
+#pragma mark -
+
+// EidosBytecodeCompiler does the work of EidosBytecode::CompileBlock().  Every Compile...() method returns false if the
+// code it is given cannot be compiled, in which case compilation of the whole block fails; there is no partial compilation.
+class EidosBytecodeCompiler
+{
+private:
+	EidosBytecode *bytecode_;
+	const EidosSymbolTable &symbols_;
+	std::vector<bool> local_typed_;			// true once the type of a local has been set by an assignment
+	int next_register_;						// the next free temporary register
+	
+	int LocalIndexForSymbol(EidosGlobalStringID p_symbol_id) const;
+	bool CollectLocals(const EidosASTNode *p_node);
+	
+	bool AllocateRegister(uint8_t *p_register);
+	void Emit(EidosBytecodeOp p_op, uint8_t p_dest, uint8_t p_a, uint8_t p_b, const EidosASTNode *p_node);
+	bool ConvertRegister(uint8_t *p_register, EidosBytecodeType p_from_type, EidosBytecodeType p_to_type);
+	
+	bool CompileStatement(const EidosASTNode *p_node);
+	bool CompileExpression(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type);
+	bool CompileIdentifier(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type);
+	bool CompileMemberRef(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type);
+	bool CompileArithmetic(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type);
+	bool CompileComparison(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type);
+	bool CompileLogical(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type);
+	bool CompileConditional(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type);
+	bool CompileCall(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type);
+	
+public:
+	EidosBytecodeCompiler(const EidosBytecodeCompiler&) = delete;
+	EidosBytecodeCompiler& operator=(const EidosBytecodeCompiler&) = delete;
+	EidosBytecodeCompiler(EidosBytecode *p_bytecode, const EidosSymbolTable &p_symbols) : bytecode_(p_bytecode), symbols_(p_symbols), next_register_(0) { }
+	
+	bool CompileBlock(const EidosASTNode *p_root_node);
+};
+
+int EidosBytecodeCompiler::LocalIndexForSymbol(EidosGlobalStringID p_symbol_id) const
+{
+	auto iter = std::find(bytecode_->local_ids_.begin(), bytecode_->local_ids_.end(), p_symbol_id);
+	
+	if (iter == bytecode_->local_ids_.end())
+		return -1;
+	
+	return (int)(iter - bytecode_->local_ids_.begin());
+}
+
+bool EidosBytecodeCompiler::CollectLocals(const EidosASTNode *p_node)
+{
+	// Find every variable assigned to by the block; these become locals, kept in registers.  We only look at statement-level
+	// nodes here, since assignments cannot occur inside expressions; anything else unsupported will be caught later.
+	switch (p_node->token_->token_type_)
+	{
+		case EidosTokenType::kTokenLBrace:
+		case EidosTokenType::kTokenInterpreterBlock:
+			for (const EidosASTNode *child : p_node->children_)
+				if (!CollectLocals(child))
+					return false;
+			return true;
+		case EidosTokenType::kTokenIf:
+			for (size_t child_index = 1; child_index < p_node->children_.size(); ++child_index)
+				if (!CollectLocals(p_node->children_[child_index]))
+					return false;
+			return true;
+		case EidosTokenType::kTokenAssign:
+		{
+			if (p_node->children_.size() != 2)
+				return false;
+			
+			const EidosASTNode *lvalue_node = p_node->children_[0];
+			
+			// only assignments to a simple identifier are supported; constants like T are excluded here too
+			if ((lvalue_node->token_->token_type_ != EidosTokenType::kTokenIdentifier) || lvalue_node->cached_literal_value_)
+				return false;
+			
+			EidosGlobalStringID symbol_id = lvalue_node->cached_stringID_;
+			
+			if (LocalIndexForSymbol(symbol_id) == -1)
+			{
+				if ((int)bytecode_->local_ids_.size() >= EidosBytecode::kMaxLocals)
+					return false;
+				
+				bytecode_->local_ids_.emplace_back(symbol_id);
+				bytecode_->local_types_.emplace_back(EidosBytecodeType::kInt);
+				local_typed_.emplace_back(false);
+			}
+			return true;
+		}
+		default:
+			return true;
+	}
+}
+
+bool EidosBytecodeCompiler::AllocateRegister(uint8_t *p_register)
+{
+	if (next_register_ >= EidosBytecode::kMaxRegisters)
+		return false;
+	
+	*p_register = (uint8_t)next_register_++;
+	bytecode_->register_count_ = std::max(bytecode_->register_count_, next_register_);
+	return true;
+}
+
+void EidosBytecodeCompiler::Emit(EidosBytecodeOp p_op, uint8_t p_dest, uint8_t p_a, uint8_t p_b, const EidosASTNode *p_node)
+{
+	EidosBytecodeInstruction instruction;
+	
+	instruction.op_ = p_op;
+	instruction.dest_ = p_dest;
+	instruction.a_ = p_a;
+	instruction.b_ = p_b;
+	instruction.int_ = 0;
+	instruction.node_ = p_node;
+	
+	bytecode_->instructions_.emplace_back(instruction);
+}
+
+bool EidosBytecodeCompiler::ConvertRegister(uint8_t *p_register, EidosBytecodeType p_from_type, EidosBytecodeType p_to_type)
+{
+	// Convert a value in place to a wider type, for promotion; the register is always a temporary, so it can be overwritten
+	if (p_from_type == p_to_type)
+		return true;
+	
+	if ((p_from_type == EidosBytecodeType::kInt) && (p_to_type == EidosBytecodeType::kFloat))
+		Emit(EidosBytecodeOp::kIntToFloat, *p_register, *p_register, 0, nullptr);
+	else if ((p_from_type == EidosBytecodeType::kLogical) && (p_to_type == EidosBytecodeType::kInt))
+		Emit(EidosBytecodeOp::kLogicalToInt, *p_register, *p_register, 0, nullptr);
+	else if ((p_from_type == EidosBytecodeType::kLogical) && (p_to_type == EidosBytecodeType::kFloat))
+		Emit(EidosBytecodeOp::kLogicalToFloat, *p_register, *p_register, 0, nullptr);
+	else
+		return false;
+	
+	return true;
+}
+
+bool EidosBytecodeCompiler::CompileBlock(const EidosASTNode *p_root_node)
+{
+	EidosTokenType root_type = p_root_node->token_->token_type_;
+	
+	if ((root_type != EidosTokenType::kTokenLBrace) && (root_type != EidosTokenType::kTokenInterpreterBlock))
+		return false;
+	
+	if (!CollectLocals(p_root_node))
+		return false;
+	
+	// locals occupy the first registers; temporaries are allocated above them
+	next_register_ = (int)bytecode_->local_ids_.size();
+	bytecode_->register_count_ = next_register_;
+	
+	for (const EidosASTNode *child : p_root_node->children_)
+		if (!CompileStatement(child))
+			return false;
+	
+	// falling off the end of a block returns void, as in Evaluate_CompoundStatement()
+	Emit(EidosBytecodeOp::kReturnVoid, 0, 0, 0, nullptr);
+	return true;
+}
+
+bool EidosBytecodeCompiler::CompileStatement(const EidosASTNode *p_node)
+{
+	int register_mark = next_register_;
+	
+	switch (p_node->token_->token_type_)
+	{
+		case EidosTokenType::kTokenSemicolon:
+			return true;
+		case EidosTokenType::kTokenLBrace:
+		{
+			for (const EidosASTNode *child : p_node->children_)
+				if (!CompileStatement(child))
+					return false;
+			return true;
+		}
+		case EidosTokenType::kTokenAssign:
+		{
+			int local_index = LocalIndexForSymbol(p_node->children_[0]->cached_stringID_);
+			uint8_t value_register;
+			EidosBytecodeType value_type;
+			
+			if (local_index == -1)
+				return false;
+			if (!CompileExpression(p_node->children_[1], &value_register, &value_type))
+				return false;
+			
+			// a local has a fixed type; the first assignment in the code determines it
+			if (!local_typed_[local_index])
+			{
+				bytecode_->local_types_[local_index] = value_type;
+				local_typed_[local_index] = true;
+			}
+			else if (bytecode_->local_types_[local_index] != value_type)
+				return false;
+			
+			Emit(EidosBytecodeOp::kStoreLocal, (uint8_t)local_index, value_register, 0, p_node);
+			next_register_ = register_mark;
+			return true;
+		}
+		case EidosTokenType::kTokenIf:
+		{
+			uint8_t condition_register;
+			EidosBytecodeType condition_type;
+			
+			if ((p_node->children_.size() < 2) || (p_node->children_.size() > 3))
+				return false;
+			if (!CompileExpression(p_node->children_[0], &condition_register, &condition_type))
+				return false;
+			if (condition_type != EidosBytecodeType::kLogical)
+				return false;
+			
+			size_t jump_false_index = bytecode_->instructions_.size();
+			Emit(EidosBytecodeOp::kJumpIfFalse, 0, condition_register, 0, p_node);
+			next_register_ = register_mark;
+			
+			if (!CompileStatement(p_node->children_[1]))
+				return false;
+			
+			if (p_node->children_.size() == 3)
+			{
+				size_t jump_end_index = bytecode_->instructions_.size();
+				Emit(EidosBytecodeOp::kJump, 0, 0, 0, p_node);
+				bytecode_->instructions_[jump_false_index].target_ = (int32_t)bytecode_->instructions_.size();
+				
+				if (!CompileStatement(p_node->children_[2]))
+					return false;
+				
+				bytecode_->instructions_[jump_end_index].target_ = (int32_t)bytecode_->instructions_.size();
+			}
+			else
+			{
+				bytecode_->instructions_[jump_false_index].target_ = (int32_t)bytecode_->instructions_.size();
+			}
+			return true;
+		}
+		case EidosTokenType::kTokenReturn:
+		{
+			if (p_node->children_.size() == 0)
+			{
+				Emit(EidosBytecodeOp::kReturnVoid, 0, 0, 0, p_node);
+				return true;
+			}
+			if (p_node->children_.size() != 1)
+				return false;
+			
+			uint8_t value_register;
+			EidosBytecodeType value_type;
+			
+			if (!CompileExpression(p_node->children_[0], &value_register, &value_type))
+				return false;
+			
+			switch (value_type)
+			{
+				case EidosBytecodeType::kInt:		Emit(EidosBytecodeOp::kReturnInt, 0, value_register, 0, p_node); break;
+				case EidosBytecodeType::kFloat:		Emit(EidosBytecodeOp::kReturnFloat, 0, value_register, 0, p_node); break;
+				case EidosBytecodeType::kLogical:	Emit(EidosBytecodeOp::kReturnLogical, 0, value_register, 0, p_node); break;
+			}
+			next_register_ = register_mark;
+			return true;
+		}
+		case EidosTokenType::kTokenFor:
+		case EidosTokenType::kTokenWhile:
+		case EidosTokenType::kTokenDo:
+		case EidosTokenType::kTokenNext:
+		case EidosTokenType::kTokenBreak:
+		case EidosTokenType::kTokenFunction:
+			return false;
+		default:
+		{
+			// an expression statement; its value is discarded, but it is evaluated for its guards
+			uint8_t value_register;
+			EidosBytecodeType value_type;
+			
+			if (!CompileExpression(p_node, &value_register, &value_type))
+				return false;
+			
+			next_register_ = register_mark;
+			return true;
+		}
+	}
+}
+
+bool EidosBytecodeCompiler::CompileExpression(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type)
+{
+	// numbers and constant identifiers like T and PI have a cached value; see EidosASTNode::_OptimizeConstants()
+	EidosValue *literal = p_node->cached_literal_value_.get();
+	
+	if (literal)
+	{
+		if ((literal->Count() != 1) || (literal->DimensionCount() != 1))
+			return false;
+		if (!AllocateRegister(p_register))
+			return false;
+		
+		switch (literal->Type())
+		{
+			case EidosValueType::kValueInt:
+				Emit(EidosBytecodeOp::kLoadConstInt, *p_register, 0, 0, p_node);
+				bytecode_->instructions_.back().int_ = literal->IntData()[0];
+				*p_type = EidosBytecodeType::kInt;
+				return true;
+			case EidosValueType::kValueFloat:
+				Emit(EidosBytecodeOp::kLoadConstFloat, *p_register, 0, 0, p_node);
+				bytecode_->instructions_.back().float_ = literal->FloatData()[0];
+				*p_type = EidosBytecodeType::kFloat;
+				return true;
+			case EidosValueType::kValueLogical:
+				Emit(EidosBytecodeOp::kLoadConstLogical, *p_register, 0, 0, p_node);
+				bytecode_->instructions_.back().logical_ = literal->LogicalData()[0];
+				*p_type = EidosBytecodeType::kLogical;
+				return true;
+			default:
+				return false;
+		}
+	}
+	
+	switch (p_node->token_->token_type_)
+	{
+		case EidosTokenType::kTokenIdentifier:
+			return CompileIdentifier(p_node, p_register, p_type);
+		case EidosTokenType::kTokenDot:
+			return CompileMemberRef(p_node, p_register, p_type);
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+		case EidosTokenType::kTokenMult:
+		case EidosTokenType::kTokenDiv:
+		case EidosTokenType::kTokenMod:
+		case EidosTokenType::kTokenExp:
+			return CompileArithmetic(p_node, p_register, p_type);
+		case EidosTokenType::kTokenEq:
+		case EidosTokenType::kTokenNotEq:
+		case EidosTokenType::kTokenLt:
+		case EidosTokenType::kTokenLtEq:
+		case EidosTokenType::kTokenGt:
+		case EidosTokenType::kTokenGtEq:
+			return CompileComparison(p_node, p_register, p_type);
+		case EidosTokenType::kTokenAnd:
+		case EidosTokenType::kTokenOr:
+		case EidosTokenType::kTokenNot:
+			return CompileLogical(p_node, p_register, p_type);
+		case EidosTokenType::kTokenConditional:
+			return CompileConditional(p_node, p_register, p_type);
+		case EidosTokenType::kTokenLParen:
+			return CompileCall(p_node, p_register, p_type);
+		default:
+			return false;
+	}
+}
+
+bool EidosBytecodeCompiler::CompileIdentifier(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type)
+{
+	EidosGlobalStringID symbol_id = p_node->cached_stringID_;
+	int local_index = LocalIndexForSymbol(symbol_id);
+	
+	if (local_index != -1)
+	{
+		// a local must have been typed by an earlier assignment; whether it has actually been assigned is checked at runtime
+		if (!local_typed_[local_index])
+			return false;
+		if (!AllocateRegister(p_register))
+			return false;
+		
+		Emit(EidosBytecodeOp::kLoadLocal, *p_register, (uint8_t)local_index, 0, p_node);
+		*p_type = bytecode_->local_types_[local_index];
+		return true;
+	}
+	
+	// otherwise the symbol comes from the symbol table, and we specialize to the type it has now
+	EidosValue *value = symbols_.GetValueRawOrNullForSymbol(symbol_id);
+	
+	if (!value || (value->Count() != 1) || (value->DimensionCount() != 1))
+		return false;
+	if (!AllocateRegister(p_register))
+		return false;
+	
+	switch (value->Type())
+	{
+		case EidosValueType::kValueInt:		Emit(EidosBytecodeOp::kLoadSymbolInt, *p_register, 0, 0, p_node); *p_type = EidosBytecodeType::kInt; break;
+		case EidosValueType::kValueFloat:	Emit(EidosBytecodeOp::kLoadSymbolFloat, *p_register, 0, 0, p_node); *p_type = EidosBytecodeType::kFloat; break;
+		case EidosValueType::kValueLogical:	Emit(EidosBytecodeOp::kLoadSymbolLogical, *p_register, 0, 0, p_node); *p_type = EidosBytecodeType::kLogical; break;
+		default: return false;
+	}
+	
+	bytecode_->instructions_.back().ids_.symbol_ = symbol_id;
+	return true;
+}
+
+bool EidosBytecodeCompiler::CompileMemberRef(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type)
+{
+	// only <identifier>.<property> is supported, where <identifier> is a singleton object and <property> is singleton int/float/logical
+	if (p_node->children_.size() != 2)
+		return false;
+	
+	const EidosASTNode *object_node = p_node->children_[0];
+	const EidosASTNode *property_node = p_node->children_[1];
+	
+	if ((object_node->token_->token_type_ != EidosTokenType::kTokenIdentifier) || object_node->cached_literal_value_)
+		return false;
+	if (property_node->token_->token_type_ != EidosTokenType::kTokenIdentifier)
+		return false;
+	if (LocalIndexForSymbol(object_node->cached_stringID_) != -1)
+		return false;
+	
+	EidosValue *value = symbols_.GetValueRawOrNullForSymbol(object_node->cached_stringID_);
+	
+	if (!value || (value->Type() != EidosValueType::kValueObject) || (value->Count() != 1) || (value->DimensionCount() != 1))
+		return false;
+	
+	const EidosClass *object_class = static_cast<EidosValue_Object *>(value)->Class();
+	const EidosPropertySignature *signature = object_class->SignatureForProperty(property_node->cached_stringID_);
+	
+	if (!signature || !(signature->value_mask_ & kEidosValueMaskSingleton))
+		return false;
+	if (!AllocateRegister(p_register))
+		return false;
+	
+	switch (signature->value_mask_ & kEidosValueMaskFlagStrip)
+	{
+		case kEidosValueMaskInt:		Emit(EidosBytecodeOp::kLoadPropertyInt, *p_register, 0, 0, p_node); *p_type = EidosBytecodeType::kInt; break;
+		case kEidosValueMaskFloat:		Emit(EidosBytecodeOp::kLoadPropertyFloat, *p_register, 0, 0, p_node); *p_type = EidosBytecodeType::kFloat; break;
+		case kEidosValueMaskLogical:	Emit(EidosBytecodeOp::kLoadPropertyLogical, *p_register, 0, 0, p_node); *p_type = EidosBytecodeType::kLogical; break;
+		default: return false;
+	}
+	
+	EidosBytecodeInstruction &instruction = bytecode_->instructions_.back();
+	
+	instruction.ids_.symbol_ = object_node->cached_stringID_;
+	instruction.ids_.property_ = property_node->cached_stringID_;
+	instruction.ids_.class_ = object_class;
+	return true;
+}
+
+bool EidosBytecodeCompiler::CompileArithmetic(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type)
+{
+	EidosTokenType token_type = p_node->token_->token_type_;
+	int register_mark = next_register_;
+	
+	// arithmetic operators accept only integer and float operands; logical operands are an error, left to the AST walker
+	if (p_node->children_.size() == 1)
+	{
+		if ((token_type != EidosTokenType::kTokenPlus) && (token_type != EidosTokenType::kTokenMinus))
+			return false;
+		
+		uint8_t operand_register;
+		EidosBytecodeType operand_type;
+		
+		if (!CompileExpression(p_node->children_[0], &operand_register, &operand_type))
+			return false;
+		if (operand_type == EidosBytecodeType::kLogical)
+			return false;
+		
+		if (token_type == EidosTokenType::kTokenPlus)
+		{
+			*p_register = operand_register;
+			*p_type = operand_type;
+			return true;
+		}
+		
+		next_register_ = register_mark;
+		AllocateRegister(p_register);
+		Emit((operand_type == EidosBytecodeType::kInt) ? EidosBytecodeOp::kNegInt : EidosBytecodeOp::kNegFloat, *p_register, operand_register, 0, p_node);
+		*p_type = operand_type;
+		return true;
+	}
+	
+	if (p_node->children_.size() != 2)
+		return false;
+	
+	uint8_t first_register, second_register;
+	EidosBytecodeType first_type, second_type;
+	
+	if (!CompileExpression(p_node->children_[0], &first_register, &first_type))
+		return false;
+	if (!CompileExpression(p_node->children_[1], &second_register, &second_type))
+		return false;
+	if ((first_type == EidosBytecodeType::kLogical) || (second_type == EidosBytecodeType::kLogical))
+		return false;
+	
+	// +, -, and * on two integers produce an integer, with overflow checks; everything else is done in float
+	bool integer_result = ((first_type == EidosBytecodeType::kInt) && (second_type == EidosBytecodeType::kInt) &&
+						   ((token_type == EidosTokenType::kTokenPlus) || (token_type == EidosTokenType::kTokenMinus) || (token_type == EidosTokenType::kTokenMult)));
+	EidosBytecodeOp op;
+	
+	if (integer_result)
+	{
+		switch (token_type)
+		{
+			case EidosTokenType::kTokenPlus:	op = EidosBytecodeOp::kAddInt; break;
+			case EidosTokenType::kTokenMinus:	op = EidosBytecodeOp::kSubInt; break;
+			default:							op = EidosBytecodeOp::kMultInt; break;
+		}
+	}
+	else
+	{
+		ConvertRegister(&first_register, first_type, EidosBytecodeType::kFloat);
+		ConvertRegister(&second_register, second_type, EidosBytecodeType::kFloat);
+		
+		switch (token_type)
+		{
+			case EidosTokenType::kTokenPlus:	op = EidosBytecodeOp::kAddFloat; break;
+			case EidosTokenType::kTokenMinus:	op = EidosBytecodeOp::kSubFloat; break;
+			case EidosTokenType::kTokenMult:	op = EidosBytecodeOp::kMultFloat; break;
+			case EidosTokenType::kTokenDiv:		op = EidosBytecodeOp::kDivFloat; break;
+			case EidosTokenType::kTokenMod:		op = EidosBytecodeOp::kModFloat; break;
+			default:							op = EidosBytecodeOp::kExpFloat; break;
+		}
+	}
+	
+	next_register_ = register_mark;
+	AllocateRegister(p_register);
+	Emit(op, *p_register, first_register, second_register, p_node);
+	*p_type = (integer_result ? EidosBytecodeType::kInt : EidosBytecodeType::kFloat);
+	return true;
+}
+
+bool EidosBytecodeCompiler::CompileComparison(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type)
+{
+	int register_mark = next_register_;
+	
+	if (p_node->children_.size() != 2)
+		return false;
+	
+	uint8_t first_register, second_register;
+	EidosBytecodeType first_type, second_type;
+	
+	if (!CompileExpression(p_node->children_[0], &first_register, &first_type))
+		return false;
+	if (!CompileExpression(p_node->children_[1], &second_register, &second_type))
+		return false;
+	
+	// comparisons promote to the higher type, as in EidosTypeForPromotion(); logical is compared as integer, which is equivalent
+	bool float_comparison = ((first_type == EidosBytecodeType::kFloat) || (second_type == EidosBytecodeType::kFloat));
+	EidosBytecodeType comparison_type = (float_comparison ? EidosBytecodeType::kFloat : EidosBytecodeType::kInt);
+	EidosBytecodeOp op;
+	
+	ConvertRegister(&first_register, first_type, comparison_type);
+	ConvertRegister(&second_register, second_type, comparison_type);
+	
+	switch (p_node->token_->token_type_)
+	{
+		case EidosTokenType::kTokenEq:		op = (float_comparison ? EidosBytecodeOp::kEqFloat : EidosBytecodeOp::kEqInt); break;
+		case EidosTokenType::kTokenNotEq:	op = (float_comparison ? EidosBytecodeOp::kNotEqFloat : EidosBytecodeOp::kNotEqInt); break;
+		case EidosTokenType::kTokenLt:		op = (float_comparison ? EidosBytecodeOp::kLtFloat : EidosBytecodeOp::kLtInt); break;
+		case EidosTokenType::kTokenLtEq:	op = (float_comparison ? EidosBytecodeOp::kLtEqFloat : EidosBytecodeOp::kLtEqInt); break;
+		case EidosTokenType::kTokenGt:		op = (float_comparison ? EidosBytecodeOp::kGtFloat : EidosBytecodeOp::kGtInt); break;
+		default:							op = (float_comparison ? EidosBytecodeOp::kGtEqFloat : EidosBytecodeOp::kGtEqInt); break;
+	}
+	
+	next_register_ = register_mark;
+	AllocateRegister(p_register);
+	Emit(op, *p_register, first_register, second_register, p_node);
+	*p_type = EidosBytecodeType::kLogical;
+	return true;
+}
+
+bool EidosBytecodeCompiler::CompileLogical(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type)
+{
+	EidosTokenType token_type = p_node->token_->token_type_;
+	int register_mark = next_register_;
+	
+	// only logical operands are supported; Eidos would coerce integer and float operands, but that is left to the AST walker
+	if (token_type == EidosTokenType::kTokenNot)
+	{
+		uint8_t operand_register;
+		EidosBytecodeType operand_type;
+		
+		if (p_node->children_.size() != 1)
+			return false;
+		if (!CompileExpression(p_node->children_[0], &operand_register, &operand_type))
+			return false;
+		if (operand_type != EidosBytecodeType::kLogical)
+			return false;
+		
+		next_register_ = register_mark;
+		AllocateRegister(p_register);
+		Emit(EidosBytecodeOp::kNot, *p_register, operand_register, 0, p_node);
+		*p_type = EidosBytecodeType::kLogical;
+		return true;
+	}
+	
+	// & and | can have any number of operands; all of them are evaluated, since Eidos does not short-circuit these operators
+	if (p_node->children_.size() < 2)
+		return false;
+	
+	EidosBytecodeOp op = ((token_type == EidosTokenType::kTokenAnd) ? EidosBytecodeOp::kAnd : EidosBytecodeOp::kOr);
+	uint8_t result_register;
+	EidosBytecodeType operand_type;
+	
+	if (!CompileExpression(p_node->children_[0], &result_register, &operand_type))
+		return false;
+	if (operand_type != EidosBytecodeType::kLogical)
+		return false;
+	
+	for (size_t child_index = 1; child_index < p_node->children_.size(); ++child_index)
+	{
+		uint8_t operand_register;
+		
+		if (!CompileExpression(p_node->children_[child_index], &operand_register, &operand_type))
+			return false;
+		if (operand_type != EidosBytecodeType::kLogical)
+			return false;
+		
+		// accumulate into a register allocated at register_mark, which is above any local register
+		next_register_ = register_mark;
+		AllocateRegister(p_register);
+		Emit(op, *p_register, result_register, operand_register, p_node);
+		result_register = *p_register;
+	}
+	
+	*p_type = EidosBytecodeType::kLogical;
+	return true;
+}
+
+bool EidosBytecodeCompiler::CompileConditional(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type)
+{
+	int register_mark = next_register_;
+	
+	if (p_node->children_.size() != 3)
+		return false;
+	
+	uint8_t condition_register, result_register, branch_register;
+	EidosBytecodeType condition_type, true_type, false_type;
+	
+	// the result register is allocated first, so that both branches can move their values into it
+	if (!AllocateRegister(&result_register))
+		return false;
+	if (!CompileExpression(p_node->children_[0], &condition_register, &condition_type))
+		return false;
+	if (condition_type != EidosBytecodeType::kLogical)
+		return false;
+	
+	size_t jump_false_index = bytecode_->instructions_.size();
+	Emit(EidosBytecodeOp::kJumpIfFalse, 0, condition_register, 0, p_node);
+	next_register_ = register_mark + 1;
+	
+	if (!CompileExpression(p_node->children_[1], &branch_register, &true_type))
+		return false;
+	Emit(EidosBytecodeOp::kMove, result_register, branch_register, 0, p_node);
+	next_register_ = register_mark + 1;
+	
+	size_t jump_end_index = bytecode_->instructions_.size();
+	Emit(EidosBytecodeOp::kJump, 0, 0, 0, p_node);
+	bytecode_->instructions_[jump_false_index].target_ = (int32_t)bytecode_->instructions_.size();
+	
+	if (!CompileExpression(p_node->children_[2], &branch_register, &false_type))
+		return false;
+	Emit(EidosBytecodeOp::kMove, result_register, branch_register, 0, p_node);
+	next_register_ = register_mark + 1;
+	
+	bytecode_->instructions_[jump_end_index].target_ = (int32_t)bytecode_->instructions_.size();
+	
+	// the two branches must agree on type, since the result register has a single type
+	if (true_type != false_type)
+		return false;
+	
+	*p_register = result_register;
+	*p_type = true_type;
+	return true;
+}
+
+bool EidosBytecodeCompiler::CompileCall(const EidosASTNode *p_node, uint8_t *p_register, EidosBytecodeType *p_type)
+{
+	int register_mark = next_register_;
+	
+	// only a few built-in math functions with a single, unnamed argument are supported
+	if (p_node->children_.size() != 2)
+		return false;
+	
+	const EidosASTNode *call_name_node = p_node->children_[0];
+	const EidosASTNode *argument_node = p_node->children_[1];
+	const EidosFunctionSignature *signature = call_name_node->cached_signature_.get();
+	
+	if (!signature || (argument_node->token_->token_type_ == EidosTokenType::kTokenAssign))
+		return false;
+	
+	EidosInternalFunctionPtr function = signature->internal_function_;
+	
+	if ((function != &Eidos_ExecuteFunction_exp) && (function != &Eidos_ExecuteFunction_log) && (function != &Eidos_ExecuteFunction_sqrt) && (function != &Eidos_ExecuteFunction_abs))
+		return false;
+	
+	uint8_t argument_register;
+	EidosBytecodeType argument_type;
+	EidosBytecodeOp op;
+	
+	if (!CompileExpression(argument_node, &argument_register, &argument_type))
+		return false;
+	if (argument_type == EidosBytecodeType::kLogical)
+		return false;
+	
+	if (function == &Eidos_ExecuteFunction_abs)
+	{
+		// abs() preserves the type of its argument
+		op = ((argument_type == EidosBytecodeType::kInt) ? EidosBytecodeOp::kCallAbsInt : EidosBytecodeOp::kCallAbsFloat);
+		*p_type = argument_type;
+	}
+	else
+	{
+		ConvertRegister(&argument_register, argument_type, EidosBytecodeType::kFloat);
+		
+		if (function == &Eidos_ExecuteFunction_exp)			op = EidosBytecodeOp::kCallExp;
+		else if (function == &Eidos_ExecuteFunction_log)	op = EidosBytecodeOp::kCallLog;
+		else												op = EidosBytecodeOp::kCallSqrt;
+		*p_type = EidosBytecodeType::kFloat;
+	}
+	
+	next_register_ = register_mark;
+	AllocateRegister(p_register);
+	Emit(op, *p_register, argument_register, 0, p_node);
+	return true;
+}
+
+
+#pragma mark -
+#pragma mark EidosBytecode
+#pragma mark -
+
+EidosBytecode *EidosBytecode::CompileBlock(const EidosASTNode *p_root_node, const EidosSymbolTable &p_symbols)
+{
+	EidosBytecode *bytecode = new EidosBytecode();
+	EidosBytecodeCompiler compiler(bytecode, p_symbols);
+	
+	if (!compiler.CompileBlock(p_root_node))
+	{
+		delete bytecode;
+		return nullptr;
+	}
+	
+	bytecode->instructions_.shrink_to_fit();
+	return bytecode;
+}
+
+bool EidosBytecode::Execute(EidosSymbolTable &p_symbols, EidosValue_SP *p_result)
+{
+	// Locals are kept in registers, so they must not already be defined; otherwise an assignment might redefine a constant,
+	// and a use of the variable before its first assignment would refer to the existing value.  The AST walker handles that.
+	for (EidosGlobalStringID local_id : local_ids_)
+		if (p_symbols.GetValueRawOrNullForSymbol(local_id))
+		{
+			bailout_count_++;
+			return false;
+		}
+	
+	EidosBytecodeRegister registers[kMaxRegisters];
+	uint64_t assigned_locals = 0;
+	const EidosBytecodeInstruction *instructions = instructions_.data();
+	const EidosBytecodeInstruction *instruction = instructions;
+	EidosValue_SP result_SP;
+	
+	while (true)
+	{
+		switch (instruction->op_)
+		{
+			case EidosBytecodeOp::kLoadConstInt:		registers[instruction->dest_].int_ = instruction->int_; break;
+			case EidosBytecodeOp::kLoadConstFloat:		registers[instruction->dest_].float_ = instruction->float_; break;
+			case EidosBytecodeOp::kLoadConstLogical:	registers[instruction->dest_].logical_ = instruction->logical_; break;
+			
+			case EidosBytecodeOp::kLoadSymbolInt:
+			{
+				EidosValue *value = p_symbols.GetValueRawOrNullForSymbol(instruction->ids_.symbol_);
+				
+				if (!value || (value->Type() != EidosValueType::kValueInt) || (value->Count() != 1) || (value->DimensionCount() != 1))
+					goto bailout;
+				
+				registers[instruction->dest_].int_ = value->IntData()[0];
+				break;
+			}
+			case EidosBytecodeOp::kLoadSymbolFloat:
+			{
+				EidosValue *value = p_symbols.GetValueRawOrNullForSymbol(instruction->ids_.symbol_);
+				
+				if (!value || (value->Type() != EidosValueType::kValueFloat) || (value->Count() != 1) || (value->DimensionCount() != 1))
+					goto bailout;
+				
+				registers[instruction->dest_].float_ = value->FloatData()[0];
+				break;
+			}
+			case EidosBytecodeOp::kLoadSymbolLogical:
+			{
+				EidosValue *value = p_symbols.GetValueRawOrNullForSymbol(instruction->ids_.symbol_);
+				
+				if (!value || (value->Type() != EidosValueType::kValueLogical) || (value->Count() != 1) || (value->DimensionCount() != 1))
+					goto bailout;
+				
+				registers[instruction->dest_].logical_ = value->LogicalData()[0];
+				break;
+			}
+			case EidosBytecodeOp::kLoadPropertyInt:
+			case EidosBytecodeOp::kLoadPropertyFloat:
+			case EidosBytecodeOp::kLoadPropertyLogical:
+			{
+				EidosValue *value = p_symbols.GetValueRawOrNullForSymbol(instruction->ids_.symbol_);
+				
+				if (!value || (value->Type() != EidosValueType::kValueObject) || (value->Count() != 1) || (value->DimensionCount() != 1))
+					goto bailout;
+				
+				EidosValue_Object *object_value = static_cast<EidosValue_Object *>(value);
+				
+				if (object_value->Class() != instruction->ids_.class_)
+					goto bailout;
+				
+				// a property getter can raise, so set up the error position as Evaluate_MemberRef() does
+				EidosErrorPosition error_pos_save = PushErrorPositionFromToken(instruction->node_->children_[1]->token_);
+				EidosValue_SP property_value = object_value->data()[0]->GetProperty(instruction->ids_.property_);
+				RestoreErrorPosition(error_pos_save);
+				
+				if (property_value->Count() != 1)
+					goto bailout;
+				
+				EidosValueType property_type = property_value->Type();
+				
+				if ((instruction->op_ == EidosBytecodeOp::kLoadPropertyInt) && (property_type == EidosValueType::kValueInt))
+					registers[instruction->dest_].int_ = property_value->IntData()[0];
+				else if ((instruction->op_ == EidosBytecodeOp::kLoadPropertyFloat) && (property_type == EidosValueType::kValueFloat))
+					registers[instruction->dest_].float_ = property_value->FloatData()[0];
+				else if ((instruction->op_ == EidosBytecodeOp::kLoadPropertyLogical) && (property_type == EidosValueType::kValueLogical))
+					registers[instruction->dest_].logical_ = property_value->LogicalData()[0];
+				else
+					goto bailout;
+				break;
+			}
+			case EidosBytecodeOp::kLoadLocal:
+				if (!(assigned_locals & (((uint64_t)1) << instruction->a_)))
+					goto bailout;
+				registers[instruction->dest_] = registers[instruction->a_];
+				break;
+			case EidosBytecodeOp::kStoreLocal:
+				registers[instruction->dest_] = registers[instruction->a_];
+				assigned_locals |= (((uint64_t)1) << instruction->dest_);
+				break;
+			case EidosBytecodeOp::kMove:
+				registers[instruction->dest_] = registers[instruction->a_];
+				break;
+			
+			case EidosBytecodeOp::kIntToFloat:		registers[instruction->dest_].float_ = (double)registers[instruction->a_].int_; break;
+			case EidosBytecodeOp::kLogicalToInt:	registers[instruction->dest_].int_ = (int64_t)registers[instruction->a_].logical_; break;
+			case EidosBytecodeOp::kLogicalToFloat:	registers[instruction->dest_].float_ = (double)registers[instruction->a_].logical_; break;
+			
+			case EidosBytecodeOp::kAddInt:
+				if (Eidos_add_overflow(registers[instruction->a_].int_, registers[instruction->b_].int_, &registers[instruction->dest_].int_))
+					goto bailout;
+				break;
+			case EidosBytecodeOp::kSubInt:
+				if (Eidos_sub_overflow(registers[instruction->a_].int_, registers[instruction->b_].int_, &registers[instruction->dest_].int_))
+					goto bailout;
+				break;
+			case EidosBytecodeOp::kMultInt:
+				if (Eidos_mul_overflow(registers[instruction->a_].int_, registers[instruction->b_].int_, &registers[instruction->dest_].int_))
+					goto bailout;
+				break;
+			case EidosBytecodeOp::kNegInt:
+				if (Eidos_sub_overflow((int64_t)0, registers[instruction->a_].int_, &registers[instruction->dest_].int_))
+					goto bailout;
+				break;
+			case EidosBytecodeOp::kAddFloat:	registers[instruction->dest_].float_ = registers[instruction->a_].float_ + registers[instruction->b_].float_; break;
+			case EidosBytecodeOp::kSubFloat:	registers[instruction->dest_].float_ = registers[instruction->a_].float_ - registers[instruction->b_].float_; break;
+			case EidosBytecodeOp::kMultFloat:	registers[instruction->dest_].float_ = registers[instruction->a_].float_ * registers[instruction->b_].float_; break;
+			case EidosBytecodeOp::kDivFloat:	registers[instruction->dest_].float_ = registers[instruction->a_].float_ / registers[instruction->b_].float_; break;
+			case EidosBytecodeOp::kModFloat:	registers[instruction->dest_].float_ = fmod(registers[instruction->a_].float_, registers[instruction->b_].float_); break;
+			case EidosBytecodeOp::kExpFloat:	registers[instruction->dest_].float_ = pow(registers[instruction->a_].float_, registers[instruction->b_].float_); break;
+			case EidosBytecodeOp::kNegFloat:	registers[instruction->dest_].float_ = -registers[instruction->a_].float_; break;
+			
+			case EidosBytecodeOp::kEqInt:		registers[instruction->dest_].logical_ = (registers[instruction->a_].int_ == registers[instruction->b_].int_); break;
+			case EidosBytecodeOp::kNotEqInt:	registers[instruction->dest_].logical_ = (registers[instruction->a_].int_ != registers[instruction->b_].int_); break;
+			case EidosBytecodeOp::kLtInt:		registers[instruction->dest_].logical_ = (registers[instruction->a_].int_ < registers[instruction->b_].int_); break;
+			case EidosBytecodeOp::kLtEqInt:		registers[instruction->dest_].logical_ = (registers[instruction->a_].int_ <= registers[instruction->b_].int_); break;
+			case EidosBytecodeOp::kGtInt:		registers[instruction->dest_].logical_ = (registers[instruction->a_].int_ > registers[instruction->b_].int_); break;
+			case EidosBytecodeOp::kGtEqInt:		registers[instruction->dest_].logical_ = (registers[instruction->a_].int_ >= registers[instruction->b_].int_); break;
+			case EidosBytecodeOp::kEqFloat:		registers[instruction->dest_].logical_ = (registers[instruction->a_].float_ == registers[instruction->b_].float_); break;
+			case EidosBytecodeOp::kNotEqFloat:	registers[instruction->dest_].logical_ = (registers[instruction->a_].float_ != registers[instruction->b_].float_); break;
+			case EidosBytecodeOp::kLtFloat:		registers[instruction->dest_].logical_ = (registers[instruction->a_].float_ < registers[instruction->b_].float_); break;
+			case EidosBytecodeOp::kLtEqFloat:	registers[instruction->dest_].logical_ = (registers[instruction->a_].float_ <= registers[instruction->b_].float_); break;
+			case EidosBytecodeOp::kGtFloat:		registers[instruction->dest_].logical_ = (registers[instruction->a_].float_ > registers[instruction->b_].float_); break;
+			case EidosBytecodeOp::kGtEqFloat:	registers[instruction->dest_].logical_ = (registers[instruction->a_].float_ >= registers[instruction->b_].float_); break;
+			
+			case EidosBytecodeOp::kAnd:		registers[instruction->dest_].logical_ = (registers[instruction->a_].logical_ && registers[instruction->b_].logical_); break;
+			case EidosBytecodeOp::kOr:		registers[instruction->dest_].logical_ = (registers[instruction->a_].logical_ || registers[instruction->b_].logical_); break;
+			case EidosBytecodeOp::kNot:		registers[instruction->dest_].logical_ = !registers[instruction->a_].logical_; break;
+			
+			case EidosBytecodeOp::kCallExp:			registers[instruction->dest_].float_ = exp(registers[instruction->a_].float_); break;
+			case EidosBytecodeOp::kCallLog:			registers[instruction->dest_].float_ = log(registers[instruction->a_].float_); break;
+			case EidosBytecodeOp::kCallSqrt:		registers[instruction->dest_].float_ = sqrt(registers[instruction->a_].float_); break;
+			case EidosBytecodeOp::kCallAbsFloat:	registers[instruction->dest_].float_ = fabs(registers[instruction->a_].float_); break;
+			case EidosBytecodeOp::kCallAbsInt:
+			{
+				// the absolute value of INT64_MIN cannot be represented in int64_t, which abs() raises for
+				int64_t operand = registers[instruction->a_].int_;
+				
+				if (operand == INT64_MIN)
+					goto bailout;
+				
+				registers[instruction->dest_].int_ = llabs(operand);
+				break;
+			}
+			
+			case EidosBytecodeOp::kJump:
+				instruction = instructions + instruction->target_;
+				continue;
+			case EidosBytecodeOp::kJumpIfFalse:
+				if (!registers[instruction->a_].logical_)
+				{
+					instruction = instructions + instruction->target_;
+					continue;
+				}
+				break;
+			
+			case EidosBytecodeOp::kReturnInt:
+				result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(registers[instruction->a_].int_));
+				goto finish;
+			case EidosBytecodeOp::kReturnFloat:
+				result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(registers[instruction->a_].float_));
+				goto finish;
+			case EidosBytecodeOp::kReturnLogical:
+				result_SP = (registers[instruction->a_].logical_ ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+				goto finish;
+			case EidosBytecodeOp::kReturnVoid:
+				result_SP = gStaticEidosValueVOID;
+				goto finish;
+		}
+		
+		instruction++;
+	}
+	
+finish:
+	// a return statement leaves the error position at its token, as Evaluate_Return() does
+	if (instruction->node_)
+		PushErrorPositionFromToken(instruction->node_->token_);
+	
+	// define the locals that were assigned, as the AST walker would have done
+	for (size_t local_index = 0; local_index < local_ids_.size(); ++local_index)
+	{
+		if (assigned_locals & (((uint64_t)1) << local_index))
+		{
+			EidosBytecodeRegister value = registers[local_index];
+			
+			switch (local_types_[local_index])
+			{
+				case EidosBytecodeType::kInt:		p_symbols.SetValueForSymbol(local_ids_[local_index], EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(value.int_))); break;
+				case EidosBytecodeType::kFloat:		p_symbols.SetValueForSymbol(local_ids_[local_index], EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(value.float_))); break;
+				case EidosBytecodeType::kLogical:	p_symbols.SetValueForSymbol(local_ids_[local_index], (value.logical_ ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF)); break;
+			}
+		}
+	}
+	
+	execution_count_++;
+	*p_result = std::move(result_SP);
+	return true;
+	
+bailout:
+	bailout_count_++;
+	return false;
+}
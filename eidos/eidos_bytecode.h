@@ -0,0 +1,193 @@
+//
+//  eidos_bytecode.h
+//  Eidos
+//
+//  Created by Ben Haller on 10/16/26.
+//  Copyright (c) 2026 Benjamin C. Haller.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+
+ EidosBytecode is a compact register-based form of a block of Eidos code, compiled from its AST, that can be executed
+ much faster than the AST can be walked by EidosInterpreter.  Only a small subset of Eidos is supported: statements
+ that are assignments to simple local variables, if/else, and return, over expressions built from singleton integer,
+ float, and logical values -- literals, variables, properties of singleton objects (x.y), arithmetic, comparisons,
+ &, |, !, and the exp(), log(), sqrt(), and abs() functions.  This subset covers the bodies of many callbacks (such as
+ mutationEffect() and fitnessEffect() callbacks) and small user-defined functions, which often run millions of times
+ per tick.  A block that uses anything outside the subset is simply not compiled, and is walked by EidosInterpreter.
+
+ Compilation is done lazily, the first time a block is executed, because the types of the variables and properties
+ referenced by the block are taken from the symbol table at that time; the compiled code is type-specialized to those
+ types, and each load is guarded by a check that the type is still as expected.  If any guard fails at runtime, or if
+ anything happens that the bytecode does not handle (such as integer overflow, which raises an error in Eidos), the
+ execution of the bytecode is abandoned and the block is walked by EidosInterpreter from the beginning instead.  That
+ is safe because the supported subset has no side effects other than setting local variables, which the bytecode keeps
+ in its own registers and defines in the symbol table only once it has completed.  This means that errors are raised by
+ the AST walker, with the usual error messages and positions; the one exception is an error raised by a property getter,
+ which the bytecode reports exactly as the AST walker would.  If the guards fail frequently, the block is marked as not
+ compilable.
+
+ The bytecode is owned by the root AST node of the block; see EidosASTNode::bytecode_.  Bytecode execution can be
+ turned off with gEidosBytecodeEnabled (the -noBytecode command-line option to slim), for comparison.
+
+ */
+
+#ifndef __Eidos__eidos_bytecode__
+#define __Eidos__eidos_bytecode__
+
+#include <vector>
+#include <cstdint>
+
+#include "eidos_value.h"
+
+
+class EidosASTNode;
+class EidosSymbolTable;
+class EidosClass;
+
+
+// If false, blocks are never compiled to bytecode, and all code is executed by walking the AST; set by -noBytecode in slim
+extern bool gEidosBytecodeEnabled;
+
+
+// The state of bytecode compilation for an AST node, kept in EidosASTNode::bytecode_state_
+enum class EidosBytecodeState : uint8_t {
+	kNotCompiled = 0,		// compilation has not yet been attempted
+	kCompiled,				// compilation succeeded; EidosASTNode::bytecode_ is valid
+	kNotCompilable			// compilation failed, or the compiled code bailed out too often; walk the AST
+};
+
+// The static type of a bytecode register; registers hold only singleton values
+enum class EidosBytecodeType : uint8_t {
+	kInt = 0,
+	kFloat,
+	kLogical
+};
+
+enum class EidosBytecodeOp : uint8_t {
+	kLoadConstInt = 0,		// dest = int_
+	kLoadConstFloat,		// dest = float_
+	kLoadConstLogical,		// dest = logical_
+	kLoadSymbolInt,			// dest = symbol, guarded to be a singleton int
+	kLoadSymbolFloat,		// dest = symbol, guarded to be a singleton float
+	kLoadSymbolLogical,		// dest = symbol, guarded to be a singleton logical
+	kLoadPropertyInt,		// dest = symbol.property, guarded to be a singleton object with a singleton int property value
+	kLoadPropertyFloat,		// dest = symbol.property, guarded to be a singleton object with a singleton float property value
+	kLoadPropertyLogical,	// dest = symbol.property, guarded to be a singleton object with a singleton logical property value
+	kLoadLocal,				// dest = local a, guarded that local a has been assigned
+	kStoreLocal,			// local dest = a, marking local dest as assigned
+	kMove,					// dest = a
+	
+	kIntToFloat,			// dest = (double)a
+	kLogicalToInt,			// dest = (int64_t)a
+	kLogicalToFloat,		// dest = (double)a
+	
+	kAddInt,				// dest = a + b, bailing out on overflow
+	kSubInt,				// dest = a - b, bailing out on overflow
+	kMultInt,				// dest = a * b, bailing out on overflow
+	kNegInt,				// dest = -a, bailing out on overflow
+	kAddFloat,				// dest = a + b
+	kSubFloat,				// dest = a - b
+	kMultFloat,				// dest = a * b
+	kDivFloat,				// dest = a / b
+	kModFloat,				// dest = fmod(a, b)
+	kExpFloat,				// dest = pow(a, b)
+	kNegFloat,				// dest = -a
+	
+	kEqInt, kNotEqInt, kLtInt, kLtEqInt, kGtInt, kGtEqInt,				// dest = (a op b), comparing as int
+	kEqFloat, kNotEqFloat, kLtFloat, kLtEqFloat, kGtFloat, kGtEqFloat,	// dest = (a op b), comparing as float
+	
+	kAnd,					// dest = a & b (logical)
+	kOr,					// dest = a | b (logical)
+	kNot,					// dest = !a (logical)
+	
+	kCallExp,				// dest = exp(a) (float)
+	kCallLog,				// dest = log(a) (float)
+	kCallSqrt,				// dest = sqrt(a) (float)
+	kCallAbsInt,			// dest = llabs(a) (int), bailing out on overflow
+	kCallAbsFloat,			// dest = fabs(a) (float)
+	
+	kJump,					// jump to target_
+	kJumpIfFalse,			// jump to target_ if a is F
+	kReturnInt,				// return a as an int value
+	kReturnFloat,			// return a as a float value
+	kReturnLogical,			// return a as a logical value
+	kReturnVoid				// return void
+};
+
+// A single bytecode instruction; registers are indices into the register file, and node_ is used for error positions
+struct EidosBytecodeInstruction {
+	EidosBytecodeOp op_;
+	uint8_t dest_;
+	uint8_t a_;
+	uint8_t b_;
+	union {
+		int64_t int_;
+		double float_;
+		eidos_logical_t logical_;
+		int32_t target_;
+		struct {
+			EidosGlobalStringID symbol_;
+			EidosGlobalStringID property_;
+			const EidosClass *class_;		// the class of symbol_, for property loads
+		} ids_;
+	};
+	const EidosASTNode *node_;
+};
+
+union EidosBytecodeRegister {
+	int64_t int_;
+	double float_;
+	eidos_logical_t logical_;
+};
+
+
+class EidosBytecode
+{
+	//	This class has its copy constructor and assignment operator disabled, to prevent accidental copying.
+	
+private:
+	std::vector<EidosBytecodeInstruction> instructions_;
+	std::vector<EidosGlobalStringID> local_ids_;		// the identifiers of the local variables, which are registers 0..local_count-1
+	std::vector<EidosBytecodeType> local_types_;		// the types of the local variables
+	int register_count_ = 0;							// the number of registers needed, including local variables
+	
+	int64_t execution_count_ = 0;						// the number of times Execute() has completed successfully
+	int64_t bailout_count_ = 0;							// the number of times Execute() has bailed out to the AST walker
+	
+	friend class EidosBytecodeCompiler;
+	
+public:
+	static const int kMaxRegisters = 256;				// register indices are uint8_t
+	static const int kMaxLocals = 64;					// assigned flags for locals are kept in a uint64_t
+	
+	EidosBytecode(const EidosBytecode&) = delete;					// no copying
+	EidosBytecode& operator=(const EidosBytecode&) = delete;		// no copying
+	EidosBytecode(void) = default;
+	
+	// Compile a block (a compound statement or interpreter block node) into bytecode, using the values in p_symbols to determine
+	// the types of the symbols referenced; returns nullptr if the block uses anything that the bytecode does not support
+	static EidosBytecode *CompileBlock(const EidosASTNode *p_root_node, const EidosSymbolTable &p_symbols);
+	
+	// Execute the bytecode against p_symbols; returns true and sets *p_result on success, with local variables assigned by the
+	// block defined in p_symbols, or returns false if execution bailed out, in which case the block must be executed by the
+	// AST walker instead (nothing observable has been done)
+	bool Execute(EidosSymbolTable &p_symbols, EidosValue_SP *p_result);
+	
+	// Returns true if execution has bailed out often enough that compiled execution is not worthwhile for this block
+	inline bool ShouldAbandon(void) const { return (bailout_count_ >= 16) && (bailout_count_ * 4 > execution_count_); }
+};
+
+
+#endif /* defined(__Eidos__eidos_bytecode__) */
@@ -957,10 +957,15 @@ EidosValue_SP Eidos_ExecuteFunction_parallelGetTaskThreadCounts(__attribute__((u
 	objectElement->SetKeyValue_StringKeys("FITNESS_SEX_1", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_FITNESS_SEX_1)));
 	objectElement->SetKeyValue_StringKeys("FITNESS_SEX_2", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_FITNESS_SEX_2)));
 	objectElement->SetKeyValue_StringKeys("FITNESS_SEX_3", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_FITNESS_SEX_3)));
+	objectElement->SetKeyValue_StringKeys("FITNESS_SUBPOPS", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_FITNESS_SUBPOPS)));
+	objectElement->SetKeyValue_StringKeys("SPATIAL_GRID", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SPATIAL_GRID)));
+	objectElement->SetKeyValue_StringKeys("KDTREE_BUILD", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_KDTREE_BUILD)));
 	objectElement->SetKeyValue_StringKeys("MIGRANT_CLEAR", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_MIGRANT_CLEAR)));
+	objectElement->SetKeyValue_StringKeys("FIXED_MUT_REMOVE", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_FIXED_MUT_REMOVE)));
 	objectElement->SetKeyValue_StringKeys("SIMPLIFY_SORT_PRE", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SIMPLIFY_SORT_PRE)));
 	objectElement->SetKeyValue_StringKeys("SIMPLIFY_SORT", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SIMPLIFY_SORT)));
 	objectElement->SetKeyValue_StringKeys("SIMPLIFY_SORT_POST", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SIMPLIFY_SORT_POST)));
+	objectElement->SetKeyValue_StringKeys("SIMPLIFY_CHROMOSOMES", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES)));
 	objectElement->SetKeyValue_StringKeys("PARENTS_CLEAR", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_PARENTS_CLEAR)));
 	objectElement->SetKeyValue_StringKeys("UNIQUE_MUTRUNS", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_UNIQUE_MUTRUNS)));
 	objectElement->SetKeyValue_StringKeys("SURVIVAL", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SURVIVAL)));
@@ -1159,10 +1164,15 @@ EidosValue_SP Eidos_ExecuteFunction_parallelSetTaskThreadCounts(__attribute__((u
 						else if (key == "FITNESS_SEX_1")				gEidos_OMP_threads_FITNESS_SEX_1 = (int)value_int64;
 						else if (key == "FITNESS_SEX_2")				gEidos_OMP_threads_FITNESS_SEX_2 = (int)value_int64;
 						else if (key == "FITNESS_SEX_3")				gEidos_OMP_threads_FITNESS_SEX_3 = (int)value_int64;
+						else if (key == "FITNESS_SUBPOPS")			gEidos_OMP_threads_FITNESS_SUBPOPS = (int)value_int64;
+						else if (key == "SPATIAL_GRID")			gEidos_OMP_threads_SPATIAL_GRID = (int)value_int64;
+						else if (key == "KDTREE_BUILD")			gEidos_OMP_threads_KDTREE_BUILD = (int)value_int64;
 						else if (key == "MIGRANT_CLEAR")				gEidos_OMP_threads_MIGRANT_CLEAR = (int)value_int64;
+						else if (key == "FIXED_MUT_REMOVE")			gEidos_OMP_threads_FIXED_MUT_REMOVE = (int)value_int64;
 						else if (key == "SIMPLIFY_SORT_PRE")			gEidos_OMP_threads_SIMPLIFY_SORT_PRE = (int)value_int64;
 						else if (key == "SIMPLIFY_SORT")				gEidos_OMP_threads_SIMPLIFY_SORT = (int)value_int64;
 						else if (key == "SIMPLIFY_SORT_POST")			gEidos_OMP_threads_SIMPLIFY_SORT_POST = (int)value_int64;
+						else if (key == "SIMPLIFY_CHROMOSOMES")			gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES = (int)value_int64;
 						else if (key == "PARENTS_CLEAR")				gEidos_OMP_threads_PARENTS_CLEAR = (int)value_int64;
 						else if (key == "UNIQUE_MUTRUNS")				gEidos_OMP_threads_UNIQUE_MUTRUNS = (int)value_int64;
 						else if (key == "SURVIVAL")						gEidos_OMP_threads_SURVIVAL = (int)value_int64;
@@ -70,7 +70,7 @@
 // for Eidos_calc_sha_256()
 #include <stdint.h>
 
-// for _Eidos_FlushZipBuffer()
+// for _Eidos_FlushZipBuffer() and EidosBGZFStreambuf
 #include "../eidos_zlib/zlib.h"
 
 // for Eidos_ColorPaletteLookup()
@@ -91,6 +91,7 @@
 int gEidosMaxThreads = 1;
 int gEidosNumThreads = 1;
 bool gEidosNumThreadsOverride = false;
+bool gEidosNUMAAware = false;
 
 
 // Require 64-bit; apparently there are some issues on 32-bit, and nobody should be doing that anyway
@@ -448,10 +449,15 @@ int gEidos_OMP_threads_FITNESS_ASEX_3 = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_FITNESS_SEX_1 = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_FITNESS_SEX_2 = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_FITNESS_SEX_3 = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_FITNESS_SUBPOPS = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_SPATIAL_GRID = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_KDTREE_BUILD = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_MIGRANT_CLEAR = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_FIXED_MUT_REMOVE = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_SIMPLIFY_SORT_PRE = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_SIMPLIFY_SORT = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_SIMPLIFY_SORT_POST = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_PARENTS_CLEAR = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_UNIQUE_MUTRUNS = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_SURVIVAL = EIDOS_OMP_MAX_THREADS;
@@ -604,10 +610,15 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_FITNESS_SEX_1 = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_FITNESS_SEX_2 = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_FITNESS_SEX_3 = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_FITNESS_SUBPOPS = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_SPATIAL_GRID = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_KDTREE_BUILD = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_MIGRANT_CLEAR = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_FIXED_MUT_REMOVE = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_SIMPLIFY_SORT_PRE = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_SIMPLIFY_SORT = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_SIMPLIFY_SORT_POST = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_PARENTS_CLEAR = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_UNIQUE_MUTRUNS = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_SURVIVAL = EIDOS_OMP_MAX_THREADS;
@@ -741,10 +752,15 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_FITNESS_SEX_1 = 8;
 		gEidos_OMP_threads_FITNESS_SEX_2 = 8;
 		gEidos_OMP_threads_FITNESS_SEX_3 = 2;
+		gEidos_OMP_threads_FITNESS_SUBPOPS = 8;
+		gEidos_OMP_threads_SPATIAL_GRID = 8;
+		gEidos_OMP_threads_KDTREE_BUILD = 8;
 		gEidos_OMP_threads_MIGRANT_CLEAR = 4;
+		gEidos_OMP_threads_FIXED_MUT_REMOVE = 8;
 		gEidos_OMP_threads_SIMPLIFY_SORT_PRE = 8;
 		gEidos_OMP_threads_SIMPLIFY_SORT = 16;
 		gEidos_OMP_threads_SIMPLIFY_SORT_POST = 6;
+		gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES = 16;
 		gEidos_OMP_threads_PARENTS_CLEAR = 16;
 		gEidos_OMP_threads_UNIQUE_MUTRUNS = 16;
 		gEidos_OMP_threads_SURVIVAL = 16;
@@ -880,10 +896,15 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_FITNESS_SEX_1 = 40;
 		gEidos_OMP_threads_FITNESS_SEX_2 = 40;
 		gEidos_OMP_threads_FITNESS_SEX_3 = 5;
+		gEidos_OMP_threads_FITNESS_SUBPOPS = 20;
+		gEidos_OMP_threads_SPATIAL_GRID = 20;
+		gEidos_OMP_threads_KDTREE_BUILD = 20;
 		gEidos_OMP_threads_MIGRANT_CLEAR = 20;
+		gEidos_OMP_threads_FIXED_MUT_REMOVE = 20;
 		gEidos_OMP_threads_SIMPLIFY_SORT_PRE = 20;
 		gEidos_OMP_threads_SIMPLIFY_SORT = 40;
 		gEidos_OMP_threads_SIMPLIFY_SORT_POST = 40;
+		gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES = 40;
 		gEidos_OMP_threads_PARENTS_CLEAR = 40;
 		gEidos_OMP_threads_UNIQUE_MUTRUNS = 40;
 		gEidos_OMP_threads_SURVIVAL = 40;
@@ -1044,10 +1065,15 @@ void _Eidos_ClipOpenMPThreadCounts(void)
 	gEidos_OMP_threads_FITNESS_SEX_1 = std::min(gEidosMaxThreads, gEidos_OMP_threads_FITNESS_SEX_1);
 	gEidos_OMP_threads_FITNESS_SEX_2 = std::min(gEidosMaxThreads, gEidos_OMP_threads_FITNESS_SEX_2);
 	gEidos_OMP_threads_FITNESS_SEX_3 = std::min(gEidosMaxThreads, gEidos_OMP_threads_FITNESS_SEX_3);
+	gEidos_OMP_threads_FITNESS_SUBPOPS = std::min(gEidosMaxThreads, gEidos_OMP_threads_FITNESS_SUBPOPS);
+	gEidos_OMP_threads_SPATIAL_GRID = std::min(gEidosMaxThreads, gEidos_OMP_threads_SPATIAL_GRID);
+	gEidos_OMP_threads_KDTREE_BUILD = std::min(gEidosMaxThreads, gEidos_OMP_threads_KDTREE_BUILD);
 	gEidos_OMP_threads_MIGRANT_CLEAR = std::min(gEidosMaxThreads, gEidos_OMP_threads_MIGRANT_CLEAR);
+	gEidos_OMP_threads_FIXED_MUT_REMOVE = std::min(gEidosMaxThreads, gEidos_OMP_threads_FIXED_MUT_REMOVE);
 	gEidos_OMP_threads_SIMPLIFY_SORT_PRE = std::min(gEidosMaxThreads, gEidos_OMP_threads_SIMPLIFY_SORT_PRE);
 	gEidos_OMP_threads_SIMPLIFY_SORT = std::min(gEidosMaxThreads, gEidos_OMP_threads_SIMPLIFY_SORT);
 	gEidos_OMP_threads_SIMPLIFY_SORT_POST = std::min(gEidosMaxThreads, gEidos_OMP_threads_SIMPLIFY_SORT_POST);
+	gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES = std::min(gEidosMaxThreads, gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES);
 	gEidos_OMP_threads_PARENTS_CLEAR = std::min(gEidosMaxThreads, gEidos_OMP_threads_PARENTS_CLEAR);
 	gEidos_OMP_threads_UNIQUE_MUTRUNS = std::min(gEidosMaxThreads, gEidos_OMP_threads_UNIQUE_MUTRUNS);
 	gEidos_OMP_threads_SURVIVAL = std::min(gEidosMaxThreads, gEidos_OMP_threads_SURVIVAL);
@@ -1066,9 +1092,13 @@ void Eidos_WarmUpOpenMP(std::ostream *outstream, bool changed_max_thread_count,
 	setenv("OMP_WAIT_POLICY", wait_policy, 0);
 	
 	// "true" prevents threads migrating between cores; this generally improves performance, especially with per-thread memory usage
-	const char *bind_policy = "true";
+	// In NUMA-aware mode we ask for threads to be spread across cores, and then pin them explicitly below where we can
+	const char *bind_policy = gEidosNUMAAware ? "spread" : "true";
 	setenv("OMP_PROC_BIND", bind_policy, 0);
 	
+	if (gEidosNUMAAware)
+		setenv("OMP_PLACES", "cores", 0);
+	
 	// We do not support dynamic adjustment of the number of threads; if we ask for N threads, we expect N threads
 	// It is important not to change that, or a variety of things will no longer work correctly
 	omp_set_dynamic(false);
@@ -1077,6 +1107,13 @@ void Eidos_WarmUpOpenMP(std::ostream *outstream, bool changed_max_thread_count,
 	omp_set_max_active_levels(1);
 	//omp_set_nested(false);		// deprecated in favor of omp_set_max_active_levels()
 	
+	// Loops over individuals that use schedule(runtime), such as fitness evaluation, get dynamic scheduling by default for load
+	// balancing; in NUMA-aware mode they get static scheduling, so each thread processes the same individuals every tick
+	if (gEidosNUMAAware)
+		omp_set_schedule(omp_sched_static, 0);
+	else
+		omp_set_schedule(omp_sched_dynamic, 16);
+	
 	// Set the maximum number of threads to the user's request, but never higher than the intrinsic max thread count
 	if (changed_max_thread_count)
 	{
@@ -1114,6 +1151,9 @@ void Eidos_WarmUpOpenMP(std::ostream *outstream, bool changed_max_thread_count,
 		(*outstream) << "// ********** Running multithreaded with OpenMP (maxThreads == " << gEidosMaxThreads << ")" << std::endl;
 		(*outstream) << "// ********** OMP_WAIT_POLICY == " << getenv("OMP_WAIT_POLICY") << ", OMP_PROC_BIND == " << getenv("OMP_PROC_BIND") << std::endl;
 		
+		if (gEidosNUMAAware)
+			(*outstream) << "// ********** OMP_PLACES == " << getenv("OMP_PLACES") << std::endl;
+		
 #if 1
 		(*outstream) << "// ********** Per-task thread counts: '" << gEidosPerTaskThreadCountsSetName << "', max " << gEidosPerTaskOriginalMaxThreadCount;
 		if (gEidosPerTaskClippedMaxThreadCount < gEidosPerTaskOriginalMaxThreadCount)
@@ -1138,6 +1178,10 @@ void Eidos_WarmUpOpenMP(std::ostream *outstream, bool changed_max_thread_count,
 #endif
 	}
 	
+	// Pin threads after all of the above, so the thread pool is created with the final thread count
+	if (gEidosNUMAAware)
+		Eidos_PinOpenMPThreadsToNUMANodes(outstream);
+	
 #ifdef EIDOS_GUI
 	// The GUI apps don't work well multithreaded.  They have to allow threads to sleep (otherwise they peg the
 	// CPU the whole time they're running), and that is so inefficient that it makes the apps actually run much
@@ -3047,6 +3091,238 @@ void Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const s
 	}
 }
 
+// Compress one block of data into a BGZF block in p_compressed, using a raw deflate stream that has already been initialized;
+// returns the length of the BGZF block, or 0 if compression failed.  See the SAM/BAM specification, section 4.1, for the format.
+static size_t _Eidos_BGZFCompressBlock(z_stream *p_stream, const char *p_data, size_t p_length, unsigned char *p_compressed, size_t p_compressed_capacity)
+{
+	static const unsigned char bgzf_header[18] = {0x1f, 0x8b, 0x08, 0x04, 0, 0, 0, 0, 0, 0xff, 0x06, 0, 'B', 'C', 0x02, 0, 0, 0};
+	
+	if (deflateReset(p_stream) != Z_OK)
+		return 0;
+	
+	p_stream->next_in = (Bytef *)p_data;
+	p_stream->avail_in = (uInt)p_length;
+	p_stream->next_out = p_compressed + 18;
+	p_stream->avail_out = (uInt)(p_compressed_capacity - 18 - 8);
+	
+	if (deflate(p_stream, Z_FINISH) != Z_STREAM_END)
+		return 0;
+	
+	size_t deflated_length = p_stream->total_out;
+	size_t block_length = 18 + deflated_length + 8;
+	uint32_t crc = (uint32_t)crc32(crc32(0L, Z_NULL, 0), (const Bytef *)p_data, (uInt)p_length);
+	uint32_t input_size = (uint32_t)p_length;
+	unsigned char *footer = p_compressed + 18 + deflated_length;
+	
+	memcpy(p_compressed, bgzf_header, 18);
+	p_compressed[16] = (unsigned char)((block_length - 1) & 0xff);		// BSIZE is the total block size minus one
+	p_compressed[17] = (unsigned char)((block_length - 1) >> 8);
+	
+	for (int byte_index = 0; byte_index < 4; ++byte_index)
+	{
+		footer[byte_index] = (unsigned char)((crc >> (8 * byte_index)) & 0xff);
+		footer[4 + byte_index] = (unsigned char)((input_size >> (8 * byte_index)) & 0xff);
+	}
+	
+	return block_length;
+}
+
+EidosBGZFStreambuf::~EidosBGZFStreambuf(void)
+{
+	// if we are being destroyed without having been closed (due to an exception, presumably), finish up as best we can
+	if (file_)
+		Close();
+}
+
+bool EidosBGZFStreambuf::Open(const std::string &p_file_path, bool p_append)
+{
+	if (file_)
+		return false;
+	
+	// BGZF files may be concatenated, so appending is simply a matter of writing more blocks at the end of the file
+	file_ = fopen(p_file_path.c_str(), p_append ? "ab" : "wb");
+	
+	if (!file_)
+		return false;
+	
+	finishing_ = false;
+	write_error_ = false;
+	block_.resize(kBlockDataSize);
+	setp(block_.data(), block_.data() + kBlockDataSize);
+	
+	compression_thread_ = std::thread(&EidosBGZFStreambuf::_CompressionThread, this);
+	
+	return true;
+}
+
+void EidosBGZFStreambuf::_QueueBlock(void)
+{
+	// hand off the filled part of the current block, and take a spare block to continue filling; this waits if the
+	// compression thread has fallen too far behind, which bounds memory usage when output outpaces compression
+	block_.resize((size_t)(pptr() - pbase()));
+	
+	{
+		std::unique_lock<std::mutex> lock(queue_mutex_);
+		
+		queue_changed_.wait(lock, [this]{ return queued_blocks_.size() < kMaxQueuedBlocks; });
+		queued_blocks_.emplace_back(std::move(block_));
+		
+		if (spare_blocks_.size())
+		{
+			block_ = std::move(spare_blocks_.back());
+			spare_blocks_.pop_back();
+		}
+		else
+		{
+			block_ = std::vector<char>();
+		}
+	}
+	
+	queue_changed_.notify_all();
+	
+	block_.resize(kBlockDataSize);
+	setp(block_.data(), block_.data() + kBlockDataSize);
+}
+
+void EidosBGZFStreambuf::_CompressionThread(void)
+{
+	// This runs on the background thread.  It must not call into Eidos or raise; failures are recorded in write_error_.
+	z_stream stream;
+	std::vector<unsigned char> compressed(65536);
+	
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+	
+	bool stream_ok = (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+	
+	while (true)
+	{
+		std::vector<char> block;
+		
+		{
+			std::unique_lock<std::mutex> lock(queue_mutex_);
+			
+			queue_changed_.wait(lock, [this]{ return (queued_blocks_.size() > 0) || finishing_; });
+			
+			if (queued_blocks_.size() == 0)
+				break;
+			
+			block = std::move(queued_blocks_.front());
+			queued_blocks_.pop_front();
+		}
+		
+		queue_changed_.notify_all();
+		
+		bool block_ok = false;
+		
+		if (stream_ok)
+		{
+			size_t block_length = _Eidos_BGZFCompressBlock(&stream, block.data(), block.size(), compressed.data(), compressed.size());
+			
+			block_ok = (block_length > 0) && (fwrite(compressed.data(), 1, block_length, file_) == block_length);
+		}
+		
+		std::lock_guard<std::mutex> lock(queue_mutex_);
+		
+		if (!block_ok)
+			write_error_ = true;
+		
+		spare_blocks_.emplace_back(std::move(block));
+	}
+	
+	if (stream_ok)
+		deflateEnd(&stream);
+	else
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex_);
+		
+		write_error_ = true;
+	}
+}
+
+EidosBGZFStreambuf::int_type EidosBGZFStreambuf::overflow(int_type p_ch)
+{
+	if (!file_)
+		return traits_type::eof();
+	
+	if (pptr() == epptr())
+		_QueueBlock();
+	
+	if (!traits_type::eq_int_type(p_ch, traits_type::eof()))
+	{
+		*pptr() = traits_type::to_char_type(p_ch);
+		pbump(1);
+	}
+	
+	return traits_type::not_eof(p_ch);
+}
+
+std::streamsize EidosBGZFStreambuf::xsputn(const char *p_s, std::streamsize p_count)
+{
+	if (!file_)
+		return 0;
+	
+	std::streamsize remaining = p_count;
+	
+	while (remaining > 0)
+	{
+		if (pptr() == epptr())
+			_QueueBlock();
+		
+		std::streamsize chunk = std::min(remaining, (std::streamsize)(epptr() - pptr()));
+		
+		memcpy(pptr(), p_s, (size_t)chunk);
+		pbump((int)chunk);
+		p_s += chunk;
+		remaining -= chunk;
+	}
+	
+	return p_count;
+}
+
+int EidosBGZFStreambuf::sync(void)
+{
+	return 0;
+}
+
+bool EidosBGZFStreambuf::Close(void)
+{
+	if (!file_)
+		return false;
+	
+	// queue the final partial block, then let the compression thread drain the queue and exit
+	if (pptr() > pbase())
+		_QueueBlock();
+	
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex_);
+		
+		finishing_ = true;
+	}
+	
+	queue_changed_.notify_all();
+	compression_thread_.join();
+	
+	// write the standard BGZF end-of-file marker, an empty block, and close the file
+	static const unsigned char bgzf_eof[28] = {0x1f, 0x8b, 0x08, 0x04, 0, 0, 0, 0, 0, 0xff, 0x06, 0, 'B', 'C', 0x02, 0, 0x1b, 0, 0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	bool success = !write_error_;
+	
+	if (fwrite(bgzf_eof, 1, 28, file_) != 28)
+		success = false;
+	if (fclose(file_) != 0)
+		success = false;
+	
+	file_ = nullptr;
+	setp(nullptr, nullptr);
+	block_.clear();
+	block_.shrink_to_fit();
+	queued_blocks_.clear();
+	spare_blocks_.clear();
+	
+	return success;
+}
+
 
 #pragma mark -
 #pragma mark Utility functions
@@ -33,6 +33,10 @@
 #include <algorithm>
 #include <unordered_map>
 #include <cstdint>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 // Workaround for Xcode bug: when you want to debug build problems with a Release build related to profiling, uncomment this,
 // since the target-level definition of SLIMPROFILING doesn't seem to affect syntax highlighting and build errors correctly.
@@ -639,6 +643,47 @@ enum class EidosFileFlush {
 
 void Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const std::string *> &p_contents, bool p_append, bool p_compress, EidosFileFlush p_flush_option);
 
+// EidosBGZFStreambuf is a std::streambuf that writes BGZF-compressed output to a file: a series of independent gzip members
+// of at most 64 KB each, as used by bgzip/tabix/htslib, terminated by the standard empty EOF block.  The output is readable by
+// any gzip reader, and indexable by tabix.  Data written to the streambuf is gathered into blocks on the calling thread, and
+// the blocks are compressed and written out in order on a background thread, so that formatting output and compressing it
+// overlap.  The background thread touches nothing but the file and the queued blocks, so it is safe in all builds.  Close()
+// must be called to finish the file; it returns false if any error occurred while compressing or writing.
+class EidosBGZFStreambuf : public std::streambuf
+{
+private:
+	static const size_t kBlockDataSize = 0xff00;		// the maximum uncompressed data per block, matching htslib
+	static const size_t kMaxQueuedBlocks = 16;			// the number of filled blocks allowed to wait for compression
+	
+	FILE *file_ = nullptr;
+	std::vector<char> block_;							// the block currently being filled through the put area
+	std::deque<std::vector<char>> queued_blocks_;		// filled blocks waiting for the compression thread, in order
+	std::vector<std::vector<char>> spare_blocks_;		// blocks that have been written, recycled to avoid reallocation
+	std::thread compression_thread_;
+	std::mutex queue_mutex_;
+	std::condition_variable queue_changed_;
+	bool finishing_ = false;							// set by Close() to tell the compression thread to exit when done
+	bool write_error_ = false;							// set by the compression thread if compression or writing fails
+	
+	void _QueueBlock(void);
+	void _CompressionThread(void);
+	
+protected:
+	virtual int_type overflow(int_type p_ch) override;
+	virtual std::streamsize xsputn(const char *p_s, std::streamsize p_count) override;
+	virtual int sync(void) override;			// a no-op; block boundaries are determined only by size
+	
+public:
+	EidosBGZFStreambuf(const EidosBGZFStreambuf&) = delete;
+	EidosBGZFStreambuf& operator=(const EidosBGZFStreambuf&) = delete;
+	EidosBGZFStreambuf(void) = default;
+	virtual ~EidosBGZFStreambuf(void) override;
+	
+	bool Open(const std::string &p_file_path, bool p_append);		// returns false if the file could not be opened
+	inline bool IsOpen(void) const { return (file_ != nullptr); }
+	bool Close(void);
+};
+
 
 // *******************************************************************************************************************
 //
@@ -24,6 +24,7 @@
 #include "eidos_rng.h"
 #include "eidos_call_signature.h"
 #include "eidos_simd.h"
+#include "eidos_bytecode.h"
 
 #include <sstream>
 #include <stdexcept>
@@ -188,7 +189,8 @@ EidosValue_SP EidosInterpreter::EvaluateInternalBlock(EidosScript *p_script_for_
 		gEidosErrorContext = EidosErrorContext{{-1, -1, -1, -1}, p_script_for_block};
 		
 		// Same code as below, just bracketed by the error context save/restore
-		result_SP = FastEvaluateNode(root_node_);
+		if (!EvaluateBlockBytecode(&result_SP))
+			result_SP = FastEvaluateNode(root_node_);
 		
 		// if a next or break statement was hit and was not handled by a loop, throw an error
 		if (next_statement_hit_ || break_statement_hit_)
@@ -200,7 +202,8 @@ EidosValue_SP EidosInterpreter::EvaluateInternalBlock(EidosScript *p_script_for_
 	}
 	else
 	{
-		result_SP = FastEvaluateNode(root_node_);
+		if (!EvaluateBlockBytecode(&result_SP))
+			result_SP = FastEvaluateNode(root_node_);
 		
 		// if a next or break statement was hit and was not handled by a loop, throw an error
 		if (next_statement_hit_ || break_statement_hit_)
@@ -220,6 +223,56 @@ EidosValue_SP EidosInterpreter::EvaluateInternalBlock(EidosScript *p_script_for_
 	return result_SP;
 }
 
+// attempt to execute root_node_ as bytecode, compiling it the first time through; returns false if the AST must be walked instead
+bool EidosInterpreter::EvaluateBlockBytecode(EidosValue_SP *p_result)
+{
+	// Bytecode is not used when anything is observing execution node by node, or inside a parallel region (where the lazy
+	// compilation and bailout counting would not be thread-safe)
+	if (!gEidosBytecodeEnabled || logging_execution_ || use_custom_undefined_identifier_raise_ || omp_in_parallel())
+		return false;
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	if (gEidosProfilingClientCount)
+		return false;
+#endif
+	
+#if DEBUG_POINTS_ENABLED
+	// SLiMgui debugging points
+	if (debug_points_ && debug_points_->set.size())
+		return false;
+#endif
+	
+	const EidosASTNode *root_node = root_node_;
+	
+	if (root_node->bytecode_state_ == EidosBytecodeState::kNotCompilable)
+		return false;
+	
+	if (root_node->bytecode_state_ == EidosBytecodeState::kNotCompiled)
+	{
+		root_node->bytecode_ = EidosBytecode::CompileBlock(root_node, *global_symbols_);
+		root_node->bytecode_state_ = (root_node->bytecode_ ? EidosBytecodeState::kCompiled : EidosBytecodeState::kNotCompilable);
+		
+		if (!root_node->bytecode_)
+			return false;
+	}
+	
+	EidosBytecode *bytecode = root_node->bytecode_;
+	
+	if (bytecode->Execute(*global_symbols_, p_result))
+		return true;
+	
+	// execution bailed out; if that happens too often, stop trying
+	if (bytecode->ShouldAbandon())
+	{
+		delete bytecode;
+		root_node->bytecode_ = nullptr;
+		root_node->bytecode_state_ = EidosBytecodeState::kNotCompilable;
+	}
+	
+	return false;
+}
+
 // the starting point for script blocks in Eidos, which do not require braces; this is not really a "block" but a series of
 // independent statements grouped only by virtue of having been executed together as a unit in the interpreter
 EidosValue_SP EidosInterpreter::EvaluateInterpreterBlock(bool p_print_output, bool p_return_last_value)
@@ -229,6 +282,14 @@ EidosValue_SP EidosInterpreter::EvaluateInterpreterBlock(bool p_print_output, bo
 	
 	EidosValue_SP result_SP = gStaticEidosValueVOID;
 	
+	// Blocks executed without output, such as the bodies of user-defined functions, can be executed as bytecode
+	if (!p_print_output && !p_return_last_value && EvaluateBlockBytecode(&result_SP))
+	{
+		EIDOS_EXIT_EXECUTION_LOG("EvaluateInterpreterBlock()");
+		EIDOS_END_EXECUTION_LOG();
+		return result_SP;
+	}
+	
 	for (EidosASTNode *child_node : root_node_->children_)
 	{
 #if (SLIMPROFILING == 1)
@@ -2150,6 +2211,61 @@ EidosValue_SP EidosInterpreter::Evaluate_MemberRef(const EidosASTNode *p_node)
 	return result_SP;
 }
 
+// Singleton fast paths for the arithmetic operators.  Scalar arithmetic in loops and callbacks is very common, and for it the
+// general vectorized code paths below spend most of their time on overhead: checking dimensions, allocating a new result value
+// from gEidosValuePool, and sizing its buffer.  When both operands are singleton integer or float values without dimensions, the
+// operators use these helpers instead.  If an operand of the result type is a temporary -- a value that nothing else refers to,
+// such as the result of a nested operator -- it is overwritten in place and returned as the result, so that an expression such as
+// a*x + b*y - c allocates only a single value.  Values held by a symbol table, cached literals, and constants always have a use
+// count greater than one, so they are never modified here; constant and invisible values are excluded anyway, for safety.
+static inline __attribute__((always_inline)) bool Eidos_IsReusableSingleton(const EidosValue_SP &p_value, EidosValueType p_type)
+{
+	return ((p_value->UseCount() == 1) && (p_value->Type() == p_type) && !p_value->IsConstant() && !p_value->Invisible());
+}
+
+static inline EidosValue_SP Eidos_SingletonIntResult(EidosValue_SP &p_first_value, EidosValue_SP &p_second_value, int64_t p_result)
+{
+	if (Eidos_IsReusableSingleton(p_first_value, EidosValueType::kValueInt))
+	{
+		static_cast<EidosValue_Int *>(p_first_value.get())->set_int_no_check(p_result, 0);
+		return std::move(p_first_value);
+	}
+	if (Eidos_IsReusableSingleton(p_second_value, EidosValueType::kValueInt))
+	{
+		static_cast<EidosValue_Int *>(p_second_value.get())->set_int_no_check(p_result, 0);
+		return std::move(p_second_value);
+	}
+	
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(p_result));
+}
+
+static inline EidosValue_SP Eidos_SingletonFloatResult(EidosValue_SP &p_first_value, EidosValue_SP &p_second_value, double p_result)
+{
+	if (Eidos_IsReusableSingleton(p_first_value, EidosValueType::kValueFloat))
+	{
+		static_cast<EidosValue_Float *>(p_first_value.get())->set_float_no_check(p_result, 0);
+		return std::move(p_first_value);
+	}
+	if (Eidos_IsReusableSingleton(p_second_value, EidosValueType::kValueFloat))
+	{
+		static_cast<EidosValue_Float *>(p_second_value.get())->set_float_no_check(p_result, 0);
+		return std::move(p_second_value);
+	}
+	
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(p_result));
+}
+
+// Returns true if both operands are singletons without dimensions, and thus eligible for the fast paths above
+static inline __attribute__((always_inline)) bool Eidos_SingletonOperands(const EidosValue_SP &p_first_value, int p_first_count, const EidosValue_SP &p_second_value, int p_second_count)
+{
+	return ((p_first_count == 1) && (p_second_count == 1) && !p_first_value->IsMatrixOrArray() && !p_second_value->IsMatrixOrArray());
+}
+
+static inline __attribute__((always_inline)) double Eidos_SingletonNumericAsFloat(const EidosValue_SP &p_value, EidosValueType p_type)
+{
+	return (p_type == EidosValueType::kValueInt) ? (double)p_value->IntData()[0] : p_value->FloatData()[0];
+}
+
 EidosValue_SP EidosInterpreter::Evaluate_Plus(const EidosASTNode *p_node)
 {
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Plus()");
@@ -2181,6 +2297,34 @@ EidosValue_SP EidosInterpreter::Evaluate_Plus(const EidosASTNode *p_node)
 		int first_child_count = first_child_value->Count();
 		int second_child_count = second_child_value->Count();
 		
+		// fast path for singleton int and float operands; see Eidos_SingletonIntResult()
+		if (Eidos_SingletonOperands(first_child_value, first_child_count, second_child_value, second_child_count))
+		{
+			if ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueInt))
+			{
+				int64_t add_result;
+				bool overflow = Eidos_add_overflow(first_child_value->IntData()[0], second_child_value->IntData()[0], &add_result);
+				
+				if (overflow)
+					EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): integer addition overflow with the binary '+' operator." << EidosTerminate(operator_token);
+				
+				result_SP = Eidos_SingletonIntResult(first_child_value, second_child_value, add_result);
+				
+				EIDOS_EXIT_EXECUTION_LOG("Evaluate_Plus()");
+				return result_SP;
+			}
+			if (((first_child_type == EidosValueType::kValueInt) || (first_child_type == EidosValueType::kValueFloat)) && ((second_child_type == EidosValueType::kValueInt) || (second_child_type == EidosValueType::kValueFloat)))
+			{
+				double first_operand = Eidos_SingletonNumericAsFloat(first_child_value, first_child_type);
+				double second_operand = Eidos_SingletonNumericAsFloat(second_child_value, second_child_type);
+				
+				result_SP = Eidos_SingletonFloatResult(first_child_value, second_child_value, first_operand + second_operand);
+				
+				EIDOS_EXIT_EXECUTION_LOG("Evaluate_Plus()");
+				return result_SP;
+			}
+		}
+		
 		// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
 		int first_child_dimcount = first_child_value->DimensionCount();
 		int second_child_dimcount = second_child_value->DimensionCount();
@@ -2501,6 +2645,34 @@ EidosValue_SP EidosInterpreter::Evaluate_Minus(const EidosASTNode *p_node)
 		
 		int second_child_count = second_child_value->Count();
 		
+		// fast path for singleton int and float operands; see Eidos_SingletonIntResult()
+		if (Eidos_SingletonOperands(first_child_value, first_child_count, second_child_value, second_child_count))
+		{
+			if ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueInt))
+			{
+				int64_t subtract_result;
+				bool overflow = Eidos_sub_overflow(first_child_value->IntData()[0], second_child_value->IntData()[0], &subtract_result);
+				
+				if (overflow)
+					EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): integer subtraction overflow with the binary '-' operator." << EidosTerminate(operator_token);
+				
+				result_SP = Eidos_SingletonIntResult(first_child_value, second_child_value, subtract_result);
+				
+				EIDOS_EXIT_EXECUTION_LOG("Evaluate_Minus()");
+				return result_SP;
+			}
+			else	// the operand types were checked above, so at least one operand is float
+			{
+				double first_operand = Eidos_SingletonNumericAsFloat(first_child_value, first_child_type);
+				double second_operand = Eidos_SingletonNumericAsFloat(second_child_value, second_child_type);
+				
+				result_SP = Eidos_SingletonFloatResult(first_child_value, second_child_value, first_operand - second_operand);
+				
+				EIDOS_EXIT_EXECUTION_LOG("Evaluate_Minus()");
+				return result_SP;
+			}
+		}
+		
 		// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
 		int first_child_dimcount = first_child_value->DimensionCount();
 		int second_child_dimcount = second_child_value->DimensionCount();
@@ -2839,6 +3011,36 @@ EidosValue_SP EidosInterpreter::Evaluate_Mult(const EidosASTNode *p_node)
 	int first_child_count = first_child_value->Count();
 	int second_child_count = second_child_value->Count();
 	
+	EidosValue_SP result_SP;
+	
+	// fast path for singleton int and float operands; see Eidos_SingletonIntResult()
+	if (Eidos_SingletonOperands(first_child_value, first_child_count, second_child_value, second_child_count))
+	{
+		if ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueInt))
+		{
+			int64_t multiply_result;
+			bool overflow = Eidos_mul_overflow(first_child_value->IntData()[0], second_child_value->IntData()[0], &multiply_result);
+			
+			if (overflow)
+				EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Mult): integer multiplication overflow with the '*' operator." << EidosTerminate(operator_token);
+			
+			result_SP = Eidos_SingletonIntResult(first_child_value, second_child_value, multiply_result);
+			
+			EIDOS_EXIT_EXECUTION_LOG("Evaluate_Mult()");
+			return result_SP;
+		}
+		else	// the operand types were checked above, so at least one operand is float
+		{
+			double first_operand = Eidos_SingletonNumericAsFloat(first_child_value, first_child_type);
+			double second_operand = Eidos_SingletonNumericAsFloat(second_child_value, second_child_type);
+			
+			result_SP = Eidos_SingletonFloatResult(first_child_value, second_child_value, first_operand * second_operand);
+			
+			EIDOS_EXIT_EXECUTION_LOG("Evaluate_Mult()");
+			return result_SP;
+		}
+	}
+	
 	// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
 	int first_child_dimcount = first_child_value->DimensionCount();
 	int second_child_dimcount = second_child_value->DimensionCount();
@@ -2847,8 +3049,6 @@ EidosValue_SP EidosInterpreter::Evaluate_Mult(const EidosASTNode *p_node)
 	if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Mult): non-conformable array operands to the '*' operator." << EidosTerminate(operator_token);
 	
-	EidosValue_SP result_SP;
-	
 	if (first_child_count == second_child_count)
 	{
 		// OK, we've got good operands; calculate the result.  If both operands are int, the result is int, otherwise float.
@@ -3019,6 +3219,21 @@ EidosValue_SP EidosInterpreter::Evaluate_Div(const EidosASTNode *p_node)
 	int first_child_count = first_child_value->Count();
 	int second_child_count = second_child_value->Count();
 	
+	EidosValue_SP result_SP;
+	
+	// fast path for singleton int and float operands; see Eidos_SingletonIntResult()
+	if (Eidos_SingletonOperands(first_child_value, first_child_count, second_child_value, second_child_count))
+	{
+		// the operand types were checked above; division always produces a float result
+		double first_operand = Eidos_SingletonNumericAsFloat(first_child_value, first_child_type);
+		double second_operand = Eidos_SingletonNumericAsFloat(second_child_value, second_child_type);
+		
+		result_SP = Eidos_SingletonFloatResult(first_child_value, second_child_value, first_operand / second_operand);
+		
+		EIDOS_EXIT_EXECUTION_LOG("Evaluate_Div()");
+		return result_SP;
+	}
+	
 	// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
 	int first_child_dimcount = first_child_value->DimensionCount();
 	int second_child_dimcount = second_child_value->DimensionCount();
@@ -3027,8 +3242,6 @@ EidosValue_SP EidosInterpreter::Evaluate_Div(const EidosASTNode *p_node)
 	if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Div): non-conformable array operands to the '/' operator." << EidosTerminate(operator_token);
 	
-	EidosValue_SP result_SP;
-	
 	// I've decided to make division perform float division always; wanting integer division is rare, and providing it as the default is error-prone.  If
 	// people want integer division, a function has been provided, integerDiv(). This decision applies also to modulo, with function integerMod().
 
@@ -0,0 +1,734 @@
+//
+//  eidos_openmp.cpp
+//  Eidos
+//
+//  Created by Ben Haller on 10/16/26.
+//  Copyright (c) 2026 Benjamin C. Haller.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "eidos_openmp.h"
+#include "eidos_globals.h"
+#include "eidos_script.h"
+#include "eidos_interpreter.h"
+#include "eidos_symbol_table.h"
+#include "eidos_rng.h"
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <limits>
+#include <cstdlib>
+#include <cerrno>
+#include <cctype>
+#include <vector>
+#include <cstring>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <dirent.h>
+#endif
+
+
+#ifdef _OPENMP
+
+
+// The minimum task sizes for running each parallel loop multithreaded, used by the production EIDOS_OMPMIN_* counts
+// in eidos_openmp.h.  These are the compiled-in defaults, which were tuned on one development machine; a threshold
+// profile, written by Eidos_TuneOpenMPThresholds() on the machine where production runs will be done, can replace them.
+
+// Eidos: math functions
+int64_t gEidos_OMPMIN_ABS_FLOAT = 2000;
+int64_t gEidos_OMPMIN_CEIL = 2000;
+int64_t gEidos_OMPMIN_EXP_FLOAT = 2000;
+int64_t gEidos_OMPMIN_FLOOR = 2000;
+int64_t gEidos_OMPMIN_LOG_FLOAT = 2000;
+int64_t gEidos_OMPMIN_LOG10_FLOAT = 2000;
+int64_t gEidos_OMPMIN_LOG2_FLOAT = 2000;
+int64_t gEidos_OMPMIN_ROUND = 2000;
+int64_t gEidos_OMPMIN_SQRT_FLOAT = 2000;
+int64_t gEidos_OMPMIN_SUM_INTEGER = 2000;
+int64_t gEidos_OMPMIN_SUM_FLOAT = 2000;
+int64_t gEidos_OMPMIN_SUM_LOGICAL = 6000;
+int64_t gEidos_OMPMIN_TRUNC = 2000;
+
+// Eidos: max(), min(), pmax(), pmin()
+int64_t gEidos_OMPMIN_MAX_INT = 2000;
+int64_t gEidos_OMPMIN_MAX_FLOAT = 2000;
+int64_t gEidos_OMPMIN_MIN_INT = 2000;
+int64_t gEidos_OMPMIN_MIN_FLOAT = 2000;
+int64_t gEidos_OMPMIN_PMAX_INT_1 = 2000;
+int64_t gEidos_OMPMIN_PMAX_INT_2 = 2000;
+int64_t gEidos_OMPMIN_PMAX_FLOAT_1 = 2000;
+int64_t gEidos_OMPMIN_PMAX_FLOAT_2 = 2000;
+int64_t gEidos_OMPMIN_PMIN_INT_1 = 2000;
+int64_t gEidos_OMPMIN_PMIN_INT_2 = 2000;
+int64_t gEidos_OMPMIN_PMIN_FLOAT_1 = 2000;
+int64_t gEidos_OMPMIN_PMIN_FLOAT_2 = 2000;
+
+// Eidos: match(), sample(), tabulate()
+int64_t gEidos_OMPMIN_MATCH_INT = 2000;
+int64_t gEidos_OMPMIN_MATCH_FLOAT = 2000;
+int64_t gEidos_OMPMIN_MATCH_STRING = 2000;
+int64_t gEidos_OMPMIN_MATCH_OBJECT = 2000;
+int64_t gEidos_OMPMIN_SAMPLE_INDEX = 2000;
+int64_t gEidos_OMPMIN_SAMPLE_R_INT = 2000;
+int64_t gEidos_OMPMIN_SAMPLE_R_FLOAT = 2000;
+int64_t gEidos_OMPMIN_SAMPLE_R_OBJECT = 2000;
+int64_t gEidos_OMPMIN_SAMPLE_WR_INT = 2000;
+int64_t gEidos_OMPMIN_SAMPLE_WR_FLOAT = 2000;
+int64_t gEidos_OMPMIN_SAMPLE_WR_OBJECT = 2000;
+int64_t gEidos_OMPMIN_TABULATE_MAXBIN = 2000;
+int64_t gEidos_OMPMIN_TABULATE = 2000;
+
+// SLiM methods/properties
+int64_t gEidos_OMPMIN_CONTAINS_MARKER_MUT = 900;
+int64_t gEidos_OMPMIN_I_COUNT_OF_MUTS_OF_TYPE = 2;
+int64_t gEidos_OMPMIN_G_COUNT_OF_MUTS_OF_TYPE = 2;
+int64_t gEidos_OMPMIN_INDS_W_PEDIGREE_IDS = 2000;
+int64_t gEidos_OMPMIN_RELATEDNESS = 2000;
+int64_t gEidos_OMPMIN_SAMPLE_INDIVIDUALS_1 = 2000;
+int64_t gEidos_OMPMIN_SAMPLE_INDIVIDUALS_2 = 2000;
+int64_t gEidos_OMPMIN_SET_FITNESS_SCALE_1 = 900;
+int64_t gEidos_OMPMIN_SET_FITNESS_SCALE_2 = 1500;
+int64_t gEidos_OMPMIN_SUM_OF_MUTS_OF_TYPE = 2;
+
+// Distribution draws and related
+int64_t gEidos_OMPMIN_DNORM_1 = 10000;
+int64_t gEidos_OMPMIN_DNORM_2 = 10000;
+int64_t gEidos_OMPMIN_RBINOM_1 = 10000;
+int64_t gEidos_OMPMIN_RBINOM_2 = 10000;
+int64_t gEidos_OMPMIN_RBINOM_3 = 10000;
+int64_t gEidos_OMPMIN_RDUNIF_1 = 10000;
+int64_t gEidos_OMPMIN_RDUNIF_2 = 10000;
+int64_t gEidos_OMPMIN_RDUNIF_3 = 10000;
+int64_t gEidos_OMPMIN_REXP_1 = 10000;
+int64_t gEidos_OMPMIN_REXP_2 = 10000;
+int64_t gEidos_OMPMIN_RNORM_1 = 10000;
+int64_t gEidos_OMPMIN_RNORM_2 = 10000;
+int64_t gEidos_OMPMIN_RNORM_3 = 10000;
+int64_t gEidos_OMPMIN_RPOIS_1 = 10000;
+int64_t gEidos_OMPMIN_RPOIS_2 = 10000;
+int64_t gEidos_OMPMIN_RUNIF_1 = 10000;
+int64_t gEidos_OMPMIN_RUNIF_2 = 10000;
+int64_t gEidos_OMPMIN_RUNIF_3 = 10000;
+
+// Sorting & ordering
+int64_t gEidos_OMPMIN_SORT_INT = 4000;
+int64_t gEidos_OMPMIN_SORT_FLOAT = 4000;
+int64_t gEidos_OMPMIN_SORT_STRING = 4000;
+
+// Spatial point/map manipulation
+int64_t gEidos_OMPMIN_POINT_IN_BOUNDS_1D = 2000;
+int64_t gEidos_OMPMIN_POINT_IN_BOUNDS_2D = 2000;
+int64_t gEidos_OMPMIN_POINT_IN_BOUNDS_3D = 2000;
+int64_t gEidos_OMPMIN_POINT_PERIODIC_1D = 2000;
+int64_t gEidos_OMPMIN_POINT_PERIODIC_2D = 2000;
+int64_t gEidos_OMPMIN_POINT_PERIODIC_3D = 2000;
+int64_t gEidos_OMPMIN_POINT_REFLECTED_1D = 2000;
+int64_t gEidos_OMPMIN_POINT_REFLECTED_2D = 2000;
+int64_t gEidos_OMPMIN_POINT_REFLECTED_3D = 2000;
+int64_t gEidos_OMPMIN_POINT_STOPPED_1D = 2000;
+int64_t gEidos_OMPMIN_POINT_STOPPED_2D = 2000;
+int64_t gEidos_OMPMIN_POINT_STOPPED_3D = 2000;
+int64_t gEidos_OMPMIN_POINT_UNIFORM_1D = 2000;
+int64_t gEidos_OMPMIN_POINT_UNIFORM_2D = 2000;
+int64_t gEidos_OMPMIN_POINT_UNIFORM_3D = 2000;
+int64_t gEidos_OMPMIN_SET_SPATIAL_POS_1_1D = 10000;
+int64_t gEidos_OMPMIN_SET_SPATIAL_POS_1_2D = 10000;
+int64_t gEidos_OMPMIN_SET_SPATIAL_POS_1_3D = 10000;
+int64_t gEidos_OMPMIN_SET_SPATIAL_POS_2_1D = 10000;
+int64_t gEidos_OMPMIN_SET_SPATIAL_POS_2_2D = 10000;
+int64_t gEidos_OMPMIN_SET_SPATIAL_POS_2_3D = 10000;
+int64_t gEidos_OMPMIN_SPATIAL_MAP_VALUE = 2000;
+
+// Spatial queries
+int64_t gEidos_OMPMIN_CLIPPEDINTEGRAL_1S = 10000;
+int64_t gEidos_OMPMIN_CLIPPEDINTEGRAL_2S = 10000;
+//int64_t gEidos_OMPMIN_CLIPPEDINTEGRAL_3S = 10000;
+int64_t gEidos_OMPMIN_DRAWBYSTRENGTH = 10;
+int64_t gEidos_OMPMIN_INTNEIGHCOUNT = 10;
+int64_t gEidos_OMPMIN_LOCALPOPDENSITY = 10;
+int64_t gEidos_OMPMIN_NEARESTINTNEIGH = 10;
+int64_t gEidos_OMPMIN_NEARESTNEIGH = 10;
+int64_t gEidos_OMPMIN_NEIGHCOUNT = 10;
+int64_t gEidos_OMPMIN_TOTNEIGHSTRENGTH = 10;
+
+// SLiM core
+int64_t gEidos_OMPMIN_AGE_INCR = 10000;
+int64_t gEidos_OMPMIN_DEFERRED_REPRO = 100;
+int64_t gEidos_OMPMIN_WF_REPRO = 100;
+int64_t gEidos_OMPMIN_FITNESS_ASEX_1 = 10000;
+int64_t gEidos_OMPMIN_FITNESS_ASEX_2 = 10000;
+int64_t gEidos_OMPMIN_FITNESS_ASEX_3 = 10000;
+int64_t gEidos_OMPMIN_FITNESS_SEX_1 = 10000;
+int64_t gEidos_OMPMIN_FITNESS_SEX_2 = 10000;
+int64_t gEidos_OMPMIN_FITNESS_SEX_3 = 10000;
+int64_t gEidos_OMPMIN_FITNESS_SUBPOPS = 10000;
+int64_t gEidos_OMPMIN_SPATIAL_GRID = 10000;
+int64_t gEidos_OMPMIN_KDTREE_BUILD = 10000;
+int64_t gEidos_OMPMIN_MIGRANT_CLEAR = 10000;
+int64_t gEidos_OMPMIN_FIXED_MUT_REMOVE = 1000;
+int64_t gEidos_OMPMIN_SIMPLIFY_SORT_PRE = 4000;
+int64_t gEidos_OMPMIN_SIMPLIFY_SORT = 4000;
+int64_t gEidos_OMPMIN_SIMPLIFY_SORT_POST = 4000;
+int64_t gEidos_OMPMIN_SIMPLIFY_CHROMOSOMES = 2;
+int64_t gEidos_OMPMIN_SURVIVAL = 10000;
+
+
+// A table of the thresholds above, keyed by the same names that parallelSetTaskThreadCounts() uses for thread counts
+typedef struct {
+	const char *key_;
+	int64_t *threshold_;
+} EidosOMPMinThreshold;
+
+static const EidosOMPMinThreshold gEidosOMPMinThresholds[] = {
+	// Eidos: math functions
+	{"ABS_FLOAT", &gEidos_OMPMIN_ABS_FLOAT},
+	{"CEIL", &gEidos_OMPMIN_CEIL},
+	{"EXP_FLOAT", &gEidos_OMPMIN_EXP_FLOAT},
+	{"FLOOR", &gEidos_OMPMIN_FLOOR},
+	{"LOG_FLOAT", &gEidos_OMPMIN_LOG_FLOAT},
+	{"LOG10_FLOAT", &gEidos_OMPMIN_LOG10_FLOAT},
+	{"LOG2_FLOAT", &gEidos_OMPMIN_LOG2_FLOAT},
+	{"ROUND", &gEidos_OMPMIN_ROUND},
+	{"SQRT_FLOAT", &gEidos_OMPMIN_SQRT_FLOAT},
+	{"SUM_INTEGER", &gEidos_OMPMIN_SUM_INTEGER},
+	{"SUM_FLOAT", &gEidos_OMPMIN_SUM_FLOAT},
+	{"SUM_LOGICAL", &gEidos_OMPMIN_SUM_LOGICAL},
+	{"TRUNC", &gEidos_OMPMIN_TRUNC},
+	// Eidos: max(), min(), pmax(), pmin()
+	{"MAX_INT", &gEidos_OMPMIN_MAX_INT},
+	{"MAX_FLOAT", &gEidos_OMPMIN_MAX_FLOAT},
+	{"MIN_INT", &gEidos_OMPMIN_MIN_INT},
+	{"MIN_FLOAT", &gEidos_OMPMIN_MIN_FLOAT},
+	{"PMAX_INT_1", &gEidos_OMPMIN_PMAX_INT_1},
+	{"PMAX_INT_2", &gEidos_OMPMIN_PMAX_INT_2},
+	{"PMAX_FLOAT_1", &gEidos_OMPMIN_PMAX_FLOAT_1},
+	{"PMAX_FLOAT_2", &gEidos_OMPMIN_PMAX_FLOAT_2},
+	{"PMIN_INT_1", &gEidos_OMPMIN_PMIN_INT_1},
+	{"PMIN_INT_2", &gEidos_OMPMIN_PMIN_INT_2},
+	{"PMIN_FLOAT_1", &gEidos_OMPMIN_PMIN_FLOAT_1},
+	{"PMIN_FLOAT_2", &gEidos_OMPMIN_PMIN_FLOAT_2},
+	// Eidos: match(), sample(), tabulate()
+	{"MATCH_INT", &gEidos_OMPMIN_MATCH_INT},
+	{"MATCH_FLOAT", &gEidos_OMPMIN_MATCH_FLOAT},
+	{"MATCH_STRING", &gEidos_OMPMIN_MATCH_STRING},
+	{"MATCH_OBJECT", &gEidos_OMPMIN_MATCH_OBJECT},
+	{"SAMPLE_INDEX", &gEidos_OMPMIN_SAMPLE_INDEX},
+	{"SAMPLE_R_INT", &gEidos_OMPMIN_SAMPLE_R_INT},
+	{"SAMPLE_R_FLOAT", &gEidos_OMPMIN_SAMPLE_R_FLOAT},
+	{"SAMPLE_R_OBJECT", &gEidos_OMPMIN_SAMPLE_R_OBJECT},
+	{"SAMPLE_WR_INT", &gEidos_OMPMIN_SAMPLE_WR_INT},
+	{"SAMPLE_WR_FLOAT", &gEidos_OMPMIN_SAMPLE_WR_FLOAT},
+	{"SAMPLE_WR_OBJECT", &gEidos_OMPMIN_SAMPLE_WR_OBJECT},
+	{"TABULATE_MAXBIN", &gEidos_OMPMIN_TABULATE_MAXBIN},
+	{"TABULATE", &gEidos_OMPMIN_TABULATE},
+	// SLiM methods/properties
+	{"CONTAINS_MARKER_MUT", &gEidos_OMPMIN_CONTAINS_MARKER_MUT},
+	{"I_COUNT_OF_MUTS_OF_TYPE", &gEidos_OMPMIN_I_COUNT_OF_MUTS_OF_TYPE},
+	{"G_COUNT_OF_MUTS_OF_TYPE", &gEidos_OMPMIN_G_COUNT_OF_MUTS_OF_TYPE},
+	{"INDS_W_PEDIGREE_IDS", &gEidos_OMPMIN_INDS_W_PEDIGREE_IDS},
+	{"RELATEDNESS", &gEidos_OMPMIN_RELATEDNESS},
+	{"SAMPLE_INDIVIDUALS_1", &gEidos_OMPMIN_SAMPLE_INDIVIDUALS_1},
+	{"SAMPLE_INDIVIDUALS_2", &gEidos_OMPMIN_SAMPLE_INDIVIDUALS_2},
+	{"SET_FITNESS_SCALE_1", &gEidos_OMPMIN_SET_FITNESS_SCALE_1},
+	{"SET_FITNESS_SCALE_2", &gEidos_OMPMIN_SET_FITNESS_SCALE_2},
+	{"SUM_OF_MUTS_OF_TYPE", &gEidos_OMPMIN_SUM_OF_MUTS_OF_TYPE},
+	// Distribution draws and related
+	{"DNORM_1", &gEidos_OMPMIN_DNORM_1},
+	{"DNORM_2", &gEidos_OMPMIN_DNORM_2},
+	{"RBINOM_1", &gEidos_OMPMIN_RBINOM_1},
+	{"RBINOM_2", &gEidos_OMPMIN_RBINOM_2},
+	{"RBINOM_3", &gEidos_OMPMIN_RBINOM_3},
+	{"RDUNIF_1", &gEidos_OMPMIN_RDUNIF_1},
+	{"RDUNIF_2", &gEidos_OMPMIN_RDUNIF_2},
+	{"RDUNIF_3", &gEidos_OMPMIN_RDUNIF_3},
+	{"REXP_1", &gEidos_OMPMIN_REXP_1},
+	{"REXP_2", &gEidos_OMPMIN_REXP_2},
+	{"RNORM_1", &gEidos_OMPMIN_RNORM_1},
+	{"RNORM_2", &gEidos_OMPMIN_RNORM_2},
+	{"RNORM_3", &gEidos_OMPMIN_RNORM_3},
+	{"RPOIS_1", &gEidos_OMPMIN_RPOIS_1},
+	{"RPOIS_2", &gEidos_OMPMIN_RPOIS_2},
+	{"RUNIF_1", &gEidos_OMPMIN_RUNIF_1},
+	{"RUNIF_2", &gEidos_OMPMIN_RUNIF_2},
+	{"RUNIF_3", &gEidos_OMPMIN_RUNIF_3},
+	// Sorting & ordering
+	{"SORT_INT", &gEidos_OMPMIN_SORT_INT},
+	{"SORT_FLOAT", &gEidos_OMPMIN_SORT_FLOAT},
+	{"SORT_STRING", &gEidos_OMPMIN_SORT_STRING},
+	// Spatial point/map manipulation
+	{"POINT_IN_BOUNDS_1D", &gEidos_OMPMIN_POINT_IN_BOUNDS_1D},
+	{"POINT_IN_BOUNDS_2D", &gEidos_OMPMIN_POINT_IN_BOUNDS_2D},
+	{"POINT_IN_BOUNDS_3D", &gEidos_OMPMIN_POINT_IN_BOUNDS_3D},
+	{"POINT_PERIODIC_1D", &gEidos_OMPMIN_POINT_PERIODIC_1D},
+	{"POINT_PERIODIC_2D", &gEidos_OMPMIN_POINT_PERIODIC_2D},
+	{"POINT_PERIODIC_3D", &gEidos_OMPMIN_POINT_PERIODIC_3D},
+	{"POINT_REFLECTED_1D", &gEidos_OMPMIN_POINT_REFLECTED_1D},
+	{"POINT_REFLECTED_2D", &gEidos_OMPMIN_POINT_REFLECTED_2D},
+	{"POINT_REFLECTED_3D", &gEidos_OMPMIN_POINT_REFLECTED_3D},
+	{"POINT_STOPPED_1D", &gEidos_OMPMIN_POINT_STOPPED_1D},
+	{"POINT_STOPPED_2D", &gEidos_OMPMIN_POINT_STOPPED_2D},
+	{"POINT_STOPPED_3D", &gEidos_OMPMIN_POINT_STOPPED_3D},
+	{"POINT_UNIFORM_1D", &gEidos_OMPMIN_POINT_UNIFORM_1D},
+	{"POINT_UNIFORM_2D", &gEidos_OMPMIN_POINT_UNIFORM_2D},
+	{"POINT_UNIFORM_3D", &gEidos_OMPMIN_POINT_UNIFORM_3D},
+	{"SET_SPATIAL_POS_1_1D", &gEidos_OMPMIN_SET_SPATIAL_POS_1_1D},
+	{"SET_SPATIAL_POS_1_2D", &gEidos_OMPMIN_SET_SPATIAL_POS_1_2D},
+	{"SET_SPATIAL_POS_1_3D", &gEidos_OMPMIN_SET_SPATIAL_POS_1_3D},
+	{"SET_SPATIAL_POS_2_1D", &gEidos_OMPMIN_SET_SPATIAL_POS_2_1D},
+	{"SET_SPATIAL_POS_2_2D", &gEidos_OMPMIN_SET_SPATIAL_POS_2_2D},
+	{"SET_SPATIAL_POS_2_3D", &gEidos_OMPMIN_SET_SPATIAL_POS_2_3D},
+	{"SPATIAL_MAP_VALUE", &gEidos_OMPMIN_SPATIAL_MAP_VALUE},
+	// Spatial queries
+	{"CLIPPEDINTEGRAL_1S", &gEidos_OMPMIN_CLIPPEDINTEGRAL_1S},
+	{"CLIPPEDINTEGRAL_2S", &gEidos_OMPMIN_CLIPPEDINTEGRAL_2S},
+	//{"CLIPPEDINTEGRAL_3S", &gEidos_OMPMIN_CLIPPEDINTEGRAL_3S},
+	{"DRAWBYSTRENGTH", &gEidos_OMPMIN_DRAWBYSTRENGTH},
+	{"INTNEIGHCOUNT", &gEidos_OMPMIN_INTNEIGHCOUNT},
+	{"LOCALPOPDENSITY", &gEidos_OMPMIN_LOCALPOPDENSITY},
+	{"NEARESTINTNEIGH", &gEidos_OMPMIN_NEARESTINTNEIGH},
+	{"NEARESTNEIGH", &gEidos_OMPMIN_NEARESTNEIGH},
+	{"NEIGHCOUNT", &gEidos_OMPMIN_NEIGHCOUNT},
+	{"TOTNEIGHSTRENGTH", &gEidos_OMPMIN_TOTNEIGHSTRENGTH},
+	// SLiM core
+	{"AGE_INCR", &gEidos_OMPMIN_AGE_INCR},
+	{"DEFERRED_REPRO", &gEidos_OMPMIN_DEFERRED_REPRO},
+	{"WF_REPRO", &gEidos_OMPMIN_WF_REPRO},
+	{"FITNESS_ASEX_1", &gEidos_OMPMIN_FITNESS_ASEX_1},
+	{"FITNESS_ASEX_2", &gEidos_OMPMIN_FITNESS_ASEX_2},
+	{"FITNESS_ASEX_3", &gEidos_OMPMIN_FITNESS_ASEX_3},
+	{"FITNESS_SEX_1", &gEidos_OMPMIN_FITNESS_SEX_1},
+	{"FITNESS_SEX_2", &gEidos_OMPMIN_FITNESS_SEX_2},
+	{"FITNESS_SEX_3", &gEidos_OMPMIN_FITNESS_SEX_3},
+	{"FITNESS_SUBPOPS", &gEidos_OMPMIN_FITNESS_SUBPOPS},
+	{"SPATIAL_GRID", &gEidos_OMPMIN_SPATIAL_GRID},
+	{"KDTREE_BUILD", &gEidos_OMPMIN_KDTREE_BUILD},
+	{"MIGRANT_CLEAR", &gEidos_OMPMIN_MIGRANT_CLEAR},
+	{"FIXED_MUT_REMOVE", &gEidos_OMPMIN_FIXED_MUT_REMOVE},
+	{"SIMPLIFY_SORT_PRE", &gEidos_OMPMIN_SIMPLIFY_SORT_PRE},
+	{"SIMPLIFY_SORT", &gEidos_OMPMIN_SIMPLIFY_SORT},
+	{"SIMPLIFY_SORT_POST", &gEidos_OMPMIN_SIMPLIFY_SORT_POST},
+	{"SIMPLIFY_CHROMOSOMES", &gEidos_OMPMIN_SIMPLIFY_CHROMOSOMES},
+	{"SURVIVAL", &gEidos_OMPMIN_SURVIVAL},
+};
+
+static int64_t *_Eidos_OMPMinThresholdForKey(const std::string &p_key)
+{
+	for (const EidosOMPMinThreshold &entry : gEidosOMPMinThresholds)
+		if (p_key == entry.key_)
+			return entry.threshold_;
+	
+	return nullptr;
+}
+
+void Eidos_LoadOpenMPThresholdProfile(const std::string &p_path, std::ostream *p_outstream)
+{
+	std::string resolved_path = Eidos_ResolvedPath(p_path);
+	std::ifstream profile_file(resolved_path);
+	
+	if (!profile_file.is_open())
+		EIDOS_TERMINATION << "ERROR (Eidos_LoadOpenMPThresholdProfile): could not open threshold profile " << resolved_path << "." << EidosTerminate(nullptr);
+	
+	std::string line;
+	int line_number = 0, threshold_count = 0;
+	
+	while (std::getline(profile_file, line))
+	{
+		++line_number;
+		
+		size_t comment_pos = line.find("//");
+		
+		if (comment_pos != std::string::npos)
+			line.erase(comment_pos);
+		
+		std::istringstream line_stream(line);
+		std::string key, value_string, extra;
+		
+		if (!(line_stream >> key))
+			continue;		// a blank or comment-only line
+		
+		if (!(line_stream >> value_string) || (line_stream >> extra))
+			EIDOS_TERMINATION << "ERROR (Eidos_LoadOpenMPThresholdProfile): malformed line " << line_number << " in threshold profile " << resolved_path << "; each line should be a key followed by a threshold." << EidosTerminate(nullptr);
+		
+		int64_t *threshold = _Eidos_OMPMinThresholdForKey(key);
+		
+		if (!threshold)
+			EIDOS_TERMINATION << "ERROR (Eidos_LoadOpenMPThresholdProfile): unrecognized key " << key << " on line " << line_number << " in threshold profile " << resolved_path << "." << EidosTerminate(nullptr);
+		
+		char *end_ptr;
+		errno = 0;
+		long long value = strtoll(value_string.c_str(), &end_ptr, 10);
+		
+		if ((errno != 0) || (*end_ptr != 0) || (value < 0))
+			EIDOS_TERMINATION << "ERROR (Eidos_LoadOpenMPThresholdProfile): threshold " << value_string << " for key " << key << " on line " << line_number << " in threshold profile " << resolved_path << " is not a non-negative integer." << EidosTerminate(nullptr);
+		
+		*threshold = (int64_t)value;
+		threshold_count++;
+	}
+	
+	if (p_outstream)
+		(*p_outstream) << "// ********** Task size thresholds: " << threshold_count << " loaded from profile '" << resolved_path << "'" << std::endl;
+}
+
+void Eidos_WriteOpenMPThresholdProfile(std::ostream &p_out)
+{
+	p_out << "// Eidos task size threshold profile; a task runs multithreaded if its size is at least its threshold" << std::endl;
+	p_out << "// tuned with maxThreads == " << gEidosMaxThreads << ", per-task thread counts '" << gEidosPerTaskThreadCountsSetName << "'" << std::endl;
+	
+	for (const EidosOMPMinThreshold &entry : gEidosOMPMinThresholds)
+		p_out << entry.key_ << " " << *entry.threshold_ << std::endl;
+}
+
+
+// The benchmarks used by Eidos_TuneOpenMPThresholds(): for each key, Eidos code that sets up the inputs for a task of size N,
+// and Eidos code that performs the task.  These mirror the parallel tests in eidos_test_parallel.h.  Parallel loops in SLiM
+// need a running model to benchmark, so their thresholds are not tuned; they keep their current values.
+typedef struct {
+	const char *key_;
+	const char *setup_;
+	const char *task_;
+} EidosOMPMinBenchmark;
+
+static const EidosOMPMinBenchmark gEidosOMPMinBenchmarks[] = {
+	// Eidos: math functions
+	{"ABS_FLOAT", "x = runif(N, -100, 100);", "abs(x);"},
+	{"CEIL", "x = runif(N, -100, 100);", "ceil(x);"},
+	{"EXP_FLOAT", "x = runif(N, -100, 100);", "exp(x);"},
+	{"FLOOR", "x = runif(N, -100, 100);", "floor(x);"},
+	{"LOG_FLOAT", "x = runif(N, 0.1, 100);", "log(x);"},
+	{"LOG10_FLOAT", "x = runif(N, 0.1, 100);", "log10(x);"},
+	{"LOG2_FLOAT", "x = runif(N, 0.1, 100);", "log2(x);"},
+	{"ROUND", "x = runif(N, -100, 100);", "round(x);"},
+	{"SQRT_FLOAT", "x = runif(N, 0, 100);", "sqrt(x);"},
+	{"SUM_INTEGER", "x = rdunif(N, -100, 100);", "sum(x);"},
+	{"SUM_FLOAT", "x = runif(N, -100, 100);", "sum(x);"},
+	{"SUM_LOGICAL", "x = asLogical(rdunif(N, 0, 1));", "sum(x);"},
+	{"TRUNC", "x = runif(N, -100, 100);", "trunc(x);"},
+	
+	// Eidos: max(), min(), pmax(), pmin()
+	{"MAX_INT", "x = rdunif(N, -100, 100);", "max(x);"},
+	{"MAX_FLOAT", "x = runif(N, -100, 100);", "max(x);"},
+	{"MIN_INT", "x = rdunif(N, -100, 100);", "min(x);"},
+	{"MIN_FLOAT", "x = runif(N, -100, 100);", "min(x);"},
+	{"PMAX_INT_1", "x = rdunif(N, -100, 100);", "pmax(x, 0);"},
+	{"PMAX_INT_2", "x = rdunif(N, -100, 100); y = rdunif(N, -100, 100);", "pmax(x, y);"},
+	{"PMAX_FLOAT_1", "x = runif(N, -100, 100);", "pmax(x, 0.0);"},
+	{"PMAX_FLOAT_2", "x = runif(N, -100, 100); y = runif(N, -100, 100);", "pmax(x, y);"},
+	{"PMIN_INT_1", "x = rdunif(N, -100, 100);", "pmin(x, 0);"},
+	{"PMIN_INT_2", "x = rdunif(N, -100, 100); y = rdunif(N, -100, 100);", "pmin(x, y);"},
+	{"PMIN_FLOAT_1", "x = runif(N, -100, 100);", "pmin(x, 0.0);"},
+	{"PMIN_FLOAT_2", "x = runif(N, -100, 100); y = runif(N, -100, 100);", "pmin(x, y);"},
+	
+	// Eidos: match(), sample(), tabulate()
+	{"MATCH_INT", "x = rdunif(N, 0, 1000); t = 0:1000;", "match(x, t);"},
+	{"MATCH_FLOAT", "x = asFloat(rdunif(N, 0, 1000)); t = asFloat(0:1000);", "match(x, t);"},
+	{"MATCH_STRING", "x = asString(rdunif(N, 0, 1000)); t = asString(0:1000);", "match(x, t);"},
+	{"MATCH_OBJECT", "t = sapply(0:99, 'Dictionary();'); x = sample(t, N, replace=T);", "match(x, t);"},
+	{"SAMPLE_INDEX", "x = 0:(N-1);", "sample(x, 5);"},
+	{"SAMPLE_R_INT", "x = 0:99;", "sample(x, N, replace=T);"},
+	{"SAMPLE_R_FLOAT", "x = asFloat(0:99);", "sample(x, N, replace=T);"},
+	{"SAMPLE_R_OBJECT", "x = sapply(0:99, 'Dictionary();');", "sample(x, N, replace=T);"},
+	{"SAMPLE_WR_INT", "x = 0:99; w = runif(100);", "sample(x, N, replace=T, weights=w);"},
+	{"SAMPLE_WR_FLOAT", "x = asFloat(0:99); w = runif(100);", "sample(x, N, replace=T, weights=w);"},
+	{"SAMPLE_WR_OBJECT", "x = sapply(0:99, 'Dictionary();'); w = runif(100);", "sample(x, N, replace=T, weights=w);"},
+	{"TABULATE_MAXBIN", "x = rdunif(N, 0, 100);", "tabulate(x);"},
+	{"TABULATE", "x = rdunif(N, 0, 100);", "tabulate(x, 100);"},
+	
+	// Distribution draws and related
+	{"DNORM_1", "x = runif(N, -3, 3);", "dnorm(x, 0.0, 1.0);"},
+	{"DNORM_2", "x = runif(N, -3, 3); m = rep(0.0, N); s = rep(1.0, N);", "dnorm(x, m, s);"},
+	{"RBINOM_1", "", "rbinom(N, 1, 0.5);"},
+	{"RBINOM_2", "", "rbinom(N, 3, 0.1);"},
+	{"RBINOM_3", "size = rep(3, N); prob = rep(0.1, N);", "rbinom(N, size, prob);"},
+	{"RDUNIF_1", "", "rdunif(N, 0, 1);"},
+	{"RDUNIF_2", "", "rdunif(N, -10, 10);"},
+	{"RDUNIF_3", "mn = rep(-10, N); mx = rep(10, N);", "rdunif(N, mn, mx);"},
+	{"REXP_1", "", "rexp(N, 2.0);"},
+	{"REXP_2", "mu = rep(2.0, N);", "rexp(N, mu);"},
+	{"RNORM_1", "", "rnorm(N, 0.0, 1.0);"},
+	{"RNORM_2", "m = rep(0.0, N);", "rnorm(N, m, 1.0);"},
+	{"RNORM_3", "m = rep(0.0, N); s = rep(1.0, N);", "rnorm(N, m, s);"},
+	{"RPOIS_1", "", "rpois(N, 2.0);"},
+	{"RPOIS_2", "lambda = rep(2.0, N);", "rpois(N, lambda);"},
+	{"RUNIF_1", "", "runif(N);"},
+	{"RUNIF_2", "", "runif(N, -1.0, 1.0);"},
+	{"RUNIF_3", "mn = rep(-1.0, N); mx = rep(1.0, N);", "runif(N, mn, mx);"},
+	
+	// Sorting & ordering
+	{"SORT_INT", "x = rdunif(N, -100, 100);", "sort(x);"},
+	{"SORT_FLOAT", "x = runif(N, -100, 100);", "sort(x);"},
+	{"SORT_STRING", "x = asString(runif(N, -100, 100));", "sort(x);"},
+};
+
+// Returns the best time, in seconds, of three trials of executing the task p_reps times
+static double _Eidos_TimeOpenMPTask(EidosInterpreter &p_interpreter, int64_t p_reps)
+{
+	double best_time = std::numeric_limits<double>::infinity();
+	
+	for (int trial = 0; trial < 3; ++trial)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		
+		for (int64_t rep = 0; rep < p_reps; ++rep)
+			p_interpreter.EvaluateInterpreterBlock(false, false);
+		
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		
+		best_time = std::min(best_time, elapsed.count());
+	}
+	
+	return best_time;
+}
+
+void Eidos_TuneOpenMPThresholds(const std::string &p_path, std::ostream &p_outstream)
+{
+	if (gEidosMaxThreads <= 1)
+		EIDOS_TERMINATION << "ERROR (Eidos_TuneOpenMPThresholds): tuning task size thresholds requires more than one thread; use -maxThreads to allow more threads." << EidosTerminate(nullptr);
+	
+	// Open the output file first, so that a bad path does not waste a long tuning run
+	std::string resolved_path = Eidos_ResolvedPath(p_path);
+	std::ofstream profile_file(resolved_path);
+	
+	if (!profile_file.is_open())
+		EIDOS_TERMINATION << "ERROR (Eidos_TuneOpenMPThresholds): could not open threshold profile " << resolved_path << " for writing." << EidosTerminate(nullptr);
+	
+	// The task sizes tested, spaced by factors of about three.  For each key, we test from the largest size downward, timing
+	// the task single-threaded and multithreaded (with the per-task thread count in effect); the threshold is the smallest
+	// size for which multithreading was faster at that size and at every larger size.  If multithreading is not faster even
+	// at the largest size, the threshold is INT64_MAX, so that the task never runs multithreaded.
+	static const int64_t task_sizes[] = {100, 300, 1000, 3000, 10000, 30000, 100000, 300000, 1000000};
+	const int task_size_count = (int)(sizeof(task_sizes) / sizeof(task_sizes[0]));
+	EidosFunctionMap function_map(*EidosInterpreter::BuiltInFunctionMap());
+	
+	Eidos_SetRNGSeed(Eidos_GenerateRNGSeed());
+	
+	p_outstream << "// Tuning task size thresholds with maxThreads == " << gEidosMaxThreads << "..." << std::endl;
+	
+	for (const EidosOMPMinBenchmark &benchmark : gEidosOMPMinBenchmarks)
+	{
+		int64_t *threshold = _Eidos_OMPMinThresholdForKey(benchmark.key_);
+		
+		if (!threshold)
+			EIDOS_TERMINATION << "ERROR (Eidos_TuneOpenMPThresholds): (internal error) no threshold for benchmark key " << benchmark.key_ << "." << EidosTerminate(nullptr);
+		
+		int64_t previous_threshold = *threshold;
+		int64_t tuned_threshold = INT64_MAX;
+		
+		for (int size_index = task_size_count - 1; size_index >= 0; --size_index)
+		{
+			int64_t task_size = task_sizes[size_index];
+			EidosSymbolTable symbol_table(EidosSymbolTableType::kLocalVariablesTable, gEidosConstantsSymbolTable);
+			
+			// Set up the inputs for the task, in symbol_table
+			EidosScript setup_script("N = " + std::to_string(task_size) + "; " + benchmark.setup_);
+			
+			setup_script.Tokenize();
+			setup_script.ParseInterpreterBlockToAST(false);
+			
+			EidosInterpreter setup_interpreter(setup_script, symbol_table, function_map, nullptr, std::cout, std::cerr
+#ifdef SLIMGUI
+				, false
+#endif
+				);
+			
+			setup_interpreter.EvaluateInterpreterBlock(false, false);
+			
+			// Time the task, with enough repetitions to get a measurable time
+			EidosScript task_script(benchmark.task_);
+			
+			task_script.Tokenize();
+			task_script.ParseInterpreterBlockToAST(false);
+			
+			EidosInterpreter task_interpreter(task_script, symbol_table, function_map, nullptr, std::cout, std::cerr
+#ifdef SLIMGUI
+				, false
+#endif
+				);
+			
+			int64_t reps = std::max((int64_t)5, (int64_t)1000000 / task_size);
+			
+			*threshold = INT64_MAX;
+			double serial_time = _Eidos_TimeOpenMPTask(task_interpreter, reps);
+			
+			*threshold = 0;
+			double parallel_time = _Eidos_TimeOpenMPTask(task_interpreter, reps);
+			
+			if (parallel_time >= serial_time)
+				break;
+			
+			tuned_threshold = task_size;
+		}
+		
+		*threshold = tuned_threshold;
+		
+		p_outstream << "//    " << benchmark.key_ << ": ";
+		if (tuned_threshold == INT64_MAX)
+			p_outstream << "never multithreaded";
+		else
+			p_outstream << tuned_threshold;
+		p_outstream << " (was " << previous_threshold << ")" << std::endl;
+	}
+	
+	Eidos_WriteOpenMPThresholdProfile(profile_file);
+	
+	p_outstream << "// Wrote threshold profile " << resolved_path << "; thresholds for SLiM tasks were not tuned" << std::endl;
+}
+
+
+#endif	// _OPENMP
+
+
+// ********************************************************************************************************************
+//
+//	NUMA-aware thread placement
+//
+
+#if defined(__linux__)
+// Parse a Linux cpulist string such as "0-15,32-47" into CPU numbers, keeping only those in p_allowed_cpus (sorted)
+static void _Eidos_ParseCPUList(const std::string &p_cpulist, const std::vector<int> &p_allowed_cpus, std::vector<int> &p_cpus)
+{
+	std::istringstream cpulist_stream(p_cpulist);
+	std::string range;
+	
+	while (std::getline(cpulist_stream, range, ','))
+	{
+		if (range.find_first_not_of(" \t\n") == std::string::npos)
+			continue;
+		
+		size_t dash_pos = range.find('-');
+		int first_cpu = (int)strtol(range.c_str(), nullptr, 10);
+		int last_cpu = (dash_pos == std::string::npos) ? first_cpu : (int)strtol(range.c_str() + dash_pos + 1, nullptr, 10);
+		
+		for (int cpu = first_cpu; (cpu <= last_cpu) && (cpu < CPU_SETSIZE); ++cpu)
+			if ((cpu >= 0) && std::binary_search(p_allowed_cpus.begin(), p_allowed_cpus.end(), cpu))
+				p_cpus.emplace_back(cpu);
+	}
+}
+
+int Eidos_NUMAThreadPlacement(const std::string &p_node_dir_path, const std::vector<int> &p_allowed_cpus, int p_thread_count, std::vector<int> &p_thread_cpus)
+{
+	// Find the allowed CPUs of each NUMA node; if the kernel does not expose NUMA topology, all of the allowed CPUs are treated
+	// as a single node, which still gives us stable thread placement
+	std::vector<std::vector<int>> node_cpus;
+	DIR *node_dir = opendir(p_node_dir_path.c_str());
+	
+	if (node_dir)
+	{
+		std::vector<int> node_ids;
+		struct dirent *entry;
+		
+		while ((entry = readdir(node_dir)) != nullptr)
+			if ((strncmp(entry->d_name, "node", 4) == 0) && isdigit((unsigned char)entry->d_name[4]))
+				node_ids.emplace_back((int)strtol(entry->d_name + 4, nullptr, 10));
+		
+		closedir(node_dir);
+		std::sort(node_ids.begin(), node_ids.end());
+		
+		for (int node_id : node_ids)
+		{
+			std::ifstream cpulist_file(p_node_dir_path + "/node" + std::to_string(node_id) + "/cpulist");
+			std::string cpulist;
+			std::vector<int> cpus;
+			
+			if (cpulist_file && std::getline(cpulist_file, cpulist))
+				_Eidos_ParseCPUList(cpulist, p_allowed_cpus, cpus);
+			
+			if (cpus.size())
+				node_cpus.emplace_back(std::move(cpus));
+		}
+	}
+	
+	if (node_cpus.size() == 0)
+		node_cpus.emplace_back(p_allowed_cpus);
+	
+	// Assign threads to nodes in contiguous blocks, so that with schedule(static) neighboring chunks of a loop over individuals
+	// are processed on the same node; within a node, threads get successive CPUs, wrapping around if a node is oversubscribed
+	int node_count = (int)node_cpus.size();
+	
+	p_thread_cpus.resize(p_thread_count);
+	
+	for (int thread_num = 0; thread_num < p_thread_count; ++thread_num)
+	{
+		int node = (int)(((int64_t)thread_num * node_count) / p_thread_count);
+		int first_thread_in_node = (int)(((int64_t)node * p_thread_count + node_count - 1) / node_count);
+		std::vector<int> &cpus = node_cpus[node];
+		
+		p_thread_cpus[thread_num] = cpus[(thread_num - first_thread_in_node) % cpus.size()];
+	}
+	
+	return node_count;
+}
+#endif
+
+#ifdef _OPENMP
+void Eidos_PinOpenMPThreadsToNUMANodes(std::ostream *p_outstream)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Eidos_PinOpenMPThreadsToNUMANodes(): illegal when parallel");
+	
+#if defined(__linux__)
+	// Find the CPUs that this process is allowed to run on, and from them the CPU for each thread of the thread pool
+	cpu_set_t allowed_cpu_set;
+	
+	CPU_ZERO(&allowed_cpu_set);
+	if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed_cpu_set) != 0)
+	{
+		if (p_outstream)
+			(*p_outstream) << "// ********** NUMA-aware mode: the allowed CPUs could not be determined; threads were not pinned" << std::endl;
+		return;
+	}
+	
+	std::vector<int> allowed_cpus;
+	
+	for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+		if (CPU_ISSET(cpu, &allowed_cpu_set))
+			allowed_cpus.emplace_back(cpu);
+	
+	std::vector<int> thread_cpus;
+	int node_count = Eidos_NUMAThreadPlacement("/sys/devices/system/node", allowed_cpus, gEidosMaxThreads, thread_cpus);
+	
+	// Pin each thread of the OpenMP thread pool to its CPU; the runtime reuses the same pool threads, in the same order, for
+	// subsequent parallel regions, so memory first touched by a thread from now on will be allocated on that thread's node
+	int pin_failures = 0;
+	
+#pragma omp parallel default(none) shared(thread_cpus) reduction(+: pin_failures) num_threads(gEidosMaxThreads)
+	{
+		cpu_set_t thread_cpu_set;
+		
+		CPU_ZERO(&thread_cpu_set);
+		CPU_SET(thread_cpus[omp_get_thread_num()], &thread_cpu_set);
+		
+		if (sched_setaffinity(0, sizeof(cpu_set_t), &thread_cpu_set) != 0)
+			pin_failures++;
+	}
+	
+	if (p_outstream)
+	{
+		if (pin_failures)
+			(*p_outstream) << "// ********** NUMA-aware mode: " << pin_failures << " of " << gEidosMaxThreads << " threads could not be pinned" << std::endl;
+		else
+			(*p_outstream) << "// ********** NUMA-aware mode: " << gEidosMaxThreads << " threads pinned across " << node_count << " NUMA node" << ((node_count == 1) ? "" : "s") << std::endl;
+	}
+#else
+	// Other platforms provide no way to pin threads to particular cores (macOS), or are not supported yet (Windows); we rely on
+	// OMP_PROC_BIND / OMP_PLACES, which Eidos_WarmUpOpenMP() sets to "spread" / "cores" in NUMA-aware mode
+	if (p_outstream)
+		(*p_outstream) << "// ********** NUMA-aware mode: explicit thread pinning is not supported on this platform; using OMP_PROC_BIND only" << std::endl;
+#endif
+}
+
+#endif	// _OPENMP
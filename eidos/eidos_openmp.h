@@ -59,9 +59,12 @@
 
 #include <signal.h>
 #include <limits.h>
+#include <stdint.h>
 #include <errno.h>
 #include <string.h>
 #include <iostream>
+#include <string>
+#include <vector>
 
 
 /*
@@ -95,6 +98,18 @@ extern int gEidosMaxThreads;
 extern int gEidosNumThreads;
 extern bool gEidosNumThreadsOverride;
 
+// If true, Eidos_WarmUpOpenMP() pins threads to cores and sets up NUMA-friendly scheduling; see Eidos_PinOpenMPThreadsToNUMANodes().
+// This must be set before Eidos_WarmUpOpenMP() is called; it is set by the -numa command-line option to slim.
+extern bool gEidosNUMAAware;
+
+#if defined(__linux__)
+// Works out the CPU for each of p_thread_count threads in NUMA-aware mode: the CPUs of each NUMA node are read from the node
+// directories (node0, node1, ...) in p_node_dir_path, normally /sys/devices/system/node, keeping only those in p_allowed_cpus;
+// if that yields nothing, the allowed CPUs are treated as a single node.  Threads are assigned to nodes in contiguous blocks,
+// and to successive CPUs within a node.  Returns the number of nodes used.  This is available in all builds, for testing.
+int Eidos_NUMAThreadPlacement(const std::string &p_node_dir_path, const std::vector<int> &p_allowed_cpus, int p_thread_count, std::vector<int> &p_thread_cpus);
+#endif
+
 
 // We want to use SIGTRAP to catch problems in the debugger in a few key spots, but it doesn't exist on Windows.
 // So we will just define SIGTRAP to be SIGABRT instead; SIGABRT is supported on Windows.
@@ -257,140 +272,146 @@ private:
 #define USE_OMP_LIMITS	1
 
 #if USE_OMP_LIMITS
-// This set of minimum counts is for production code
+// This set of minimum counts is for production code; the counts are variables, so that they can be tuned at runtime.
+// Their compiled-in default values are in eidos_openmp.cpp, and can be replaced by a profile; see Eidos_TuneOpenMPThresholds().
 
 // Eidos: math functions
-#define EIDOS_OMPMIN_ABS_FLOAT				2000
-#define EIDOS_OMPMIN_CEIL					2000
-#define EIDOS_OMPMIN_EXP_FLOAT				2000
-#define EIDOS_OMPMIN_FLOOR					2000
-#define EIDOS_OMPMIN_LOG_FLOAT				2000
-#define EIDOS_OMPMIN_LOG10_FLOAT			2000
-#define EIDOS_OMPMIN_LOG2_FLOAT				2000
-#define EIDOS_OMPMIN_ROUND					2000
-#define EIDOS_OMPMIN_SQRT_FLOAT				2000
-#define EIDOS_OMPMIN_SUM_INTEGER			2000
-#define EIDOS_OMPMIN_SUM_FLOAT				2000
-#define EIDOS_OMPMIN_SUM_LOGICAL			6000
-#define EIDOS_OMPMIN_TRUNC					2000
+#define EIDOS_OMPMIN_ABS_FLOAT				gEidos_OMPMIN_ABS_FLOAT
+#define EIDOS_OMPMIN_CEIL					gEidos_OMPMIN_CEIL
+#define EIDOS_OMPMIN_EXP_FLOAT				gEidos_OMPMIN_EXP_FLOAT
+#define EIDOS_OMPMIN_FLOOR					gEidos_OMPMIN_FLOOR
+#define EIDOS_OMPMIN_LOG_FLOAT				gEidos_OMPMIN_LOG_FLOAT
+#define EIDOS_OMPMIN_LOG10_FLOAT			gEidos_OMPMIN_LOG10_FLOAT
+#define EIDOS_OMPMIN_LOG2_FLOAT				gEidos_OMPMIN_LOG2_FLOAT
+#define EIDOS_OMPMIN_ROUND					gEidos_OMPMIN_ROUND
+#define EIDOS_OMPMIN_SQRT_FLOAT				gEidos_OMPMIN_SQRT_FLOAT
+#define EIDOS_OMPMIN_SUM_INTEGER			gEidos_OMPMIN_SUM_INTEGER
+#define EIDOS_OMPMIN_SUM_FLOAT				gEidos_OMPMIN_SUM_FLOAT
+#define EIDOS_OMPMIN_SUM_LOGICAL			gEidos_OMPMIN_SUM_LOGICAL
+#define EIDOS_OMPMIN_TRUNC					gEidos_OMPMIN_TRUNC
 
 // Eidos: max(), min(), pmax(), pmin()
-#define EIDOS_OMPMIN_MAX_INT				2000
-#define EIDOS_OMPMIN_MAX_FLOAT				2000
-#define EIDOS_OMPMIN_MIN_INT				2000
-#define EIDOS_OMPMIN_MIN_FLOAT				2000
-#define EIDOS_OMPMIN_PMAX_INT_1				2000
-#define EIDOS_OMPMIN_PMAX_INT_2				2000
-#define EIDOS_OMPMIN_PMAX_FLOAT_1			2000
-#define EIDOS_OMPMIN_PMAX_FLOAT_2			2000
-#define EIDOS_OMPMIN_PMIN_INT_1				2000
-#define EIDOS_OMPMIN_PMIN_INT_2				2000
-#define EIDOS_OMPMIN_PMIN_FLOAT_1			2000
-#define EIDOS_OMPMIN_PMIN_FLOAT_2			2000
+#define EIDOS_OMPMIN_MAX_INT				gEidos_OMPMIN_MAX_INT
+#define EIDOS_OMPMIN_MAX_FLOAT				gEidos_OMPMIN_MAX_FLOAT
+#define EIDOS_OMPMIN_MIN_INT				gEidos_OMPMIN_MIN_INT
+#define EIDOS_OMPMIN_MIN_FLOAT				gEidos_OMPMIN_MIN_FLOAT
+#define EIDOS_OMPMIN_PMAX_INT_1				gEidos_OMPMIN_PMAX_INT_1
+#define EIDOS_OMPMIN_PMAX_INT_2				gEidos_OMPMIN_PMAX_INT_2
+#define EIDOS_OMPMIN_PMAX_FLOAT_1			gEidos_OMPMIN_PMAX_FLOAT_1
+#define EIDOS_OMPMIN_PMAX_FLOAT_2			gEidos_OMPMIN_PMAX_FLOAT_2
+#define EIDOS_OMPMIN_PMIN_INT_1				gEidos_OMPMIN_PMIN_INT_1
+#define EIDOS_OMPMIN_PMIN_INT_2				gEidos_OMPMIN_PMIN_INT_2
+#define EIDOS_OMPMIN_PMIN_FLOAT_1			gEidos_OMPMIN_PMIN_FLOAT_1
+#define EIDOS_OMPMIN_PMIN_FLOAT_2			gEidos_OMPMIN_PMIN_FLOAT_2
 
 // Eidos: match(), sample(), tabulate()
-#define EIDOS_OMPMIN_MATCH_INT				2000
-#define EIDOS_OMPMIN_MATCH_FLOAT			2000
-#define EIDOS_OMPMIN_MATCH_STRING			2000
-#define EIDOS_OMPMIN_MATCH_OBJECT			2000
-#define EIDOS_OMPMIN_SAMPLE_INDEX			2000
-#define EIDOS_OMPMIN_SAMPLE_R_INT			2000
-#define EIDOS_OMPMIN_SAMPLE_R_FLOAT			2000
-#define EIDOS_OMPMIN_SAMPLE_R_OBJECT		2000
-#define EIDOS_OMPMIN_SAMPLE_WR_INT			2000
-#define EIDOS_OMPMIN_SAMPLE_WR_FLOAT		2000
-#define EIDOS_OMPMIN_SAMPLE_WR_OBJECT		2000
-#define EIDOS_OMPMIN_TABULATE_MAXBIN		2000
-#define EIDOS_OMPMIN_TABULATE				2000
+#define EIDOS_OMPMIN_MATCH_INT				gEidos_OMPMIN_MATCH_INT
+#define EIDOS_OMPMIN_MATCH_FLOAT			gEidos_OMPMIN_MATCH_FLOAT
+#define EIDOS_OMPMIN_MATCH_STRING			gEidos_OMPMIN_MATCH_STRING
+#define EIDOS_OMPMIN_MATCH_OBJECT			gEidos_OMPMIN_MATCH_OBJECT
+#define EIDOS_OMPMIN_SAMPLE_INDEX			gEidos_OMPMIN_SAMPLE_INDEX
+#define EIDOS_OMPMIN_SAMPLE_R_INT			gEidos_OMPMIN_SAMPLE_R_INT
+#define EIDOS_OMPMIN_SAMPLE_R_FLOAT			gEidos_OMPMIN_SAMPLE_R_FLOAT
+#define EIDOS_OMPMIN_SAMPLE_R_OBJECT		gEidos_OMPMIN_SAMPLE_R_OBJECT
+#define EIDOS_OMPMIN_SAMPLE_WR_INT			gEidos_OMPMIN_SAMPLE_WR_INT
+#define EIDOS_OMPMIN_SAMPLE_WR_FLOAT		gEidos_OMPMIN_SAMPLE_WR_FLOAT
+#define EIDOS_OMPMIN_SAMPLE_WR_OBJECT		gEidos_OMPMIN_SAMPLE_WR_OBJECT
+#define EIDOS_OMPMIN_TABULATE_MAXBIN		gEidos_OMPMIN_TABULATE_MAXBIN
+#define EIDOS_OMPMIN_TABULATE				gEidos_OMPMIN_TABULATE
 
 // SLiM methods/properties
-#define EIDOS_OMPMIN_CONTAINS_MARKER_MUT	900
-#define EIDOS_OMPMIN_I_COUNT_OF_MUTS_OF_TYPE	2
-#define EIDOS_OMPMIN_G_COUNT_OF_MUTS_OF_TYPE	2
-#define EIDOS_OMPMIN_INDS_W_PEDIGREE_IDS	2000
-#define EIDOS_OMPMIN_RELATEDNESS			2000
-#define EIDOS_OMPMIN_SAMPLE_INDIVIDUALS_1	2000
-#define EIDOS_OMPMIN_SAMPLE_INDIVIDUALS_2	2000
-#define EIDOS_OMPMIN_SET_FITNESS_SCALE_1	900
-#define EIDOS_OMPMIN_SET_FITNESS_SCALE_2	1500
-#define EIDOS_OMPMIN_SUM_OF_MUTS_OF_TYPE	2
+#define EIDOS_OMPMIN_CONTAINS_MARKER_MUT	gEidos_OMPMIN_CONTAINS_MARKER_MUT
+#define EIDOS_OMPMIN_I_COUNT_OF_MUTS_OF_TYPE	gEidos_OMPMIN_I_COUNT_OF_MUTS_OF_TYPE
+#define EIDOS_OMPMIN_G_COUNT_OF_MUTS_OF_TYPE	gEidos_OMPMIN_G_COUNT_OF_MUTS_OF_TYPE
+#define EIDOS_OMPMIN_INDS_W_PEDIGREE_IDS	gEidos_OMPMIN_INDS_W_PEDIGREE_IDS
+#define EIDOS_OMPMIN_RELATEDNESS			gEidos_OMPMIN_RELATEDNESS
+#define EIDOS_OMPMIN_SAMPLE_INDIVIDUALS_1	gEidos_OMPMIN_SAMPLE_INDIVIDUALS_1
+#define EIDOS_OMPMIN_SAMPLE_INDIVIDUALS_2	gEidos_OMPMIN_SAMPLE_INDIVIDUALS_2
+#define EIDOS_OMPMIN_SET_FITNESS_SCALE_1	gEidos_OMPMIN_SET_FITNESS_SCALE_1
+#define EIDOS_OMPMIN_SET_FITNESS_SCALE_2	gEidos_OMPMIN_SET_FITNESS_SCALE_2
+#define EIDOS_OMPMIN_SUM_OF_MUTS_OF_TYPE	gEidos_OMPMIN_SUM_OF_MUTS_OF_TYPE
 
 // Distribution draws and related
-#define EIDOS_OMPMIN_DNORM_1				10000
-#define EIDOS_OMPMIN_DNORM_2				10000
-#define EIDOS_OMPMIN_RBINOM_1				10000
-#define EIDOS_OMPMIN_RBINOM_2				10000
-#define EIDOS_OMPMIN_RBINOM_3				10000
-#define EIDOS_OMPMIN_RDUNIF_1				10000
-#define EIDOS_OMPMIN_RDUNIF_2				10000
-#define EIDOS_OMPMIN_RDUNIF_3				10000
-#define EIDOS_OMPMIN_REXP_1					10000
-#define EIDOS_OMPMIN_REXP_2					10000
-#define EIDOS_OMPMIN_RNORM_1				10000
-#define EIDOS_OMPMIN_RNORM_2				10000
-#define EIDOS_OMPMIN_RNORM_3				10000
-#define EIDOS_OMPMIN_RPOIS_1				10000
-#define EIDOS_OMPMIN_RPOIS_2				10000
-#define EIDOS_OMPMIN_RUNIF_1				10000
-#define EIDOS_OMPMIN_RUNIF_2				10000
-#define EIDOS_OMPMIN_RUNIF_3				10000
+#define EIDOS_OMPMIN_DNORM_1				gEidos_OMPMIN_DNORM_1
+#define EIDOS_OMPMIN_DNORM_2				gEidos_OMPMIN_DNORM_2
+#define EIDOS_OMPMIN_RBINOM_1				gEidos_OMPMIN_RBINOM_1
+#define EIDOS_OMPMIN_RBINOM_2				gEidos_OMPMIN_RBINOM_2
+#define EIDOS_OMPMIN_RBINOM_3				gEidos_OMPMIN_RBINOM_3
+#define EIDOS_OMPMIN_RDUNIF_1				gEidos_OMPMIN_RDUNIF_1
+#define EIDOS_OMPMIN_RDUNIF_2				gEidos_OMPMIN_RDUNIF_2
+#define EIDOS_OMPMIN_RDUNIF_3				gEidos_OMPMIN_RDUNIF_3
+#define EIDOS_OMPMIN_REXP_1					gEidos_OMPMIN_REXP_1
+#define EIDOS_OMPMIN_REXP_2					gEidos_OMPMIN_REXP_2
+#define EIDOS_OMPMIN_RNORM_1				gEidos_OMPMIN_RNORM_1
+#define EIDOS_OMPMIN_RNORM_2				gEidos_OMPMIN_RNORM_2
+#define EIDOS_OMPMIN_RNORM_3				gEidos_OMPMIN_RNORM_3
+#define EIDOS_OMPMIN_RPOIS_1				gEidos_OMPMIN_RPOIS_1
+#define EIDOS_OMPMIN_RPOIS_2				gEidos_OMPMIN_RPOIS_2
+#define EIDOS_OMPMIN_RUNIF_1				gEidos_OMPMIN_RUNIF_1
+#define EIDOS_OMPMIN_RUNIF_2				gEidos_OMPMIN_RUNIF_2
+#define EIDOS_OMPMIN_RUNIF_3				gEidos_OMPMIN_RUNIF_3
 
 // Sorting & ordering
-#define EIDOS_OMPMIN_SORT_INT				4000
-#define EIDOS_OMPMIN_SORT_FLOAT				4000
-#define EIDOS_OMPMIN_SORT_STRING			4000
+#define EIDOS_OMPMIN_SORT_INT				gEidos_OMPMIN_SORT_INT
+#define EIDOS_OMPMIN_SORT_FLOAT				gEidos_OMPMIN_SORT_FLOAT
+#define EIDOS_OMPMIN_SORT_STRING			gEidos_OMPMIN_SORT_STRING
 
 // Spatial point/map manipulation
-#define EIDOS_OMPMIN_POINT_IN_BOUNDS_1D		2000
-#define EIDOS_OMPMIN_POINT_IN_BOUNDS_2D		2000
-#define EIDOS_OMPMIN_POINT_IN_BOUNDS_3D		2000
-#define EIDOS_OMPMIN_POINT_PERIODIC_1D		2000
-#define EIDOS_OMPMIN_POINT_PERIODIC_2D		2000
-#define EIDOS_OMPMIN_POINT_PERIODIC_3D		2000
-#define EIDOS_OMPMIN_POINT_REFLECTED_1D		2000
-#define EIDOS_OMPMIN_POINT_REFLECTED_2D		2000
-#define EIDOS_OMPMIN_POINT_REFLECTED_3D		2000
-#define EIDOS_OMPMIN_POINT_STOPPED_1D		2000
-#define EIDOS_OMPMIN_POINT_STOPPED_2D		2000
-#define EIDOS_OMPMIN_POINT_STOPPED_3D		2000
-#define EIDOS_OMPMIN_POINT_UNIFORM_1D		2000
-#define EIDOS_OMPMIN_POINT_UNIFORM_2D		2000
-#define EIDOS_OMPMIN_POINT_UNIFORM_3D		2000
-#define EIDOS_OMPMIN_SET_SPATIAL_POS_1_1D	10000
-#define EIDOS_OMPMIN_SET_SPATIAL_POS_1_2D	10000
-#define EIDOS_OMPMIN_SET_SPATIAL_POS_1_3D	10000
-#define EIDOS_OMPMIN_SET_SPATIAL_POS_2_1D	10000
-#define EIDOS_OMPMIN_SET_SPATIAL_POS_2_2D	10000
-#define EIDOS_OMPMIN_SET_SPATIAL_POS_2_3D	10000
-#define EIDOS_OMPMIN_SPATIAL_MAP_VALUE		2000
+#define EIDOS_OMPMIN_POINT_IN_BOUNDS_1D		gEidos_OMPMIN_POINT_IN_BOUNDS_1D
+#define EIDOS_OMPMIN_POINT_IN_BOUNDS_2D		gEidos_OMPMIN_POINT_IN_BOUNDS_2D
+#define EIDOS_OMPMIN_POINT_IN_BOUNDS_3D		gEidos_OMPMIN_POINT_IN_BOUNDS_3D
+#define EIDOS_OMPMIN_POINT_PERIODIC_1D		gEidos_OMPMIN_POINT_PERIODIC_1D
+#define EIDOS_OMPMIN_POINT_PERIODIC_2D		gEidos_OMPMIN_POINT_PERIODIC_2D
+#define EIDOS_OMPMIN_POINT_PERIODIC_3D		gEidos_OMPMIN_POINT_PERIODIC_3D
+#define EIDOS_OMPMIN_POINT_REFLECTED_1D		gEidos_OMPMIN_POINT_REFLECTED_1D
+#define EIDOS_OMPMIN_POINT_REFLECTED_2D		gEidos_OMPMIN_POINT_REFLECTED_2D
+#define EIDOS_OMPMIN_POINT_REFLECTED_3D		gEidos_OMPMIN_POINT_REFLECTED_3D
+#define EIDOS_OMPMIN_POINT_STOPPED_1D		gEidos_OMPMIN_POINT_STOPPED_1D
+#define EIDOS_OMPMIN_POINT_STOPPED_2D		gEidos_OMPMIN_POINT_STOPPED_2D
+#define EIDOS_OMPMIN_POINT_STOPPED_3D		gEidos_OMPMIN_POINT_STOPPED_3D
+#define EIDOS_OMPMIN_POINT_UNIFORM_1D		gEidos_OMPMIN_POINT_UNIFORM_1D
+#define EIDOS_OMPMIN_POINT_UNIFORM_2D		gEidos_OMPMIN_POINT_UNIFORM_2D
+#define EIDOS_OMPMIN_POINT_UNIFORM_3D		gEidos_OMPMIN_POINT_UNIFORM_3D
+#define EIDOS_OMPMIN_SET_SPATIAL_POS_1_1D	gEidos_OMPMIN_SET_SPATIAL_POS_1_1D
+#define EIDOS_OMPMIN_SET_SPATIAL_POS_1_2D	gEidos_OMPMIN_SET_SPATIAL_POS_1_2D
+#define EIDOS_OMPMIN_SET_SPATIAL_POS_1_3D	gEidos_OMPMIN_SET_SPATIAL_POS_1_3D
+#define EIDOS_OMPMIN_SET_SPATIAL_POS_2_1D	gEidos_OMPMIN_SET_SPATIAL_POS_2_1D
+#define EIDOS_OMPMIN_SET_SPATIAL_POS_2_2D	gEidos_OMPMIN_SET_SPATIAL_POS_2_2D
+#define EIDOS_OMPMIN_SET_SPATIAL_POS_2_3D	gEidos_OMPMIN_SET_SPATIAL_POS_2_3D
+#define EIDOS_OMPMIN_SPATIAL_MAP_VALUE		gEidos_OMPMIN_SPATIAL_MAP_VALUE
 
 // Spatial queries
-#define EIDOS_OMPMIN_CLIPPEDINTEGRAL_1S		10000
-#define EIDOS_OMPMIN_CLIPPEDINTEGRAL_2S		10000
-//#define EIDOS_OMPMIN_CLIPPEDINTEGRAL_3S		10000
-#define EIDOS_OMPMIN_DRAWBYSTRENGTH			10
-#define EIDOS_OMPMIN_INTNEIGHCOUNT			10
-#define EIDOS_OMPMIN_LOCALPOPDENSITY		10
-#define EIDOS_OMPMIN_NEARESTINTNEIGH		10
-#define EIDOS_OMPMIN_NEARESTNEIGH			10
-#define EIDOS_OMPMIN_NEIGHCOUNT				10
-#define EIDOS_OMPMIN_TOTNEIGHSTRENGTH		10
+#define EIDOS_OMPMIN_CLIPPEDINTEGRAL_1S		gEidos_OMPMIN_CLIPPEDINTEGRAL_1S
+#define EIDOS_OMPMIN_CLIPPEDINTEGRAL_2S		gEidos_OMPMIN_CLIPPEDINTEGRAL_2S
+//#define EIDOS_OMPMIN_CLIPPEDINTEGRAL_3S		gEidos_OMPMIN_CLIPPEDINTEGRAL_3S
+#define EIDOS_OMPMIN_DRAWBYSTRENGTH			gEidos_OMPMIN_DRAWBYSTRENGTH
+#define EIDOS_OMPMIN_INTNEIGHCOUNT			gEidos_OMPMIN_INTNEIGHCOUNT
+#define EIDOS_OMPMIN_LOCALPOPDENSITY		gEidos_OMPMIN_LOCALPOPDENSITY
+#define EIDOS_OMPMIN_NEARESTINTNEIGH		gEidos_OMPMIN_NEARESTINTNEIGH
+#define EIDOS_OMPMIN_NEARESTNEIGH			gEidos_OMPMIN_NEARESTNEIGH
+#define EIDOS_OMPMIN_NEIGHCOUNT				gEidos_OMPMIN_NEIGHCOUNT
+#define EIDOS_OMPMIN_TOTNEIGHSTRENGTH		gEidos_OMPMIN_TOTNEIGHSTRENGTH
 
 // SLiM core
-#define EIDOS_OMPMIN_AGE_INCR				10000
-#define EIDOS_OMPMIN_DEFERRED_REPRO			100
-#define EIDOS_OMPMIN_WF_REPRO				100
-#define EIDOS_OMPMIN_FITNESS_ASEX_1			10000
-#define EIDOS_OMPMIN_FITNESS_ASEX_2			10000
-#define EIDOS_OMPMIN_FITNESS_ASEX_3			10000
-#define EIDOS_OMPMIN_FITNESS_SEX_1			10000
-#define EIDOS_OMPMIN_FITNESS_SEX_2			10000
-#define EIDOS_OMPMIN_FITNESS_SEX_3			10000
-#define EIDOS_OMPMIN_MIGRANT_CLEAR			10000
-#define EIDOS_OMPMIN_SIMPLIFY_SORT_PRE		4000
-#define EIDOS_OMPMIN_SIMPLIFY_SORT			4000
-#define EIDOS_OMPMIN_SIMPLIFY_SORT_POST		4000
-#define EIDOS_OMPMIN_SURVIVAL				10000
+#define EIDOS_OMPMIN_AGE_INCR				gEidos_OMPMIN_AGE_INCR
+#define EIDOS_OMPMIN_DEFERRED_REPRO			gEidos_OMPMIN_DEFERRED_REPRO
+#define EIDOS_OMPMIN_WF_REPRO				gEidos_OMPMIN_WF_REPRO
+#define EIDOS_OMPMIN_FITNESS_ASEX_1			gEidos_OMPMIN_FITNESS_ASEX_1
+#define EIDOS_OMPMIN_FITNESS_ASEX_2			gEidos_OMPMIN_FITNESS_ASEX_2
+#define EIDOS_OMPMIN_FITNESS_ASEX_3			gEidos_OMPMIN_FITNESS_ASEX_3
+#define EIDOS_OMPMIN_FITNESS_SEX_1			gEidos_OMPMIN_FITNESS_SEX_1
+#define EIDOS_OMPMIN_FITNESS_SEX_2			gEidos_OMPMIN_FITNESS_SEX_2
+#define EIDOS_OMPMIN_FITNESS_SEX_3			gEidos_OMPMIN_FITNESS_SEX_3
+#define EIDOS_OMPMIN_FITNESS_SUBPOPS		gEidos_OMPMIN_FITNESS_SUBPOPS
+#define EIDOS_OMPMIN_SPATIAL_GRID		gEidos_OMPMIN_SPATIAL_GRID
+#define EIDOS_OMPMIN_KDTREE_BUILD		gEidos_OMPMIN_KDTREE_BUILD
+#define EIDOS_OMPMIN_MIGRANT_CLEAR			gEidos_OMPMIN_MIGRANT_CLEAR
+#define EIDOS_OMPMIN_FIXED_MUT_REMOVE		gEidos_OMPMIN_FIXED_MUT_REMOVE
+#define EIDOS_OMPMIN_SIMPLIFY_SORT_PRE		gEidos_OMPMIN_SIMPLIFY_SORT_PRE
+#define EIDOS_OMPMIN_SIMPLIFY_SORT			gEidos_OMPMIN_SIMPLIFY_SORT
+#define EIDOS_OMPMIN_SIMPLIFY_SORT_POST		gEidos_OMPMIN_SIMPLIFY_SORT_POST
+#define EIDOS_OMPMIN_SIMPLIFY_CHROMOSOMES	gEidos_OMPMIN_SIMPLIFY_CHROMOSOMES
+#define EIDOS_OMPMIN_SURVIVAL				gEidos_OMPMIN_SURVIVAL
 
 #else
 // This set of minimum counts is for debugging; we want to run all self-tests in parallel, so that
@@ -524,15 +545,179 @@ private:
 #define EIDOS_OMPMIN_FITNESS_SEX_1			0
 #define EIDOS_OMPMIN_FITNESS_SEX_2			0
 #define EIDOS_OMPMIN_FITNESS_SEX_3			0
+#define EIDOS_OMPMIN_FITNESS_SUBPOPS		0
+#define EIDOS_OMPMIN_SPATIAL_GRID		0
+#define EIDOS_OMPMIN_KDTREE_BUILD		0
 #define EIDOS_OMPMIN_MIGRANT_CLEAR			0
+#define EIDOS_OMPMIN_FIXED_MUT_REMOVE		0
 #define EIDOS_OMPMIN_SIMPLIFY_SORT_PRE		0
 #define EIDOS_OMPMIN_SIMPLIFY_SORT			0
 #define EIDOS_OMPMIN_SIMPLIFY_SORT_POST		0
+#define EIDOS_OMPMIN_SIMPLIFY_CHROMOSOMES	0
 #define EIDOS_OMPMIN_SURVIVAL				0
 
 #endif
 
 
+// Declarations for the minimum task sizes used by the production EIDOS_OMPMIN_* counts above.  These are int64_t
+// so that a threshold can be set to INT64_MAX, meaning that the loop should never run multithreaded.
+
+// Eidos: math functions
+extern int64_t gEidos_OMPMIN_ABS_FLOAT;
+extern int64_t gEidos_OMPMIN_CEIL;
+extern int64_t gEidos_OMPMIN_EXP_FLOAT;
+extern int64_t gEidos_OMPMIN_FLOOR;
+extern int64_t gEidos_OMPMIN_LOG_FLOAT;
+extern int64_t gEidos_OMPMIN_LOG10_FLOAT;
+extern int64_t gEidos_OMPMIN_LOG2_FLOAT;
+extern int64_t gEidos_OMPMIN_ROUND;
+extern int64_t gEidos_OMPMIN_SQRT_FLOAT;
+extern int64_t gEidos_OMPMIN_SUM_INTEGER;
+extern int64_t gEidos_OMPMIN_SUM_FLOAT;
+extern int64_t gEidos_OMPMIN_SUM_LOGICAL;
+extern int64_t gEidos_OMPMIN_TRUNC;
+
+// Eidos: max(), min(), pmax(), pmin()
+extern int64_t gEidos_OMPMIN_MAX_INT;
+extern int64_t gEidos_OMPMIN_MAX_FLOAT;
+extern int64_t gEidos_OMPMIN_MIN_INT;
+extern int64_t gEidos_OMPMIN_MIN_FLOAT;
+extern int64_t gEidos_OMPMIN_PMAX_INT_1;
+extern int64_t gEidos_OMPMIN_PMAX_INT_2;
+extern int64_t gEidos_OMPMIN_PMAX_FLOAT_1;
+extern int64_t gEidos_OMPMIN_PMAX_FLOAT_2;
+extern int64_t gEidos_OMPMIN_PMIN_INT_1;
+extern int64_t gEidos_OMPMIN_PMIN_INT_2;
+extern int64_t gEidos_OMPMIN_PMIN_FLOAT_1;
+extern int64_t gEidos_OMPMIN_PMIN_FLOAT_2;
+
+// Eidos: match(), sample(), tabulate()
+extern int64_t gEidos_OMPMIN_MATCH_INT;
+extern int64_t gEidos_OMPMIN_MATCH_FLOAT;
+extern int64_t gEidos_OMPMIN_MATCH_STRING;
+extern int64_t gEidos_OMPMIN_MATCH_OBJECT;
+extern int64_t gEidos_OMPMIN_SAMPLE_INDEX;
+extern int64_t gEidos_OMPMIN_SAMPLE_R_INT;
+extern int64_t gEidos_OMPMIN_SAMPLE_R_FLOAT;
+extern int64_t gEidos_OMPMIN_SAMPLE_R_OBJECT;
+extern int64_t gEidos_OMPMIN_SAMPLE_WR_INT;
+extern int64_t gEidos_OMPMIN_SAMPLE_WR_FLOAT;
+extern int64_t gEidos_OMPMIN_SAMPLE_WR_OBJECT;
+extern int64_t gEidos_OMPMIN_TABULATE_MAXBIN;
+extern int64_t gEidos_OMPMIN_TABULATE;
+
+// SLiM methods/properties
+extern int64_t gEidos_OMPMIN_CONTAINS_MARKER_MUT;
+extern int64_t gEidos_OMPMIN_I_COUNT_OF_MUTS_OF_TYPE;
+extern int64_t gEidos_OMPMIN_G_COUNT_OF_MUTS_OF_TYPE;
+extern int64_t gEidos_OMPMIN_INDS_W_PEDIGREE_IDS;
+extern int64_t gEidos_OMPMIN_RELATEDNESS;
+extern int64_t gEidos_OMPMIN_SAMPLE_INDIVIDUALS_1;
+extern int64_t gEidos_OMPMIN_SAMPLE_INDIVIDUALS_2;
+extern int64_t gEidos_OMPMIN_SET_FITNESS_SCALE_1;
+extern int64_t gEidos_OMPMIN_SET_FITNESS_SCALE_2;
+extern int64_t gEidos_OMPMIN_SUM_OF_MUTS_OF_TYPE;
+
+// Distribution draws and related
+extern int64_t gEidos_OMPMIN_DNORM_1;
+extern int64_t gEidos_OMPMIN_DNORM_2;
+extern int64_t gEidos_OMPMIN_RBINOM_1;
+extern int64_t gEidos_OMPMIN_RBINOM_2;
+extern int64_t gEidos_OMPMIN_RBINOM_3;
+extern int64_t gEidos_OMPMIN_RDUNIF_1;
+extern int64_t gEidos_OMPMIN_RDUNIF_2;
+extern int64_t gEidos_OMPMIN_RDUNIF_3;
+extern int64_t gEidos_OMPMIN_REXP_1;
+extern int64_t gEidos_OMPMIN_REXP_2;
+extern int64_t gEidos_OMPMIN_RNORM_1;
+extern int64_t gEidos_OMPMIN_RNORM_2;
+extern int64_t gEidos_OMPMIN_RNORM_3;
+extern int64_t gEidos_OMPMIN_RPOIS_1;
+extern int64_t gEidos_OMPMIN_RPOIS_2;
+extern int64_t gEidos_OMPMIN_RUNIF_1;
+extern int64_t gEidos_OMPMIN_RUNIF_2;
+extern int64_t gEidos_OMPMIN_RUNIF_3;
+
+// Sorting & ordering
+extern int64_t gEidos_OMPMIN_SORT_INT;
+extern int64_t gEidos_OMPMIN_SORT_FLOAT;
+extern int64_t gEidos_OMPMIN_SORT_STRING;
+
+// Spatial point/map manipulation
+extern int64_t gEidos_OMPMIN_POINT_IN_BOUNDS_1D;
+extern int64_t gEidos_OMPMIN_POINT_IN_BOUNDS_2D;
+extern int64_t gEidos_OMPMIN_POINT_IN_BOUNDS_3D;
+extern int64_t gEidos_OMPMIN_POINT_PERIODIC_1D;
+extern int64_t gEidos_OMPMIN_POINT_PERIODIC_2D;
+extern int64_t gEidos_OMPMIN_POINT_PERIODIC_3D;
+extern int64_t gEidos_OMPMIN_POINT_REFLECTED_1D;
+extern int64_t gEidos_OMPMIN_POINT_REFLECTED_2D;
+extern int64_t gEidos_OMPMIN_POINT_REFLECTED_3D;
+extern int64_t gEidos_OMPMIN_POINT_STOPPED_1D;
+extern int64_t gEidos_OMPMIN_POINT_STOPPED_2D;
+extern int64_t gEidos_OMPMIN_POINT_STOPPED_3D;
+extern int64_t gEidos_OMPMIN_POINT_UNIFORM_1D;
+extern int64_t gEidos_OMPMIN_POINT_UNIFORM_2D;
+extern int64_t gEidos_OMPMIN_POINT_UNIFORM_3D;
+extern int64_t gEidos_OMPMIN_SET_SPATIAL_POS_1_1D;
+extern int64_t gEidos_OMPMIN_SET_SPATIAL_POS_1_2D;
+extern int64_t gEidos_OMPMIN_SET_SPATIAL_POS_1_3D;
+extern int64_t gEidos_OMPMIN_SET_SPATIAL_POS_2_1D;
+extern int64_t gEidos_OMPMIN_SET_SPATIAL_POS_2_2D;
+extern int64_t gEidos_OMPMIN_SET_SPATIAL_POS_2_3D;
+extern int64_t gEidos_OMPMIN_SPATIAL_MAP_VALUE;
+
+// Spatial queries
+extern int64_t gEidos_OMPMIN_CLIPPEDINTEGRAL_1S;
+extern int64_t gEidos_OMPMIN_CLIPPEDINTEGRAL_2S;
+//extern int64_t gEidos_OMPMIN_CLIPPEDINTEGRAL_3S;
+extern int64_t gEidos_OMPMIN_DRAWBYSTRENGTH;
+extern int64_t gEidos_OMPMIN_INTNEIGHCOUNT;
+extern int64_t gEidos_OMPMIN_LOCALPOPDENSITY;
+extern int64_t gEidos_OMPMIN_NEARESTINTNEIGH;
+extern int64_t gEidos_OMPMIN_NEARESTNEIGH;
+extern int64_t gEidos_OMPMIN_NEIGHCOUNT;
+extern int64_t gEidos_OMPMIN_TOTNEIGHSTRENGTH;
+
+// SLiM core
+extern int64_t gEidos_OMPMIN_AGE_INCR;
+extern int64_t gEidos_OMPMIN_DEFERRED_REPRO;
+extern int64_t gEidos_OMPMIN_WF_REPRO;
+extern int64_t gEidos_OMPMIN_FITNESS_ASEX_1;
+extern int64_t gEidos_OMPMIN_FITNESS_ASEX_2;
+extern int64_t gEidos_OMPMIN_FITNESS_ASEX_3;
+extern int64_t gEidos_OMPMIN_FITNESS_SEX_1;
+extern int64_t gEidos_OMPMIN_FITNESS_SEX_2;
+extern int64_t gEidos_OMPMIN_FITNESS_SEX_3;
+extern int64_t gEidos_OMPMIN_FITNESS_SUBPOPS;
+extern int64_t gEidos_OMPMIN_SPATIAL_GRID;
+extern int64_t gEidos_OMPMIN_KDTREE_BUILD;
+extern int64_t gEidos_OMPMIN_MIGRANT_CLEAR;
+extern int64_t gEidos_OMPMIN_FIXED_MUT_REMOVE;
+extern int64_t gEidos_OMPMIN_SIMPLIFY_SORT_PRE;
+extern int64_t gEidos_OMPMIN_SIMPLIFY_SORT;
+extern int64_t gEidos_OMPMIN_SIMPLIFY_SORT_POST;
+extern int64_t gEidos_OMPMIN_SIMPLIFY_CHROMOSOMES;
+extern int64_t gEidos_OMPMIN_SURVIVAL;
+
+// A threshold profile is a text file of "KEY value" lines, using the same keys as parallelSetTaskThreadCounts(), that replaces
+// the compiled-in default thresholds above with values calibrated for a particular machine; "//" begins a comment.  Keys that
+// are not given in the profile keep their default values.  Eidos_LoadOpenMPThresholdProfile() should be called at startup,
+// after Eidos_WarmUpOpenMP(); it raises if the profile is malformed.  Eidos_TuneOpenMPThresholds() benchmarks each parallel
+// Eidos function at a range of task sizes, running single-threaded versus multithreaded, to find the smallest task size at
+// which multithreading pays off on the current machine; it then writes out a profile with the results (slim -tuneThreads).
+void Eidos_LoadOpenMPThresholdProfile(const std::string &p_path, std::ostream *p_outstream);
+void Eidos_WriteOpenMPThresholdProfile(std::ostream &p_out);
+void Eidos_TuneOpenMPThresholds(const std::string &p_path, std::ostream &p_outstream);
+
+// In NUMA-aware mode (gEidosNUMAAware, slim -numa), each thread of the OpenMP thread pool is pinned to a CPU, with threads
+// assigned to NUMA nodes in contiguous blocks.  Memory is placed on the node of the thread that first touches it, so once
+// threads are pinned, per-thread data structures (such as MutationRunContexts) that are allocated and initialized by their
+// own thread stay local, and loops over individuals that use schedule(runtime) switch to a static schedule so that each
+// thread keeps working on the same individuals.  Called by Eidos_WarmUpOpenMP() in NUMA-aware mode; Linux only for now.
+void Eidos_PinOpenMPThreadsToNUMANodes(std::ostream *p_outstream);
+
+
 // Here we declare variables that hold the number of threads we prefer to use for each parallel loop.
 // These have default values, which can be overridden with parallelSetTaskThreadCounts().
 
@@ -663,10 +848,15 @@ extern int gEidos_OMP_threads_FITNESS_ASEX_3;
 extern int gEidos_OMP_threads_FITNESS_SEX_1;
 extern int gEidos_OMP_threads_FITNESS_SEX_2;
 extern int gEidos_OMP_threads_FITNESS_SEX_3;
+extern int gEidos_OMP_threads_FITNESS_SUBPOPS;
+extern int gEidos_OMP_threads_SPATIAL_GRID;
+extern int gEidos_OMP_threads_KDTREE_BUILD;
 extern int gEidos_OMP_threads_MIGRANT_CLEAR;
+extern int gEidos_OMP_threads_FIXED_MUT_REMOVE;
 extern int gEidos_OMP_threads_SIMPLIFY_SORT_PRE;
 extern int gEidos_OMP_threads_SIMPLIFY_SORT;
 extern int gEidos_OMP_threads_SIMPLIFY_SORT_POST;
+extern int gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES;
 extern int gEidos_OMP_threads_PARENTS_CLEAR;
 extern int gEidos_OMP_threads_UNIQUE_MUTRUNS;
 extern int gEidos_OMP_threads_SURVIVAL;
@@ -715,6 +715,95 @@ inline double product_float64(const double *input, int64_t count)
     return prod;
 }
 
+// ================================
+// Bit Counting
+// ================================
+// These count set bits across arrays of 64-bit words, as used for bit-packed genotype
+// matrices; the AND variant counts bits set in both arrays, without a temporary.
+
+#if defined(EIDOS_HAS_AVX2)
+// Per-byte popcount using a nibble lookup table, summed into 4 64-bit lanes
+inline __m256i popcount_epi64_avx2(__m256i v)
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i lo = _mm256_and_si256(v, low_mask);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+    __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+}
+
+inline int64_t horizontal_sum_epi64_avx2(__m256i v)
+{
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return _mm_cvtsi128_si64(sum) + _mm_extract_epi64(sum, 1);
+}
+#endif
+
+// ---------------------
+// Popcount: sum(bits(x))
+// ---------------------
+inline int64_t popcount_uint64(const uint64_t *input, int64_t count)
+{
+    int64_t total = 0;
+    int64_t i = 0;
+
+#if defined(EIDOS_HAS_AVX2)
+    __m256i vsum = _mm256_setzero_si256();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&input[i]);
+        vsum = _mm256_add_epi64(vsum, popcount_epi64_avx2(v));
+    }
+    total = horizontal_sum_epi64_avx2(vsum);
+#elif defined(EIDOS_HAS_NEON)
+    for (; i + 2 <= count; i += 2)
+    {
+        uint8x16_t v = vreinterpretq_u8_u64(vld1q_u64(&input[i]));
+        total += vaddlvq_u8(vcntq_u8(v));
+    }
+#endif
+
+    // Scalar remainder; this compiles to a popcnt instruction where available (SSE4.2 etc.)
+    for (; i < count; i++)
+        total += __builtin_popcountll(input[i]);
+
+    return total;
+}
+
+// ---------------------
+// Popcount of AND: sum(bits(x & y))
+// ---------------------
+inline int64_t popcount_and_uint64(const uint64_t *input1, const uint64_t *input2, int64_t count)
+{
+    int64_t total = 0;
+    int64_t i = 0;
+
+#if defined(EIDOS_HAS_AVX2)
+    __m256i vsum = _mm256_setzero_si256();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i v1 = _mm256_loadu_si256((const __m256i *)&input1[i]);
+        __m256i v2 = _mm256_loadu_si256((const __m256i *)&input2[i]);
+        vsum = _mm256_add_epi64(vsum, popcount_epi64_avx2(_mm256_and_si256(v1, v2)));
+    }
+    total = horizontal_sum_epi64_avx2(vsum);
+#elif defined(EIDOS_HAS_NEON)
+    for (; i + 2 <= count; i += 2)
+    {
+        uint64x2_t v = vandq_u64(vld1q_u64(&input1[i]), vld1q_u64(&input2[i]));
+        total += vaddlvq_u8(vcntq_u8(vreinterpretq_u8_u64(v)));
+    }
+#endif
+
+    // Scalar remainder
+    for (; i < count; i++)
+        total += __builtin_popcountll(input1[i] & input2[i]);
+
+    return total;
+}
+
 // ================================
 // Float (Single-Precision) SIMD Operations
 // ================================
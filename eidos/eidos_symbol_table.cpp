@@ -426,6 +426,28 @@ EidosValue *EidosSymbolTable::_GetValue_RAW(EidosGlobalStringID p_symbol_name, c
 	EIDOS_TERMINATION << "ERROR (EidosSymbolTable::_GetValue_RAW): undefined identifier " << EidosStringRegistry::StringForGlobalStringID(p_symbol_name) << "." << EidosTerminate(p_symbol_token);
 }
 
+EidosValue *EidosSymbolTable::GetValueRawOrNullForSymbol(EidosGlobalStringID p_symbol_name) const
+{
+	// This follows _GetValue_RAW() but returns nullptr instead of raising for an undefined symbol
+	const EidosSymbolTable *current_table = this;
+	
+	do
+	{
+		if (p_symbol_name < current_table->capacity_)
+		{
+			EidosValue *slot_value = current_table->slots_[p_symbol_name].symbol_value_SP_.get();
+			
+			if (slot_value)
+				return slot_value;
+		}
+		
+		current_table = current_table->chain_symbol_table_;
+	}
+	while (current_table);
+	
+	return nullptr;
+}
+
 EidosValue_SP EidosSymbolTable::_GetValue_IsConstIsLocal(EidosGlobalStringID p_symbol_name, const EidosToken *p_symbol_token, bool *p_is_const, bool *p_is_local) const
 {
 	// This follows _GetValue() but provides the p_is_const and p_is_global flags
@@ -190,6 +190,9 @@ public:
 	inline __attribute__((always_inline)) EidosValue *GetValueRawOrRaiseForASTNode(const EidosASTNode *p_symbol_node) const { return _GetValue_RAW(p_symbol_node->cached_stringID_, p_symbol_node->token_); }
 	inline __attribute__((always_inline)) EidosValue *GetValueRawOrRaiseForSymbol(EidosGlobalStringID p_symbol_name) const { return _GetValue_RAW(p_symbol_name, nullptr); }
 	
+	// Get a value as an unwrapped EidosValue *, or nullptr if the symbol is not defined; used by EidosBytecode, which falls back rather than raising
+	EidosValue *GetValueRawOrNullForSymbol(EidosGlobalStringID p_symbol_name) const;
+	
 	// Special getters that return a boolean flag, true if the fetched symbol is a constant
 	inline __attribute__((always_inline)) EidosValue_SP GetValueOrRaiseForASTNode_IsConstIsLocal(const EidosASTNode *p_symbol_node, bool *p_is_const, bool *p_is_local) const { return _GetValue_IsConstIsLocal(p_symbol_node->cached_stringID_, p_symbol_node->token_, p_is_const, p_is_local); }
 	inline __attribute__((always_inline)) EidosValue_SP GetValueOrRaiseForSymbol_IsConstIsLocal(EidosGlobalStringID p_symbol_name, bool *p_is_const, bool *p_is_local) const { return _GetValue_IsConstIsLocal(p_symbol_name, nullptr, p_is_const, p_is_local); }
@@ -214,6 +217,12 @@ public:
 	inline __attribute__((always_inline)) void InitializeConstantSymbolEntry(EidosSymbolTableEntry &p_new_entry) { _InitializeConstantSymbolEntry(p_new_entry.first, p_new_entry.second); }
 	inline __attribute__((always_inline)) void InitializeConstantSymbolEntry(EidosGlobalStringID p_symbol_name, EidosValue_SP p_value) { _InitializeConstantSymbolEntry(p_symbol_name, std::move(p_value)); }
 	
+	// ReplaceConstantSymbolEntry() swaps in a new value for a constant that was set up with InitializeConstantSymbolEntry(), in O(1).
+	// This lets a context constants table be set up once and then reused across many invocations of a callback, when only the
+	// value of one callback parameter changes between invocations; the same requirements as for InitializeConstantSymbolEntry()
+	// apply, and in addition the symbol must already be defined in this table.
+	inline __attribute__((always_inline)) void ReplaceConstantSymbolEntry(EidosGlobalStringID p_symbol_name, EidosValue_SP p_value) { slots_[p_symbol_name].symbol_value_SP_ = std::move(p_value); }
+	
 	// Utility methods for printing a symbol table and, for PrintSymbolTableChain(), its parents; note these are different from operator<<
 	void PrintSymbolTable(std::ostream &p_outstream);
 	void PrintSymbolTableChain(std::ostream &p_outstream);
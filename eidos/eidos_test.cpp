@@ -25,6 +25,7 @@
 #include "eidos_globals.h"
 #include "eidos_rng.h"
 #include "eidos_sorting.h"
+#include "eidos_openmp.h"
 
 #include <stdlib.h>
 #include <iostream>
@@ -35,6 +36,12 @@
 #include <random>
 #include <ctime>
 #include <algorithm>
+#include <fstream>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/stat.h>
+#endif
 
 #if 0
 // includes for the timing code in RunEidosTests(), which is normally #if 0
@@ -321,6 +328,7 @@ int RunEidosTests(void)
 	// Run tests
 	_RunFloatOutputTests();
 	_RunInternalFilesystemTests();
+	_RunNUMAPlacementTests(temp_path);
 	_RunLiteralsIdentifiersAndTokenizationTests();
 	_RunSymbolsAndVariablesTests();
 	_RunParsingTests();
@@ -1745,6 +1753,107 @@ void _RunInternalFilesystemTests(void)
 #endif
 }
 
+#pragma mark NUMA placement
+void _RunNUMAPlacementTests(const std::string &temp_path)
+{
+	// test the NUMA topology parsing and thread placement used by slim -numa, with gEidosNUMAAware set as it would be; the node
+	// directories are mocked up in the temporary directory, as /sys/devices/system/node would be on a two-node or one-node machine
+#if defined(__linux__)
+	if (!Eidos_TemporaryDirectoryExists())
+		return;
+	
+	bool saved_NUMA_aware = gEidosNUMAAware;
+	gEidosNUMAAware = true;
+	
+	auto check_placement = [](const std::string &p_node_dir_path, const std::vector<int> &p_allowed_cpus, int p_thread_count, const std::vector<int> &p_expected_cpus, int p_expected_node_count, const char *p_description) {
+		try {
+			std::vector<int> thread_cpus;
+			int node_count = Eidos_NUMAThreadPlacement(p_node_dir_path, p_allowed_cpus, p_thread_count, thread_cpus);
+			
+			if ((thread_cpus == p_expected_cpus) && (node_count == p_expected_node_count))
+				gEidosTestSuccessCount++;
+			else
+			{
+				gEidosTestFailureCount++;
+				std::cerr << "Eidos_NUMAThreadPlacement() " << p_description << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : incorrect result (" << node_count << " nodes)" << std::endl;
+			}
+		} catch (...) {
+			gEidosTestFailureCount++;
+			std::cerr << "Eidos_NUMAThreadPlacement() " << p_description << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : raise during execution" << std::endl;
+		}
+	};
+	
+	auto make_node = [](const std::string &p_node_dir_path, const std::string &p_node_name, const std::string &p_cpulist) {
+		mkdir(p_node_dir_path.c_str(), 0777);
+		mkdir((p_node_dir_path + "/" + p_node_name).c_str(), 0777);
+		std::ofstream cpulist_file(p_node_dir_path + "/" + p_node_name + "/cpulist");
+		cpulist_file << p_cpulist << std::endl;
+	};
+	
+	// two nodes, with a memory-only node (empty cpulist) and a non-node entry that should both be skipped
+	std::string two_node_path = temp_path + "/numa_two_node";
+	make_node(two_node_path, "node0", "0-3");
+	make_node(two_node_path, "node1", "4,5-7");
+	make_node(two_node_path, "node2", "");
+	make_node(two_node_path, "possible", "0-7");
+	
+	check_placement(two_node_path, {0, 1, 2, 3, 4, 5, 6, 7}, 4, {0, 1, 4, 5}, 2, "two nodes, four threads");
+	check_placement(two_node_path, {0, 1, 2, 3, 4, 5, 6, 7}, 3, {0, 1, 4}, 2, "two nodes, three threads");
+	check_placement(two_node_path, {0, 2, 4, 6}, 4, {0, 2, 4, 6}, 2, "two nodes, restricted affinity");
+	check_placement(two_node_path, {4, 5}, 3, {4, 5, 4}, 1, "two nodes, affinity within one node");
+	
+	// a single node, oversubscribed
+	std::string one_node_path = temp_path + "/numa_one_node";
+	make_node(one_node_path, "node0", "0-3");
+	
+	check_placement(one_node_path, {0, 1, 2, 3}, 6, {0, 1, 2, 3, 0, 1}, 1, "one node, six threads");
+	
+	// no node directory at all, as on a kernel without NUMA support; all allowed CPUs are then treated as one node
+	check_placement(temp_path + "/numa_no_such_directory", {1, 3}, 3, {1, 3, 1}, 1, "no node directory");
+	check_placement(temp_path + "/numa_no_such_directory", {0}, 1, {0}, 1, "no node directory, one CPU");
+	
+#ifdef _OPENMP
+	// pin the threads of the thread pool on this machine, check that each is now confined to one allowed CPU, and then free them
+	cpu_set_t allowed_cpu_set;
+	
+	CPU_ZERO(&allowed_cpu_set);
+	if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed_cpu_set) == 0)
+	{
+		int badly_pinned = 0;
+		
+		Eidos_PinOpenMPThreadsToNUMANodes(nullptr);
+		
+#pragma omp parallel default(none) shared(allowed_cpu_set) reduction(+: badly_pinned) num_threads(gEidosMaxThreads)
+		{
+			cpu_set_t thread_cpu_set;
+			
+			CPU_ZERO(&thread_cpu_set);
+			if ((sched_getaffinity(0, sizeof(cpu_set_t), &thread_cpu_set) != 0) || (CPU_COUNT(&thread_cpu_set) != 1))
+				badly_pinned++;
+			else
+			{
+				CPU_AND(&thread_cpu_set, &thread_cpu_set, &allowed_cpu_set);
+				if (CPU_COUNT(&thread_cpu_set) != 1)
+					badly_pinned++;
+			}
+			
+			sched_setaffinity(0, sizeof(cpu_set_t), &allowed_cpu_set);
+		}
+		
+		if (badly_pinned == 0)
+			gEidosTestSuccessCount++;
+		else
+		{
+			gEidosTestFailureCount++;
+			std::cerr << "Eidos_PinOpenMPThreadsToNUMANodes() : " << EIDOS_OUTPUT_FAILURE_TAG << " : " << badly_pinned << " threads not pinned to one allowed CPU" << std::endl;
+		}
+	}
+#endif
+	
+	gEidosNUMAAware = saved_NUMA_aware;
+#endif
+}
+
 #pragma mark literals & identifiers
 void _RunLiteralsIdentifiersAndTokenizationTests(void)
 {
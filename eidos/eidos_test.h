@@ -76,6 +76,7 @@ extern void EidosAssertScriptRaise(const std::string &p_script_string, const int
 // Test subfunction prototypes
 extern void _RunFloatOutputTests(void);
 extern void _RunInternalFilesystemTests(void);
+extern void _RunNUMAPlacementTests(const std::string &temp_path);
 extern void _RunLiteralsIdentifiersAndTokenizationTests(void);
 extern void _RunSymbolsAndVariablesTests(void);
 extern void _RunParsingTests(void);
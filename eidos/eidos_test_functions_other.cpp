@@ -1892,6 +1892,20 @@ void _RunUserDefinedFunctionTests(void)
 	EidosAssertScriptRaise("function(void)foo(void) { defineConstant('x', 10); } foo(); defineGlobal('x', 5);", 60, "is already defined as a constant");
 	EidosAssertScriptRaise("function(void)foo(void) { defineGlobal('x', 5); } foo(); defineConstant('x', 10); foo();", 57, "already defined");
 	
+	// Bytecode execution of simple function bodies must match the AST walker exactly; see eidos_bytecode.h
+	EidosAssertScriptSuccess_FV("function (f$)f(f$ x, i$ n) { y = x * n; if (y > 10.0) return y - 10; else return y; } c(f(2.5, 2), f(2.5, 6));", {5.0, 5.0});
+	EidosAssertScriptSuccess_L("function (f$)g(f$ x) { a = exp(x); b = log(a + 1); return (b > 0.5) ? sqrt(b) else abs(-b); } identical(c(g(1.0), g(-2.0)), c(sqrt(log(exp(1.0) + 1)), log(exp(-2.0) + 1)));", true);
+	EidosAssertScriptSuccess_IV("function (i$)h(i$ x) { y = x; if (x < 0) y = -x; return y * 3 - abs(x); } c(h(-4), h(5));", {8, 10});
+	EidosAssertScriptSuccess_LV("function (l$)k(i$ x, f$ y) { return (x == 2) & (y >= 1.5) & !F | (x > 10); } c(k(2, 1.5), k(3, 1.5), k(11, 0.0));", {true, false, true});
+	EidosAssertScriptSuccess_F("function (f$)m(i$ x) { return x % 3 + x / 4 + x ^ 2; } m(7);", 51.75);
+	EidosAssertScriptSuccess_FV("function (numeric$)d(numeric$ x) { return x * 2; } c(d(3), d(1.5), d(3));", {6.0, 3.0, 6.0});
+	EidosAssertScriptSuccess_FV("defineGlobal('G', 2.0); function (f$)f(f$ x) { return x * G; } a = f(3.0); defineGlobal('G', 2); c(a, f(3.0));", {6.0, 6.0});
+	EidosAssertScriptSuccess_I("function (i$)f(i$ x) { y = x + 1; return y; } y = 10; f(5) + y;", 16);
+	EidosAssertScriptSuccess_VOID("function (void)f(i$ x) { y = x + 1; } f(5);");
+	EidosAssertScriptRaise("function (i$)f(i$ x) { return x + 1; } f(5); f(9223372036854775807);", 45, "integer addition overflow");
+	EidosAssertScriptRaise("function (i$)f(l$ b) { if (b) x = 1; return x; } f(T); f(F);", 55, "undefined identifier x");
+	EidosAssertScriptRaise("function (i$)f(i$ x) { return abs(x); } f(-5); f(-9223372036854775807 - 1);", 47, "most negative integer");
+	
 	// Mutual recursion with lambdas
 	
 	
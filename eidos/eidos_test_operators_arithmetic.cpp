@@ -90,8 +90,17 @@ void _RunOperatorPlusTests1(void)
 	EidosAssertScriptRaise("5e18 + c(0, 0, 5e18, 0);", 5, "overflow with the binary");
 	EidosAssertScriptRaise("c(0, 0, 5e18, 0) + 5e18;", 17, "overflow with the binary");
 	EidosAssertScriptRaise("c(0, 0, 5e18, 0) + c(0, 0, 5e18, 0);", 17, "overflow with the binary");
+	EidosAssertScriptRaise("x = 5e18; (x - 1) + 5e18;", 18, "overflow with the binary");
 #endif
 	
+	// operator +: singleton operands take a fast path that reuses temporary values in place; variables, constants, and matrices must not be modified
+	EidosAssertScriptSuccess_IV("x = 5; y = x + 1 + 2; c(x, y);", {5, 8});
+	EidosAssertScriptSuccess_FV("x = 5.5; y = (x * 2) - (x / 2) + 1; c(x, y);", {5.5, 9.25});
+	EidosAssertScriptSuccess_FV("x = 2.0; y = abs(x) + 1.0; z = -x * 3 + x; c(x, y, z);", {2.0, 3.0, -4.0});
+	EidosAssertScriptSuccess_IV("for (i in 1:3) x = i * 2 + 1; c(i, x);", {3, 7});
+	EidosAssertScriptSuccess_L("y = PI * 2.0 + 1.0; identical(y, 2 * 3.141592653589793 + 1) & (PI == 3.141592653589793);", true);
+	EidosAssertScriptSuccess_L("identical(matrix(5) + 1, matrix(6)) & identical(2 * array(1.5, c(1,1,1)) - 1, array(2.0, c(1,1,1)));", true);
+	
 	// operator +: test with mixed singletons, vectors, matrices, and arrays; the dimensionality code is shared across all operand types, so testing it with integer should suffice
 	// this is the only place where we test the binary operators with matrices and arrays so comprehensively; the same machinery is used for all, so it should suffice
 	EidosAssertScriptSuccess_L("identical(1 + integer(0), integer(0));", true);
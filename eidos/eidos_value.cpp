@@ -1738,39 +1738,10 @@ void EidosValue_Float::erase_index(size_t p_index)
 #pragma mark EidosValue_Object
 #pragma mark -
 
-// See comments on EidosValue_Object::EidosValue_Object() below.  Note this is shared by all species.
-std::vector<EidosValue_Object *> gEidosValue_Object_Mutation_Registry;
-
 EidosValue_Object::EidosValue_Object(const EidosClass *p_class) : EidosValue(EidosValueType::kValueObject),
 	values_(&singleton_value_), count_(0), capacity_(1), class_(p_class)
 {
 	class_uses_retain_release_ = (class_ == gEidosObject_Class ? true : class_->UsesRetainRelease());
-	
-	// BCH 7 May 2017: OK, so, this is a hack of breathtaking disgustingness.  Here is the problem.  In SLiM we
-	// need to reallocate the block in which all Mutation objects live, which invalidates all their pointers.
-	// SLiM can mostly handle that for itself, but there is a big problem when it comes to EidosValue_Object
-	// instances, which can contain Mutation * elements that must be updated.  So we need to find every single
-	// EidosValue_Object in existence which has a class of Mutation.  To that end, we here register this object
-	// in a global list if it is of class Mutation; in ~EidosValue_Object we will deregister it.  Maybe there
-	// is some way to do this without pushing the hack down into Eidos, but at the moment I'm not seeing it.
-	// On the bright side, this scheme actually seems pretty robust; the only way it fails is if somebody avoids
-	// using the constructor or the destructor for EidosValue_Object, I think, which seems unlikely.
-	// Note this is shared by all species, since the mutation block itself is shared by all species.
-	const std::string *element_type = &(class_->ClassName());
-										
-	if (element_type == &gEidosStr_Mutation)
-	{
-		THREAD_SAFETY_IN_ACTIVE_PARALLEL("EidosValue_Object::EidosValue_Object(): gEidosValue_Object_Mutation_Registry change");
-		
-		gEidosValue_Object_Mutation_Registry.emplace_back(this);
-		registered_for_patching_ = true;
-		
-		//std::cout << "pushed Mutation EidosValue_Object, count == " << gEidosValue_Object_Mutation_Registry.size() << std::endl;
-	}
-	else
-	{
-		registered_for_patching_ = false;
-	}
 }
 
 EidosValue_Object::EidosValue_Object(EidosObject *p_element1, const EidosClass *p_class) : EidosValue_Object(p_class)
@@ -1862,21 +1833,6 @@ EidosValue_Object::EidosValue_Object(EidosObject **p_values, size_t p_count, con
 
 EidosValue_Object::~EidosValue_Object(void)
 {
-	// See comment on EidosValue_Object::EidosValue_Object() above
-	if (registered_for_patching_)
-	{
-		THREAD_SAFETY_IN_ACTIVE_PARALLEL("EidosValue_Object::~EidosValue_Object(): gEidosValue_Object_Mutation_Registry change");
-		
-		auto erase_iter = std::find(gEidosValue_Object_Mutation_Registry.begin(), gEidosValue_Object_Mutation_Registry.end(), this);
-		
-		if (erase_iter != gEidosValue_Object_Mutation_Registry.end())
-			gEidosValue_Object_Mutation_Registry.erase(erase_iter);
-		else
-			EIDOS_TERMINATION << "ERROR (EidosValue_Object::~EidosValue_Object): (internal error) unregistered EidosValue_Object of class Mutation." << EidosTerminate(nullptr);
-		
-		//std::cout << "popped Mutation EidosValue_Object, count == " << gEidosValue_Object_Mutation_Registry.size() << std::endl;
-	}
-	
 	if (class_uses_retain_release_)
 	{
 		for (size_t index = 0; index < count_; ++index)
@@ -1892,30 +1848,6 @@ EidosValue_Object::~EidosValue_Object(void)
 		free(values_);
 }
 
-// Provided to SLiM for the Mutation-pointer hack; see EidosValue_Object::EidosValue_Object() for comments
-void EidosValue_Object::PatchPointersByAdding(std::uintptr_t p_pointer_difference)
-{
-	for (size_t i = 0; i < count_; ++i)
-	{
-		std::uintptr_t old_element_ptr = reinterpret_cast<std::uintptr_t>(values_[i]);
-		std::uintptr_t new_element_ptr = old_element_ptr + p_pointer_difference;
-		
-		values_[i] = reinterpret_cast<EidosObject *>(new_element_ptr);				// NOLINT(*-no-int-to-ptr)
-	}
-}
-
-// Provided to SLiM for the Mutation-pointer hack; see EidosValue_Object::EidosValue_Object() for comments
-void EidosValue_Object::PatchPointersBySubtracting(std::uintptr_t p_pointer_difference)
-{
-	for (size_t i = 0; i < count_; ++i)
-	{
-		std::uintptr_t old_element_ptr = reinterpret_cast<std::uintptr_t>(values_[i]);
-		std::uintptr_t new_element_ptr = old_element_ptr - p_pointer_difference;
-		
-		values_[i] = reinterpret_cast<EidosObject *>(new_element_ptr);				// NOLINT(*-no-int-to-ptr)
-	}
-}
-
 void EidosValue_Object::RaiseForClassMismatch(void) const
 {
 	EIDOS_TERMINATION << "ERROR (EidosValue_Object::RaiseForClassMismatch): the type of an object cannot be changed." << EidosTerminate(nullptr);
@@ -199,7 +199,6 @@ protected:
 	unsigned int constant_ : 1;								// if set, this EidosValue is a constant and cannot be modified
 	unsigned int iterator_var_ : 1;							// if set, this EidosValue cannot be replaced by a different value in a variable
 	unsigned int invisible_ : 1;							// as in R; if true, the value will not normally be printed to the console
-	unsigned int registered_for_patching_ : 1;				// used by EidosValue_Object, otherwise UNINITIALIZED; declared here for reasons of memory packing
 	unsigned int class_uses_retain_release_ : 1;			// used by EidosValue_Object, otherwise UNINITIALIZED; cached from UsesRetainRelease() of class_; true until class_ is set
 	
 	int64_t *dim_;											// nullptr for vectors; points to a malloced, OWNED array of dimensions for matrices and arrays
@@ -962,7 +961,6 @@ protected:
 	const EidosClass *class_;			// can be gEidosObject_Class if the vector is empty
 	
 	// declared by EidosValue for our benefit, to pack bytes
-	//unsigned int registered_for_patching_ : 1;			// for mutation pointer patching; see EidosValue_Object::EidosValue_Object()
 	//unsigned int class_uses_retain_release_ : 1;			// cached from UsesRetainRelease() of class_; true until class_ is set
 	
 	// check the type of a new element being added to an EidosValue_Object, and update class_uses_retain_release_
@@ -987,10 +985,6 @@ protected:
 	}
 	void RaiseForClassMismatch(void) const;
 	
-	// Provided to SLiM for the Mutation-pointer hack; see EidosValue_Object::EidosValue_Object() for comments
-	void PatchPointersByAdding(std::uintptr_t p_pointer_difference);
-	void PatchPointersBySubtracting(std::uintptr_t p_pointer_difference);
-	
 public:
 	EidosValue_Object(void) = delete;												// no default constructor
 	EidosValue_Object& operator=(const EidosValue_Object&) = delete;				// no copying
@@ -1107,8 +1101,6 @@ public:
 	void set_object_element_no_check_RR(EidosObject *p_object, size_t p_index);		// specifies retain/release
 	void set_object_element_no_check_no_previous_RR(EidosObject *p_object, size_t p_index);		// specifies retain/release, previous value assumed invalid from resize_no_initialize_RR
 	void set_object_element_no_check_NORR(EidosObject *p_object, size_t p_index);	// specifies no retain/release
-	
-	friend void SLiM_IncreaseMutationBlockCapacity(void);	// for PatchPointersByAdding() / PatchPointersBySubtracting()
 };
 
 inline __attribute__((always_inline)) void EidosValue_Object::push_object_element_CRR(EidosObject *p_object)